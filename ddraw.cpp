@@ -9,11 +9,13 @@
 // https://go.microsoft.com/fwlink/?linkid=2136896
 //-----------------------------------------------------------------------------
 #include "dxview.h"
+#include "dxtrace.h"
 
 #include <ddraw.h>
 #include <stdio.h>
 
 extern HRESULT Int2Str(_Out_writes_bytes_(nDestLen) LPTSTR pszDest, UINT nDestLen, DWORD i);
+BOOL DXGI_GetMonitorAdapter(HMONITOR hMonitor, ADAPTERLUID& luid);
 
 namespace
 {
@@ -22,6 +24,19 @@ namespace
     LPDIRECTDRAW7 g_pDD = nullptr;
     HMODULE g_hInstDDraw = nullptr;
     GUID* g_pDDGUID;
+    const char* g_pDDName = "";     // Of g_pDD, as probe timing reports it
+    BOOL g_bDDTimedOut = FALSE;     // A call hung, so DirectDraw is left alone from then on
+
+    // Each driver as enumerated, see DDEnumCallBack
+    struct DDDRIVER
+    {
+        GUID*           pGUID;          // Each node's lParam1
+        std::string     strName;
+        ADAPTERLUID     AdapterLuid;    // Of the adapter its monitor is on, zero if unknown
+    };
+
+    std::vector<DDDRIVER> g_ddDrivers;
+    HTREEITEM g_hTreeDD = nullptr;
 
     LPDIRECTDRAWCREATEEX g_directDrawCreateEx = nullptr;
     LPDIRECTDRAWENUMERATEEXA g_directDrawEnumerateEx = nullptr;
@@ -31,12 +46,11 @@ namespace
     HRESULT DDDisplayVideoModes(LPARAM lParam1, LPARAM lParam2, _In_opt_ PRINTCBINFO* pInfo);
     HRESULT DDDisplayFourCCFormat(LPARAM lParam1, LPARAM lParam2, _In_opt_ PRINTCBINFO* pInfo);
 
-#define DDCAPDEFex(name,val,flag) {name, FIELD_OFFSET(DDCAPS,val), flag, DXV_9EXCAP}
-#define DDCAPDEF(name,val,flag) {name, FIELD_OFFSET(DDCAPS,val), flag}
-#define DDVALDEF(name,val)      {name, FIELD_OFFSET(DDCAPS,val), 0}
-#define DDHEXDEF(name,val)      {name, FIELD_OFFSET(DDCAPS,val), 0xFFFFFFFF}
+#define DDCAPDEFex(name,val,flag) CAPDEFROW(name, DDCAPS, val, flag, DXV_9EXCAP, CAPDEF_FLAG)
+#define DDCAPDEF(name,val,flag) CAPDEFROW(name, DDCAPS, val, flag, 0, CAPDEF_FLAG)
+#define DDVALDEF(name,val)      CAPDEFROW(name, DDCAPS, val, 0, 0, CAPDEF_VALUE)
+#define DDHEXDEF(name,val)      CAPDEFROW(name, DDCAPS, val, 0, 0, CAPDEF_HEX)
 #define ROPDEF(name,dwRops,rop) DDCAPDEF(name,dwRops[((rop>>16)&0xFF)/32],static_cast<DWORD>((1<<((rop>>16)&0xFF)%32)))
-#define MAKEMODE(xres,yres,bpp) (((DWORD)xres << 20) | ((DWORD)yres << 8) | bpp)
 
 
     //-----------------------------------------------------------------------------
@@ -617,10 +631,41 @@ namespace
     };
 
 
+    // DirectDrawCreateEx as run under the watchdog, see DDCreate
+    struct DDCREATE
+    {
+        GUID*           pGUID;
+        std::string     strName;
+        LPDIRECTDRAW7   pDD;
+        HRESULT         hr;
+    };
+
+    //-----------------------------------------------------------------------------
+    void DDCreateProc(VOID* pContext)
+    {
+        auto pCreate = static_cast<DDCREATE*>(pContext);
+        pCreate->hr = PROBE_CALL("DirectDrawCreateEx", pCreate->strName.c_str(),
+            g_directDrawCreateEx(pCreate->pGUID, (VOID**)&pCreate->pDD, IID_IDirectDraw7, nullptr));
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: DDAbandon()
+    // Desc: Called when the watchdog gives up on a DirectDraw call. The object
+    //       stays with the call that hung, and every node after this shows
+    //       nothing rather than risk another.
+    //-----------------------------------------------------------------------------
+    void DDAbandon()
+    {
+        g_bDDTimedOut = TRUE;
+        g_pDD = nullptr;
+        g_pDDGUID = nullptr;
+        g_pDDName = "";
+    }
+
     //-----------------------------------------------------------------------------
     HRESULT DDCreate(GUID* pGUID)
     {
-        if (pGUID == (GUID*)-2)
+        if (pGUID == (GUID*)-2 || g_bDDTimedOut)
             return E_FAIL;
 
         if (g_pDD && pGUID == g_pDDGUID)
@@ -637,9 +682,32 @@ namespace
         if (!g_directDrawCreateEx)
             return E_FAIL;
 
-        if (SUCCEEDED(g_directDrawCreateEx(pGUID, (VOID**)&g_pDD, IID_IDirectDraw7, nullptr)))
+        const char* pName = "";
+        for (const auto& driver : g_ddDrivers)
+        {
+            if (driver.pGUID == pGUID)
+                pName = driver.strName.c_str();
+        }
+
+        auto pCreate = new (std::nothrow) DDCREATE{ pGUID, pName, nullptr, E_FAIL };
+        if (!pCreate)
+            return E_OUTOFMEMORY;
+
+        if (!WatchdogRun(DDCreateProc, pCreate))
+        {
+            // pCreate stays with the call that hung
+            DDAbandon();
+            return E_FAIL;
+        }
+
+        HRESULT hr = pCreate->hr;
+        g_pDD = pCreate->pDD;
+        delete pCreate;
+
+        if (SUCCEEDED(hr))
         {
             g_pDDGUID = pGUID;
+            g_pDDName = pName;
             return S_OK;
         }
 
@@ -660,7 +728,8 @@ namespace
             DDSCAPS2 ddsCaps2 = {};
 
             ddsCaps2.dwCaps = DDSCAPS_VIDEOMEMORY;
-            HRESULT hr = g_pDD->GetAvailableVidMem(&ddsCaps2, &dwTotalVidMem, &dwFreeVidMem);
+            HRESULT hr = PROBE_CALL("IDirectDraw7::GetAvailableVidMem", g_pDDName,
+                g_pDD->GetAvailableVidMem(&ddsCaps2, &dwTotalVidMem, &dwFreeVidMem));
             if (FAILED(hr))
             {
                 dwTotalVidMem = 0;
@@ -668,7 +737,8 @@ namespace
             }
 
             ddsCaps2.dwCaps = DDSCAPS_LOCALVIDMEM;
-            hr = g_pDD->GetAvailableVidMem(&ddsCaps2, &dwTotalLocMem, &dwFreeLocMem);
+            hr = PROBE_CALL("IDirectDraw7::GetAvailableVidMem", g_pDDName,
+                g_pDD->GetAvailableVidMem(&ddsCaps2, &dwTotalLocMem, &dwFreeLocMem));
             if (FAILED(hr))
             {
                 dwTotalLocMem = 0;
@@ -676,7 +746,8 @@ namespace
             }
 
             ddsCaps2.dwCaps = DDSCAPS_NONLOCALVIDMEM;
-            hr = g_pDD->GetAvailableVidMem(&ddsCaps2, &dwTotalAGPMem, &dwFreeAGPMem);
+            hr = PROBE_CALL("IDirectDraw7::GetAvailableVidMem", g_pDDName,
+                g_pDD->GetAvailableVidMem(&ddsCaps2, &dwTotalAGPMem, &dwFreeAGPMem));
             if (FAILED(hr))
             {
                 dwTotalAGPMem = 0;
@@ -684,7 +755,8 @@ namespace
             }
 
             ddsCaps2.dwCaps = DDSCAPS_TEXTURE;
-            hr = g_pDD->GetAvailableVidMem(&ddsCaps2, &dwTotalTexMem, &dwFreeTexMem);
+            hr = PROBE_CALL("IDirectDraw7::GetAvailableVidMem", g_pDDName,
+                g_pDD->GetAvailableVidMem(&ddsCaps2, &dwTotalTexMem, &dwFreeTexMem));
             if (FAILED(hr))
             {
                 dwTotalTexMem = 0;
@@ -752,9 +824,9 @@ namespace
 
             HRESULT hr;
             if (lParam1 == DDCREATE_EMULATIONONLY)
-                hr = g_pDD->GetCaps(nullptr, &ddcaps);
+                hr = PROBE_CALL("IDirectDraw7::GetCaps", g_pDDName, g_pDD->GetCaps(nullptr, &ddcaps));
             else
-                hr = g_pDD->GetCaps(&ddcaps, nullptr);
+                hr = PROBE_CALL("IDirectDraw7::GetCaps", g_pDDName, g_pDD->GetCaps(&ddcaps, nullptr));
             if (FAILED(hr))
             {
                 ddcaps = {};
@@ -779,7 +851,8 @@ namespace
             return S_OK;
 
         DWORD dwNumOfCodes;
-        HRESULT hr = g_pDD->GetFourCCCodes(&dwNumOfCodes, nullptr);
+        HRESULT hr = PROBE_CALL("IDirectDraw7::GetFourCCCodes", g_pDDName,
+            g_pDD->GetFourCCCodes(&dwNumOfCodes, nullptr));
         if (FAILED(hr))
             return E_FAIL;
 
@@ -787,7 +860,7 @@ namespace
         if (!FourCC)
             return E_OUTOFMEMORY;
 
-        hr = g_pDD->GetFourCCCodes(&dwNumOfCodes, FourCC);
+        hr = PROBE_CALL("IDirectDraw7::GetFourCCCodes", g_pDDName, g_pDD->GetFourCCCodes(&dwNumOfCodes, FourCC));
         if (FAILED(hr))
             return E_FAIL;
 
@@ -828,6 +901,50 @@ namespace
     }
     
 
+    // The display modes as listed under the watchdog, see DDDisplayVideoModes
+    struct DDVIDEOMODES
+    {
+        LPDIRECTDRAW7               pDD;
+        std::string                 strName;
+        std::vector<DDSURFACEDESC2> modes;
+    };
+
+    //-----------------------------------------------------------------------------
+    HRESULT CALLBACK CollectDisplayModesCallback(DDSURFACEDESC2* pddsd, VOID* pContext)
+    {
+        static_cast<DDVIDEOMODES*>(pContext)->modes.push_back(*pddsd);
+        return DDENUMRET_OK;
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: DDProbeVideoModes()
+    // Desc: Lists the modes, ModeX included, which takes exclusive mode. That
+    //       is where a bad driver has been seen to hang, hence the watchdog.
+    //-----------------------------------------------------------------------------
+    void DDProbeVideoModes(VOID* pContext)
+    {
+        auto pModes = static_cast<DDVIDEOMODES*>(pContext);
+        const char* strName = pModes->strName.c_str();
+
+        // Get the current mode mode for this driver
+        DDSURFACEDESC2 ddsd = {};
+        ddsd.dwSize = sizeof(DDSURFACEDESC2);
+        HRESULT hr = PROBE_CALL("IDirectDraw7::GetDisplayMode", strName, pModes->pDD->GetDisplayMode(&ddsd));
+        if (FAILED(hr))
+            return;
+
+        // Get Mode with ModeX
+        PROBE_CALL("IDirectDraw7::SetCooperativeLevel", strName,
+            pModes->pDD->SetCooperativeLevel(g_hwndMain, DDSCL_FULLSCREEN | DDSCL_EXCLUSIVE |
+                DDSCL_ALLOWMODEX | DDSCL_NOWINDOWCHANGES));
+
+        PROBE_CALL("IDirectDraw7::EnumDisplayModes", strName,
+            pModes->pDD->EnumDisplayModes(DDEDM_STANDARDVGAMODES, nullptr, pModes, CollectDisplayModesCallback));
+
+        PROBE_CALL("IDirectDraw7::SetCooperativeLevel", strName,
+            pModes->pDD->SetCooperativeLevel(g_hwndMain, DDSCL_NORMAL));
+    }
+
     //-----------------------------------------------------------------------------
     HRESULT CALLBACK EnumDisplayModesCallback(DDSURFACEDESC2* pddsd, VOID*)
     {
@@ -896,9 +1013,6 @@ namespace
     HRESULT DDDisplayVideoModes(LPARAM lParam1, LPARAM /*lParam2*/,
         _In_opt_ PRINTCBINFO* pPrintInfo)
     {
-        DWORD          mode;
-        DDSURFACEDESC2 ddsd;
-
         if (!pPrintInfo)
         {
             LVAddColumn(g_hwndLV, 0, "Mode", 24);
@@ -910,26 +1024,36 @@ namespace
 
         if (SUCCEEDED(DDCreate((GUID*)lParam1)))
         {
-            // Get the current mode mode for this driver
-            ddsd.dwSize = sizeof(DDSURFACEDESC2);
-            HRESULT hr = g_pDD->GetDisplayMode(&ddsd);
-            if (SUCCEEDED(hr))
+            auto pModes = new (std::nothrow) DDVIDEOMODES{ g_pDD, g_pDDName, {} };
+            if (!pModes)
+                return E_OUTOFMEMORY;
+
+            if (!WatchdogRun(DDProbeVideoModes, pModes))
             {
-                mode = MAKEMODE(ddsd.dwWidth, ddsd.dwHeight, ddsd.ddpfPixelFormat.dwRGBBitCount);
+                // pModes stays with the call that hung
+                DDAbandon();
+
+                if (pPrintInfo)
+                    return PrintStringLine("Timed out", pPrintInfo);
 
-                // Get Mode with ModeX
-                g_pDD->SetCooperativeLevel(g_hwndMain, DDSCL_FULLSCREEN | DDSCL_EXCLUSIVE |
-                    DDSCL_ALLOWMODEX | DDSCL_NOWINDOWCHANGES);
+                LVAddText(g_hwndLV, 0, "Timed out");
+                return S_OK;
+            }
 
+            for (auto& ddsd : pModes->modes)
+            {
                 if (pPrintInfo)
-                    g_pDD->EnumDisplayModes(DDEDM_STANDARDVGAMODES, nullptr, (VOID*)pPrintInfo,
-                        EnumDisplayModesCallbackPrint);
+                {
+                    if (EnumDisplayModesCallbackPrint(&ddsd, pPrintInfo) != DDENUMRET_OK)
+                        break;
+                }
                 else
-                    g_pDD->EnumDisplayModes(DDEDM_STANDARDVGAMODES, nullptr, UIntToPtr(mode),
-                        EnumDisplayModesCallback);
-
-                g_pDD->SetCooperativeLevel(g_hwndMain, DDSCL_NORMAL);
+                {
+                    EnumDisplayModesCallback(&ddsd, nullptr);
+                }
             }
+
+            delete pModes;
         }
 
         return S_OK;
@@ -938,9 +1062,9 @@ namespace
 
     //-----------------------------------------------------------------------------
     BOOL CALLBACK DDEnumCallBack(_In_ GUID* pid, _In_z_ LPSTR lpDriverDesc,
-        _In_opt_ LPSTR lpDriverName, _In_opt_ VOID* lpContext, _In_opt_ HMONITOR)
+        _In_opt_ LPSTR lpDriverName, _In_opt_ VOID* lpContext, _In_opt_ HMONITOR hMonitor)
     {
-        HTREEITEM hParent = (HTREEITEM)lpContext;
+        auto pDrivers = static_cast<std::vector<DDDRIVER>*>(lpContext);
         TCHAR szText[256];
 
         if (pid != (GUID*)-2)
@@ -952,18 +1076,82 @@ namespace
                     *pid = temp;
             }
 
-        // Add subnode to treeview
+        // Name the node after the driver
         if (lpDriverName && *lpDriverName)
             sprintf_s(szText, sizeof(szText), "%s (%s)", lpDriverDesc, lpDriverName);
         else
             strcpy_s(szText, sizeof(szText), lpDriverDesc);
         szText[255] = TEXT('\0');
 
-        DDCapDefs[0].strName = szText;
-        AddCapsToTV(hParent, DDCapDefs, (LPARAM)pid);
+        DDDRIVER driver = { pid, szText, {} };
+
+        // The primary display driver doesn't name a monitor
+        if (!hMonitor)
+            hMonitor = MonitorFromPoint(POINT{ 0, 0 }, MONITOR_DEFAULTTOPRIMARY);
+        (void)DXGI_GetMonitorAdapter(hMonitor, driver.AdapterLuid);
+
+        pDrivers->push_back(std::move(driver));
 
         return(DDENUMRET_OK);
     }
+
+
+    //-----------------------------------------------------------------------------
+    HRESULT EnumDrivers(std::vector<DDDRIVER>& drivers)
+    {
+        return PROBE_CALL("DirectDrawEnumerateEx", nullptr, g_directDrawEnumerateEx(DDEnumCallBack, &drivers,
+            DDENUM_ATTACHEDSECONDARYDEVICES |
+            DDENUM_DETACHEDSECONDARYDEVICES |
+            DDENUM_NONDISPLAYDEVICES));
+    }
+
+
+    //-----------------------------------------------------------------------------
+    VOID AddDriverTree(HTREEITEM hParent, const DDDRIVER& driver)
+    {
+        DDCapDefs[0].strName = driver.strName.c_str();
+        AddCapsToTV(hParent, DDCapDefs, (LPARAM)driver.pGUID);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    BOOL IsAllocatedGUID(const GUID* pGUID)
+    {
+        return (pGUID != (GUID*)-2) && (HIWORD(pGUID) != 0);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    BOOL IsSameDriver(const DDDRIVER& driver1, const DDDRIVER& driver2)
+    {
+        BOOL bSameGUID = (IsAllocatedGUID(driver1.pGUID) && IsAllocatedGUID(driver2.pGUID))
+            ? IsEqualGUID(*driver1.pGUID, *driver2.pGUID)
+            : (driver1.pGUID == driver2.pGUID);
+
+        return bSameGUID && (driver1.strName == driver2.strName)
+            && IsSameLuid(driver1.AdapterLuid, driver2.AdapterLuid);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Driver nodes are in the order they're enumerated
+    int CALLBACK CompareDriverNodes(LPARAM lParam1, LPARAM lParam2, LPARAM /*lParamSort*/)
+    {
+        auto rank = [](LPARAM lParam) -> size_t
+        {
+            auto pni = reinterpret_cast<const NODEINFO*>(lParam);
+            for (size_t i = 0; pni && i < g_ddDrivers.size(); ++i)
+            {
+                if (reinterpret_cast<LPARAM>(g_ddDrivers[i].pGUID) == pni->lParam1)
+                    return i;
+            }
+            return g_ddDrivers.size();
+        };
+
+        size_t rank1 = rank(lParam1);
+        size_t rank2 = rank(lParam2);
+        return (rank1 < rank2) ? -1 : (rank1 > rank2) ? 1 : 0;
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -985,6 +1173,8 @@ VOID DD_Init()
 //-----------------------------------------------------------------------------
 VOID DD_FillTree(HWND hwndTV)
 {
+    PROBESCOPE probeScope(PROBE_PHASE, "DD_FillTree", nullptr);
+
     if (!g_directDrawEnumerateEx)
         return;
 
@@ -995,10 +1185,10 @@ VOID DD_FillTree(HWND hwndTV)
         nullptr, 0, 0);
 
     // Add Display Driver node(s) and capability nodes to treeview
-    g_directDrawEnumerateEx(DDEnumCallBack, hTree,
-        DDENUM_ATTACHEDSECONDARYDEVICES |
-        DDENUM_DETACHEDSECONDARYDEVICES |
-        DDENUM_NONDISPLAYDEVICES);
+    (void)EnumDrivers(g_ddDrivers);
+    for (const auto& driver : g_ddDrivers)
+        AddDriverTree(hTree, driver);
+    g_hTreeDD = hTree;
 
     // Hardware Emulation Layer (HEL) not supported on Windows 8,
     // so we no longer show it
@@ -1007,14 +1197,95 @@ VOID DD_FillTree(HWND hwndTV)
 }
 
 
+//-----------------------------------------------------------------------------
+// Name: DD_UpdateAdapters()
+// Desc: Replaces the nodes of the drivers on the adapters a device change
+//       removed or updated, and adds those of new drivers
+//-----------------------------------------------------------------------------
+VOID DD_UpdateAdapters(HWND hwndTV, const std::vector<ADAPTERCHANGE>& changes)
+{
+    if (!hwndTV || !g_hTreeDD || !g_directDrawEnumerateEx || g_bDDTimedOut || changes.empty())
+        return;
+
+    // The caps are read as they're shown, so let go of the object a driver
+    // that changed may have
+    SAFE_RELEASE(g_pDD);
+    g_pDDGUID = nullptr;
+    g_pDDName = "";
+
+    std::vector<DDDRIVER> drivers;
+    (void)EnumDrivers(drivers);
+
+    std::vector<BOOL> kept(drivers.size(), FALSE);
+    HTREEITEM hNext = nullptr;
+    for (HTREEITEM hChild = TreeView_GetChild(hwndTV, g_hTreeDD); hChild; hChild = hNext)
+    {
+        hNext = TreeView_GetNextSibling(hwndTV, hChild);
+
+        TV_ITEM tvi = {};
+        tvi.mask = TVIF_PARAM;
+        tvi.hItem = hChild;
+        auto pni = TreeView_GetItem(hwndTV, &tvi) ? reinterpret_cast<const NODEINFO*>(tvi.lParam) : nullptr;
+
+        const DDDRIVER* pOld = nullptr;
+        for (const auto& driver : g_ddDrivers)
+        {
+            if (pni && reinterpret_cast<LPARAM>(driver.pGUID) == pni->lParam1)
+                pOld = &driver;
+        }
+
+        size_t iKept = drivers.size();
+        if (pOld && !IsAdapterChanged(changes, pOld->AdapterLuid))
+        {
+            for (size_t i = 0; i < drivers.size() && iKept == drivers.size(); ++i)
+            {
+                if (!kept[i] && IsSameDriver(*pOld, drivers[i]))
+                    iKept = i;
+            }
+        }
+
+        if (iKept < drivers.size())
+        {
+            // The node goes on pointing at the GUID it was added with
+            if (IsAllocatedGUID(drivers[iKept].pGUID))
+                LocalFree(drivers[iKept].pGUID);
+            drivers[iKept].pGUID = pOld->pGUID;
+            kept[iKept] = TRUE;
+        }
+        else
+        {
+            TVDeleteNode(hwndTV, hChild);
+            if (pOld && IsAllocatedGUID(pOld->pGUID))
+                LocalFree(pOld->pGUID);
+        }
+    }
+
+    g_ddDrivers = std::move(drivers);
+    for (size_t i = 0; i < g_ddDrivers.size(); ++i)
+    {
+        if (!kept[i])
+            AddDriverTree(g_hTreeDD, g_ddDrivers[i]);
+    }
+
+    TVSORTCB sort = {};
+    sort.hParent = g_hTreeDD;
+    sort.lpfnCompare = CompareDriverNodes;
+    TreeView_SortChildrenCB(hwndTV, &sort, FALSE);
+}
+
+
 //-----------------------------------------------------------------------------
 // Name: DD_CleanUp()
 //-----------------------------------------------------------------------------
 VOID DD_CleanUp()
 {
     SAFE_RELEASE(g_pDD);
+    g_pDDName = "";
+    g_ddDrivers.clear();
+    g_hTreeDD = nullptr;
 
-    if (g_hInstDDraw)
+    // A call that hung may yet return into the DLL
+    if (g_hInstDDraw && !g_bDDTimedOut)
     {
         g_directDrawCreateEx = nullptr;
         g_directDrawEnumerateEx = nullptr;
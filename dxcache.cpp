@@ -0,0 +1,443 @@
+//-----------------------------------------------------------------------------
+// Name: dxcache.cpp
+//
+// Desc: DirectX Capabilities Viewer snapshots
+//
+//       A snapshot holds every node of the tree along with the caps recorded
+//       for it, and a key describing the adapters, their drivers and the OS.
+//
+//       The cache is a snapshot of the last headless capture. The next capture
+//       with the same key rebuilds the tree from it without creating any
+//       devices. Recordings are snapshots saved and loaded by name, and are
+//       replayed regardless of key so they can be viewed on any machine.
+//       Probe workers hand their shards of the tree back as snapshots too.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxview.h"
+#include "dxshard.h"
+#include "dxtrace.h"
+
+#include <shlobj.h>
+
+extern DWORD g_dwViewState;
+extern HWND  g_hwndTV;
+
+UINT DXGI_GetAdapterKeys(ADAPTERKEY* pKeys, UINT maxKeys);
+BOOL DXView_BuildSnapshot(HWND hwndTV, std::vector<uint8_t>& data);
+
+namespace
+{
+    const DWORD CACHE_MAX_SIZE = 64 * 1024 * 1024;
+
+    using LPRTLGETVERSION = LONG(WINAPI*)(PRTL_OSVERSIONINFOW);
+
+    std::vector<CAPMODEL*> g_snapshotModels;   // Replayed by nodes loaded from snapshots
+
+    //-----------------------------------------------------------------------------
+    BOOL GetCachePath(_Out_writes_(MAX_PATH) TCHAR* strPath)
+    {
+        if (FAILED(SHGetFolderPath(nullptr, CSIDL_LOCAL_APPDATA, nullptr, SHGFP_TYPE_CURRENT, strPath)))
+            return FALSE;
+
+        return (strcat_s(strPath, MAX_PATH, TEXT("\\dxview.cache")) == 0);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: BuildCacheKey()
+    // Desc: Everything that can change the captured output: the OS build, this
+    //       executable, the view options and each adapter along with its driver.
+    //       CapReadSnapshotAdapters reads the adapters back, so keep it in step.
+    //-----------------------------------------------------------------------------
+    void BuildCacheKey(std::vector<uint8_t>& key)
+    {
+        CapWriteU32(key, CAPSNAPSHOT_VERSION);
+
+        // GetVersionEx reports whatever the manifest allows, so ask ntdll
+        RTL_OSVERSIONINFOW osvi = {};
+        osvi.dwOSVersionInfoSize = sizeof(osvi);
+        auto pfnRtlGetVersion = reinterpret_cast<LPRTLGETVERSION>(
+            GetProcAddress(GetModuleHandle(TEXT("ntdll.dll")), "RtlGetVersion"));
+        if (pfnRtlGetVersion)
+            (void)pfnRtlGetVersion(&osvi);
+
+        CapWriteU32(key, osvi.dwMajorVersion);
+        CapWriteU32(key, osvi.dwMinorVersion);
+        CapWriteU32(key, osvi.dwBuildNumber);
+
+        auto pDosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(GetModuleHandle(nullptr));
+        auto pNtHeaders = reinterpret_cast<const IMAGE_NT_HEADERS*>(
+            reinterpret_cast<const BYTE*>(pDosHeader) + pDosHeader->e_lfanew);
+        CapWriteU32(key, pNtHeaders->FileHeader.TimeDateStamp);
+
+        // The 9Ex view only depends on the OS, and each model checks it anyway
+        CapWriteU32(key, g_dwViewState);
+
+        UINT numAdapters = DXGI_GetAdapterKeys(nullptr, 0);
+        std::vector<ADAPTERKEY> adapters(numAdapters);
+        if (numAdapters > 0)
+            numAdapters = __min(numAdapters, DXGI_GetAdapterKeys(adapters.data(), numAdapters));
+
+        CapWriteU32(key, numAdapters);
+        for (UINT i = 0; i < numAdapters; ++i)
+        {
+            const ADAPTERKEY& adapter = adapters[i];
+            CapWriteU32(key, adapter.AdapterLuid.LowPart);
+            CapWriteU32(key, static_cast<uint32_t>(adapter.AdapterLuid.HighPart));
+            CapWriteU32(key, adapter.VendorId);
+            CapWriteU32(key, adapter.DeviceId);
+            CapWriteU32(key, adapter.SubSysId);
+            CapWriteU32(key, adapter.Revision);
+            CapWriteU32(key, static_cast<uint32_t>(adapter.DriverVersion));
+            CapWriteU32(key, static_cast<uint32_t>(adapter.DriverVersion >> 32));
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: RecordedCaps()
+    // Desc: Display callback for nodes loaded from a snapshot. lParam1 is the
+    //       recorded model, which is replayed instead of querying any device.
+    //-----------------------------------------------------------------------------
+    HRESULT RecordedCaps(LPARAM lParam1, LPARAM /*lParam2*/, PRINTCBINFO* pPrintInfo)
+    {
+        auto pRecorded = reinterpret_cast<const CAPMODEL*>(lParam1);
+        if (!pRecorded)
+            return E_FAIL;
+
+        if (pPrintInfo)
+        {
+            if (pPrintInfo->pModel)
+            {
+                pPrintInfo->pModel->rows = pRecorded->rows;
+                pPrintInfo->pModel->caps = pRecorded->caps;
+                pPrintInfo->pModel->capRows = pRecorded->capRows;
+                pPrintInfo->pModel->list = pRecorded->list;
+                return S_OK;
+            }
+
+            return PrintCapModel(*pRecorded, pPrintInfo);
+        }
+
+        // Shown as it was recorded, columns and all
+        if (!pRecorded->list.columns.empty())
+        {
+            for (size_t i = 0; i < pRecorded->list.columns.size(); ++i)
+            {
+                const CAPLISTCOLUMN& column = pRecorded->list.columns[i];
+                LVAddColumn(g_hwndLV, static_cast<int>(i), column.name.c_str(), static_cast<int>(column.width));
+            }
+
+            for (const auto& row : pRecorded->list.rows)
+            {
+                for (const auto& cell : row)
+                    LVAddText(g_hwndLV, static_cast<int>(cell.col), "%s", cell.text.c_str());
+            }
+
+            return S_OK;
+        }
+
+        // Nodes recorded without their list show the name and value of each row
+        AddColsToLV();
+        for (const auto& row : pRecorded->rows)
+        {
+            if (row.cells.empty())
+                continue;
+
+            LVAddText(g_hwndLV, 0, "%s", row.Name());
+            if (row.cells.size() > 1)
+                LVAddText(g_hwndLV, 1, "%s", row.Value());
+        }
+
+        return S_OK;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: SnapshotSink
+    // Desc: Appends each node of the tree to the snapshot file contents
+    //-----------------------------------------------------------------------------
+    struct SnapshotSink : public CAPSINK
+    {
+        std::vector<uint8_t>* pData;
+
+        HRESULT OnNode(LPCSTR strText, DWORD dwDepth, const CAPMODEL* pModel) override
+        {
+            CapWriteSnapshotNode(*pData, dwDepth, strText, strlen(strText), pModel);
+            return S_OK;
+        }
+
+        // So a replay shows every column the node showed
+        BOOL WantsLists() const override { return TRUE; }
+    };
+
+
+    //-----------------------------------------------------------------------------
+    BOOL ReadSnapshotFile(LPCTSTR strPath, std::vector<uint8_t>& data)
+    {
+        HANDLE hFile = CreateFile(strPath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE)
+            return FALSE;
+
+        BOOL fResult = FALSE;
+        LARGE_INTEGER size = {};
+        if (GetFileSizeEx(hFile, &size) && size.QuadPart > 0 && size.QuadPart <= CACHE_MAX_SIZE)
+        {
+            data.resize(static_cast<size_t>(size.QuadPart));
+
+            DWORD cbRead = 0;
+            fResult = ReadFile(hFile, data.data(), static_cast<DWORD>(data.size()), &cbRead, nullptr)
+                && (cbRead == data.size());
+        }
+
+        CloseHandle(hFile);
+        return fResult;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    BOOL WriteSnapshotFile(LPCTSTR strPath, const std::vector<uint8_t>& data)
+    {
+        HANDLE hFile = CreateFile(strPath, GENERIC_WRITE, 0, nullptr,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE)
+            return FALSE;
+
+        DWORD cbWritten = 0;
+        BOOL fResult = WriteFile(hFile, data.data(), static_cast<DWORD>(data.size()), &cbWritten, nullptr)
+            && (cbWritten == data.size());
+        CloseHandle(hFile);
+
+        // Don't leave a truncated snapshot behind
+        if (!fResult)
+            DeleteFile(strPath);
+
+        return fResult;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: LoadSnapshot()
+    // Desc: Adds the nodes of a snapshot to the tree. When bCheckKey is set the
+    //       snapshot is only used if it was written on this same configuration.
+    //-----------------------------------------------------------------------------
+    BOOL LoadSnapshot(const std::vector<uint8_t>& data, BOOL bCheckKey)
+    {
+        const uint8_t* pData = data.data();
+        const uint8_t* pEnd = pData + data.size();
+
+        std::string snapshotKey;
+        uint32_t version = 0;
+        if (!CapReadSnapshotHeader(pData, pEnd, snapshotKey, version))
+            return FALSE;
+
+        if (bCheckKey)
+        {
+            std::vector<uint8_t> key;
+            BuildCacheKey(key);
+            if (snapshotKey.size() != key.size() || memcmp(snapshotKey.data(), key.data(), key.size()) != 0)
+                return FALSE;
+        }
+        else if (version != CAPSNAPSHOT_VERSION)
+        {
+            // Only the format version has to match to replay another machine's snapshot
+            return FALSE;
+        }
+
+        // Parse everything before touching the tree so a bad file leaves it empty
+        std::vector<CAPSNAPSHOTNODE> nodes;
+        if (!CapReadSnapshotNodes(pData, pEnd, nodes))
+            return FALSE;
+
+        // The nodes' display callbacks reference these until DXView_FreeSnapshot
+        for (auto& node : nodes)
+        {
+            if (node.pModel)
+                g_snapshotModels.push_back(node.pModel);
+        }
+
+        BOOL fResult = TRUE;
+        std::vector<HTREEITEM> parents;
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            const CAPSNAPSHOTNODE& node = nodes[i];
+            BOOL bKids = (i + 1 < nodes.size()) && (nodes[i + 1].depth > node.depth);
+            HTREEITEM hParent = node.depth ? parents[node.depth - 1] : TVI_ROOT;
+
+            HTREEITEM hItem = TVAddNode(hParent, node.text.c_str(), bKids,
+                node.depth ? IDI_CAPS : IDI_DIRECTX,
+                node.pModel ? RecordedCaps : nullptr, reinterpret_cast<LPARAM>(node.pModel), 0);
+            if (!hItem)
+            {
+                fResult = FALSE;
+                break;
+            }
+
+            parents.resize(node.depth + 1);
+            parents[node.depth] = hItem;
+        }
+
+        if (!fResult)
+        {
+            if (g_hwndTV)
+                TreeView_DeleteAllItems(g_hwndTV);
+            else
+                TVFreeHeadlessTree();
+        }
+
+        return fResult;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: SaveSnapshot()
+    // Desc: Writes the tree, and every node's caps, along with this machine's key
+    //-----------------------------------------------------------------------------
+    BOOL SaveSnapshot(HWND hwndTV, LPCTSTR strPath)
+    {
+        std::vector<uint8_t> data;
+        if (!DXView_BuildSnapshot(hwndTV, data))
+            return FALSE;
+
+        return WriteSnapshotFile(strPath, data);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_BuildSnapshot()
+// Desc: The tree, and every node's caps, along with this machine's key, as a
+//       snapshot file holds them
+//-----------------------------------------------------------------------------
+BOOL DXView_BuildSnapshot(HWND hwndTV, std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> key;
+    BuildCacheKey(key);
+
+    data.clear();
+    CapWriteU32(data, CAPSNAPSHOT_MAGIC);
+    CapWriteString(data, reinterpret_cast<const char*>(key.data()), key.size());
+
+    SnapshotSink sink;
+    sink.pData = &data;
+    return SUCCEEDED(TVWalkModels(hwndTV, &sink));
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_LoadShards()
+// Desc: Fills the tree from what the probe workers wrote, merged under this
+//       machine's key, replaying it as a recording is
+//-----------------------------------------------------------------------------
+BOOL DXView_LoadShards(const CAPSHARD* pShards, size_t numShards)
+{
+    PROBESCOPE probeScope(PROBE_PHASE, "DXView_LoadShards", nullptr);
+
+    std::vector<uint8_t> key;
+    BuildCacheKey(key);
+
+    std::vector<uint8_t> data;
+    CapMergeShards(pShards, numShards, std::string(key.begin(), key.end()), data);
+
+    return LoadSnapshot(data, FALSE);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_LoadCache()
+// Desc: Fills the headless tree from the cache if it was written on this same
+//       configuration. Returns FALSE, leaving the tree empty, if it wasn't.
+//-----------------------------------------------------------------------------
+BOOL DXView_LoadCache()
+{
+    PROBESCOPE probeScope(PROBE_PHASE, "DXView_LoadCache", nullptr);
+
+    if (g_hwndTV)
+        return FALSE;
+
+    TCHAR strPath[MAX_PATH];
+    std::vector<uint8_t> data;
+    if (!GetCachePath(strPath) || !ReadSnapshotFile(strPath, data))
+        return FALSE;
+
+    return LoadSnapshot(data, TRUE);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_SaveCache()
+// Desc: Saves the headless tree, and every node's caps, for DXView_LoadCache
+//-----------------------------------------------------------------------------
+VOID DXView_SaveCache()
+{
+    PROBESCOPE probeScope(PROBE_PHASE, "DXView_SaveCache", nullptr);
+
+    if (g_hwndTV)
+        return;
+
+    TCHAR strPath[MAX_PATH];
+    if (GetCachePath(strPath))
+        (void)SaveSnapshot(nullptr, strPath);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_LoadRecording()
+// Desc: Fills the tree, or the headless tree when there is no TreeView, from a
+//       recording made on any machine. Nothing is queried from the devices
+//       here; every node replays the caps that were recorded for it.
+//-----------------------------------------------------------------------------
+BOOL DXView_LoadRecording(LPCTSTR strFile)
+{
+    PROBESCOPE probeScope(PROBE_PHASE, "DXView_LoadRecording", nullptr);
+
+    std::vector<uint8_t> data;
+    if (!strFile || !*strFile || !ReadSnapshotFile(strFile, data))
+        return FALSE;
+
+    return LoadSnapshot(data, FALSE);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_ReplaySnapshot()
+// Desc: As DXView_LoadRecording, from a recording already in memory
+//-----------------------------------------------------------------------------
+BOOL DXView_ReplaySnapshot(const std::vector<uint8_t>& data)
+{
+    return LoadSnapshot(data, FALSE);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_SaveRecording()
+// Desc: Records the whole tree, probing anything not yet expanded, so it can
+//       be replayed elsewhere with DXView_LoadRecording
+//-----------------------------------------------------------------------------
+BOOL DXView_SaveRecording(HWND hwndTV, LPCTSTR strFile)
+{
+    PROBESCOPE probeScope(PROBE_PHASE, "DXView_SaveRecording", nullptr);
+
+    if (!strFile || !*strFile)
+        return FALSE;
+
+    return SaveSnapshot(hwndTV, strFile);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_FreeSnapshot()
+// Desc: Frees the models of every snapshot loaded. The nodes that replayed
+//       them must be gone by now.
+//-----------------------------------------------------------------------------
+VOID DXView_FreeSnapshot()
+{
+    for (auto pModel : g_snapshotModels)
+        delete pModel;
+    g_snapshotModels.clear();
+}
@@ -0,0 +1,1172 @@
+//-----------------------------------------------------------------------------
+// Name: dxcapsbench.cpp
+//
+// Desc: Measures the viewer's device-independent stages over snapshots
+//       recorded with dxview -record, or over synthetic ones when none are
+//       given, so it runs on any machine without a GPU
+//
+//       dxcapsbench [-adapters:n] [-time:ms] [-csv:file] [-json:file] [snapshot ...]
+//
+//       Each stage runs for at least the given time per input and reports
+//       nodes, rows and bytes per second along with heap allocations per
+//       run. The stages are what the viewer does between the driver and the
+//       file: building the tree from a snapshot, capturing each node's rows
+//       as its display callback does, laying them out as the text export
+//       does, writing the snapshot back, and the search index, store and
+//       diff built on top.
+//
+//       The Windows build links the viewer itself, and also times its
+//       Direct3D 9 tree building over a table-driven stub of -adapters:n
+//       adapters, with the "Render Format Compatibility" subtrees filled on
+//       expand (fill9-lazy) and up front (fill9-eager). For these stages
+//       the rows are the driver calls made. It also replays each input into
+//       the viewer's tree, as -replay does, and times every node's display
+//       callback (callbacks) and the viewer's own JSON, NDJSON and text file
+//       writers over it (save-json, save-ndjson, save-text).
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxsearch.h"
+#include "dxstore.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+
+#ifdef _WIN32
+#include "dxview.h"
+#include <d3d9.h>
+
+VOID DXG_InitWith(IDirect3D9* pD3D);
+VOID DXG_SetEagerFill(BOOL bEager);
+VOID DXG_FillTree(HWND hwndTV);
+VOID DXG_CleanUp();
+BOOL DXView_ReplaySnapshot(const std::vector<uint8_t>& data);
+VOID DXView_FreeSnapshot();
+BOOL DXView_SaveJson(HWND hwndTV, LPCTSTR strFile, BOOL bNDJSON);
+BOOL DXView_OnHeadlessFile(LPCTSTR strFile);
+#endif
+
+namespace
+{
+    const size_t SNAPSHOT_MAX_SIZE = 64 * 1024 * 1024;
+
+    // Counted by the operator new replacements below. Stages run on one
+    // thread, so a plain counter is enough.
+    size_t g_allocations = 0;
+
+    struct BENCHINPUT
+    {
+        std::string             name;
+        std::vector<uint8_t>    data;       // The snapshot file
+        CAPSNAPSHOT             snapshot;   // data, already loaded, for the stages that start from the tree
+        uint32_t                numAdapters = 0;    // Of the stub, for the stages run over it instead
+    };
+
+    // What one run of a stage got through
+    struct BENCHCOUNTS
+    {
+        uint64_t        nodes;
+        uint64_t        rows;
+        uint64_t        bytes;
+    };
+
+    struct BENCHRESULT
+    {
+        const char*     strStage;
+        std::string     input;
+        uint32_t        runs;
+        double          seconds;        // For all the runs
+        BENCHCOUNTS     counts;         // Of one run
+        double          allocations;    // Per run
+    };
+
+    typedef void (*LPBENCHSTAGE)(const BENCHINPUT& input, BENCHCOUNTS& counts);
+
+    //-----------------------------------------------------------------------------
+    uint64_t CountRows(const CAPSNAPSHOT& snapshot)
+    {
+        uint64_t rows = 0;
+        for (const auto& node : snapshot.nodes)
+        {
+            if (node.pModel)
+                rows += node.pModel->rows.size();
+        }
+        return rows;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: BenchLoad()
+    // Desc: Parses a snapshot into its nodes and models, as -replay and the
+    //       cache do before building the tree
+    //-----------------------------------------------------------------------------
+    void BenchLoad(const BENCHINPUT& input, BENCHCOUNTS& counts)
+    {
+        CAPSNAPSHOT snapshot;
+        if (!snapshot.Load(input.data.data(), input.data.size()))
+            return;
+
+        counts.nodes = snapshot.nodes.size();
+        counts.rows = CountRows(snapshot);
+        counts.bytes = input.data.size();
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: BenchCapture()
+    // Desc: Feeds every row through the capture interface the Print* helpers
+    //       use, which is all a display callback does once it has its caps
+    //-----------------------------------------------------------------------------
+    void BenchCapture(const BENCHINPUT& input, BENCHCOUNTS& counts)
+    {
+        for (const auto& node : input.snapshot.nodes)
+        {
+            ++counts.nodes;
+            if (!node.pModel)
+                continue;
+
+            CAPMODEL model;
+            for (const auto& row : node.pModel->rows)
+            {
+                model.SetRowKind(row.kind, row.value);
+                for (const auto& cell : row.cells)
+                {
+                    model.AddCell(cell.x, cell.text.c_str(), cell.text.length());
+                    counts.bytes += cell.text.length();
+                }
+                model.EndRow();
+            }
+            model.Flush();
+
+            counts.rows += model.rows.size();
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: BenchRender()
+    // Desc: Lays out each node and row as lines of text, in the layout the
+    //       text file export uses
+    //-----------------------------------------------------------------------------
+    void BenchRender(const BENCHINPUT& input, BENCHCOUNTS& counts)
+    {
+        const uint32_t c_tabSize = 3;
+
+        std::string text;
+        for (const auto& node : input.snapshot.nodes)
+        {
+            ++counts.nodes;
+
+            text.append(node.depth * c_tabSize, ' ');
+            text += node.text;
+            text += '\n';
+
+            if (!node.pModel)
+                continue;
+
+            const size_t xIndent = (node.depth + 2) * c_tabSize;
+            for (const auto& row : node.pModel->rows)
+            {
+                size_t lineStart = text.size();
+                for (const auto& cell : row.cells)
+                {
+                    size_t x = lineStart + xIndent + cell.x;
+                    if (text.size() < x)
+                        text.append(x - text.size(), ' ');
+                    else if (text.size() > lineStart)
+                        text += ' ';
+                    text += cell.text;
+                }
+                text += '\n';
+                ++counts.rows;
+            }
+        }
+
+        counts.bytes = text.size();
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: BenchSerialize()
+    // Desc: Writes the tree back out in the snapshot form -record and the
+    //       cache use
+    //-----------------------------------------------------------------------------
+    void BenchSerialize(const BENCHINPUT& input, BENCHCOUNTS& counts)
+    {
+        std::vector<uint8_t> data;
+        CapWriteU32(data, CAPSNAPSHOT_MAGIC);
+        CapWriteString(data, input.snapshot.key.data(), input.snapshot.key.size());
+
+        for (const auto& node : input.snapshot.nodes)
+        {
+            CapWriteSnapshotNode(data, node.depth, node.text.data(), node.text.size(), node.pModel);
+            if (node.pModel)
+                counts.rows += node.pModel->rows.size();
+            ++counts.nodes;
+        }
+
+        counts.bytes = data.size();
+    }
+
+
+    //-----------------------------------------------------------------------------
+    void BenchIndex(const BENCHINPUT& input, BENCHCOUNTS& counts)
+    {
+        CAPSEARCHINDEX index;
+        index.Build(input.snapshot.nodes);
+
+        counts.nodes = input.snapshot.nodes.size();
+        counts.rows = index.entries.size() - counts.nodes;
+        counts.bytes = input.data.size();
+    }
+
+
+    //-----------------------------------------------------------------------------
+    void BenchStore(const BENCHINPUT& input, BENCHCOUNTS& counts)
+    {
+        CAPSTOREBUILDER builder;
+        builder.AddSnapshot(input.name.c_str(), input.snapshot);
+
+        std::vector<uint8_t> data;
+        builder.Write(data);
+
+        counts.nodes = input.snapshot.nodes.size();
+        counts.rows = CountRows(input.snapshot);
+        counts.bytes = data.size();
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: BenchDiff()
+    // Desc: Compares the snapshot with itself, so every node and row is lined
+    //       up and compared and nothing is reported
+    //-----------------------------------------------------------------------------
+    void BenchDiff(const BENCHINPUT& input, BENCHCOUNTS& counts)
+    {
+        std::vector<CAPDIFF> diffs;
+        CapDiffSnapshots(input.snapshot, input.snapshot, diffs);
+
+        counts.nodes = input.snapshot.nodes.size();
+        counts.rows = CountRows(input.snapshot) + diffs.size();
+        counts.bytes = input.data.size();
+    }
+
+    const struct
+    {
+        const char*     strName;
+        LPBENCHSTAGE    pfnStage;
+    } c_stages[] =
+    {
+        { "load",       BenchLoad },
+        { "capture",    BenchCapture },
+        { "render",     BenchRender },
+        { "serialize",  BenchSerialize },
+        { "index",      BenchIndex },
+        { "store",      BenchStore },
+        { "diff",       BenchDiff },
+    };
+
+#ifdef _WIN32
+    //-----------------------------------------------------------------------------
+    // What the stub Direct3D 9 reports for a format, on every adapter
+    //-----------------------------------------------------------------------------
+    struct STUBFORMAT9
+    {
+        D3DFORMAT   fmt;
+        DWORD       dwUsage;    // D3DUSAGE_* flags CheckDeviceFormat accepts, queries included
+        BOOL        bDisplay;   // An adapter and back buffer format for CheckDeviceType
+        UINT        msMask;     // Bit n set if D3DMULTISAMPLE_TYPE n is supported
+    };
+
+    const DWORD STUB9_TEXTURE = D3DUSAGE_QUERY_FILTER | D3DUSAGE_QUERY_SRGBREAD
+        | D3DUSAGE_QUERY_VERTEXTEXTURE | D3DUSAGE_QUERY_WRAPANDMIP;
+    const DWORD STUB9_TARGET = D3DUSAGE_RENDERTARGET | D3DUSAGE_AUTOGENMIPMAP
+        | D3DUSAGE_QUERY_POSTPIXELSHADER_BLENDING | D3DUSAGE_QUERY_SRGBWRITE | STUB9_TEXTURE;
+    const DWORD STUB9_DEPTH = D3DUSAGE_DEPTHSTENCIL;
+
+    const UINT STUB9_MSAA = (1u << D3DMULTISAMPLE_NONE) | (1u << D3DMULTISAMPLE_NONMASKABLE)
+        | (1u << D3DMULTISAMPLE_2_SAMPLES) | (1u << D3DMULTISAMPLE_4_SAMPLES) | (1u << D3DMULTISAMPLE_8_SAMPLES);
+    const UINT STUB9_NOMSAA = (1u << D3DMULTISAMPLE_NONE);
+
+    const STUBFORMAT9 c_stubFormats9[] =
+    {
+        { D3DFMT_A2R10G10B10,   STUB9_TARGET,   TRUE,   STUB9_MSAA },
+        { D3DFMT_A8R8G8B8,      STUB9_TARGET,   TRUE,   STUB9_MSAA },
+        { D3DFMT_X8R8G8B8,      STUB9_TARGET,   TRUE,   STUB9_MSAA },
+        { D3DFMT_A1R5G5B5,      STUB9_TARGET,   TRUE,   STUB9_MSAA },
+        { D3DFMT_X1R5G5B5,      STUB9_TARGET,   TRUE,   STUB9_MSAA },
+        { D3DFMT_R5G6B5,        STUB9_TARGET,   TRUE,   STUB9_MSAA },
+        { D3DFMT_A8B8G8R8,      STUB9_TARGET,   FALSE,  STUB9_MSAA },
+        { D3DFMT_G16R16,        STUB9_TARGET,   FALSE,  STUB9_MSAA },
+        { D3DFMT_A16B16G16R16,  STUB9_TARGET,   FALSE,  STUB9_MSAA },
+        { D3DFMT_R16F,          STUB9_TARGET,   FALSE,  STUB9_MSAA },
+        { D3DFMT_G16R16F,       STUB9_TARGET,   FALSE,  STUB9_MSAA },
+        { D3DFMT_A16B16G16R16F, STUB9_TARGET,   FALSE,  STUB9_MSAA },
+        { D3DFMT_R32F,          STUB9_TARGET,   FALSE,  STUB9_NOMSAA },
+        { D3DFMT_G32R32F,       STUB9_TARGET,   FALSE,  STUB9_NOMSAA },
+        { D3DFMT_A32B32G32R32F, STUB9_TARGET,   FALSE,  STUB9_NOMSAA },
+        { D3DFMT_A8,            STUB9_TEXTURE,  FALSE,  0 },
+        { D3DFMT_L8,            STUB9_TEXTURE,  FALSE,  0 },
+        { D3DFMT_A8L8,          STUB9_TEXTURE,  FALSE,  0 },
+        { D3DFMT_V8U8,          STUB9_TEXTURE,  FALSE,  0 },
+        { D3DFMT_DXT1,          STUB9_TEXTURE,  FALSE,  0 },
+        { D3DFMT_DXT3,          STUB9_TEXTURE,  FALSE,  0 },
+        { D3DFMT_DXT5,          STUB9_TEXTURE,  FALSE,  0 },
+        { D3DFMT_D16,           STUB9_DEPTH,    FALSE,  STUB9_MSAA },
+        { D3DFMT_D24X8,         STUB9_DEPTH,    FALSE,  STUB9_MSAA },
+        { D3DFMT_D24S8,         STUB9_DEPTH,    FALSE,  STUB9_MSAA },
+        { D3DFMT_D32F_LOCKABLE, STUB9_DEPTH,    FALSE,  STUB9_NOMSAA },
+    };
+
+    // Display modes the stub lists for each display format
+    const struct
+    {
+        UINT    width;
+        UINT    height;
+    } c_stubModes9[] =
+    {
+        { 640, 480 }, { 800, 600 }, { 1024, 768 }, { 1280, 720 }, { 1280, 1024 },
+        { 1600, 900 }, { 1920, 1080 }, { 2560, 1440 }, { 3840, 2160 },
+    };
+
+
+    //-----------------------------------------------------------------------------
+    const STUBFORMAT9* FindStubFormat9(D3DFORMAT fmt)
+    {
+        for (const auto& format : c_stubFormats9)
+        {
+            if (format.fmt == fmt)
+                return &format;
+        }
+        return nullptr;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: StubDirect3D9
+    // Desc: Answers the viewer's Direct3D 9 probes from c_stubFormats9 for any
+    //       number of identical HAL adapters, counting the calls made, so the
+    //       viewer's own tree building can be timed without a GPU
+    //-----------------------------------------------------------------------------
+    class StubDirect3D9 : public IDirect3D9
+    {
+    public:
+        explicit StubDirect3D9(UINT numAdapters) noexcept : m_cRef(1), m_numAdapters(numAdapters), m_numCalls(0) {}
+
+        uint64_t Calls() const { return m_numCalls; }
+
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObj) override
+        {
+            if (!ppvObj)
+                return E_POINTER;
+
+            if (riid != __uuidof(IUnknown) && riid != __uuidof(IDirect3D9))
+            {
+                *ppvObj = nullptr;
+                return E_NOINTERFACE;
+            }
+
+            *ppvObj = static_cast<IDirect3D9*>(this);
+            AddRef();
+            return S_OK;
+        }
+
+        ULONG STDMETHODCALLTYPE AddRef() override
+        {
+            return ++m_cRef;
+        }
+
+        ULONG STDMETHODCALLTYPE Release() override
+        {
+            ULONG cRef = --m_cRef;
+            if (!cRef)
+                delete this;
+            return cRef;
+        }
+
+        HRESULT STDMETHODCALLTYPE RegisterSoftwareDevice(void* /*pInitializeFunction*/) override
+        {
+            ++m_numCalls;
+            return D3DERR_NOTAVAILABLE;
+        }
+
+        UINT STDMETHODCALLTYPE GetAdapterCount() override
+        {
+            ++m_numCalls;
+            return m_numAdapters;
+        }
+
+        HRESULT STDMETHODCALLTYPE GetAdapterIdentifier(UINT Adapter, DWORD /*Flags*/, D3DADAPTER_IDENTIFIER9* pIdentifier) override
+        {
+            ++m_numCalls;
+            if (Adapter >= m_numAdapters || !pIdentifier)
+                return D3DERR_INVALIDCALL;
+
+            *pIdentifier = {};
+            strcpy_s(pIdentifier->Driver, "stub9.dll");
+            sprintf_s(pIdentifier->Description, "Stub Direct3D 9 Adapter %u", Adapter);
+            sprintf_s(pIdentifier->DeviceName, "\\\\.\\DISPLAY%u", Adapter + 1);
+            pIdentifier->DriverVersion.QuadPart = 0x001F000000000001;
+            pIdentifier->VendorId = 0x1414;
+            pIdentifier->DeviceId = 0x8c + Adapter;
+            pIdentifier->WHQLLevel = 1;
+            return D3D_OK;
+        }
+
+        UINT STDMETHODCALLTYPE GetAdapterModeCount(UINT Adapter, D3DFORMAT Format) override
+        {
+            ++m_numCalls;
+            return IsDisplayFormat(Adapter, D3DDEVTYPE_HAL, Format) ? static_cast<UINT>(std::size(c_stubModes9)) : 0;
+        }
+
+        HRESULT STDMETHODCALLTYPE EnumAdapterModes(UINT Adapter, D3DFORMAT Format, UINT Mode, D3DDISPLAYMODE* pMode) override
+        {
+            ++m_numCalls;
+            if (!IsDisplayFormat(Adapter, D3DDEVTYPE_HAL, Format) || Mode >= std::size(c_stubModes9) || !pMode)
+                return D3DERR_INVALIDCALL;
+
+            pMode->Width = c_stubModes9[Mode].width;
+            pMode->Height = c_stubModes9[Mode].height;
+            pMode->RefreshRate = 60;
+            pMode->Format = Format;
+            return D3D_OK;
+        }
+
+        HRESULT STDMETHODCALLTYPE GetAdapterDisplayMode(UINT Adapter, D3DDISPLAYMODE* pMode) override
+        {
+            ++m_numCalls;
+            if (Adapter >= m_numAdapters || !pMode)
+                return D3DERR_INVALIDCALL;
+
+            pMode->Width = 1920;
+            pMode->Height = 1080;
+            pMode->RefreshRate = 60;
+            pMode->Format = D3DFMT_X8R8G8B8;
+            return D3D_OK;
+        }
+
+        HRESULT STDMETHODCALLTYPE CheckDeviceType(UINT Adapter, D3DDEVTYPE DevType, D3DFORMAT AdapterFormat,
+            D3DFORMAT BackBufferFormat, BOOL /*bWindowed*/) override
+        {
+            ++m_numCalls;
+            return (IsDisplayFormat(Adapter, DevType, AdapterFormat) && IsDisplayFormat(Adapter, DevType, BackBufferFormat))
+                ? D3D_OK : D3DERR_NOTAVAILABLE;
+        }
+
+        HRESULT STDMETHODCALLTYPE CheckDeviceFormat(UINT Adapter, D3DDEVTYPE DeviceType, D3DFORMAT AdapterFormat,
+            DWORD Usage, D3DRESOURCETYPE RType, D3DFORMAT CheckFormat) override
+        {
+            ++m_numCalls;
+            if (!IsDisplayFormat(Adapter, DeviceType, AdapterFormat))
+                return D3DERR_NOTAVAILABLE;
+
+            const STUBFORMAT9* pFormat = FindStubFormat9(CheckFormat);
+            if (!pFormat || (Usage & ~pFormat->dwUsage))
+                return D3DERR_NOTAVAILABLE;
+
+            // Depth buffers are surfaces and 2D textures only
+            if ((pFormat->dwUsage & D3DUSAGE_DEPTHSTENCIL) && RType != D3DRTYPE_SURFACE && RType != D3DRTYPE_TEXTURE)
+                return D3DERR_NOTAVAILABLE;
+
+            return D3D_OK;
+        }
+
+        HRESULT STDMETHODCALLTYPE CheckDeviceMultiSampleType(UINT Adapter, D3DDEVTYPE DeviceType, D3DFORMAT SurfaceFormat,
+            BOOL /*Windowed*/, D3DMULTISAMPLE_TYPE MultiSampleType, DWORD* pQualityLevels) override
+        {
+            ++m_numCalls;
+            const STUBFORMAT9* pFormat = FindStubFormat9(SurfaceFormat);
+            if (!IsStubDevice(Adapter, DeviceType) || !pFormat
+                || static_cast<UINT>(MultiSampleType) > static_cast<UINT>(D3DMULTISAMPLE_16_SAMPLES)
+                || !((pFormat->msMask >> MultiSampleType) & 1))
+                return D3DERR_NOTAVAILABLE;
+
+            if (pQualityLevels)
+                *pQualityLevels = (MultiSampleType == D3DMULTISAMPLE_NONMASKABLE) ? 4 : 1;
+            return D3D_OK;
+        }
+
+        HRESULT STDMETHODCALLTYPE CheckDepthStencilMatch(UINT Adapter, D3DDEVTYPE DeviceType, D3DFORMAT AdapterFormat,
+            D3DFORMAT RenderTargetFormat, D3DFORMAT DepthStencilFormat) override
+        {
+            ++m_numCalls;
+            const STUBFORMAT9* pTarget = FindStubFormat9(RenderTargetFormat);
+            const STUBFORMAT9* pDepth = FindStubFormat9(DepthStencilFormat);
+            return (IsDisplayFormat(Adapter, DeviceType, AdapterFormat)
+                && pTarget && (pTarget->dwUsage & D3DUSAGE_RENDERTARGET)
+                && pDepth && (pDepth->dwUsage & D3DUSAGE_DEPTHSTENCIL)) ? D3D_OK : D3DERR_NOTAVAILABLE;
+        }
+
+        HRESULT STDMETHODCALLTYPE CheckDeviceFormatConversion(UINT Adapter, D3DDEVTYPE DeviceType, D3DFORMAT SourceFormat,
+            D3DFORMAT TargetFormat) override
+        {
+            ++m_numCalls;
+            return (IsDisplayFormat(Adapter, DeviceType, SourceFormat) && IsDisplayFormat(Adapter, DeviceType, TargetFormat))
+                ? D3D_OK : D3DERR_NOTAVAILABLE;
+        }
+
+        HRESULT STDMETHODCALLTYPE GetDeviceCaps(UINT Adapter, D3DDEVTYPE DeviceType, D3DCAPS9* pCaps) override
+        {
+            ++m_numCalls;
+            if (!IsStubDevice(Adapter, DeviceType) || !pCaps)
+                return D3DERR_INVALIDCALL;
+
+            *pCaps = {};
+            pCaps->DeviceType = DeviceType;
+            pCaps->AdapterOrdinal = Adapter;
+            pCaps->MaxTextureWidth = 8192;
+            pCaps->MaxTextureHeight = 8192;
+            pCaps->MaxVolumeExtent = 2048;
+            pCaps->MaxAnisotropy = 16;
+            pCaps->MaxSimultaneousTextures = 8;
+            pCaps->MaxPrimitiveCount = 0xFFFFFF;
+            pCaps->MaxVertexIndex = 0xFFFFFF;
+            pCaps->MaxStreams = 16;
+            pCaps->NumSimultaneousRTs = 4;
+            pCaps->VertexShaderVersion = D3DVS_VERSION(3, 0);
+            pCaps->PixelShaderVersion = D3DPS_VERSION(3, 0);
+            pCaps->MaxVertexShaderConst = 256;
+            pCaps->MaxPointSize = 8192.0f;
+            return D3D_OK;
+        }
+
+        HMONITOR STDMETHODCALLTYPE GetAdapterMonitor(UINT /*Adapter*/) override
+        {
+            ++m_numCalls;
+            return nullptr;
+        }
+
+        HRESULT STDMETHODCALLTYPE CreateDevice(UINT /*Adapter*/, D3DDEVTYPE /*DeviceType*/, HWND /*hFocusWindow*/,
+            DWORD /*BehaviorFlags*/, D3DPRESENT_PARAMETERS* /*pPresentationParameters*/,
+            IDirect3DDevice9** ppReturnedDeviceInterface) override
+        {
+            ++m_numCalls;
+            if (ppReturnedDeviceInterface)
+                *ppReturnedDeviceInterface = nullptr;
+            return D3DERR_NOTAVAILABLE;
+        }
+
+    private:
+        ~StubDirect3D9() = default;
+
+        // Only HAL devices, so the tree has no reference device nodes
+        bool IsStubDevice(UINT Adapter, D3DDEVTYPE DeviceType) const
+        {
+            return (Adapter < m_numAdapters) && (DeviceType == D3DDEVTYPE_HAL);
+        }
+
+        bool IsDisplayFormat(UINT Adapter, D3DDEVTYPE DeviceType, D3DFORMAT Format) const
+        {
+            const STUBFORMAT9* pFormat = FindStubFormat9(Format);
+            return IsStubDevice(Adapter, DeviceType) && pFormat && pFormat->bDisplay;
+        }
+
+        ULONG       m_cRef;
+        UINT        m_numAdapters;
+        uint64_t    m_numCalls;
+    };
+
+
+    //-----------------------------------------------------------------------------
+    // Name: BenchFill9()
+    // Desc: Builds the viewer's Direct3D 9 tree over the stub, in the headless
+    //       tree, counting its nodes and the driver calls made as its rows
+    //-----------------------------------------------------------------------------
+    void BenchFill9(UINT numAdapters, BOOL bEager, BENCHCOUNTS& counts)
+    {
+        auto pStub = new (std::nothrow) StubDirect3D9(numAdapters);
+        if (!pStub)
+            return;
+
+        // DXG_CleanUp releases the reference DXG_InitWith takes over
+        pStub->AddRef();
+        DXG_InitWith(pStub);
+        DXG_SetEagerFill(bEager);
+
+        DXG_FillTree(nullptr);
+
+        counts.nodes = TVCountNodes(nullptr);
+        counts.rows = pStub->Calls();
+
+        TVFreeHeadlessTree();
+        DXG_CleanUp();
+        pStub->Release();
+    }
+
+    void BenchFill9Lazy(const BENCHINPUT& input, BENCHCOUNTS& counts)
+    {
+        BenchFill9(input.numAdapters, FALSE, counts);
+    }
+
+    void BenchFill9Eager(const BENCHINPUT& input, BENCHCOUNTS& counts)
+    {
+        BenchFill9(input.numAdapters, TRUE, counts);
+    }
+
+    // Stages of the viewer itself, run over the stub rather than a snapshot
+    const struct
+    {
+        const char*     strName;
+        LPBENCHSTAGE    pfnStage;
+    } c_stubStages[] =
+    {
+        { "fill9-lazy",  BenchFill9Lazy },
+        { "fill9-eager", BenchFill9Eager },
+    };
+
+    // Where the file export stages write, made once in main
+    TCHAR g_szTempFile[MAX_PATH] = {};
+
+    // Counts what TVWalkModels hands over
+    struct COUNTSINK : public CAPSINK
+    {
+        BENCHCOUNTS     counts = {};
+
+        HRESULT OnNode(LPCSTR /*strText*/, DWORD /*dwDepth*/, const CAPMODEL* pModel) override
+        {
+            ++counts.nodes;
+            if (!pModel)
+                return S_OK;
+
+            for (const auto& row : pModel->rows)
+            {
+                for (const auto& cell : row.cells)
+                    counts.bytes += cell.text.length();
+            }
+            counts.rows += pModel->rows.size();
+            return S_OK;
+        }
+    };
+
+
+    //-----------------------------------------------------------------------------
+    // Name: BenchCallbacks()
+    // Desc: Runs every node's display callback in the replayed tree, as
+    //       selecting each node in the viewer would
+    //-----------------------------------------------------------------------------
+    void BenchCallbacks(const BENCHINPUT& /*input*/, BENCHCOUNTS& counts)
+    {
+        TVFreeNodeModels(nullptr);
+
+        COUNTSINK sink;
+        if (SUCCEEDED(TVWalkModels(nullptr, &sink)))
+            counts = sink.counts;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: BenchSaveFile()
+    // Desc: Writes the replayed tree with one of the viewer's file exports.
+    //       The display callbacks have run by then (in the warm-up run at the
+    //       latest), so this is the writer alone.
+    //-----------------------------------------------------------------------------
+    void BenchSaveFile(BOOL (*pfnSave)(LPCTSTR strFile), const BENCHINPUT& input, BENCHCOUNTS& counts)
+    {
+        WIN32_FILE_ATTRIBUTE_DATA attributes = {};
+        if (!pfnSave(g_szTempFile)
+            || !GetFileAttributesEx(g_szTempFile, GetFileExInfoStandard, &attributes))
+            return;
+
+        counts.nodes = input.snapshot.nodes.size();
+        counts.rows = CountRows(input.snapshot);
+        counts.bytes = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+    }
+
+    BOOL SaveJson(LPCTSTR strFile) { return DXView_SaveJson(nullptr, strFile, FALSE); }
+    BOOL SaveNDJson(LPCTSTR strFile) { return DXView_SaveJson(nullptr, strFile, TRUE); }
+
+    void BenchSaveJson(const BENCHINPUT& input, BENCHCOUNTS& counts)
+    {
+        BenchSaveFile(SaveJson, input, counts);
+    }
+
+    void BenchSaveNDJson(const BENCHINPUT& input, BENCHCOUNTS& counts)
+    {
+        BenchSaveFile(SaveNDJson, input, counts);
+    }
+
+    void BenchSaveText(const BENCHINPUT& input, BENCHCOUNTS& counts)
+    {
+        BenchSaveFile(DXView_OnHeadlessFile, input, counts);
+    }
+
+    // Stages of the viewer itself, run over each input replayed into its tree
+    const struct
+    {
+        const char*     strName;
+        LPBENCHSTAGE    pfnStage;
+    } c_replayStages[] =
+    {
+        { "callbacks",   BenchCallbacks },
+        { "save-json",   BenchSaveJson },
+        { "save-ndjson", BenchSaveNDJson },
+        { "save-text",   BenchSaveText },
+    };
+#endif
+
+
+    //-----------------------------------------------------------------------------
+    // Name: RunStage()
+    // Desc: One untimed run to warm up, then as many as fit in minTime
+    //-----------------------------------------------------------------------------
+    void RunStage(const char* strStage, LPBENCHSTAGE pfnStage, const BENCHINPUT& input,
+        std::chrono::milliseconds minTime, BENCHRESULT& result)
+    {
+        result = {};
+        result.strStage = strStage;
+        result.input = input.name;
+
+        pfnStage(input, result.counts);
+
+        BENCHCOUNTS counts = {};
+        size_t allocations = g_allocations;
+        auto start = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::steady_clock::duration::zero();
+        do
+        {
+            counts = {};
+            pfnStage(input, counts);
+            ++result.runs;
+            elapsed = std::chrono::steady_clock::now() - start;
+        } while (elapsed < minTime);
+
+        result.seconds = std::chrono::duration<double>(elapsed).count();
+        result.allocations = static_cast<double>(g_allocations - allocations) / result.runs;
+        result.counts = counts;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    bool ReadSnapshotFile(const char* strPath, std::vector<uint8_t>& data)
+    {
+        std::ifstream file(strPath, std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+
+        std::streamoff size = file.tellg();
+        if (size <= 0 || static_cast<size_t>(size) > SNAPSHOT_MAX_SIZE)
+            return false;
+
+        data.resize(static_cast<size_t>(size));
+        file.seekg(0);
+        return !!file.read(reinterpret_cast<char*>(data.data()), size);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: AddSyntheticRow()
+    // Desc: Rows laid out as the Print* helpers lay them out, name in the
+    //       first cell and value in the second
+    //-----------------------------------------------------------------------------
+    void AddSyntheticRow(CAPMODEL& model, CAPKIND kind, uint32_t value, const char* strName, const char* strValue)
+    {
+        model.SetRowKind(kind, value);
+        model.AddCell(0, strName, strlen(strName));
+        if (strValue)
+            model.AddCell(40, strValue, strlen(strValue));
+        model.EndRow();
+    }
+
+    void WriteSyntheticNode(std::vector<uint8_t>& data, uint32_t depth, const char* strText, const CAPMODEL* pModel)
+    {
+        CapWriteSnapshotNode(data, depth, strText, strlen(strText), pModel);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: BuildSyntheticSnapshot()
+    // Desc: A snapshot shaped like a capture of numAdapters adapters: adapter
+    //       details, display modes, a features node and a format subtree per
+    //       API, and a Direct3D 9 caps node, with values varying by adapter
+    //-----------------------------------------------------------------------------
+    void BuildSyntheticSnapshot(uint32_t numAdapters, std::vector<uint8_t>& data)
+    {
+        static const char* c_szLayouts[] =
+        {
+            "R32G32B32A32", "R32G32B32", "R16G16B16A16", "R32G32", "R10G10B10A2", "R11G11B10",
+            "R8G8B8A8", "R16G16", "R32", "R8G8", "R16", "R8", "B8G8R8A8", "B5G6R5", "BC1", "BC3", "BC7",
+        };
+        static const char* c_szTypes[] = { "TYPELESS", "UNORM", "SNORM", "UINT", "SINT", "FLOAT" };
+        static const char* c_szSupport[] =
+        {
+            "Texture2D", "Texture3D", "TextureCube", "ShaderLoad", "ShaderSample", "Mip", "RenderTarget",
+            "Blendable", "DepthStencil", "MultisampleRenderTarget", "MultisampleLoad", "TypedUAVLoad",
+        };
+        static const char* c_szApis[] = { "Direct3D 12", "Direct3D 11.4", "Direct3D 10.1" };
+
+        std::vector<uint8_t> key;
+        CapWriteU32(key, CAPSNAPSHOT_VERSION);
+        for (int i = 0; i < 5; ++i)
+            CapWriteU32(key, 0);
+        CapWriteU32(key, numAdapters);
+        for (uint32_t i = 0; i < numAdapters; ++i)
+        {
+            const uint32_t values[] = { i + 1, 0, 0x1000u + i, 0x2000u + i, 0, 1, i, 0x001F0000 };
+            for (uint32_t value : values)
+                CapWriteU32(key, value);
+        }
+
+        CapWriteU32(data, CAPSNAPSHOT_MAGIC);
+        CapWriteString(data, reinterpret_cast<const char*>(key.data()), key.size());
+
+        char szText[128];
+        char szValue[64];
+        WriteSyntheticNode(data, 0, "DXGI Devices", nullptr);
+        for (uint32_t iAdapter = 0; iAdapter < numAdapters; ++iAdapter)
+        {
+            CAPMODEL adapter;
+            snprintf(szText, sizeof(szText), "Synthetic Adapter %u", iAdapter);
+            AddSyntheticRow(adapter, CAPKIND_STRING, 0, "Description", szText);
+            snprintf(szValue, sizeof(szValue), "0x%04X", 0x1000u + iAdapter);
+            AddSyntheticRow(adapter, CAPKIND_HEX, 0x1000u + iAdapter, "VendorId", szValue);
+            snprintf(szValue, sizeof(szValue), "%u MB", 4096u << (iAdapter & 1));
+            AddSyntheticRow(adapter, CAPKIND_VALUE, 4096u << (iAdapter & 1), "DedicatedVideoMemory", szValue);
+            WriteSyntheticNode(data, 1, szText, &adapter);
+
+            CAPMODEL modes;
+            modes.SetRowKind(CAPKIND_TEXT, 0);
+            modes.AddCell(0, "Resolution", 10);
+            modes.AddCell(20, "Format", 6);
+            modes.AddCell(50, "Refresh", 7);
+            modes.EndRow();
+            for (uint32_t i = 0; i < 64; ++i)
+            {
+                modes.SetRowKind(CAPKIND_TEXT, 0);
+                snprintf(szValue, sizeof(szValue), "%u x %u", 640 + i * 80, 480 + i * 45);
+                modes.AddCell(0, szValue, strlen(szValue));
+                modes.AddCell(20, "DXGI_FORMAT_R8G8B8A8_UNORM", 26);
+                snprintf(szValue, sizeof(szValue), "%u", 60 + (i % 4) * 30);
+                modes.AddCell(50, szValue, strlen(szValue));
+                modes.EndRow();
+            }
+            WriteSyntheticNode(data, 2, "Outputs", nullptr);
+            WriteSyntheticNode(data, 3, "Output 0", &modes);
+
+            for (uint32_t iApi = 0; iApi < std::size(c_szApis); ++iApi)
+            {
+                CAPMODEL features;
+                for (uint32_t i = 0; i < 48; ++i)
+                {
+                    snprintf(szText, sizeof(szText), "Feature%uSupported", i);
+                    bool bSupported = ((i + iAdapter + iApi) % 3) != 0;
+                    AddSyntheticRow(features, CAPKIND_BOOL, bSupported ? 1 : 0, szText, bSupported ? "Yes" : "No");
+
+                    snprintf(szText, sizeof(szText), "Feature%uTier", i);
+                    snprintf(szValue, sizeof(szValue), "Optional (Yes - Tier %u)", 1 + (i + iAdapter) % 3);
+                    AddSyntheticRow(features, CAPKIND_STRING, 0, szText, szValue);
+                }
+                WriteSyntheticNode(data, 2, c_szApis[iApi], &features);
+
+                WriteSyntheticNode(data, 3, "Formats", nullptr);
+                for (const char* strLayout : c_szLayouts)
+                {
+                    for (const char* strType : c_szTypes)
+                    {
+                        CAPMODEL format;
+                        for (uint32_t i = 0; i < std::size(c_szSupport); ++i)
+                        {
+                            bool bSupported = ((strlen(strLayout) + i + iAdapter + iApi) % 4) != 0;
+                            AddSyntheticRow(format, CAPKIND_BOOL, bSupported ? 1 : 0, c_szSupport[i],
+                                bSupported ? "Yes" : "No");
+                        }
+
+                        snprintf(szText, sizeof(szText), "DXGI_FORMAT_%s_%s", strLayout, strType);
+                        WriteSyntheticNode(data, 4, szText, &format);
+                    }
+                }
+            }
+        }
+
+        WriteSyntheticNode(data, 0, "Direct3D9 Devices", nullptr);
+        for (uint32_t iAdapter = 0; iAdapter < numAdapters; ++iAdapter)
+        {
+            snprintf(szText, sizeof(szText), "Synthetic Adapter %u", iAdapter);
+            WriteSyntheticNode(data, 1, szText, nullptr);
+
+            CAPMODEL caps;
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                snprintf(szText, sizeof(szText), "D3DCAPS9 Cap%u", i);
+                switch (i % 4)
+                {
+                case 0:
+                    snprintf(szValue, sizeof(szValue), "0x%08X", i * 0x01010101u + iAdapter);
+                    AddSyntheticRow(caps, CAPKIND_HEX, i * 0x01010101u + iAdapter, szText, szValue);
+                    break;
+
+                case 1:
+                    snprintf(szValue, sizeof(szValue), "%u", i * 16 + iAdapter);
+                    AddSyntheticRow(caps, CAPKIND_VALUE, i * 16 + iAdapter, szText, szValue);
+                    break;
+
+                case 2:
+                    AddSyntheticRow(caps, CAPKIND_VERSION, 0x0300, szText, "3.0");
+                    break;
+
+                default:
+                {
+                    float fValue = 1.0f + static_cast<float>(i + iAdapter) / 8.0f;
+                    uint32_t value;
+                    memcpy(&value, &fValue, sizeof(value));
+                    snprintf(szValue, sizeof(szValue), "%.6f", static_cast<double>(fValue));
+                    AddSyntheticRow(caps, CAPKIND_FLOAT, value, szText, szValue);
+                    break;
+                }
+                }
+            }
+            WriteSyntheticNode(data, 2, "HAL", &caps);
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    double PerSecond(uint64_t count, const BENCHRESULT& result)
+    {
+        return (result.seconds > 0) ? count * static_cast<double>(result.runs) / result.seconds : 0;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    void PrintResult(const BENCHRESULT& result)
+    {
+        printf("%-11s %-24.24s %6u %10.3f %12.0f %12.0f %10.1f %12.1f\n",
+            result.strStage, result.input.c_str(), result.runs, result.seconds * 1000.0 / result.runs,
+            PerSecond(result.counts.nodes, result), PerSecond(result.counts.rows, result),
+            PerSecond(result.counts.bytes, result) / (1024.0 * 1024.0), result.allocations);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    void AppendJsonString(std::string& json, const std::string& text)
+    {
+        json += '"';
+        for (char ch : text)
+        {
+            if (ch == '"' || ch == '\\')
+                json += '\\';
+            if (static_cast<unsigned char>(ch) >= 0x20)
+                json += ch;
+        }
+        json += '"';
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: WriteResults()
+    // Desc: CSV with a header line, or a JSON array of objects with the same
+    //       fields, for tracking the figures from run to run
+    //-----------------------------------------------------------------------------
+    bool WriteResults(const char* strFile, bool bJson, const std::vector<BENCHRESULT>& results)
+    {
+        std::string text = bJson ? "[\n"
+            : "stage,input,runs,ms_per_run,nodes_per_sec,rows_per_sec,bytes_per_sec,allocs_per_run\n";
+
+        char szFields[256];
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const BENCHRESULT& result = results[i];
+            double msPerRun = result.seconds * 1000.0 / result.runs;
+            if (bJson)
+            {
+                text += "{\"stage\":\"";
+                text += result.strStage;
+                text += "\",\"input\":";
+                AppendJsonString(text, result.input);
+                snprintf(szFields, sizeof(szFields),
+                    ",\"runs\":%u,\"ms_per_run\":%.6f,\"nodes_per_sec\":%.1f,\"rows_per_sec\":%.1f,"
+                    "\"bytes_per_sec\":%.1f,\"allocs_per_run\":%.1f}%s\n",
+                    result.runs, msPerRun, PerSecond(result.counts.nodes, result),
+                    PerSecond(result.counts.rows, result), PerSecond(result.counts.bytes, result),
+                    result.allocations, (i + 1 < results.size()) ? "," : "");
+            }
+            else
+            {
+                text += result.strStage;
+                text += ',';
+                text += result.input;
+                snprintf(szFields, sizeof(szFields), ",%u,%.6f,%.1f,%.1f,%.1f,%.1f\n",
+                    result.runs, msPerRun, PerSecond(result.counts.nodes, result),
+                    PerSecond(result.counts.rows, result), PerSecond(result.counts.bytes, result),
+                    result.allocations);
+            }
+            text += szFields;
+        }
+
+        if (bJson)
+            text += "]\n";
+
+        std::ofstream file(strFile, std::ios::binary | std::ios::trunc);
+        return file && file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Heap allocations are counted by replacing the global operator new
+//-----------------------------------------------------------------------------
+void* operator new(size_t size)
+{
+    ++g_allocations;
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    ++g_allocations;
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+
+//-----------------------------------------------------------------------------
+// Name: main()
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    uint32_t numAdapters = 2;
+    unsigned long minTime = 500;
+    const char* strCsv = nullptr;
+    const char* strJson = nullptr;
+    int iArg = 1;
+    for (; iArg < argc && (*argv[iArg] == '-' || *argv[iArg] == '/'); ++iArg)
+    {
+        if (!strncmp(argv[iArg] + 1, "adapters:", 9))
+            numAdapters = static_cast<uint32_t>(strtoul(argv[iArg] + 10, nullptr, 10));
+        else if (!strncmp(argv[iArg] + 1, "time:", 5))
+            minTime = strtoul(argv[iArg] + 6, nullptr, 10);
+        else if (!strncmp(argv[iArg] + 1, "csv:", 4))
+            strCsv = argv[iArg] + 5;
+        else if (!strncmp(argv[iArg] + 1, "json:", 5))
+            strJson = argv[iArg] + 6;
+        else
+            break;
+    }
+
+    if ((iArg < argc && (*argv[iArg] == '-' || *argv[iArg] == '/')) || !numAdapters)
+    {
+        fprintf(stderr, "Usage: dxcapsbench [-adapters:n] [-time:ms] [-csv:file] [-json:file] [snapshot ...]\n");
+        return 2;
+    }
+
+    std::vector<std::unique_ptr<BENCHINPUT>> inputs;
+    if (iArg == argc)
+    {
+        std::unique_ptr<BENCHINPUT> input(new BENCHINPUT);
+        input->name = "synthetic:" + std::to_string(numAdapters);
+        BuildSyntheticSnapshot(numAdapters, input->data);
+        inputs.push_back(std::move(input));
+    }
+
+    for (; iArg < argc; ++iArg)
+    {
+        std::unique_ptr<BENCHINPUT> input(new BENCHINPUT);
+        input->name = argv[iArg];
+        if (!ReadSnapshotFile(argv[iArg], input->data))
+        {
+            fprintf(stderr, "dxcapsbench: can't read %s\n", argv[iArg]);
+            return 2;
+        }
+        inputs.push_back(std::move(input));
+    }
+
+    for (auto& input : inputs)
+    {
+        if (!input->snapshot.Load(input->data.data(), input->data.size()))
+        {
+            fprintf(stderr, "dxcapsbench: %s is not a snapshot from this version\n", input->name.c_str());
+            return 2;
+        }
+    }
+
+    printf("%-11s %-24s %6s %10s %12s %12s %10s %12s\n",
+        "Stage", "Input", "Runs", "ms/run", "Nodes/s", "Rows/s", "MB/s", "Allocs/run");
+
+    std::vector<BENCHRESULT> results;
+    for (const auto& input : inputs)
+    {
+        for (const auto& stage : c_stages)
+        {
+            BENCHRESULT result;
+            RunStage(stage.strName, stage.pfnStage, *input, std::chrono::milliseconds(minTime), result);
+            PrintResult(result);
+            results.push_back(std::move(result));
+        }
+    }
+
+#ifdef _WIN32
+    TCHAR szTempPath[MAX_PATH];
+    if (!GetTempPath(MAX_PATH, szTempPath) || !GetTempFileName(szTempPath, TEXT("dxb"), 0, g_szTempFile))
+    {
+        fprintf(stderr, "dxcapsbench: can't create a temporary file\n");
+        return 2;
+    }
+
+    for (const auto& input : inputs)
+    {
+        if (!DXView_ReplaySnapshot(input->data))
+        {
+            fprintf(stderr, "dxcapsbench: can't replay %s\n", input->name.c_str());
+            DXView_FreeSnapshot();
+            continue;
+        }
+
+        for (const auto& stage : c_replayStages)
+        {
+            BENCHRESULT result;
+            RunStage(stage.strName, stage.pfnStage, *input, std::chrono::milliseconds(minTime), result);
+            PrintResult(result);
+            results.push_back(std::move(result));
+        }
+
+        TVFreeHeadlessTree();
+        DXView_FreeSnapshot();
+    }
+
+    DeleteFile(g_szTempFile);
+
+    BENCHINPUT stub;
+    stub.name = "stub9:" + std::to_string(numAdapters);
+    stub.numAdapters = numAdapters;
+    for (const auto& stage : c_stubStages)
+    {
+        BENCHRESULT result;
+        RunStage(stage.strName, stage.pfnStage, stub, std::chrono::milliseconds(minTime), result);
+        PrintResult(result);
+        results.push_back(std::move(result));
+    }
+#endif
+
+    if (strCsv && !WriteResults(strCsv, false, results))
+    {
+        fprintf(stderr, "dxcapsbench: can't write %s\n", strCsv);
+        return 2;
+    }
+
+    if (strJson && !WriteResults(strJson, true, results))
+    {
+        fprintf(stderr, "dxcapsbench: can't write %s\n", strJson);
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+//-----------------------------------------------------------------------------
+// Name: dxcapsdiff.cpp
+//
+// Desc: Compares two snapshots recorded with dxview -record, such as the same
+//       adapter before and after a driver update
+//
+//       dxcapsdiff [-count] <old snapshot> <new snapshot>
+//
+//       Prints a line per difference, starting with + for added, - for
+//       removed or ~ for changed. With -count, prints how many of each there
+//       are instead, and how many cap flags each snapshot has set. Exits with
+//       0 when the snapshots match, 1 when they differ and 2 if either can't
+//       be read.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxdiff.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    const size_t SNAPSHOT_MAX_SIZE = 64 * 1024 * 1024;
+
+    //-----------------------------------------------------------------------------
+    bool LoadSnapshotFile(const char* strPath, CAPSNAPSHOT& snapshot)
+    {
+        std::ifstream file(strPath, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            fprintf(stderr, "dxcapsdiff: can't open %s\n", strPath);
+            return false;
+        }
+
+        std::streamoff size = file.tellg();
+        if (size <= 0 || static_cast<size_t>(size) > SNAPSHOT_MAX_SIZE)
+        {
+            fprintf(stderr, "dxcapsdiff: %s is not a snapshot\n", strPath);
+            return false;
+        }
+
+        std::vector<uint8_t> data(static_cast<size_t>(size));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(data.data()), size))
+        {
+            fprintf(stderr, "dxcapsdiff: can't read %s\n", strPath);
+            return false;
+        }
+
+        if (!snapshot.Load(data.data(), data.size()))
+        {
+            fprintf(stderr, "dxcapsdiff: %s is not a snapshot from this version\n", strPath);
+            return false;
+        }
+
+        return true;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    void PrintDiff(const CAPDIFF& diff, std::string& line)
+    {
+        static const char c_chKind[] = { '+', '-', '~' };
+
+        line.assign(1, c_chKind[diff.kind]);
+        line += ' ';
+        line += diff.path;
+
+        const CAPROW* pRow = diff.pNew ? diff.pNew : diff.pOld;
+        if (pRow)
+        {
+            std::string value;
+            line += ": ";
+            line += pRow->Name();
+
+            if (diff.kind == CAPDIFF_CHANGED)
+            {
+                CapDiffRowValue(*diff.pOld, value);
+                line += ": ";
+                line += value;
+                CapDiffRowValue(*diff.pNew, value);
+                line += " -> ";
+                line += value;
+            }
+            else
+            {
+                CapDiffRowValue(*pRow, value);
+                if (!value.empty())
+                {
+                    line += " = ";
+                    line += value;
+                }
+            }
+        }
+
+        line += '\n';
+        fputs(line.c_str(), stdout);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    uint64_t CountFlagsSet(const CAPSNAPSHOT& snapshot)
+    {
+        uint64_t count = 0;
+        for (const auto& node : snapshot.nodes)
+        {
+            if (node.pModel)
+                count += node.pModel->caps.CountSet();
+        }
+        return count;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: main()
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    bool bCountOnly = false;
+    int iArg = 1;
+    if (iArg < argc && (!strcmp(argv[iArg], "-count") || !strcmp(argv[iArg], "/count")))
+    {
+        bCountOnly = true;
+        ++iArg;
+    }
+
+    if (argc - iArg != 2)
+    {
+        fprintf(stderr, "Usage: dxcapsdiff [-count] <old snapshot> <new snapshot>\n");
+        return 2;
+    }
+
+    CAPSNAPSHOT oldSnapshot;
+    CAPSNAPSHOT newSnapshot;
+    if (!LoadSnapshotFile(argv[iArg], oldSnapshot) || !LoadSnapshotFile(argv[iArg + 1], newSnapshot))
+        return 2;
+
+    std::vector<CAPDIFF> diffs;
+    CapDiffSnapshots(oldSnapshot, newSnapshot, diffs);
+
+    if (bCountOnly)
+    {
+        size_t counts[3] = {};
+        for (const auto& diff : diffs)
+            ++counts[diff.kind];
+
+        printf("%zu added, %zu removed, %zu changed\n",
+            counts[CAPDIFF_ADDED], counts[CAPDIFF_REMOVED], counts[CAPDIFF_CHANGED]);
+        printf("%llu -> %llu cap flags set\n", static_cast<unsigned long long>(CountFlagsSet(oldSnapshot)),
+            static_cast<unsigned long long>(CountFlagsSet(newSnapshot)));
+    }
+    else
+    {
+        std::string line;
+        for (const auto& diff : diffs)
+            PrintDiff(diff, line);
+    }
+
+    return diffs.empty() ? 0 : 1;
+}
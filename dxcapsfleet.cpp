@@ -0,0 +1,248 @@
+//-----------------------------------------------------------------------------
+// Name: dxcapsfleet.cpp
+//
+// Desc: Aggregates a directory of snapshots recorded with dxview -record
+//
+//       dxcapsfleet [-threads:n] [-store:file] <directory>
+//
+//       Reads every snapshot in the directory and its subdirectories on all
+//       cores, then prints a tab-separated line per cap of each adapter's
+//       vendor, device and driver, and of the WARP, Reference, Direct3D 9 and
+//       DirectDraw subtrees: how many subtrees report it, what percentage of
+//       them support it and how often each value was seen.
+//
+//       With -store, writes every snapshot to a columnar store for
+//       dxcapsquery instead.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxfleet.h"
+#include "dxstore.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const size_t SNAPSHOT_MAX_SIZE = 64 * 1024 * 1024;
+
+    // Snapshots are loaded in parallel but added to the store one at a time
+    struct STOREWRITER
+    {
+        CAPSTOREBUILDER     builder;
+        std::mutex          lock;
+    };
+
+    //-----------------------------------------------------------------------------
+    bool ReadSnapshotFile(const fs::path& path, std::vector<uint8_t>& data)
+    {
+        std::error_code ec;
+        auto size = fs::file_size(path, ec);
+        if (ec || !size || size > SNAPSHOT_MAX_SIZE)
+            return false;
+
+        std::ifstream file(path, std::ios::binary);
+        data.resize(static_cast<size_t>(size));
+        return file && file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size));
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: AggregateFiles()
+    // Desc: Thread proc. Each thread takes the next file until none are left,
+    //       tallying into its own aggregate so nothing is shared until the end.
+    //-----------------------------------------------------------------------------
+    void AggregateFiles(const std::vector<fs::path>& files, std::atomic<size_t>& next, CAPFLEET& fleet, STOREWRITER* pStore)
+    {
+        std::vector<uint8_t> data;
+        CAPSNAPSHOT snapshot;
+        for (size_t i = next++; i < files.size(); i = next++)
+        {
+            if (!ReadSnapshotFile(files[i], data) || !snapshot.Load(data.data(), data.size()))
+            {
+                ++fleet.skipped;
+                continue;
+            }
+
+            if (pStore)
+            {
+                std::lock_guard<std::mutex> guard(pStore->lock);
+                pStore->builder.AddSnapshot(files[i].filename().string().c_str(), snapshot);
+            }
+            else
+            {
+                fleet.Add(snapshot);
+            }
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: PrintFleet()
+    // Desc: Adapter groups come out first, sorted by vendor, device and driver,
+    //       then the others, each with its kind in place of the vendor. Nodes
+    //       are sorted by path, and each cap's values from most to least common.
+    //-----------------------------------------------------------------------------
+    void PrintFleet(const CAPFLEET& fleet)
+    {
+        static const char* const c_szKinds[] = { "", "WARP", "Reference", "Direct3D9", "DirectDraw", "Other" };
+
+        printf("Vendor\tDevice\tDriver\tSubtrees\tNode\tCap\tPresent\tSupported%%\tValues\n");
+
+        std::string line;
+        for (const auto& group : fleet.groups)
+        {
+            const CAPFLEETKEY& key = group.first;
+
+            char szGroup[80];
+            if (key.kind != CAPFLEET_ADAPTER)
+            {
+                snprintf(szGroup, sizeof(szGroup), "%s\t\t\t%u", c_szKinds[key.kind], group.second.subtrees);
+            }
+            else
+            {
+                snprintf(szGroup, sizeof(szGroup), "0x%04X\t0x%04X\t%u.%u.%u.%u\t%u",
+                    key.vendorId, key.deviceId,
+                    static_cast<unsigned>((key.driverVersion >> 48) & 0xFFFF),
+                    static_cast<unsigned>((key.driverVersion >> 32) & 0xFFFF),
+                    static_cast<unsigned>((key.driverVersion >> 16) & 0xFFFF),
+                    static_cast<unsigned>(key.driverVersion & 0xFFFF),
+                    group.second.subtrees);
+            }
+
+            std::vector<const std::pair<const std::string, CAPFLEETNODE>*> nodes;
+            nodes.reserve(group.second.nodes.size());
+            for (const auto& node : group.second.nodes)
+                nodes.push_back(&node);
+            std::sort(nodes.begin(), nodes.end(), [](auto a, auto b) { return a->first < b->first; });
+
+            std::vector<std::pair<std::string, uint32_t>> values;
+            for (auto pNode : nodes)
+            {
+                for (const auto& row : pNode->second.rows)
+                {
+                    values.assign(row.values.begin(), row.values.end());
+                    std::sort(values.begin(), values.end(), [](const auto& a, const auto& b)
+                        {
+                            return (a.second != b.second) ? (a.second > b.second) : (a.first < b.first);
+                        });
+
+                    char szCounts[64];
+                    snprintf(szCounts, sizeof(szCounts), "\t%u\t%.1f\t", row.present,
+                        100.0 * row.supported / row.present);
+
+                    line = szGroup;
+                    line += '\t';
+                    line += pNode->first;
+                    line += '\t';
+                    line += row.name;
+                    line += szCounts;
+                    for (size_t i = 0; i < values.size(); ++i)
+                    {
+                        if (i)
+                            line += "; ";
+                        line += values[i].first;
+                        line += '=';
+                        line += std::to_string(values[i].second);
+                    }
+                    line += '\n';
+                    fputs(line.c_str(), stdout);
+                }
+            }
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: main()
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    unsigned numThreads = std::thread::hardware_concurrency();
+    const char* strStore = nullptr;
+    int iArg = 1;
+    for (; iArg < argc && (*argv[iArg] == '-' || *argv[iArg] == '/'); ++iArg)
+    {
+        if (!strncmp(argv[iArg] + 1, "threads:", 8))
+            numThreads = static_cast<unsigned>(strtoul(argv[iArg] + 9, nullptr, 10));
+        else if (!strncmp(argv[iArg] + 1, "store:", 6))
+            strStore = argv[iArg] + 7;
+        else
+            break;
+    }
+
+    if (argc - iArg != 1)
+    {
+        fprintf(stderr, "Usage: dxcapsfleet [-threads:n] [-store:file] <directory>\n");
+        return 2;
+    }
+
+    std::vector<fs::path> files;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(argv[iArg], ec), end; !ec && it != end; it.increment(ec))
+    {
+        if (it->is_regular_file(ec))
+            files.push_back(it->path());
+    }
+
+    if (ec)
+    {
+        fprintf(stderr, "dxcapsfleet: can't read %s\n", argv[iArg]);
+        return 2;
+    }
+
+    numThreads = std::max(1u, std::min<unsigned>(numThreads, static_cast<unsigned>(files.size())));
+
+    std::unique_ptr<STOREWRITER> store;
+    if (strStore)
+        store.reset(new STOREWRITER);
+
+    std::vector<CAPFLEET> partials(numThreads);
+    std::vector<std::thread> threads;
+    std::atomic<size_t> next(0);
+    for (unsigned i = 1; i < numThreads; ++i)
+        threads.emplace_back(AggregateFiles, std::cref(files), std::ref(next), std::ref(partials[i]), store.get());
+
+    AggregateFiles(files, next, partials[0], store.get());
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (unsigned i = 1; i < numThreads; ++i)
+        partials[0].Merge(partials[i]);
+
+    if (partials[0].skipped)
+        fprintf(stderr, "dxcapsfleet: skipped %u files that aren't snapshots from this version\n", partials[0].skipped);
+
+    if (!store)
+    {
+        PrintFleet(partials[0]);
+        return 0;
+    }
+
+    std::vector<uint8_t> data;
+    store->builder.Write(data);
+
+    std::ofstream file(strStore, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size())))
+    {
+        fprintf(stderr, "dxcapsfleet: can't write %s\n", strStore);
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,212 @@
+//-----------------------------------------------------------------------------
+// Name: dxcapsquery.cpp
+//
+// Desc: Queries a store written with dxcapsfleet -store
+//
+//       dxcapsquery <store> [-show:path] <predicate>...
+//
+//       Prints the name of each snapshot matching every predicate, followed
+//       by its values for any -show columns. A predicate is one of
+//
+//           path            has the cap
+//           !path           lacks the cap
+//           path=value      has the cap with this value
+//           path!=value     lacks the cap or has another value
+//
+//       where '*' in a path matches any part of one node name, as in
+//       "DXGI Devices/*/Direct3D 12/D3D_FEATURE_LEVEL_12_1/Shader Model".
+//       The store is memory mapped and only the named columns are read.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxstore.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    //-----------------------------------------------------------------------------
+    // Name: MAPPEDFILE
+    // Desc: Read-only mapping of a whole file
+    //-----------------------------------------------------------------------------
+    struct MAPPEDFILE
+    {
+        const uint8_t*  pData;
+        size_t          cbData;
+
+        MAPPEDFILE() noexcept : pData(nullptr), cbData(0) {}
+        MAPPEDFILE(const MAPPEDFILE&) = delete;
+        MAPPEDFILE& operator=(const MAPPEDFILE&) = delete;
+        ~MAPPEDFILE() { Close(); }
+
+        bool Open(const char* strPath)
+        {
+#ifdef _WIN32
+            HANDLE hFile = CreateFileA(strPath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (hFile == INVALID_HANDLE_VALUE)
+                return false;
+
+            LARGE_INTEGER size = {};
+            HANDLE hMapping = nullptr;
+            if (GetFileSizeEx(hFile, &size) && size.QuadPart > 0)
+                hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(hFile);
+            if (!hMapping)
+                return false;
+
+            pData = static_cast<const uint8_t*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(hMapping);
+            cbData = pData ? static_cast<size_t>(size.QuadPart) : 0;
+#else
+            int fd = open(strPath, O_RDONLY);
+            if (fd < 0)
+                return false;
+
+            struct stat st = {};
+            void* pMapping = MAP_FAILED;
+            if (!fstat(fd, &st) && st.st_size > 0)
+                pMapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);
+            if (pMapping == MAP_FAILED)
+                return false;
+
+            pData = static_cast<const uint8_t*>(pMapping);
+            cbData = static_cast<size_t>(st.st_size);
+#endif
+            return pData != nullptr;
+        }
+
+        void Close()
+        {
+            if (pData)
+            {
+#ifdef _WIN32
+                UnmapViewOfFile(pData);
+#else
+                munmap(const_cast<uint8_t*>(pData), cbData);
+#endif
+            }
+            pData = nullptr;
+            cbData = 0;
+        }
+    };
+
+
+    //-----------------------------------------------------------------------------
+    bool ParsePredicate(const char* strArg, CAPSTOREPREDICATE& predicate)
+    {
+        predicate.value.clear();
+
+        const char* pOp = strstr(strArg, "!=");
+        if (pOp)
+        {
+            predicate.op = CAPSTORE_NOTEQUAL;
+            predicate.path.assign(strArg, pOp);
+            predicate.value = pOp + 2;
+        }
+        else if ((pOp = strchr(strArg, '=')) != nullptr)
+        {
+            predicate.op = CAPSTORE_EQUAL;
+            predicate.path.assign(strArg, pOp);
+            predicate.value = pOp + 1;
+        }
+        else if (*strArg == '!')
+        {
+            predicate.op = CAPSTORE_LACKS;
+            predicate.path = strArg + 1;
+        }
+        else
+        {
+            predicate.op = CAPSTORE_HAS;
+            predicate.path = strArg;
+        }
+
+        return !predicate.path.empty();
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: main()
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: dxcapsquery <store> [-show:path] <predicate>...\n");
+        return 2;
+    }
+
+    MAPPEDFILE file;
+    CAPSTORE store;
+    if (!file.Open(argv[1]) || !store.Open(file.pData, file.cbData))
+    {
+        fprintf(stderr, "dxcapsquery: %s is not a store from this version\n", argv[1]);
+        return 2;
+    }
+
+    std::vector<const CAPSTORECOLUMN*> show;
+    std::vector<const CAPSTORECOLUMN*> columns;
+    std::vector<uint64_t> rows;
+    store.SelectAll(rows);
+    for (int i = 2; i < argc; ++i)
+    {
+        if (!strncmp(argv[i], "-show:", 6) || !strncmp(argv[i], "/show:", 6))
+        {
+            store.FindColumns(argv[i] + 6, columns);
+            show.insert(show.end(), columns.begin(), columns.end());
+            continue;
+        }
+
+        CAPSTOREPREDICATE predicate;
+        if (!ParsePredicate(argv[i], predicate))
+        {
+            fprintf(stderr, "dxcapsquery: bad predicate %s\n", argv[i]);
+            return 2;
+        }
+
+        store.Select(predicate, rows);
+    }
+
+    const CAPSTORECOLUMN* pName = store.FindColumn("@name");
+    std::string line;
+    std::string text;
+    uint32_t count = 0;
+    for (uint32_t row = 0; row < store.NumRows(); ++row)
+    {
+        if (!((rows[row >> 6] >> (row & 63)) & 1))
+            continue;
+
+        ++count;
+        line.clear();
+        if (pName)
+            store.GetText(*pName, row, line);
+
+        for (auto pColumn : show)
+        {
+            store.GetText(*pColumn, row, text);
+            line += '\t';
+            line += text;
+        }
+
+        line += '\n';
+        fputs(line.c_str(), stdout);
+    }
+
+    fprintf(stderr, "%u of %u snapshots match\n", count, store.NumRows());
+    return 0;
+}
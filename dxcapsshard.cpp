@@ -0,0 +1,281 @@
+//-----------------------------------------------------------------------------
+// Name: dxcapsshard.cpp
+//
+// Desc: Runs fake probe workers through the shard protocol dxview -workers
+//       uses, so the shared memory and merge can be tried without a GPU
+//
+//       dxcapsshard [-crash:n] [-hang:n] [-timeout:ms] [-out:file] <snapshot> ...
+//
+//       Each snapshot, as recorded with dxview -record, is one shard. A
+//       forked worker per shard "probes" it by reading the file and writes it
+//       into a region of shared memory, as a dxview worker does. Worker n
+//       dies halfway through writing with -crash:n, or never finishes with
+//       -hang:n and is killed after the timeout. The parent prints what came
+//       back from each worker and writes the merged snapshot to -out. Exits
+//       with 0 when every shard came back, 1 when any failed and 2 on error.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxshard.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    const size_t SNAPSHOT_MAX_SIZE = 64 * 1024 * 1024;
+
+    // Only pages a worker writes are ever backed
+    const size_t SHARD_REGION_SIZE = CAPSHARD_MIN_REGION + SNAPSHOT_MAX_SIZE;
+
+    struct FAKEWORKER
+    {
+        const char*     strPath;
+        void*           pRegion;
+        pid_t           pid;
+        bool            bExited;
+        int             status;
+    };
+
+    //-----------------------------------------------------------------------------
+    bool ReadSnapshotFile(const char* strPath, std::vector<uint8_t>& data)
+    {
+        std::ifstream file(strPath, std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+
+        std::streamoff size = file.tellg();
+        if (size <= 0 || static_cast<size_t>(size) > SNAPSHOT_MAX_SIZE)
+            return false;
+
+        data.resize(static_cast<size_t>(size));
+        file.seekg(0);
+        return !!file.read(reinterpret_cast<char*>(data.data()), size);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: RunFakeWorker()
+    // Desc: The child's side. Returns its exit code.
+    //-----------------------------------------------------------------------------
+    int RunFakeWorker(const FAKEWORKER& worker, bool bCrash, bool bHang)
+    {
+        std::vector<uint8_t> data;
+        if (!ReadSnapshotFile(worker.strPath, data))
+            return 1;
+
+        if (bHang)
+        {
+            for (;;)
+                std::this_thread::sleep_for(std::chrono::seconds(60));
+        }
+
+        if (bCrash)
+        {
+            // Leave the region as a driver fault partway through would
+            auto pHeader = static_cast<CAPSHARDHEADER*>(worker.pRegion);
+            pHeader->state.store(CAPSHARD_WRITING);
+            memcpy(reinterpret_cast<uint8_t*>(pHeader) + sizeof(CAPSHARDHEADER), data.data(), data.size() / 2);
+            abort();
+        }
+
+        return CapShardWrite(worker.pRegion, SHARD_REGION_SIZE, data) ? 0 : 1;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: WaitForWorkers()
+    // Desc: Reaps the workers as they exit, killing any still running after
+    //       timeoutMs
+    //-----------------------------------------------------------------------------
+    void WaitForWorkers(FAKEWORKER* pWorkers, size_t numWorkers, unsigned long timeoutMs)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+        size_t numRunning = numWorkers;
+        while (numRunning > 0 && std::chrono::steady_clock::now() < deadline)
+        {
+            for (size_t i = 0; i < numWorkers; ++i)
+            {
+                FAKEWORKER& worker = pWorkers[i];
+                if (!worker.bExited && waitpid(worker.pid, &worker.status, WNOHANG) == worker.pid)
+                {
+                    worker.bExited = true;
+                    --numRunning;
+                }
+            }
+
+            if (numRunning > 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        for (size_t i = 0; i < numWorkers; ++i)
+        {
+            FAKEWORKER& worker = pWorkers[i];
+            if (worker.bExited)
+                continue;
+
+            kill(worker.pid, SIGKILL);
+            (void)waitpid(worker.pid, &worker.status, 0);
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    void DescribeExit(const FAKEWORKER& worker, char* strText, size_t cchText)
+    {
+        if (!worker.bExited)
+            snprintf(strText, cchText, "killed after the timeout");
+        else if (WIFSIGNALED(worker.status))
+            snprintf(strText, cchText, "died with signal %d", WTERMSIG(worker.status));
+        else
+            snprintf(strText, cchText, "exited with %d", WEXITSTATUS(worker.status));
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: main()
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    long iCrash = -1;
+    long iHang = -1;
+    unsigned long timeoutMs = 5000;
+    const char* strOut = nullptr;
+    int iArg = 1;
+    for (; iArg < argc && (*argv[iArg] == '-' || *argv[iArg] == '/'); ++iArg)
+    {
+        if (!strncmp(argv[iArg] + 1, "crash:", 6))
+            iCrash = strtol(argv[iArg] + 7, nullptr, 10);
+        else if (!strncmp(argv[iArg] + 1, "hang:", 5))
+            iHang = strtol(argv[iArg] + 6, nullptr, 10);
+        else if (!strncmp(argv[iArg] + 1, "timeout:", 8))
+            timeoutMs = strtoul(argv[iArg] + 9, nullptr, 10);
+        else if (!strncmp(argv[iArg] + 1, "out:", 4))
+            strOut = argv[iArg] + 5;
+        else
+            break;
+    }
+
+    if (iArg == argc || *argv[iArg] == '-' || *argv[iArg] == '/')
+    {
+        fprintf(stderr, "Usage: dxcapsshard [-crash:n] [-hang:n] [-timeout:ms] [-out:file] <snapshot> ...\n");
+        return 2;
+    }
+
+    auto numShards = static_cast<size_t>(argc - iArg);
+    std::unique_ptr<FAKEWORKER[]> workers(new FAKEWORKER[numShards]());
+    for (size_t i = 0; i < numShards; ++i)
+    {
+        FAKEWORKER& worker = workers[i];
+        worker.strPath = argv[iArg + i];
+
+        // Shared with the worker, as the file mapping is with a dxview worker
+        worker.pRegion = mmap(nullptr, SHARD_REGION_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (worker.pRegion == MAP_FAILED)
+        {
+            fprintf(stderr, "dxcapsshard: can't map a region for %s\n", worker.strPath);
+            return 2;
+        }
+        CapShardInit(worker.pRegion, SHARD_REGION_SIZE);
+    }
+
+    // Nothing buffered may be written twice by the children
+    fflush(stdout);
+    fflush(stderr);
+
+    size_t numStarted = 0;
+    for (; numStarted < numShards; ++numStarted)
+    {
+        FAKEWORKER& worker = workers[numStarted];
+        worker.pid = fork();
+        if (worker.pid == 0)
+            _exit(RunFakeWorker(worker, static_cast<long>(numStarted) == iCrash, static_cast<long>(numStarted) == iHang));
+
+        if (worker.pid < 0)
+        {
+            fprintf(stderr, "dxcapsshard: can't start a worker for %s\n", worker.strPath);
+            break;
+        }
+    }
+
+    WaitForWorkers(workers.get(), numStarted, timeoutMs);
+    if (numStarted < numShards)
+        return 2;
+
+    std::unique_ptr<CAPSHARD[]> shards(new CAPSHARD[numShards]);
+    std::string key;
+    size_t numFailed = 0;
+    for (size_t i = 0; i < numShards; ++i)
+    {
+        const FAKEWORKER& worker = workers[i];
+        CAPSHARD& shard = shards[i];
+        shard.root = "Shards";
+        shard.name = worker.strPath;
+        shard.result = worker.bExited
+            ? CapShardLoad(worker.pRegion, SHARD_REGION_SIZE, shard.snapshot)
+            : CAPSHARD_TIMEDOUT;
+
+        char strExit[64];
+        DescribeExit(worker, strExit, sizeof(strExit));
+        if (shard.result == CAPSHARD_OK)
+        {
+            printf("%s: %zu nodes, worker %s\n", worker.strPath, shard.snapshot.nodes.size(), strExit);
+            if (key.empty())
+                key = shard.snapshot.key;
+        }
+        else
+        {
+            printf("%s: failed, worker %s\n", worker.strPath, strExit);
+            ++numFailed;
+        }
+    }
+
+    // The key of the first shard that came back, as a dxview parent uses its own
+    if (key.empty())
+    {
+        std::vector<uint8_t> version;
+        CapWriteU32(version, CAPSNAPSHOT_VERSION);
+        key.assign(version.begin(), version.end());
+    }
+
+    std::vector<uint8_t> merged;
+    CapMergeShards(shards.get(), numShards, key, merged);
+
+    CAPSNAPSHOT check;
+    if (!check.Load(merged.data(), merged.size()))
+    {
+        fprintf(stderr, "dxcapsshard: the merged snapshot doesn't load\n");
+        return 2;
+    }
+    printf("Merged: %zu shards, %zu failed, %zu nodes\n", numShards, numFailed, check.nodes.size());
+
+    if (strOut)
+    {
+        std::ofstream file(strOut, std::ios::binary | std::ios::trunc);
+        if (!file || !file.write(reinterpret_cast<const char*>(merged.data()), static_cast<std::streamsize>(merged.size())))
+        {
+            fprintf(stderr, "dxcapsshard: can't write %s\n", strOut);
+            return 2;
+        }
+    }
+
+    for (size_t i = 0; i < numShards; ++i)
+        munmap(workers[i].pRegion, SHARD_REGION_SIZE);
+
+    return numFailed ? 1 : 0;
+}
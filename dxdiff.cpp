@@ -0,0 +1,299 @@
+//-----------------------------------------------------------------------------
+// Name: dxdiff.cpp
+//
+// Desc: DirectX Capabilities Viewer snapshot comparison
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxdiff.h"
+
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+    const uint32_t NO_DEPTH = UINT32_MAX;
+
+    //-----------------------------------------------------------------------------
+    // Name: RowValuesMatch()
+    // Desc: Typed rows compare their raw values, so "0x0000001F" and "0x1f"
+    //       agree. Anything else compares the text after the name.
+    //-----------------------------------------------------------------------------
+    bool RowValuesMatch(const CAPROW& oldRow, const CAPROW& newRow)
+    {
+        if (oldRow.kind != newRow.kind)
+            return false;
+
+        switch (oldRow.kind)
+        {
+        case CAPKIND_VALUE:
+        case CAPKIND_HEX:
+        case CAPKIND_BOOL:
+        case CAPKIND_VERSION:
+        case CAPKIND_FLOAT:
+            return oldRow.value == newRow.value;
+
+        default:
+            break;
+        }
+
+        if (oldRow.cells.size() != newRow.cells.size())
+            return false;
+
+        for (size_t i = 1; i < oldRow.cells.size(); ++i)
+        {
+            if (oldRow.cells[i].text != newRow.cells[i].text)
+                return false;
+        }
+
+        return true;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: DiffModels()
+    // Desc: Compares the rows of a node present in both snapshots. Either model
+    //       may be null, in which case every row of the other is reported.
+    //-----------------------------------------------------------------------------
+    void DiffModels(const std::string& path, const CAPMODEL* pOld, const CAPMODEL* pNew, std::vector<CAPDIFF>& diffs)
+    {
+        const CAPMODEL empty;
+        const CAPMODEL& oldModel = pOld ? *pOld : empty;
+        const CAPMODEL& newModel = pNew ? *pNew : empty;
+
+        // Rows printed from the same caps under the same view are the same
+        if (oldModel.IsAllCaps() && newModel.IsAllCaps() && oldModel.viewState == newModel.viewState
+            && oldModel.view9Ex == newModel.view9Ex && oldModel.caps == newModel.caps)
+            return;
+
+        // Most nodes are unchanged between drivers, so check row by row first
+        if (oldModel.rows.size() == newModel.rows.size())
+        {
+            size_t i = 0;
+            for (; i < oldModel.rows.size(); ++i)
+            {
+                const CAPROW& oldRow = oldModel.rows[i];
+                const CAPROW& newRow = newModel.rows[i];
+                if (strcmp(oldRow.Name(), newRow.Name()) != 0 || !RowValuesMatch(oldRow, newRow))
+                    break;
+            }
+
+            if (i == oldModel.rows.size())
+                return;
+        }
+
+        std::vector<std::string> oldKeys;
+        std::vector<std::string> newKeys;
+        CapBuildRowKeys(oldModel, oldKeys);
+        CapBuildRowKeys(newModel, newKeys);
+
+        std::unordered_map<std::string, size_t> oldIndex;
+        oldIndex.reserve(oldKeys.size());
+        for (size_t i = 0; i < oldKeys.size(); ++i)
+        {
+            if (!oldKeys[i].empty())
+                oldIndex.emplace(oldKeys[i], i);
+        }
+
+        std::vector<bool> matched(oldKeys.size(), false);
+        for (size_t i = 0; i < newKeys.size(); ++i)
+        {
+            if (newKeys[i].empty())
+                continue;
+
+            const CAPROW& newRow = newModel.rows[i];
+            auto it = oldIndex.find(newKeys[i]);
+            if (it == oldIndex.end())
+            {
+                diffs.push_back({ CAPDIFF_ADDED, path, nullptr, &newRow });
+                continue;
+            }
+
+            matched[it->second] = true;
+            const CAPROW& oldRow = oldModel.rows[it->second];
+            if (!RowValuesMatch(oldRow, newRow))
+                diffs.push_back({ CAPDIFF_CHANGED, path, &oldRow, &newRow });
+        }
+
+        for (size_t i = 0; i < oldKeys.size(); ++i)
+        {
+            if (!oldKeys[i].empty() && !matched[i])
+                diffs.push_back({ CAPDIFF_REMOVED, path, &oldModel.rows[i], nullptr });
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: Load()
+// Desc: Reads a snapshot file's contents. Only snapshots written in this
+//       format version can be read.
+//-----------------------------------------------------------------------------
+bool CAPSNAPSHOT::Load(const uint8_t* pData, size_t cbData)
+{
+    Clear();
+
+    const uint8_t* pEnd = pData + cbData;
+    uint32_t version = 0;
+    if (!CapReadSnapshotHeader(pData, pEnd, key, version) || version != CAPSNAPSHOT_VERSION)
+        return false;
+
+    return CapReadSnapshotNodes(pData, pEnd, nodes);
+}
+
+
+//-----------------------------------------------------------------------------
+void CAPSNAPSHOT::Clear()
+{
+    for (auto& node : nodes)
+        delete node.pModel;
+    nodes.clear();
+    key.clear();
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapBuildNodePaths()
+// Desc: Joins each node's name to its parents'. Siblings with the same name,
+//       such as two identical adapters, are told apart by a "#n" suffix in
+//       the order they appear.
+//-----------------------------------------------------------------------------
+void CapBuildNodePaths(const std::vector<CAPSNAPSHOTNODE>& nodes, std::vector<std::string>& paths)
+{
+    paths.resize(nodes.size());
+
+    std::vector<size_t> parents;    // Last node seen at each depth
+    std::unordered_map<std::string, uint32_t> seen;
+    seen.reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        const CAPSNAPSHOTNODE& node = nodes[i];
+
+        std::string path;
+        if (node.depth)
+        {
+            path = paths[parents[node.depth - 1]];
+            path += '/';
+        }
+        path += node.text;
+
+        uint32_t count = ++seen[path];
+        if (count > 1)
+        {
+            path += '#';
+            path += std::to_string(count);
+        }
+
+        paths[i] = std::move(path);
+        parents.resize(node.depth + 1);
+        parents[node.depth] = i;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapBuildRowKeys()
+// Desc: Keys each row by name, numbering repeats the same way as node
+//       paths. Blank rows get an empty key and are never compared.
+//-----------------------------------------------------------------------------
+void CapBuildRowKeys(const CAPMODEL& model, std::vector<std::string>& keys)
+{
+    keys.resize(model.rows.size());
+
+    std::unordered_map<std::string, uint32_t> seen;
+    for (size_t i = 0; i < model.rows.size(); ++i)
+    {
+        std::string key = model.rows[i].Name();
+        if (key.empty())
+            continue;
+
+        uint32_t count = ++seen[key];
+        if (count > 1)
+        {
+            key += '#';
+            key += std::to_string(count);
+        }
+
+        keys[i] = std::move(key);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapDiffSnapshots()
+// Desc: Lists every difference between two snapshots: changed rows of the
+//       nodes they share, in the new snapshot's order, then rows and nodes
+//       that only one of them has. A node only one snapshot has is reported
+//       once, without its rows or children.
+//-----------------------------------------------------------------------------
+void CapDiffSnapshots(const CAPSNAPSHOT& oldSnapshot, const CAPSNAPSHOT& newSnapshot, std::vector<CAPDIFF>& diffs)
+{
+    diffs.clear();
+
+    std::vector<std::string> oldPaths;
+    std::vector<std::string> newPaths;
+    CapBuildNodePaths(oldSnapshot.nodes, oldPaths);
+    CapBuildNodePaths(newSnapshot.nodes, newPaths);
+
+    std::unordered_map<std::string, size_t> oldIndex;
+    oldIndex.reserve(oldPaths.size());
+    for (size_t i = 0; i < oldPaths.size(); ++i)
+        oldIndex.emplace(oldPaths[i], i);
+
+    std::vector<bool> matched(oldPaths.size(), false);
+    uint32_t addedDepth = NO_DEPTH;
+    for (size_t i = 0; i < newPaths.size(); ++i)
+    {
+        const CAPSNAPSHOTNODE& newNode = newSnapshot.nodes[i];
+        if (addedDepth != NO_DEPTH && newNode.depth > addedDepth)
+            continue;
+        addedDepth = NO_DEPTH;
+
+        auto it = oldIndex.find(newPaths[i]);
+        if (it == oldIndex.end())
+        {
+            diffs.push_back({ CAPDIFF_ADDED, newPaths[i], nullptr, nullptr });
+            addedDepth = newNode.depth;
+            continue;
+        }
+
+        matched[it->second] = true;
+        DiffModels(newPaths[i], oldSnapshot.nodes[it->second].pModel, newNode.pModel, diffs);
+    }
+
+    uint32_t removedDepth = NO_DEPTH;
+    for (size_t i = 0; i < oldPaths.size(); ++i)
+    {
+        const CAPSNAPSHOTNODE& oldNode = oldSnapshot.nodes[i];
+        if (removedDepth != NO_DEPTH && oldNode.depth > removedDepth)
+            continue;
+        removedDepth = NO_DEPTH;
+
+        if (!matched[i])
+        {
+            diffs.push_back({ CAPDIFF_REMOVED, oldPaths[i], nullptr, nullptr });
+            removedDepth = oldNode.depth;
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapDiffRowValue()
+// Desc: What a row shows after its name, with multiple columns joined
+//-----------------------------------------------------------------------------
+void CapDiffRowValue(const CAPROW& row, std::string& value)
+{
+    value.clear();
+    for (size_t i = 1; i < row.cells.size(); ++i)
+    {
+        if (i > 1)
+            value += ' ';
+        value += row.cells[i].text;
+    }
+}
@@ -0,0 +1,56 @@
+//-----------------------------------------------------------------------------
+// Name: dxdiff.h
+//
+// Desc: DirectX Capabilities Viewer snapshot comparison
+//
+//       Lines up the nodes of two snapshots by their path from the root, and
+//       the rows of each node by name, then reports what was added, removed
+//       or changed. Kept free of Windows dependencies so stored snapshots can
+//       be compared on any machine.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include "dxmodel.h"
+
+enum CAPDIFFKIND : uint32_t
+{
+    CAPDIFF_ADDED = 0,
+    CAPDIFF_REMOVED,
+    CAPDIFF_CHANGED,
+};
+
+struct CAPDIFF
+{
+    CAPDIFFKIND     kind;
+    std::string     path;       // Node names from the root, separated by '/'
+    const CAPROW*   pOld;       // Both rows are null when the whole node was added or removed
+    const CAPROW*   pNew;
+};
+
+// Every node of a snapshot file, which owns their models
+struct CAPSNAPSHOT
+{
+    std::string                     key;
+    std::vector<CAPSNAPSHOTNODE>    nodes;
+
+    CAPSNAPSHOT() = default;
+    CAPSNAPSHOT(const CAPSNAPSHOT&) = delete;
+    CAPSNAPSHOT& operator=(const CAPSNAPSHOT&) = delete;
+    ~CAPSNAPSHOT() { Clear(); }
+
+    bool Load(const uint8_t* pData, size_t cbData);
+    void Clear();
+};
+
+// Paths are unique within a snapshot, and name the same node in any other
+void CapBuildNodePaths(const std::vector<CAPSNAPSHOTNODE>& nodes, std::vector<std::string>& paths);
+void CapBuildRowKeys(const CAPMODEL& model, std::vector<std::string>& keys);
+
+// Rows point into the snapshots, which must outlive the results
+void CapDiffSnapshots(const CAPSNAPSHOT& oldSnapshot, const CAPSNAPSHOT& newSnapshot, std::vector<CAPDIFF>& diffs);
+void CapDiffRowValue(const CAPROW& row, std::string& value);
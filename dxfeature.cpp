@@ -0,0 +1,300 @@
+//-----------------------------------------------------------------------------
+// Name: dxfeature.cpp
+//
+// Desc: DirectX Capabilities Viewer feature level summaries
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxfeature.h"
+
+#include <cstring>
+
+namespace
+{
+    const char c_strYes[] = "Yes";
+    const char c_strNo[] = "No";
+    const char c_strNA[] = "n/a";
+    const char c_strOptYes[] = "Optional (Yes)";
+    const char c_strOptNo[] = "Optional (No)";
+
+    // By tier. Tiers past the end aren't known to the viewer and are just Yes.
+    const uint32_t MAX_TIER = 4;
+    const char* const c_strTiers[MAX_TIER + 1] =
+    {
+        c_strYes, "Yes - Tier 1", "Yes - Tier 2", "Yes - Tier 3", "Yes - Tier 4",
+    };
+    const char* const c_strOptTiers[MAX_TIER + 1] =
+    {
+        c_strOptNo, "Optional (Yes - Tier 1)", "Optional (Yes - Tier 2)", "Optional (Yes - Tier 3)", "Optional (Yes - Tier 4)",
+    };
+
+    // By the minor version of shader model 6
+    const char* const c_strShaderModel6[] =
+    {
+        "6.0 (Optional)", "6.1 (Optional)", "6.2 (Optional)", "6.3 (Optional)",
+        "6.4 (Optional)", "6.5 (Optional)", "6.6 (Optional)", "6.7 (Optional)",
+    };
+    const char* const c_strComputeShader6[] =
+    {
+        "Yes (CS 6.0)", "Yes (CS 6.1)", "Yes (CS 6.2)", "Yes (CS 6.3)",
+        "Yes (CS 6.4)", "Yes (CS 6.5)", "Yes (CS 6.6)", "Yes (CS 6.7)",
+    };
+
+    static_assert(sizeof(c_strShaderModel6) / sizeof(c_strShaderModel6[0]) == CAPFL_SHADER_MODEL_6_7 - CAPFL_SHADER_MODEL_6_0 + 1,
+        "One string per shader model");
+
+    //-----------------------------------------------------------------------------
+    void AddLine(CAPFLSUMMARY& summary, const char* strName, const char* strValue)
+    {
+        if (!strValue || summary.count >= CAPFL_MAX_LINES)
+            return;
+
+        CAPFLLINE& line = summary.lines[summary.count++];
+        line.strName = strName;
+        line.strValue = strValue;
+        line.bYesNo = false;
+        line.bSupported = strcmp(strValue, c_strNo) != 0 && strcmp(strValue, c_strNA) != 0;
+    }
+
+    void AddYesNo(CAPFLSUMMARY& summary, const char* strName, bool bSupported)
+    {
+        if (summary.count >= CAPFL_MAX_LINES)
+            return;
+
+        CAPFLLINE& line = summary.lines[summary.count++];
+        line.strName = strName;
+        line.strValue = bSupported ? c_strYes : c_strNo;
+        line.bYesNo = true;
+        line.bSupported = bSupported;
+    }
+
+    //-----------------------------------------------------------------------------
+    const char* RequirementText(CAPFLREQ req, bool bSupported)
+    {
+        switch (req)
+        {
+        case CAPFLREQ_NO:       return c_strNo;
+        case CAPFLREQ_OPTIONAL: return bSupported ? c_strOptYes : c_strOptNo;
+        case CAPFLREQ_REQUIRED: return c_strYes;
+        default:                return nullptr;
+        }
+    }
+
+    const char* TierText(CAPFLREQ req, uint32_t tier)
+    {
+        switch (req)
+        {
+        case CAPFLREQ_NO:       return c_strNo;
+        case CAPFLREQ_OPTIONAL: return (tier <= MAX_TIER) ? c_strOptTiers[tier] : c_strOptYes;
+        case CAPFLREQ_REQUIRED: return (tier <= MAX_TIER) ? c_strTiers[tier] : c_strYes;
+        default:                return nullptr;
+        }
+    }
+
+    // D3D12_RAYTRACING_TIER counts from 1.0 as 10
+    const char* RaytracingText(CAPFLREQ req, uint32_t tier)
+    {
+        const bool bRequired = (req == CAPFLREQ_REQUIRED);
+        switch (tier)
+        {
+        case 0:     return TierText(req, 0);
+        case 10:    return bRequired ? "Yes - Tier 1.0" : "Optional (Yes - Tier 1.0)";
+        case 11:    return bRequired ? "Yes - Tier 1.1" : "Optional (Yes - Tier 1.1)";
+        default:    return RequirementText(req, true);
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapFeatureSummary()
+// Desc: The lines are in the order the viewer shows them, including those the
+//       view filters out when it only shows what's supported
+//-----------------------------------------------------------------------------
+bool CapFeatureSummary(uint32_t fl, CAPFLAPI api, uint32_t flags, const CAPFLOPTIONS& options, CAPFLSUMMARY& summary)
+{
+    summary.count = 0;
+
+    fl = CapClampFeatureLevel(fl, api);
+
+    const bool bD3D12 = (api == CAPFLAPI_D3D12);
+    const CAPFLFEATURES* pFeatures = CapFindFLFeatures(fl);
+    const CAPFLLIMITS* pLimits = CapFindFLLimits(fl, bD3D12);
+    if (!pFeatures || !pLimits)
+        return false;
+
+    // Each takes in the later Direct3D 11 interfaces, but not Direct3D 12
+    const bool bD3D11 = (api >= CAPFLAPI_D3D11 && !bD3D12);
+    const bool bD3D11_1 = (api >= CAPFLAPI_D3D11_1 && !bD3D12);
+    const bool bD3D11_2 = (api >= CAPFLAPI_D3D11_2 && !bD3D12);
+    const bool bD3D11_3 = (api == CAPFLAPI_D3D11_3);
+    const bool b10level9 = (fl < CAPFL_10_0);
+
+    const char* strShaderModel = pFeatures->strShaderModel;
+    const char* strComputeShader = pFeatures->strComputeShader;
+    if (bD3D12)
+    {
+        strShaderModel = pFeatures->strShaderModel12;
+        strComputeShader = pFeatures->strComputeShader12;
+
+        if (pFeatures->shaderModel12 && options.shaderModel > pFeatures->shaderModel12
+            && options.shaderModel >= CAPFL_SHADER_MODEL_6_0 && options.shaderModel <= CAPFL_SHADER_MODEL_6_7)
+        {
+            strShaderModel = c_strShaderModel6[options.shaderModel - CAPFL_SHADER_MODEL_6_0];
+            strComputeShader = c_strComputeShader6[options.shaderModel - CAPFL_SHADER_MODEL_6_0];
+        }
+    }
+
+    // Where compute shaders are optional, so are UAVs
+    const char* strUAVSlots = pLimits->strUAVSlots;
+    const char* strUAVEveryStage = pFeatures->strUAVEveryStage;
+    const char* strUAVOnlyRender = pFeatures->strUAVOnlyRender;
+    if (pFeatures->computeShader == CAPFLREQ_OPTIONAL)
+    {
+        if (bD3D11 && options.computeShader4x)
+        {
+            strUAVSlots = "1";
+            strUAVEveryStage = c_strNo;
+            strUAVOnlyRender = c_strNo;
+        }
+        else
+        {
+            strComputeShader = bD3D11 ? c_strOptNo : c_strNo;
+        }
+    }
+    else if (pFeatures->computeShader == CAPFLREQ_NA)
+    {
+        strComputeShader = c_strNA;
+    }
+
+    AddLine(summary, "Shader Model", strShaderModel);
+    AddYesNo(summary, "Geometry Shader", fl >= CAPFL_10_0);
+    AddYesNo(summary, "Stream Out", fl >= CAPFL_10_0);
+
+    if (bD3D11 || bD3D12)
+    {
+        AddLine(summary, "DirectCompute", strComputeShader);
+        AddYesNo(summary, "Hull & Domain Shaders", fl >= CAPFL_11_0);
+    }
+
+    if (bD3D12)
+    {
+        AddLine(summary, "Variable Rate Shading (VRS)", TierText(pFeatures->vrs, options.vrsTier));
+        AddLine(summary, "Mesh & Amplification Shaders", RequirementText(pFeatures->meshShaders, options.meshShaders));
+        AddLine(summary, "DirectX Raytracing", RaytracingText(pFeatures->raytracing, options.raytracingTier));
+    }
+
+    AddYesNo(summary, "Texture Resource Arrays", fl >= CAPFL_10_0);
+
+    if (api != CAPFLAPI_D3D10)
+    {
+        AddYesNo(summary, "Cubemap Resource Arrays", fl >= CAPFL_10_1);
+    }
+
+    AddYesNo(summary, "BC4/BC5 Compression", fl >= CAPFL_10_0);
+
+    if (bD3D11 || bD3D12)
+    {
+        AddYesNo(summary, "BC6H/BC7 Compression", fl >= CAPFL_11_0);
+    }
+
+    AddYesNo(summary, "Alpha-to-coverage", fl >= CAPFL_10_0);
+
+    if (bD3D11_1 || bD3D12)
+    {
+        AddLine(summary, "Logic Ops (Output Merger)", RequirementText(pFeatures->logicOps, options.logicOps));
+    }
+
+    if (bD3D11_1)
+    {
+        AddLine(summary, "Constant Buffer Partial Updates", RequirementText(pFeatures->cbUpdates, options.cbPartial));
+        AddLine(summary, "Constant Buffer Offsetting", RequirementText(pFeatures->cbUpdates, options.cbOffsetting));
+        AddLine(summary, "UAVs at Every Stage", strUAVEveryStage);
+        AddLine(summary, "UAV-only rendering", strUAVOnlyRender);
+    }
+
+    if (bD3D11_2 || bD3D12)
+    {
+        AddLine(summary, "Tiled Resources", TierText(pFeatures->tiled, options.tiledTier));
+    }
+
+    if (bD3D11_2)
+    {
+        AddLine(summary, "Min/Max Filtering", RequirementText(pFeatures->minMaxFilter, options.minMaxFilter));
+        AddLine(summary, "Map DEFAULT Buffers", RequirementText(pFeatures->mapDefaultBuffers, options.mapDefaultBuffers));
+    }
+
+    if (bD3D11_3 || bD3D12)
+    {
+        AddLine(summary, "Conservative Rasterization", TierText(pFeatures->conservativeRaster, options.conservativeTier));
+        AddLine(summary, "PS-Specified Stencil Ref", RequirementText(pFeatures->psStencilRef, options.psStencilRef));
+        AddLine(summary, "Rasterizer Ordered Views", RequirementText(pFeatures->rovs, options.rovs));
+    }
+
+    if (bD3D12)
+    {
+        AddLine(summary, "Resource Binding", TierText(pFeatures->resourceBinding, options.bindingTier));
+    }
+
+    if ((flags & CAPFLF_DXGI1_1) && !bD3D12)
+    {
+        AddLine(summary, "Extended Formats (BGRA, etc.)", RequirementText(pFeatures->extFormats, options.extFormats));
+        AddLine(summary, "10-bit XR High Color Format", RequirementText(pFeatures->x2Format, options.x2Format));
+    }
+
+    if (bD3D11_1)
+    {
+        AddLine(summary, "16-bit Formats (565/5551/4444)", RequirementText(pFeatures->bpp16, options.bpp565));
+
+        const char* strNonPow2 = pFeatures->strNonPow2;
+        if (!strNonPow2)
+            strNonPow2 = options.nonPow2 ? "Optional (Full)" : "Conditional";
+        AddLine(summary, "Non-Power-of-2 Textures", strNonPow2);
+    }
+
+    const char* strMaxTexDim = pLimits->strMaxTexDim;
+    if (flags & CAPFLF_WARP)
+    {
+        strMaxTexDim = (bD3D11_1 || bD3D12) ? "16777216" : "65536";
+    }
+
+    AddLine(summary, "Max Texture Dimension", strMaxTexDim);
+    AddLine(summary, "Max Cubemap Dimension", pLimits->strMaxCubeDim);
+    AddLine(summary, "Max Volume Extent", pLimits->strMaxVolDim);
+    AddLine(summary, "Max Texture Repeat", pLimits->strMaxTexRepeat);
+    AddLine(summary, "Max Input Slots", pLimits->strMaxInputSlots);
+    AddLine(summary, "UAV Slots", strUAVSlots);
+    AddLine(summary, "Max Anisotropy", pLimits->strMaxAnisotropy);
+    AddLine(summary, "Max Primitive Count", pLimits->strMaxPrimCount);
+    AddLine(summary, "Simultaneous Render Targets", pLimits->strMRT);
+
+    if (b10level9)
+    {
+        AddYesNo(summary, "Occlusion Queries", fl >= CAPFL_9_2);
+        AddYesNo(summary, "Separate Alpha Blend", fl >= CAPFL_9_2);
+        AddYesNo(summary, "Mirror Once", fl >= CAPFL_9_2);
+        AddYesNo(summary, "Overlapping Vertex Elements", fl >= CAPFL_9_2);
+        AddYesNo(summary, "Independant Write Masks", fl >= CAPFL_9_3);
+
+        // Only Direct3D 11.2 reports simple instancing
+        const char* strInstancing = RequirementText(pFeatures->instancing, options.instancing);
+        if (pFeatures->instancing == CAPFLREQ_OPTIONAL)
+            strInstancing = !bD3D11_2 ? c_strNo : options.instancing ? "Optional (Simple)" : c_strOptNo;
+        AddLine(summary, "Instancing", strInstancing);
+
+        if (bD3D11_1)
+        {
+            AddLine(summary, "Shadow Support", RequirementText(CAPFLREQ_OPTIONAL, options.shadows));
+        }
+
+        if (bD3D11_2)
+        {
+            AddLine(summary, "Cubemap Render w/ non-Cube Depth", RequirementText(CAPFLREQ_OPTIONAL, options.cubeRT));
+        }
+    }
+
+    return true;
+}
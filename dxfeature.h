@@ -0,0 +1,310 @@
+//-----------------------------------------------------------------------------
+// Name: dxfeature.h
+//
+// Desc: DirectX Capabilities Viewer feature level summaries
+//
+//       What a feature level fixes is kept in constant tables, one row per
+//       level. Only what a level leaves optional is asked of the device, once
+//       per device (see CAPFLOPTIONS), and the summary shown for a level is
+//       derived from the tables and those answers alone. The limits are
+//       spelled as the SDK headers name them, which dxgi.cpp checks at compile
+//       time. Kept free of Windows dependencies.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Valued as D3D_FEATURE_LEVEL is
+enum CAPFL : uint32_t
+{
+    CAPFL_9_1 = 0x9100,
+    CAPFL_9_2 = 0x9200,
+    CAPFL_9_3 = 0x9300,
+    CAPFL_10_0 = 0xa000,
+    CAPFL_10_1 = 0xa100,
+    CAPFL_11_0 = 0xb000,
+    CAPFL_11_1 = 0xb100,
+    CAPFL_12_0 = 0xc000,
+    CAPFL_12_1 = 0xc100,
+    CAPFL_12_2 = 0xc200,
+};
+
+// The device interface a summary is for, valued as the low byte of a feature
+// level node's lParam3
+enum CAPFLAPI : uint32_t
+{
+    CAPFLAPI_D3D10 = 0,
+    CAPFLAPI_D3D10_1 = 1,
+    CAPFLAPI_D3D11 = 2,
+    CAPFLAPI_D3D11_1 = 3,
+    CAPFLAPI_D3D11_2 = 4,
+    CAPFLAPI_D3D11_3 = 5,
+    CAPFLAPI_D3D12 = 10,
+};
+
+// How a level has a feature
+enum CAPFLREQ : uint8_t
+{
+    CAPFLREQ_NA = 0,        // Not shown at this level
+    CAPFLREQ_NO,
+    CAPFLREQ_OPTIONAL,      // As the device reports it
+    CAPFLREQ_REQUIRED,
+};
+
+#define CAPFL_SHADER_MODEL_5_1  0x51    // D3D_SHADER_MODEL values
+#define CAPFL_SHADER_MODEL_6_0  0x60
+#define CAPFL_SHADER_MODEL_6_5  0x65
+#define CAPFL_SHADER_MODEL_6_7  0x67    // The highest the viewer asks about
+
+#define CAPFLF_WARP     0x01    // The WARP software device
+#define CAPFLF_DXGI1_1  0x02    // DXGI 1.1 or later, needed for extended formats
+
+// The resource limits of a level. Direct3D 12 devices name those of the 12_x
+// levels after their own API, and those of lower levels as Direct3D 11 does.
+struct CAPFLLIMITS
+{
+    uint32_t        flMin;
+    uint32_t        flMax;
+    bool            bD3D12;
+    const char*     strMaxTexDim;
+    const char*     strMaxCubeDim;
+    const char*     strMaxVolDim;
+    const char*     strMaxTexRepeat;
+    const char*     strMaxAnisotropy;
+    const char*     strMaxPrimCount;
+    const char*     strMaxInputSlots;
+    const char*     strMRT;
+    const char*     strUAVSlots;            // Null where UAVs come with optional compute shaders
+};
+
+constexpr CAPFLLIMITS c_capFLLimits[] =
+{
+    { CAPFL_12_0, CAPFL_12_2, true,
+        "D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION( 16384 )", "D3D12_REQ_TEXTURECUBE_DIMENSION( 16384 )",
+        "D3D12_REQ_TEXTURE3D_U_V_OR_W_DIMENSION( 2048 )", "D3D12_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION( 16384 )",
+        "D3D12_REQ_MAXANISOTROPY( 16 )", "4294967296", "D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT( 32 )",
+        "D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT( 8 )", "D3D12_UAV_SLOT_COUNT( 64 )" },
+    { CAPFL_11_1, CAPFL_12_2, false,
+        "D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION( 16384 )", "D3D11_REQ_TEXTURECUBE_DIMENSION( 16384 )",
+        "D3D11_REQ_TEXTURE3D_U_V_OR_W_DIMENSION( 2048 )", "D3D11_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION( 16384 )",
+        "D3D11_REQ_MAXANISOTROPY( 16 )", "4294967296", "D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT( 32 )",
+        "D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT( 8 )", "D3D11_1_UAV_SLOT_COUNT( 64 )" },
+    { CAPFL_11_0, CAPFL_11_0, false,
+        "D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION( 16384 )", "D3D11_REQ_TEXTURECUBE_DIMENSION( 16384 )",
+        "D3D11_REQ_TEXTURE3D_U_V_OR_W_DIMENSION( 2048 )", "D3D11_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION( 16384 )",
+        "D3D11_REQ_MAXANISOTROPY( 16 )", "4294967296", "D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT( 32 )",
+        "D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT( 8 )", "8" },
+    { CAPFL_10_1, CAPFL_10_1, false,
+        "D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION( 8192 )", "D3D10_REQ_TEXTURECUBE_DIMENSION( 8192 )",
+        "D3D10_REQ_TEXTURE3D_U_V_OR_W_DIMENSION( 2048 )", "D3D10_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION( 8192 )",
+        "D3D10_REQ_MAXANISOTROPY( 16 )", "4294967296", "D3D10_1_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT( 32 )",
+        "D3D10_SIMULTANEOUS_RENDER_TARGET_COUNT( 8 )", nullptr },
+    { CAPFL_10_0, CAPFL_10_0, false,
+        "D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION( 8192 )", "D3D10_REQ_TEXTURECUBE_DIMENSION( 8192 )",
+        "D3D10_REQ_TEXTURE3D_U_V_OR_W_DIMENSION( 2048 )", "D3D10_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION( 8192 )",
+        "D3D10_REQ_MAXANISOTROPY( 16 )", "4294967296", "D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT( 16 )",
+        "D3D10_SIMULTANEOUS_RENDER_TARGET_COUNT( 8 )", nullptr },
+    { CAPFL_9_3, CAPFL_9_3, false,
+        "D3D_FL9_3_REQ_TEXTURE2D_U_OR_V_DIMENSION( 4096 )", "D3D_FL9_3_REQ_TEXTURECUBE_DIMENSION( 4096 )",
+        "D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION( 256 )", "D3D_FL9_3_MAX_TEXTURE_REPEAT( 8192 )",
+        "D3D11_REQ_MAXANISOTROPY( 16 )", "D3D_FL9_2_IA_PRIMITIVE_MAX_COUNT( 1048575 )", "D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT( 16 )",
+        "D3D_FL9_3_SIMULTANEOUS_RENDER_TARGET_COUNT( 4 )", nullptr },
+    { CAPFL_9_2, CAPFL_9_2, false,
+        "D3D_FL9_1_REQ_TEXTURE2D_U_OR_V_DIMENSION( 2048 )", "D3D_FL9_1_REQ_TEXTURECUBE_DIMENSION( 512 )",
+        "D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION( 256 )", "D3D_FL9_2_MAX_TEXTURE_REPEAT( 2048 )",
+        "D3D11_REQ_MAXANISOTROPY( 16 )", "D3D_FL9_2_IA_PRIMITIVE_MAX_COUNT( 1048575 )", "D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT( 16 )",
+        "D3D_FL9_1_SIMULTANEOUS_RENDER_TARGET_COUNT( 1 )", nullptr },
+    { CAPFL_9_1, CAPFL_9_1, false,
+        "D3D_FL9_1_REQ_TEXTURE2D_U_OR_V_DIMENSION( 2048 )", "D3D_FL9_1_REQ_TEXTURECUBE_DIMENSION( 512 )",
+        "D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION( 256 )", "D3D_FL9_1_MAX_TEXTURE_REPEAT( 128 )",
+        "D3D_FL9_1_DEFAULT_MAX_ANISOTROPY( 2 )", "D3D_FL9_1_IA_PRIMITIVE_MAX_COUNT( 65535 )", "D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT( 16 )",
+        "D3D_FL9_1_SIMULTANEOUS_RENDER_TARGET_COUNT( 1 )", nullptr },
+};
+
+// The features of a level. Shader model 5.0 and 5.1 devices are summed up by
+// the level alone; Direct3D 12 devices at 12_0 and up may report a higher
+// shader model than the level requires.
+struct CAPFLFEATURES
+{
+    uint32_t        fl;
+    const char*     strShaderModel;
+    const char*     strShaderModel12;       // For Direct3D 12 devices
+    uint32_t        shaderModel12;          // D3D_SHADER_MODEL the level requires of them, 0 if not asked
+    CAPFLREQ        computeShader;
+    const char*     strComputeShader;       // When supported
+    const char*     strComputeShader12;
+    const char*     strUAVEveryStage;       // Null where UAVs come with optional compute shaders
+    const char*     strUAVOnlyRender;
+    const char*     strNonPow2;             // Null where it's a 10level9 option
+    CAPFLREQ        logicOps;
+    CAPFLREQ        cbUpdates;              // Partial updates and offsetting
+    CAPFLREQ        tiled;
+    CAPFLREQ        minMaxFilter;
+    CAPFLREQ        mapDefaultBuffers;
+    CAPFLREQ        conservativeRaster;
+    CAPFLREQ        rovs;
+    CAPFLREQ        psStencilRef;
+    CAPFLREQ        resourceBinding;
+    CAPFLREQ        extFormats;
+    CAPFLREQ        x2Format;
+    CAPFLREQ        bpp16;
+    CAPFLREQ        instancing;
+    CAPFLREQ        vrs;
+    CAPFLREQ        meshShaders;
+    CAPFLREQ        raytracing;
+};
+
+#define FLREQ_NA    CAPFLREQ_NA
+#define FLREQ_NO    CAPFLREQ_NO
+#define FLREQ_OPT   CAPFLREQ_OPTIONAL
+#define FLREQ_REQ   CAPFLREQ_REQUIRED
+
+constexpr CAPFLFEATURES c_capFLFeatures[] =
+{
+    //                          Logic      CB         Tiled      MinMax     MapDef     ConsRast   ROVs       StenRef    Binding    ExtFmt     X2         16bpp      Instance   VRS        Mesh       DXR
+    { CAPFL_12_2, "5.0", "6.5", CAPFL_SHADER_MODEL_6_5, FLREQ_REQ, "Yes (CS 5.0)", "Yes (CS 6.5)", "Yes", "16", "Full",
+                                FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_OPT, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ },
+    { CAPFL_12_1, "5.0", "5.1", CAPFL_SHADER_MODEL_5_1, FLREQ_REQ, "Yes (CS 5.0)", "Yes (CS 5.1)", "Yes", "16", "Full",
+                                FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_OPT, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_OPT, FLREQ_OPT, FLREQ_OPT },
+    { CAPFL_12_0, "5.0", "5.1", CAPFL_SHADER_MODEL_5_1, FLREQ_REQ, "Yes (CS 5.0)", "Yes (CS 5.1)", "Yes", "16", "Full",
+                                FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_OPT, FLREQ_OPT, FLREQ_OPT, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_OPT, FLREQ_OPT, FLREQ_OPT },
+    { CAPFL_11_1, "5.0", "5.1", 0, FLREQ_REQ, "Yes (CS 5.0)", "Yes (CS 5.1)", "Yes", "16", "Full",
+                                FLREQ_REQ, FLREQ_REQ, FLREQ_OPT, FLREQ_OPT, FLREQ_OPT, FLREQ_OPT, FLREQ_OPT, FLREQ_OPT, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_OPT, FLREQ_OPT, FLREQ_OPT },
+    { CAPFL_11_0, "5.0", "5.1", 0, FLREQ_REQ, "Yes (CS 5.0)", "Yes (CS 5.1)", "No", "8", "Full",
+                                FLREQ_OPT, FLREQ_OPT, FLREQ_OPT, FLREQ_NO,  FLREQ_OPT, FLREQ_NO,  FLREQ_NO,  FLREQ_NO,  FLREQ_REQ, FLREQ_REQ, FLREQ_REQ, FLREQ_OPT, FLREQ_REQ, FLREQ_OPT, FLREQ_OPT, FLREQ_OPT },
+    { CAPFL_10_1, "4.x", nullptr, 0, FLREQ_OPT, "Optional (Yes - CS 4.x)", nullptr, nullptr, nullptr, "Full",
+                                FLREQ_OPT, FLREQ_OPT, FLREQ_NO,  FLREQ_NO,  FLREQ_NO,  FLREQ_NO,  FLREQ_NO,  FLREQ_NO,  FLREQ_NA,  FLREQ_OPT, FLREQ_OPT, FLREQ_OPT, FLREQ_REQ, FLREQ_NA,  FLREQ_NA,  FLREQ_NA },
+    { CAPFL_10_0, "4.0", nullptr, 0, FLREQ_OPT, "Optional (Yes - CS 4.0)", nullptr, nullptr, nullptr, "Full",
+                                FLREQ_OPT, FLREQ_OPT, FLREQ_NO,  FLREQ_NO,  FLREQ_NO,  FLREQ_NO,  FLREQ_NO,  FLREQ_NO,  FLREQ_NA,  FLREQ_OPT, FLREQ_OPT, FLREQ_OPT, FLREQ_REQ, FLREQ_NA,  FLREQ_NA,  FLREQ_NA },
+    { CAPFL_9_3, "2.0 (4_0_level_9_3) [vs_2_a/ps_2_b]", nullptr, 0, FLREQ_NA, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                FLREQ_NO,  FLREQ_REQ, FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_REQ, FLREQ_NA,  FLREQ_OPT, FLREQ_REQ, FLREQ_NA,  FLREQ_NA,  FLREQ_NA },
+    { CAPFL_9_2, "2.0 (4_0_level_9_1)", nullptr, 0, FLREQ_NA, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                FLREQ_NO,  FLREQ_REQ, FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_REQ, FLREQ_NA,  FLREQ_OPT, FLREQ_OPT, FLREQ_NA,  FLREQ_NA,  FLREQ_NA },
+    { CAPFL_9_1, "2.0 (4_0_level_9_1)", nullptr, 0, FLREQ_NA, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                FLREQ_NO,  FLREQ_REQ, FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_NA,  FLREQ_REQ, FLREQ_NA,  FLREQ_OPT, FLREQ_OPT, FLREQ_NA,  FLREQ_NA,  FLREQ_NA },
+};
+
+#undef FLREQ_NA
+#undef FLREQ_NO
+#undef FLREQ_OPT
+#undef FLREQ_REQ
+
+// What a device reported of the features levels leave optional. Only what
+// its interface can report is filled in, the rest is left zero.
+struct CAPFLOPTIONS
+{
+    uint32_t        shaderModel;            // Highest D3D_SHADER_MODEL
+    uint32_t        tiledTier;              // D3D11_ or D3D12_TILED_RESOURCES_TIER
+    uint32_t        bindingTier;            // D3D12_RESOURCE_BINDING_TIER
+    uint32_t        conservativeTier;       // D3D11_ or D3D12_CONSERVATIVE_RASTERIZATION_TIER
+    uint32_t        vrsTier;                // D3D12_VARIABLE_SHADING_RATE_TIER
+    uint32_t        raytracingTier;         // D3D12_RAYTRACING_TIER
+    bool            meshShaders;
+    bool            rovs;
+    bool            psStencilRef;
+    bool            logicOps;
+    bool            cbPartial;
+    bool            cbOffsetting;
+    bool            minMaxFilter;
+    bool            mapDefaultBuffers;
+    bool            computeShader4x;        // With raw and structured buffers
+    bool            extFormats;             // BGRA render targets
+    bool            x2Format;               // 10-bit XR scan-out
+    bool            bpp565;
+    bool            nonPow2;                // The rest are 10level9 options
+    bool            shadows;
+    bool            instancing;
+    bool            cubeRT;
+};
+
+#define CAPFL_MAX_LINES 64
+
+struct CAPFLLINE
+{
+    const char*     strName;
+    const char*     strValue;
+    bool            bYesNo;                 // Printed even when not supported
+    bool            bSupported;             // Neither No nor n/a
+};
+
+struct CAPFLSUMMARY
+{
+    CAPFLLINE       lines[CAPFL_MAX_LINES];
+    size_t          count;
+};
+
+
+//-----------------------------------------------------------------------------
+// Name: CapFindFLLimits()
+//-----------------------------------------------------------------------------
+constexpr const CAPFLLIMITS* CapFindFLLimits(uint32_t fl, bool bD3D12)
+{
+    for (const auto& limits : c_capFLLimits)
+    {
+        if (fl >= limits.flMin && fl <= limits.flMax && (bD3D12 || !limits.bD3D12))
+            return &limits;
+    }
+    return nullptr;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapFindFLFeatures()
+//-----------------------------------------------------------------------------
+constexpr const CAPFLFEATURES* CapFindFLFeatures(uint32_t fl)
+{
+    for (const auto& features : c_capFLFeatures)
+    {
+        if (features.fl == fl)
+            return &features;
+    }
+    return nullptr;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapClampFeatureLevel()
+// Desc: The highest level an interface can report, as Direct3D 11.3 was the
+//       first to know of the 12_x levels
+//-----------------------------------------------------------------------------
+constexpr uint32_t CapClampFeatureLevel(uint32_t fl, CAPFLAPI api)
+{
+    uint32_t flMax = (api == CAPFLAPI_D3D12 || api == CAPFLAPI_D3D11_3) ? CAPFL_12_2
+        : (api >= CAPFLAPI_D3D11_1) ? CAPFL_11_1
+        : (api == CAPFLAPI_D3D11) ? CAPFL_11_0
+        : (api == CAPFLAPI_D3D10_1) ? CAPFL_10_1
+        : CAPFL_10_0;
+    return (fl > flMax) ? flMax : fl;
+}
+
+constexpr bool CapFLTextEquals(const char* strA, const char* strB)
+{
+    if (!strA || !strB)
+        return strA == strB;
+    for (; *strA && *strA == *strB; ++strA, ++strB) {}
+    return *strA == *strB;
+}
+
+static_assert(CapFindFLLimits(CAPFL_12_2, true)->bD3D12 && !CapFindFLLimits(CAPFL_12_2, false)->bD3D12,
+    "Direct3D 12 limits must come first");
+static_assert(CapFLTextEquals(CapFindFLLimits(CAPFL_11_1, true)->strMaxTexDim, CapFindFLLimits(CAPFL_11_1, false)->strMaxTexDim),
+    "Direct3D 12 devices name the limits of 11_x as Direct3D 11 does");
+static_assert(CapFindFLFeatures(CAPFL_9_1)->fl == CAPFL_9_1 && CapFindFLLimits(CAPFL_9_1, false)->flMin == CAPFL_9_1,
+    "Every level needs a row");
+
+// The summary shown for a level of the device, false for a level the viewer
+// doesn't know. flags are CAPFLF_ values.
+bool CapFeatureSummary(uint32_t fl, CAPFLAPI api, uint32_t flags, const CAPFLOPTIONS& options, CAPFLSUMMARY& summary);
+
+// Whether the viewer shows a line of the summary. Unless everything is shown
+// only what's supported is, though printing keeps every Yes/No line.
+constexpr bool CapFLLineShown(const CAPFLLINE& line, bool bViewAll, bool bPrint)
+{
+    return bViewAll || line.bSupported || (bPrint && line.bYesNo);
+}
@@ -0,0 +1,2150 @@
+//-----------------------------------------------------------------------------
+// Name: dxfeaturetest.cpp
+//
+// Desc: Checks the feature level summaries CapFeatureSummary derives against
+//       the D3D_FeatureLevel that dxgi.cpp had before the tables, for every
+//       feature level, interface, CAPFLF_ flag, view and print, and every
+//       combination of the options each interface reports (see TryOptions)
+//
+//       The old function is kept below as it was, built against stand-ins
+//       for the device interfaces that answer from a CAPFLOPTIONS. Where the
+//       summaries were meant to change, ExpectChanges says how. Exits with 0
+//       when every summary matches and 1 otherwise.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxfeature.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    //-----------------------------------------------------------------------------
+    // What D3D_FeatureLevel used of windows.h, d3d10_1.h, d3d11_3.h and d3d12.h
+    //-----------------------------------------------------------------------------
+    typedef long HRESULT;
+    typedef int BOOL;
+    typedef intptr_t LPARAM;
+    typedef unsigned int UINT;
+    typedef void* HWND;
+
+    const HRESULT S_OK = 0;
+    const HRESULT E_FAIL = static_cast<HRESULT>(0x80004005);
+    const HRESULT E_INVALIDARG = static_cast<HRESULT>(0x80070057);
+
+    const BOOL TRUE = 1;
+    const BOOL FALSE = 0;
+
+    inline bool SUCCEEDED(HRESULT hr) { return hr >= 0; }
+    inline bool FAILED(HRESULT hr) { return hr < 0; }
+
+    enum D3D_FEATURE_LEVEL
+    {
+        D3D_FEATURE_LEVEL_9_1 = CAPFL_9_1,
+        D3D_FEATURE_LEVEL_9_2 = CAPFL_9_2,
+        D3D_FEATURE_LEVEL_9_3 = CAPFL_9_3,
+        D3D_FEATURE_LEVEL_10_0 = CAPFL_10_0,
+        D3D_FEATURE_LEVEL_10_1 = CAPFL_10_1,
+        D3D_FEATURE_LEVEL_11_0 = CAPFL_11_0,
+        D3D_FEATURE_LEVEL_11_1 = CAPFL_11_1,
+        D3D_FEATURE_LEVEL_12_0 = CAPFL_12_0,
+        D3D_FEATURE_LEVEL_12_1 = CAPFL_12_1,
+        D3D_FEATURE_LEVEL_12_2 = CAPFL_12_2,
+    };
+
+    enum D3D_DRIVER_TYPE
+    {
+        D3D_DRIVER_TYPE_HARDWARE = 1,
+        D3D_DRIVER_TYPE_WARP = 5,
+    };
+
+    enum D3D_SHADER_MODEL
+    {
+        D3D_SHADER_MODEL_5_1 = 0x51,
+        D3D_SHADER_MODEL_6_0 = 0x60,
+        D3D_SHADER_MODEL_6_1 = 0x61,
+        D3D_SHADER_MODEL_6_2 = 0x62,
+        D3D_SHADER_MODEL_6_3 = 0x63,
+        D3D_SHADER_MODEL_6_4 = 0x64,
+        D3D_SHADER_MODEL_6_5 = 0x65,
+        D3D_SHADER_MODEL_6_6 = 0x66,
+        D3D_SHADER_MODEL_6_7 = 0x67,
+    };
+
+    enum D3D11_TILED_RESOURCES_TIER
+    {
+        D3D11_TILED_RESOURCES_NOT_SUPPORTED = 0,
+        D3D11_TILED_RESOURCES_TIER_1 = 1,
+        D3D11_TILED_RESOURCES_TIER_2 = 2,
+        D3D11_TILED_RESOURCES_TIER_3 = 3,
+    };
+
+    enum D3D11_CONSERVATIVE_RASTERIZATION_TIER
+    {
+        D3D11_CONSERVATIVE_RASTERIZATION_NOT_SUPPORTED = 0,
+        D3D11_CONSERVATIVE_RASTERIZATION_TIER_1 = 1,
+        D3D11_CONSERVATIVE_RASTERIZATION_TIER_2 = 2,
+        D3D11_CONSERVATIVE_RASTERIZATION_TIER_3 = 3,
+    };
+
+    enum D3D12_TILED_RESOURCES_TIER
+    {
+        D3D12_TILED_RESOURCES_TIER_NOT_SUPPORTED = 0,
+        D3D12_TILED_RESOURCES_TIER_1 = 1,
+        D3D12_TILED_RESOURCES_TIER_2 = 2,
+        D3D12_TILED_RESOURCES_TIER_3 = 3,
+        D3D12_TILED_RESOURCES_TIER_4 = 4,
+    };
+
+    enum D3D12_RESOURCE_BINDING_TIER
+    {
+        D3D12_RESOURCE_BINDING_TIER_1 = 1,
+        D3D12_RESOURCE_BINDING_TIER_2 = 2,
+        D3D12_RESOURCE_BINDING_TIER_3 = 3,
+    };
+
+    enum D3D12_CONSERVATIVE_RASTERIZATION_TIER
+    {
+        D3D12_CONSERVATIVE_RASTERIZATION_TIER_NOT_SUPPORTED = 0,
+        D3D12_CONSERVATIVE_RASTERIZATION_TIER_1 = 1,
+        D3D12_CONSERVATIVE_RASTERIZATION_TIER_2 = 2,
+        D3D12_CONSERVATIVE_RASTERIZATION_TIER_3 = 3,
+    };
+
+    enum D3D12_VARIABLE_SHADING_RATE_TIER
+    {
+        D3D12_VARIABLE_SHADING_RATE_TIER_NOT_SUPPORTED = 0,
+        D3D12_VARIABLE_SHADING_RATE_TIER_1 = 1,
+        D3D12_VARIABLE_SHADING_RATE_TIER_2 = 2,
+    };
+
+    enum D3D12_RAYTRACING_TIER
+    {
+        D3D12_RAYTRACING_TIER_NOT_SUPPORTED = 0,
+        D3D12_RAYTRACING_TIER_1_0 = 10,
+        D3D12_RAYTRACING_TIER_1_1 = 11,
+    };
+
+    enum D3D11_FEATURE
+    {
+        D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS = 4,
+        D3D11_FEATURE_D3D11_OPTIONS2 = 14,
+    };
+
+    enum D3D12_FEATURE
+    {
+        D3D12_FEATURE_D3D12_OPTIONS = 0,
+    };
+
+    struct D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS
+    {
+        BOOL ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x;
+    };
+
+    struct D3D11_FEATURE_DATA_D3D11_OPTIONS2
+    {
+        D3D11_TILED_RESOURCES_TIER TiledResourcesTier;
+    };
+
+    struct D3D12_FEATURE_DATA_D3D12_OPTIONS
+    {
+        BOOL OutputMergerLogicOp;
+        D3D12_TILED_RESOURCES_TIER TiledResourcesTier;
+        D3D12_RESOURCE_BINDING_TIER ResourceBindingTier;
+        BOOL PSSpecifiedStencilRefSupported;
+        D3D12_CONSERVATIVE_RASTERIZATION_TIER ConservativeRasterizationTier;
+        BOOL ROVsSupported;
+    };
+
+#define D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION ( 8192 )
+#define D3D10_REQ_TEXTURECUBE_DIMENSION ( 8192 )
+#define D3D10_REQ_TEXTURE3D_U_V_OR_W_DIMENSION ( 2048 )
+#define D3D10_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION ( 8192 )
+#define D3D10_REQ_MAXANISOTROPY ( 16 )
+#define D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT ( 16 )
+#define D3D10_1_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT ( 32 )
+#define D3D10_SIMULTANEOUS_RENDER_TARGET_COUNT ( 8 )
+#define D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION ( 16384 )
+#define D3D11_REQ_TEXTURECUBE_DIMENSION ( 16384 )
+#define D3D11_REQ_TEXTURE3D_U_V_OR_W_DIMENSION ( 2048 )
+#define D3D11_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION ( 16384 )
+#define D3D11_REQ_MAXANISOTROPY ( 16 )
+#define D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT ( 32 )
+#define D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT ( 8 )
+#define D3D11_1_UAV_SLOT_COUNT ( 64 )
+#define D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION ( 16384 )
+#define D3D12_REQ_TEXTURECUBE_DIMENSION ( 16384 )
+#define D3D12_REQ_TEXTURE3D_U_V_OR_W_DIMENSION ( 2048 )
+#define D3D12_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION ( 16384 )
+#define D3D12_REQ_MAXANISOTROPY ( 16 )
+#define D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT ( 32 )
+#define D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT ( 8 )
+#define D3D12_UAV_SLOT_COUNT ( 64 )
+#define D3D_FL9_1_REQ_TEXTURE2D_U_OR_V_DIMENSION 2048
+#define D3D_FL9_3_REQ_TEXTURE2D_U_OR_V_DIMENSION 4096
+#define D3D_FL9_1_REQ_TEXTURECUBE_DIMENSION 512
+#define D3D_FL9_3_REQ_TEXTURECUBE_DIMENSION 4096
+#define D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION 256
+#define D3D_FL9_1_DEFAULT_MAX_ANISOTROPY 2
+#define D3D_FL9_1_IA_PRIMITIVE_MAX_COUNT 65535
+#define D3D_FL9_2_IA_PRIMITIVE_MAX_COUNT 1048575
+#define D3D_FL9_1_SIMULTANEOUS_RENDER_TARGET_COUNT 1
+#define D3D_FL9_3_SIMULTANEOUS_RENDER_TARGET_COUNT 4
+#define D3D_FL9_1_MAX_TEXTURE_REPEAT 128
+#define D3D_FL9_2_MAX_TEXTURE_REPEAT 2048
+#define D3D_FL9_3_MAX_TEXTURE_REPEAT 8192
+
+#define XTOSTRING(a) #a TOSTRING(a)
+#define TOSTRING(a) #a
+
+#define XTOSTRING2(a) #a TOSTRING2(a)
+#define TOSTRING2(a) "( " #a " )"
+
+    //-----------------------------------------------------------------------------
+    // Stand-ins for the devices, which answer from the options under test
+    //-----------------------------------------------------------------------------
+    struct ID3D10Device
+    {
+        const CAPFLOPTIONS* pOptions;
+    };
+
+    struct ID3D10Device1 : ID3D10Device {};
+
+    struct ID3D11Device
+    {
+        const CAPFLOPTIONS* pOptions;
+
+        HRESULT CheckFeatureSupport(D3D11_FEATURE feature, void* pData, UINT cbData)
+        {
+            if (feature == D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS && cbData == sizeof(D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS))
+            {
+                auto pHW = static_cast<D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS*>(pData);
+                pHW->ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x = pOptions->computeShader4x;
+                return S_OK;
+            }
+
+            if (feature == D3D11_FEATURE_D3D11_OPTIONS2 && cbData == sizeof(D3D11_FEATURE_DATA_D3D11_OPTIONS2))
+            {
+                auto pOpts = static_cast<D3D11_FEATURE_DATA_D3D11_OPTIONS2*>(pData);
+                pOpts->TiledResourcesTier = static_cast<D3D11_TILED_RESOURCES_TIER>(pOptions->tiledTier);
+                return S_OK;
+            }
+
+            return E_INVALIDARG;
+        }
+    };
+
+    struct ID3D11Device1 : ID3D11Device {};
+    struct ID3D11Device2 : ID3D11Device1 {};
+    struct ID3D11Device3 : ID3D11Device2 {};
+
+    struct ID3D12Device
+    {
+        const CAPFLOPTIONS* pOptions;
+
+        HRESULT CheckFeatureSupport(D3D12_FEATURE feature, void* pData, UINT cbData)
+        {
+            if (feature != D3D12_FEATURE_D3D12_OPTIONS || cbData != sizeof(D3D12_FEATURE_DATA_D3D12_OPTIONS))
+                return E_INVALIDARG;
+
+            auto pOpts = static_cast<D3D12_FEATURE_DATA_D3D12_OPTIONS*>(pData);
+            pOpts->OutputMergerLogicOp = pOptions->logicOps;
+            pOpts->TiledResourcesTier = static_cast<D3D12_TILED_RESOURCES_TIER>(pOptions->tiledTier);
+            pOpts->ResourceBindingTier = static_cast<D3D12_RESOURCE_BINDING_TIER>(pOptions->bindingTier);
+            pOpts->PSSpecifiedStencilRefSupported = pOptions->psStencilRef;
+            pOpts->ConservativeRasterizationTier = static_cast<D3D12_CONSERVATIVE_RASTERIZATION_TIER>(pOptions->conservativeTier);
+            pOpts->ROVsSupported = pOptions->rovs;
+            return S_OK;
+        }
+    };
+
+    const char c_szYes[] = "Yes";
+    const char c_szNo[] = "No";
+    const char c_szNA[] = "n/a";
+    const char c_szOptYes[] = "Optional (Yes)";
+    const char c_szOptNo[] = "Optional (No)";
+
+    const char* FL_NOTE = "This feature summary is derived from hardware feature level";
+
+    //-----------------------------------------------------------------------------
+    // The probes, as dxgi.cpp makes them of a real device
+    //-----------------------------------------------------------------------------
+    D3D_SHADER_MODEL GetD3D12ShaderModel(ID3D12Device* device)
+    {
+        // A Direct3D 11.3 device at a 12_x level got here with no device and
+        // crashed; see ExpectChanges
+        if (!device)
+            return D3D_SHADER_MODEL_5_1;
+
+        uint32_t shaderModel = device->pOptions->shaderModel;
+        return (shaderModel >= D3D_SHADER_MODEL_6_0 && shaderModel <= D3D_SHADER_MODEL_6_7)
+            ? static_cast<D3D_SHADER_MODEL>(shaderModel) : D3D_SHADER_MODEL_5_1;
+    }
+
+    const char* D3D12DXRSupported(ID3D12Device* device)
+    {
+        switch (device->pOptions->raytracingTier)
+        {
+        case D3D12_RAYTRACING_TIER_NOT_SUPPORTED: break;
+        case D3D12_RAYTRACING_TIER_1_0: return "Optional (Yes - Tier 1.0)";
+        case D3D12_RAYTRACING_TIER_1_1: return "Optional (Yes - Tier 1.1)";
+        default: return c_szOptYes;
+        }
+
+        return c_szOptNo;
+    }
+
+    const char* D3D12VRSSupported(ID3D12Device* device)
+    {
+        switch (device->pOptions->vrsTier)
+        {
+        case D3D12_VARIABLE_SHADING_RATE_TIER_NOT_SUPPORTED: break;
+        case D3D12_VARIABLE_SHADING_RATE_TIER_1: return "Optional (Yes - Tier 1)";
+        case D3D12_VARIABLE_SHADING_RATE_TIER_2: return "Optional (Yes - Teir 2)";
+        default: return c_szOptYes;
+        }
+
+        return c_szOptNo;
+    }
+
+    bool IsD3D12MeshShaderSupported(ID3D12Device* device)
+    {
+        return device->pOptions->meshShaders;
+    }
+
+    void CheckExtendedFormats(ID3D10Device* pDevice, BOOL& ext, BOOL& x2)
+    {
+        ext = pDevice->pOptions->extFormats;
+        x2 = pDevice->pOptions->x2Format;
+    }
+
+    void CheckExtendedFormats(ID3D11Device* pDevice, BOOL& ext, BOOL& x2, BOOL& bpp565)
+    {
+        ext = pDevice->pOptions->extFormats;
+        x2 = pDevice->pOptions->x2Format;
+        bpp565 = pDevice->pOptions->bpp565;
+    }
+
+    void CheckD3D11Ops(ID3D11Device* pDevice, bool& logicOps, bool& cbPartial, bool& cbOffsetting)
+    {
+        logicOps = pDevice->pOptions->logicOps;
+        cbPartial = pDevice->pOptions->cbPartial;
+        cbOffsetting = pDevice->pOptions->cbOffsetting;
+    }
+
+    void CheckD3D11Ops1(ID3D11Device* pDevice, D3D11_TILED_RESOURCES_TIER& tiled, bool& minmaxfilter, bool& mapdefaultbuff)
+    {
+        tiled = static_cast<D3D11_TILED_RESOURCES_TIER>(pDevice->pOptions->tiledTier);
+        minmaxfilter = pDevice->pOptions->minMaxFilter;
+        mapdefaultbuff = pDevice->pOptions->mapDefaultBuffers;
+    }
+
+    void CheckD3D11Ops2(ID3D11Device* pDevice, D3D11_TILED_RESOURCES_TIER& tiled, D3D11_CONSERVATIVE_RASTERIZATION_TIER& crast,
+        bool& rovs, bool& pssref)
+    {
+        crast = static_cast<D3D11_CONSERVATIVE_RASTERIZATION_TIER>(pDevice->pOptions->conservativeTier);
+        tiled = static_cast<D3D11_TILED_RESOURCES_TIER>(pDevice->pOptions->tiledTier);
+        rovs = pDevice->pOptions->rovs;
+        pssref = pDevice->pOptions->psStencilRef;
+    }
+
+    void CheckD3D9Ops(ID3D11Device* pDevice, bool& nonpow2, bool& shadows)
+    {
+        nonpow2 = pDevice->pOptions->nonPow2;
+        shadows = pDevice->pOptions->shadows;
+    }
+
+    void CheckD3D9Ops1(ID3D11Device* pDevice, bool& nonpow2, bool& shadows, bool& instancing, bool& cubemapRT)
+    {
+        nonpow2 = pDevice->pOptions->nonPow2;
+        shadows = pDevice->pOptions->shadows;
+        instancing = pDevice->pOptions->instancing;
+        cubemapRT = pDevice->pOptions->cubeRT;
+    }
+
+    //-----------------------------------------------------------------------------
+    // The list view and printer, which collect what they're given
+    //-----------------------------------------------------------------------------
+    const unsigned long IDM_VIEWAVAIL = 1;
+    const unsigned long IDM_VIEWALL = 2;
+
+    unsigned long g_dwViewState = IDM_VIEWAVAIL;
+    void* g_DXGIFactory1 = nullptr;
+    HWND g_hwndLV = nullptr;
+
+    struct PRINTCBINFO
+    {
+        int unused;
+    };
+
+    struct SHOWNLINES
+    {
+        const char*     strNames[CAPFL_MAX_LINES];
+        const char*     strValues[CAPFL_MAX_LINES];
+        size_t          count;
+        bool            bOverflow;
+
+        void Add(const char* strName, const char* strValue)
+        {
+            // The note isn't part of the summary
+            if (strValue == FL_NOTE)
+                return;
+
+            if (count >= CAPFL_MAX_LINES)
+            {
+                bOverflow = true;
+                return;
+            }
+
+            strNames[count] = strName;
+            strValues[count] = strValue;
+            ++count;
+        }
+    };
+
+    SHOWNLINES* g_pShown = nullptr;
+    const char* g_strColumn0 = nullptr;
+
+    void LVAddColumn(HWND, int, const char*, int) {}
+
+    void LVAddText(HWND, int iColumn, const char* strText)
+    {
+        if (iColumn == 0)
+        {
+            g_strColumn0 = strText;
+        }
+        else
+        {
+            g_pShown->Add(g_strColumn0, strText);
+        }
+    }
+
+    void PrintStringValueLine(const char* strName, const char* strValue, PRINTCBINFO*)
+    {
+        g_pShown->Add(strName, strValue);
+    }
+
+#define LVYESNO(a,b) \
+        if ( g_dwViewState == IDM_VIEWALL || (b) ) \
+        { \
+            LVAddText( g_hwndLV, 0, a ); \
+            LVAddText( g_hwndLV, 1, (b) ? c_szYes : c_szNo ); \
+        }
+
+#define PRINTYESNO(a,b) \
+        PrintStringValueLine( a, (b) ? c_szYes : c_szNo, pPrintInfo );
+
+#define LVLINE(a,b) \
+        if ( g_dwViewState == IDM_VIEWALL || (b != c_szNA && b != c_szNo) ) \
+        { \
+            LVAddText( g_hwndLV, 0, a ); \
+            LVAddText( g_hwndLV, 1, b ); \
+        }
+
+#define PRINTLINE(a,b) \
+        if ( g_dwViewState == IDM_VIEWALL || (b != c_szNA && b != c_szNo) ) \
+        { \
+            PrintStringValueLine( a, b, pPrintInfo ); \
+        }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: D3D_FeatureLevel()
+    // Desc: As it was in dxgi.cpp
+    //-----------------------------------------------------------------------------
+    HRESULT D3D_FeatureLevel(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
+    {
+        auto fl = static_cast<D3D_FEATURE_LEVEL>(lParam1);
+        if (lParam2 == 0)
+            return S_OK;
+
+        ID3D10Device* pD3D10 = nullptr;
+        ID3D10Device1* pD3D10_1 = nullptr;
+        ID3D11Device* pD3D11 = nullptr;
+        ID3D11Device1* pD3D11_1 = nullptr;
+        ID3D11Device2* pD3D11_2 = nullptr;
+        ID3D11Device3* pD3D11_3 = nullptr;
+        ID3D12Device* pD3D12 = nullptr;
+
+        auto d3dVer = static_cast<unsigned int>(lParam3 & 0xff);
+        auto d3dType = static_cast<D3D_DRIVER_TYPE>((lParam3 & 0xff00) >> 8);
+
+        if (d3dVer == 10)
+        {
+            pD3D12 = reinterpret_cast<ID3D12Device*>(lParam2);
+        }
+        else if (d3dVer == 5)
+        {
+            pD3D11_3 = reinterpret_cast<ID3D11Device3*>(lParam2);
+        }
+        else
+        {
+            if (fl > D3D_FEATURE_LEVEL_11_1)
+                fl = D3D_FEATURE_LEVEL_11_1;
+
+            if (d3dVer == 4)
+            {
+                pD3D11_2 = reinterpret_cast<ID3D11Device2*>(lParam2);
+            }
+            else if (d3dVer == 3)
+            {
+                pD3D11_1 = reinterpret_cast<ID3D11Device1*>(lParam2);
+            }
+            else
+            {
+                if (fl > D3D_FEATURE_LEVEL_11_0)
+                    fl = D3D_FEATURE_LEVEL_11_0;
+
+                if (d3dVer == 2)
+                {
+                    pD3D11 = reinterpret_cast<ID3D11Device*>(lParam2);
+                }
+                else
+                {
+                    if (fl > D3D_FEATURE_LEVEL_10_1)
+                        fl = D3D_FEATURE_LEVEL_10_1;
+
+                    if (d3dVer == 1)
+                    {
+                        pD3D10_1 = reinterpret_cast<ID3D10Device1*>(lParam2);
+                    }
+                    else
+                    {
+                        if (fl > D3D_FEATURE_LEVEL_10_0)
+                            fl = D3D_FEATURE_LEVEL_10_0;
+
+                        pD3D10 = reinterpret_cast<ID3D10Device*>(lParam2);
+                    }
+                }
+            }
+        }
+
+        if (!pPrintInfo)
+        {
+            LVAddColumn(g_hwndLV, 0, "Name", 30);
+            LVAddColumn(g_hwndLV, 1, "Value", 60);
+        }
+
+        const char* shaderModel = nullptr;
+        const char* computeShader = c_szNo;
+        const char* maxTexDim = nullptr;
+        const char* maxCubeDim = nullptr;
+        const char* maxVolDim = nullptr;
+        const char* maxTexRepeat = nullptr;
+        const char* maxAnisotropy = nullptr;
+        const char* maxPrimCount = "4294967296";
+        const char* maxInputSlots = nullptr;
+        const char* mrt = nullptr;
+        const char* extFormats = nullptr;
+        const char* x2_10BitFormat = nullptr;
+        const char* logic_ops = c_szNo;
+        const char* cb_partial = c_szNA;
+        const char* cb_offsetting = c_szNA;
+        const char* uavSlots = nullptr;
+        const char* uavEveryStage = nullptr;
+        const char* uavOnlyRender = nullptr;
+        const char* nonpow2 = nullptr;
+        const char* bpp16 = c_szNo;
+        const char* shadows = nullptr;
+        const char* cubeRT = nullptr;
+        const char* tiled_rsc = nullptr;
+        const char* binding_rsc = nullptr;
+        const char* minmaxfilter = nullptr;
+        const char* mapdefaultbuff = nullptr;
+        const char* consrv_rast = nullptr;
+        const char* rast_ordered_views = nullptr;
+        const char* ps_stencil_ref = nullptr;
+        const char* instancing = nullptr;
+        const char* vrs = nullptr;
+        const char* meshShaders = nullptr;
+        const char* dxr = nullptr;
+
+        BOOL _10level9 = FALSE;
+
+        switch (fl)
+        {
+        case D3D_FEATURE_LEVEL_12_2:
+            if (pD3D12)
+            {
+                switch (GetD3D12ShaderModel(pD3D12))
+                {
+                case D3D_SHADER_MODEL_6_7:
+                    shaderModel = "6.7 (Optional)";
+                    computeShader = "Yes (CS 6.7)";
+                    break;
+                case D3D_SHADER_MODEL_6_6:
+                    shaderModel = "6.6 (Optional)";
+                    computeShader = "Yes (CS 6.6)";
+                    break;
+                default:
+                    shaderModel = "6.5";
+                    computeShader = "Yes (CS 6.5)";
+                    break;
+                }
+                vrs = "Yes - Tier 2";
+                meshShaders = c_szYes;
+                dxr = "Yes - Tier 1.1";
+            }
+            // Fall-through
+
+        case D3D_FEATURE_LEVEL_12_1:
+        case D3D_FEATURE_LEVEL_12_0:
+            if (!shaderModel)
+            {
+                switch (GetD3D12ShaderModel(pD3D12))
+                {
+                case D3D_SHADER_MODEL_6_7:
+                    shaderModel = "6.7 (Optional)";
+                    computeShader = "Yes (CS 6.7)";
+                    break;
+                case D3D_SHADER_MODEL_6_6:
+                    shaderModel = "6.6 (Optional)";
+                    computeShader = "Yes (CS 6.6)";
+                    break;
+                case D3D_SHADER_MODEL_6_5:
+                    shaderModel = "6.5 (Optional)";
+                    computeShader = "Yes (CS 6.5)";
+                    break;
+                case D3D_SHADER_MODEL_6_4:
+                    shaderModel = "6.4 (Optional)";
+                    computeShader = "Yes (CS 6.4)";
+                    break;
+                case D3D_SHADER_MODEL_6_3:
+                    shaderModel = "6.3 (Optional)";
+                    computeShader = "Yes (CS 6.3)";
+                    break;
+                case D3D_SHADER_MODEL_6_2:
+                    shaderModel = "6.2 (Optional)";
+                    computeShader = "Yes (CS 6.2)";
+                    break;
+                case D3D_SHADER_MODEL_6_1:
+                    shaderModel = "6.1 (Optional)";
+                    computeShader = "Yes (CS 6.1)";
+                    break;
+                case D3D_SHADER_MODEL_6_0:
+                    shaderModel = "6.0 (Optional)";
+                    computeShader = "Yes (CS 6.0)";
+                    break;
+                default:
+                    shaderModel = "5.1";
+                    computeShader = "Yes (CS 5.1)";
+                    break;
+                }
+            }
+            extFormats = c_szYes;
+            x2_10BitFormat = c_szYes;
+            logic_ops = c_szYes;
+            cb_partial = c_szYes;
+            cb_offsetting = c_szYes;
+            uavEveryStage = c_szYes;
+            uavOnlyRender = "16";
+            nonpow2 = "Full";
+            bpp16 = c_szYes;
+            instancing = c_szYes;
+
+            if (pD3D12)
+            {
+                maxTexDim = XTOSTRING(D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION);
+                maxCubeDim = XTOSTRING(D3D12_REQ_TEXTURECUBE_DIMENSION);
+                maxVolDim = XTOSTRING(D3D12_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
+                maxTexRepeat = XTOSTRING(D3D12_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION);
+                maxAnisotropy = XTOSTRING(D3D12_REQ_MAXANISOTROPY);
+                maxInputSlots = XTOSTRING(D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+                mrt = XTOSTRING(D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT);
+                uavSlots = XTOSTRING(D3D12_UAV_SLOT_COUNT);
+
+                D3D12_FEATURE_DATA_D3D12_OPTIONS d3d12opts = {};
+                HRESULT hr = pD3D12->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &d3d12opts, sizeof(D3D12_FEATURE_DATA_D3D12_OPTIONS));
+                if (FAILED(hr))
+                    memset(&d3d12opts, 0, sizeof(d3d12opts));
+
+                switch (d3d12opts.TiledResourcesTier)
+                {
+                    // 12.0 & 12.1 should be T2 or greater, 12.2 is T3 or greater
+                case D3D12_TILED_RESOURCES_TIER_2:  tiled_rsc = "Yes - Tier 2"; break;
+                case D3D12_TILED_RESOURCES_TIER_3:  tiled_rsc = "Yes - Tier 3"; break;
+                case D3D12_TILED_RESOURCES_TIER_4:  tiled_rsc = "Yes - Tier 4"; break;
+                default:                            tiled_rsc = c_szYes;        break;
+                }
+
+                switch (d3d12opts.ResourceBindingTier)
+                {
+                    // 12.0 & 12.1 should be T2 or greater, 12.2 is T3 or greater
+                case D3D12_RESOURCE_BINDING_TIER_2: binding_rsc = "Yes - Tier 2"; break;
+                case D3D12_RESOURCE_BINDING_TIER_3: binding_rsc = "Yes - Tier 3"; break;
+                default:                            binding_rsc = c_szYes;        break;
+                }
+
+                if (fl >= D3D_FEATURE_LEVEL_12_1)
+                {
+                    switch (d3d12opts.ConservativeRasterizationTier)
+                    {
+                        // 12.1 requires T1, 12.2 requires T3
+                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_1:   consrv_rast = "Yes - Tier 1";  break;
+                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_2:   consrv_rast = "Yes - Tier 2";  break;
+                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_3:   consrv_rast = "Yes - Tier 3";  break;
+                    default:                                        consrv_rast = c_szYes;         break;
+                    }
+
+                    rast_ordered_views = c_szYes;
+                }
+                else
+                {
+                    switch (d3d12opts.ConservativeRasterizationTier)
+                    {
+                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_NOT_SUPPORTED:   consrv_rast = c_szOptNo; break;
+                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_1:               consrv_rast = "Optional (Yes - Tier 1)";  break;
+                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_2:               consrv_rast = "Optional (Yes - Tier 2)";  break;
+                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_3:               consrv_rast = "Optional (Yes - Tier 3)";  break;
+                    default:                                                    consrv_rast = c_szOptYes; break;
+                    }
+
+                    rast_ordered_views = (d3d12opts.ROVsSupported) ? c_szOptYes : c_szOptNo;
+                }
+
+                ps_stencil_ref = (d3d12opts.PSSpecifiedStencilRefSupported) ? c_szOptYes : c_szOptNo;
+                minmaxfilter = c_szYes;
+                mapdefaultbuff = c_szYes;
+            }
+            else if (pD3D11_3)
+            {
+                maxTexDim = XTOSTRING(D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION);
+                maxCubeDim = XTOSTRING(D3D11_REQ_TEXTURECUBE_DIMENSION);
+                maxVolDim = XTOSTRING(D3D11_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
+                maxTexRepeat = XTOSTRING(D3D11_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION);
+                maxAnisotropy = XTOSTRING(D3D11_REQ_MAXANISOTROPY);
+                maxInputSlots = XTOSTRING(D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+                mrt = XTOSTRING(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT);
+                uavSlots = XTOSTRING(D3D11_1_UAV_SLOT_COUNT);
+
+                D3D11_TILED_RESOURCES_TIER tiled = D3D11_TILED_RESOURCES_NOT_SUPPORTED;
+                bool bMinMaxFilter, bMapDefaultBuff;
+                CheckD3D11Ops1(pD3D11_3, tiled, bMinMaxFilter, bMapDefaultBuff);
+
+                D3D11_CONSERVATIVE_RASTERIZATION_TIER crast = D3D11_CONSERVATIVE_RASTERIZATION_NOT_SUPPORTED;
+                bool rovs, pssref;
+                CheckD3D11Ops2(pD3D11_3, tiled, crast, rovs, pssref);
+
+                switch (tiled)
+                {
+                    // 12.0 & 12.1 should be T2 or greater, 12.2 is T3 or greater
+                case D3D11_TILED_RESOURCES_TIER_2:          tiled_rsc = "Yes - Tier 2";  break;
+                case D3D11_TILED_RESOURCES_TIER_3:          tiled_rsc = "Yes - Tier 3";  break;
+                default:                                    tiled_rsc = c_szYes;         break;
+                }
+
+                if (fl >= D3D_FEATURE_LEVEL_12_1)
+                {
+                    switch (crast)
+                    {
+                        // 12.1 requires T1
+                    case D3D11_CONSERVATIVE_RASTERIZATION_TIER_1:           consrv_rast = "Yes - Tier 1";  break;
+                    case D3D11_CONSERVATIVE_RASTERIZATION_TIER_2:           consrv_rast = "Yes - Tier 2";  break;
+                    case D3D11_CONSERVATIVE_RASTERIZATION_TIER_3:           consrv_rast = "Yes - Tier 3";  break;
+                    default:                                                consrv_rast = c_szYes;         break;
+                    }
+
+                    rast_ordered_views = c_szYes;
+                }
+                else
+                {
+                    switch (crast)
+                    {
+                    case D3D11_CONSERVATIVE_RASTERIZATION_NOT_SUPPORTED:    consrv_rast = c_szOptNo; break;
+                    case D3D11_CONSERVATIVE_RASTERIZATION_TIER_1:           consrv_rast = "Optional (Yes - Tier 1)";  break;
+                    case D3D11_CONSERVATIVE_RASTERIZATION_TIER_2:           consrv_rast = "Optional (Yes - Tier 2)";  break;
+                    case D3D11_CONSERVATIVE_RASTERIZATION_TIER_3:           consrv_rast = "Optional (Yes - Tier 3)";  break;
+                    default:                                                consrv_rast = c_szOptYes; break;
+                    }
+
+                    rast_ordered_views = (rovs) ? c_szOptYes : c_szOptNo;
+                }
+
+                ps_stencil_ref = (pssref) ? c_szOptYes : c_szOptNo;
+                minmaxfilter = c_szYes;
+                mapdefaultbuff = c_szYes;
+            }
+            break;
+
+        case D3D_FEATURE_LEVEL_11_1:
+            shaderModel = "5.0";
+            computeShader = "Yes (CS 5.0)";
+            maxTexDim = XTOSTRING(D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION);
+            maxCubeDim = XTOSTRING(D3D11_REQ_TEXTURECUBE_DIMENSION);
+            maxVolDim = XTOSTRING(D3D11_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
+            maxTexRepeat = XTOSTRING(D3D11_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION);
+            maxAnisotropy = XTOSTRING(D3D11_REQ_MAXANISOTROPY);
+            maxInputSlots = XTOSTRING(D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+            mrt = XTOSTRING(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT);
+            extFormats = c_szYes;
+            x2_10BitFormat = c_szYes;
+            logic_ops = c_szYes;
+            cb_partial = c_szYes;
+            cb_offsetting = c_szYes;
+            uavSlots = XTOSTRING(D3D11_1_UAV_SLOT_COUNT);
+            uavEveryStage = c_szYes;
+            uavOnlyRender = "16";
+            nonpow2 = "Full";
+            bpp16 = c_szYes;
+            instancing = c_szYes;
+
+            if (pD3D12)
+            {
+                shaderModel = "5.1";
+                computeShader = "Yes (CS 5.1)";
+
+                D3D12_FEATURE_DATA_D3D12_OPTIONS d3d12opts = {};
+                HRESULT hr = pD3D12->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &d3d12opts, sizeof(D3D12_FEATURE_DATA_D3D12_OPTIONS));
+                if (FAILED(hr))
+                    memset(&d3d12opts, 0, sizeof(d3d12opts));
+
+                switch (d3d12opts.TiledResourcesTier)
+                {
+                case D3D12_TILED_RESOURCES_TIER_NOT_SUPPORTED:  tiled_rsc = c_szOptNo; break;
+                case D3D12_TILED_RESOURCES_TIER_1:              tiled_rsc = "Optional (Yes - Tier 1)";  break;
+                case D3D12_TILED_RESOURCES_TIER_2:              tiled_rsc = "Optional (Yes - Tier 2)";  break;
+                case D3D12_TILED_RESOURCES_TIER_3:              tiled_rsc = "Optional (Yes - Tier 3)";  break;
+                case D3D12_TILED_RESOURCES_TIER_4:              tiled_rsc = "Optional (Yes - Tier 4)";  break;
+                default:                                        tiled_rsc = c_szOptYes; break;
+                }
+
+                switch (d3d12opts.ResourceBindingTier)
+                {
+                case D3D12_RESOURCE_BINDING_TIER_1: binding_rsc = "Yes - Tier 1"; break;
+                case D3D12_RESOURCE_BINDING_TIER_2: binding_rsc = "Yes - Tier 2"; break;
+                case D3D12_RESOURCE_BINDING_TIER_3: binding_rsc = "Yes - Tier 3"; break;
+                default:                            binding_rsc = c_szYes;        break;
+                }
+
+                switch (d3d12opts.ConservativeRasterizationTier)
+                {
+                case D3D12_CONSERVATIVE_RASTERIZATION_TIER_NOT_SUPPORTED:   consrv_rast = c_szOptNo; break;
+                case D3D12_CONSERVATIVE_RASTERIZATION_TIER_1:               consrv_rast = "Optional (Yes - Tier 1)";  break;
+                case D3D12_CONSERVATIVE_RASTERIZATION_TIER_2:               consrv_rast = "Optional (Yes - Tier 2)";  break;
+                case D3D12_CONSERVATIVE_RASTERIZATION_TIER_3:               consrv_rast = "Optional (Yes - Tier 3)";  break;
+                default:                                                    consrv_rast = c_szOptYes; break;
+                }
+
+                rast_ordered_views = (d3d12opts.ROVsSupported) ? c_szOptYes : c_szOptNo;
+                ps_stencil_ref = (d3d12opts.PSSpecifiedStencilRefSupported) ? c_szOptYes : c_szOptNo;
+                minmaxfilter = c_szYes;
+                mapdefaultbuff = c_szYes;
+            }
+            else if (pD3D11_3)
+            {
+                D3D11_TILED_RESOURCES_TIER tiled = D3D11_TILED_RESOURCES_NOT_SUPPORTED;
+                bool bMinMaxFilter, bMapDefaultBuff;
+                CheckD3D11Ops1(pD3D11_3, tiled, bMinMaxFilter, bMapDefaultBuff);
+
+                D3D11_CONSERVATIVE_RASTERIZATION_TIER crast = D3D11_CONSERVATIVE_RASTERIZATION_NOT_SUPPORTED;
+                bool rovs, pssref;
+                CheckD3D11Ops2(pD3D11_3, tiled, crast, rovs, pssref);
+
+                switch (tiled)
+                {
+                case D3D11_TILED_RESOURCES_NOT_SUPPORTED:   tiled_rsc = c_szOptNo; break;
+                case D3D11_TILED_RESOURCES_TIER_1:          tiled_rsc = "Optional (Yes - Tier 1)";  break;
+                case D3D11_TILED_RESOURCES_TIER_2:          tiled_rsc = "Optional (Yes - Tier 2)";  break;
+                case D3D11_TILED_RESOURCES_TIER_3:          tiled_rsc = "Optional (Yes - Tier 3)";  break;
+                default:                                    tiled_rsc = c_szOptYes; break;
+                }
+
+                switch (crast)
+                {
+                case D3D11_CONSERVATIVE_RASTERIZATION_NOT_SUPPORTED:    consrv_rast = c_szOptNo; break;
+                case D3D11_CONSERVATIVE_RASTERIZATION_TIER_1:           consrv_rast = "Optional (Yes - Tier 1)";  break;
+                case D3D11_CONSERVATIVE_RASTERIZATION_TIER_2:           consrv_rast = "Optional (Yes - Tier 2)";  break;
+                case D3D11_CONSERVATIVE_RASTERIZATION_TIER_3:           consrv_rast = "Optional (Yes - Tier 3)";  break;
+                default:                                                consrv_rast = c_szOptYes; break;
+                }
+
+                rast_ordered_views = (rovs) ? c_szOptYes : c_szOptNo;
+                ps_stencil_ref = (pssref) ? c_szOptYes : c_szOptNo;
+                minmaxfilter = bMinMaxFilter ? c_szOptYes : c_szOptNo;
+                mapdefaultbuff = bMapDefaultBuff ? c_szOptYes : c_szOptNo;
+            }
+            else if (pD3D11_2)
+            {
+                D3D11_TILED_RESOURCES_TIER tiled = D3D11_TILED_RESOURCES_NOT_SUPPORTED;
+                bool bMinMaxFilter, bMapDefaultBuff;
+                CheckD3D11Ops1(pD3D11_2, tiled, bMinMaxFilter, bMapDefaultBuff);
+
+                switch (tiled)
+                {
+                case D3D11_TILED_RESOURCES_NOT_SUPPORTED:   tiled_rsc = c_szOptNo; break;
+                case D3D11_TILED_RESOURCES_TIER_1:          tiled_rsc = "Optional (Yes - Tier 1)";  break;
+                case D3D11_TILED_RESOURCES_TIER_2:          tiled_rsc = "Optional (Yes - Tier 2)";  break;
+                default:                                    tiled_rsc = c_szOptYes; break;
+                }
+
+                minmaxfilter = bMinMaxFilter ? c_szOptYes : c_szOptNo;
+                mapdefaultbuff = bMapDefaultBuff ? c_szOptYes : c_szOptNo;
+            }
+            break;
+
+        case D3D_FEATURE_LEVEL_11_0:
+            shaderModel = "5.0";
+            computeShader = "Yes (CS 5.0)";
+            maxTexDim = XTOSTRING(D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION);
+            maxCubeDim = XTOSTRING(D3D11_REQ_TEXTURECUBE_DIMENSION);
+            maxVolDim = XTOSTRING(D3D11_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
+            maxTexRepeat = XTOSTRING(D3D11_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION);
+            maxAnisotropy = XTOSTRING(D3D11_REQ_MAXANISOTROPY);
+            maxInputSlots = XTOSTRING(D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+            mrt = XTOSTRING(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT);
+            extFormats = c_szYes;
+            x2_10BitFormat = c_szYes;
+            instancing = c_szYes;
+
+            if (pD3D12)
+            {
+                shaderModel = "5.1";
+                computeShader = "Yes (CS 5.1)";
+
+                D3D12_FEATURE_DATA_D3D12_OPTIONS d3d12opts = {};
+                HRESULT hr = pD3D12->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &d3d12opts, sizeof(D3D12_FEATURE_DATA_D3D12_OPTIONS));
+                if (FAILED(hr))
+                    memset(&d3d12opts, 0, sizeof(d3d12opts));
+
+                switch (d3d12opts.TiledResourcesTier)
+                {
+                case D3D12_TILED_RESOURCES_TIER_NOT_SUPPORTED:  tiled_rsc = c_szOptNo; break;
+                case D3D12_TILED_RESOURCES_TIER_1:              tiled_rsc = "Optional (Yes - Tier 1)";  break;
+                case D3D12_TILED_RESOURCES_TIER_2:              tiled_rsc = "Optional (Yes - Tier 2)";  break;
+                case D3D12_TILED_RESOURCES_TIER_3:              tiled_rsc = "Optional (Yes - Tier 3)";  break;
+                case D3D12_TILED_RESOURCES_TIER_4:              tiled_rsc = "Optional (Yes - Tier 4)";  break;
+                default:                                        tiled_rsc = c_szOptYes; break;
+                }
+
+                switch (d3d12opts.ResourceBindingTier)
+                {
+                case D3D12_RESOURCE_BINDING_TIER_1: binding_rsc = "Yes - Tier 1"; break;
+                case D3D12_RESOURCE_BINDING_TIER_2: binding_rsc = "Yes - Tier 2"; break;
+                case D3D12_RESOURCE_BINDING_TIER_3: binding_rsc = "Yes - Tier 3"; break;
+                default:                            binding_rsc = c_szYes;        break;
+                }
+
+                logic_ops = d3d12opts.OutputMergerLogicOp ? c_szOptYes : c_szOptNo;
+                consrv_rast = rast_ordered_views = ps_stencil_ref = minmaxfilter = c_szNo;
+                mapdefaultbuff = c_szYes;
+
+                uavSlots = "8";
+                uavEveryStage = c_szNo;
+                uavOnlyRender = "8";
+                nonpow2 = "Full";
+            }
+            else if (pD3D11_3)
+            {
+                D3D11_TILED_RESOURCES_TIER tiled = D3D11_TILED_RESOURCES_NOT_SUPPORTED;
+                bool bMinMaxFilter, bMapDefaultBuff;
+                CheckD3D11Ops1(pD3D11_3, tiled, bMinMaxFilter, bMapDefaultBuff);
+
+                D3D11_FEATURE_DATA_D3D11_OPTIONS2 d3d11opts2 = {};
+                HRESULT hr = pD3D11_3->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS2, &d3d11opts2, sizeof(d3d11opts2));
+                if (SUCCEEDED(hr))
+                {
+                    // D3D11_FEATURE_DATA_D3D11_OPTIONS1 caps this at Tier 2
+                    tiled = d3d11opts2.TiledResourcesTier;
+                }
+
+                switch (tiled)
+                {
+                case D3D11_TILED_RESOURCES_NOT_SUPPORTED:   tiled_rsc = c_szOptNo; break;
+                case D3D11_TILED_RESOURCES_TIER_1:          tiled_rsc = "Optional (Yes - Tier 1)";  break;
+                case D3D11_TILED_RESOURCES_TIER_2:          tiled_rsc = "Optional (Yes - Tier 2)";  break;
+                case D3D11_TILED_RESOURCES_TIER_3:          tiled_rsc = "Optional (Yes - Tier 3)";  break;
+                default:                                    tiled_rsc = c_szOptYes; break;
+                }
+
+                consrv_rast = rast_ordered_views = ps_stencil_ref = minmaxfilter = c_szNo;
+                mapdefaultbuff = bMapDefaultBuff ? c_szOptYes : c_szOptNo;
+            }
+            else if (pD3D11_2)
+            {
+                D3D11_TILED_RESOURCES_TIER tiled = D3D11_TILED_RESOURCES_NOT_SUPPORTED;
+                bool bMinMaxFilter, bMapDefaultBuff;
+                CheckD3D11Ops1(pD3D11_2, tiled, bMinMaxFilter, bMapDefaultBuff);
+
+                switch (tiled)
+                {
+                case D3D11_TILED_RESOURCES_NOT_SUPPORTED:   tiled_rsc = c_szOptNo; break;
+                case D3D11_TILED_RESOURCES_TIER_1:          tiled_rsc = "Optional (Yes - Tier 1)";  break;
+                case D3D11_TILED_RESOURCES_TIER_2:          tiled_rsc = "Optional (Yes - Tier 2)";  break;
+                default:                                    tiled_rsc = c_szOptYes; break;
+                }
+
+                minmaxfilter = c_szNo;
+                mapdefaultbuff = bMapDefaultBuff ? c_szOptYes : c_szOptNo;
+            }
+
+            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
+            {
+                ID3D11Device* pD3D = (pD3D11_3) ? pD3D11_3 : ((pD3D11_2) ? pD3D11_2 : pD3D11_1);
+
+                bool bLogicOps, bCBpartial, bCBoffsetting;
+                CheckD3D11Ops(pD3D, bLogicOps, bCBpartial, bCBoffsetting);
+                logic_ops = bLogicOps ? c_szOptYes : c_szOptNo;
+                cb_partial = bCBpartial ? c_szOptYes : c_szOptNo;
+                cb_offsetting = bCBoffsetting ? c_szOptYes : c_szOptNo;
+
+                BOOL ext, x2, bpp565;
+                CheckExtendedFormats(pD3D, ext, x2, bpp565);
+                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+
+                uavSlots = "8";
+                uavEveryStage = c_szNo;
+                uavOnlyRender = "8";
+                nonpow2 = "Full";
+            }
+            break;
+
+        case D3D_FEATURE_LEVEL_10_1:
+            shaderModel = "4.x";
+            instancing = c_szYes;
+
+            if (pD3D11_3)
+            {
+                consrv_rast = rast_ordered_views = ps_stencil_ref = c_szNo;
+            }
+
+            if (pD3D11_2 || pD3D11_3)
+            {
+                tiled_rsc = minmaxfilter = mapdefaultbuff = c_szNo;
+            }
+
+            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
+            {
+                ID3D11Device* pD3D = (pD3D11_3) ? pD3D11_3 : ((pD3D11_2) ? pD3D11_2 : pD3D11_1);
+
+                D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS d3d10xhw = {};
+                HRESULT hr = pD3D->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &d3d10xhw, sizeof(d3d10xhw));
+                if (FAILED(hr))
+                    memset(&d3d10xhw, 0, sizeof(d3d10xhw));
+
+                if (d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x)
+                {
+                    computeShader = "Optional (Yes - CS 4.x)";
+                    uavSlots = "1";
+                    uavEveryStage = c_szNo;
+                    uavOnlyRender = c_szNo;
+                }
+                else
+                {
+                    computeShader = c_szOptNo;
+                }
+
+                bool bLogicOps, bCBpartial, bCBoffsetting;
+                CheckD3D11Ops(pD3D, bLogicOps, bCBpartial, bCBoffsetting);
+                logic_ops = bLogicOps ? c_szOptYes : c_szOptNo;
+                cb_partial = bCBpartial ? c_szOptYes : c_szOptNo;
+                cb_offsetting = bCBoffsetting ? c_szOptYes : c_szOptNo;
+
+                BOOL ext, x2, bpp565;
+                CheckExtendedFormats(pD3D, ext, x2, bpp565);
+
+                extFormats = (ext) ? c_szOptYes : c_szOptNo;
+                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
+                nonpow2 = "Full";
+                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+            }
+            else if (pD3D11)
+            {
+                D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS d3d10xhw = {};
+                HRESULT hr = pD3D11->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &d3d10xhw, sizeof(d3d10xhw));
+                if (FAILED(hr))
+                    memset(&d3d10xhw, 0, sizeof(d3d10xhw));
+
+                computeShader = (d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x) ? "Optional (Yes - CS 4.x)" : c_szOptNo;
+
+                BOOL ext, x2, bpp565;
+                CheckExtendedFormats(pD3D11, ext, x2, bpp565);
+
+                extFormats = (ext) ? c_szOptYes : c_szOptNo;
+                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
+            }
+            else if (pD3D10_1)
+            {
+                BOOL ext, x2;
+                CheckExtendedFormats(pD3D10_1, ext, x2);
+
+                extFormats = (ext) ? c_szOptYes : c_szOptNo;
+                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
+            }
+            else if (pD3D10)
+            {
+                BOOL ext, x2;
+                CheckExtendedFormats(pD3D10, ext, x2);
+
+                extFormats = (ext) ? c_szOptYes : c_szOptNo;
+                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
+            }
+
+            maxTexDim = XTOSTRING(D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION);
+            maxCubeDim = XTOSTRING(D3D10_REQ_TEXTURECUBE_DIMENSION);
+            maxVolDim = XTOSTRING(D3D10_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
+            maxTexRepeat = XTOSTRING(D3D10_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION);
+            maxAnisotropy = XTOSTRING(D3D10_REQ_MAXANISOTROPY);
+            maxInputSlots = XTOSTRING(D3D10_1_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+            mrt = XTOSTRING(D3D10_SIMULTANEOUS_RENDER_TARGET_COUNT);
+            break;
+
+        case D3D_FEATURE_LEVEL_10_0:
+            shaderModel = "4.0";
+            instancing = c_szYes;
+
+            if (pD3D11_3)
+            {
+                consrv_rast = rast_ordered_views = ps_stencil_ref = c_szNo;
+            }
+
+            if (pD3D11_2 || pD3D11_3)
+            {
+                tiled_rsc = minmaxfilter = mapdefaultbuff = c_szNo;
+            }
+
+            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
+            {
+                ID3D11Device* pD3D = (pD3D11_3) ? pD3D11_3 : ((pD3D11_2) ? pD3D11_2 : pD3D11_1);
+
+                D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS d3d10xhw = {};
+                HRESULT hr = pD3D->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &d3d10xhw, sizeof(d3d10xhw));
+                if (FAILED(hr))
+                    memset(&d3d10xhw, 0, sizeof(d3d10xhw));
+
+                if (d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x)
+                {
+                    computeShader = "Optional (Yes - CS 4.x)";
+                    uavSlots = "1";
+                    uavEveryStage = c_szNo;
+                    uavOnlyRender = c_szNo;
+                }
+                else
+                {
+                    computeShader = c_szOptNo;
+                }
+
+                bool bLogicOps, bCBpartial, bCBoffsetting;
+                CheckD3D11Ops(pD3D, bLogicOps, bCBpartial, bCBoffsetting);
+                logic_ops = bLogicOps ? c_szOptYes : c_szOptNo;
+                cb_partial = bCBpartial ? c_szOptYes : c_szOptNo;
+                cb_offsetting = bCBoffsetting ? c_szOptYes : c_szOptNo;
+
+                BOOL ext, x2, bpp565;
+                CheckExtendedFormats(pD3D, ext, x2, bpp565);
+
+                extFormats = (ext) ? c_szOptYes : c_szOptNo;
+                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
+                nonpow2 = "Full";
+                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+            }
+            else if (pD3D11)
+            {
+                D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS d3d10xhw = {};
+                HRESULT hr = pD3D11->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &d3d10xhw, sizeof(d3d10xhw));
+                if (FAILED(hr))
+                    memset(&d3d10xhw, 0, sizeof(d3d10xhw));
+
+                computeShader = (d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x) ? "Optional (Yes - CS 4.0)" : c_szOptNo;
+
+                BOOL ext, x2, bpp565;
+                CheckExtendedFormats(pD3D11, ext, x2, bpp565);
+
+                extFormats = (ext) ? c_szOptYes : c_szOptNo;
+                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
+            }
+            else if (pD3D10_1)
+            {
+                BOOL ext, x2;
+                CheckExtendedFormats(pD3D10_1, ext, x2);
+
+                extFormats = (ext) ? c_szOptYes : c_szOptNo;
+                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
+            }
+            else if (pD3D10)
+            {
+                BOOL ext, x2;
+                CheckExtendedFormats(pD3D10, ext, x2);
+
+                extFormats = (ext) ? c_szOptYes : c_szOptNo;
+                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
+            }
+
+            maxTexDim = XTOSTRING(D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION);
+            maxCubeDim = XTOSTRING(D3D10_REQ_TEXTURECUBE_DIMENSION);
+            maxVolDim = XTOSTRING(D3D10_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
+            maxTexRepeat = XTOSTRING(D3D10_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION);
+            maxAnisotropy = XTOSTRING(D3D10_REQ_MAXANISOTROPY);
+            maxInputSlots = XTOSTRING(D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+            mrt = XTOSTRING(D3D10_SIMULTANEOUS_RENDER_TARGET_COUNT);
+            break;
+
+        case D3D_FEATURE_LEVEL_9_3:
+            _10level9 = TRUE;
+            shaderModel = "2.0 (4_0_level_9_3) [vs_2_a/ps_2_b]";
+            computeShader = c_szNA;
+            maxTexDim = XTOSTRING2(D3D_FL9_3_REQ_TEXTURE2D_U_OR_V_DIMENSION);
+            maxCubeDim = XTOSTRING2(D3D_FL9_3_REQ_TEXTURECUBE_DIMENSION);
+            maxVolDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
+            maxTexRepeat = XTOSTRING2(D3D_FL9_3_MAX_TEXTURE_REPEAT);
+            maxAnisotropy = XTOSTRING(D3D11_REQ_MAXANISOTROPY);
+            maxPrimCount = XTOSTRING2(D3D_FL9_2_IA_PRIMITIVE_MAX_COUNT);
+            maxInputSlots = XTOSTRING(D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+            mrt = XTOSTRING2(D3D_FL9_3_SIMULTANEOUS_RENDER_TARGET_COUNT);
+            extFormats = c_szYes;
+            instancing = c_szYes;
+
+            if (pD3D11_2 || pD3D11_3)
+            {
+                ID3D11Device* pD3D = (pD3D11_3) ? pD3D11_3 : pD3D11_2;
+
+                cb_partial = c_szYes;
+                cb_offsetting = c_szYes;
+
+                BOOL ext, x2, bpp565;
+                CheckExtendedFormats(pD3D, ext, x2, bpp565);
+
+                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+
+                bool bNonPow2, bShadows, bInstancing, bCubeRT;
+                CheckD3D9Ops1(pD3D, bNonPow2, bShadows, bInstancing, bCubeRT);
+                nonpow2 = bNonPow2 ? "Optional (Full)" : "Conditional";
+                shadows = bShadows ? c_szOptYes : c_szOptNo;
+                cubeRT = bCubeRT ? c_szOptYes : c_szOptNo;
+            }
+            else if (pD3D11_1)
+            {
+                cb_partial = c_szYes;
+                cb_offsetting = c_szYes;
+
+                BOOL ext, x2, bpp565;
+                CheckExtendedFormats(pD3D11_1, ext, x2, bpp565);
+
+                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+
+                bool bNonPow2, bShadows;
+                CheckD3D9Ops(pD3D11_1, bNonPow2, bShadows);
+                nonpow2 = bNonPow2 ? "Optional (Full)" : "Conditional";
+                shadows = bShadows ? c_szOptYes : c_szOptNo;
+            }
+            break;
+
+        case D3D_FEATURE_LEVEL_9_2:
+            _10level9 = TRUE;
+            shaderModel = "2.0 (4_0_level_9_1)";
+            computeShader = c_szNA;
+            maxTexDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURE2D_U_OR_V_DIMENSION);
+            maxCubeDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURECUBE_DIMENSION);
+            maxVolDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
+            maxTexRepeat = XTOSTRING2(D3D_FL9_2_MAX_TEXTURE_REPEAT);
+            maxAnisotropy = XTOSTRING(D3D11_REQ_MAXANISOTROPY);
+            maxPrimCount = XTOSTRING2(D3D_FL9_2_IA_PRIMITIVE_MAX_COUNT);
+            maxInputSlots = XTOSTRING(D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+            mrt = XTOSTRING2(D3D_FL9_1_SIMULTANEOUS_RENDER_TARGET_COUNT);
+            extFormats = c_szYes;
+            instancing = c_szNo;
+
+            if (pD3D11_2 || pD3D11_3)
+            {
+                ID3D11Device* pD3D = (pD3D11_3) ? pD3D11_3 : pD3D11_2;
+
+                cb_partial = c_szYes;
+                cb_offsetting = c_szYes;
+
+                BOOL ext, x2, bpp565;
+                CheckExtendedFormats(pD3D, ext, x2, bpp565);
+
+                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+
+                bool bNonPow2, bShadows, bInstancing, bCubeRT;
+                CheckD3D9Ops1(pD3D, bNonPow2, bShadows, bInstancing, bCubeRT);
+                nonpow2 = bNonPow2 ? "Optional (Full)" : "Conditional";
+                shadows = bShadows ? c_szOptYes : c_szOptNo;
+                instancing = bInstancing ? "Optional (Simple)" : c_szOptNo;
+                cubeRT = bCubeRT ? c_szOptYes : c_szOptNo;
+            }
+            else if (pD3D11_1)
+            {
+                cb_partial = c_szYes;
+                cb_offsetting = c_szYes;
+
+                BOOL ext, x2, bpp565;
+                CheckExtendedFormats(pD3D11_1, ext, x2, bpp565);
+
+                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+
+                bool bNonPow2, bShadows;
+                CheckD3D9Ops(pD3D11_1, bNonPow2, bShadows);
+                nonpow2 = bNonPow2 ? "Optional (Full)" : "Conditional";
+                shadows = bShadows ? c_szOptYes : c_szOptNo;
+            }
+            break;
+
+        case D3D_FEATURE_LEVEL_9_1:
+            _10level9 = TRUE;
+            shaderModel = "2.0 (4_0_level_9_1)";
+            computeShader = c_szNA;
+            maxTexDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURE2D_U_OR_V_DIMENSION);
+            maxCubeDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURECUBE_DIMENSION);
+            maxVolDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
+            maxTexRepeat = XTOSTRING2(D3D_FL9_1_MAX_TEXTURE_REPEAT);
+            maxAnisotropy = XTOSTRING2(D3D_FL9_1_DEFAULT_MAX_ANISOTROPY);
+            maxPrimCount = XTOSTRING2(D3D_FL9_1_IA_PRIMITIVE_MAX_COUNT);
+            maxInputSlots = XTOSTRING(D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+            mrt = XTOSTRING2(D3D_FL9_1_SIMULTANEOUS_RENDER_TARGET_COUNT);
+            extFormats = c_szYes;
+            instancing = c_szNo;
+
+            if (pD3D11_2 || pD3D11_3)
+            {
+                ID3D11Device* pD3D = (pD3D11_3) ? pD3D11_3 : pD3D11_2;
+
+                cb_partial = c_szYes;
+                cb_offsetting = c_szYes;
+
+                BOOL ext, x2, bpp565;
+                CheckExtendedFormats(pD3D, ext, x2, bpp565);
+
+                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+
+                bool bNonPow2, bShadows, bInstancing, bCubeRT;
+                CheckD3D9Ops1(pD3D, bNonPow2, bShadows, bInstancing, bCubeRT);
+                nonpow2 = bNonPow2 ? "Optional (Full)" : "Conditional";
+                shadows = bShadows ? c_szOptYes : c_szOptNo;
+                instancing = bInstancing ? "Optional (Simple)" : c_szOptNo;
+                cubeRT = bCubeRT ? c_szOptYes : c_szOptNo;
+            }
+            else if (pD3D11_1)
+            {
+                cb_partial = c_szYes;
+                cb_offsetting = c_szYes;
+
+                BOOL ext, x2, bpp565;
+                CheckExtendedFormats(pD3D11_1, ext, x2, bpp565);
+
+                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+
+                bool bNonPow2, bShadows;
+                CheckD3D9Ops(pD3D11_1, bNonPow2, bShadows);
+                nonpow2 = bNonPow2 ? "Optional (Full)" : "Conditional";
+                shadows = bShadows ? c_szOptYes : c_szOptNo;
+            }
+            break;
+
+        default:
+            return E_FAIL;
+        }
+
+        if (d3dType == D3D_DRIVER_TYPE_WARP)
+        {
+            maxTexDim = (pD3D12 || pD3D11_3 || pD3D11_2 || pD3D11_1) ? "16777216" : "65536";
+        }
+
+        if (pD3D12)
+        {
+            if (!vrs)
+            {
+                vrs = D3D12VRSSupported(pD3D12);
+            }
+
+            if (!meshShaders)
+            {
+                meshShaders = IsD3D12MeshShaderSupported(pD3D12) ? c_szOptYes : c_szOptNo;
+            }
+
+            if (!dxr)
+            {
+                dxr = D3D12DXRSupported(pD3D12);
+            }
+        }
+
+        if (!pPrintInfo)
+        {
+            LVLINE("Shader Model", shaderModel);
+            LVYESNO("Geometry Shader", (fl >= D3D_FEATURE_LEVEL_10_0));
+            LVYESNO("Stream Out", (fl >= D3D_FEATURE_LEVEL_10_0));
+
+            if (pD3D12 || pD3D11_3 || pD3D11_2 || pD3D11_1 || pD3D11)
+            {
+                if (g_dwViewState == IDM_VIEWALL || computeShader != c_szNo)
+                {
+                    LVLINE("DirectCompute", computeShader);
+                }
+
+                LVYESNO("Hull & Domain Shaders", (fl >= D3D_FEATURE_LEVEL_11_0));
+            }
+
+            if (pD3D12)
+            {
+                LVLINE("Variable Rate Shading (VRS)", vrs);
+                LVLINE("Mesh & Amplification Shaders", meshShaders);
+                LVLINE("DirectX Raytracing", dxr);
+            }
+
+            LVYESNO("Texture Resource Arrays", (fl >= D3D_FEATURE_LEVEL_10_0));
+
+            if (d3dVer != 0)
+            {
+                LVYESNO("Cubemap Resource Arrays", (fl >= D3D_FEATURE_LEVEL_10_1));
+            }
+
+            LVYESNO("BC4/BC5 Compression", (fl >= D3D_FEATURE_LEVEL_10_0));
+
+            if (pD3D12 || pD3D11_3 || pD3D11_2 || pD3D11_1 || pD3D11)
+            {
+                LVYESNO("BC6H/BC7 Compression", (fl >= D3D_FEATURE_LEVEL_11_0));
+            }
+
+            LVYESNO("Alpha-to-coverage", (fl >= D3D_FEATURE_LEVEL_10_0));
+
+            if (pD3D11_1 || pD3D11_2 || pD3D11_3 || pD3D12)
+            {
+                LVLINE("Logic Ops (Output Merger)", logic_ops);
+            }
+
+            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
+            {
+                LVLINE("Constant Buffer Partial Updates", cb_partial);
+                LVLINE("Constant Buffer Offsetting", cb_offsetting);
+
+                if (uavEveryStage)
+                {
+                    LVLINE("UAVs at Every Stage", uavEveryStage);
+                }
+
+                if (uavOnlyRender)
+                {
+                    LVLINE("UAV-only rendering", uavOnlyRender);
+                }
+            }
+
+            if (pD3D11_2 || pD3D11_3 || pD3D12)
+            {
+                if (tiled_rsc)
+                {
+                    LVLINE("Tiled Resources", tiled_rsc);
+                }
+            }
+
+            if (pD3D11_2 || pD3D11_3)
+            {
+                if (minmaxfilter)
+                {
+                    LVLINE("Min/Max Filtering", minmaxfilter);
+                }
+
+                if (mapdefaultbuff)
+                {
+                    LVLINE("Map DEFAULT Buffers", mapdefaultbuff);
+                }
+            }
+
+            if (pD3D11_3 || pD3D12)
+            {
+                if (consrv_rast)
+                {
+                    LVLINE("Conservative Rasterization", consrv_rast);
+                }
+
+                if (ps_stencil_ref)
+                {
+                    LVLINE("PS-Specified Stencil Ref", ps_stencil_ref);
+                }
+
+                if (rast_ordered_views)
+                {
+                    LVLINE("Rasterizer Ordered Views", rast_ordered_views);
+                }
+            }
+
+            if (pD3D12 && binding_rsc)
+            {
+                LVLINE("Resource Binding", binding_rsc);
+            }
+
+            if (g_DXGIFactory1 && !pD3D12)
+            {
+                LVLINE("Extended Formats (BGRA, etc.)", extFormats);
+
+                if (x2_10BitFormat && (g_dwViewState == IDM_VIEWALL || x2_10BitFormat != c_szNo))
+                {
+                    LVLINE("10-bit XR High Color Format", x2_10BitFormat);
+                }
+            }
+
+            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
+            {
+                LVLINE("16-bit Formats (565/5551/4444)", bpp16);
+            }
+
+            if (nonpow2 && !pD3D12)
+            {
+                LVLINE("Non-Power-of-2 Textures", nonpow2);
+            }
+
+            LVLINE("Max Texture Dimension", maxTexDim);
+            LVLINE("Max Cubemap Dimension", maxCubeDim);
+
+            if (maxVolDim)
+            {
+                LVLINE("Max Volume Extent", maxVolDim);
+            }
+
+            if (maxTexRepeat)
+            {
+                LVLINE("Max Texture Repeat", maxTexRepeat);
+            }
+
+            LVLINE("Max Input Slots", maxInputSlots);
+
+            if (uavSlots)
+            {
+                LVLINE("UAV Slots", uavSlots);
+            }
+
+            if (maxAnisotropy)
+            {
+                LVLINE("Max Anisotropy", maxAnisotropy);
+            }
+
+            LVLINE("Max Primitive Count", maxPrimCount);
+
+            if (mrt)
+            {
+                LVLINE("Simultaneous Render Targets", mrt);
+            }
+
+            if (_10level9)
+            {
+                LVYESNO("Occlusion Queries", (fl >= D3D_FEATURE_LEVEL_9_2));
+                LVYESNO("Separate Alpha Blend", (fl >= D3D_FEATURE_LEVEL_9_2));
+                LVYESNO("Mirror Once", (fl >= D3D_FEATURE_LEVEL_9_2));
+                LVYESNO("Overlapping Vertex Elements", (fl >= D3D_FEATURE_LEVEL_9_2));
+                LVYESNO("Independant Write Masks", (fl >= D3D_FEATURE_LEVEL_9_3));
+
+                LVLINE("Instancing", instancing);
+
+                if (pD3D11_1 || pD3D11_2 || pD3D11_3)
+                {
+                    LVLINE("Shadow Support", shadows);
+                }
+
+                if (pD3D11_2 || pD3D11_3)
+                {
+                    LVLINE("Cubemap Render w/ non-Cube Depth", cubeRT);
+                }
+            }
+
+            LVLINE("Note", FL_NOTE);
+        }
+        else
+        {
+            PRINTLINE("Shader Model", shaderModel);
+            PRINTYESNO("Geometry Shader", (fl >= D3D_FEATURE_LEVEL_10_0));
+            PRINTYESNO("Stream Out", (fl >= D3D_FEATURE_LEVEL_10_0));
+
+            if (pD3D12 || pD3D11_3 || pD3D11_2 || pD3D11_1 || pD3D11)
+            {
+                PRINTLINE("DirectCompute", computeShader);
+                PRINTYESNO("Hull & Domain Shaders", (fl >= D3D_FEATURE_LEVEL_11_0));
+            }
+
+            if (pD3D12)
+            {
+                PRINTLINE("Variable Rate Shading (VRS)", vrs);
+                PRINTLINE("Mesh & Amplification Shaders", meshShaders);
+                PRINTLINE("DirectX Raytracing", dxr);
+            }
+
+            PRINTYESNO("Texture Resource Arrays", (fl >= D3D_FEATURE_LEVEL_10_0));
+
+            if (d3dVer != 0)
+            {
+                PRINTYESNO("Cubemap Resource Arrays", (fl >= D3D_FEATURE_LEVEL_10_1));
+            }
+
+            PRINTYESNO("BC4/BC5 Compression", (fl >= D3D_FEATURE_LEVEL_10_0));
+
+            if (pD3D11_3 || pD3D11_2 || pD3D11_1 || pD3D11)
+            {
+                PRINTYESNO("BC6H/BC7 Compression", (fl >= D3D_FEATURE_LEVEL_11_0));
+            }
+
+            PRINTYESNO("Alpha-to-coverage", (fl >= D3D_FEATURE_LEVEL_10_0));
+
+            if (pD3D11_1 || pD3D11_2 || pD3D11_3 || pD3D12)
+            {
+                PRINTLINE("Logic Ops (Output Merger)", logic_ops);
+            }
+
+            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
+            {
+                PRINTLINE("Constant Buffer Partial Updates", cb_partial);
+                PRINTLINE("Constant Buffer Offsetting", cb_offsetting);
+
+                if (uavEveryStage)
+                {
+                    PRINTLINE("UAVs at Every Stage", uavEveryStage);
+                }
+
+                if (uavOnlyRender)
+                {
+                    PRINTLINE("UAV-only rendering", uavOnlyRender);
+                }
+            }
+
+            if (pD3D11_2 || pD3D11_3 || pD3D12)
+            {
+                if (tiled_rsc)
+                {
+                    PRINTLINE("Tiled Resources", tiled_rsc);
+                }
+            }
+
+            if (pD3D11_2 || pD3D11_3)
+            {
+                if (minmaxfilter)
+                {
+                    PRINTLINE("Min/Max Filtering", minmaxfilter);
+                }
+
+                if (mapdefaultbuff)
+                {
+                    PRINTLINE("Map DEFAULT Buffers", mapdefaultbuff);
+                }
+            }
+
+            if (pD3D11_3 || pD3D12)
+            {
+                if (consrv_rast)
+                {
+                    PRINTLINE("Conservative Rasterization", consrv_rast);
+                }
+
+                if (ps_stencil_ref)
+                {
+                    PRINTLINE("PS-Specified Stencil Ref ", ps_stencil_ref);
+                }
+
+                if (rast_ordered_views)
+                {
+                    PRINTLINE("Rasterizer Ordered Views", rast_ordered_views);
+                }
+            }
+
+            if (pD3D12 && binding_rsc)
+            {
+                PRINTLINE("Resource Binding", binding_rsc);
+            }
+
+            if (g_DXGIFactory1 && !pD3D12)
+            {
+                PRINTLINE("Extended Formats (BGRA, etc.)", extFormats);
+
+                if (x2_10BitFormat)
+                {
+                    PRINTLINE("10-bit XR High Color Format", x2_10BitFormat);
+                }
+            }
+
+            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
+            {
+                PRINTLINE("16-bit Formats (565/5551/4444)", bpp16);
+            }
+
+            if (nonpow2)
+            {
+                PRINTLINE("Non-Power-of-2 Textures", nonpow2);
+            }
+
+            PRINTLINE("Max Texture Dimension", maxTexDim);
+            PRINTLINE("Max Cubemap Dimension", maxCubeDim);
+
+            if (maxVolDim)
+            {
+                PRINTLINE("Max Volume Extent", maxVolDim);
+            }
+
+            if (maxTexRepeat)
+            {
+                PRINTLINE("Max Texture Repeat", maxTexRepeat);
+            }
+
+            PRINTLINE("Max Input Slots", maxInputSlots);
+
+            if (uavSlots)
+            {
+                PRINTLINE("UAV Slots", uavSlots);
+            }
+
+            if (maxAnisotropy)
+            {
+                PRINTLINE("Max Anisotropy", maxAnisotropy);
+            }
+
+            PRINTLINE("Max Primitive Count", maxPrimCount);
+
+            if (mrt)
+            {
+                PRINTLINE("Simultaneous Render Targets", mrt);
+            }
+
+            if (_10level9)
+            {
+                PRINTYESNO("Occlusion Queries", (fl >= D3D_FEATURE_LEVEL_9_2));
+                PRINTYESNO("Separate Alpha Blend", (fl >= D3D_FEATURE_LEVEL_9_2));
+                PRINTYESNO("Mirror Once", (fl >= D3D_FEATURE_LEVEL_9_2));
+                PRINTYESNO("Overlapping Vertex Elements", (fl >= D3D_FEATURE_LEVEL_9_2));
+                PRINTYESNO("Independant Write Masks", (fl >= D3D_FEATURE_LEVEL_9_3));
+
+                PRINTLINE("Instancing", instancing);
+
+                if (pD3D11_1 || pD3D11_2 || pD3D11_3)
+                {
+                    PRINTLINE("Shadow Support", shadows);
+                }
+
+                if (pD3D11_2 || pD3D11_3)
+                {
+                    PRINTLINE("Cubemap Render w/ non-Cube Depth", cubeRT);
+                }
+            }
+
+            PRINTLINE("Note", FL_NOTE);
+        }
+
+        return S_OK;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // The options each interface reports, to be tried in every combination
+    //-----------------------------------------------------------------------------
+    struct OPTIONDIM
+    {
+        const char*     strName;
+        void            (*pfnSet)(CAPFLOPTIONS& options, uint32_t value);
+        uint32_t        count;
+    };
+
+#define OPTION_BOOL(member) { #member, [](CAPFLOPTIONS& options, uint32_t value) { options.member = (value != 0); }, 2 }
+#define OPTION_TIER(member, numTiers) { #member, [](CAPFLOPTIONS& options, uint32_t value) { options.member = value; }, numTiers }
+
+    const uint32_t c_shaderModels[] =
+    {
+        D3D_SHADER_MODEL_5_1, D3D_SHADER_MODEL_6_0, D3D_SHADER_MODEL_6_1, D3D_SHADER_MODEL_6_2, D3D_SHADER_MODEL_6_3,
+        D3D_SHADER_MODEL_6_4, D3D_SHADER_MODEL_6_5, D3D_SHADER_MODEL_6_6, D3D_SHADER_MODEL_6_7,
+    };
+    const uint32_t c_raytracingTiers[] = { D3D12_RAYTRACING_TIER_NOT_SUPPORTED, D3D12_RAYTRACING_TIER_1_0, D3D12_RAYTRACING_TIER_1_1 };
+
+    // CheckExtendedFormats
+    const OPTIONDIM c_optionsD3D10[] =
+    {
+        OPTION_BOOL(extFormats), OPTION_BOOL(x2Format),
+    };
+
+    // The D3D10_X_HARDWARE_OPTIONS and CheckExtendedFormats
+    const OPTIONDIM c_optionsD3D11[] =
+    {
+        OPTION_BOOL(computeShader4x), OPTION_BOOL(extFormats), OPTION_BOOL(x2Format), OPTION_BOOL(bpp565),
+    };
+
+    // CheckD3D11Ops and CheckD3D9Ops
+    const OPTIONDIM c_optionsD3D11_1[] =
+    {
+        OPTION_BOOL(computeShader4x), OPTION_BOOL(extFormats), OPTION_BOOL(x2Format), OPTION_BOOL(bpp565),
+        OPTION_BOOL(logicOps), OPTION_BOOL(cbPartial), OPTION_BOOL(cbOffsetting),
+        OPTION_BOOL(nonPow2), OPTION_BOOL(shadows),
+    };
+
+    // CheckD3D11Ops1 and CheckD3D9Ops1, where OPTIONS1 stops at tiled resources tier 2
+    const OPTIONDIM c_optionsD3D11_2[] =
+    {
+        OPTION_BOOL(computeShader4x), OPTION_BOOL(extFormats), OPTION_BOOL(x2Format), OPTION_BOOL(bpp565),
+        OPTION_BOOL(logicOps), OPTION_BOOL(cbPartial), OPTION_BOOL(cbOffsetting),
+        OPTION_BOOL(nonPow2), OPTION_BOOL(shadows), OPTION_BOOL(instancing), OPTION_BOOL(cubeRT),
+        OPTION_TIER(tiledTier, 3), OPTION_BOOL(minMaxFilter), OPTION_BOOL(mapDefaultBuffers),
+    };
+
+    // CheckD3D11Ops2
+    const OPTIONDIM c_optionsD3D11_3[] =
+    {
+        OPTION_BOOL(computeShader4x), OPTION_BOOL(extFormats), OPTION_BOOL(x2Format), OPTION_BOOL(bpp565),
+        OPTION_BOOL(logicOps), OPTION_BOOL(cbPartial), OPTION_BOOL(cbOffsetting),
+        OPTION_BOOL(nonPow2), OPTION_BOOL(shadows), OPTION_BOOL(instancing), OPTION_BOOL(cubeRT),
+        OPTION_TIER(tiledTier, 4), OPTION_BOOL(minMaxFilter), OPTION_BOOL(mapDefaultBuffers),
+        OPTION_TIER(conservativeTier, 4), OPTION_BOOL(rovs), OPTION_BOOL(psStencilRef),
+    };
+
+    // D3D12_OPTIONS, the shader model and the VRS, mesh shader and raytracing
+    // queries
+    const OPTIONDIM c_optionsD3D12[] =
+    {
+        { "shaderModel", [](CAPFLOPTIONS& options, uint32_t value) { options.shaderModel = c_shaderModels[value]; },
+            static_cast<uint32_t>(sizeof(c_shaderModels) / sizeof(c_shaderModels[0])) },
+        OPTION_TIER(tiledTier, 5), OPTION_TIER(bindingTier, 4), OPTION_TIER(conservativeTier, 4),
+        OPTION_BOOL(rovs), OPTION_BOOL(psStencilRef), OPTION_BOOL(logicOps),
+        OPTION_TIER(vrsTier, 3),
+        { "raytracingTier", [](CAPFLOPTIONS& options, uint32_t value) { options.raytracingTier = c_raytracingTiers[value]; }, 3 },
+        OPTION_BOOL(meshShaders),
+    };
+
+#undef OPTION_BOOL
+#undef OPTION_TIER
+
+    struct APITEST
+    {
+        CAPFLAPI            api;
+        const char*         strName;
+        const OPTIONDIM*    pDims;
+        size_t              numDims;
+    };
+
+#define APITEST_ENTRY(api, dims) { api, #api, dims, sizeof(dims) / sizeof(dims[0]) }
+
+    const APITEST c_apis[] =
+    {
+        APITEST_ENTRY(CAPFLAPI_D3D10, c_optionsD3D10),
+        APITEST_ENTRY(CAPFLAPI_D3D10_1, c_optionsD3D10),
+        APITEST_ENTRY(CAPFLAPI_D3D11, c_optionsD3D11),
+        APITEST_ENTRY(CAPFLAPI_D3D11_1, c_optionsD3D11_1),
+        APITEST_ENTRY(CAPFLAPI_D3D11_2, c_optionsD3D11_2),
+        APITEST_ENTRY(CAPFLAPI_D3D11_3, c_optionsD3D11_3),
+        APITEST_ENTRY(CAPFLAPI_D3D12, c_optionsD3D12),
+    };
+
+#undef APITEST_ENTRY
+
+    const uint32_t c_featureLevels[] =
+    {
+        CAPFL_9_1, CAPFL_9_2, CAPFL_9_3, CAPFL_10_0, CAPFL_10_1, CAPFL_11_0, CAPFL_11_1, CAPFL_12_0, CAPFL_12_1, CAPFL_12_2,
+    };
+
+
+    //-----------------------------------------------------------------------------
+    // Name: LegacyLines()
+    // Desc: What the old D3D_FeatureLevel showed
+    //-----------------------------------------------------------------------------
+    bool LegacyLines(uint32_t fl, CAPFLAPI api, uint32_t flags, const CAPFLOPTIONS& options, bool bViewAll, bool bPrint,
+        SHOWNLINES& shown)
+    {
+        ID3D10Device1 device10;
+        ID3D11Device3 device11;
+        ID3D12Device device12;
+        device10.pOptions = device11.pOptions = device12.pOptions = &options;
+
+        LPARAM lParam2 = (api == CAPFLAPI_D3D12) ? reinterpret_cast<LPARAM>(&device12)
+            : (api >= CAPFLAPI_D3D11) ? reinterpret_cast<LPARAM>(static_cast<ID3D11Device*>(&device11))
+            : reinterpret_cast<LPARAM>(static_cast<ID3D10Device*>(&device10));
+
+        D3D_DRIVER_TYPE d3dType = (flags & CAPFLF_WARP) ? D3D_DRIVER_TYPE_WARP : D3D_DRIVER_TYPE_HARDWARE;
+        LPARAM lParam3 = (static_cast<LPARAM>(d3dType) << 8) | static_cast<LPARAM>(api);
+
+        static int s_factory;
+        g_DXGIFactory1 = (flags & CAPFLF_DXGI1_1) ? &s_factory : nullptr;
+        g_dwViewState = bViewAll ? IDM_VIEWALL : IDM_VIEWAVAIL;
+
+        shown.count = 0;
+        shown.bOverflow = false;
+        g_pShown = &shown;
+
+        PRINTCBINFO printInfo = {};
+        HRESULT hr = D3D_FeatureLevel(static_cast<LPARAM>(fl), lParam2, lParam3, bPrint ? &printInfo : nullptr);
+        g_pShown = nullptr;
+        return SUCCEEDED(hr) && !shown.bOverflow;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: SummaryLines()
+    // Desc: What D3D_FeatureLevel shows of a summary from CapFeatureSummary now
+    //-----------------------------------------------------------------------------
+    bool SummaryLines(const CAPFLSUMMARY& summary, bool bViewAll, bool bPrint, SHOWNLINES& shown)
+    {
+        shown.count = 0;
+        shown.bOverflow = false;
+
+        for (size_t i = 0; i < summary.count; ++i)
+        {
+            const CAPFLLINE& line = summary.lines[i];
+            if (CapFLLineShown(line, bViewAll, bPrint))
+                shown.Add(line.strName, line.strValue);
+        }
+        return !shown.bOverflow;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Editing the old output into what's expected now
+    //-----------------------------------------------------------------------------
+    size_t FindLine(const SHOWNLINES& shown, const char* strName)
+    {
+        for (size_t i = 0; i < shown.count; ++i)
+        {
+            if (strcmp(shown.strNames[i], strName) == 0)
+                return i;
+        }
+        return shown.count;
+    }
+
+    void InsertLineAfter(SHOWNLINES& shown, const char* strAfter, const char* strName, const char* strValue)
+    {
+        size_t iLine = FindLine(shown, strAfter);
+        if (iLine == shown.count)
+            return;
+
+        if (shown.count >= CAPFL_MAX_LINES)
+        {
+            shown.bOverflow = true;
+            return;
+        }
+
+        for (size_t i = shown.count; i > iLine + 1; --i)
+        {
+            shown.strNames[i] = shown.strNames[i - 1];
+            shown.strValues[i] = shown.strValues[i - 1];
+        }
+        shown.strNames[iLine + 1] = strName;
+        shown.strValues[iLine + 1] = strValue;
+        ++shown.count;
+    }
+
+    void RemoveLine(SHOWNLINES& shown, const char* strName)
+    {
+        size_t iLine = FindLine(shown, strName);
+        if (iLine == shown.count)
+            return;
+
+        for (size_t i = iLine + 1; i < shown.count; ++i)
+        {
+            shown.strNames[i - 1] = shown.strNames[i];
+            shown.strValues[i - 1] = shown.strValues[i];
+        }
+        --shown.count;
+    }
+
+    void RenameLine(SHOWNLINES& shown, const char* strName, const char* strNewName)
+    {
+        size_t iLine = FindLine(shown, strName);
+        if (iLine != shown.count)
+            shown.strNames[iLine] = strNewName;
+    }
+
+    void ReplaceValue(SHOWNLINES& shown, const char* strName, const char* strValue, const char* strNewValue)
+    {
+        size_t iLine = FindLine(shown, strName);
+        if (iLine != shown.count && strcmp(shown.strValues[iLine], strValue) == 0)
+            shown.strValues[iLine] = strNewValue;
+    }
+
+    const char* RequiredTierText(uint32_t tier)
+    {
+        static const char* const s_strTiers[] = { c_szYes, "Yes - Tier 1", "Yes - Tier 2", "Yes - Tier 3", "Yes - Tier 4" };
+        return (tier < sizeof(s_strTiers) / sizeof(s_strTiers[0])) ? s_strTiers[tier] : c_szYes;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: ExpectChanges()
+    // Desc: Where the summaries are meant to differ from what the old code showed
+    //-----------------------------------------------------------------------------
+    void ExpectChanges(uint32_t fl, CAPFLAPI api, const CAPFLOPTIONS& options, bool bPrint, SHOWNLINES& expected)
+    {
+        // Printing no longer pads the name or leaves out BC6H/BC7 for D3D12, and
+        // stops printing the Non-Power-of-2 line the list view never had for it
+        if (bPrint)
+        {
+            RenameLine(expected, "PS-Specified Stencil Ref ", "PS-Specified Stencil Ref");
+            if (api == CAPFLAPI_D3D12)
+            {
+                InsertLineAfter(expected, "BC4/BC5 Compression", "BC6H/BC7 Compression", (fl >= CAPFL_11_0) ? c_szYes : c_szNo);
+                RemoveLine(expected, "Non-Power-of-2 Textures");
+            }
+        }
+
+        ReplaceValue(expected, "Variable Rate Shading (VRS)", "Optional (Yes - Teir 2)", "Optional (Yes - Tier 2)");
+
+        // Required features show the tier the device has rather than the least
+        // the feature level needs
+        if (fl >= CAPFL_12_0 && (api == CAPFLAPI_D3D12 || api == CAPFLAPI_D3D11_3))
+        {
+            ReplaceValue(expected, "Tiled Resources", c_szYes, RequiredTierText(options.tiledTier));
+            if (api == CAPFLAPI_D3D12)
+                ReplaceValue(expected, "Resource Binding", c_szYes, RequiredTierText(options.bindingTier));
+        }
+        if (fl >= CAPFL_12_2 && api == CAPFLAPI_D3D12)
+        {
+            ReplaceValue(expected, "Variable Rate Shading (VRS)", "Yes - Tier 2", RequiredTierText(options.vrsTier));
+            ReplaceValue(expected, "DirectX Raytracing", "Yes - Tier 1.1",
+                (options.raytracingTier == D3D12_RAYTRACING_TIER_1_0) ? "Yes - Tier 1.0"
+                : (options.raytracingTier == D3D12_RAYTRACING_TIER_1_1) ? "Yes - Tier 1.1" : c_szYes);
+        }
+
+        // D3D11.0 has UAV slots too
+        if (api == CAPFLAPI_D3D11)
+        {
+            if (fl >= CAPFL_11_0)
+                InsertLineAfter(expected, "Max Input Slots", "UAV Slots", "8");
+            else if (fl >= CAPFL_10_0 && options.computeShader4x)
+                InsertLineAfter(expected, "Max Input Slots", "UAV Slots", "1");
+        }
+
+        // CS 4.0 is all 10_0 has, as D3D11.0 already said
+        if (api >= CAPFLAPI_D3D11_1 && api <= CAPFLAPI_D3D11_3 && fl == CAPFL_10_0)
+            ReplaceValue(expected, "DirectCompute", "Optional (Yes - CS 4.x)", "Optional (Yes - CS 4.0)");
+
+        // A D3D11.3 device at 12_x isn't a D3D12 one, so it's 5.0 rather than
+        // the 5.1 the old code asked a D3D12 device it didn't have for
+        if (api == CAPFLAPI_D3D11_3 && fl >= CAPFL_12_0)
+        {
+            ReplaceValue(expected, "Shader Model", "5.1", "5.0");
+            ReplaceValue(expected, "DirectCompute", "Yes (CS 5.1)", "Yes (CS 5.0)");
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: SameLines()
+    //-----------------------------------------------------------------------------
+    bool SameLines(const SHOWNLINES& a, const SHOWNLINES& b)
+    {
+        if (a.count != b.count)
+            return false;
+
+        for (size_t i = 0; i < a.count; ++i)
+        {
+            if (strcmp(a.strNames[i], b.strNames[i]) != 0 || strcmp(a.strValues[i], b.strValues[i]) != 0)
+                return false;
+        }
+        return true;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    void PrintLines(const char* strTitle, const SHOWNLINES& shown)
+    {
+        printf("  %s:\n", strTitle);
+        for (size_t i = 0; i < shown.count; ++i)
+            printf("    %-36s %s\n", shown.strNames[i], shown.strValues[i]);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    void PrintCase(uint32_t fl, const APITEST& api, uint32_t flags, const CAPFLOPTIONS& options, bool bViewAll, bool bPrint)
+    {
+        printf("FL %x, %s, flags %u, %s, %s, options:", fl, api.strName, flags,
+            bViewAll ? "all" : "supported", bPrint ? "print" : "list view");
+
+        printf(" sm %x tiled %u binding %u crast %u vrs %u dxr %u",
+            options.shaderModel, options.tiledTier, options.bindingTier, options.conservativeTier, options.vrsTier, options.raytracingTier);
+        printf(" bools %d%d%d%d%d%d%d%d%d%d%d%d%d%d%d%d\n",
+            options.meshShaders, options.rovs, options.psStencilRef, options.logicOps, options.cbPartial, options.cbOffsetting,
+            options.minMaxFilter, options.mapDefaultBuffers, options.computeShader4x, options.extFormats, options.x2Format,
+            options.bpp565, options.nonPow2, options.shadows, options.instancing, options.cubeRT);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: NextOptions()
+    // Desc: Steps to the next combination of option values, false after the last
+    //-----------------------------------------------------------------------------
+    bool NextOptions(const APITEST& api, uint32_t* values)
+    {
+        for (size_t i = 0; i < api.numDims; ++i)
+        {
+            if (++values[i] < api.pDims[i].count)
+                return true;
+            values[i] = 0;
+        }
+        return false;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: TryOptions()
+    // Desc: Every tier is tried with every other, but since no line depends on
+    //       more than two of the Yes/No options, only the combinations with at
+    //       most two of those on or at most two off are
+    //-----------------------------------------------------------------------------
+    bool TryOptions(const APITEST& api, const uint32_t* values)
+    {
+        size_t numBools = 0;
+        size_t numOn = 0;
+        for (size_t i = 0; i < api.numDims; ++i)
+        {
+            if (api.pDims[i].count == 2)
+            {
+                ++numBools;
+                numOn += values[i];
+            }
+        }
+        return numOn <= 2 || numOn + 2 >= numBools;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: main()
+//-----------------------------------------------------------------------------
+int main()
+{
+    unsigned long long numCases = 0;
+    unsigned long long numFailed = 0;
+
+    for (const auto& api : c_apis)
+    {
+        uint32_t values[32] = {};
+        do
+        {
+            if (!TryOptions(api, values))
+                continue;
+
+            CAPFLOPTIONS options = {};
+            for (size_t i = 0; i < api.numDims; ++i)
+                api.pDims[i].pfnSet(options, values[i]);
+
+            for (uint32_t fl : c_featureLevels)
+            {
+                // The viewer only has D3D12 devices at 11_0 and up
+                if (api.api == CAPFLAPI_D3D12 && fl < CAPFL_11_0)
+                    continue;
+
+                for (uint32_t flags = 0; flags <= (CAPFLF_WARP | CAPFLF_DXGI1_1); ++flags)
+                {
+                    CAPFLSUMMARY summary;
+                    bool bSummary = CapFeatureSummary(fl, api.api, flags, options, summary);
+
+                    for (int iView = 0; iView < 4; ++iView)
+                    {
+                        bool bViewAll = (iView & 1) != 0;
+                        bool bPrint = (iView & 2) != 0;
+
+                        SHOWNLINES expected = {};
+                        SHOWNLINES actual = {};
+                        bool bExpected = LegacyLines(fl, api.api, flags, options, bViewAll, bPrint, expected);
+                        if (bExpected)
+                            ExpectChanges(fl, api.api, options, bPrint, expected);
+                        bool bActual = bSummary && SummaryLines(summary, bViewAll, bPrint, actual);
+
+                        ++numCases;
+                        if (bExpected != bActual || !SameLines(expected, actual))
+                        {
+                            if (++numFailed <= 10)
+                            {
+                                PrintCase(fl, api, flags, options, bViewAll, bPrint);
+                                PrintLines("expected", expected);
+                                PrintLines("actual", actual);
+                            }
+                        }
+                    }
+                }
+            }
+        } while (NextOptions(api, values));
+    }
+
+    printf("%llu summaries, %llu differ\n", numCases, numFailed);
+    return numFailed ? 1 : 0;
+}
@@ -0,0 +1,485 @@
+//-----------------------------------------------------------------------------
+// Name: dxfind.cpp
+//
+// Desc: DirectX Capabilities Viewer search box and -grep
+//
+//       The tree is copied into a snapshot on the UI thread, then indexed on
+//       the thread pool (see dxsearch.h). Once the index is ready every
+//       keystroke in the search box jumps to the first match at or after the
+//       current one without running any display callbacks.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxview.h"
+#include "dxdiff.h"
+#include "dxsearch.h"
+#include "dxtrace.h"
+
+#include <algorithm>
+
+extern HWND  g_hwndTV;
+extern HWND  g_hwndSearch;
+extern HFONT g_hFont;
+extern CHAR  g_strTitle[];
+
+VOID DXView_OnSearchChange();
+VOID DXView_FindNext( BOOL bBackward );
+VOID DXView_FreeSearch();
+
+namespace
+{
+    //-----------------------------------------------------------------------------
+    // Name: SEARCHTREE
+    // Desc: The tree as of when the index was built, and the TreeView item of
+    //       each of its nodes
+    //-----------------------------------------------------------------------------
+    struct SEARCHTREE
+    {
+        CAPSNAPSHOT             snapshot;
+        CAPSEARCHINDEX          index;
+        std::vector<HTREEITEM>  items;
+        UINT                    generation;     // Of g_searchGeneration when the build started
+    };
+
+    SEARCHTREE* g_pSearch = nullptr;            // Ready to query
+    SEARCHTREE* g_pSearchBuilding = nullptr;    // Being indexed on the thread pool
+    PTP_WORK    g_searchWork = nullptr;
+    UINT        g_searchGeneration = 0;         // Tells a stale WM_SEARCHREADY from the current one
+    std::vector<uint64_t> g_searchMatches;
+    uint32_t    g_searchEntry = 0;              // Last match jumped to
+
+    //-----------------------------------------------------------------------------
+    // Name: SearchSink
+    // Desc: Copies each node of the tree into a snapshot
+    //-----------------------------------------------------------------------------
+    struct SearchSink : public CAPSINK
+    {
+        CAPSNAPSHOT* pSnapshot;
+
+        HRESULT OnNode(LPCSTR strText, DWORD dwDepth, const CAPMODEL* pModel) override
+        {
+            CAPSNAPSHOTNODE node = { dwDepth, strText, nullptr };
+            if (pModel)
+            {
+                node.pModel = new (std::nothrow) CAPMODEL(*pModel);
+                if (!node.pModel)
+                    return E_OUTOFMEMORY;
+            }
+
+            pSnapshot->nodes.push_back(std::move(node));
+            return S_OK;
+        }
+    };
+
+
+    //-----------------------------------------------------------------------------
+    VOID CollectTreeItems(HWND hwndTV, HTREEITEM hItem, std::vector<HTREEITEM>& items)
+    {
+        for (; hItem; hItem = TreeView_GetNextSibling(hwndTV, hItem))
+        {
+            items.push_back(hItem);
+            CollectTreeItems(hwndTV, TreeView_GetChild(hwndTV, hItem), items);
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: CopyTree()
+    // Desc: Copies the whole tree, probing anything not yet expanded, along with
+    //       the TreeView item of each node unless hwndTV is nullptr
+    //-----------------------------------------------------------------------------
+    SEARCHTREE* CopyTree(HWND hwndTV)
+    {
+        auto pTree = new (std::nothrow) SEARCHTREE;
+        if (!pTree)
+            return nullptr;
+        pTree->generation = 0;
+
+        SearchSink sink;
+        sink.pSnapshot = &pTree->snapshot;
+        HRESULT hr = TVWalkModels(hwndTV, &sink);
+
+        // The walk expanded every node, so the TreeView now has them all in the same order
+        if (SUCCEEDED(hr) && hwndTV)
+        {
+            CollectTreeItems(hwndTV, TreeView_GetRoot(hwndTV), pTree->items);
+            if (pTree->items.size() != pTree->snapshot.nodes.size())
+                hr = E_FAIL;
+        }
+
+        if (FAILED(hr))
+        {
+            delete pTree;
+            return nullptr;
+        }
+
+        return pTree;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    VOID CALLBACK SearchIndexWorkCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID pContext, PTP_WORK /*work*/)
+    {
+        auto pTree = static_cast<SEARCHTREE*>(pContext);
+        pTree->index.Build(pTree->snapshot.nodes);
+
+        PostMessage(g_hwndMain, WM_SEARCHREADY, pTree->generation, 0);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    VOID WaitForSearchIndex()
+    {
+        if (g_searchWork)
+        {
+            WaitForThreadpoolWorkCallbacks(g_searchWork, FALSE);
+            CloseThreadpoolWork(g_searchWork);
+            g_searchWork = nullptr;
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: GetNodeEntry()
+    // Desc: The entry for a node's name, which comes before its rows
+    //-----------------------------------------------------------------------------
+    uint32_t GetNodeEntry(const CAPSEARCHINDEX& index, uint32_t node)
+    {
+        auto it = std::lower_bound(index.entries.begin(), index.entries.end(), node,
+            [](const CAPSEARCHENTRY& entry, uint32_t value) { return entry.node < value; });
+        return static_cast<uint32_t>(it - index.entries.begin());
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: GetSelectedEntry()
+    // Desc: The last match jumped to if it's still showing, otherwise the
+    //       selected node
+    //-----------------------------------------------------------------------------
+    uint32_t GetSelectedEntry()
+    {
+        const auto& entries = g_pSearch->index.entries;
+        HTREEITEM hSel = TreeView_GetSelection(g_hwndTV);
+        if (g_searchEntry < entries.size() && g_pSearch->items[entries[g_searchEntry].node] == hSel)
+            return g_searchEntry;
+
+        auto it = std::find(g_pSearch->items.begin(), g_pSearch->items.end(), hSel);
+        if (it == g_pSearch->items.end())
+            return 0;
+
+        return GetNodeEntry(g_pSearch->index, static_cast<uint32_t>(it - g_pSearch->items.begin()));
+    }
+
+
+    //-----------------------------------------------------------------------------
+    VOID ShowSearchCount(BOOL bSearching)
+    {
+        CHAR strTitle[128];
+        if (!bSearching)
+            strcpy_s(strTitle, g_strTitle);
+        else if (!g_pSearch)
+            sprintf_s(strTitle, "%s - Indexing...", g_strTitle);
+        else
+            sprintf_s(strTitle, "%s - %u matches", g_strTitle, CapSearchCount(g_searchMatches));
+
+        SetWindowText(g_hwndMain, strTitle);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: JumpToEntry()
+    // Desc: Selects the node of an entry, and the entry's row in the list view
+    //-----------------------------------------------------------------------------
+    VOID JumpToEntry(uint32_t entry)
+    {
+        g_searchEntry = entry;
+
+        const CAPSEARCHENTRY& match = g_pSearch->index.entries[entry];
+        HTREEITEM hItem = g_pSearch->items[match.node];
+        TreeView_SelectItem(g_hwndTV, hItem);
+        TreeView_EnsureVisible(g_hwndTV, hItem);
+
+        if (match.row == CAPSEARCH_NODE)
+            return;
+
+        // Rows with the same name, such as those of a repeated heading, are told
+        // apart by how many come before
+        const auto& rows = g_pSearch->snapshot.nodes[match.node].pModel->rows;
+        const char* strName = rows[match.row].Name();
+        UINT nth = 0;
+        for (uint32_t i = 0; i < match.row; ++i)
+        {
+            if (!strcmp(rows[i].Name(), strName))
+                ++nth;
+        }
+
+        (void)LVSelectRow(g_hwndLV, strName, nth);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    LRESULT CALLBACK SearchBoxProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam,
+        UINT_PTR /*uIdSubclass*/, DWORD_PTR /*dwRefData*/)
+    {
+        switch (msg)
+        {
+        case WM_KEYDOWN:
+            if (wParam == VK_RETURN || wParam == VK_F3)
+            {
+                DXView_FindNext(GetKeyState(VK_SHIFT) < 0);
+                return 0;
+            }
+            else if (wParam == VK_ESCAPE)
+            {
+                SetFocus(g_hwndTV);
+                return 0;
+            }
+            else if (wParam == VK_TAB)
+            {
+                SetFocus((GetKeyState(VK_SHIFT) < 0) ? g_hwndLV : g_hwndTV);
+                return 0;
+            }
+            break;
+
+        case WM_CHAR:
+            // Keep the edit control from beeping at these
+            if (wParam == '\r' || wParam == '\t' || wParam == VK_ESCAPE)
+                return 0;
+            break;
+
+        case WM_NCDESTROY:
+            RemoveWindowSubclass(hWnd, SearchBoxProc, 0);
+            break;
+        }
+
+        return DefSubclassProc(hWnd, msg, wParam, lParam);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_CreateSearchBox()
+// Desc: The edit control above the tree. Enter finds the next match,
+//       Shift+Enter the previous one and Esc goes back to the tree.
+//-----------------------------------------------------------------------------
+HWND DXView_CreateSearchBox(HWND hWnd)
+{
+    HWND hwndSearch = CreateWindowEx(WS_EX_CLIENTEDGE, WC_EDIT, "",
+        WS_VISIBLE | WS_CHILD | ES_AUTOHSCROLL,
+        0, 0, 0, 0, hWnd, (HMENU)IDC_SEARCH, g_hInstance, nullptr);
+    if (!hwndSearch)
+        return nullptr;
+
+    SendMessage(hwndSearch, WM_SETFONT, (WPARAM)g_hFont, FALSE);
+    SendMessage(hwndSearch, EM_SETCUEBANNER, FALSE, (LPARAM)L"Search (Enter for next)");
+    SetWindowSubclass(hwndSearch, SearchBoxProc, 0, 0);
+
+    return hwndSearch;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_BeginSearchIndex()
+// Desc: Copies the tree and starts indexing it on the thread pool, unless
+//       that's already done or under way. WM_SEARCHREADY comes once it's done.
+//-----------------------------------------------------------------------------
+VOID DXView_BeginSearchIndex()
+{
+    if (g_pSearch || g_pSearchBuilding)
+        return;
+
+    HCURSOR hOldCursor = SetCursor(LoadCursor(nullptr, IDC_WAIT));
+    g_pSearchBuilding = CopyTree(g_hwndTV);
+    SetCursor(hOldCursor);
+
+    if (!g_pSearchBuilding)
+        return;
+
+    g_pSearchBuilding->generation = ++g_searchGeneration;
+    g_searchWork = CreateThreadpoolWork(SearchIndexWorkCallback, g_pSearchBuilding, nullptr);
+    if (g_searchWork)
+    {
+        SubmitThreadpoolWork(g_searchWork);
+    }
+    else
+    {
+        // No thread pool work item available, so just index inline
+        SearchIndexWorkCallback(nullptr, g_pSearchBuilding, nullptr);
+    }
+
+    ShowSearchCount(GetWindowTextLength(g_hwndSearch) > 0);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_OnSearchReady()
+// Desc: Takes the index just built, then searches for whatever was typed
+//       while it was being built
+//-----------------------------------------------------------------------------
+VOID DXView_OnSearchReady(UINT generation)
+{
+    if (generation != g_searchGeneration || !g_pSearchBuilding)
+        return;
+
+    WaitForSearchIndex();
+
+    g_pSearch = g_pSearchBuilding;
+    g_pSearchBuilding = nullptr;
+    g_searchEntry = 0;
+
+    if (GetWindowTextLength(g_hwndSearch) > 0)
+        DXView_OnSearchChange();
+    else
+        ShowSearchCount(FALSE);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_OnSearchChange()
+// Desc: Jumps to the first match at or after the current one as the query
+//       is typed, so a longer query stays put while it still matches
+//-----------------------------------------------------------------------------
+VOID DXView_OnSearchChange()
+{
+    CHAR strQuery[256] = {};
+    GetWindowText(g_hwndSearch, strQuery, static_cast<int>(std::size(strQuery)));
+    if (!*strQuery)
+    {
+        g_searchMatches.clear();
+        ShowSearchCount(FALSE);
+        return;
+    }
+
+    if (!g_pSearch)
+    {
+        DXView_BeginSearchIndex();
+        return;
+    }
+
+    g_pSearch->index.Find(strQuery, g_searchMatches);
+    ShowSearchCount(TRUE);
+
+    uint32_t entry;
+    if (CapSearchNext(g_searchMatches, GetSelectedEntry(), false, entry))
+        JumpToEntry(entry);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_FindNext()
+//-----------------------------------------------------------------------------
+VOID DXView_FindNext(BOOL bBackward)
+{
+    if (!g_pSearch)
+    {
+        DXView_OnSearchChange();
+        return;
+    }
+
+    if (!CapSearchCount(g_searchMatches))
+    {
+        MessageBeep(MB_OK);
+        return;
+    }
+
+    uint32_t start = GetSelectedEntry();
+    if (bBackward)
+        start = start ? start - 1 : UINT32_MAX;
+    else
+        ++start;
+
+    uint32_t entry;
+    if (CapSearchNext(g_searchMatches, start, bBackward != FALSE, entry))
+        JumpToEntry(entry);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_ResetSearch()
+// Desc: Drops the index once the tree or its view options change. The next
+//       search builds a new one.
+//-----------------------------------------------------------------------------
+VOID DXView_ResetSearch()
+{
+    DXView_FreeSearch();
+
+    if (g_hwndSearch && GetWindowTextLength(g_hwndSearch) > 0)
+        ShowSearchCount(FALSE);
+}
+
+
+//-----------------------------------------------------------------------------
+VOID DXView_FreeSearch()
+{
+    WaitForSearchIndex();
+
+    delete g_pSearch;
+    delete g_pSearchBuilding;
+    g_pSearch = g_pSearchBuilding = nullptr;
+
+    g_searchMatches.clear();
+    g_searchEntry = 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_SaveGrep()
+// Desc: Writes a line for each node and row of the tree matching the query:
+//       the node's path, then the row's name and value, separated by tabs
+//-----------------------------------------------------------------------------
+BOOL DXView_SaveGrep(HWND hwndTV, LPCTSTR strFile, LPCSTR strQuery)
+{
+    PROBESCOPE probeScope(PROBE_PHASE, "DXView_SaveGrep", nullptr);
+
+    if (!strFile || !*strFile || !strQuery)
+        return FALSE;
+
+    SEARCHTREE* pTree = CopyTree(hwndTV);
+    if (!pTree)
+        return FALSE;
+
+    const auto& nodes = pTree->snapshot.nodes;
+    pTree->index.Build(nodes);
+
+    std::vector<uint64_t> matches;
+    pTree->index.Find(strQuery, matches);
+
+    std::vector<std::string> paths;
+    CapBuildNodePaths(nodes, paths);
+
+    std::string text;
+    for (uint32_t entry = 0; entry < pTree->index.entries.size(); ++entry)
+    {
+        if (!((matches[entry >> 6] >> (entry & 63)) & 1))
+            continue;
+
+        const CAPSEARCHENTRY& match = pTree->index.entries[entry];
+        text += paths[match.node];
+        if (match.row != CAPSEARCH_NODE)
+        {
+            const CAPROW& row = nodes[match.node].pModel->rows[match.row];
+            text += '\t';
+            text += row.Name();
+            text += '\t';
+            text += row.Value();
+        }
+        text += "\r\n";
+    }
+
+    delete pTree;
+
+    HANDLE hFile = CreateFile(strFile, GENERIC_WRITE, 0, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    DWORD cbWritten = 0;
+    BOOL fResult = WriteFile(hFile, text.data(), static_cast<DWORD>(text.size()), &cbWritten, nullptr)
+        && (cbWritten == text.size());
+    CloseHandle(hFile);
+
+    return fResult;
+}
@@ -0,0 +1,401 @@
+//-----------------------------------------------------------------------------
+// Name: dxfleet.cpp
+//
+// Desc: DirectX Capabilities Viewer fleet aggregation
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxfleet.h"
+
+#include <cstring>
+#include <utility>
+
+namespace
+{
+    // A cap as aggregated. Rows like the MSAA ones, whose value lists several
+    // "label: value" parts, give one of these per part.
+    struct FLEETCAP
+    {
+        std::string     name;
+        std::string     value;
+        bool            supported;
+    };
+
+    //-----------------------------------------------------------------------------
+    // Name: IsCapSupported()
+    // Desc: Typed caps are supported when non-zero. Text is supported unless it
+    //       is empty or one of the ways the viewer shows that something isn't.
+    //-----------------------------------------------------------------------------
+    bool IsCapSupported(CAPKIND kind, uint32_t value, const std::string& text)
+    {
+        switch (kind)
+        {
+        case CAPKIND_VALUE:
+        case CAPKIND_HEX:
+        case CAPKIND_BOOL:
+        case CAPKIND_VERSION:
+        case CAPKIND_FLOAT:
+            return value != 0;
+
+        default:
+            break;
+        }
+
+        static const char* const c_szUnsupported[] = { "", "No", "Optional (No)", "n/a", "None", "0" };
+        for (auto szText : c_szUnsupported)
+        {
+            if (text == szText)
+                return false;
+        }
+
+        return true;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: NextFleetCap()
+    // Desc: caps is reused from node to node, so its strings keep their buffers
+    //-----------------------------------------------------------------------------
+    FLEETCAP& NextFleetCap(std::vector<FLEETCAP>& caps, size_t& count)
+    {
+        if (count == caps.size())
+            caps.emplace_back();
+        return caps[count++];
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: SplitCompositeValue()
+    // Desc: Splits "2x: Yes (1)   4x: No" into its parts. Returns false, adding
+    //       nothing, if the text isn't made up only of such parts.
+    //-----------------------------------------------------------------------------
+    bool SplitCompositeValue(const std::string& name, const std::string& text, std::vector<FLEETCAP>& caps, size_t& count)
+    {
+        if (text.find("   ") == std::string::npos)
+            return false;
+
+        const size_t first = count;
+        size_t pos = 0;
+        while (pos < text.size())
+        {
+            size_t end = text.find("   ", pos);
+            if (end == std::string::npos)
+                end = text.size();
+
+            size_t colon = text.find(": ", pos);
+            if (colon == std::string::npos || colon >= end)
+            {
+                count = first;
+                return false;
+            }
+
+            FLEETCAP& cap = NextFleetCap(caps, count);
+            cap.name = name;
+            cap.name += ' ';
+            cap.name.append(text, pos, colon - pos);
+            cap.value.assign(text, colon + 2, end - colon - 2);
+            cap.supported = IsCapSupported(CAPKIND_STRING, 0, cap.value);
+
+            pos = text.find_first_not_of(' ', end);
+            if (pos == std::string::npos)
+                break;
+        }
+
+        return count > first;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: GetFleetCaps()
+    // Desc: The caps a node's rows show. Headings and blank lines aren't caps.
+    //-----------------------------------------------------------------------------
+    size_t GetFleetCaps(const CAPMODEL& model, std::vector<FLEETCAP>& caps)
+    {
+        size_t count = 0;
+        std::string value;
+        for (const auto& row : model.rows)
+        {
+            if (row.kind == CAPKIND_HEADING || !*row.Name())
+                continue;
+
+            CapDiffRowValue(row, value);
+            if (row.kind == CAPKIND_STRING && SplitCompositeValue(row.cells[0].text, value, caps, count))
+                continue;
+
+            FLEETCAP& cap = NextFleetCap(caps, count);
+            cap.name = row.cells[0].text;
+            cap.supported = IsCapSupported(row.kind, row.value, value);
+            cap.value.swap(value);
+        }
+
+        return count;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    void CountValue(CAPFLEETROW& row, const std::string& value, uint32_t count)
+    {
+        for (auto& entry : row.values)
+        {
+            if (entry.first == value)
+            {
+                entry.second += count;
+                return;
+            }
+        }
+
+        row.values.emplace_back(value, count);
+    }
+
+    void CountCap(CAPFLEETROW& row, const FLEETCAP& cap)
+    {
+        ++row.present;
+        if (cap.supported)
+            ++row.supported;
+        CountValue(row, cap.value, 1);
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: AddFleetCaps()
+    // Desc: Snapshots of the same device and driver almost always list a node's
+    //       caps in the same order, so they're matched by position until one
+    //       differs, and by key from there on.
+    //-----------------------------------------------------------------------------
+    void AddFleetCaps(CAPFLEETNODE& node, const std::vector<FLEETCAP>& caps, size_t count)
+    {
+        size_t i = 0;
+        for (; i < count && i < node.rows.size() && node.rows[i].name == caps[i].name; ++i)
+            CountCap(node.rows[i], caps[i]);
+
+        if (i == count)
+            return;
+
+        // Number repeated names the same way as the rows matched so far
+        std::unordered_map<std::string, uint32_t> seen;
+        for (size_t j = 0; j < i; ++j)
+            ++seen[caps[j].name];
+
+        for (; i < count; ++i)
+        {
+            std::string key = caps[i].name;
+            uint32_t nth = ++seen[key];
+            if (nth > 1)
+            {
+                key += '#';
+                key += std::to_string(nth);
+            }
+
+            auto it = node.index.find(key);
+            if (it == node.index.end())
+            {
+                CAPFLEETROW row = {};
+                row.name = caps[i].name;
+                row.key = key;
+                it = node.index.emplace(std::move(key), node.rows.size()).first;
+                node.rows.push_back(std::move(row));
+            }
+
+            CountCap(node.rows[it->second], caps[i]);
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: MatchAdapter()
+    // Desc: The adapter of the snapshot's key that an adapter node is for: the
+    //       first one not yet taken whose vendor and device are those the node
+    //       shows. The nodes are added in the key's order, so this is usually
+    //       the next one. Returns adapters.size() if none is left.
+    //-----------------------------------------------------------------------------
+    size_t MatchAdapter(const CAPMODEL* pModel, const std::vector<CAPSNAPSHOTADAPTER>& adapters, std::vector<bool>& taken)
+    {
+        const uint32_t NO_ID = ~0u;
+        uint32_t vendorId = NO_ID;
+        uint32_t deviceId = NO_ID;
+        for (size_t i = 0; pModel && i < pModel->rows.size(); ++i)
+        {
+            const CAPROW& row = pModel->rows[i];
+            if (row.kind != CAPKIND_HEX)
+                continue;
+
+            if (!strcmp(row.Name(), "VendorId"))
+                vendorId = row.value;
+            else if (!strcmp(row.Name(), "DeviceId"))
+                deviceId = row.value;
+        }
+
+        for (size_t i = 0; i < adapters.size(); ++i)
+        {
+            if (!taken[i]
+                && (vendorId == NO_ID || adapters[i].vendorId == vendorId)
+                && (deviceId == NO_ID || adapters[i].deviceId == deviceId))
+            {
+                taken[i] = true;
+                return i;
+            }
+        }
+
+        return adapters.size();
+    }
+
+
+    //-----------------------------------------------------------------------------
+    size_t SubtreeEnd(const std::vector<CAPSNAPSHOTNODE>& nodes, size_t iRoot)
+    {
+        size_t i = iRoot + 1;
+        while (i < nodes.size() && nodes[i].depth > nodes[iRoot].depth)
+            ++i;
+        return i;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: AddFleetSubtree()
+    // Desc: Tallies the nodes from iRoot up to iEnd, with path in place of the
+    //       root's own path. That drops the "#n" CapBuildNodePaths gives a root
+    //       whose sibling has the same name, so identical adapters line up
+    //       whichever one they were.
+    //-----------------------------------------------------------------------------
+    void AddFleetSubtree(CAPFLEETGROUP& group, const std::vector<CAPSNAPSHOTNODE>& nodes,
+        const std::vector<std::string>& paths, size_t iRoot, size_t iEnd, std::string path, std::vector<FLEETCAP>& caps)
+    {
+        ++group.subtrees;
+
+        const std::string& rootPath = paths[iRoot];
+        const size_t cchBase = path.size();
+
+        for (size_t i = iRoot; i < iEnd; ++i)
+        {
+            const CAPMODEL* pModel = nodes[i].pModel;
+            if (!pModel)
+                continue;
+
+            size_t count = GetFleetCaps(*pModel, caps);
+            if (!count)
+                continue;
+
+            path.resize(cchBase);
+            path.append(paths[i], rootPath.size(), std::string::npos);
+            AddFleetCaps(group.nodes[path], caps, count);
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: Add()
+// Desc: Tallies one snapshot, a subtree at a time. Adapters that aren't in
+//       the snapshot's key, which only happens if they changed while it was
+//       being recorded, form a group of their own.
+//-----------------------------------------------------------------------------
+void CAPFLEET::Add(const CAPSNAPSHOT& snapshot)
+{
+    const std::vector<CAPSNAPSHOTNODE>& nodes = snapshot.nodes;
+
+    std::vector<CAPSNAPSHOTADAPTER> adapters;
+    if (!CapReadSnapshotAdapters(snapshot.key, adapters))
+        adapters.clear();
+    std::vector<bool> taken(adapters.size(), false);
+
+    std::vector<std::string> paths;
+    CapBuildNodePaths(nodes, paths);
+
+    std::vector<FLEETCAP> caps;
+    for (size_t iRoot = 0; iRoot < nodes.size(); iRoot = SubtreeEnd(nodes, iRoot))
+    {
+        CAPFLEETKEY groupKey = {};
+        if (nodes[iRoot].text == "Direct3D9 Devices")
+            groupKey.kind = CAPFLEET_D3D9;
+        else if (nodes[iRoot].text == "DirectDraw Devices")
+            groupKey.kind = CAPFLEET_DDRAW;
+        else if (nodes[iRoot].text != "DXGI Devices")
+            groupKey.kind = CAPFLEET_OTHER;
+        else
+        {
+            // Each adapter, WARP and Reference under DXGI Devices
+            size_t iEnd = SubtreeEnd(nodes, iRoot);
+            for (size_t i = iRoot + 1; i < iEnd; i = SubtreeEnd(nodes, i))
+            {
+                CAPFLEETKEY adapterKey = {};
+                if (nodes[i].text == "Windows Advanced Rasterization Platform (WARP)")
+                    adapterKey.kind = CAPFLEET_WARP;
+                else if (nodes[i].text == "Reference")
+                    adapterKey.kind = CAPFLEET_REFERENCE;
+                else
+                {
+                    size_t iAdapter = MatchAdapter(nodes[i].pModel, adapters, taken);
+                    if (iAdapter < adapters.size())
+                    {
+                        adapterKey.vendorId = adapters[iAdapter].vendorId;
+                        adapterKey.deviceId = adapters[iAdapter].deviceId;
+                        adapterKey.driverVersion = adapters[iAdapter].driverVersion;
+                    }
+                }
+
+                AddFleetSubtree(groups[adapterKey], nodes, paths, i, SubtreeEnd(nodes, i),
+                    paths[iRoot] + '/' + nodes[i].text, caps);
+            }
+            continue;
+        }
+
+        AddFleetSubtree(groups[groupKey], nodes, paths, iRoot, SubtreeEnd(nodes, iRoot), nodes[iRoot].text, caps);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: Merge()
+// Desc: Adds the tallies of another aggregate, taking whatever it has that
+//       this one doesn't rather than copying it
+//-----------------------------------------------------------------------------
+void CAPFLEET::Merge(CAPFLEET& other)
+{
+    skipped += other.skipped;
+
+    for (auto& otherGroup : other.groups)
+    {
+        auto itGroup = groups.find(otherGroup.first);
+        if (itGroup == groups.end())
+        {
+            groups.emplace(otherGroup.first, std::move(otherGroup.second));
+            continue;
+        }
+
+        CAPFLEETGROUP& group = itGroup->second;
+        group.subtrees += otherGroup.second.subtrees;
+        for (auto& otherNode : otherGroup.second.nodes)
+        {
+            auto itNode = group.nodes.find(otherNode.first);
+            if (itNode == group.nodes.end())
+            {
+                group.nodes.emplace(otherNode.first, std::move(otherNode.second));
+                continue;
+            }
+
+            CAPFLEETNODE& node = itNode->second;
+            for (auto& otherRow : otherNode.second.rows)
+            {
+                auto itRow = node.index.find(otherRow.key);
+                if (itRow == node.index.end())
+                {
+                    node.index.emplace(otherRow.key, node.rows.size());
+                    node.rows.push_back(std::move(otherRow));
+                    continue;
+                }
+
+                CAPFLEETROW& row = node.rows[itRow->second];
+                row.present += otherRow.present;
+                row.supported += otherRow.supported;
+                for (const auto& value : otherRow.values)
+                    CountValue(row, value.first, value.second);
+            }
+        }
+    }
+
+    other.groups.clear();
+    other.skipped = 0;
+}
@@ -0,0 +1,86 @@
+//-----------------------------------------------------------------------------
+// Name: dxfleet.h
+//
+// Desc: DirectX Capabilities Viewer fleet aggregation
+//
+//       Tallies the caps of many snapshots. Each DXGI adapter's subtree is
+//       grouped by that adapter's vendor, device and driver, and the WARP,
+//       Reference, Direct3D 9 and DirectDraw subtrees each form groups of
+//       their own. Every cap keeps how many subtrees report it, how many of
+//       those support it and how often each value was seen. Aggregates built
+//       on separate threads are merged at the end. Kept free of Windows
+//       dependencies.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include "dxdiff.h"
+
+#include <map>
+#include <unordered_map>
+
+// Which part of a snapshot a group tallies
+enum CAPFLEETKIND : uint32_t
+{
+    CAPFLEET_ADAPTER = 0,   // A DXGI adapter, by vendor, device and driver
+    CAPFLEET_WARP,
+    CAPFLEET_REFERENCE,
+    CAPFLEET_D3D9,
+    CAPFLEET_DDRAW,
+    CAPFLEET_OTHER,         // Anything else, such as the probe statistics
+};
+
+struct CAPFLEETKEY
+{
+    CAPFLEETKIND    kind;
+    uint32_t        vendorId;       // These three are 0 unless kind is CAPFLEET_ADAPTER
+    uint32_t        deviceId;
+    uint64_t        driverVersion;
+
+    bool operator<(const CAPFLEETKEY& other) const
+    {
+        if (kind != other.kind)
+            return kind < other.kind;
+        if (vendorId != other.vendorId)
+            return vendorId < other.vendorId;
+        if (deviceId != other.deviceId)
+            return deviceId < other.deviceId;
+        return driverVersion < other.driverVersion;
+    }
+};
+
+struct CAPFLEETROW
+{
+    std::string     name;           // As shown
+    std::string     key;            // Name numbered when a node repeats it
+    uint32_t        present;        // Subtrees with this cap
+    uint32_t        supported;      // Of those, how many have it set (see IsCapSupported)
+    std::vector<std::pair<std::string, uint32_t>>   values; // Snapshots by value shown, rarely more than a few
+};
+
+struct CAPFLEETNODE
+{
+    std::vector<CAPFLEETROW>                    rows;       // In the order first seen
+    std::unordered_map<std::string, size_t>     index;      // Into rows, by key
+};
+
+struct CAPFLEETGROUP
+{
+    uint32_t                                        subtrees;   // Snapshots, once for each such adapter they have
+    std::unordered_map<std::string, CAPFLEETNODE>   nodes;      // By path (see CAPFLEET::Add)
+};
+
+struct CAPFLEET
+{
+    std::map<CAPFLEETKEY, CAPFLEETGROUP>    groups;
+    uint32_t                                skipped;        // Snapshots that couldn't be read
+
+    CAPFLEET() noexcept : skipped(0) {}
+
+    void Add(const CAPSNAPSHOT& snapshot);
+    void Merge(CAPFLEET& other);
+};
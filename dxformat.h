@@ -0,0 +1,223 @@
+//-----------------------------------------------------------------------------
+// Name: dxformat.h
+//
+// Desc: DirectX Capabilities Viewer format metadata
+//
+//       Each API keeps a constant table describing its format enum. Names,
+//       format lists and reverse lookups are all derived from that table at
+//       compile time, so adding a format is a one-line change. Kept free of
+//       Windows dependencies.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#define FORMAT_INDEX_SIZE   256     // Format values below this are looked up directly
+#define FORMAT_HASH_SIZE    2048    // Slots in a name lookup table, must be a power of two
+
+enum FORMATCLASS : uint8_t
+{
+    FORMATCLASS_UNKNOWN = 0,
+    FORMATCLASS_COLOR,              // One value per channel, usable as a render target
+    FORMATCLASS_DEPTHSTENCIL,
+    FORMATCLASS_PACKED,             // Shared exponent, subsampled or bit-packed texels
+    FORMATCLASS_COMPRESSED,         // Block compressed
+    FORMATCLASS_VIDEO,              // YUV and palettized video formats
+    FORMATCLASS_BUFFER,             // Vertex and index data
+};
+
+#define FORMATCLASS_MASK(c) (1u << (c))
+
+#define FMTF_TYPELESS   0x01        // Some or all channels are typeless
+#define FMTF_SRGB       0x02
+#define FMTF_BGR        0x04        // Stored blue first
+#define FMTF_PLANAR     0x08
+#define FMTF_PALETTIZED 0x10
+#define FMTF_STENCIL    0x20
+#define FMTF_DISPLAY    0x40        // Only meaningful for scan-out
+#define FMTF_9EX        0x80        // Requires Direct3D 9Ex
+
+struct FORMATDESC
+{
+    uint32_t        format;         // Value of the API's format enum
+    const char*     strName;        // Full enum name, prefix included
+    const char*     strChannels;    // Channel layout in memory order
+    uint8_t         bpp;            // Bits per texel, or per block texel when compressed
+    uint8_t         blockWidth;
+    uint8_t         blockHeight;
+    FORMATCLASS     fmtClass;
+    uint8_t         flags;          // FMTF_ values
+    uint32_t        typeless;       // Typeless format of the family, or 0
+};
+
+struct FORMATTABLE
+{
+    const FORMATDESC*   pFormats;
+    size_t              count;
+    size_t              cchPrefix;  // Length of the prefix every name shares
+};
+
+struct FORMATINDEX
+{
+    uint8_t     rows[FORMAT_INDEX_SIZE];    // Table row plus one by format value, 0 if none
+};
+
+struct FORMATHASH
+{
+    uint32_t    seed;                       // Picked so that no two names share a slot
+    uint8_t     slots[FORMAT_HASH_SIZE];    // Table row plus one by name hash, 0 if none
+};
+
+
+//-----------------------------------------------------------------------------
+// Name: FormatNameHash()
+// Desc: Case-insensitive FNV-1a over a name, folded down to a slot
+//-----------------------------------------------------------------------------
+constexpr size_t FormatNameHash(const char* strName, uint32_t seed)
+{
+    uint32_t hash = 2166136261u ^ seed;
+    for (; *strName; ++strName)
+    {
+        char ch = *strName;
+        if (ch >= 'a' && ch <= 'z')
+            ch = static_cast<char>(ch - 'a' + 'A');
+        hash ^= static_cast<uint8_t>(ch);
+        hash *= 16777619u;
+    }
+    return (hash ^ (hash >> 15)) & (FORMAT_HASH_SIZE - 1);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: FormatNameEquals()
+// Desc: Case-insensitive comparison of at most cchMax characters
+//-----------------------------------------------------------------------------
+constexpr bool FormatNameEquals(const char* strA, const char* strB, size_t cchMax)
+{
+    for (size_t i = 0; i < cchMax; ++i)
+    {
+        char chA = strA[i];
+        char chB = strB[i];
+        if (chA >= 'a' && chA <= 'z')
+            chA = static_cast<char>(chA - 'a' + 'A');
+        if (chB >= 'a' && chB <= 'z')
+            chB = static_cast<char>(chB - 'a' + 'A');
+        if (chA != chB)
+            return false;
+        if (!chA)
+            break;
+    }
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: BuildFormatIndex()
+//-----------------------------------------------------------------------------
+constexpr FORMATINDEX BuildFormatIndex(const FORMATTABLE& table)
+{
+    FORMATINDEX index = {};
+    for (size_t i = 0; i < table.count; ++i)
+    {
+        if (table.pFormats[i].format < FORMAT_INDEX_SIZE)
+            index.rows[table.pFormats[i].format] = static_cast<uint8_t>(i + 1);
+    }
+    return index;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: BuildFormatHash()
+// Desc: Hashes each name less its prefix. Check the result with
+//       CountFormatHashSlots, a collision leaves fewer slots than formats.
+//-----------------------------------------------------------------------------
+constexpr FORMATHASH BuildFormatHash(const FORMATTABLE& table, uint32_t seed)
+{
+    FORMATHASH hash = {};
+    hash.seed = seed;
+    for (size_t i = 0; i < table.count; ++i)
+        hash.slots[FormatNameHash(table.pFormats[i].strName + table.cchPrefix, seed)] = static_cast<uint8_t>(i + 1);
+    return hash;
+}
+
+constexpr size_t CountFormatHashSlots(const FORMATHASH& hash)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < FORMAT_HASH_SIZE; ++i)
+    {
+        if (hash.slots[i])
+            ++count;
+    }
+    return count;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: FindFormat()
+// Desc: Looks up a format by value
+//-----------------------------------------------------------------------------
+inline const FORMATDESC* FindFormat(const FORMATTABLE& table, const FORMATINDEX& index, uint32_t format)
+{
+    if (format < FORMAT_INDEX_SIZE)
+    {
+        uint8_t row = index.rows[format];
+        return row ? &table.pFormats[row - 1] : nullptr;
+    }
+
+    // Only FOURCC formats are this large, and there are few of them
+    for (size_t i = 0; i < table.count; ++i)
+    {
+        if (table.pFormats[i].format == format)
+            return &table.pFormats[i];
+    }
+
+    return nullptr;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: FindFormatByName()
+// Desc: Looks up a format by name, ignoring case. The prefix is optional.
+//-----------------------------------------------------------------------------
+inline const FORMATDESC* FindFormatByName(const FORMATTABLE& table, const FORMATHASH& hash, const char* strName)
+{
+    if (!strName || !table.count)
+        return nullptr;
+
+    if (FormatNameEquals(strName, table.pFormats[0].strName, table.cchPrefix))
+        strName += table.cchPrefix;
+
+    uint8_t row = hash.slots[FormatNameHash(strName, hash.seed)];
+    if (!row)
+        return nullptr;
+
+    const FORMATDESC* pDesc = &table.pFormats[row - 1];
+    if (!FormatNameEquals(strName, pDesc->strName + table.cchPrefix, SIZE_MAX))
+        return nullptr;
+
+    return pDesc;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: FormatMatches()
+// Desc: Whether a format is in one of the classes and has none of the flags,
+//       for building format lists
+//-----------------------------------------------------------------------------
+constexpr bool FormatMatches(const FORMATDESC& desc, uint32_t classMask, uint32_t excludeFlags)
+{
+    return (FORMATCLASS_MASK(desc.fmtClass) & classMask) && !(desc.flags & excludeFlags);
+}
+
+
+//-----------------------------------------------------------------------------
+// Format lookups by name, for importers and query filters
+//-----------------------------------------------------------------------------
+const FORMATDESC* DXGI_FindFormat(const char* strName);
+const FORMATDESC* DXG_FindFormat(const char* strName);
@@ -9,8 +9,17 @@
 // https://go.microsoft.com/fwlink/?linkid=2136896
 //-----------------------------------------------------------------------------
 #include "dxview.h"
+#include "dxformat.h"
+#include "dxtrace.h"
 #include <d3d9.h>
 
+// Define for some debug output (D3D9 tree build time and node count)
+//#define EXTRA_DEBUG
+
+// Define to probe the "Render Format Compatibility" subtrees at startup
+// instead of the first time each node is expanded (see DXG_SetEagerFill)
+//#define DXG_EAGER_FILL
+
 // Some useful 9EX defines so we don't have to include the 9ex header
 #define D3DFMT_D32_LOCKABLE 84
 #define D3DFMT_S8_LOCKABLE	85
@@ -37,101 +46,154 @@ namespace
 
     BOOL g_is9Ex = FALSE;
 
-    BOOL IsAdapterFmtAvailable(UINT iAdapter, D3DDEVTYPE devType, D3DFORMAT fmtAdapter, BOOL bWindowed);
-    HRESULT DXGDisplayCaps(LPARAM lParam1, LPARAM lParam2, _In_opt_ PRINTCBINFO* pInfo);
+#ifdef DXG_EAGER_FILL
+    BOOL g_bEagerFill = TRUE;
+#else
+    BOOL g_bEagerFill = FALSE;
+#endif
 
-#define CAPSVALDEFex(name,val)           {name, FIELD_OFFSET(D3DCAPS9,val), 0, DXV_9EXCAP}
-#define CAPSVALDEF(name,val)           {name, FIELD_OFFSET(D3DCAPS9,val), 0}
-#define CAPSFLAGDEFex(name,val,flag)     {name, FIELD_OFFSET(D3DCAPS9,val), flag, DXV_9EXCAP}
-#define CAPSFLAGDEF(name,val,flag)     {name, FIELD_OFFSET(D3DCAPS9,val), flag}
-#define CAPSMASK16DEF(name,val)        {name, FIELD_OFFSET(D3DCAPS9,val), 0x0FFFFFFF}
-#define CAPSFLOATDEF(name,val)         {name, FIELD_OFFSET(D3DCAPS9,val), 0xBFFFFFFF}
-#define CAPSSHADERDEF(name,val)        {name, FIELD_OFFSET(D3DCAPS9,val), 0xEFFFFFFF}
+    std::vector<std::string> g_adapterNames;    // By adapter ordinal, for probe timing
 
-#define PRIMCAPSVALDEF(name,val)       {name, FIELD_OFFSET(D3DPRIMCAPS9,val), 0}
-#define PRIMCAPSFLAGDEF(name,val,flag) {name, FIELD_OFFSET(D3DPRIMCAPS9,val), flag}
+    // So a device change can find the adapters it touched
+    HTREEITEM g_hTreeD3D9 = nullptr;
+    std::vector<ADAPTERLUID> g_adapterLuids;    // By adapter ordinal, zero without Direct3D9Ex
 
-    // NOTE: Remember to update FormatName() when you update this list!!
-    D3DFORMAT AllFormatArray[] =
+    //-----------------------------------------------------------------------------
+    const char* AdapterName(UINT iAdapter)
     {
-        D3DFMT_R8G8B8,
-        D3DFMT_A8R8G8B8,
-        D3DFMT_X8R8G8B8,
-        D3DFMT_R5G6B5,
-        D3DFMT_X1R5G5B5,
-        D3DFMT_A1R5G5B5,
-        D3DFMT_A4R4G4B4,
-        D3DFMT_R3G3B2,
-        D3DFMT_A8,
-        D3DFMT_A8R3G3B2,
-        D3DFMT_X4R4G4B4,
-        D3DFMT_A2B10G10R10,
-        D3DFMT_A8B8G8R8,
-        D3DFMT_X8B8G8R8,
-        D3DFMT_G16R16,
-        D3DFMT_A2R10G10B10,
-        D3DFMT_A16B16G16R16,
-
-        D3DFMT_A8P8,
-        D3DFMT_P8,
-
-        D3DFMT_L8,
-        D3DFMT_A8L8,
-        D3DFMT_A4L4,
-
-        D3DFMT_V8U8,
-        D3DFMT_L6V5U5,
-        D3DFMT_X8L8V8U8,
-        D3DFMT_Q8W8V8U8,
-        D3DFMT_V16U16,
-        D3DFMT_A2W10V10U10,
-
-        D3DFMT_UYVY,
-        D3DFMT_R8G8_B8G8,
-        D3DFMT_YUY2,
-        D3DFMT_G8R8_G8B8,
-        D3DFMT_DXT1,
-        D3DFMT_DXT2,
-        D3DFMT_DXT3,
-        D3DFMT_DXT4,
-        D3DFMT_DXT5,
+        return (iAdapter < g_adapterNames.size()) ? g_adapterNames[iAdapter].c_str() : "";
+    }
 
-        D3DFMT_D16_LOCKABLE,
-        D3DFMT_D32,
-        D3DFMT_D15S1,
-        D3DFMT_D24S8,
-        D3DFMT_D24X8,
-        D3DFMT_D24X4S4,
-        D3DFMT_D16,
+    BOOL IsAdapterFmtAvailable(UINT iAdapter, D3DDEVTYPE devType, D3DFORMAT fmtAdapter, BOOL bWindowed);
+    HRESULT DXGDisplayCaps(LPARAM lParam1, LPARAM lParam2, _In_opt_ PRINTCBINFO* pInfo);
 
-        D3DFMT_D32F_LOCKABLE,
-        D3DFMT_D24FS8,
+#define CAPSVALDEFex(name,val)         CAPDEFROW(name, D3DCAPS9, val, 0, DXV_9EXCAP, CAPDEF_VALUE)
+#define CAPSVALDEF(name,val)           CAPDEFROW(name, D3DCAPS9, val, 0, 0, CAPDEF_VALUE)
+#define CAPSFLAGDEFex(name,val,flag)   CAPDEFROW(name, D3DCAPS9, val, flag, DXV_9EXCAP, CAPDEF_FLAG)
+#define CAPSFLAGDEF(name,val,flag)     CAPDEFROW(name, D3DCAPS9, val, flag, 0, CAPDEF_FLAG)
+#define CAPSMASK16DEF(name,val)        CAPDEFROW(name, D3DCAPS9, val, 0, 0, CAPDEF_MASK16)
+#define CAPSFLOATDEF(name,val)         CAPDEFROW(name, D3DCAPS9, val, 0, 0, CAPDEF_FLOAT)
+#define CAPSSHADERDEF(name,val)        CAPDEFROW(name, D3DCAPS9, val, 0, 0, CAPDEF_VERSION)
 
-        D3DFMT_L16,
+#define PRIMCAPSVALDEF(name,val)       CAPDEFROW(name, D3DPRIMCAPS9, val, 0, 0, CAPDEF_VALUE)
+#define PRIMCAPSFLAGDEF(name,val,flag) CAPDEFROW(name, D3DPRIMCAPS9, val, flag, 0, CAPDEF_FLAG)
 
-        D3DFMT_VERTEXDATA,
-        D3DFMT_INDEX16,
-        D3DFMT_INDEX32,
+#define D3D9FMT(name, channels, bpp, bw, bh, fmtClass, flags) \
+    { static_cast<uint32_t>(D3DFMT_##name), "D3DFMT_" #name, channels, bpp, bw, bh, \
+      FORMATCLASS_##fmtClass, flags, 0 }
 
-        D3DFMT_Q16W16V16U16,
+    // In the order the format lists below keep
+    constexpr FORMATDESC c_d3d9Formats[] =
+    {
+        D3D9FMT(UNKNOWN,       "",       0, 1, 1, UNKNOWN,      0),
+
+        D3D9FMT(R8G8B8,        "RGB",   24, 1, 1, COLOR,        0),
+        D3D9FMT(A8R8G8B8,      "ARGB",  32, 1, 1, COLOR,        0),
+        D3D9FMT(X8R8G8B8,      "XRGB",  32, 1, 1, COLOR,        0),
+        D3D9FMT(R5G6B5,        "RGB",   16, 1, 1, COLOR,        0),
+        D3D9FMT(X1R5G5B5,      "XRGB",  16, 1, 1, COLOR,        0),
+        D3D9FMT(A1R5G5B5,      "ARGB",  16, 1, 1, COLOR,        0),
+        D3D9FMT(A4R4G4B4,      "ARGB",  16, 1, 1, COLOR,        0),
+        D3D9FMT(R3G3B2,        "RGB",    8, 1, 1, COLOR,        0),
+        D3D9FMT(A8,            "A",      8, 1, 1, COLOR,        0),
+        D3D9FMT(A8R3G3B2,      "ARGB",  16, 1, 1, COLOR,        0),
+        D3D9FMT(X4R4G4B4,      "XRGB",  16, 1, 1, COLOR,        0),
+        D3D9FMT(A2B10G10R10,   "ABGR",  32, 1, 1, COLOR,        0),
+        D3D9FMT(A8B8G8R8,      "ABGR",  32, 1, 1, COLOR,        0),
+        D3D9FMT(X8B8G8R8,      "XBGR",  32, 1, 1, COLOR,        0),
+        D3D9FMT(G16R16,        "GR",    32, 1, 1, COLOR,        0),
+        D3D9FMT(A2R10G10B10,   "ARGB",  32, 1, 1, COLOR,        0),
+        D3D9FMT(A16B16G16R16,  "ABGR",  64, 1, 1, COLOR,        0),
+
+        D3D9FMT(A8P8,          "AP",    16, 1, 1, COLOR,        FMTF_PALETTIZED),
+        D3D9FMT(P8,            "P",      8, 1, 1, COLOR,        FMTF_PALETTIZED),
+
+        D3D9FMT(L8,            "L",      8, 1, 1, COLOR,        0),
+        D3D9FMT(A8L8,          "AL",    16, 1, 1, COLOR,        0),
+        D3D9FMT(A4L4,          "AL",     8, 1, 1, COLOR,        0),
+
+        D3D9FMT(V8U8,          "VU",    16, 1, 1, COLOR,        0),
+        D3D9FMT(L6V5U5,        "LVU",   16, 1, 1, COLOR,        0),
+        D3D9FMT(X8L8V8U8,      "XLVU",  32, 1, 1, COLOR,        0),
+        D3D9FMT(Q8W8V8U8,      "QWVU",  32, 1, 1, COLOR,        0),
+        D3D9FMT(V16U16,        "VU",    32, 1, 1, COLOR,        0),
+        D3D9FMT(A2W10V10U10,   "AWVU",  32, 1, 1, COLOR,        0),
+
+        D3D9FMT(UYVY,          "UYVY",  16, 2, 1, VIDEO,        0),
+        D3D9FMT(R8G8_B8G8,     "RGBG",  16, 2, 1, PACKED,       0),
+        D3D9FMT(YUY2,          "YUYV",  16, 2, 1, VIDEO,        0),
+        D3D9FMT(G8R8_G8B8,     "GRGB",  16, 2, 1, PACKED,       0),
+        D3D9FMT(DXT1,          "RGBA",   4, 4, 4, COMPRESSED,   0),
+        D3D9FMT(DXT2,          "RGBA",   8, 4, 4, COMPRESSED,   0),
+        D3D9FMT(DXT3,          "RGBA",   8, 4, 4, COMPRESSED,   0),
+        D3D9FMT(DXT4,          "RGBA",   8, 4, 4, COMPRESSED,   0),
+        D3D9FMT(DXT5,          "RGBA",   8, 4, 4, COMPRESSED,   0),
+
+        D3D9FMT(D16_LOCKABLE,  "D",     16, 1, 1, DEPTHSTENCIL, 0),
+        D3D9FMT(D32,           "D",     32, 1, 1, DEPTHSTENCIL, 0),
+        D3D9FMT(D15S1,         "DS",    16, 1, 1, DEPTHSTENCIL, FMTF_STENCIL),
+        D3D9FMT(D24S8,         "DS",    32, 1, 1, DEPTHSTENCIL, FMTF_STENCIL),
+        D3D9FMT(D24X8,         "DX",    32, 1, 1, DEPTHSTENCIL, 0),
+        D3D9FMT(D24X4S4,       "DXS",   32, 1, 1, DEPTHSTENCIL, FMTF_STENCIL),
+        D3D9FMT(D16,           "D",     16, 1, 1, DEPTHSTENCIL, 0),
+
+        D3D9FMT(D32F_LOCKABLE, "D",     32, 1, 1, DEPTHSTENCIL, 0),
+        D3D9FMT(D24FS8,        "DS",    32, 1, 1, DEPTHSTENCIL, FMTF_STENCIL),
+
+        D3D9FMT(L16,           "L",     16, 1, 1, COLOR,        0),
+
+        D3D9FMT(VERTEXDATA,    "",       0, 1, 1, BUFFER,       0),
+        D3D9FMT(INDEX16,       "",      16, 1, 1, BUFFER,       0),
+        D3D9FMT(INDEX32,       "",      32, 1, 1, BUFFER,       0),
+
+        D3D9FMT(Q16W16V16U16,  "QWVU",  64, 1, 1, COLOR,        0),
+
+        D3D9FMT(MULTI2_ARGB8,  "ARGB",  32, 1, 1, COLOR,        0),
+
+        D3D9FMT(R16F,          "R",     16, 1, 1, COLOR,        0),
+        D3D9FMT(G16R16F,       "GR",    32, 1, 1, COLOR,        0),
+        D3D9FMT(A16B16G16R16F, "ABGR",  64, 1, 1, COLOR,        0),
+
+        D3D9FMT(R32F,          "R",     32, 1, 1, COLOR,        0),
+        D3D9FMT(G32R32F,       "GR",    64, 1, 1, COLOR,        0),
+        D3D9FMT(A32B32G32R32F, "ABGR", 128, 1, 1, COLOR,        0),
+
+        D3D9FMT(CxV8U8,        "VU",    16, 1, 1, COLOR,        0),
+
+        D3D9FMT(D32_LOCKABLE,  "D",     32, 1, 1, DEPTHSTENCIL, FMTF_9EX),
+        D3D9FMT(S8_LOCKABLE,   "S",      8, 1, 1, DEPTHSTENCIL, FMTF_STENCIL | FMTF_9EX),
+        D3D9FMT(A1,            "A",      1, 1, 1, COLOR,        FMTF_9EX),
+    };
 
-        D3DFMT_MULTI2_ARGB8,
+    constexpr FORMATTABLE c_d3d9FormatTable = { c_d3d9Formats, std::size(c_d3d9Formats), 7 };
+    constexpr FORMATINDEX c_d3d9FormatIndex = BuildFormatIndex(c_d3d9FormatTable);
+    constexpr FORMATHASH c_d3d9FormatHash = BuildFormatHash(c_d3d9FormatTable, 7);
 
-        D3DFMT_R16F,
-        D3DFMT_G16R16F,
-        D3DFMT_A16B16G16R16F,
+    static_assert(CountFormatHashSlots(c_d3d9FormatHash) == std::size(c_d3d9Formats), "D3D9 format names collide, pick another seed");
 
-        D3DFMT_R32F,
-        D3DFMT_G32R32F,
-        D3DFMT_A32B32G32R32F,
+    struct D3D9FORMATLIST
+    {
+        D3DFORMAT       formats[std::size(c_d3d9Formats)];
+        UINT            count;
+    };
 
-        D3DFMT_CxV8U8,
+    //-----------------------------------------------------------------------------
+    // Name: BuildFormatList()
+    // Desc: Every format in the given classes, less those with an excluded flag
+    //-----------------------------------------------------------------------------
+    constexpr D3D9FORMATLIST BuildFormatList(uint32_t classMask, uint32_t excludeFlags)
+    {
+        D3D9FORMATLIST list = {};
+        for (size_t i = 0; i < std::size(c_d3d9Formats); ++i)
+        {
+            if (FormatMatches(c_d3d9Formats[i], classMask, excludeFlags))
+                list.formats[list.count++] = static_cast<D3DFORMAT>(c_d3d9Formats[i].format);
+        }
+        return list;
+    }
 
-        (D3DFORMAT)D3DFMT_D32_LOCKABLE,
-        (D3DFORMAT)D3DFMT_S8_LOCKABLE,
-        (D3DFORMAT)D3DFMT_A1,
-    };
-    const int NumFormats = sizeof(AllFormatArray) / sizeof(AllFormatArray[0]);
+    constexpr D3D9FORMATLIST AllFormatArray = BuildFormatList(~FORMATCLASS_MASK(FORMATCLASS_UNKNOWN), 0);
+    const int NumFormats = static_cast<int>(AllFormatArray.count);
 
     // A subset of AllFormatArray...it's those D3DFMTs that could possibly be
     // adapter (display) formats.
@@ -786,89 +848,22 @@ namespace
     };
 
     //-----------------------------------------------------------------------------
+    const FORMATDESC* GetFormatDesc(D3DFORMAT format)
+    {
+        return FindFormat(c_d3d9FormatTable, c_d3d9FormatIndex, static_cast<uint32_t>(format));
+    }
+
     const TCHAR* FormatName(D3DFORMAT format)
     {
-        switch (format)
-        {
-        case D3DFMT_UNKNOWN:         return TEXT("D3DFMT_UNKNOWN");
-        case D3DFMT_R8G8B8:          return TEXT("D3DFMT_R8G8B8");
-        case D3DFMT_A8R8G8B8:        return TEXT("D3DFMT_A8R8G8B8");
-        case D3DFMT_X8R8G8B8:        return TEXT("D3DFMT_X8R8G8B8");
-        case D3DFMT_R5G6B5:          return TEXT("D3DFMT_R5G6B5");
-        case D3DFMT_X1R5G5B5:        return TEXT("D3DFMT_X1R5G5B5");
-        case D3DFMT_A1R5G5B5:        return TEXT("D3DFMT_A1R5G5B5");
-        case D3DFMT_A4R4G4B4:        return TEXT("D3DFMT_A4R4G4B4");
-        case D3DFMT_R3G3B2:          return TEXT("D3DFMT_R3G3B2");
-        case D3DFMT_A8:              return TEXT("D3DFMT_A8");
-        case D3DFMT_A8R3G3B2:        return TEXT("D3DFMT_A8R3G3B2");
-        case D3DFMT_X4R4G4B4:        return TEXT("D3DFMT_X4R4G4B4");
-        case D3DFMT_A2B10G10R10:     return TEXT("D3DFMT_A2B10G10R10");
-        case D3DFMT_A8B8G8R8:        return TEXT("D3DFMT_A8B8G8R8");
-        case D3DFMT_X8B8G8R8:        return TEXT("D3DFMT_X8B8G8R8");
-        case D3DFMT_G16R16:          return TEXT("D3DFMT_G16R16");
-        case D3DFMT_A2R10G10B10:     return TEXT("D3DFMT_A2R10G10B10");
-        case D3DFMT_A16B16G16R16:    return TEXT("D3DFMT_A16B16G16R16");
-
-        case D3DFMT_A8P8:            return TEXT("D3DFMT_A8P8");
-        case D3DFMT_P8:              return TEXT("D3DFMT_P8");
-
-        case D3DFMT_L8:              return TEXT("D3DFMT_L8");
-        case D3DFMT_A8L8:            return TEXT("D3DFMT_A8L8");
-        case D3DFMT_A4L4:            return TEXT("D3DFMT_A4L4");
-
-        case D3DFMT_V8U8:            return TEXT("D3DFMT_V8U8");
-        case D3DFMT_L6V5U5:          return TEXT("D3DFMT_L6V5U5");
-        case D3DFMT_X8L8V8U8:        return TEXT("D3DFMT_X8L8V8U8");
-        case D3DFMT_Q8W8V8U8:        return TEXT("D3DFMT_Q8W8V8U8");
-        case D3DFMT_V16U16:          return TEXT("D3DFMT_V16U16");
-        case D3DFMT_A2W10V10U10:     return TEXT("D3DFMT_A2W10V10U10");
-
-        case D3DFMT_UYVY:            return TEXT("D3DFMT_UYVY");
-        case D3DFMT_R8G8_B8G8:       return TEXT("D3DFMT_R8G8_B8G8");
-        case D3DFMT_YUY2:            return TEXT("D3DFMT_YUY2");
-        case D3DFMT_G8R8_G8B8:       return TEXT("D3DFMT_G8R8_G8B8");
-        case D3DFMT_DXT1:            return TEXT("D3DFMT_DXT1");
-        case D3DFMT_DXT2:            return TEXT("D3DFMT_DXT2");
-        case D3DFMT_DXT3:            return TEXT("D3DFMT_DXT3");
-        case D3DFMT_DXT4:            return TEXT("D3DFMT_DXT4");
-        case D3DFMT_DXT5:            return TEXT("D3DFMT_DXT5");
-
-        case D3DFMT_D16_LOCKABLE:    return TEXT("D3DFMT_D16_LOCKABLE");
-        case D3DFMT_D32:             return TEXT("D3DFMT_D32");
-        case D3DFMT_D15S1:           return TEXT("D3DFMT_D15S1");
-        case D3DFMT_D24S8:           return TEXT("D3DFMT_D24S8");
-        case D3DFMT_D24X8:           return TEXT("D3DFMT_D24X8");
-        case D3DFMT_D24X4S4:         return TEXT("D3DFMT_D24X4S4");
-        case D3DFMT_D16:             return TEXT("D3DFMT_D16");
-        case D3DFMT_D32F_LOCKABLE:   return TEXT("D3DFMT_D32F_LOCKABLE");
-        case D3DFMT_D24FS8:          return TEXT("D3DFMT_D24FS8");
-
-        case D3DFMT_L16:             return TEXT("D3DFMT_L16");
-
-        case D3DFMT_VERTEXDATA:      return TEXT("D3DFMT_VERTEXDATA");
-        case D3DFMT_INDEX16:         return TEXT("D3DFMT_INDEX16");
-        case D3DFMT_INDEX32:         return TEXT("D3DFMT_INDEX32");
-
-        case D3DFMT_Q16W16V16U16:    return TEXT("D3DFMT_Q16W16V16U16");
-
-        case D3DFMT_MULTI2_ARGB8:    return TEXT("D3DFMT_MULTI2_ARGB8");
-
-        case D3DFMT_R16F:            return TEXT("D3DFMT_R16F");
-        case D3DFMT_G16R16F:         return TEXT("D3DFMT_G16R16F");
-        case D3DFMT_A16B16G16R16F:   return TEXT("D3DFMT_A16B16G16R16F");
-
-        case D3DFMT_R32F:            return TEXT("D3DFMT_R32F");
-        case D3DFMT_G32R32F:         return TEXT("D3DFMT_G32R32F");
-        case D3DFMT_A32B32G32R32F:   return TEXT("D3DFMT_A32B32G32R32F");
-
-        case D3DFMT_CxV8U8:          return TEXT("D3DFMT_CxV8U8");
-
-        case D3DFMT_D32_LOCKABLE:	 return TEXT("D3DFMT_D32_LOCKABLE");
-        case D3DFMT_S8_LOCKABLE:	 return TEXT("D3DFMT_S8_LOCKABLE");
-        case D3DFMT_A1:				 return TEXT("D3DFMT_A1");
-
-        default:                     return TEXT("Unknown format");
-        }
+        const FORMATDESC* pDesc = GetFormatDesc(format);
+        return pDesc ? pDesc->strName : TEXT("Unknown format");
+    }
+
+    // Formats only a 9Ex device knows about
+    BOOL IsFormat9ExOnly(D3DFORMAT format)
+    {
+        const FORMATDESC* pDesc = GetFormatDesc(format);
+        return (pDesc && (pDesc->flags & FMTF_9EX)) ? TRUE : FALSE;
     }
 
 
@@ -917,7 +912,8 @@ namespace
         }
 
         D3DADAPTER_IDENTIFIER9 identifier;
-        HRESULT hr = g_pD3D->GetAdapterIdentifier(iAdapter, D3DENUM_WHQL_LEVEL, &identifier);
+        HRESULT hr = PROBE_CALL("IDirect3D9::GetAdapterIdentifier", AdapterName(iAdapter),
+            g_pD3D->GetAdapterIdentifier(iAdapter, D3DENUM_WHQL_LEVEL, &identifier));
         if (FAILED(hr))
             return hr;
 
@@ -996,11 +992,13 @@ namespace
         for (INT iFormat = 0; iFormat < NumAdapterFormats; iFormat++)
         {
             D3DFORMAT fmt = AdapterFormatArray[iFormat];
-            UINT numModes = g_pD3D->GetAdapterModeCount(iAdapter, fmt);
+            UINT numModes = PROBE_CALL("IDirect3D9::GetAdapterModeCount", AdapterName(iAdapter),
+                g_pD3D->GetAdapterModeCount(iAdapter, fmt));
             for (UINT iMode = 0; iMode < numModes; iMode++)
             {
                 D3DDISPLAYMODE mode;
-                g_pD3D->EnumAdapterModes(iAdapter, fmt, iMode, &mode);
+                PROBE_CALL("IDirect3D9::EnumAdapterModes", AdapterName(iAdapter),
+                    g_pD3D->EnumAdapterModes(iAdapter, fmt, iMode, &mode));
                 if (!pPrintInfo)
                 {
                     LVAddText(g_hwndLV, 0, "%d x %d", mode.Width, mode.Height);
@@ -1079,7 +1077,8 @@ namespace
         }
 
         DWORD dwNumQualityLevels;
-        if (SUCCEEDED(g_pD3D->CheckDeviceMultiSampleType(iAdapter, devType, fmt, bWindowed, msType, &dwNumQualityLevels)))
+        if (SUCCEEDED(PROBE_CALL("IDirect3D9::CheckDeviceMultiSampleType", AdapterName(iAdapter),
+            g_pD3D->CheckDeviceMultiSampleType(iAdapter, devType, fmt, bWindowed, msType, &dwNumQualityLevels))))
         {
             TCHAR str[100];
             if (dwNumQualityLevels == 1)
@@ -1119,7 +1118,8 @@ namespace
         for (int iFmt = 0; iFmt < NumBBFormats; iFmt++)
         {
             D3DFORMAT fmt = BBFormatArray[iFmt];
-            if (SUCCEEDED(g_pD3D->CheckDeviceType(iAdapter, devType, fmtAdapter, fmt, bWindowed)))
+            if (SUCCEEDED(PROBE_CALL("IDirect3D9::CheckDeviceType", AdapterName(iAdapter),
+                g_pD3D->CheckDeviceType(iAdapter, devType, fmtAdapter, fmt, bWindowed))))
             {
                 if (!pPrintInfo)
                 {
@@ -1154,9 +1154,10 @@ namespace
 
         for (int iFmt = 0; iFmt < NumFormats; iFmt++)
         {
-            D3DFORMAT fmt = AllFormatArray[iFmt];
-            if (SUCCEEDED(g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter, D3DUSAGE_RENDERTARGET,
-                D3DRTYPE_SURFACE, fmt)))
+            D3DFORMAT fmt = AllFormatArray.formats[iFmt];
+            if (SUCCEEDED(PROBE_CALL("IDirect3D9::CheckDeviceFormat", AdapterName(iAdapter),
+                g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter, D3DUSAGE_RENDERTARGET,
+                    D3DRTYPE_SURFACE, fmt))))
             {
                 if (!pPrintInfo)
                 {
@@ -1193,11 +1194,12 @@ namespace
         {
             D3DFORMAT fmt = DSFormatArray[iFmt];
 
-            if (!g_is9Ex && ((fmt == D3DFMT_D32_LOCKABLE) || (fmt == D3DFMT_S8_LOCKABLE)))
+            if (!g_is9Ex && IsFormat9ExOnly(fmt))
                 continue;
 
-            if (SUCCEEDED(g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter, D3DUSAGE_DEPTHSTENCIL,
-                D3DRTYPE_SURFACE, fmt)))
+            if (SUCCEEDED(PROBE_CALL("IDirect3D9::CheckDeviceFormat", AdapterName(iAdapter),
+                g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter, D3DUSAGE_DEPTHSTENCIL,
+                    D3DRTYPE_SURFACE, fmt))))
             {
                 if (!pPrintInfo)
                 {
@@ -1232,7 +1234,8 @@ namespace
         }
 
         DWORD dwNumQualityLevels;
-        if (SUCCEEDED(g_pD3D->CheckDeviceMultiSampleType(iAdapter, devType, fmtDS, FALSE, msType, &dwNumQualityLevels)))
+        if (SUCCEEDED(PROBE_CALL("IDirect3D9::CheckDeviceMultiSampleType", AdapterName(iAdapter),
+            g_pD3D->CheckDeviceMultiSampleType(iAdapter, devType, fmtDS, FALSE, msType, &dwNumQualityLevels))))
         {
             TCHAR str[100];
             if (dwNumQualityLevels == 1)
@@ -1271,13 +1274,14 @@ namespace
 
         for (int iFmt = 0; iFmt < NumFormats; iFmt++)
         {
-            D3DFORMAT fmt = AllFormatArray[iFmt];
+            D3DFORMAT fmt = AllFormatArray.formats[iFmt];
 
-            if (!g_is9Ex && ((fmt == D3DFMT_A1) || (fmt == D3DFMT_D32_LOCKABLE) || (fmt == D3DFMT_S8_LOCKABLE)))
+            if (!g_is9Ex && IsFormat9ExOnly(fmt))
                 continue;
 
-            if (SUCCEEDED(g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter, 0,
-                D3DRTYPE_SURFACE, fmt)))
+            if (SUCCEEDED(PROBE_CALL("IDirect3D9::CheckDeviceFormat", AdapterName(iAdapter),
+                g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter, 0,
+                    D3DRTYPE_SURFACE, fmt))))
             {
                 if (!pPrintInfo)
                 {
@@ -1310,7 +1314,7 @@ namespace
         UINT col = 0;
 
         D3DCAPS9 Caps;
-        g_pD3D->GetDeviceCaps(iAdapter, devType, &Caps);
+        PROBE_CALL("IDirect3D9::GetDeviceCaps", AdapterName(iAdapter), g_pD3D->GetDeviceCaps(iAdapter, devType, &Caps));
 
         if (!pPrintInfo)
         {
@@ -1376,9 +1380,9 @@ namespace
         BOOL bFoundSuccess;
         for (int iFmt = 0; iFmt < NumFormats; iFmt++)
         {
-            D3DFORMAT fmt = AllFormatArray[iFmt];
+            D3DFORMAT fmt = AllFormatArray.formats[iFmt];
 
-            if (!g_is9Ex && ((fmt == D3DFMT_A1) || (fmt == D3DFMT_D32_LOCKABLE) || (fmt == D3DFMT_S8_LOCKABLE)))
+            if (!g_is9Ex && IsFormat9ExOnly(fmt))
                 continue;
 
             // First pass: see if CDF succeeds for any usage
@@ -1423,8 +1427,9 @@ namespace
                 {
                     continue;
                 }
-                if (SUCCEEDED(g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter,
-                    usageArray[iUsage], RType, fmt)))
+                if (SUCCEEDED(PROBE_CALL("IDirect3D9::CheckDeviceFormat", AdapterName(iAdapter),
+                    g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter,
+                        usageArray[iUsage], RType, fmt))))
                 {
                     bFoundSuccess = TRUE;
                     break;
@@ -1483,8 +1488,9 @@ namespace
                     }
                     if (SUCCEEDED(hr))
                     {
-                        hr = g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter,
-                            usageArray[iUsage], RType, fmt);
+                        hr = PROBE_CALL("IDirect3D9::CheckDeviceFormat", AdapterName(iAdapter),
+                            g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter,
+                                usageArray[iUsage], RType, fmt));
                     }
                     if (hr == D3DOK_NOAUTOGEN)
                         pstr = TEXT("No");
@@ -1540,13 +1546,222 @@ namespace
         for (int iFmtBackBuffer = 0; iFmtBackBuffer < NumBBFormats; iFmtBackBuffer++)
         {
             D3DFORMAT fmtBackBuffer = BBFormatArray[iFmtBackBuffer];
-            if (SUCCEEDED(g_pD3D->CheckDeviceType(iAdapter, devType, fmtAdapter, fmtBackBuffer, bWindowed)))
+            if (SUCCEEDED(PROBE_CALL("IDirect3D9::CheckDeviceType", AdapterName(iAdapter),
+                g_pD3D->CheckDeviceType(iAdapter, devType, fmtAdapter, fmtBackBuffer, bWindowed))))
             {
                 return TRUE;
             }
         }
         return FALSE;
     }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: DXGFillRenderFormatMultiSample()
+    // Desc: Lazy fill of a render format node under "Render Format Compatibility"
+    //
+    // lParam1 is the iAdapter and device type
+    // lParam2 is the adapter fmt and bWindowed
+    // lParam3 is the render target fmt
+    //-----------------------------------------------------------------------------
+    VOID DXGFillRenderFormatMultiSample(HWND /*hwndTV*/, HTREEITEM hParent, LPARAM lParam1, LPARAM lParam2, LPARAM lParam3)
+    {
+        UINT iAdapter = LOWORD(lParam1);
+        auto devType = static_cast<D3DDEVTYPE>(HIWORD(lParam1));
+        auto fmtAdapter = static_cast<D3DFORMAT>(LOWORD(lParam2));
+        auto bWindowed = static_cast<BOOL>(HIWORD(lParam2));
+        auto fmtRender = static_cast<D3DFORMAT>(lParam3);
+
+        for (D3DMULTISAMPLE_TYPE msType = D3DMULTISAMPLE_NONE; msType <= D3DMULTISAMPLE_16_SAMPLES; msType = (D3DMULTISAMPLE_TYPE)((UINT)msType + 1))
+        {
+            if (FAILED(PROBE_CALL("IDirect3D9::CheckDeviceMultiSampleType", AdapterName(iAdapter),
+                g_pD3D->CheckDeviceMultiSampleType(iAdapter, devType, fmtRender, bWindowed, msType, nullptr))))
+                continue;
+
+            HTREEITEM hTree = TVAddNodeEx(hParent, MultiSampleTypeName(msType), TRUE, IDI_CAPS, DXGDisplayMultiSample, MAKELPARAM(iAdapter, (UINT)devType), MAKELPARAM(bWindowed, (UINT)msType), (LPARAM)fmtRender);
+            HTREEITEM hTreeDS = TVAddNode(hTree, "Compatible Depth/Stencil Formats", TRUE, IDI_CAPS, nullptr, 0, 0);
+            for (int iFmt = 0; iFmt < NumDSFormats; iFmt++)
+            {
+                D3DFORMAT DSFmt = DSFormatArray[iFmt];
+                if (SUCCEEDED(PROBE_CALL("IDirect3D9::CheckDeviceFormat", AdapterName(iAdapter),
+                    g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter, D3DUSAGE_DEPTHSTENCIL,
+                        D3DRTYPE_SURFACE, DSFmt))))
+                {
+                    if (SUCCEEDED(PROBE_CALL("IDirect3D9::CheckDepthStencilMatch", AdapterName(iAdapter),
+                        g_pD3D->CheckDepthStencilMatch(iAdapter, devType, fmtAdapter, fmtRender, DSFmt))))
+                    {
+                        if (SUCCEEDED(PROBE_CALL("IDirect3D9::CheckDeviceMultiSampleType", AdapterName(iAdapter),
+                            g_pD3D->CheckDeviceMultiSampleType(iAdapter, devType, DSFmt, bWindowed, msType, nullptr))))
+                        {
+                            (void)TVAddNodeEx(hTreeDS, FormatName(DSFmt), FALSE, IDI_CAPS, DXGCheckDSQualityLevels, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)DSFmt, (LPARAM)msType);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: DXGFillRenderFormatCompat()
+    // Desc: Lazy fill of a "Render Format Compatibility" node. Each compatible
+    //       render format is itself added as a lazy node.
+    //
+    // lParam1 is the iAdapter and device type
+    // lParam2 is the adapter fmt
+    // lParam3 is bWindowed
+    //-----------------------------------------------------------------------------
+    VOID DXGFillRenderFormatCompat(HWND /*hwndTV*/, HTREEITEM hParent, LPARAM lParam1, LPARAM lParam2, LPARAM lParam3)
+    {
+        UINT iAdapter = LOWORD(lParam1);
+        auto devType = static_cast<D3DDEVTYPE>(HIWORD(lParam1));
+        auto fmtAdapter = static_cast<D3DFORMAT>(lParam2);
+        auto bWindowed = static_cast<BOOL>(lParam3);
+
+        for (int iFmtRender = 0; iFmtRender < NumFormats; iFmtRender++)
+        {
+            D3DFORMAT fmtRender = AllFormatArray.formats[iFmtRender];
+            if (SUCCEEDED(PROBE_CALL("IDirect3D9::CheckDeviceFormat", AdapterName(iAdapter),
+                g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter, D3DUSAGE_RENDERTARGET, D3DRTYPE_SURFACE, fmtRender)))
+                || (IsBBFmt(fmtRender) && SUCCEEDED(PROBE_CALL("IDirect3D9::CheckDeviceType", AdapterName(iAdapter),
+                    g_pD3D->CheckDeviceType(iAdapter, devType, fmtAdapter, fmtRender, bWindowed)))))
+            {
+                (void)TVAddLazyNode(hParent, FormatName(fmtRender), IDI_CAPS, DXGFillRenderFormatMultiSample,
+                    lParam1, MAKELPARAM(fmtAdapter, bWindowed), (LPARAM)fmtRender);
+            }
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    void CreateD3D9()
+    {
+        g_is9Ex = FALSE;
+
+        if (g_direct3DCreate9Ex)
+        {
+            g_is9Ex = SUCCEEDED(PROBE_CALL("Direct3DCreate9Ex", nullptr,
+                g_direct3DCreate9Ex(D3D_SDK_VERSION, &g_pD3D)));
+        }
+
+        if (!g_is9Ex && g_direct3DCreate9)
+            g_pD3D = PROBE_CALL("Direct3DCreate9", nullptr, g_direct3DCreate9(D3D_SDK_VERSION));
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: GetAdapterLuid()
+    // Desc: Only Direct3D9Ex says which adapter an ordinal is, so without it
+    //       every ordinal reads as zero
+    //-----------------------------------------------------------------------------
+    ADAPTERLUID GetAdapterLuid(UINT iAdapter)
+    {
+        ADAPTERLUID luid = {};
+
+        IDirect3D9Ex* pD3DEx = nullptr;
+        if (g_is9Ex && SUCCEEDED(g_pD3D->QueryInterface(IID_PPV_ARGS(&pD3DEx))))
+        {
+            LUID adapterLuid;
+            if (SUCCEEDED(PROBE_CALL("IDirect3D9Ex::GetAdapterLUID", AdapterName(iAdapter),
+                pD3DEx->GetAdapterLUID(iAdapter, &adapterLuid))))
+            {
+                luid = { adapterLuid.LowPart, adapterLuid.HighPart };
+            }
+            pD3DEx->Release();
+        }
+
+        return luid;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: AddAdapterTree()
+    // Desc: Adds the node of an adapter ordinal and everything below it
+    //-----------------------------------------------------------------------------
+    VOID AddAdapterTree(HTREEITEM hTree, UINT iAdapter)
+    {
+        D3DDEVTYPE deviceTypeArray[] = { D3DDEVTYPE_HAL, D3DDEVTYPE_SW, D3DDEVTYPE_REF };
+        static const TCHAR* deviceNameArray[] = { "HAL", "Software", "Reference" };
+        static const UINT numDeviceTypes = sizeof(deviceTypeArray) / sizeof(deviceTypeArray[0]);
+
+        D3DADAPTER_IDENTIFIER9 identifier;
+        if (FAILED(PROBE_CALL("IDirect3D9::GetAdapterIdentifier", AdapterName(iAdapter),
+            g_pD3D->GetAdapterIdentifier(iAdapter, 0, &identifier))))
+            return;
+
+        g_adapterNames[iAdapter] = identifier.Description;
+
+        HTREEITEM hTree2 = TVAddNode(hTree, identifier.Description, TRUE, IDI_CAPS,
+            DXGDisplayAdapterInfo, iAdapter, 0);
+        (void)TVAddNode(hTree2, "Display Modes", FALSE, IDI_CAPS,
+            DXGDisplayModes, iAdapter, 0);
+        HTREEITEM hTree3 = TVAddNode(hTree2, "D3D Device Types", TRUE, IDI_CAPS,
+            nullptr, 0, 0);
+
+        for (UINT iDevice = 0; iDevice < numDeviceTypes; iDevice++)
+        {
+            D3DDEVTYPE devType = deviceTypeArray[iDevice];
+
+            if (devType == D3DDEVTYPE_SW)
+                continue; // we don't register a SW device, so just skip it
+
+            if (!IsDeviceTypeAvailable(iAdapter, devType))
+                continue;
+
+            // Add caps for each device
+            D3DCAPS9 caps;
+            HRESULT hr = PROBE_CALL("IDirect3D9::GetDeviceCaps", AdapterName(iAdapter),
+                g_pD3D->GetDeviceCaps(iAdapter, devType, &caps));
+            if (FAILED(hr))
+                memset(&caps, 0, sizeof(caps));
+            D3DCAPS9* pCapsCopy = new (std::nothrow) D3DCAPS9;
+            if (!pCapsCopy)
+                continue;
+            *pCapsCopy = caps;
+            HTREEITEM hTree4 = TVAddNode(hTree3, deviceNameArray[iDevice], TRUE, IDI_CAPS, nullptr, 0, 0);
+            AddCapsToTV(hTree4, DXGCapDefs, (LPARAM)pCapsCopy);
+
+            // List adapter formats for each device
+            HTREEITEM hTree5 = TVAddNode(hTree4, "Adapter Formats", TRUE, IDI_CAPS, nullptr, 0, 0);
+            D3DFORMAT fmtAdapter;
+            for (int iFmtAdapter = 0; iFmtAdapter < NumAdapterFormats; iFmtAdapter++)
+            {
+                fmtAdapter = AdapterFormatArray[iFmtAdapter];
+                for (BOOL bWindowed = FALSE; bWindowed < 2; bWindowed++)
+                {
+                    if (!IsAdapterFmtAvailable(iAdapter, devType, fmtAdapter, bWindowed))
+                        continue;
+
+                    TCHAR sz[100];
+                    sprintf_s(sz, sizeof(sz), "%s %s", FormatName(fmtAdapter), bWindowed ? "(Windowed)" : "(Fullscreen)");
+                    HTREEITEM hTree6 = TVAddNode(hTree5, sz, TRUE, IDI_CAPS, nullptr, 0, 0);
+                    TVAddNodeEx(hTree6, "Back Buffer Formats", FALSE, IDI_CAPS, DXGDisplayBackBuffer, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)bWindowed);
+                    TVAddNodeEx(hTree6, "Render Target Formats", FALSE, IDI_CAPS, DXGDisplayRenderTarget, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)0);
+                    TVAddNodeEx(hTree6, "Depth/Stencil Formats", FALSE, IDI_CAPS, DXGDisplayDepthStencil, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)0);
+                    TVAddNodeEx(hTree6, "Plain Surface Formats", FALSE, IDI_CAPS, DXGDisplayPlainSurface, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)0);
+                    TVAddNodeEx(hTree6, "Texture Formats", FALSE, IDI_CAPS, DXGDisplayResource, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)D3DRTYPE_TEXTURE);
+                    TVAddNodeEx(hTree6, "Cube Texture Formats", FALSE, IDI_CAPS, DXGDisplayResource, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)D3DRTYPE_CUBETEXTURE);
+                    TVAddNodeEx(hTree6, "Volume Texture Formats", FALSE, IDI_CAPS, DXGDisplayResource, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)D3DRTYPE_VOLUMETEXTURE);
+                    // Render format compatibility is tens of thousands of driver calls
+                    // per adapter, so only probe it when the user expands it
+                    (void)TVAddLazyNode(hTree6, "Render Format Compatibility", IDI_CAPS,
+                        DXGFillRenderFormatCompat, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)bWindowed);
+                }
+            }
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Adapter nodes are in ordinal order, which is each node's lParam1
+    int CALLBACK CompareAdapterNodes(LPARAM lParam1, LPARAM lParam2, LPARAM /*lParamSort*/)
+    {
+        auto pni1 = reinterpret_cast<const NODEINFO*>(lParam1);
+        auto pni2 = reinterpret_cast<const NODEINFO*>(lParam2);
+        UINT iAdapter1 = pni1 ? static_cast<UINT>(pni1->lParam1) : 0;
+        UINT iAdapter2 = pni2 ? static_cast<UINT>(pni2->lParam1) : 0;
+        return (iAdapter1 < iAdapter2) ? -1 : (iAdapter1 > iAdapter2) ? 1 : 0;
+    }
 }
 
 
@@ -1555,21 +1770,13 @@ namespace
 //-----------------------------------------------------------------------------
 VOID DXG_Init()
 {
-    g_is9Ex = FALSE;
-
     g_hInstD3D = LoadLibraryEx("d3d9.dll", nullptr, LOAD_LIBRARY_SEARCH_SYSTEM32);
     if (g_hInstD3D)
     {
         g_direct3DCreate9 = reinterpret_cast<LPDIRECT3D9CREATE9>(GetProcAddress(g_hInstD3D, "Direct3DCreate9"));
         g_direct3DCreate9Ex = reinterpret_cast<LPDIRECT3D9CREATE9EX>(GetProcAddress(g_hInstD3D, "Direct3DCreate9Ex"));
 
-        if (g_direct3DCreate9Ex)
-        {
-            g_is9Ex = SUCCEEDED(g_direct3DCreate9Ex(D3D_SDK_VERSION, &g_pD3D));
-        }
-
-        if (!g_is9Ex && g_direct3DCreate9)
-            g_pD3D = g_direct3DCreate9(D3D_SDK_VERSION);
+        CreateD3D9();
     }
 }
 
@@ -1579,119 +1786,107 @@ VOID DXG_Init()
 //-----------------------------------------------------------------------------
 VOID DXG_FillTree(HWND hwndTV)
 {
-    HRESULT hr;
-    D3DDEVTYPE deviceTypeArray[] = { D3DDEVTYPE_HAL, D3DDEVTYPE_SW, D3DDEVTYPE_REF };
-    D3DDEVTYPE devType;
-    UINT iDevice;
-    D3DCAPS9 caps;
-    D3DCAPS9* pCapsCopy;
-
-    static const TCHAR* deviceNameArray[] = { "HAL", "Software", "Reference" };
-    static const UINT numDeviceTypes = sizeof(deviceTypeArray) / sizeof(deviceTypeArray[0]);
+    PROBESCOPE probeScope(PROBE_PHASE, "DXG_FillTree", nullptr);
 
     if (!g_pD3D)
         return;
 
+#ifdef EXTRA_DEBUG
+    LARGE_INTEGER qpcStart;
+    QueryPerformanceCounter(&qpcStart);
+#endif
+
     HTREEITEM hTree = TVAddNode(TVI_ROOT, "Direct3D9 Devices", TRUE, IDI_DIRECTX,
         nullptr, 0, 0);
 
-    UINT numAdapters = g_pD3D->GetAdapterCount();
+    UINT numAdapters = PROBE_CALL("IDirect3D9::GetAdapterCount", nullptr, g_pD3D->GetAdapterCount());
+    g_adapterNames.resize(numAdapters);
+    g_adapterLuids.resize(numAdapters);
     for (UINT iAdapter = 0; iAdapter < numAdapters; iAdapter++)
     {
-        D3DADAPTER_IDENTIFIER9 identifier;
-        if (SUCCEEDED(g_pD3D->GetAdapterIdentifier(iAdapter, 0, &identifier)))
-        {
-            HTREEITEM hTree2 = TVAddNode(hTree, identifier.Description, TRUE, IDI_CAPS,
-                DXGDisplayAdapterInfo, iAdapter, 0);
-            (void)TVAddNode(hTree2, "Display Modes", FALSE, IDI_CAPS,
-                DXGDisplayModes, iAdapter, 0);
-            HTREEITEM hTree3 = TVAddNode(hTree2, "D3D Device Types", TRUE, IDI_CAPS,
-                nullptr, 0, 0);
-
-            for (iDevice = 0; iDevice < numDeviceTypes; iDevice++)
-            {
-                devType = deviceTypeArray[iDevice];
+        g_adapterLuids[iAdapter] = GetAdapterLuid(iAdapter);
+        AddAdapterTree(hTree, iAdapter);
+    }
+    g_hTreeD3D9 = hTree;
 
-                if (devType == D3DDEVTYPE_SW)
-                    continue; // we don't register a SW device, so just skip it
+    if (g_bEagerFill)
+        TVExpandAll(hwndTV, hTree);
 
-                if (!IsDeviceTypeAvailable(iAdapter, devType))
-                    continue;
+#ifdef EXTRA_DEBUG
+    {
+        LARGE_INTEGER qpcEnd, qpcFreq;
+        QueryPerformanceCounter(&qpcEnd);
+        QueryPerformanceFrequency(&qpcFreq);
+
+        char buff[128];
+        sprintf_s(buff, "DXG_FillTree: %u nodes in %.2f ms\n", TVCountNodes(hwndTV),
+            double(qpcEnd.QuadPart - qpcStart.QuadPart) * 1000.0 / double(qpcFreq.QuadPart));
+        OutputDebugStringA(buff);
+    }
+#endif
 
-                // Add caps for each device
-                hr = g_pD3D->GetDeviceCaps(iAdapter, devType, &caps);
-                if (FAILED(hr))
-                    memset(&caps, 0, sizeof(caps));
-                pCapsCopy = new (std::nothrow) D3DCAPS9;
-                if (!pCapsCopy)
-                    continue;
-                *pCapsCopy = caps;
-                HTREEITEM hTree4 = TVAddNode(hTree3, deviceNameArray[iDevice], TRUE, IDI_CAPS, nullptr, 0, 0);
-                AddCapsToTV(hTree4, DXGCapDefs, (LPARAM)pCapsCopy);
-
-                // List adapter formats for each device
-                HTREEITEM hTree5 = TVAddNode(hTree4, "Adapter Formats", TRUE, IDI_CAPS, nullptr, 0, 0);
-                D3DFORMAT fmtAdapter;
-                for (int iFmtAdapter = 0; iFmtAdapter < NumAdapterFormats; iFmtAdapter++)
-                {
-                    fmtAdapter = AdapterFormatArray[iFmtAdapter];
-                    for (BOOL bWindowed = FALSE; bWindowed < 2; bWindowed++)
-                    {
-                        if (!IsAdapterFmtAvailable(iAdapter, devType, fmtAdapter, bWindowed))
-                            continue;
+    TreeView_Expand(hwndTV, hTree, TVE_EXPAND);
+}
 
-                        TCHAR sz[100];
-                        sprintf_s(sz, sizeof(sz), "%s %s", FormatName(fmtAdapter), bWindowed ? "(Windowed)" : "(Fullscreen)");
-                        HTREEITEM hTree6 = TVAddNode(hTree5, sz, TRUE, IDI_CAPS, nullptr, 0, 0);
-                        TVAddNodeEx(hTree6, "Back Buffer Formats", FALSE, IDI_CAPS, DXGDisplayBackBuffer, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)bWindowed);
-                        TVAddNodeEx(hTree6, "Render Target Formats", FALSE, IDI_CAPS, DXGDisplayRenderTarget, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)0);
-                        TVAddNodeEx(hTree6, "Depth/Stencil Formats", FALSE, IDI_CAPS, DXGDisplayDepthStencil, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)0);
-                        TVAddNodeEx(hTree6, "Plain Surface Formats", FALSE, IDI_CAPS, DXGDisplayPlainSurface, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)0);
-                        TVAddNodeEx(hTree6, "Texture Formats", FALSE, IDI_CAPS, DXGDisplayResource, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)D3DRTYPE_TEXTURE);
-                        TVAddNodeEx(hTree6, "Cube Texture Formats", FALSE, IDI_CAPS, DXGDisplayResource, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)D3DRTYPE_CUBETEXTURE);
-                        TVAddNodeEx(hTree6, "Volume Texture Formats", FALSE, IDI_CAPS, DXGDisplayResource, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)fmtAdapter, (LPARAM)D3DRTYPE_VOLUMETEXTURE);
-                        HTREEITEM hTree7 = TVAddNode(hTree6, "Render Format Compatibility", TRUE, IDI_CAPS, nullptr, 0, 0);
-                        D3DFORMAT fmtRender;
-                        for (int iFmtRender = 0; iFmtRender < NumFormats; iFmtRender++)
-                        {
-                            fmtRender = AllFormatArray[iFmtRender];
-                            if (SUCCEEDED(g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter, D3DUSAGE_RENDERTARGET, D3DRTYPE_SURFACE, fmtRender))
-                                || (IsBBFmt(fmtRender) && SUCCEEDED(g_pD3D->CheckDeviceType(iAdapter, devType, fmtAdapter, fmtRender, bWindowed))))
-                            {
-                                HTREEITEM hTree8 = TVAddNode(hTree7, FormatName(fmtRender), TRUE, IDI_CAPS, nullptr, 0, 0);
-                                for (D3DMULTISAMPLE_TYPE msType = D3DMULTISAMPLE_NONE; msType <= D3DMULTISAMPLE_16_SAMPLES; msType = (D3DMULTISAMPLE_TYPE)((UINT)msType + 1))
-                                {
-                                    if (SUCCEEDED(g_pD3D->CheckDeviceMultiSampleType(iAdapter, devType, fmtRender, bWindowed, msType, nullptr)))
-                                    {
-                                        HTREEITEM hTree9 = TVAddNodeEx(hTree8, MultiSampleTypeName(msType), TRUE, IDI_CAPS, DXGDisplayMultiSample, MAKELPARAM(iAdapter, (UINT)devType), MAKELPARAM(bWindowed, (UINT)msType), (LPARAM)fmtRender);
-                                        HTREEITEM hTree10 = TVAddNode(hTree9, "Compatible Depth/Stencil Formats", TRUE, IDI_CAPS, nullptr, 0, 0);
-                                        D3DFORMAT DSFmt;
-                                        for (int iFmt = 0; iFmt < NumDSFormats; iFmt++)
-                                        {
-                                            DSFmt = DSFormatArray[iFmt];
-                                            if (SUCCEEDED(g_pD3D->CheckDeviceFormat(iAdapter, devType, fmtAdapter, D3DUSAGE_DEPTHSTENCIL,
-                                                D3DRTYPE_SURFACE, DSFmt)))
-                                            {
-                                                if (SUCCEEDED(g_pD3D->CheckDepthStencilMatch(iAdapter, devType, fmtAdapter, fmtRender, DSFmt)))
-                                                {
-                                                    if (SUCCEEDED(g_pD3D->CheckDeviceMultiSampleType(iAdapter, devType, DSFmt, bWindowed, msType, nullptr)))
-                                                    {
-                                                        (void)TVAddNodeEx(hTree10, FormatName(DSFmt), FALSE, IDI_CAPS, DXGCheckDSQualityLevels, MAKELPARAM(iAdapter, (UINT)devType), (LPARAM)DSFmt, (LPARAM)msType);
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+
+//-----------------------------------------------------------------------------
+// Name: DXG_UpdateAdapters()
+// Desc: Replaces the nodes of the adapters a device change removed or
+//       updated, and adds those of new ones. Ordinals shift as adapters come
+//       and go, so an adapter is only kept if it's still at the same ordinal.
+//-----------------------------------------------------------------------------
+VOID DXG_UpdateAdapters(HWND hwndTV, const std::vector<ADAPTERCHANGE>& changes)
+{
+    if (!hwndTV || !g_hTreeD3D9 || changes.empty())
+        return;
+
+    // An IDirect3D9 goes on enumerating the adapters there were when it was created
+    SAFE_RELEASE(g_pD3D);
+    CreateD3D9();
+
+    UINT numAdapters = g_pD3D ? PROBE_CALL("IDirect3D9::GetAdapterCount", nullptr, g_pD3D->GetAdapterCount()) : 0;
+    std::vector<ADAPTERLUID> luids(numAdapters);
+    for (UINT iAdapter = 0; iAdapter < numAdapters; iAdapter++)
+        luids[iAdapter] = GetAdapterLuid(iAdapter);
+
+    std::vector<BOOL> kept(numAdapters, FALSE);
+    HTREEITEM hNext = nullptr;
+    for (HTREEITEM hChild = TreeView_GetChild(hwndTV, g_hTreeD3D9); hChild; hChild = hNext)
+    {
+        hNext = TreeView_GetNextSibling(hwndTV, hChild);
+
+        TV_ITEM tvi = {};
+        tvi.mask = TVIF_PARAM;
+        tvi.hItem = hChild;
+        auto pni = TreeView_GetItem(hwndTV, &tvi) ? reinterpret_cast<const NODEINFO*>(tvi.lParam) : nullptr;
+        UINT iAdapter = pni ? static_cast<UINT>(pni->lParam1) : UINT_MAX;
+
+        // Without Direct3D9Ex there's no telling which adapter is which, so
+        // they're all redone
+        if (g_is9Ex && iAdapter < numAdapters && iAdapter < g_adapterLuids.size()
+            && IsSameLuid(g_adapterLuids[iAdapter], luids[iAdapter])
+            && !IsAdapterChanged(changes, luids[iAdapter]))
+        {
+            kept[iAdapter] = TRUE;
+        }
+        else
+        {
+            TVDeleteNode(hwndTV, hChild);
         }
     }
 
-    TreeView_Expand(hwndTV, hTree, TVE_EXPAND);
+    g_adapterLuids = std::move(luids);
+    g_adapterNames.resize(numAdapters);
+    for (UINT iAdapter = 0; iAdapter < numAdapters; iAdapter++)
+    {
+        if (!kept[iAdapter])
+            AddAdapterTree(g_hTreeD3D9, iAdapter);
+    }
+
+    TVSORTCB sort = {};
+    sort.hParent = g_hTreeD3D9;
+    sort.lpfnCompare = CompareAdapterNodes;
+    TreeView_SortChildrenCB(hwndTV, &sort, FALSE);
 }
 
 
@@ -1702,6 +1897,9 @@ VOID DXG_FillTree(HWND hwndTV)
 VOID DXG_CleanUp()
 {
     SAFE_RELEASE(g_pD3D);
+    g_adapterNames.clear();
+    g_adapterLuids.clear();
+    g_hTreeD3D9 = nullptr;
 
     if (g_hInstD3D)
     {
@@ -1714,7 +1912,43 @@ VOID DXG_CleanUp()
 }
 
 
+//-----------------------------------------------------------------------------
+// Name: DXG_InitWith()
+// Desc: Probes pD3D, such as dxcapsbench's table-driven stub, instead of what
+//       d3d9.dll creates. Takes over the caller's reference.
+//-----------------------------------------------------------------------------
+VOID DXG_InitWith(IDirect3D9* pD3D)
+{
+    DXG_CleanUp();
+
+    g_pD3D = pD3D;
+    g_is9Ex = FALSE;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXG_SetEagerFill()
+// Desc: Whether DXG_FillTree probes every "Render Format Compatibility"
+//       subtree up front (the old behavior) rather than on first expand, for
+//       comparing the startup cost of the two
+//-----------------------------------------------------------------------------
+VOID DXG_SetEagerFill(BOOL bEager)
+{
+    g_bEagerFill = bEager;
+}
+
+
 BOOL DXG_Is9Ex()
 {
     return g_is9Ex;
 }
+
+
+//-----------------------------------------------------------------------------
+// Name: DXG_FindFormat()
+// Desc: Looks up a D3D9 format by name, with or without the D3DFMT_ prefix
+//-----------------------------------------------------------------------------
+const FORMATDESC* DXG_FindFormat(const char* strName)
+{
+    return FindFormatByName(c_d3d9FormatTable, c_d3d9FormatHash, strName);
+}
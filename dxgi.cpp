@@ -9,6 +9,9 @@
 // https://go.microsoft.com/fwlink/?linkid=2136896
 //-----------------------------------------------------------------------------
 #include "dxview.h"
+#include "dxfeature.h"
+#include "dxformat.h"
+#include "dxtrace.h"
 
 #include <D3Dcommon.h>
 #include <dxgi1_5.h>
@@ -139,121 +142,171 @@ namespace
         DXGI_FORMAT_B8G8R8A8_UNORM
     };
 
-    const DXGI_FORMAT g_cfsMSAA_10[] =
+#define DXGIFMT(name, channels, bpp, bw, bh, fmtClass, flags, typeless) \
+    { static_cast<uint32_t>(DXGI_FORMAT_##name), "DXGI_FORMAT_" #name, channels, bpp, bw, bh, \
+      FORMATCLASS_##fmtClass, flags, static_cast<uint32_t>(DXGI_FORMAT_##typeless) }
+
+    // In enum order, which the format lists below keep
+    constexpr FORMATDESC c_dxgiFormats[] =
     {
-        DXGI_FORMAT_R32G32B32A32_FLOAT,
-        DXGI_FORMAT_R32G32B32A32_UINT,
-        DXGI_FORMAT_R32G32B32A32_SINT,
-        DXGI_FORMAT_R32G32B32_FLOAT,
-        DXGI_FORMAT_R32G32B32_UINT,
-        DXGI_FORMAT_R32G32B32_SINT,
-        DXGI_FORMAT_R16G16B16A16_FLOAT,
-        DXGI_FORMAT_R16G16B16A16_UNORM,
-        DXGI_FORMAT_R16G16B16A16_UINT,
-        DXGI_FORMAT_R16G16B16A16_SNORM,
-        DXGI_FORMAT_R16G16B16A16_SINT,
-        DXGI_FORMAT_R32G32_FLOAT,
-        DXGI_FORMAT_R32G32_UINT,
-        DXGI_FORMAT_R32G32_SINT,
-        DXGI_FORMAT_D32_FLOAT_S8X24_UINT,
-        DXGI_FORMAT_R10G10B10A2_UNORM,
-        DXGI_FORMAT_R10G10B10A2_UINT,
-        DXGI_FORMAT_R11G11B10_FLOAT,
-        DXGI_FORMAT_R8G8B8A8_UNORM,
-        DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
-        DXGI_FORMAT_R8G8B8A8_UINT,
-        DXGI_FORMAT_R8G8B8A8_SNORM,
-        DXGI_FORMAT_R8G8B8A8_SINT,
-        DXGI_FORMAT_R16G16_FLOAT,
-        DXGI_FORMAT_R16G16_UNORM,
-        DXGI_FORMAT_R16G16_UINT,
-        DXGI_FORMAT_R16G16_SNORM,
-        DXGI_FORMAT_R16G16_SINT,
-        DXGI_FORMAT_D32_FLOAT,
-        DXGI_FORMAT_R32_FLOAT,
-        DXGI_FORMAT_R32_UINT,
-        DXGI_FORMAT_R32_SINT,
-        DXGI_FORMAT_D24_UNORM_S8_UINT,
-        DXGI_FORMAT_R8G8_UNORM,
-        DXGI_FORMAT_R8G8_UINT,
-        DXGI_FORMAT_R8G8_SNORM,
-        DXGI_FORMAT_R8G8_SINT,
-        DXGI_FORMAT_R16_FLOAT,
-        DXGI_FORMAT_D16_UNORM,
-        DXGI_FORMAT_R16_UNORM,
-        DXGI_FORMAT_R16_UINT,
-        DXGI_FORMAT_R16_SNORM,
-        DXGI_FORMAT_R16_SINT,
-        DXGI_FORMAT_R8_UNORM,
-        DXGI_FORMAT_R8_UINT,
-        DXGI_FORMAT_R8_SNORM,
-        DXGI_FORMAT_R8_SINT,
-        DXGI_FORMAT_A8_UNORM
+        DXGIFMT(UNKNOWN,                    "",       0, 1, 1, UNKNOWN,      0,                        UNKNOWN),
+        DXGIFMT(R32G32B32A32_TYPELESS,      "RGBA", 128, 1, 1, COLOR,        FMTF_TYPELESS,            R32G32B32A32_TYPELESS),
+        DXGIFMT(R32G32B32A32_FLOAT,         "RGBA", 128, 1, 1, COLOR,        0,                        R32G32B32A32_TYPELESS),
+        DXGIFMT(R32G32B32A32_UINT,          "RGBA", 128, 1, 1, COLOR,        0,                        R32G32B32A32_TYPELESS),
+        DXGIFMT(R32G32B32A32_SINT,          "RGBA", 128, 1, 1, COLOR,        0,                        R32G32B32A32_TYPELESS),
+        DXGIFMT(R32G32B32_TYPELESS,         "RGB",   96, 1, 1, COLOR,        FMTF_TYPELESS,            R32G32B32_TYPELESS),
+        DXGIFMT(R32G32B32_FLOAT,            "RGB",   96, 1, 1, COLOR,        0,                        R32G32B32_TYPELESS),
+        DXGIFMT(R32G32B32_UINT,             "RGB",   96, 1, 1, COLOR,        0,                        R32G32B32_TYPELESS),
+        DXGIFMT(R32G32B32_SINT,             "RGB",   96, 1, 1, COLOR,        0,                        R32G32B32_TYPELESS),
+        DXGIFMT(R16G16B16A16_TYPELESS,      "RGBA",  64, 1, 1, COLOR,        FMTF_TYPELESS,            R16G16B16A16_TYPELESS),
+        DXGIFMT(R16G16B16A16_FLOAT,         "RGBA",  64, 1, 1, COLOR,        0,                        R16G16B16A16_TYPELESS),
+        DXGIFMT(R16G16B16A16_UNORM,         "RGBA",  64, 1, 1, COLOR,        0,                        R16G16B16A16_TYPELESS),
+        DXGIFMT(R16G16B16A16_UINT,          "RGBA",  64, 1, 1, COLOR,        0,                        R16G16B16A16_TYPELESS),
+        DXGIFMT(R16G16B16A16_SNORM,         "RGBA",  64, 1, 1, COLOR,        0,                        R16G16B16A16_TYPELESS),
+        DXGIFMT(R16G16B16A16_SINT,          "RGBA",  64, 1, 1, COLOR,        0,                        R16G16B16A16_TYPELESS),
+        DXGIFMT(R32G32_TYPELESS,            "RG",    64, 1, 1, COLOR,        FMTF_TYPELESS,            R32G32_TYPELESS),
+        DXGIFMT(R32G32_FLOAT,               "RG",    64, 1, 1, COLOR,        0,                        R32G32_TYPELESS),
+        DXGIFMT(R32G32_UINT,                "RG",    64, 1, 1, COLOR,        0,                        R32G32_TYPELESS),
+        DXGIFMT(R32G32_SINT,                "RG",    64, 1, 1, COLOR,        0,                        R32G32_TYPELESS),
+        DXGIFMT(R32G8X24_TYPELESS,          "RGX",   64, 1, 1, COLOR,        FMTF_TYPELESS,            R32G8X24_TYPELESS),
+        DXGIFMT(D32_FLOAT_S8X24_UINT,       "DSX",   64, 1, 1, DEPTHSTENCIL, FMTF_STENCIL,             R32G8X24_TYPELESS),
+        DXGIFMT(R32_FLOAT_X8X24_TYPELESS,   "RX",    64, 1, 1, COLOR,        FMTF_TYPELESS,            R32G8X24_TYPELESS),
+        DXGIFMT(X32_TYPELESS_G8X24_UINT,    "XGX",   64, 1, 1, COLOR,        FMTF_TYPELESS,            R32G8X24_TYPELESS),
+        DXGIFMT(R10G10B10A2_TYPELESS,       "RGBA",  32, 1, 1, COLOR,        FMTF_TYPELESS,            R10G10B10A2_TYPELESS),
+        DXGIFMT(R10G10B10A2_UNORM,          "RGBA",  32, 1, 1, COLOR,        0,                        R10G10B10A2_TYPELESS),
+        DXGIFMT(R10G10B10A2_UINT,           "RGBA",  32, 1, 1, COLOR,        0,                        R10G10B10A2_TYPELESS),
+        DXGIFMT(R11G11B10_FLOAT,            "RGB",   32, 1, 1, COLOR,        0,                        UNKNOWN),
+        DXGIFMT(R8G8B8A8_TYPELESS,          "RGBA",  32, 1, 1, COLOR,        FMTF_TYPELESS,            R8G8B8A8_TYPELESS),
+        DXGIFMT(R8G8B8A8_UNORM,             "RGBA",  32, 1, 1, COLOR,        0,                        R8G8B8A8_TYPELESS),
+        DXGIFMT(R8G8B8A8_UNORM_SRGB,        "RGBA",  32, 1, 1, COLOR,        FMTF_SRGB,                R8G8B8A8_TYPELESS),
+        DXGIFMT(R8G8B8A8_UINT,              "RGBA",  32, 1, 1, COLOR,        0,                        R8G8B8A8_TYPELESS),
+        DXGIFMT(R8G8B8A8_SNORM,             "RGBA",  32, 1, 1, COLOR,        0,                        R8G8B8A8_TYPELESS),
+        DXGIFMT(R8G8B8A8_SINT,              "RGBA",  32, 1, 1, COLOR,        0,                        R8G8B8A8_TYPELESS),
+        DXGIFMT(R16G16_TYPELESS,            "RG",    32, 1, 1, COLOR,        FMTF_TYPELESS,            R16G16_TYPELESS),
+        DXGIFMT(R16G16_FLOAT,               "RG",    32, 1, 1, COLOR,        0,                        R16G16_TYPELESS),
+        DXGIFMT(R16G16_UNORM,               "RG",    32, 1, 1, COLOR,        0,                        R16G16_TYPELESS),
+        DXGIFMT(R16G16_UINT,                "RG",    32, 1, 1, COLOR,        0,                        R16G16_TYPELESS),
+        DXGIFMT(R16G16_SNORM,               "RG",    32, 1, 1, COLOR,        0,                        R16G16_TYPELESS),
+        DXGIFMT(R16G16_SINT,                "RG",    32, 1, 1, COLOR,        0,                        R16G16_TYPELESS),
+        DXGIFMT(R32_TYPELESS,               "R",     32, 1, 1, COLOR,        FMTF_TYPELESS,            R32_TYPELESS),
+        DXGIFMT(D32_FLOAT,                  "D",     32, 1, 1, DEPTHSTENCIL, 0,                        R32_TYPELESS),
+        DXGIFMT(R32_FLOAT,                  "R",     32, 1, 1, COLOR,        0,                        R32_TYPELESS),
+        DXGIFMT(R32_UINT,                   "R",     32, 1, 1, COLOR,        0,                        R32_TYPELESS),
+        DXGIFMT(R32_SINT,                   "R",     32, 1, 1, COLOR,        0,                        R32_TYPELESS),
+        DXGIFMT(R24G8_TYPELESS,             "RG",    32, 1, 1, COLOR,        FMTF_TYPELESS,            R24G8_TYPELESS),
+        DXGIFMT(D24_UNORM_S8_UINT,          "DS",    32, 1, 1, DEPTHSTENCIL, FMTF_STENCIL,             R24G8_TYPELESS),
+        DXGIFMT(R24_UNORM_X8_TYPELESS,      "RX",    32, 1, 1, COLOR,        FMTF_TYPELESS,            R24G8_TYPELESS),
+        DXGIFMT(X24_TYPELESS_G8_UINT,       "XG",    32, 1, 1, COLOR,        FMTF_TYPELESS,            R24G8_TYPELESS),
+        DXGIFMT(R8G8_TYPELESS,              "RG",    16, 1, 1, COLOR,        FMTF_TYPELESS,            R8G8_TYPELESS),
+        DXGIFMT(R8G8_UNORM,                 "RG",    16, 1, 1, COLOR,        0,                        R8G8_TYPELESS),
+        DXGIFMT(R8G8_UINT,                  "RG",    16, 1, 1, COLOR,        0,                        R8G8_TYPELESS),
+        DXGIFMT(R8G8_SNORM,                 "RG",    16, 1, 1, COLOR,        0,                        R8G8_TYPELESS),
+        DXGIFMT(R8G8_SINT,                  "RG",    16, 1, 1, COLOR,        0,                        R8G8_TYPELESS),
+        DXGIFMT(R16_TYPELESS,               "R",     16, 1, 1, COLOR,        FMTF_TYPELESS,            R16_TYPELESS),
+        DXGIFMT(R16_FLOAT,                  "R",     16, 1, 1, COLOR,        0,                        R16_TYPELESS),
+        DXGIFMT(D16_UNORM,                  "D",     16, 1, 1, DEPTHSTENCIL, 0,                        R16_TYPELESS),
+        DXGIFMT(R16_UNORM,                  "R",     16, 1, 1, COLOR,        0,                        R16_TYPELESS),
+        DXGIFMT(R16_UINT,                   "R",     16, 1, 1, COLOR,        0,                        R16_TYPELESS),
+        DXGIFMT(R16_SNORM,                  "R",     16, 1, 1, COLOR,        0,                        R16_TYPELESS),
+        DXGIFMT(R16_SINT,                   "R",     16, 1, 1, COLOR,        0,                        R16_TYPELESS),
+        DXGIFMT(R8_TYPELESS,                "R",      8, 1, 1, COLOR,        FMTF_TYPELESS,            R8_TYPELESS),
+        DXGIFMT(R8_UNORM,                   "R",      8, 1, 1, COLOR,        0,                        R8_TYPELESS),
+        DXGIFMT(R8_UINT,                    "R",      8, 1, 1, COLOR,        0,                        R8_TYPELESS),
+        DXGIFMT(R8_SNORM,                   "R",      8, 1, 1, COLOR,        0,                        R8_TYPELESS),
+        DXGIFMT(R8_SINT,                    "R",      8, 1, 1, COLOR,        0,                        R8_TYPELESS),
+        DXGIFMT(A8_UNORM,                   "A",      8, 1, 1, COLOR,        0,                        UNKNOWN),
+        DXGIFMT(R1_UNORM,                   "R",      1, 1, 1, PACKED,       0,                        UNKNOWN),
+        DXGIFMT(R9G9B9E5_SHAREDEXP,         "RGBE",  32, 1, 1, PACKED,       0,                        UNKNOWN),
+        DXGIFMT(R8G8_B8G8_UNORM,            "RGBG",  16, 2, 1, PACKED,       0,                        UNKNOWN),
+        DXGIFMT(G8R8_G8B8_UNORM,            "GRGB",  16, 2, 1, PACKED,       0,                        UNKNOWN),
+        DXGIFMT(BC1_TYPELESS,               "RGBA",   4, 4, 4, COMPRESSED,   FMTF_TYPELESS,            BC1_TYPELESS),
+        DXGIFMT(BC1_UNORM,                  "RGBA",   4, 4, 4, COMPRESSED,   0,                        BC1_TYPELESS),
+        DXGIFMT(BC1_UNORM_SRGB,             "RGBA",   4, 4, 4, COMPRESSED,   FMTF_SRGB,                BC1_TYPELESS),
+        DXGIFMT(BC2_TYPELESS,               "RGBA",   8, 4, 4, COMPRESSED,   FMTF_TYPELESS,            BC2_TYPELESS),
+        DXGIFMT(BC2_UNORM,                  "RGBA",   8, 4, 4, COMPRESSED,   0,                        BC2_TYPELESS),
+        DXGIFMT(BC2_UNORM_SRGB,             "RGBA",   8, 4, 4, COMPRESSED,   FMTF_SRGB,                BC2_TYPELESS),
+        DXGIFMT(BC3_TYPELESS,               "RGBA",   8, 4, 4, COMPRESSED,   FMTF_TYPELESS,            BC3_TYPELESS),
+        DXGIFMT(BC3_UNORM,                  "RGBA",   8, 4, 4, COMPRESSED,   0,                        BC3_TYPELESS),
+        DXGIFMT(BC3_UNORM_SRGB,             "RGBA",   8, 4, 4, COMPRESSED,   FMTF_SRGB,                BC3_TYPELESS),
+        DXGIFMT(BC4_TYPELESS,               "R",      4, 4, 4, COMPRESSED,   FMTF_TYPELESS,            BC4_TYPELESS),
+        DXGIFMT(BC4_UNORM,                  "R",      4, 4, 4, COMPRESSED,   0,                        BC4_TYPELESS),
+        DXGIFMT(BC4_SNORM,                  "R",      4, 4, 4, COMPRESSED,   0,                        BC4_TYPELESS),
+        DXGIFMT(BC5_TYPELESS,               "RG",     8, 4, 4, COMPRESSED,   FMTF_TYPELESS,            BC5_TYPELESS),
+        DXGIFMT(BC5_UNORM,                  "RG",     8, 4, 4, COMPRESSED,   0,                        BC5_TYPELESS),
+        DXGIFMT(BC5_SNORM,                  "RG",     8, 4, 4, COMPRESSED,   0,                        BC5_TYPELESS),
+        DXGIFMT(B5G6R5_UNORM,               "BGR",   16, 1, 1, COLOR,        FMTF_BGR,                 UNKNOWN),
+        DXGIFMT(B5G5R5A1_UNORM,             "BGRA",  16, 1, 1, COLOR,        FMTF_BGR,                 UNKNOWN),
+        DXGIFMT(B8G8R8A8_UNORM,             "BGRA",  32, 1, 1, COLOR,        FMTF_BGR,                 B8G8R8A8_TYPELESS),
+        DXGIFMT(B8G8R8X8_UNORM,             "BGRX",  32, 1, 1, COLOR,        FMTF_BGR,                 B8G8R8X8_TYPELESS),
+        DXGIFMT(R10G10B10_XR_BIAS_A2_UNORM, "RGBA",  32, 1, 1, COLOR,        FMTF_DISPLAY,             UNKNOWN),
+        DXGIFMT(B8G8R8A8_TYPELESS,          "BGRA",  32, 1, 1, COLOR,        FMTF_TYPELESS | FMTF_BGR, B8G8R8A8_TYPELESS),
+        DXGIFMT(B8G8R8A8_UNORM_SRGB,        "BGRA",  32, 1, 1, COLOR,        FMTF_SRGB | FMTF_BGR,     B8G8R8A8_TYPELESS),
+        DXGIFMT(B8G8R8X8_TYPELESS,          "BGRX",  32, 1, 1, COLOR,        FMTF_TYPELESS | FMTF_BGR, B8G8R8X8_TYPELESS),
+        DXGIFMT(B8G8R8X8_UNORM_SRGB,        "BGRX",  32, 1, 1, COLOR,        FMTF_SRGB | FMTF_BGR,     B8G8R8X8_TYPELESS),
+        DXGIFMT(BC6H_TYPELESS,              "RGB",    8, 4, 4, COMPRESSED,   FMTF_TYPELESS,            BC6H_TYPELESS),
+        DXGIFMT(BC6H_UF16,                  "RGB",    8, 4, 4, COMPRESSED,   0,                        BC6H_TYPELESS),
+        DXGIFMT(BC6H_SF16,                  "RGB",    8, 4, 4, COMPRESSED,   0,                        BC6H_TYPELESS),
+        DXGIFMT(BC7_TYPELESS,               "RGBA",   8, 4, 4, COMPRESSED,   FMTF_TYPELESS,            BC7_TYPELESS),
+        DXGIFMT(BC7_UNORM,                  "RGBA",   8, 4, 4, COMPRESSED,   0,                        BC7_TYPELESS),
+        DXGIFMT(BC7_UNORM_SRGB,             "RGBA",   8, 4, 4, COMPRESSED,   FMTF_SRGB,                BC7_TYPELESS),
+        DXGIFMT(AYUV,                       "VUYA",  32, 1, 1, VIDEO,        0,                        UNKNOWN),
+        DXGIFMT(Y410,                       "UYVA",  32, 1, 1, VIDEO,        0,                        UNKNOWN),
+        DXGIFMT(Y416,                       "UYVA",  64, 1, 1, VIDEO,        0,                        UNKNOWN),
+        DXGIFMT(NV12,                       "YUV",   12, 2, 2, VIDEO,        FMTF_PLANAR,              UNKNOWN),
+        DXGIFMT(P010,                       "YUV",   24, 2, 2, VIDEO,        FMTF_PLANAR,              UNKNOWN),
+        DXGIFMT(P016,                       "YUV",   24, 2, 2, VIDEO,        FMTF_PLANAR,              UNKNOWN),
+        DXGIFMT(420_OPAQUE,                 "YUV",   12, 2, 2, VIDEO,        FMTF_PLANAR,              UNKNOWN),
+        DXGIFMT(YUY2,                       "YUYV",  16, 2, 1, VIDEO,        0,                        UNKNOWN),
+        DXGIFMT(Y210,                       "YUYV",  32, 2, 1, VIDEO,        0,                        UNKNOWN),
+        DXGIFMT(Y216,                       "YUYV",  32, 2, 1, VIDEO,        0,                        UNKNOWN),
+        DXGIFMT(NV11,                       "YUV",   12, 4, 1, VIDEO,        FMTF_PLANAR,              UNKNOWN),
+        DXGIFMT(AI44,                       "AI",     8, 1, 1, VIDEO,        FMTF_PALETTIZED,          UNKNOWN),
+        DXGIFMT(IA44,                       "IA",     8, 1, 1, VIDEO,        FMTF_PALETTIZED,          UNKNOWN),
+        DXGIFMT(P8,                         "P",      8, 1, 1, VIDEO,        FMTF_PALETTIZED,          UNKNOWN),
+        DXGIFMT(A8P8,                       "PA",    16, 1, 1, VIDEO,        FMTF_PALETTIZED,          UNKNOWN),
+        DXGIFMT(B4G4R4A4_UNORM,             "BGRA",  16, 1, 1, COLOR,        FMTF_BGR,                 UNKNOWN),
+        DXGIFMT(P208,                       "YUV",   16, 2, 1, VIDEO,        FMTF_PLANAR,              UNKNOWN),
+        DXGIFMT(V208,                       "YUV",   16, 1, 2, VIDEO,        FMTF_PLANAR,              UNKNOWN),
+        DXGIFMT(V408,                       "YUV",   24, 1, 1, VIDEO,        FMTF_PLANAR,              UNKNOWN),
     };
 
-    const DXGI_FORMAT g_cfsMSAA_11[] =
+    constexpr FORMATTABLE c_dxgiFormatTable = { c_dxgiFormats, std::size(c_dxgiFormats), 12 };
+    constexpr FORMATINDEX c_dxgiFormatIndex = BuildFormatIndex(c_dxgiFormatTable);
+    constexpr FORMATHASH c_dxgiFormatHash = BuildFormatHash(c_dxgiFormatTable, 5);
+
+    static_assert(CountFormatHashSlots(c_dxgiFormatHash) == std::size(c_dxgiFormats), "DXGI format names collide, pick another seed");
+
+    struct DXGIFORMATLIST
     {
-        DXGI_FORMAT_R32G32B32A32_FLOAT,
-        DXGI_FORMAT_R32G32B32A32_UINT,
-        DXGI_FORMAT_R32G32B32A32_SINT,
-        DXGI_FORMAT_R32G32B32_FLOAT,
-        DXGI_FORMAT_R32G32B32_UINT,
-        DXGI_FORMAT_R32G32B32_SINT,
-        DXGI_FORMAT_R16G16B16A16_FLOAT,
-        DXGI_FORMAT_R16G16B16A16_UNORM,
-        DXGI_FORMAT_R16G16B16A16_UINT,
-        DXGI_FORMAT_R16G16B16A16_SNORM,
-        DXGI_FORMAT_R16G16B16A16_SINT,
-        DXGI_FORMAT_R32G32_FLOAT,
-        DXGI_FORMAT_R32G32_UINT,
-        DXGI_FORMAT_R32G32_SINT,
-        DXGI_FORMAT_D32_FLOAT_S8X24_UINT,
-        DXGI_FORMAT_R10G10B10A2_UNORM,
-        DXGI_FORMAT_R10G10B10A2_UINT,
-        DXGI_FORMAT_R11G11B10_FLOAT,
-        DXGI_FORMAT_R8G8B8A8_UNORM,
-        DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
-        DXGI_FORMAT_R8G8B8A8_UINT,
-        DXGI_FORMAT_R8G8B8A8_SNORM,
-        DXGI_FORMAT_R8G8B8A8_SINT,
-        DXGI_FORMAT_R16G16_FLOAT,
-        DXGI_FORMAT_R16G16_UNORM,
-        DXGI_FORMAT_R16G16_UINT,
-        DXGI_FORMAT_R16G16_SNORM,
-        DXGI_FORMAT_R16G16_SINT,
-        DXGI_FORMAT_D32_FLOAT,
-        DXGI_FORMAT_R32_FLOAT,
-        DXGI_FORMAT_R32_UINT,
-        DXGI_FORMAT_R32_SINT,
-        DXGI_FORMAT_D24_UNORM_S8_UINT,
-        DXGI_FORMAT_R8G8_UNORM,
-        DXGI_FORMAT_R8G8_UINT,
-        DXGI_FORMAT_R8G8_SNORM,
-        DXGI_FORMAT_R8G8_SINT,
-        DXGI_FORMAT_R16_FLOAT,
-        DXGI_FORMAT_D16_UNORM,
-        DXGI_FORMAT_R16_UNORM,
-        DXGI_FORMAT_R16_UINT,
-        DXGI_FORMAT_R16_SNORM,
-        DXGI_FORMAT_R16_SINT,
-        DXGI_FORMAT_R8_UNORM,
-        DXGI_FORMAT_R8_UINT,
-        DXGI_FORMAT_R8_SNORM,
-        DXGI_FORMAT_R8_SINT,
-        DXGI_FORMAT_A8_UNORM,
-        DXGI_FORMAT_B8G8R8A8_UNORM,
-        DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,
-        DXGI_FORMAT_B8G8R8X8_UNORM,
-        DXGI_FORMAT_B8G8R8X8_UNORM_SRGB,
-        DXGI_FORMAT_B5G6R5_UNORM,
-        DXGI_FORMAT_B5G5R5A1_UNORM,
-        DXGI_FORMAT_B4G4R4A4_UNORM,
+        DXGI_FORMAT     formats[std::size(c_dxgiFormats)];
+        UINT            count;
     };
 
-    BOOL g_sampCount10[D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT];
-    BOOL g_sampCount10_1[D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT];
-    BOOL g_sampCount11[D3D11_MAX_MULTISAMPLE_SAMPLE_COUNT];
-    BOOL g_sampCount11_1[D3D11_MAX_MULTISAMPLE_SAMPLE_COUNT];
+    //-----------------------------------------------------------------------------
+    // Name: BuildFormatList()
+    // Desc: Every format in the given classes, less those with an excluded flag
+    //-----------------------------------------------------------------------------
+    constexpr DXGIFORMATLIST BuildFormatList(uint32_t classMask, uint32_t excludeFlags)
+    {
+        DXGIFORMATLIST list = {};
+        for (size_t i = 0; i < std::size(c_dxgiFormats); ++i)
+        {
+            if (FormatMatches(c_dxgiFormats[i], classMask, excludeFlags))
+                list.formats[list.count++] = static_cast<DXGI_FORMAT>(c_dxgiFormats[i].format);
+        }
+        return list;
+    }
+
+    constexpr DXGIFORMATLIST g_cfsMSAA_10 = BuildFormatList(
+        FORMATCLASS_MASK(FORMATCLASS_COLOR) | FORMATCLASS_MASK(FORMATCLASS_DEPTHSTENCIL),
+        FMTF_TYPELESS | FMTF_BGR | FMTF_DISPLAY);
+
+    // Direct3D 11 adds the BGR formats
+    constexpr DXGIFORMATLIST g_cfsMSAA_11 = BuildFormatList(
+        FORMATCLASS_MASK(FORMATCLASS_COLOR) | FORMATCLASS_MASK(FORMATCLASS_DEPTHSTENCIL),
+        FMTF_TYPELESS | FMTF_DISPLAY);
+
+    constexpr DXGIFORMATLIST g_cfsVideo = BuildFormatList(FORMATCLASS_MASK(FORMATCLASS_VIDEO), 0);
 
     const D3D_FEATURE_LEVEL g_featureLevels[] =
     {
@@ -299,38 +352,22 @@ namespace
         return shaderModelOpt.HighestShaderModel;
     }
 
-    const char* D3D12DXRSupported(_In_ ID3D12Device* device)
+    D3D12_RAYTRACING_TIER GetD3D12RaytracingTier(_In_ ID3D12Device* device)
     {
         D3D12_FEATURE_DATA_D3D12_OPTIONS5 d3d12opts = {};
         if (SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS5, &d3d12opts, sizeof(D3D12_FEATURE_DATA_D3D12_OPTIONS5))))
-        {
-            switch (d3d12opts.RaytracingTier)
-            {
-            case D3D12_RAYTRACING_TIER_NOT_SUPPORTED: break;
-            case D3D12_RAYTRACING_TIER_1_0: return "Optional (Yes - Tier 1.0)";
-            case D3D12_RAYTRACING_TIER_1_1: return "Optional (Yes - Tier 1.1)";
-            default: return c_szOptYes;
-            }
-        }
+            return d3d12opts.RaytracingTier;
 
-        return c_szOptNo;
+        return D3D12_RAYTRACING_TIER_NOT_SUPPORTED;
     }
 
-    const char* D3D12VRSSupported(_In_ ID3D12Device* device)
+    D3D12_VARIABLE_SHADING_RATE_TIER GetD3D12VRSTier(_In_ ID3D12Device* device)
     {
         D3D12_FEATURE_DATA_D3D12_OPTIONS6 d3d12opts = {};
         if (SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS6, &d3d12opts, sizeof(D3D12_FEATURE_DATA_D3D12_OPTIONS6))))
-        {
-            switch (d3d12opts.VariableShadingRateTier)
-            {
-            case D3D12_VARIABLE_SHADING_RATE_TIER_NOT_SUPPORTED: break;
-            case D3D12_VARIABLE_SHADING_RATE_TIER_1: return "Optional (Yes - Tier 1)";
-            case D3D12_VARIABLE_SHADING_RATE_TIER_2: return "Optional (Yes - Teir 2)";
-            default: return c_szOptYes;
-            }
-        }
+            return d3d12opts.VariableShadingRateTier;
 
-        return c_szOptNo;
+        return D3D12_VARIABLE_SHADING_RATE_TIER_NOT_SUPPORTED;
     }
 
     bool IsD3D12MeshShaderSupported(_In_ ID3D12Device* device)
@@ -347,132 +384,15 @@ namespace
     //-----------------------------------------------------------------------------
 #define ENUMNAME(a) case a: return TEXT(#a)
 
-    const TCHAR* FormatName(DXGI_FORMAT format)
+    const FORMATDESC* GetFormatDesc(DXGI_FORMAT format)
     {
-        switch (format)
-        {
-            ENUMNAME(DXGI_FORMAT_R32G32B32A32_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_R32G32B32A32_FLOAT);
-            ENUMNAME(DXGI_FORMAT_R32G32B32A32_UINT);
-            ENUMNAME(DXGI_FORMAT_R32G32B32A32_SINT);
-            ENUMNAME(DXGI_FORMAT_R32G32B32_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_R32G32B32_FLOAT);
-            ENUMNAME(DXGI_FORMAT_R32G32B32_UINT);
-            ENUMNAME(DXGI_FORMAT_R32G32B32_SINT);
-            ENUMNAME(DXGI_FORMAT_R16G16B16A16_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_R16G16B16A16_FLOAT);
-            ENUMNAME(DXGI_FORMAT_R16G16B16A16_UNORM);
-            ENUMNAME(DXGI_FORMAT_R16G16B16A16_UINT);
-            ENUMNAME(DXGI_FORMAT_R16G16B16A16_SNORM);
-            ENUMNAME(DXGI_FORMAT_R16G16B16A16_SINT);
-            ENUMNAME(DXGI_FORMAT_R32G32_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_R32G32_FLOAT);
-            ENUMNAME(DXGI_FORMAT_R32G32_UINT);
-            ENUMNAME(DXGI_FORMAT_R32G32_SINT);
-            ENUMNAME(DXGI_FORMAT_R32G8X24_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_D32_FLOAT_S8X24_UINT);
-            ENUMNAME(DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_X32_TYPELESS_G8X24_UINT);
-            ENUMNAME(DXGI_FORMAT_R10G10B10A2_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_R10G10B10A2_UNORM);
-            ENUMNAME(DXGI_FORMAT_R10G10B10A2_UINT);
-            ENUMNAME(DXGI_FORMAT_R11G11B10_FLOAT);
-            ENUMNAME(DXGI_FORMAT_R8G8B8A8_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_R8G8B8A8_UNORM);
-            ENUMNAME(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
-            ENUMNAME(DXGI_FORMAT_R8G8B8A8_UINT);
-            ENUMNAME(DXGI_FORMAT_R8G8B8A8_SNORM);
-            ENUMNAME(DXGI_FORMAT_R8G8B8A8_SINT);
-            ENUMNAME(DXGI_FORMAT_R16G16_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_R16G16_FLOAT);
-            ENUMNAME(DXGI_FORMAT_R16G16_UNORM);
-            ENUMNAME(DXGI_FORMAT_R16G16_UINT);
-            ENUMNAME(DXGI_FORMAT_R16G16_SNORM);
-            ENUMNAME(DXGI_FORMAT_R16G16_SINT);
-            ENUMNAME(DXGI_FORMAT_R32_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_D32_FLOAT);
-            ENUMNAME(DXGI_FORMAT_R32_FLOAT);
-            ENUMNAME(DXGI_FORMAT_R32_UINT);
-            ENUMNAME(DXGI_FORMAT_R32_SINT);
-            ENUMNAME(DXGI_FORMAT_R24G8_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_D24_UNORM_S8_UINT);
-            ENUMNAME(DXGI_FORMAT_R24_UNORM_X8_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_X24_TYPELESS_G8_UINT);
-            ENUMNAME(DXGI_FORMAT_R8G8_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_R8G8_UNORM);
-            ENUMNAME(DXGI_FORMAT_R8G8_UINT);
-            ENUMNAME(DXGI_FORMAT_R8G8_SNORM);
-            ENUMNAME(DXGI_FORMAT_R8G8_SINT);
-            ENUMNAME(DXGI_FORMAT_R16_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_R16_FLOAT);
-            ENUMNAME(DXGI_FORMAT_D16_UNORM);
-            ENUMNAME(DXGI_FORMAT_R16_UNORM);
-            ENUMNAME(DXGI_FORMAT_R16_UINT);
-            ENUMNAME(DXGI_FORMAT_R16_SNORM);
-            ENUMNAME(DXGI_FORMAT_R16_SINT);
-            ENUMNAME(DXGI_FORMAT_R8_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_R8_UNORM);
-            ENUMNAME(DXGI_FORMAT_R8_UINT);
-            ENUMNAME(DXGI_FORMAT_R8_SNORM);
-            ENUMNAME(DXGI_FORMAT_R8_SINT);
-            ENUMNAME(DXGI_FORMAT_A8_UNORM);
-            ENUMNAME(DXGI_FORMAT_R1_UNORM);
-            ENUMNAME(DXGI_FORMAT_R9G9B9E5_SHAREDEXP);
-            ENUMNAME(DXGI_FORMAT_R8G8_B8G8_UNORM);
-            ENUMNAME(DXGI_FORMAT_G8R8_G8B8_UNORM);
-            ENUMNAME(DXGI_FORMAT_BC1_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_BC1_UNORM);
-            ENUMNAME(DXGI_FORMAT_BC1_UNORM_SRGB);
-            ENUMNAME(DXGI_FORMAT_BC2_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_BC2_UNORM);
-            ENUMNAME(DXGI_FORMAT_BC2_UNORM_SRGB);
-            ENUMNAME(DXGI_FORMAT_BC3_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_BC3_UNORM);
-            ENUMNAME(DXGI_FORMAT_BC3_UNORM_SRGB);
-            ENUMNAME(DXGI_FORMAT_BC4_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_BC4_UNORM);
-            ENUMNAME(DXGI_FORMAT_BC4_SNORM);
-            ENUMNAME(DXGI_FORMAT_BC5_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_BC5_UNORM);
-            ENUMNAME(DXGI_FORMAT_BC5_SNORM);
-            ENUMNAME(DXGI_FORMAT_B5G6R5_UNORM);
-            ENUMNAME(DXGI_FORMAT_B5G5R5A1_UNORM);
-            ENUMNAME(DXGI_FORMAT_B8G8R8A8_UNORM);
-            ENUMNAME(DXGI_FORMAT_B8G8R8X8_UNORM);
-            ENUMNAME(DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM);
-            ENUMNAME(DXGI_FORMAT_B8G8R8A8_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_B8G8R8A8_UNORM_SRGB);
-            ENUMNAME(DXGI_FORMAT_B8G8R8X8_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_B8G8R8X8_UNORM_SRGB);
-            ENUMNAME(DXGI_FORMAT_BC6H_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_BC6H_UF16);
-            ENUMNAME(DXGI_FORMAT_BC6H_SF16);
-            ENUMNAME(DXGI_FORMAT_BC7_TYPELESS);
-            ENUMNAME(DXGI_FORMAT_BC7_UNORM);
-            ENUMNAME(DXGI_FORMAT_BC7_UNORM_SRGB);
-            ENUMNAME(DXGI_FORMAT_AYUV);
-            ENUMNAME(DXGI_FORMAT_Y410);
-            ENUMNAME(DXGI_FORMAT_Y416);
-            ENUMNAME(DXGI_FORMAT_NV12);
-            ENUMNAME(DXGI_FORMAT_P010);
-            ENUMNAME(DXGI_FORMAT_P016);
-            ENUMNAME(DXGI_FORMAT_420_OPAQUE);
-            ENUMNAME(DXGI_FORMAT_YUY2);
-            ENUMNAME(DXGI_FORMAT_Y210);
-            ENUMNAME(DXGI_FORMAT_Y216);
-            ENUMNAME(DXGI_FORMAT_NV11);
-            ENUMNAME(DXGI_FORMAT_AI44);
-            ENUMNAME(DXGI_FORMAT_IA44);
-            ENUMNAME(DXGI_FORMAT_P8);
-            ENUMNAME(DXGI_FORMAT_A8P8);
-            ENUMNAME(DXGI_FORMAT_B4G4R4A4_UNORM);
-            ENUMNAME(DXGI_FORMAT_P208);
-            ENUMNAME(DXGI_FORMAT_V208);
-            ENUMNAME(DXGI_FORMAT_V408);
+        return FindFormat(c_dxgiFormatTable, c_dxgiFormatIndex, static_cast<uint32_t>(format));
+    }
 
-        default:
-            return TEXT("DXGI_FORMAT_UNKNOWN");
-        }
+    const TCHAR* FormatName(DXGI_FORMAT format)
+    {
+        const FORMATDESC* pDesc = GetFormatDesc(format);
+        return pDesc ? pDesc->strName : TEXT("DXGI_FORMAT_UNKNOWN");
     }
 
     const TCHAR* FLName(D3D10_FEATURE_LEVEL1 lvl)
@@ -835,7 +755,8 @@ namespace
 
             UINT num = 0;
             const DWORD flags = 0;
-            HRESULT hr = pOutput->GetDisplayModeList(fmt, flags, &num, 0);
+            HRESULT hr = PROBE_CALL("IDXGIOutput::GetDisplayModeList", GetObjectAdapterName(pOutput),
+                pOutput->GetDisplayModeList(fmt, flags, &num, 0));
 
             if (SUCCEEDED(hr) && num > 0)
             {
@@ -843,7 +764,8 @@ namespace
                 if (!pDescs)
                    return E_OUTOFMEMORY;
 
-                hr = pOutput->GetDisplayModeList(fmt, flags, &num, pDescs);
+                hr = PROBE_CALL("IDXGIOutput::GetDisplayModeList", GetObjectAdapterName(pOutput),
+                    pOutput->GetDisplayModeList(fmt, flags, &num, pDescs));
 
                 if (SUCCEEDED(hr))
                 {
@@ -974,6 +896,376 @@ namespace
     }
 
 
+    //-----------------------------------------------------------------------------
+    // Format support matrix
+    //
+    // Every format node of a device asks about the same formats, so a device's
+    // answers, including the MSAA quality levels at every sample count, are
+    // gathered once. Devices with MSAA nodes start this on the thread pool as
+    // the tree is built, others on first use. After that each node is a table
+    // lookup.
+    //-----------------------------------------------------------------------------
+#define FORMAT_MATRIX_SIZE 192  // Every DXGI_FORMAT up to DXGI_FORMAT_A4B4G4R4_UNORM
+#define MSAA_MAX_SAMPLE_COUNT D3D11_MAX_MULTISAMPLE_SAMPLE_COUNT
+
+    static_assert(D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT == MSAA_MAX_SAMPLE_COUNT, "MSAA sample count mismatch");
+
+    struct FORMATSUPPORT
+    {
+        UINT    Support1;   // D3D10_FORMAT_SUPPORT, D3D11_FORMAT_SUPPORT or D3D12_FORMAT_SUPPORT1
+        UINT    Support2;   // D3D11_FORMAT_SUPPORT2 or D3D12_FORMAT_SUPPORT2
+        UINT    Quality[MSAA_MAX_SAMPLE_COUNT]; // Quality levels, indexed by sample count - 1
+    };
+
+    struct FORMATMATRIX;
+    using FORMATFILLCALLBACK = void(*)(FORMATMATRIX& matrix);
+
+    struct FORMATMATRIX
+    {
+        FORMATMATRIX*       pNext;
+        IUnknown*           pDevice;    // Not AddRef'd, the device outlives the matrix
+        FORMATFILLCALLBACK  fnFill;
+        PTP_WORK            pWork;      // Fills in the matrix, nullptr once waited on
+        CHAR                strAdapter[128];    // The device's adapter, for probe timing
+        FORMATSUPPORT       formats[FORMAT_MATRIX_SIZE];
+    };
+
+    FORMATMATRIX* g_pFormatMatrices = nullptr;
+
+    const char* GetObjectAdapterName(IUnknown* pObject);
+
+    //-----------------------------------------------------------------------------
+    void FillFormatQuality(ID3D10Device* pDevice, const char* strAdapter, DXGI_FORMAT fmt, FORMATSUPPORT& support)
+    {
+        // Don't bother asking about formats the device doesn't support at all
+        if (!support.Support1)
+            return;
+
+        for (UINT samples = 1; samples <= MSAA_MAX_SAMPLE_COUNT; ++samples)
+        {
+            UINT quality = 0;
+            if (FAILED(PROBE_CALL("ID3D10Device::CheckMultisampleQualityLevels", strAdapter,
+                pDevice->CheckMultisampleQualityLevels(fmt, samples, &quality))))
+                quality = 0;
+            support.Quality[samples - 1] = quality;
+        }
+    }
+
+    void FillFormatQuality(ID3D11Device* pDevice, const char* strAdapter, DXGI_FORMAT fmt, FORMATSUPPORT& support)
+    {
+        if (!support.Support1)
+            return;
+
+        for (UINT samples = 1; samples <= MSAA_MAX_SAMPLE_COUNT; ++samples)
+        {
+            UINT quality = 0;
+            if (FAILED(PROBE_CALL("ID3D11Device::CheckMultisampleQualityLevels", strAdapter,
+                pDevice->CheckMultisampleQualityLevels(fmt, samples, &quality))))
+                quality = 0;
+            support.Quality[samples - 1] = quality;
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    void FillFormatMatrix10(FORMATMATRIX& matrix)
+    {
+        auto pDevice = static_cast<ID3D10Device*>(matrix.pDevice);
+
+        for (UINT i = 0; i < FORMAT_MATRIX_SIZE; ++i)
+        {
+            auto fmt = static_cast<DXGI_FORMAT>(i);
+            FORMATSUPPORT& support = matrix.formats[i];
+
+            if (FAILED(PROBE_CALL("ID3D10Device::CheckFormatSupport", matrix.strAdapter,
+                pDevice->CheckFormatSupport(fmt, &support.Support1))))
+                support.Support1 = 0;
+
+            FillFormatQuality(pDevice, matrix.strAdapter, fmt, support);
+        }
+    }
+
+    void FillFormatMatrix11(FORMATMATRIX& matrix)
+    {
+        auto pDevice = static_cast<ID3D11Device*>(matrix.pDevice);
+
+        for (UINT i = 0; i < FORMAT_MATRIX_SIZE; ++i)
+        {
+            auto fmt = static_cast<DXGI_FORMAT>(i);
+            FORMATSUPPORT& support = matrix.formats[i];
+
+            if (FAILED(PROBE_CALL("ID3D11Device::CheckFormatSupport", matrix.strAdapter,
+                pDevice->CheckFormatSupport(fmt, &support.Support1))))
+                support.Support1 = 0;
+
+            D3D11_FEATURE_DATA_FORMAT_SUPPORT2 cfs2 = {};
+            cfs2.InFormat = fmt;
+            if (SUCCEEDED(PROBE_CALL("ID3D11Device::CheckFeatureSupport", matrix.strAdapter,
+                pDevice->CheckFeatureSupport(D3D11_FEATURE_FORMAT_SUPPORT2, &cfs2, sizeof(cfs2)))))
+                support.Support2 = cfs2.OutFormatSupport2;
+
+            FillFormatQuality(pDevice, matrix.strAdapter, fmt, support);
+        }
+    }
+
+    void FillFormatMatrix12(FORMATMATRIX& matrix)
+    {
+        auto pDevice = static_cast<ID3D12Device*>(matrix.pDevice);
+
+        for (UINT i = 0; i < FORMAT_MATRIX_SIZE; ++i)
+        {
+            D3D12_FEATURE_DATA_FORMAT_SUPPORT fmtSupport = {
+                static_cast<DXGI_FORMAT>(i), D3D12_FORMAT_SUPPORT1_NONE, D3D12_FORMAT_SUPPORT2_NONE,
+            };
+            if (SUCCEEDED(PROBE_CALL("ID3D12Device::CheckFeatureSupport", matrix.strAdapter,
+                pDevice->CheckFeatureSupport(D3D12_FEATURE_FORMAT_SUPPORT,
+                    &fmtSupport, sizeof(D3D12_FEATURE_DATA_FORMAT_SUPPORT)))))
+            {
+                matrix.formats[i].Support1 = fmtSupport.Support1;
+                matrix.formats[i].Support2 = fmtSupport.Support2;
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    VOID CALLBACK FormatMatrixWorkCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID pContext, PTP_WORK /*work*/)
+    {
+        auto pMatrix = static_cast<FORMATMATRIX*>(pContext);
+        pMatrix->fnFill(*pMatrix);
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: BeginFormatMatrix()
+    // Desc: Starts filling in the device's matrix on the thread pool, unless
+    //       that has already been done
+    //-----------------------------------------------------------------------------
+    FORMATMATRIX* BeginFormatMatrix(IUnknown* pDevice, FORMATFILLCALLBACK fnFill)
+    {
+        for (FORMATMATRIX* pMatrix = g_pFormatMatrices; pMatrix; pMatrix = pMatrix->pNext)
+        {
+            if (pMatrix->pDevice == pDevice)
+                return pMatrix;
+        }
+
+        auto pMatrix = new (std::nothrow) FORMATMATRIX();
+        if (!pMatrix)
+            return nullptr;
+
+        pMatrix->pDevice = pDevice;
+        pMatrix->fnFill = fnFill;
+        strcpy_s(pMatrix->strAdapter, GetObjectAdapterName(pDevice));
+        pMatrix->pWork = CreateThreadpoolWork(FormatMatrixWorkCallback, pMatrix, nullptr);
+        if (pMatrix->pWork)
+        {
+            SubmitThreadpoolWork(pMatrix->pWork);
+        }
+        else
+        {
+            // No thread pool work item available, so just fill it in inline
+            fnFill(*pMatrix);
+        }
+
+        pMatrix->pNext = g_pFormatMatrices;
+        g_pFormatMatrices = pMatrix;
+        return pMatrix;
+    }
+
+    void BeginFormatMatrix(ID3D10Device* pDevice) { (void)BeginFormatMatrix(pDevice, FillFormatMatrix10); }
+    void BeginFormatMatrix(ID3D11Device* pDevice) { (void)BeginFormatMatrix(pDevice, FillFormatMatrix11); }
+
+    //-----------------------------------------------------------------------------
+    void WaitForFormatMatrix(FORMATMATRIX* pMatrix)
+    {
+        if (pMatrix && pMatrix->pWork)
+        {
+            WaitForThreadpoolWorkCallbacks(pMatrix->pWork, FALSE);
+            CloseThreadpoolWork(pMatrix->pWork);
+            pMatrix->pWork = nullptr;
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: GetFormatMatrix()
+    // Desc: Returns the device's completed matrix, filling it in first if it
+    //       hasn't been started yet. Only ever called from the UI thread.
+    //-----------------------------------------------------------------------------
+    const FORMATMATRIX* GetFormatMatrix(IUnknown* pDevice, FORMATFILLCALLBACK fnFill)
+    {
+        FORMATMATRIX* pMatrix = BeginFormatMatrix(pDevice, fnFill);
+        WaitForFormatMatrix(pMatrix);
+        return pMatrix;
+    }
+
+    const FORMATMATRIX* GetFormatMatrix(ID3D10Device* pDevice) { return GetFormatMatrix(pDevice, FillFormatMatrix10); }
+    const FORMATMATRIX* GetFormatMatrix(ID3D11Device* pDevice) { return GetFormatMatrix(pDevice, FillFormatMatrix11); }
+    const FORMATMATRIX* GetFormatMatrix(ID3D12Device* pDevice) { return GetFormatMatrix(pDevice, FillFormatMatrix12); }
+
+    //-----------------------------------------------------------------------------
+    void FreeFormatMatrices()
+    {
+        while (g_pFormatMatrices)
+        {
+            FORMATMATRIX* pNext = g_pFormatMatrices->pNext;
+            WaitForFormatMatrix(g_pFormatMatrices);
+            delete g_pFormatMatrices;
+            g_pFormatMatrices = pNext;
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: FreeFormatMatrix()
+    // Desc: Frees the device's matrix, if it has one, before the device goes away
+    //-----------------------------------------------------------------------------
+    void FreeFormatMatrix(IUnknown* pDevice)
+    {
+        for (FORMATMATRIX** ppMatrix = &g_pFormatMatrices; *ppMatrix; ppMatrix = &(*ppMatrix)->pNext)
+        {
+            if ((*ppMatrix)->pDevice == pDevice)
+            {
+                FORMATMATRIX* pMatrix = *ppMatrix;
+                *ppMatrix = pMatrix->pNext;
+                WaitForFormatMatrix(pMatrix);
+                delete pMatrix;
+                return;
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: GetFormatSupport()
+    // Desc: CheckFormatSupport from the device's format support matrix
+    //-----------------------------------------------------------------------------
+    UINT GetFormatSupport(ID3D10Device* pDevice, DXGI_FORMAT fmt)
+    {
+        const FORMATMATRIX* pMatrix = (fmt < FORMAT_MATRIX_SIZE) ? GetFormatMatrix(pDevice) : nullptr;
+        if (pMatrix)
+            return pMatrix->formats[fmt].Support1;
+
+        UINT fmtSupport = 0;
+        if (FAILED(PROBE_CALL("ID3D10Device::CheckFormatSupport", GetObjectAdapterName(pDevice),
+            pDevice->CheckFormatSupport(fmt, &fmtSupport))))
+            fmtSupport = 0;
+        return fmtSupport;
+    }
+
+    UINT GetFormatSupport(ID3D11Device* pDevice, DXGI_FORMAT fmt)
+    {
+        const FORMATMATRIX* pMatrix = (fmt < FORMAT_MATRIX_SIZE) ? GetFormatMatrix(pDevice) : nullptr;
+        if (pMatrix)
+            return pMatrix->formats[fmt].Support1;
+
+        UINT fmtSupport = 0;
+        if (FAILED(PROBE_CALL("ID3D11Device::CheckFormatSupport", GetObjectAdapterName(pDevice),
+            pDevice->CheckFormatSupport(fmt, &fmtSupport))))
+            fmtSupport = 0;
+        return fmtSupport;
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: GetFormatSupport2()
+    // Desc: D3D11_FEATURE_FORMAT_SUPPORT2 from the device's format support matrix
+    //-----------------------------------------------------------------------------
+    UINT GetFormatSupport2(ID3D11Device* pDevice, DXGI_FORMAT fmt)
+    {
+        const FORMATMATRIX* pMatrix = (fmt < FORMAT_MATRIX_SIZE) ? GetFormatMatrix(pDevice) : nullptr;
+        if (pMatrix)
+            return pMatrix->formats[fmt].Support2;
+
+        D3D11_FEATURE_DATA_FORMAT_SUPPORT2 cfs2 = {};
+        cfs2.InFormat = fmt;
+        if (FAILED(PROBE_CALL("ID3D11Device::CheckFeatureSupport", GetObjectAdapterName(pDevice),
+            pDevice->CheckFeatureSupport(D3D11_FEATURE_FORMAT_SUPPORT2, &cfs2, sizeof(cfs2)))))
+            cfs2.OutFormatSupport2 = 0;
+        return cfs2.OutFormatSupport2;
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: GetFormatQuality()
+    // Desc: CheckMultisampleQualityLevels from the device's format support matrix
+    //-----------------------------------------------------------------------------
+    UINT GetFormatQuality(ID3D10Device* pDevice, DXGI_FORMAT fmt, UINT samples)
+    {
+        if (samples < 1 || samples > MSAA_MAX_SAMPLE_COUNT)
+            return 0;
+
+        const FORMATMATRIX* pMatrix = (fmt < FORMAT_MATRIX_SIZE) ? GetFormatMatrix(pDevice) : nullptr;
+        if (pMatrix)
+            return pMatrix->formats[fmt].Quality[samples - 1];
+
+        UINT quality = 0;
+        if (FAILED(PROBE_CALL("ID3D10Device::CheckMultisampleQualityLevels", GetObjectAdapterName(pDevice),
+            pDevice->CheckMultisampleQualityLevels(fmt, samples, &quality))))
+            quality = 0;
+        return quality;
+    }
+
+    UINT GetFormatQuality(ID3D11Device* pDevice, DXGI_FORMAT fmt, UINT samples)
+    {
+        if (samples < 1 || samples > MSAA_MAX_SAMPLE_COUNT)
+            return 0;
+
+        const FORMATMATRIX* pMatrix = (fmt < FORMAT_MATRIX_SIZE) ? GetFormatMatrix(pDevice) : nullptr;
+        if (pMatrix)
+            return pMatrix->formats[fmt].Quality[samples - 1];
+
+        UINT quality = 0;
+        if (FAILED(PROBE_CALL("ID3D11Device::CheckMultisampleQualityLevels", GetObjectAdapterName(pDevice),
+            pDevice->CheckMultisampleQualityLevels(fmt, samples, &quality))))
+            quality = 0;
+        return quality;
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: GetFormatSupport()
+    // Desc: D3D12_FEATURE_FORMAT_SUPPORT from the device's format support matrix
+    //-----------------------------------------------------------------------------
+    void GetFormatSupport(ID3D12Device* pDevice, D3D12_FEATURE_DATA_FORMAT_SUPPORT& fmtSupport)
+    {
+        const FORMATMATRIX* pMatrix = (fmtSupport.Format < FORMAT_MATRIX_SIZE) ? GetFormatMatrix(pDevice) : nullptr;
+        if (pMatrix)
+        {
+            fmtSupport.Support1 = static_cast<D3D12_FORMAT_SUPPORT1>(pMatrix->formats[fmtSupport.Format].Support1);
+            fmtSupport.Support2 = static_cast<D3D12_FORMAT_SUPPORT2>(pMatrix->formats[fmtSupport.Format].Support2);
+            return;
+        }
+
+        if (FAILED(PROBE_CALL("ID3D12Device::CheckFeatureSupport", GetObjectAdapterName(pDevice),
+            pDevice->CheckFeatureSupport(D3D12_FEATURE_FORMAT_SUPPORT,
+                &fmtSupport, sizeof(D3D12_FEATURE_DATA_FORMAT_SUPPORT)))))
+        {
+            fmtSupport.Support1 = D3D12_FORMAT_SUPPORT1_NONE;
+            fmtSupport.Support2 = D3D12_FORMAT_SUPPORT2_NONE;
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: GetMSAASampleCounts()
+    // Desc: Which sample counts any of the given formats supports. 1 always is.
+    //-----------------------------------------------------------------------------
+    void GetMSAASampleCounts(ID3D10Device* pDevice, const DXGI_FORMAT* pFormats, UINT count, BOOL sampCount[])
+    {
+        memset(sampCount, 0, sizeof(BOOL) * MSAA_MAX_SAMPLE_COUNT);
+        sampCount[0] = TRUE;
+
+        for (UINT samples = 2; samples <= MSAA_MAX_SAMPLE_COUNT; ++samples)
+        {
+            for (UINT i = 0; i < count && !sampCount[samples - 1]; ++i)
+                sampCount[samples - 1] = (GetFormatQuality(pDevice, pFormats[i], samples) > 0);
+        }
+    }
+
+    void GetMSAASampleCounts(ID3D11Device* pDevice, const DXGI_FORMAT* pFormats, UINT count, BOOL sampCount[])
+    {
+        memset(sampCount, 0, sizeof(BOOL) * MSAA_MAX_SAMPLE_COUNT);
+        sampCount[0] = TRUE;
+
+        for (UINT samples = 2; samples <= MSAA_MAX_SAMPLE_COUNT; ++samples)
+        {
+            for (UINT i = 0; i < count && !sampCount[samples - 1]; ++i)
+                sampCount[samples - 1] = (GetFormatQuality(pDevice, pFormats[i], samples) > 0);
+        }
+    }
+
+
     //-----------------------------------------------------------------------------
     void CheckExtendedFormats(ID3D10Device* pDevice, BOOL& ext, BOOL& x2)
     {
@@ -984,14 +1276,16 @@ namespace
             return;
 
         UINT fmtSupport = 0;
-        HRESULT hr = pDevice->CheckFormatSupport(DXGI_FORMAT_B8G8R8A8_UNORM, &fmtSupport);
+        HRESULT hr = PROBE_CALL("ID3D10Device::CheckFormatSupport", GetObjectAdapterName(pDevice),
+            pDevice->CheckFormatSupport(DXGI_FORMAT_B8G8R8A8_UNORM, &fmtSupport));
         if (FAILED(hr))
             fmtSupport = 0;
 
         if (fmtSupport & D3D10_FORMAT_SUPPORT_RENDER_TARGET)
             ext = TRUE;
 
-        hr = pDevice->CheckFormatSupport(DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM, &fmtSupport);
+        hr = PROBE_CALL("ID3D10Device::CheckFormatSupport", GetObjectAdapterName(pDevice),
+            pDevice->CheckFormatSupport(DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM, &fmtSupport));
         if (FAILED(hr))
             fmtSupport = 0;
 
@@ -1004,7 +1298,8 @@ namespace
         ext = x2 = bpp565 = FALSE;
 
         UINT fmtSupport = 0;
-        HRESULT hr = pDevice->CheckFormatSupport(DXGI_FORMAT_B8G8R8A8_UNORM, &fmtSupport);
+        HRESULT hr = PROBE_CALL("ID3D11Device::CheckFormatSupport", GetObjectAdapterName(pDevice),
+            pDevice->CheckFormatSupport(DXGI_FORMAT_B8G8R8A8_UNORM, &fmtSupport));
         if (FAILED(hr))
             fmtSupport = 0;
 
@@ -1012,7 +1307,8 @@ namespace
             ext = TRUE;
 
         fmtSupport = 0;
-        hr = pDevice->CheckFormatSupport(DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM, &fmtSupport);
+        hr = PROBE_CALL("ID3D11Device::CheckFormatSupport", GetObjectAdapterName(pDevice),
+            pDevice->CheckFormatSupport(DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM, &fmtSupport));
         if (FAILED(hr))
             fmtSupport = 0;
 
@@ -1023,7 +1319,8 @@ namespace
         if (g_DXGIFactory2)
         {
             fmtSupport = 0;
-            hr = pDevice->CheckFormatSupport(DXGI_FORMAT_B5G6R5_UNORM, &fmtSupport);
+            hr = PROBE_CALL("ID3D11Device::CheckFormatSupport", GetObjectAdapterName(pDevice),
+                pDevice->CheckFormatSupport(DXGI_FORMAT_B5G6R5_UNORM, &fmtSupport));
             if (FAILED(hr))
                 fmtSupport = 0;
 
@@ -1129,890 +1426,637 @@ namespace
         cubemapRT = (d3d9opts.TextureCubeFaceRenderTargetWithNonCubeDepthStencilSupported) ? true : false;
     }
 
-//-----------------------------------------------------------------------------
-#define D3D_FL_LPARAM3_D3D10( d3dType ) ( ( (d3dType & 0xff) << 8 ) | 0 )
-#define D3D_FL_LPARAM3_D3D10_1( d3dType ) ( ( (d3dType & 0xff) << 8 ) | 1 )
-#define D3D_FL_LPARAM3_D3D11( d3dType ) ( ( (d3dType & 0xff) << 8 ) | 2 )
-#define D3D_FL_LPARAM3_D3D11_1( d3dType ) ( ( (d3dType & 0xff) << 8 ) | 3 )
-#define D3D_FL_LPARAM3_D3D11_2( d3dType ) ( ( (d3dType & 0xff) << 8 ) | 4 )
-#define D3D_FL_LPARAM3_D3D11_3( d3dType ) ( ( (d3dType & 0xff) << 8 ) | 5 )
-#define D3D_FL_LPARAM3_D3D12( d3dType ) ( ( (d3dType & 0xff) << 8 ) | 10 )
 
-    HRESULT D3D_FeatureLevel(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
+    //-----------------------------------------------------------------------------
+    // Name: FillFeatureOptions()
+    // Desc: Asks the device about what feature levels leave optional, as far as
+    //       its interface can report it
+    //-----------------------------------------------------------------------------
+    void FillFeatureOptions(IUnknown* pDevice, CAPFLAPI api, CAPFLOPTIONS& options)
     {
-        auto fl = static_cast<D3D_FEATURE_LEVEL>(lParam1);
-        if (lParam2 == 0)
-            return S_OK;
+        options = {};
 
-        ID3D10Device* pD3D10 = nullptr;
-        ID3D10Device1* pD3D10_1 = nullptr;
-        ID3D11Device* pD3D11 = nullptr;
-        ID3D11Device1* pD3D11_1 = nullptr;
-        ID3D11Device2* pD3D11_2 = nullptr;
-        ID3D11Device3* pD3D11_3 = nullptr;
-        ID3D12Device* pD3D12 = nullptr;
+        if (api == CAPFLAPI_D3D12)
+        {
+            auto pD3D12 = static_cast<ID3D12Device*>(pDevice);
 
-        auto d3dVer = static_cast<unsigned int>(lParam3 & 0xff);
-        auto d3dType = static_cast<D3D_DRIVER_TYPE>((lParam3 & 0xff00) >> 8);
+            options.shaderModel = static_cast<uint32_t>(GetD3D12ShaderModel(pD3D12));
 
-        if (d3dVer == 10)
-        {
-            pD3D12 = reinterpret_cast<ID3D12Device*>(lParam2);
+            D3D12_FEATURE_DATA_D3D12_OPTIONS d3d12opts = {};
+            if (SUCCEEDED(pD3D12->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &d3d12opts, sizeof(D3D12_FEATURE_DATA_D3D12_OPTIONS))))
+            {
+                options.tiledTier = static_cast<uint32_t>(d3d12opts.TiledResourcesTier);
+                options.bindingTier = static_cast<uint32_t>(d3d12opts.ResourceBindingTier);
+                options.conservativeTier = static_cast<uint32_t>(d3d12opts.ConservativeRasterizationTier);
+                options.rovs = (d3d12opts.ROVsSupported) ? true : false;
+                options.psStencilRef = (d3d12opts.PSSpecifiedStencilRefSupported) ? true : false;
+                options.logicOps = (d3d12opts.OutputMergerLogicOp) ? true : false;
+            }
+
+            options.vrsTier = static_cast<uint32_t>(GetD3D12VRSTier(pD3D12));
+            options.raytracingTier = static_cast<uint32_t>(GetD3D12RaytracingTier(pD3D12));
+            options.meshShaders = IsD3D12MeshShaderSupported(pD3D12);
+            return;
         }
-        else if (d3dVer == 5)
+
+        BOOL ext = FALSE;
+        BOOL x2 = FALSE;
+        BOOL bpp565 = FALSE;
+
+        if (api == CAPFLAPI_D3D10 || api == CAPFLAPI_D3D10_1)
         {
-            pD3D11_3 = reinterpret_cast<ID3D11Device3*>(lParam2);
+            CheckExtendedFormats(static_cast<ID3D10Device*>(pDevice), ext, x2);
+            options.extFormats = (ext) ? true : false;
+            options.x2Format = (x2) ? true : false;
+            return;
         }
-        else
-        {
-            if (fl > D3D_FEATURE_LEVEL_11_1)
-                fl = D3D_FEATURE_LEVEL_11_1;
 
-            if (d3dVer == 4)
-            {
-                pD3D11_2 = reinterpret_cast<ID3D11Device2*>(lParam2);
-            }
-            else if (d3dVer == 3)
-            {
-                pD3D11_1 = reinterpret_cast<ID3D11Device1*>(lParam2);
-            }
-            else
-            {
-                if (fl > D3D_FEATURE_LEVEL_11_0)
-                    fl = D3D_FEATURE_LEVEL_11_0;
+        auto pD3D11 = static_cast<ID3D11Device*>(pDevice);
 
-                if (d3dVer == 2)
-                {
-                    pD3D11 = reinterpret_cast<ID3D11Device*>(lParam2);
-                }
-                else
-                {
-                    if (fl > D3D_FEATURE_LEVEL_10_1)
-                        fl = D3D_FEATURE_LEVEL_10_1;
+        D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS d3d10xhw = {};
+        if (SUCCEEDED(pD3D11->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &d3d10xhw, sizeof(d3d10xhw))))
+            options.computeShader4x = (d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x) ? true : false;
 
-                    if (d3dVer == 1)
-                    {
-                        pD3D10_1 = reinterpret_cast<ID3D10Device1*>(lParam2);
-                    }
-                    else
-                    {
-                        if (fl > D3D_FEATURE_LEVEL_10_0)
-                            fl = D3D_FEATURE_LEVEL_10_0;
+        CheckExtendedFormats(pD3D11, ext, x2, bpp565);
+        options.extFormats = (ext) ? true : false;
+        options.x2Format = (x2) ? true : false;
+        options.bpp565 = (bpp565) ? true : false;
 
-                        pD3D10 = reinterpret_cast<ID3D10Device*>(lParam2);
-                    }
-                }
-            }
-        }
+        if (api == CAPFLAPI_D3D11)
+            return;
 
-        if (!pPrintInfo)
+        CheckD3D11Ops(pD3D11, options.logicOps, options.cbPartial, options.cbOffsetting);
+
+        if (api == CAPFLAPI_D3D11_1)
         {
-            LVAddColumn(g_hwndLV, 0, "Name", 30);
-            LVAddColumn(g_hwndLV, 1, "Value", 60);
+            CheckD3D9Ops(pD3D11, options.nonPow2, options.shadows);
+            return;
         }
 
-        const char* shaderModel = nullptr;
-        const char* computeShader = c_szNo;
-        const char* maxTexDim = nullptr;
-        const char* maxCubeDim = nullptr;
-        const char* maxVolDim = nullptr;
-        const char* maxTexRepeat = nullptr;
-        const char* maxAnisotropy = nullptr;
-        const char* maxPrimCount = "4294967296";
-        const char* maxInputSlots = nullptr;
-        const char* mrt = nullptr;
-        const char* extFormats = nullptr;
-        const char* x2_10BitFormat = nullptr;
-        const char* logic_ops = c_szNo;
-        const char* cb_partial = c_szNA;
-        const char* cb_offsetting = c_szNA;
-        const char* uavSlots = nullptr;
-        const char* uavEveryStage = nullptr;
-        const char* uavOnlyRender = nullptr;
-        const char* nonpow2 = nullptr;
-        const char* bpp16 = c_szNo;
-        const char* shadows = nullptr;
-        const char* cubeRT = nullptr;
-        const char* tiled_rsc = nullptr;
-        const char* binding_rsc = nullptr;
-        const char* minmaxfilter = nullptr;
-        const char* mapdefaultbuff = nullptr;
-        const char* consrv_rast = nullptr;
-        const char* rast_ordered_views = nullptr;
-        const char* ps_stencil_ref = nullptr;
-        const char* instancing = nullptr;
-        const char* vrs = nullptr;
-        const char* meshShaders = nullptr;
-        const char* dxr = nullptr;
+        D3D11_TILED_RESOURCES_TIER tiled = D3D11_TILED_RESOURCES_NOT_SUPPORTED;
+        CheckD3D11Ops1(pD3D11, tiled, options.minMaxFilter, options.mapDefaultBuffers);
+        options.tiledTier = static_cast<uint32_t>(tiled);
 
-        BOOL _10level9 = FALSE;
+        CheckD3D9Ops1(pD3D11, options.nonPow2, options.shadows, options.instancing, options.cubeRT);
 
-        switch (fl)
+        if (api == CAPFLAPI_D3D11_3)
         {
-        case D3D_FEATURE_LEVEL_12_2:
-            if (pD3D12)
-            {
-                switch (GetD3D12ShaderModel(pD3D12))
-                {
-                case D3D_SHADER_MODEL_6_7:
-                    shaderModel = "6.7 (Optional)";
-                    computeShader = "Yes (CS 6.7)";
-                    break;
-                case D3D_SHADER_MODEL_6_6:
-                    shaderModel = "6.6 (Optional)";
-                    computeShader = "Yes (CS 6.6)";
-                    break;
-                default:
-                    shaderModel = "6.5";
-                    computeShader = "Yes (CS 6.5)";
-                    break;
-                }
-                vrs = "Yes - Tier 2";
-                meshShaders = c_szYes;
-                dxr = "Yes - Tier 1.1";
-            }
-            // Fall-through
+            // D3D11_FEATURE_DATA_D3D11_OPTIONS1 caps tiled resources at Tier 2
+            D3D11_CONSERVATIVE_RASTERIZATION_TIER crast = D3D11_CONSERVATIVE_RASTERIZATION_NOT_SUPPORTED;
+            CheckD3D11Ops2(pD3D11, tiled, crast, options.rovs, options.psStencilRef);
+            options.tiledTier = __max(options.tiledTier, static_cast<uint32_t>(tiled));
+            options.conservativeTier = static_cast<uint32_t>(crast);
+        }
+    }
 
-        case D3D_FEATURE_LEVEL_12_1:
-        case D3D_FEATURE_LEVEL_12_0:
-            if (!shaderModel)
-            {
-                switch (GetD3D12ShaderModel(pD3D12))
-                {
-                case D3D_SHADER_MODEL_6_7:
-                    shaderModel = "6.7 (Optional)";
-                    computeShader = "Yes (CS 6.7)";
-                    break;
-                case D3D_SHADER_MODEL_6_6:
-                    shaderModel = "6.6 (Optional)";
-                    computeShader = "Yes (CS 6.6)";
-                    break;
-                case D3D_SHADER_MODEL_6_5:
-                    shaderModel = "6.5 (Optional)";
-                    computeShader = "Yes (CS 6.5)";
-                    break;
-                case D3D_SHADER_MODEL_6_4:
-                    shaderModel = "6.4 (Optional)";
-                    computeShader = "Yes (CS 6.4)";
-                    break;
-                case D3D_SHADER_MODEL_6_3:
-                    shaderModel = "6.3 (Optional)";
-                    computeShader = "Yes (CS 6.3)";
-                    break;
-                case D3D_SHADER_MODEL_6_2:
-                    shaderModel = "6.2 (Optional)";
-                    computeShader = "Yes (CS 6.2)";
-                    break;
-                case D3D_SHADER_MODEL_6_1:
-                    shaderModel = "6.1 (Optional)";
-                    computeShader = "Yes (CS 6.1)";
-                    break;
-                case D3D_SHADER_MODEL_6_0:
-                    shaderModel = "6.0 (Optional)";
-                    computeShader = "Yes (CS 6.0)";
-                    break;
-                default:
-                    shaderModel = "5.1";
-                    computeShader = "Yes (CS 5.1)";
-                    break;
-                }
-            }
-            extFormats = c_szYes;
-            x2_10BitFormat = c_szYes;
-            logic_ops = c_szYes;
-            cb_partial = c_szYes;
-            cb_offsetting = c_szYes;
-            uavEveryStage = c_szYes;
-            uavOnlyRender = "16";
-            nonpow2 = "Full";
-            bpp16 = c_szYes;
-            instancing = c_szYes;
-
-            if (pD3D12)
-            {
-                maxTexDim = XTOSTRING(D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION);
-                maxCubeDim = XTOSTRING(D3D12_REQ_TEXTURECUBE_DIMENSION);
-                maxVolDim = XTOSTRING(D3D12_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
-                maxTexRepeat = XTOSTRING(D3D12_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION);
-                maxAnisotropy = XTOSTRING(D3D12_REQ_MAXANISOTROPY);
-                maxInputSlots = XTOSTRING(D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
-                mrt = XTOSTRING(D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT);
-                uavSlots = XTOSTRING(D3D12_UAV_SLOT_COUNT);
-
-                D3D12_FEATURE_DATA_D3D12_OPTIONS d3d12opts = {};
-                HRESULT hr = pD3D12->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &d3d12opts, sizeof(D3D12_FEATURE_DATA_D3D12_OPTIONS));
-                if (FAILED(hr))
-                    memset(&d3d12opts, 0, sizeof(d3d12opts));
 
-                switch (d3d12opts.TiledResourcesTier)
-                {
-                    // 12.0 & 12.1 should be T2 or greater, 12.2 is T3 or greater
-                case D3D12_TILED_RESOURCES_TIER_2:  tiled_rsc = "Yes - Tier 2"; break;
-                case D3D12_TILED_RESOURCES_TIER_3:  tiled_rsc = "Yes - Tier 3"; break;
-                case D3D12_TILED_RESOURCES_TIER_4:  tiled_rsc = "Yes - Tier 4"; break;
-                default:                            tiled_rsc = c_szYes;        break;
-                }
+    //-----------------------------------------------------------------------------
+    // A device's answers for the feature level summaries, which are shown once
+    // per view option when captured and again on every selection
+    struct FEATUREOPTIONS
+    {
+        FEATUREOPTIONS*     pNext;
+        IUnknown*           pDevice;    // Not AddRef'd, freed along with the device
+        CAPFLAPI            api;
+        CAPFLOPTIONS        options;
+    };
 
-                switch (d3d12opts.ResourceBindingTier)
-                {
-                    // 12.0 & 12.1 should be T2 or greater, 12.2 is T3 or greater
-                case D3D12_RESOURCE_BINDING_TIER_2: binding_rsc = "Yes - Tier 2"; break;
-                case D3D12_RESOURCE_BINDING_TIER_3: binding_rsc = "Yes - Tier 3"; break;
-                default:                            binding_rsc = c_szYes;        break;
-                }
+    FEATUREOPTIONS* g_pFeatureOptions = nullptr;
 
-                if (fl >= D3D_FEATURE_LEVEL_12_1)
-                {
-                    switch (d3d12opts.ConservativeRasterizationTier)
-                    {
-                        // 12.1 requires T1, 12.2 requires T3
-                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_1:   consrv_rast = "Yes - Tier 1";  break;
-                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_2:   consrv_rast = "Yes - Tier 2";  break;
-                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_3:   consrv_rast = "Yes - Tier 3";  break;
-                    default:                                        consrv_rast = c_szYes;         break;
-                    }
+    //-----------------------------------------------------------------------------
+    // Name: GetFeatureOptions()
+    // Desc: Asks the device the first time only. Only ever called from the UI
+    //       thread.
+    //-----------------------------------------------------------------------------
+    const CAPFLOPTIONS* GetFeatureOptions(IUnknown* pDevice, CAPFLAPI api)
+    {
+        for (FEATUREOPTIONS* pOptions = g_pFeatureOptions; pOptions; pOptions = pOptions->pNext)
+        {
+            if (pOptions->pDevice == pDevice && pOptions->api == api)
+                return &pOptions->options;
+        }
 
-                    rast_ordered_views = c_szYes;
-                }
-                else
-                {
-                    switch (d3d12opts.ConservativeRasterizationTier)
-                    {
-                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_NOT_SUPPORTED:   consrv_rast = c_szOptNo; break;
-                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_1:               consrv_rast = "Optional (Yes - Tier 1)";  break;
-                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_2:               consrv_rast = "Optional (Yes - Tier 2)";  break;
-                    case D3D12_CONSERVATIVE_RASTERIZATION_TIER_3:               consrv_rast = "Optional (Yes - Tier 3)";  break;
-                    default:                                                    consrv_rast = c_szOptYes; break;
-                    }
+        auto pOptions = new (std::nothrow) FEATUREOPTIONS();
+        if (!pOptions)
+            return nullptr;
 
-                    rast_ordered_views = (d3d12opts.ROVsSupported) ? c_szOptYes : c_szOptNo;
-                }
+        pOptions->pDevice = pDevice;
+        pOptions->api = api;
+        FillFeatureOptions(pDevice, api, pOptions->options);
+
+        pOptions->pNext = g_pFeatureOptions;
+        g_pFeatureOptions = pOptions;
+        return &pOptions->options;
+    }
+
+    //-----------------------------------------------------------------------------
+    void FreeFeatureOptions()
+    {
+        while (g_pFeatureOptions)
+        {
+            FEATUREOPTIONS* pNext = g_pFeatureOptions->pNext;
+            delete g_pFeatureOptions;
+            g_pFeatureOptions = pNext;
+        }
+    }
 
-                ps_stencil_ref = (d3d12opts.PSSpecifiedStencilRefSupported) ? c_szOptYes : c_szOptNo;
-                minmaxfilter = c_szYes;
-                mapdefaultbuff = c_szYes;
+    //-----------------------------------------------------------------------------
+    // Name: FreeFeatureOptions()
+    // Desc: Frees what the device answered, under each of its interfaces,
+    //       before the device goes away
+    //-----------------------------------------------------------------------------
+    void FreeFeatureOptions(IUnknown* pDevice)
+    {
+        for (FEATUREOPTIONS** ppOptions = &g_pFeatureOptions; *ppOptions; )
+        {
+            FEATUREOPTIONS* pOptions = *ppOptions;
+            if (pOptions->pDevice == pDevice)
+            {
+                *ppOptions = pOptions->pNext;
+                delete pOptions;
             }
-            else if (pD3D11_3)
+            else
             {
-                maxTexDim = XTOSTRING(D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION);
-                maxCubeDim = XTOSTRING(D3D11_REQ_TEXTURECUBE_DIMENSION);
-                maxVolDim = XTOSTRING(D3D11_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
-                maxTexRepeat = XTOSTRING(D3D11_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION);
-                maxAnisotropy = XTOSTRING(D3D11_REQ_MAXANISOTROPY);
-                maxInputSlots = XTOSTRING(D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
-                mrt = XTOSTRING(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT);
-                uavSlots = XTOSTRING(D3D11_1_UAV_SLOT_COUNT);
+                ppOptions = &pOptions->pNext;
+            }
+        }
+    }
 
-                D3D11_TILED_RESOURCES_TIER tiled = D3D11_TILED_RESOURCES_NOT_SUPPORTED;
-                bool bMinMaxFilter, bMapDefaultBuff;
-                CheckD3D11Ops1(pD3D11_3, tiled, bMinMaxFilter, bMapDefaultBuff);
+//-----------------------------------------------------------------------------
+#define D3D_FL_LPARAM3_D3D10( d3dType ) ( ( (d3dType & 0xff) << 8 ) | CAPFLAPI_D3D10 )
+#define D3D_FL_LPARAM3_D3D10_1( d3dType ) ( ( (d3dType & 0xff) << 8 ) | CAPFLAPI_D3D10_1 )
+#define D3D_FL_LPARAM3_D3D11( d3dType ) ( ( (d3dType & 0xff) << 8 ) | CAPFLAPI_D3D11 )
+#define D3D_FL_LPARAM3_D3D11_1( d3dType ) ( ( (d3dType & 0xff) << 8 ) | CAPFLAPI_D3D11_1 )
+#define D3D_FL_LPARAM3_D3D11_2( d3dType ) ( ( (d3dType & 0xff) << 8 ) | CAPFLAPI_D3D11_2 )
+#define D3D_FL_LPARAM3_D3D11_3( d3dType ) ( ( (d3dType & 0xff) << 8 ) | CAPFLAPI_D3D11_3 )
+#define D3D_FL_LPARAM3_D3D12( d3dType ) ( ( (d3dType & 0xff) << 8 ) | CAPFLAPI_D3D12 )
+
+    static_assert(CAPFL_9_1 == static_cast<uint32_t>(D3D_FEATURE_LEVEL_9_1) && CAPFL_10_0 == static_cast<uint32_t>(D3D_FEATURE_LEVEL_10_0)
+        && CAPFL_11_0 == static_cast<uint32_t>(D3D_FEATURE_LEVEL_11_0) && CAPFL_12_2 == static_cast<uint32_t>(D3D_FEATURE_LEVEL_12_2),
+        "Feature level mismatch");
+    static_assert(CAPFL_SHADER_MODEL_5_1 == static_cast<uint32_t>(D3D_SHADER_MODEL_5_1)
+        && CAPFL_SHADER_MODEL_6_7 == static_cast<uint32_t>(D3D_SHADER_MODEL_6_7), "Shader model mismatch");
+    static_assert(D3D12_RAYTRACING_TIER_1_0 == 10 && D3D12_RAYTRACING_TIER_1_1 == 11, "Raytracing tier mismatch");
 
-                D3D11_CONSERVATIVE_RASTERIZATION_TIER crast = D3D11_CONSERVATIVE_RASTERIZATION_NOT_SUPPORTED;
-                bool rovs, pssref;
-                CheckD3D11Ops2(pD3D11_3, tiled, crast, rovs, pssref);
+    //-----------------------------------------------------------------------------
+    // The limits in dxfeature.h are spelled out, so check them against the
+    // headers they come from
+    //-----------------------------------------------------------------------------
+    constexpr bool FLLimitsMatch(uint32_t fl, bool bD3D12, const char* strMaxTexDim, const char* strMaxCubeDim,
+        const char* strMaxVolDim, const char* strMaxTexRepeat, const char* strMaxAnisotropy, const char* strMaxPrimCount,
+        const char* strMaxInputSlots, const char* strMRT, const char* strUAVSlots)
+    {
+        return CapFLTextEquals(CapFindFLLimits(fl, bD3D12)->strMaxTexDim, strMaxTexDim)
+            && CapFLTextEquals(CapFindFLLimits(fl, bD3D12)->strMaxCubeDim, strMaxCubeDim)
+            && CapFLTextEquals(CapFindFLLimits(fl, bD3D12)->strMaxVolDim, strMaxVolDim)
+            && CapFLTextEquals(CapFindFLLimits(fl, bD3D12)->strMaxTexRepeat, strMaxTexRepeat)
+            && CapFLTextEquals(CapFindFLLimits(fl, bD3D12)->strMaxAnisotropy, strMaxAnisotropy)
+            && CapFLTextEquals(CapFindFLLimits(fl, bD3D12)->strMaxPrimCount, strMaxPrimCount)
+            && CapFLTextEquals(CapFindFLLimits(fl, bD3D12)->strMaxInputSlots, strMaxInputSlots)
+            && CapFLTextEquals(CapFindFLLimits(fl, bD3D12)->strMRT, strMRT)
+            && CapFLTextEquals(CapFindFLLimits(fl, bD3D12)->strUAVSlots, strUAVSlots);
+    }
 
-                switch (tiled)
-                {
-                    // 12.0 & 12.1 should be T2 or greater, 12.2 is T3 or greater
-                case D3D11_TILED_RESOURCES_TIER_2:          tiled_rsc = "Yes - Tier 2";  break;
-                case D3D11_TILED_RESOURCES_TIER_3:          tiled_rsc = "Yes - Tier 3";  break;
-                default:                                    tiled_rsc = c_szYes;         break;
-                }
+    static_assert(FLLimitsMatch(CAPFL_12_0, true,
+        XTOSTRING(D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION), XTOSTRING(D3D12_REQ_TEXTURECUBE_DIMENSION),
+        XTOSTRING(D3D12_REQ_TEXTURE3D_U_V_OR_W_DIMENSION), XTOSTRING(D3D12_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION),
+        XTOSTRING(D3D12_REQ_MAXANISOTROPY), "4294967296", XTOSTRING(D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT),
+        XTOSTRING(D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT), XTOSTRING(D3D12_UAV_SLOT_COUNT)), "12_x limits don't match d3d12.h");
+    static_assert(FLLimitsMatch(CAPFL_11_1, false,
+        XTOSTRING(D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION), XTOSTRING(D3D11_REQ_TEXTURECUBE_DIMENSION),
+        XTOSTRING(D3D11_REQ_TEXTURE3D_U_V_OR_W_DIMENSION), XTOSTRING(D3D11_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION),
+        XTOSTRING(D3D11_REQ_MAXANISOTROPY), "4294967296", XTOSTRING(D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT),
+        XTOSTRING(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT), XTOSTRING(D3D11_1_UAV_SLOT_COUNT)), "11_1 limits don't match d3d11.h");
+    static_assert(FLLimitsMatch(CAPFL_11_0, false,
+        XTOSTRING(D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION), XTOSTRING(D3D11_REQ_TEXTURECUBE_DIMENSION),
+        XTOSTRING(D3D11_REQ_TEXTURE3D_U_V_OR_W_DIMENSION), XTOSTRING(D3D11_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION),
+        XTOSTRING(D3D11_REQ_MAXANISOTROPY), "4294967296", XTOSTRING(D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT),
+        XTOSTRING(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT), "8"), "11_0 limits don't match d3d11.h");
+    static_assert(FLLimitsMatch(CAPFL_10_1, false,
+        XTOSTRING(D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION), XTOSTRING(D3D10_REQ_TEXTURECUBE_DIMENSION),
+        XTOSTRING(D3D10_REQ_TEXTURE3D_U_V_OR_W_DIMENSION), XTOSTRING(D3D10_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION),
+        XTOSTRING(D3D10_REQ_MAXANISOTROPY), "4294967296", XTOSTRING(D3D10_1_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT),
+        XTOSTRING(D3D10_SIMULTANEOUS_RENDER_TARGET_COUNT), nullptr), "10_1 limits don't match d3d10_1.h");
+    static_assert(FLLimitsMatch(CAPFL_10_0, false,
+        XTOSTRING(D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION), XTOSTRING(D3D10_REQ_TEXTURECUBE_DIMENSION),
+        XTOSTRING(D3D10_REQ_TEXTURE3D_U_V_OR_W_DIMENSION), XTOSTRING(D3D10_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION),
+        XTOSTRING(D3D10_REQ_MAXANISOTROPY), "4294967296", XTOSTRING(D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT),
+        XTOSTRING(D3D10_SIMULTANEOUS_RENDER_TARGET_COUNT), nullptr), "10_0 limits don't match d3d10.h");
+    static_assert(FLLimitsMatch(CAPFL_9_3, false,
+        XTOSTRING2(D3D_FL9_3_REQ_TEXTURE2D_U_OR_V_DIMENSION), XTOSTRING2(D3D_FL9_3_REQ_TEXTURECUBE_DIMENSION),
+        XTOSTRING2(D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION), XTOSTRING2(D3D_FL9_3_MAX_TEXTURE_REPEAT),
+        XTOSTRING(D3D11_REQ_MAXANISOTROPY), XTOSTRING2(D3D_FL9_2_IA_PRIMITIVE_MAX_COUNT), XTOSTRING(D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT),
+        XTOSTRING2(D3D_FL9_3_SIMULTANEOUS_RENDER_TARGET_COUNT), nullptr), "9_3 limits don't match d3dcommon.h");
+    static_assert(FLLimitsMatch(CAPFL_9_2, false,
+        XTOSTRING2(D3D_FL9_1_REQ_TEXTURE2D_U_OR_V_DIMENSION), XTOSTRING2(D3D_FL9_1_REQ_TEXTURECUBE_DIMENSION),
+        XTOSTRING2(D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION), XTOSTRING2(D3D_FL9_2_MAX_TEXTURE_REPEAT),
+        XTOSTRING(D3D11_REQ_MAXANISOTROPY), XTOSTRING2(D3D_FL9_2_IA_PRIMITIVE_MAX_COUNT), XTOSTRING(D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT),
+        XTOSTRING2(D3D_FL9_1_SIMULTANEOUS_RENDER_TARGET_COUNT), nullptr), "9_2 limits don't match d3dcommon.h");
+    static_assert(FLLimitsMatch(CAPFL_9_1, false,
+        XTOSTRING2(D3D_FL9_1_REQ_TEXTURE2D_U_OR_V_DIMENSION), XTOSTRING2(D3D_FL9_1_REQ_TEXTURECUBE_DIMENSION),
+        XTOSTRING2(D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION), XTOSTRING2(D3D_FL9_1_MAX_TEXTURE_REPEAT),
+        XTOSTRING2(D3D_FL9_1_DEFAULT_MAX_ANISOTROPY), XTOSTRING2(D3D_FL9_1_IA_PRIMITIVE_MAX_COUNT), XTOSTRING(D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT),
+        XTOSTRING2(D3D_FL9_1_SIMULTANEOUS_RENDER_TARGET_COUNT), nullptr), "9_1 limits don't match d3dcommon.h");
 
-                if (fl >= D3D_FEATURE_LEVEL_12_1)
-                {
-                    switch (crast)
-                    {
-                        // 12.1 requires T1
-                    case D3D11_CONSERVATIVE_RASTERIZATION_TIER_1:           consrv_rast = "Yes - Tier 1";  break;
-                    case D3D11_CONSERVATIVE_RASTERIZATION_TIER_2:           consrv_rast = "Yes - Tier 2";  break;
-                    case D3D11_CONSERVATIVE_RASTERIZATION_TIER_3:           consrv_rast = "Yes - Tier 3";  break;
-                    default:                                                consrv_rast = c_szYes;         break;
-                    }
+    //-----------------------------------------------------------------------------
+    // Name: D3D_FeatureLevel()
+    // Desc: The summary of a feature level of the device, derived from the level
+    //       and what the device answered once about what the level leaves
+    //       optional (see CapFeatureSummary)
+    //-----------------------------------------------------------------------------
+    HRESULT D3D_FeatureLevel(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
+    {
+        auto fl = static_cast<uint32_t>(lParam1);
+        auto pDevice = reinterpret_cast<IUnknown*>(lParam2);
+        if (!pDevice)
+            return S_OK;
 
-                    rast_ordered_views = c_szYes;
-                }
-                else
-                {
-                    switch (crast)
-                    {
-                    case D3D11_CONSERVATIVE_RASTERIZATION_NOT_SUPPORTED:    consrv_rast = c_szOptNo; break;
-                    case D3D11_CONSERVATIVE_RASTERIZATION_TIER_1:           consrv_rast = "Optional (Yes - Tier 1)";  break;
-                    case D3D11_CONSERVATIVE_RASTERIZATION_TIER_2:           consrv_rast = "Optional (Yes - Tier 2)";  break;
-                    case D3D11_CONSERVATIVE_RASTERIZATION_TIER_3:           consrv_rast = "Optional (Yes - Tier 3)";  break;
-                    default:                                                consrv_rast = c_szOptYes; break;
-                    }
+        auto api = static_cast<CAPFLAPI>(lParam3 & 0xff);
+        auto d3dType = static_cast<D3D_DRIVER_TYPE>((lParam3 & 0xff00) >> 8);
 
-                    rast_ordered_views = (rovs) ? c_szOptYes : c_szOptNo;
-                }
+        if (!pPrintInfo)
+        {
+            LVAddColumn(g_hwndLV, 0, "Name", 30);
+            LVAddColumn(g_hwndLV, 1, "Value", 60);
+        }
+
+        CAPFLOPTIONS options;
+        const CAPFLOPTIONS* pOptions = GetFeatureOptions(pDevice, api);
+        if (!pOptions)
+        {
+            FillFeatureOptions(pDevice, api, options);
+            pOptions = &options;
+        }
+
+        uint32_t flags = 0;
+        if (d3dType == D3D_DRIVER_TYPE_WARP)
+            flags |= CAPFLF_WARP;
+        if (g_DXGIFactory1)
+            flags |= CAPFLF_DXGI1_1;
 
-                ps_stencil_ref = (pssref) ? c_szOptYes : c_szOptNo;
-                minmaxfilter = c_szYes;
-                mapdefaultbuff = c_szYes;
+        CAPFLSUMMARY summary;
+        if (!CapFeatureSummary(fl, api, flags, *pOptions, summary))
+            return E_FAIL;
+
+        for (size_t i = 0; i < summary.count; ++i)
+        {
+            const CAPFLLINE& line = summary.lines[i];
+            if (!CapFLLineShown(line, g_dwViewState == IDM_VIEWALL, pPrintInfo != nullptr))
+                continue;
+
+            if (!pPrintInfo)
+            {
+                LVAddText(g_hwndLV, 0, "%s", line.strName);
+                LVAddText(g_hwndLV, 1, "%s", line.strValue);
             }
-            break;
+            else
+            {
+                PrintStringValueLine(line.strName, line.strValue, pPrintInfo);
+            }
+        }
 
-        case D3D_FEATURE_LEVEL_11_1:
-            shaderModel = "5.0";
-            computeShader = "Yes (CS 5.0)";
-            maxTexDim = XTOSTRING(D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION);
-            maxCubeDim = XTOSTRING(D3D11_REQ_TEXTURECUBE_DIMENSION);
-            maxVolDim = XTOSTRING(D3D11_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
-            maxTexRepeat = XTOSTRING(D3D11_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION);
-            maxAnisotropy = XTOSTRING(D3D11_REQ_MAXANISOTROPY);
-            maxInputSlots = XTOSTRING(D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
-            mrt = XTOSTRING(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT);
-            extFormats = c_szYes;
-            x2_10BitFormat = c_szYes;
-            logic_ops = c_szYes;
-            cb_partial = c_szYes;
-            cb_offsetting = c_szYes;
-            uavSlots = XTOSTRING(D3D11_1_UAV_SLOT_COUNT);
-            uavEveryStage = c_szYes;
-            uavOnlyRender = "16";
-            nonpow2 = "Full";
-            bpp16 = c_szYes;
-            instancing = c_szYes;
-
-            if (pD3D12)
-            {
-                shaderModel = "5.1";
-                computeShader = "Yes (CS 5.1)";
-
-                D3D12_FEATURE_DATA_D3D12_OPTIONS d3d12opts = {};
-                HRESULT hr = pD3D12->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &d3d12opts, sizeof(D3D12_FEATURE_DATA_D3D12_OPTIONS));
-                if (FAILED(hr))
-                    memset(&d3d12opts, 0, sizeof(d3d12opts));
+        if (!pPrintInfo)
+        {
+            LVLINE("Note", FL_NOTE);
+        }
+        else
+        {
+            PRINTLINE("Note", FL_NOTE);
+        }
 
-                switch (d3d12opts.TiledResourcesTier)
-                {
-                case D3D12_TILED_RESOURCES_TIER_NOT_SUPPORTED:  tiled_rsc = c_szOptNo; break;
-                case D3D12_TILED_RESOURCES_TIER_1:              tiled_rsc = "Optional (Yes - Tier 1)";  break;
-                case D3D12_TILED_RESOURCES_TIER_2:              tiled_rsc = "Optional (Yes - Tier 2)";  break;
-                case D3D12_TILED_RESOURCES_TIER_3:              tiled_rsc = "Optional (Yes - Tier 3)";  break;
-                case D3D12_TILED_RESOURCES_TIER_4:              tiled_rsc = "Optional (Yes - Tier 4)";  break;
-                default:                                        tiled_rsc = c_szOptYes; break;
-                }
+        return S_OK;
+    }
 
-                switch (d3d12opts.ResourceBindingTier)
-                {
-                case D3D12_RESOURCE_BINDING_TIER_1: binding_rsc = "Yes - Tier 1"; break;
-                case D3D12_RESOURCE_BINDING_TIER_2: binding_rsc = "Yes - Tier 2"; break;
-                case D3D12_RESOURCE_BINDING_TIER_3: binding_rsc = "Yes - Tier 3"; break;
-                default:                            binding_rsc = c_szYes;        break;
-                }
 
-                switch (d3d12opts.ConservativeRasterizationTier)
-                {
-                case D3D12_CONSERVATIVE_RASTERIZATION_TIER_NOT_SUPPORTED:   consrv_rast = c_szOptNo; break;
-                case D3D12_CONSERVATIVE_RASTERIZATION_TIER_1:               consrv_rast = "Optional (Yes - Tier 1)";  break;
-                case D3D12_CONSERVATIVE_RASTERIZATION_TIER_2:               consrv_rast = "Optional (Yes - Tier 2)";  break;
-                case D3D12_CONSERVATIVE_RASTERIZATION_TIER_3:               consrv_rast = "Optional (Yes - Tier 3)";  break;
-                default:                                                    consrv_rast = c_szOptYes; break;
-                }
+    //-----------------------------------------------------------------------------
+    HRESULT D3D10Info(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
+    {
+        auto pDevice = reinterpret_cast<ID3D10Device*>(lParam1);
+        if (!pDevice)
+            return S_OK;
+
+        if (!pPrintInfo)
+        {
+            LVAddColumn(g_hwndLV, 0, "Name", 30);
 
-                rast_ordered_views = (d3d12opts.ROVsSupported) ? c_szOptYes : c_szOptNo;
-                ps_stencil_ref = (d3d12opts.PSSpecifiedStencilRefSupported) ? c_szOptYes : c_szOptNo;
-                minmaxfilter = c_szYes;
-                mapdefaultbuff = c_szYes;
+            if (lParam2 == D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
+            {
+                LVAddColumn(g_hwndLV, 1, "Value", 25);
+                LVAddColumn(g_hwndLV, 2, "Quality Level", 25);
             }
-            else if (pD3D11_3)
+            else
             {
-                D3D11_TILED_RESOURCES_TIER tiled = D3D11_TILED_RESOURCES_NOT_SUPPORTED;
-                bool bMinMaxFilter, bMapDefaultBuff;
-                CheckD3D11Ops1(pD3D11_3, tiled, bMinMaxFilter, bMapDefaultBuff);
+                LVAddColumn(g_hwndLV, 1, "Value", 60);
+            }
+        }
 
-                D3D11_CONSERVATIVE_RASTERIZATION_TIER crast = D3D11_CONSERVATIVE_RASTERIZATION_NOT_SUPPORTED;
-                bool rovs, pssref;
-                CheckD3D11Ops2(pD3D11_3, tiled, crast, rovs, pssref);
+        if (!lParam2)
+        {
+            // General Direct3D 10.0 device information
 
-                switch (tiled)
-                {
-                case D3D11_TILED_RESOURCES_NOT_SUPPORTED:   tiled_rsc = c_szOptNo; break;
-                case D3D11_TILED_RESOURCES_TIER_1:          tiled_rsc = "Optional (Yes - Tier 1)";  break;
-                case D3D11_TILED_RESOURCES_TIER_2:          tiled_rsc = "Optional (Yes - Tier 2)";  break;
-                case D3D11_TILED_RESOURCES_TIER_3:          tiled_rsc = "Optional (Yes - Tier 3)";  break;
-                default:                                    tiled_rsc = c_szOptYes; break;
-                }
+            BOOL ext, x2;
+            CheckExtendedFormats(pDevice, ext, x2);
 
-                switch (crast)
+            if (!pPrintInfo)
+            {
+                if (g_DXGIFactory1)
                 {
-                case D3D11_CONSERVATIVE_RASTERIZATION_NOT_SUPPORTED:    consrv_rast = c_szOptNo; break;
-                case D3D11_CONSERVATIVE_RASTERIZATION_TIER_1:           consrv_rast = "Optional (Yes - Tier 1)";  break;
-                case D3D11_CONSERVATIVE_RASTERIZATION_TIER_2:           consrv_rast = "Optional (Yes - Tier 2)";  break;
-                case D3D11_CONSERVATIVE_RASTERIZATION_TIER_3:           consrv_rast = "Optional (Yes - Tier 3)";  break;
-                default:                                                consrv_rast = c_szOptYes; break;
+                    LVYESNO("Extended Formats (BGRA, etc.)", ext);
+                    LVYESNO("10-bit XR High Color Format", x2);
                 }
 
-                rast_ordered_views = (rovs) ? c_szOptYes : c_szOptNo;
-                ps_stencil_ref = (pssref) ? c_szOptYes : c_szOptNo;
-                minmaxfilter = bMinMaxFilter ? c_szOptYes : c_szOptNo;
-                mapdefaultbuff = bMapDefaultBuff ? c_szOptYes : c_szOptNo;
+                LVLINE("Note", D3D10_NOTE);
             }
-            else if (pD3D11_2)
+            else
             {
-                D3D11_TILED_RESOURCES_TIER tiled = D3D11_TILED_RESOURCES_NOT_SUPPORTED;
-                bool bMinMaxFilter, bMapDefaultBuff;
-                CheckD3D11Ops1(pD3D11_2, tiled, bMinMaxFilter, bMapDefaultBuff);
-
-                switch (tiled)
+                if (g_DXGIFactory1)
                 {
-                case D3D11_TILED_RESOURCES_NOT_SUPPORTED:   tiled_rsc = c_szOptNo; break;
-                case D3D11_TILED_RESOURCES_TIER_1:          tiled_rsc = "Optional (Yes - Tier 1)";  break;
-                case D3D11_TILED_RESOURCES_TIER_2:          tiled_rsc = "Optional (Yes - Tier 2)";  break;
-                default:                                    tiled_rsc = c_szOptYes; break;
+                    PRINTYESNO("Extended Formats (BGRA, etc.)", ext);
+                    PRINTYESNO("10-bit XR High Color Format", x2);
                 }
 
-                minmaxfilter = bMinMaxFilter ? c_szOptYes : c_szOptNo;
-                mapdefaultbuff = bMapDefaultBuff ? c_szOptYes : c_szOptNo;
+                PRINTLINE("Note", D3D10_NOTE);
             }
-            break;
-
-        case D3D_FEATURE_LEVEL_11_0:
-            shaderModel = "5.0";
-            computeShader = "Yes (CS 5.0)";
-            maxTexDim = XTOSTRING(D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION);
-            maxCubeDim = XTOSTRING(D3D11_REQ_TEXTURECUBE_DIMENSION);
-            maxVolDim = XTOSTRING(D3D11_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
-            maxTexRepeat = XTOSTRING(D3D11_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION);
-            maxAnisotropy = XTOSTRING(D3D11_REQ_MAXANISOTROPY);
-            maxInputSlots = XTOSTRING(D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
-            mrt = XTOSTRING(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT);
-            extFormats = c_szYes;
-            x2_10BitFormat = c_szYes;
-            instancing = c_szYes;
-
-            if (pD3D12)
-            {
-                shaderModel = "5.1";
-                computeShader = "Yes (CS 5.1)";
-
-                D3D12_FEATURE_DATA_D3D12_OPTIONS d3d12opts = {};
-                HRESULT hr = pD3D12->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &d3d12opts, sizeof(D3D12_FEATURE_DATA_D3D12_OPTIONS));
-                if (FAILED(hr))
-                    memset(&d3d12opts, 0, sizeof(d3d12opts));
-
-                switch (d3d12opts.TiledResourcesTier)
-                {
-                case D3D12_TILED_RESOURCES_TIER_NOT_SUPPORTED:  tiled_rsc = c_szOptNo; break;
-                case D3D12_TILED_RESOURCES_TIER_1:              tiled_rsc = "Optional (Yes - Tier 1)";  break;
-                case D3D12_TILED_RESOURCES_TIER_2:              tiled_rsc = "Optional (Yes - Tier 2)";  break;
-                case D3D12_TILED_RESOURCES_TIER_3:              tiled_rsc = "Optional (Yes - Tier 3)";  break;
-                case D3D12_TILED_RESOURCES_TIER_4:              tiled_rsc = "Optional (Yes - Tier 4)";  break;
-                default:                                        tiled_rsc = c_szOptYes; break;
-                }
 
-                switch (d3d12opts.ResourceBindingTier)
-                {
-                case D3D12_RESOURCE_BINDING_TIER_1: binding_rsc = "Yes - Tier 1"; break;
-                case D3D12_RESOURCE_BINDING_TIER_2: binding_rsc = "Yes - Tier 2"; break;
-                case D3D12_RESOURCE_BINDING_TIER_3: binding_rsc = "Yes - Tier 3"; break;
-                default:                            binding_rsc = c_szYes;        break;
-                }
+            return S_OK;
+        }
 
-                logic_ops = d3d12opts.OutputMergerLogicOp ? c_szOptYes : c_szOptNo;
-                consrv_rast = rast_ordered_views = ps_stencil_ref = minmaxfilter = c_szNo;
-                mapdefaultbuff = c_szYes;
+        // Use CheckFormatSupport for format usage defined as optional for Direct3D 10 devices
+        static const DXGI_FORMAT cfsShaderSample[] =
+        {
+            DXGI_FORMAT_R32G32B32A32_FLOAT,
+            DXGI_FORMAT_R32G32B32_FLOAT,
+            DXGI_FORMAT_R32G32_FLOAT,
+            DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS,
+            DXGI_FORMAT_R32_FLOAT,
+            DXGI_FORMAT_R24_UNORM_X8_TYPELESS
+        };
 
-                uavSlots = "8";
-                uavEveryStage = c_szNo;
-                uavOnlyRender = "8";
-                nonpow2 = "Full";
-            }
-            else if (pD3D11_3)
-            {
-                D3D11_TILED_RESOURCES_TIER tiled = D3D11_TILED_RESOURCES_NOT_SUPPORTED;
-                bool bMinMaxFilter, bMapDefaultBuff;
-                CheckD3D11Ops1(pD3D11_3, tiled, bMinMaxFilter, bMapDefaultBuff);
+        static const DXGI_FORMAT cfsMipAutoGen[] =
+        {
+            DXGI_FORMAT_R32G32B32_FLOAT
+        };
 
-                D3D11_FEATURE_DATA_D3D11_OPTIONS2 d3d11opts2 = {};
-                HRESULT hr = pD3D11_3->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS2, &d3d11opts2, sizeof(d3d11opts2));
-                if (SUCCEEDED(hr))
-                {
-                    // D3D11_FEATURE_DATA_D3D11_OPTIONS1 caps this at Tier 2
-                    tiled = d3d11opts2.TiledResourcesTier;
-                }
+        static const DXGI_FORMAT cfsRenderTarget[] =
+        {
+            DXGI_FORMAT_R32G32B32_FLOAT,
+            DXGI_FORMAT_R32G32B32_UINT,
+            DXGI_FORMAT_R32G32B32_SINT
+        };
 
-                switch (tiled)
-                {
-                case D3D11_TILED_RESOURCES_NOT_SUPPORTED:   tiled_rsc = c_szOptNo; break;
-                case D3D11_TILED_RESOURCES_TIER_1:          tiled_rsc = "Optional (Yes - Tier 1)";  break;
-                case D3D11_TILED_RESOURCES_TIER_2:          tiled_rsc = "Optional (Yes - Tier 2)";  break;
-                case D3D11_TILED_RESOURCES_TIER_3:          tiled_rsc = "Optional (Yes - Tier 3)";  break;
-                default:                                    tiled_rsc = c_szOptYes; break;
-                }
+        static const DXGI_FORMAT cfsBlendableRT[] =
+        {
+            DXGI_FORMAT_R32G32B32_FLOAT,
+            DXGI_FORMAT_R16G16B16A16_UNORM,
+            DXGI_FORMAT_R16G16_UNORM,
+            DXGI_FORMAT_R16_UNORM
+        };
 
-                consrv_rast = rast_ordered_views = ps_stencil_ref = minmaxfilter = c_szNo;
-                mapdefaultbuff = bMapDefaultBuff ? c_szOptYes : c_szOptNo;
-            }
-            else if (pD3D11_2)
-            {
-                D3D11_TILED_RESOURCES_TIER tiled = D3D11_TILED_RESOURCES_NOT_SUPPORTED;
-                bool bMinMaxFilter, bMapDefaultBuff;
-                CheckD3D11Ops1(pD3D11_2, tiled, bMinMaxFilter, bMapDefaultBuff);
+        UINT count = 0;
+        const DXGI_FORMAT* array = nullptr;
+        BOOL skips = FALSE;
 
-                switch (tiled)
-                {
-                case D3D11_TILED_RESOURCES_NOT_SUPPORTED:   tiled_rsc = c_szOptNo; break;
-                case D3D11_TILED_RESOURCES_TIER_1:          tiled_rsc = "Optional (Yes - Tier 1)";  break;
-                case D3D11_TILED_RESOURCES_TIER_2:          tiled_rsc = "Optional (Yes - Tier 2)";  break;
-                default:                                    tiled_rsc = c_szOptYes; break;
-                }
+        switch (lParam2)
+        {
+        case D3D10_FORMAT_SUPPORT_SHADER_SAMPLE:
+            count = sizeof(cfsShaderSample) / sizeof(DXGI_FORMAT);
+            array = cfsShaderSample;
+            break;
 
-                minmaxfilter = c_szNo;
-                mapdefaultbuff = bMapDefaultBuff ? c_szOptYes : c_szOptNo;
-            }
+        case D3D10_FORMAT_SUPPORT_MIP_AUTOGEN:
+            count = sizeof(cfsMipAutoGen) / sizeof(DXGI_FORMAT);
+            array = cfsMipAutoGen;
+            break;
 
-            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
-            {
-                ID3D11Device* pD3D = (pD3D11_3) ? pD3D11_3 : ((pD3D11_2) ? pD3D11_2 : pD3D11_1);
+        case D3D10_FORMAT_SUPPORT_RENDER_TARGET:
+            count = sizeof(cfsRenderTarget) / sizeof(DXGI_FORMAT);
+            array = cfsRenderTarget;
+            break;
 
-                bool bLogicOps, bCBpartial, bCBoffsetting;
-                CheckD3D11Ops(pD3D, bLogicOps, bCBpartial, bCBoffsetting);
-                logic_ops = bLogicOps ? c_szOptYes : c_szOptNo;
-                cb_partial = bCBpartial ? c_szOptYes : c_szOptNo;
-                cb_offsetting = bCBoffsetting ? c_szOptYes : c_szOptNo;
+        case D3D10_FORMAT_SUPPORT_BLENDABLE:
+            count = sizeof(cfsBlendableRT) / sizeof(DXGI_FORMAT);
+            array = cfsBlendableRT;
+            break;
 
-                BOOL ext, x2, bpp565;
-                CheckExtendedFormats(pD3D, ext, x2, bpp565);
-                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+        case D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET:
+            count = g_cfsMSAA_10.count;
+            array = g_cfsMSAA_10.formats;
+            break;
 
-                uavSlots = "8";
-                uavEveryStage = c_szNo;
-                uavOnlyRender = "8";
-                nonpow2 = "Full";
-            }
+        case D3D10_FORMAT_SUPPORT_MULTISAMPLE_LOAD:
+            count = g_cfsMSAA_10.count;
+            array = g_cfsMSAA_10.formats;
+            skips = TRUE;
             break;
 
-        case D3D_FEATURE_LEVEL_10_1:
-            shaderModel = "4.x";
-            instancing = c_szYes;
+        default:
+            return E_FAIL;
+        }
 
-            if (pD3D11_3)
-            {
-                consrv_rast = rast_ordered_views = ps_stencil_ref = c_szNo;
-            }
+        for (UINT i = 0; i < count; ++i)
+        {
+            DXGI_FORMAT fmt = array[i];
 
-            if (pD3D11_2 || pD3D11_3)
+            if (skips)
             {
-                tiled_rsc = minmaxfilter = mapdefaultbuff = c_szNo;
+                // Special logic to let us reuse the MSAA array twice with a few special cases that are skipped
+                switch (fmt)
+                {
+                case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+                case DXGI_FORMAT_D32_FLOAT:
+                case DXGI_FORMAT_D24_UNORM_S8_UINT:
+                case DXGI_FORMAT_D16_UNORM:
+                    continue;
+                }
             }
 
-            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
+            if (lParam2 == D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
             {
-                ID3D11Device* pD3D = (pD3D11_3) ? pD3D11_3 : ((pD3D11_2) ? pD3D11_2 : pD3D11_1);
+                UINT quality = GetFormatQuality(pDevice, fmt, (UINT)lParam3);
 
-                D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS d3d10xhw = {};
-                HRESULT hr = pD3D->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &d3d10xhw, sizeof(d3d10xhw));
-                if (FAILED(hr))
-                    memset(&d3d10xhw, 0, sizeof(d3d10xhw));
+                BOOL msaa = (quality > 0);
 
-                if (d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x)
+                if (!pPrintInfo)
                 {
-                    computeShader = "Optional (Yes - CS 4.x)";
-                    uavSlots = "1";
-                    uavEveryStage = c_szNo;
-                    uavOnlyRender = c_szNo;
+                    if (g_dwViewState == IDM_VIEWALL || msaa)
+                    {
+                        LVAddText(g_hwndLV, 0, FormatName(fmt));
+                        LVAddText(g_hwndLV, 1, msaa ? c_szYes : c_szNo); \
+
+                            TCHAR strBuffer[16];
+                        sprintf_s(strBuffer, 16, "%u", msaa ? quality : 0);
+                        LVAddText(g_hwndLV, 2, strBuffer);
+                    }
                 }
                 else
                 {
-                    computeShader = c_szOptNo;
-                }
-
-                bool bLogicOps, bCBpartial, bCBoffsetting;
-                CheckD3D11Ops(pD3D, bLogicOps, bCBpartial, bCBoffsetting);
-                logic_ops = bLogicOps ? c_szOptYes : c_szOptNo;
-                cb_partial = bCBpartial ? c_szOptYes : c_szOptNo;
-                cb_offsetting = bCBoffsetting ? c_szOptYes : c_szOptNo;
-
-                BOOL ext, x2, bpp565;
-                CheckExtendedFormats(pD3D, ext, x2, bpp565);
+                    TCHAR strBuffer[32];
+                    if (msaa)
+                        sprintf_s(strBuffer, 32, "Yes (%u)", quality);
+                    else
+                        strcpy_s(strBuffer, 32, c_szNo);
 
-                extFormats = (ext) ? c_szOptYes : c_szOptNo;
-                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
-                nonpow2 = "Full";
-                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+                    PrintStringValueLine(FormatName(fmt), strBuffer, pPrintInfo);
+                }
             }
-            else if (pD3D11)
+            else
             {
-                D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS d3d10xhw = {};
-                HRESULT hr = pD3D11->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &d3d10xhw, sizeof(d3d10xhw));
-                if (FAILED(hr))
-                    memset(&d3d10xhw, 0, sizeof(d3d10xhw));
+                UINT fmtSupport = GetFormatSupport(pDevice, fmt);
 
-                computeShader = (d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x) ? "Optional (Yes - CS 4.x)" : c_szOptNo;
-
-                BOOL ext, x2, bpp565;
-                CheckExtendedFormats(pD3D11, ext, x2, bpp565);
-
-                extFormats = (ext) ? c_szOptYes : c_szOptNo;
-                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
-            }
-            else if (pD3D10_1)
-            {
-                BOOL ext, x2;
-                CheckExtendedFormats(pD3D10_1, ext, x2);
-
-                extFormats = (ext) ? c_szOptYes : c_szOptNo;
-                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
-            }
-            else if (pD3D10)
-            {
-                BOOL ext, x2;
-                CheckExtendedFormats(pD3D10, ext, x2);
-
-                extFormats = (ext) ? c_szOptYes : c_szOptNo;
-                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
-            }
-
-            maxTexDim = XTOSTRING(D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION);
-            maxCubeDim = XTOSTRING(D3D10_REQ_TEXTURECUBE_DIMENSION);
-            maxVolDim = XTOSTRING(D3D10_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
-            maxTexRepeat = XTOSTRING(D3D10_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION);
-            maxAnisotropy = XTOSTRING(D3D10_REQ_MAXANISOTROPY);
-            maxInputSlots = XTOSTRING(D3D10_1_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
-            mrt = XTOSTRING(D3D10_SIMULTANEOUS_RENDER_TARGET_COUNT);
-            break;
-
-        case D3D_FEATURE_LEVEL_10_0:
-            shaderModel = "4.0";
-            instancing = c_szYes;
-
-            if (pD3D11_3)
-            {
-                consrv_rast = rast_ordered_views = ps_stencil_ref = c_szNo;
-            }
-
-            if (pD3D11_2 || pD3D11_3)
-            {
-                tiled_rsc = minmaxfilter = mapdefaultbuff = c_szNo;
-            }
-
-            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
-            {
-                ID3D11Device* pD3D = (pD3D11_3) ? pD3D11_3 : ((pD3D11_2) ? pD3D11_2 : pD3D11_1);
-
-                D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS d3d10xhw = {};
-                HRESULT hr = pD3D->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &d3d10xhw, sizeof(d3d10xhw));
-                if (FAILED(hr))
-                    memset(&d3d10xhw, 0, sizeof(d3d10xhw));
-
-                if (d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x)
+                if (!pPrintInfo)
                 {
-                    computeShader = "Optional (Yes - CS 4.x)";
-                    uavSlots = "1";
-                    uavEveryStage = c_szNo;
-                    uavOnlyRender = c_szNo;
+                    LVYESNO(FormatName(fmt), fmtSupport & (UINT)lParam2);
                 }
                 else
                 {
-                    computeShader = c_szOptNo;
+                    PRINTYESNO(FormatName(fmt), fmtSupport & (UINT)lParam2);
                 }
+            }
+        }
 
-                bool bLogicOps, bCBpartial, bCBoffsetting;
-                CheckD3D11Ops(pD3D, bLogicOps, bCBpartial, bCBoffsetting);
-                logic_ops = bLogicOps ? c_szOptYes : c_szOptNo;
-                cb_partial = bCBpartial ? c_szOptYes : c_szOptNo;
-                cb_offsetting = bCBoffsetting ? c_szOptYes : c_szOptNo;
+        return S_OK;
+    }
+
+    HRESULT D3D10Info1(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
+    {
+        auto pDevice = reinterpret_cast<ID3D10Device1*>(lParam1);
+        if (!pDevice)
+            return S_OK;
 
-                BOOL ext, x2, bpp565;
-                CheckExtendedFormats(pD3D, ext, x2, bpp565);
+        if (!pPrintInfo)
+        {
+            LVAddColumn(g_hwndLV, 0, "Name", 30);
 
-                extFormats = (ext) ? c_szOptYes : c_szOptNo;
-                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
-                nonpow2 = "Full";
-                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+            if (lParam2 == D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
+            {
+                LVAddColumn(g_hwndLV, 1, "Value", 25);
+                LVAddColumn(g_hwndLV, 2, "Quality Level", 25);
             }
-            else if (pD3D11)
+            else
             {
-                D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS d3d10xhw = {};
-                HRESULT hr = pD3D11->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &d3d10xhw, sizeof(d3d10xhw));
-                if (FAILED(hr))
-                    memset(&d3d10xhw, 0, sizeof(d3d10xhw));
+                LVAddColumn(g_hwndLV, 1, "Value", 60);
+            }
+        }
 
-                computeShader = (d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x) ? "Optional (Yes - CS 4.0)" : c_szOptNo;
+        if (!lParam2)
+        {
+            // General Direct3D 10.1 device information
+            D3D10_FEATURE_LEVEL1 fl = pDevice->GetFeatureLevel();
 
-                BOOL ext, x2, bpp565;
-                CheckExtendedFormats(pD3D11, ext, x2, bpp565);
+            const char* szNote = nullptr;
 
-                extFormats = (ext) ? c_szOptYes : c_szOptNo;
-                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
-            }
-            else if (pD3D10_1)
+            switch (fl)
             {
-                BOOL ext, x2;
-                CheckExtendedFormats(pD3D10_1, ext, x2);
+            case D3D10_FEATURE_LEVEL_10_0:
+                szNote = SEE_D3D10;
+                break;
 
-                extFormats = (ext) ? c_szOptYes : c_szOptNo;
-                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
-            }
-            else if (pD3D10)
-            {
-                BOOL ext, x2;
-                CheckExtendedFormats(pD3D10, ext, x2);
+            case D3D10_FEATURE_LEVEL_9_3:
+            case D3D10_FEATURE_LEVEL_9_2:
+            case D3D10_FEATURE_LEVEL_9_1:
+                szNote = _10L9_NOTE;
+                break;
 
-                extFormats = (ext) ? c_szOptYes : c_szOptNo;
-                x2_10BitFormat = (x2) ? c_szOptYes : c_szOptNo;
+            default:
+                szNote = D3D10_NOTE1;
+                break;
             }
 
-            maxTexDim = XTOSTRING(D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION);
-            maxCubeDim = XTOSTRING(D3D10_REQ_TEXTURECUBE_DIMENSION);
-            maxVolDim = XTOSTRING(D3D10_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
-            maxTexRepeat = XTOSTRING(D3D10_REQ_FILTERING_HW_ADDRESSABLE_RESOURCE_DIMENSION);
-            maxAnisotropy = XTOSTRING(D3D10_REQ_MAXANISOTROPY);
-            maxInputSlots = XTOSTRING(D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
-            mrt = XTOSTRING(D3D10_SIMULTANEOUS_RENDER_TARGET_COUNT);
-            break;
-
-        case D3D_FEATURE_LEVEL_9_3:
-            _10level9 = TRUE;
-            shaderModel = "2.0 (4_0_level_9_3) [vs_2_a/ps_2_b]";
-            computeShader = c_szNA;
-            maxTexDim = XTOSTRING2(D3D_FL9_3_REQ_TEXTURE2D_U_OR_V_DIMENSION);
-            maxCubeDim = XTOSTRING2(D3D_FL9_3_REQ_TEXTURECUBE_DIMENSION);
-            maxVolDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
-            maxTexRepeat = XTOSTRING2(D3D_FL9_3_MAX_TEXTURE_REPEAT);
-            maxAnisotropy = XTOSTRING(D3D11_REQ_MAXANISOTROPY);
-            maxPrimCount = XTOSTRING2(D3D_FL9_2_IA_PRIMITIVE_MAX_COUNT);
-            maxInputSlots = XTOSTRING(D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
-            mrt = XTOSTRING2(D3D_FL9_3_SIMULTANEOUS_RENDER_TARGET_COUNT);
-            extFormats = c_szYes;
-            instancing = c_szYes;
+            BOOL ext, x2;
+            CheckExtendedFormats(pDevice, ext, x2);
 
-            if (pD3D11_2 || pD3D11_3)
+            if (!pPrintInfo)
             {
-                ID3D11Device* pD3D = (pD3D11_3) ? pD3D11_3 : pD3D11_2;
-
-                cb_partial = c_szYes;
-                cb_offsetting = c_szYes;
-
-                BOOL ext, x2, bpp565;
-                CheckExtendedFormats(pD3D, ext, x2, bpp565);
+                LVLINE("Feature Level", FLName(fl));
 
-                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+                    if (g_DXGIFactory1 != nullptr && (fl >= D3D10_FEATURE_LEVEL_10_0))
+                    {
+                        LVYESNO("Extended Formats (BGRA, etc.)", ext);
+                        LVYESNO("10-bit XR High Color Format", x2);
+                    }
 
-                bool bNonPow2, bShadows, bInstancing, bCubeRT;
-                CheckD3D9Ops1(pD3D, bNonPow2, bShadows, bInstancing, bCubeRT);
-                nonpow2 = bNonPow2 ? "Optional (Full)" : "Conditional";
-                shadows = bShadows ? c_szOptYes : c_szOptNo;
-                cubeRT = bCubeRT ? c_szOptYes : c_szOptNo;
+                    LVLINE("Note", szNote);
             }
-            else if (pD3D11_1)
+            else
             {
-                cb_partial = c_szYes;
-                cb_offsetting = c_szYes;
-
-                BOOL ext, x2, bpp565;
-                CheckExtendedFormats(pD3D11_1, ext, x2, bpp565);
+                PRINTLINE("Feature Level", FLName(fl));
 
-                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+                    if (g_DXGIFactory1 != nullptr && (fl >= D3D10_FEATURE_LEVEL_10_0))
+                    {
+                        PRINTYESNO("Extended Formats (BGRA, etc.)", ext);
+                        PRINTYESNO("10-bit XR High Color Format", x2);
+                    }
 
-                bool bNonPow2, bShadows;
-                CheckD3D9Ops(pD3D11_1, bNonPow2, bShadows);
-                nonpow2 = bNonPow2 ? "Optional (Full)" : "Conditional";
-                shadows = bShadows ? c_szOptYes : c_szOptNo;
+                    PRINTLINE("Note", szNote);
             }
-            break;
 
-        case D3D_FEATURE_LEVEL_9_2:
-            _10level9 = TRUE;
-            shaderModel = "2.0 (4_0_level_9_1)";
-            computeShader = c_szNA;
-            maxTexDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURE2D_U_OR_V_DIMENSION);
-            maxCubeDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURECUBE_DIMENSION);
-            maxVolDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
-            maxTexRepeat = XTOSTRING2(D3D_FL9_2_MAX_TEXTURE_REPEAT);
-            maxAnisotropy = XTOSTRING(D3D11_REQ_MAXANISOTROPY);
-            maxPrimCount = XTOSTRING2(D3D_FL9_2_IA_PRIMITIVE_MAX_COUNT);
-            maxInputSlots = XTOSTRING(D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
-            mrt = XTOSTRING2(D3D_FL9_1_SIMULTANEOUS_RENDER_TARGET_COUNT);
-            extFormats = c_szYes;
-            instancing = c_szNo;
-
-            if (pD3D11_2 || pD3D11_3)
-            {
-                ID3D11Device* pD3D = (pD3D11_3) ? pD3D11_3 : pD3D11_2;
+            return S_OK;
+        }
 
-                cb_partial = c_szYes;
-                cb_offsetting = c_szYes;
+        // Use CheckFormatSupport for format usage defined as optional for Direct3D 10.1 devices
+        static const DXGI_FORMAT cfsShaderSample[] =
+        {
+            DXGI_FORMAT_R32G32B32_FLOAT
+        };
 
-                BOOL ext, x2, bpp565;
-                CheckExtendedFormats(pD3D, ext, x2, bpp565);
+        static const DXGI_FORMAT cfsMipAutoGen[] =
+        {
+            DXGI_FORMAT_R32G32B32_FLOAT
+        };
 
-                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+        static const DXGI_FORMAT cfsRenderTarget[] =
+        {
+            DXGI_FORMAT_R32G32B32_FLOAT,
+            DXGI_FORMAT_R32G32B32_UINT,
+            DXGI_FORMAT_R32G32B32_SINT
+        };
 
-                bool bNonPow2, bShadows, bInstancing, bCubeRT;
-                CheckD3D9Ops1(pD3D, bNonPow2, bShadows, bInstancing, bCubeRT);
-                nonpow2 = bNonPow2 ? "Optional (Full)" : "Conditional";
-                shadows = bShadows ? c_szOptYes : c_szOptNo;
-                instancing = bInstancing ? "Optional (Simple)" : c_szOptNo;
-                cubeRT = bCubeRT ? c_szOptYes : c_szOptNo;
-            }
-            else if (pD3D11_1)
-            {
-                cb_partial = c_szYes;
-                cb_offsetting = c_szYes;
+        // Most RT formats are required to support 4x MSAA for 10.1 devices
+        static const DXGI_FORMAT cfsMSAA4x[] =
+        {
+            DXGI_FORMAT_R32G32B32A32_FLOAT,
+            DXGI_FORMAT_R32G32B32A32_UINT,
+            DXGI_FORMAT_R32G32B32A32_SINT,
+            DXGI_FORMAT_R32G32B32_FLOAT,
+            DXGI_FORMAT_R32G32B32_UINT,
+            DXGI_FORMAT_R32G32B32_SINT,
+        };
 
-                BOOL ext, x2, bpp565;
-                CheckExtendedFormats(pD3D11_1, ext, x2, bpp565);
+        UINT count = 0;
+        const DXGI_FORMAT* array = nullptr;
 
-                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
+        switch (lParam2)
+        {
+        case D3D10_FORMAT_SUPPORT_SHADER_SAMPLE:
+            count = sizeof(cfsShaderSample) / sizeof(DXGI_FORMAT);
+            array = cfsShaderSample;
+            break;
 
-                bool bNonPow2, bShadows;
-                CheckD3D9Ops(pD3D11_1, bNonPow2, bShadows);
-                nonpow2 = bNonPow2 ? "Optional (Full)" : "Conditional";
-                shadows = bShadows ? c_szOptYes : c_szOptNo;
-            }
+        case D3D10_FORMAT_SUPPORT_MIP_AUTOGEN:
+            count = sizeof(cfsMipAutoGen) / sizeof(DXGI_FORMAT);
+            array = cfsMipAutoGen;
             break;
 
-        case D3D_FEATURE_LEVEL_9_1:
-            _10level9 = TRUE;
-            shaderModel = "2.0 (4_0_level_9_1)";
-            computeShader = c_szNA;
-            maxTexDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURE2D_U_OR_V_DIMENSION);
-            maxCubeDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURECUBE_DIMENSION);
-            maxVolDim = XTOSTRING2(D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION);
-            maxTexRepeat = XTOSTRING2(D3D_FL9_1_MAX_TEXTURE_REPEAT);
-            maxAnisotropy = XTOSTRING2(D3D_FL9_1_DEFAULT_MAX_ANISOTROPY);
-            maxPrimCount = XTOSTRING2(D3D_FL9_1_IA_PRIMITIVE_MAX_COUNT);
-            maxInputSlots = XTOSTRING(D3D10_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
-            mrt = XTOSTRING2(D3D_FL9_1_SIMULTANEOUS_RENDER_TARGET_COUNT);
-            extFormats = c_szYes;
-            instancing = c_szNo;
+        case D3D10_FORMAT_SUPPORT_RENDER_TARGET:
+            count = sizeof(cfsRenderTarget) / sizeof(DXGI_FORMAT);
+            array = cfsRenderTarget;
+            break;
 
-            if (pD3D11_2 || pD3D11_3)
+        case D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET:
+            if (pDevice->GetFeatureLevel() <= D3D10_FEATURE_LEVEL_9_3)
             {
-                ID3D11Device* pD3D = (pD3D11_3) ? pD3D11_3 : pD3D11_2;
-
-                cb_partial = c_szYes;
-                cb_offsetting = c_szYes;
-
-                BOOL ext, x2, bpp565;
-                CheckExtendedFormats(pD3D, ext, x2, bpp565);
-
-                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
-
-                bool bNonPow2, bShadows, bInstancing, bCubeRT;
-                CheckD3D9Ops1(pD3D, bNonPow2, bShadows, bInstancing, bCubeRT);
-                nonpow2 = bNonPow2 ? "Optional (Full)" : "Conditional";
-                shadows = bShadows ? c_szOptYes : c_szOptNo;
-                instancing = bInstancing ? "Optional (Simple)" : c_szOptNo;
-                cubeRT = bCubeRT ? c_szOptYes : c_szOptNo;
+                count = sizeof(g_cfsMSAA_10level9) / sizeof(DXGI_FORMAT);
+                array = g_cfsMSAA_10level9;
             }
-            else if (pD3D11_1)
+            else if (g_dwViewState != IDM_VIEWALL && lParam3 == 4)
             {
-                cb_partial = c_szYes;
-                cb_offsetting = c_szYes;
-
-                BOOL ext, x2, bpp565;
-                CheckExtendedFormats(pD3D11_1, ext, x2, bpp565);
-
-                bpp16 = (bpp565) ? c_szOptYes : c_szOptNo;
-
-                bool bNonPow2, bShadows;
-                CheckD3D9Ops(pD3D11_1, bNonPow2, bShadows);
-                nonpow2 = bNonPow2 ? "Optional (Full)" : "Conditional";
-                shadows = bShadows ? c_szOptYes : c_szOptNo;
+                count = sizeof(cfsMSAA4x) / sizeof(DXGI_FORMAT);
+                array = cfsMSAA4x;
+            }
+            else
+            {
+                count = g_cfsMSAA_10.count;
+                array = g_cfsMSAA_10.formats;
             }
             break;
 
@@ -2020,392 +2064,161 @@ namespace
             return E_FAIL;
         }
 
-        if (d3dType == D3D_DRIVER_TYPE_WARP)
-        {
-            maxTexDim = (pD3D12 || pD3D11_3 || pD3D11_2 || pD3D11_1) ? "16777216" : "65536";
-        }
-
-        if (pD3D12)
+        for (UINT i = 0; i < count; ++i)
         {
-            if (!vrs)
-            {
-                vrs = D3D12VRSSupported(pD3D12);
-            }
-
-            if (!meshShaders)
-            {
-                meshShaders = IsD3D12MeshShaderSupported(pD3D12) ? c_szOptYes : c_szOptNo;
-            }
+            DXGI_FORMAT fmt = array[i];
 
-            if (!dxr)
+            if (lParam2 == D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
             {
-                dxr = D3D12DXRSupported(pD3D12);
-            }
-        }
+                UINT quality = GetFormatQuality(pDevice, fmt, (UINT)lParam3);
 
-        if (!pPrintInfo)
-        {
-            LVLINE("Shader Model", shaderModel);
-            LVYESNO("Geometry Shader", (fl >= D3D_FEATURE_LEVEL_10_0));
-            LVYESNO("Stream Out", (fl >= D3D_FEATURE_LEVEL_10_0));
+                BOOL msaa = (quality > 0);
 
-            if (pD3D12 || pD3D11_3 || pD3D11_2 || pD3D11_1 || pD3D11)
-            {
-                if (g_dwViewState == IDM_VIEWALL || computeShader != c_szNo)
+                if (!pPrintInfo)
                 {
-                    LVLINE("DirectCompute", computeShader);
+                    if (g_dwViewState == IDM_VIEWALL || msaa)
+                    {
+                        LVAddText(g_hwndLV, 0, FormatName(fmt));
+                        LVAddText(g_hwndLV, 1, msaa ? c_szYes : c_szNo); \
+
+                            TCHAR strBuffer[16];
+                        sprintf_s(strBuffer, 16, "%u", msaa ? quality : 0);
+                        LVAddText(g_hwndLV, 2, strBuffer);
+                    }
                 }
+                else
+                {
+                    TCHAR strBuffer[32];
+                    if (msaa)
+                        sprintf_s(strBuffer, 32, "Yes (%u)", quality);
+                    else
+                        strcpy_s(strBuffer, 32, c_szNo);
 
-                LVYESNO("Hull & Domain Shaders", (fl >= D3D_FEATURE_LEVEL_11_0));
+                    PrintStringValueLine(FormatName(fmt), strBuffer, pPrintInfo);
+                }
             }
-
-            if (pD3D12)
+            else
             {
-                LVLINE("Variable Rate Shading (VRS)", vrs);
-                LVLINE("Mesh & Amplification Shaders", meshShaders);
-                LVLINE("DirectX Raytracing", dxr);
+                UINT fmtSupport = GetFormatSupport(pDevice, fmt);
+
+                if (!pPrintInfo)
+                {
+                    LVYESNO(FormatName(fmt), fmtSupport& (UINT)lParam2);
+                }
+                else
+                {
+                    PRINTYESNO(FormatName(fmt), fmtSupport & (UINT)lParam2);
+                }
             }
+        }
 
-            LVYESNO("Texture Resource Arrays", (fl >= D3D_FEATURE_LEVEL_10_0));
+        return S_OK;
+    }
 
-            if (d3dVer != 0)
-            {
-                LVYESNO("Cubemap Resource Arrays", (fl >= D3D_FEATURE_LEVEL_10_1));
-            }
 
-            LVYESNO("BC4/BC5 Compression", (fl >= D3D_FEATURE_LEVEL_10_0));
+    HRESULT D3D10InfoMSAA(LPARAM lParam1, LPARAM /*lParam2*/, PRINTCBINFO* pPrintInfo)
+    {
+        auto pDevice = reinterpret_cast<ID3D10Device*>(lParam1);
+        if (!pDevice)
+            return S_OK;
 
-            if (pD3D12 || pD3D11_3 || pD3D11_2 || pD3D11_1 || pD3D11)
-            {
-                LVYESNO("BC6H/BC7 Compression", (fl >= D3D_FEATURE_LEVEL_11_0));
-            }
+        BOOL sampCount[D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT];
+        GetMSAASampleCounts(pDevice, g_cfsMSAA_10.formats, g_cfsMSAA_10.count, sampCount);
 
-            LVYESNO("Alpha-to-coverage", (fl >= D3D_FEATURE_LEVEL_10_0));
+        if (!pPrintInfo)
+        {
+            LVAddColumn(g_hwndLV, 0, "Name", 30);
 
-            if (pD3D11_1 || pD3D11_2 || pD3D11_3 || pD3D12)
+            UINT column = 1;
+            for (UINT samples = 2; samples <= D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT; ++samples)
             {
-                LVLINE("Logic Ops (Output Merger)", logic_ops);
+                if (!sampCount[samples - 1] && !IsMSAAPowerOf2(samples))
+                    continue;
+
+                TCHAR strBuffer[8];
+                sprintf_s(strBuffer, 8, "%ux", samples);
+                LVAddColumn(g_hwndLV, column, strBuffer, 8);
+                ++column;
             }
+        }
 
-            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
-            {
-                LVLINE("Constant Buffer Partial Updates", cb_partial);
-                LVLINE("Constant Buffer Offsetting", cb_offsetting);
+        const UINT count = g_cfsMSAA_10.count;
 
-                if (uavEveryStage)
-                {
-                    LVLINE("UAVs at Every Stage", uavEveryStage);
-                }
+        for (UINT i = 0; i < count; ++i)
+        {
+            DXGI_FORMAT fmt = g_cfsMSAA_10.formats[i];
 
-                if (uavOnlyRender)
-                {
-                    LVLINE("UAV-only rendering", uavOnlyRender);
-                }
-            }
+            UINT sampQ[D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT];
+            memset(sampQ, 0, sizeof(sampQ));
 
-            if (pD3D11_2 || pD3D11_3 || pD3D12)
+            BOOL any = FALSE;
+            for (UINT samples = 2; samples <= D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT; ++samples)
             {
-                if (tiled_rsc)
+                UINT quality = GetFormatQuality(pDevice, fmt, samples);
+
+                if (quality > 0)
                 {
-                    LVLINE("Tiled Resources", tiled_rsc);
+                    sampQ[samples - 1] = quality;
+                    any = TRUE;
                 }
             }
 
-            if (pD3D11_2 || pD3D11_3)
+            if (!pPrintInfo)
             {
-                if (minmaxfilter)
-                {
-                    LVLINE("Min/Max Filtering", minmaxfilter);
-                }
+                if (g_dwViewState != IDM_VIEWALL && !any)
+                    continue;
 
-                if (mapdefaultbuff)
-                {
-                    LVLINE("Map DEFAULT Buffers", mapdefaultbuff);
-                }
-            }
+                LVAddText(g_hwndLV, 0, FormatName(fmt));
 
-            if (pD3D11_3 || pD3D12)
-            {
-                if (consrv_rast)
+                UINT column = 1;
+                for (UINT samples = 2; samples <= D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT; ++samples)
                 {
-                    LVLINE("Conservative Rasterization", consrv_rast);
-                }
-
-                if (ps_stencil_ref)
-                {
-                    LVLINE("PS-Specified Stencil Ref", ps_stencil_ref);
-                }
-
-                if (rast_ordered_views)
-                {
-                    LVLINE("Rasterizer Ordered Views", rast_ordered_views);
-                }
-            }
-
-            if (pD3D12 && binding_rsc)
-            {
-                LVLINE("Resource Binding", binding_rsc);
-            }
-
-            if (g_DXGIFactory1 && !pD3D12)
-            {
-                LVLINE("Extended Formats (BGRA, etc.)", extFormats);
-
-                if (x2_10BitFormat && (g_dwViewState == IDM_VIEWALL || x2_10BitFormat != c_szNo))
-                {
-                    LVLINE("10-bit XR High Color Format", x2_10BitFormat);
-                }
-            }
-
-            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
-            {
-                LVLINE("16-bit Formats (565/5551/4444)", bpp16);
-            }
-
-            if (nonpow2 && !pD3D12)
-            {
-                LVLINE("Non-Power-of-2 Textures", nonpow2);
-            }
-
-            LVLINE("Max Texture Dimension", maxTexDim);
-            LVLINE("Max Cubemap Dimension", maxCubeDim);
-
-            if (maxVolDim)
-            {
-                LVLINE("Max Volume Extent", maxVolDim);
-            }
-
-            if (maxTexRepeat)
-            {
-                LVLINE("Max Texture Repeat", maxTexRepeat);
-            }
-
-            LVLINE("Max Input Slots", maxInputSlots);
-
-            if (uavSlots)
-            {
-                LVLINE("UAV Slots", uavSlots);
-            }
-
-            if (maxAnisotropy)
-            {
-                LVLINE("Max Anisotropy", maxAnisotropy);
-            }
-
-            LVLINE("Max Primitive Count", maxPrimCount);
-
-            if (mrt)
-            {
-                LVLINE("Simultaneous Render Targets", mrt);
-            }
-
-            if (_10level9)
-            {
-                LVYESNO("Occlusion Queries", (fl >= D3D_FEATURE_LEVEL_9_2));
-                LVYESNO("Separate Alpha Blend", (fl >= D3D_FEATURE_LEVEL_9_2));
-                LVYESNO("Mirror Once", (fl >= D3D_FEATURE_LEVEL_9_2));
-                LVYESNO("Overlapping Vertex Elements", (fl >= D3D_FEATURE_LEVEL_9_2));
-                LVYESNO("Independant Write Masks", (fl >= D3D_FEATURE_LEVEL_9_3));
-
-                LVLINE("Instancing", instancing);
-
-                if (pD3D11_1 || pD3D11_2 || pD3D11_3)
-                {
-                    LVLINE("Shadow Support", shadows);
-                }
-
-                if (pD3D11_2 || pD3D11_3)
-                {
-                    LVLINE("Cubemap Render w/ non-Cube Depth", cubeRT);
-                }
-            }
-
-            LVLINE("Note", FL_NOTE);
-        }
-        else
-        {
-            PRINTLINE("Shader Model", shaderModel);
-            PRINTYESNO("Geometry Shader", (fl >= D3D_FEATURE_LEVEL_10_0));
-            PRINTYESNO("Stream Out", (fl >= D3D_FEATURE_LEVEL_10_0));
-
-            if (pD3D12 || pD3D11_3 || pD3D11_2 || pD3D11_1 || pD3D11)
-            {
-                PRINTLINE("DirectCompute", computeShader);
-                PRINTYESNO("Hull & Domain Shaders", (fl >= D3D_FEATURE_LEVEL_11_0));
-            }
-
-            if (pD3D12)
-            {
-                PRINTLINE("Variable Rate Shading (VRS)", vrs);
-                PRINTLINE("Mesh & Amplification Shaders", meshShaders);
-                PRINTLINE("DirectX Raytracing", dxr);
-            }
-
-            PRINTYESNO("Texture Resource Arrays", (fl >= D3D_FEATURE_LEVEL_10_0));
-
-            if (d3dVer != 0)
-            {
-                PRINTYESNO("Cubemap Resource Arrays", (fl >= D3D_FEATURE_LEVEL_10_1));
-            }
-
-            PRINTYESNO("BC4/BC5 Compression", (fl >= D3D_FEATURE_LEVEL_10_0));
-
-            if (pD3D11_3 || pD3D11_2 || pD3D11_1 || pD3D11)
-            {
-                PRINTYESNO("BC6H/BC7 Compression", (fl >= D3D_FEATURE_LEVEL_11_0));
-            }
-
-            PRINTYESNO("Alpha-to-coverage", (fl >= D3D_FEATURE_LEVEL_10_0));
-
-            if (pD3D11_1 || pD3D11_2 || pD3D11_3 || pD3D12)
-            {
-                PRINTLINE("Logic Ops (Output Merger)", logic_ops);
-            }
-
-            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
-            {
-                PRINTLINE("Constant Buffer Partial Updates", cb_partial);
-                PRINTLINE("Constant Buffer Offsetting", cb_offsetting);
-
-                if (uavEveryStage)
-                {
-                    PRINTLINE("UAVs at Every Stage", uavEveryStage);
-                }
-
-                if (uavOnlyRender)
-                {
-                    PRINTLINE("UAV-only rendering", uavOnlyRender);
-                }
-            }
-
-            if (pD3D11_2 || pD3D11_3 || pD3D12)
-            {
-                if (tiled_rsc)
-                {
-                    PRINTLINE("Tiled Resources", tiled_rsc);
-                }
-            }
-
-            if (pD3D11_2 || pD3D11_3)
-            {
-                if (minmaxfilter)
-                {
-                    PRINTLINE("Min/Max Filtering", minmaxfilter);
-                }
-
-                if (mapdefaultbuff)
-                {
-                    PRINTLINE("Map DEFAULT Buffers", mapdefaultbuff);
-                }
-            }
-
-            if (pD3D11_3 || pD3D12)
-            {
-                if (consrv_rast)
-                {
-                    PRINTLINE("Conservative Rasterization", consrv_rast);
-                }
+                    if (!sampCount[samples - 1] && !IsMSAAPowerOf2(samples))
+                        continue;
 
-                if (ps_stencil_ref)
-                {
-                    PRINTLINE("PS-Specified Stencil Ref ", ps_stencil_ref);
-                }
+                    if (sampQ[samples - 1] > 0)
+                    {
+                        TCHAR strBuffer[32];
+                        sprintf_s(strBuffer, 32, "Yes (%u)", sampQ[samples - 1]);
+                        LVAddText(g_hwndLV, column, strBuffer);
+                    }
+                    else
+                        LVAddText(g_hwndLV, column, c_szNo);
 
-                if (rast_ordered_views)
-                {
-                    PRINTLINE("Rasterizer Ordered Views", rast_ordered_views);
+                    ++column;
                 }
             }
-
-            if (pD3D12 && binding_rsc)
-            {
-                PRINTLINE("Resource Binding", binding_rsc);
-            }
-
-            if (g_DXGIFactory1 && !pD3D12)
+            else
             {
-                PRINTLINE("Extended Formats (BGRA, etc.)", extFormats);
+                TCHAR buff[1024];
+                *buff = 0;
 
-                if (x2_10BitFormat)
+                for (UINT samples = 2; samples <= D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT; ++samples)
                 {
-                    PRINTLINE("10-bit XR High Color Format", x2_10BitFormat);
-                }
-            }
-
-            if (pD3D11_1 || pD3D11_2 || pD3D11_3)
-            {
-                PRINTLINE("16-bit Formats (565/5551/4444)", bpp16);
-            }
-
-            if (nonpow2)
-            {
-                PRINTLINE("Non-Power-of-2 Textures", nonpow2);
-            }
-
-            PRINTLINE("Max Texture Dimension", maxTexDim);
-            PRINTLINE("Max Cubemap Dimension", maxCubeDim);
-
-            if (maxVolDim)
-            {
-                PRINTLINE("Max Volume Extent", maxVolDim);
-            }
-
-            if (maxTexRepeat)
-            {
-                PRINTLINE("Max Texture Repeat", maxTexRepeat);
-            }
-
-            PRINTLINE("Max Input Slots", maxInputSlots);
-
-            if (uavSlots)
-            {
-                PRINTLINE("UAV Slots", uavSlots);
-            }
-
-            if (maxAnisotropy)
-            {
-                PRINTLINE("Max Anisotropy", maxAnisotropy);
-            }
-
-            PRINTLINE("Max Primitive Count", maxPrimCount);
-
-            if (mrt)
-            {
-                PRINTLINE("Simultaneous Render Targets", mrt);
-            }
-
-            if (_10level9)
-            {
-                PRINTYESNO("Occlusion Queries", (fl >= D3D_FEATURE_LEVEL_9_2));
-                PRINTYESNO("Separate Alpha Blend", (fl >= D3D_FEATURE_LEVEL_9_2));
-                PRINTYESNO("Mirror Once", (fl >= D3D_FEATURE_LEVEL_9_2));
-                PRINTYESNO("Overlapping Vertex Elements", (fl >= D3D_FEATURE_LEVEL_9_2));
-                PRINTYESNO("Independant Write Masks", (fl >= D3D_FEATURE_LEVEL_9_3));
+                    if (!sampCount[samples - 1] && !IsMSAAPowerOf2(samples))
+                        continue;
 
-                PRINTLINE("Instancing", instancing);
+                    TCHAR strBuffer[32];
+                    if (sampQ[samples - 1] > 0)
+                        sprintf_s(strBuffer, 32, "%ux: Yes (%u)   ", samples, sampQ[samples - 1]);
+                    else
+                        sprintf_s(strBuffer, 32, "%ux: No   ", samples);
 
-                if (pD3D11_1 || pD3D11_2 || pD3D11_3)
-                {
-                    PRINTLINE("Shadow Support", shadows);
+                    strcat_s(buff, 1024, strBuffer);
                 }
 
-                if (pD3D11_2 || pD3D11_3)
-                {
-                    PRINTLINE("Cubemap Render w/ non-Cube Depth", cubeRT);
-                }
+                PrintStringValueLine(FormatName(fmt), buff, pPrintInfo);
             }
-
-            PRINTLINE("Note", FL_NOTE);
         }
 
         return S_OK;
     }
-  
+
 
     //-----------------------------------------------------------------------------
-    HRESULT D3D10Info(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
+    HRESULT D3D11Info(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
     {
-        auto pDevice = reinterpret_cast<ID3D10Device*>(lParam1);
+        auto pDevice = reinterpret_cast<ID3D11Device*>(lParam1);
         if (!pDevice)
             return S_OK;
 
@@ -2413,7 +2226,7 @@ namespace
         {
             LVAddColumn(g_hwndLV, 0, "Name", 30);
 
-            if (lParam2 == D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
+            if (lParam2 == D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
             {
                 LVAddColumn(g_hwndLV, 1, "Value", 25);
                 LVAddColumn(g_hwndLV, 2, "Quality Level", 25);
@@ -2426,44 +2239,83 @@ namespace
 
         if (!lParam2)
         {
-            // General Direct3D 10.0 device information
+            // General Direct3D 11 device information
+            D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
+            if (fl > D3D_FEATURE_LEVEL_11_0)
+                fl = D3D_FEATURE_LEVEL_11_0;
 
-            BOOL ext, x2;
-            CheckExtendedFormats(pDevice, ext, x2);
+            // CheckFeatureSupport
+            D3D11_FEATURE_DATA_THREADING threading = {};
+            HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading));
+            if (FAILED(hr))
+                memset(&threading, 0, sizeof(threading));
+
+            D3D11_FEATURE_DATA_DOUBLES doubles = {};
+            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_DOUBLES, &doubles, sizeof(doubles));
+            if (FAILED(hr))
+                memset(&doubles, 0, sizeof(doubles));
+
+            D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS d3d10xhw = {};
+            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &d3d10xhw, sizeof(d3d10xhw));
+            if (FAILED(hr))
+                memset(&d3d10xhw, 0, sizeof(d3d10xhw));
+
+            // Setup note
+            const char* szNote = nullptr;
+
+            switch (fl)
+            {
+            case D3D_FEATURE_LEVEL_10_0:
+                szNote = SEE_D3D10;
+                break;
+
+            case D3D_FEATURE_LEVEL_10_1:
+            case D3D_FEATURE_LEVEL_9_3:
+            case D3D_FEATURE_LEVEL_9_2:
+            case D3D_FEATURE_LEVEL_9_1:
+                szNote = SEE_D3D10_1;
+                break;
+
+            default:
+                szNote = D3D11_NOTE;
+                break;
+            }
 
             if (!pPrintInfo)
             {
-                if (g_DXGIFactory1)
-                {
-                    LVYESNO("Extended Formats (BGRA, etc.)", ext);
-                    LVYESNO("10-bit XR High Color Format", x2);
-                }
+                LVLINE("Feature Level", FLName(fl));
 
-                LVLINE("Note", D3D10_NOTE);
+                LVYESNO("Driver Concurrent Creates", threading.DriverConcurrentCreates);
+                LVYESNO("Driver Command Lists", threading.DriverCommandLists);
+                LVYESNO("Double-precision Shaders", doubles.DoublePrecisionFloatShaderOps);
+                LVYESNO("DirectCompute CS 4.x", d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x);
+
+                    LVLINE("Note", szNote);
             }
             else
             {
-                if (g_DXGIFactory1)
-                {
-                    PRINTYESNO("Extended Formats (BGRA, etc.)", ext);
-                    PRINTYESNO("10-bit XR High Color Format", x2);
-                }
+                PRINTLINE("Feature Level", FLName(fl));
 
-                PRINTLINE("Note", D3D10_NOTE);
+                PRINTYESNO("Driver Concurrent Creates", threading.DriverConcurrentCreates);
+                PRINTYESNO("Driver Command Lists", threading.DriverCommandLists);
+                PRINTYESNO("Double-precision Shaders", doubles.DoublePrecisionFloatShaderOps);
+                PRINTYESNO("DirectCompute CS 4.x", d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x);
+
+                    PRINTLINE("Note", szNote);
             }
 
             return S_OK;
         }
 
-        // Use CheckFormatSupport for format usage defined as optional for Direct3D 10 devices
+        // Use CheckFormatSupport for format usage defined as optional for Direct3D 11 devices
         static const DXGI_FORMAT cfsShaderSample[] =
         {
-            DXGI_FORMAT_R32G32B32A32_FLOAT,
-            DXGI_FORMAT_R32G32B32_FLOAT,
-            DXGI_FORMAT_R32G32_FLOAT,
-            DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS,
-            DXGI_FORMAT_R32_FLOAT,
-            DXGI_FORMAT_R24_UNORM_X8_TYPELESS
+            DXGI_FORMAT_R32G32B32_FLOAT
+        };
+
+        static const DXGI_FORMAT cfsShaderGather[] =
+        {
+            DXGI_FORMAT_R32G32B32_FLOAT
         };
 
         static const DXGI_FORMAT cfsMipAutoGen[] =
@@ -2478,49 +2330,54 @@ namespace
             DXGI_FORMAT_R32G32B32_SINT
         };
 
-        static const DXGI_FORMAT cfsBlendableRT[] =
+        // Most RT formats are required to support 8x MSAA for 11 devices
+        static const DXGI_FORMAT cfsMSAA8x[] =
         {
-            DXGI_FORMAT_R32G32B32_FLOAT,
-            DXGI_FORMAT_R16G16B16A16_UNORM,
-            DXGI_FORMAT_R16G16_UNORM,
-            DXGI_FORMAT_R16_UNORM
+            DXGI_FORMAT_R32G32B32A32_FLOAT,
+            DXGI_FORMAT_R32G32B32A32_UINT,
+            DXGI_FORMAT_R32G32B32A32_SINT
         };
 
         UINT count = 0;
         const DXGI_FORMAT* array = nullptr;
-        BOOL skips = FALSE;
 
         switch (lParam2)
         {
-        case D3D10_FORMAT_SUPPORT_SHADER_SAMPLE:
+        case D3D11_FORMAT_SUPPORT_SHADER_SAMPLE:
             count = sizeof(cfsShaderSample) / sizeof(DXGI_FORMAT);
             array = cfsShaderSample;
             break;
 
-        case D3D10_FORMAT_SUPPORT_MIP_AUTOGEN:
+        case D3D11_FORMAT_SUPPORT_SHADER_GATHER:
+            count = sizeof(cfsShaderGather) / sizeof(DXGI_FORMAT);
+            array = cfsShaderGather;
+            break;
+
+        case D3D11_FORMAT_SUPPORT_MIP_AUTOGEN:
             count = sizeof(cfsMipAutoGen) / sizeof(DXGI_FORMAT);
             array = cfsMipAutoGen;
             break;
 
-        case D3D10_FORMAT_SUPPORT_RENDER_TARGET:
+        case D3D11_FORMAT_SUPPORT_RENDER_TARGET:
             count = sizeof(cfsRenderTarget) / sizeof(DXGI_FORMAT);
             array = cfsRenderTarget;
             break;
 
-        case D3D10_FORMAT_SUPPORT_BLENDABLE:
-            count = sizeof(cfsBlendableRT) / sizeof(DXGI_FORMAT);
-            array = cfsBlendableRT;
-            break;
-
-        case D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET:
-            count = sizeof(g_cfsMSAA_10) / sizeof(DXGI_FORMAT);
-            array = g_cfsMSAA_10;
-            break;
-
-        case D3D10_FORMAT_SUPPORT_MULTISAMPLE_LOAD:
-            count = sizeof(g_cfsMSAA_10) / sizeof(DXGI_FORMAT);
-            array = g_cfsMSAA_10;
-            skips = TRUE;
+        case D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET:
+            if (g_dwViewState != IDM_VIEWALL && lParam3 == 8)
+            {
+                count = sizeof(cfsMSAA8x) / sizeof(DXGI_FORMAT);
+                array = cfsMSAA8x;
+            }
+            else if (g_dwViewState != IDM_VIEWALL && lParam3 == 4)
+            {
+                count = 0;
+            }
+            else
+            {
+                count = g_cfsMSAA_11.count;
+                array = g_cfsMSAA_11.formats;
+            }
             break;
 
         default:
@@ -2531,25 +2388,15 @@ namespace
         {
             DXGI_FORMAT fmt = array[i];
 
-            if (skips)
+            if (lParam2 == D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
             {
-                // Special logic to let us reuse the MSAA array twice with a few special cases that are skipped
-                switch (fmt)
-                {
-                case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
-                case DXGI_FORMAT_D32_FLOAT:
-                case DXGI_FORMAT_D24_UNORM_S8_UINT:
-                case DXGI_FORMAT_D16_UNORM:
+                // Skip 16 bits-per-pixel formats for DX 11.0
+                if (fmt == DXGI_FORMAT_B5G6R5_UNORM || fmt == DXGI_FORMAT_B5G5R5A1_UNORM || fmt == DXGI_FORMAT_B4G4R4A4_UNORM)
                     continue;
-                }
-            }
 
-            if (lParam2 == D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
-            {
-                UINT quality;
-                HRESULT hr = pDevice->CheckMultisampleQualityLevels(fmt, (UINT)lParam3, &quality);
+                UINT quality = GetFormatQuality(pDevice, fmt, (UINT)lParam3);
 
-                BOOL msaa = (SUCCEEDED(hr) && quality > 0) != 0;
+                BOOL msaa = (quality > 0);
 
                 if (!pPrintInfo)
                 {
@@ -2576,10 +2423,7 @@ namespace
             }
             else
             {
-                UINT fmtSupport = 0;
-                HRESULT hr = pDevice->CheckFormatSupport(fmt, &fmtSupport);
-                if (FAILED(hr))
-                    fmtSupport = 0;
+                UINT fmtSupport = GetFormatSupport(pDevice, fmt);
 
                 if (!pPrintInfo)
                 {
@@ -2595,9 +2439,179 @@ namespace
         return S_OK;
     }
 
-    HRESULT D3D10Info1(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
+    void D3D11FeatureSupportInfo1(ID3D11Device1* pDevice, bool bDev2, PRINTCBINFO* pPrintInfo)
     {
-        auto pDevice = reinterpret_cast<ID3D10Device1*>(lParam1);
+        if (!pDevice)
+            return;
+
+        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
+
+        // CheckFeatureSupport
+        D3D11_FEATURE_DATA_THREADING threading = {};
+        HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading));
+        if (FAILED(hr))
+            memset(&threading, 0, sizeof(threading));
+
+        D3D11_FEATURE_DATA_DOUBLES doubles = {};
+        hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_DOUBLES, &doubles, sizeof(doubles));
+        if (FAILED(hr))
+            memset(&doubles, 0, sizeof(doubles));
+
+        D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS d3d10xhw = {};
+        hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &d3d10xhw, sizeof(d3d10xhw));
+        if (FAILED(hr))
+            memset(&d3d10xhw, 0, sizeof(d3d10xhw));
+
+        D3D11_FEATURE_DATA_D3D11_OPTIONS d3d11opts = {};
+        hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &d3d11opts, sizeof(d3d11opts));
+        if (FAILED(hr))
+            memset(&d3d11opts, 0, sizeof(d3d11opts));
+
+        D3D11_FEATURE_DATA_D3D9_OPTIONS d3d9opts = {};
+        hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D9_OPTIONS, &d3d9opts, sizeof(d3d9opts));
+        if (FAILED(hr))
+            memset(&d3d9opts, 0, sizeof(d3d9opts));
+
+        D3D11_FEATURE_DATA_ARCHITECTURE_INFO d3d11arch = {};
+        hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_ARCHITECTURE_INFO, &d3d11arch, sizeof(d3d11arch));
+        if (FAILED(hr))
+            memset(&d3d11arch, 0, sizeof(d3d11arch));
+
+        D3D11_FEATURE_DATA_SHADER_MIN_PRECISION_SUPPORT minprecis = {};
+        hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_SHADER_MIN_PRECISION_SUPPORT, &minprecis, sizeof(minprecis));
+        if (FAILED(hr))
+            memset(&minprecis, 0, sizeof(minprecis));
+
+        D3D11_FEATURE_DATA_D3D11_OPTIONS1 d3d11opts1 = {};
+        memset(&d3d11opts1, 0, sizeof(d3d11opts1));
+        if (bDev2)
+        {
+            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS1, &d3d11opts1, sizeof(d3d11opts1));
+            if (FAILED(hr))
+                memset(&d3d11opts1, 0, sizeof(d3d11opts1));
+        }
+
+        const char* clearview = nullptr;
+        if (d3d11opts.ClearView)
+        {
+            clearview = d3d11opts1.ClearViewAlsoSupportsDepthOnlyFormats ? "RTV, UAV, and Depth (Driver sees)" : "RTV and UAV (Driver sees)";
+        }
+        else
+        {
+            clearview = d3d11opts1.ClearViewAlsoSupportsDepthOnlyFormats ? "RTV, UAV, and Depth (Driver doesn't see)" : "RTV and UAV (Driver doesn't see)";
+        }
+
+        const char* double_shaders = nullptr;
+        if (d3d11opts.ExtendedDoublesShaderInstructions)
+        {
+            double_shaders = "Extended";
+        }
+        else if (doubles.DoublePrecisionFloatShaderOps)
+        {
+            double_shaders = c_szYes;
+        }
+        else
+        {
+            double_shaders = c_szNo;
+        }
+
+        const char* ps_precis = nullptr;
+        switch (minprecis.PixelShaderMinPrecision & (D3D11_SHADER_MIN_PRECISION_16_BIT | D3D11_SHADER_MIN_PRECISION_10_BIT))
+        {
+        case 0:                                 ps_precis = "Full";         break;
+        case D3D11_SHADER_MIN_PRECISION_16_BIT: ps_precis = "16/32-bit";    break;
+        case D3D11_SHADER_MIN_PRECISION_10_BIT: ps_precis = "10/32-bit";    break;
+        default:                                ps_precis = "10/16/32-bit"; break;
+        }
+
+        const char* other_precis = nullptr;
+        switch (minprecis.AllOtherShaderStagesMinPrecision & (D3D11_SHADER_MIN_PRECISION_16_BIT | D3D11_SHADER_MIN_PRECISION_10_BIT))
+        {
+        case 0:                                 other_precis = "Full";      break;
+        case D3D11_SHADER_MIN_PRECISION_16_BIT: other_precis = "16/32-bit"; break;
+        case D3D11_SHADER_MIN_PRECISION_10_BIT: other_precis = "10/32-bit"; break;
+        default:                                other_precis = "10/16/32-bit"; break;
+        }
+
+        const char* nonpow2 = (d3d9opts.FullNonPow2TextureSupport) ? "Full" : "Conditional";
+
+        if (!pPrintInfo)
+        {
+            LVLINE("Feature Level", FLName(fl));
+
+            LVYESNO("Driver Concurrent Creates", threading.DriverConcurrentCreates);
+            LVYESNO("Driver Command Lists", threading.DriverCommandLists);
+            LVLINE("Double-precision Shaders", double_shaders);
+            LVYESNO("DirectCompute CS 4.x", d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x);
+
+            LVYESNO("Driver sees DiscardResource/View", d3d11opts.DiscardAPIsSeenByDriver);
+            LVYESNO("Driver sees COPY_FLAGS", d3d11opts.FlagsForUpdateAndCopySeenByDriver);
+            LVLINE("ClearView", clearview);
+            LVYESNO("Copy w/ Overlapping Rect", d3d11opts.CopyWithOverlap);
+            LVYESNO("CB Partial Update", d3d11opts.ConstantBufferPartialUpdate);
+            LVYESNO("CB Offsetting", d3d11opts.ConstantBufferOffsetting);
+            LVYESNO("Map NO_OVERWRITE on Dynamic CB", d3d11opts.MapNoOverwriteOnDynamicConstantBuffer);
+
+            if (fl >= D3D_FEATURE_LEVEL_10_0)
+            {
+                LVYESNO("Map NO_OVERWRITE on Dynamic SRV", d3d11opts.MapNoOverwriteOnDynamicBufferSRV);
+                LVYESNO("MSAA with ForcedSampleCount=1", d3d11opts.MultisampleRTVWithForcedSampleCountOne);
+                    LVYESNO("Extended resource sharing", d3d11opts.ExtendedResourceSharing);
+            }
+
+            if (fl >= D3D_FEATURE_LEVEL_11_0)
+            {
+                LVYESNO("Saturating Add Instruction", d3d11opts.SAD4ShaderInstructions);
+            }
+
+            LVYESNO("Tile-based Deferred Renderer", d3d11arch.TileBasedDeferredRenderer);
+
+                LVLINE("Non-Power-of-2 Textures", nonpow2);
+
+            LVLINE("Pixel Shader Precision", ps_precis);
+            LVLINE("Other Stage Precision", other_precis);
+        }
+        else
+        {
+            PRINTLINE("Feature Level", FLName(fl));
+
+            PRINTYESNO("Driver Concurrent Creates", threading.DriverConcurrentCreates);
+            PRINTYESNO("Driver Command Lists", threading.DriverCommandLists);
+            PRINTLINE("Double-precision Shaders", double_shaders);
+            PRINTYESNO("DirectCompute CS 4.x", d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x);
+
+            PRINTYESNO("Driver sees DiscardResource/View", d3d11opts.DiscardAPIsSeenByDriver);
+            PRINTYESNO("Driver sees COPY_FLAGS", d3d11opts.FlagsForUpdateAndCopySeenByDriver);
+            PRINTLINE("ClearView", clearview);
+            PRINTYESNO("Copy w/ Overlapping Rect", d3d11opts.CopyWithOverlap);
+            PRINTYESNO("CB Partial Update", d3d11opts.ConstantBufferPartialUpdate);
+            PRINTYESNO("CB Offsetting", d3d11opts.ConstantBufferOffsetting);
+            PRINTYESNO("Map NO_OVERWRITE on Dynamic CB", d3d11opts.MapNoOverwriteOnDynamicConstantBuffer);
+
+            if (fl >= D3D_FEATURE_LEVEL_10_0)
+            {
+                PRINTYESNO("Map NO_OVERWRITE on Dynamic SRV", d3d11opts.MapNoOverwriteOnDynamicBufferSRV);
+                PRINTYESNO("MSAA with ForcedSampleCount=1", d3d11opts.MultisampleRTVWithForcedSampleCountOne);
+                PRINTYESNO("Extended resource sharing", d3d11opts.ExtendedResourceSharing);
+            }
+
+            if (fl >= D3D_FEATURE_LEVEL_11_0)
+            {
+                PRINTYESNO("Saturating Add Instruction", d3d11opts.SAD4ShaderInstructions);
+            }
+
+            PRINTYESNO("Tile-based Deferred Renderer", d3d11arch.TileBasedDeferredRenderer);
+
+            PRINTLINE("Non-Power-of-2 Textures", nonpow2);
+
+            PRINTLINE("Pixel Shader Precision", ps_precis);
+            PRINTLINE("Other Stage Precision", other_precis);
+        }
+    }
+
+    HRESULT D3D11Info1(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
+    {
+        auto pDevice = reinterpret_cast<ID3D11Device1*>(lParam1);
         if (!pDevice)
             return S_OK;
 
@@ -2605,7 +2619,7 @@ namespace
         {
             LVAddColumn(g_hwndLV, 0, "Name", 30);
 
-            if (lParam2 == D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
+            if (lParam2 == D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
             {
                 LVAddColumn(g_hwndLV, 1, "Value", 25);
                 LVAddColumn(g_hwndLV, 2, "Quality Level", 25);
@@ -2616,125 +2630,281 @@ namespace
             }
         }
 
+        // General Direct3D 11.1 device information
+        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
+
         if (!lParam2)
         {
-            // General Direct3D 10.1 device information
-            D3D10_FEATURE_LEVEL1 fl = pDevice->GetFeatureLevel();
+            D3D11FeatureSupportInfo1(pDevice, false, pPrintInfo);
 
+            // Setup note
             const char* szNote = nullptr;
 
             switch (fl)
             {
-            case D3D10_FEATURE_LEVEL_10_0:
+            case D3D_FEATURE_LEVEL_10_0:
                 szNote = SEE_D3D10;
                 break;
 
-            case D3D10_FEATURE_LEVEL_9_3:
-            case D3D10_FEATURE_LEVEL_9_2:
-            case D3D10_FEATURE_LEVEL_9_1:
-                szNote = _10L9_NOTE;
+            case D3D_FEATURE_LEVEL_10_1:
+            case D3D_FEATURE_LEVEL_9_3:
+            case D3D_FEATURE_LEVEL_9_2:
+            case D3D_FEATURE_LEVEL_9_1:
+                szNote = SEE_D3D10_1;
                 break;
 
-            default:
-                szNote = D3D10_NOTE1;
+            case D3D_FEATURE_LEVEL_11_0:
+                szNote = SEE_D3D11;
                 break;
-            }
 
-            BOOL ext, x2;
-            CheckExtendedFormats(pDevice, ext, x2);
+            default:
+                szNote = D3D11_NOTE1;
+                break;
+            }
 
             if (!pPrintInfo)
             {
-                LVLINE("Feature Level", FLName(fl));
-
-                    if (g_DXGIFactory1 != nullptr && (fl >= D3D10_FEATURE_LEVEL_10_0))
-                    {
-                        LVYESNO("Extended Formats (BGRA, etc.)", ext);
-                        LVYESNO("10-bit XR High Color Format", x2);
-                    }
-
-                    LVLINE("Note", szNote);
+                LVLINE("Note", szNote);
             }
             else
             {
-                PRINTLINE("Feature Level", FLName(fl));
-
-                    if (g_DXGIFactory1 != nullptr && (fl >= D3D10_FEATURE_LEVEL_10_0))
-                    {
-                        PRINTYESNO("Extended Formats (BGRA, etc.)", ext);
-                        PRINTYESNO("10-bit XR High Color Format", x2);
-                    }
-
-                    PRINTLINE("Note", szNote);
+                PRINTLINE("Note", szNote);
             }
 
             return S_OK;
         }
 
-        // Use CheckFormatSupport for format usage defined as optional for Direct3D 10.1 devices
+        // Use CheckFormatSupport for format usage defined as optional for Direct3D 11.1 devices
+
+        static const DXGI_FORMAT cfs16bpp[] =
+        {
+            DXGI_FORMAT_B5G6R5_UNORM,
+            DXGI_FORMAT_B5G5R5A1_UNORM,
+            DXGI_FORMAT_B4G4R4A4_UNORM,
+        };
+
+        static const DXGI_FORMAT cfs16bpp2[] =
+        {
+            DXGI_FORMAT_B5G5R5A1_UNORM,
+            DXGI_FORMAT_B4G4R4A4_UNORM,
+        };
+
         static const DXGI_FORMAT cfsShaderSample[] =
+        {
+            DXGI_FORMAT_R32G32B32A32_FLOAT,
+            DXGI_FORMAT_R32G32B32_FLOAT,
+            DXGI_FORMAT_R32G32_FLOAT,
+            DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS,
+            DXGI_FORMAT_R32_FLOAT,
+            DXGI_FORMAT_R24_UNORM_X8_TYPELESS
+        };
+
+        static const DXGI_FORMAT cfsShaderSample10_1[] =
         {
             DXGI_FORMAT_R32G32B32_FLOAT
         };
 
-        static const DXGI_FORMAT cfsMipAutoGen[] =
+        static const DXGI_FORMAT cfsShaderGather[] =
         {
             DXGI_FORMAT_R32G32B32_FLOAT
         };
 
+        static const DXGI_FORMAT cfsMipAutoGen[] =
+        {
+            DXGI_FORMAT_R32G32B32_FLOAT,
+            DXGI_FORMAT_B5G6R5_UNORM,
+            DXGI_FORMAT_B5G5R5A1_UNORM,
+            DXGI_FORMAT_B4G4R4A4_UNORM,
+        };
+
+        static const DXGI_FORMAT cfsMipAutoGen11_1[] =
+        {
+            DXGI_FORMAT_R32G32B32_FLOAT,
+            DXGI_FORMAT_B5G5R5A1_UNORM,
+            DXGI_FORMAT_B4G4R4A4_UNORM,
+        };
+
         static const DXGI_FORMAT cfsRenderTarget[] =
         {
             DXGI_FORMAT_R32G32B32_FLOAT,
             DXGI_FORMAT_R32G32B32_UINT,
-            DXGI_FORMAT_R32G32B32_SINT
+            DXGI_FORMAT_R32G32B32_SINT,
+            DXGI_FORMAT_B5G6R5_UNORM,
+            DXGI_FORMAT_B5G5R5A1_UNORM,
+            DXGI_FORMAT_B4G4R4A4_UNORM,
         };
 
-        // Most RT formats are required to support 4x MSAA for 10.1 devices
-        static const DXGI_FORMAT cfsMSAA4x[] =
+        static const DXGI_FORMAT cfsRenderTarget11_1[] =
         {
-            DXGI_FORMAT_R32G32B32A32_FLOAT,
-            DXGI_FORMAT_R32G32B32A32_UINT,
-            DXGI_FORMAT_R32G32B32A32_SINT,
             DXGI_FORMAT_R32G32B32_FLOAT,
             DXGI_FORMAT_R32G32B32_UINT,
             DXGI_FORMAT_R32G32B32_SINT,
+            DXGI_FORMAT_B5G5R5A1_UNORM,
+            DXGI_FORMAT_B4G4R4A4_UNORM,
+        };
+
+        static const DXGI_FORMAT cfsBlendableRT[] =
+        {
+            DXGI_FORMAT_R32G32B32_FLOAT,
+            DXGI_FORMAT_R16G16B16A16_UNORM,
+            DXGI_FORMAT_R16G16_UNORM,
+            DXGI_FORMAT_R16_UNORM,
+            DXGI_FORMAT_B5G6R5_UNORM,
+            DXGI_FORMAT_B5G5R5A1_UNORM,
+            DXGI_FORMAT_B4G4R4A4_UNORM,
+        };
+
+        static const DXGI_FORMAT cfsLogicOps[] =
+        {
+            DXGI_FORMAT_R32G32B32A32_UINT,
+            DXGI_FORMAT_R32G32B32_UINT,
+            DXGI_FORMAT_R16G16B16A16_UINT,
+            DXGI_FORMAT_R32G32_UINT,
+            DXGI_FORMAT_R10G10B10A2_UINT,
+            DXGI_FORMAT_R8G8B8A8_UINT,
+            DXGI_FORMAT_R16G16_UINT,
+            DXGI_FORMAT_R32_UINT,
+            DXGI_FORMAT_R8G8_UINT,
+            DXGI_FORMAT_R16_UINT,
+            DXGI_FORMAT_R8_UINT,
+        };
+
+        // Most RT formats are required to support 8x MSAA for 11.x devices
+        static const DXGI_FORMAT cfsMSAA8x[] =
+        {
+            DXGI_FORMAT_R32G32B32A32_FLOAT,
+            DXGI_FORMAT_R32G32B32A32_UINT,
+            DXGI_FORMAT_R32G32B32A32_SINT,
+            DXGI_FORMAT_B5G6R5_UNORM,
+            DXGI_FORMAT_B5G5R5A1_UNORM,
+            DXGI_FORMAT_B4G4R4A4_UNORM,
         };
 
         UINT count = 0;
         const DXGI_FORMAT* array = nullptr;
+        BOOL skips = FALSE;
 
         switch (lParam2)
         {
-        case D3D10_FORMAT_SUPPORT_SHADER_SAMPLE:
-            count = sizeof(cfsShaderSample) / sizeof(DXGI_FORMAT);
-            array = cfsShaderSample;
+        case D3D11_FORMAT_SUPPORT_IA_VERTEX_BUFFER:
+            count = sizeof(cfs16bpp) / sizeof(DXGI_FORMAT);
+            array = cfs16bpp;
             break;
 
-        case D3D10_FORMAT_SUPPORT_MIP_AUTOGEN:
-            count = sizeof(cfsMipAutoGen) / sizeof(DXGI_FORMAT);
-            array = cfsMipAutoGen;
+        case D3D11_FORMAT_SUPPORT_SHADER_SAMPLE:
+            if (fl >= D3D_FEATURE_LEVEL_10_1)
+            {
+                count = sizeof(cfsShaderSample10_1) / sizeof(DXGI_FORMAT);
+                array = cfsShaderSample10_1;
+            }
+            else
+            {
+                count = sizeof(cfsShaderSample) / sizeof(DXGI_FORMAT);
+                array = cfsShaderSample;
+            }
             break;
 
-        case D3D10_FORMAT_SUPPORT_RENDER_TARGET:
-            count = sizeof(cfsRenderTarget) / sizeof(DXGI_FORMAT);
-            array = cfsRenderTarget;
+        case D3D11_FORMAT_SUPPORT_SHADER_GATHER:
+            count = sizeof(cfsShaderGather) / sizeof(DXGI_FORMAT);
+            array = cfsShaderGather;
             break;
 
-        case D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET:
-            if (pDevice->GetFeatureLevel() <= D3D10_FEATURE_LEVEL_9_3)
+        case D3D11_FORMAT_SUPPORT_MIP_AUTOGEN:
+            if (fl >= D3D_FEATURE_LEVEL_11_1)
             {
-                count = sizeof(g_cfsMSAA_10level9) / sizeof(DXGI_FORMAT);
-                array = g_cfsMSAA_10level9;
+                count = sizeof(cfsMipAutoGen11_1) / sizeof(DXGI_FORMAT);
+                array = cfsMipAutoGen11_1;
             }
-            else if (g_dwViewState != IDM_VIEWALL && lParam3 == 4)
+            else
             {
-                count = sizeof(cfsMSAA4x) / sizeof(DXGI_FORMAT);
-                array = cfsMSAA4x;
+                count = sizeof(cfsMipAutoGen) / sizeof(DXGI_FORMAT);
+                array = cfsMipAutoGen;
+            }
+            break;
+
+        case D3D11_FORMAT_SUPPORT_RENDER_TARGET:
+            if (fl >= D3D_FEATURE_LEVEL_11_1)
+            {
+                count = sizeof(cfsRenderTarget11_1) / sizeof(DXGI_FORMAT);
+                array = cfsRenderTarget11_1;
+            }
+            else
+            {
+                count = sizeof(cfsRenderTarget) / sizeof(DXGI_FORMAT);
+                array = cfsRenderTarget;
+            }
+            break;
+
+        case D3D11_FORMAT_SUPPORT_BLENDABLE:
+            if (fl >= D3D_FEATURE_LEVEL_10_0)
+            {
+                count = sizeof(cfs16bpp2) / sizeof(DXGI_FORMAT);
+                array = cfs16bpp2;
+            }
+            else
+            {
+                count = sizeof(cfsBlendableRT) / sizeof(DXGI_FORMAT);
+                array = cfsBlendableRT;
+            }
+            break;
+
+        case D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET:
+            if (g_dwViewState != IDM_VIEWALL && lParam3 == 8)
+            {
+                count = sizeof(cfsMSAA8x) / sizeof(DXGI_FORMAT);
+                array = cfsMSAA8x;
+            }
+            else if (g_dwViewState != IDM_VIEWALL && (lParam3 == 2 || lParam3 == 4))
+            {
+                count = sizeof(cfs16bpp) / sizeof(DXGI_FORMAT);
+                array = cfs16bpp;
+            }
+            else
+            {
+                count = g_cfsMSAA_11.count;
+                array = g_cfsMSAA_11.formats;
+            }
+            break;
+
+        case D3D11_FORMAT_SUPPORT_MULTISAMPLE_LOAD:
+            if (fl >= D3D_FEATURE_LEVEL_10_1)
+            {
+                count = sizeof(cfs16bpp2) / sizeof(DXGI_FORMAT);
+                array = cfs16bpp2;
+            }
+            else if (fl >= D3D_FEATURE_LEVEL_10_0)
+            {
+                count = sizeof(cfs16bpp) / sizeof(DXGI_FORMAT);
+                array = cfs16bpp;
             }
             else
             {
-                count = sizeof(g_cfsMSAA_10) / sizeof(DXGI_FORMAT);
-                array = g_cfsMSAA_10;
+                count = g_cfsMSAA_11.count;
+                array = g_cfsMSAA_11.formats;
+            }
+            skips = TRUE;
+            break;
+
+        case D3D11_FORMAT_SUPPORT_TYPED_UNORDERED_ACCESS_VIEW:
+            count = sizeof(cfs16bpp) / sizeof(DXGI_FORMAT);
+            array = cfs16bpp;
+            break;
+
+        case LPARAM(-1): // D3D11_FORMAT_SUPPORT2
+            switch (lParam3)
+            {
+            case D3D11_FORMAT_SUPPORT2_OUTPUT_MERGER_LOGIC_OP:
+                count = sizeof(cfsLogicOps) / sizeof(DXGI_FORMAT);
+                array = cfsLogicOps;
+                break;
+
+            case D3D11_FORMAT_SUPPORT2_UAV_TYPED_STORE:
+                count = sizeof(cfs16bpp) / sizeof(DXGI_FORMAT);
+                array = cfs16bpp;
+                break;
+
+            default:
+                return E_FAIL;
             }
             break;
 
@@ -2746,22 +2916,39 @@ namespace
         {
             DXGI_FORMAT fmt = array[i];
 
-            if (lParam2 == D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
+            if (skips)
             {
-                UINT quality;
-                HRESULT hr = pDevice->CheckMultisampleQualityLevels(fmt, (UINT)lParam3, &quality);
-
-                BOOL msaa = (SUCCEEDED(hr) && quality > 0) != 0;
-
-                if (!pPrintInfo)
+                // Special logic to let us reuse the MSAA array twice with a few special cases that are skipped
+                switch (fmt)
                 {
-                    if (g_dwViewState == IDM_VIEWALL || msaa)
-                    {
-                        LVAddText(g_hwndLV, 0, FormatName(fmt));
-                        LVAddText(g_hwndLV, 1, msaa ? c_szYes : c_szNo); \
-
-                            TCHAR strBuffer[16];
-                        sprintf_s(strBuffer, 16, "%u", msaa ? quality : 0);
+                case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+                case DXGI_FORMAT_D32_FLOAT:
+                case DXGI_FORMAT_D24_UNORM_S8_UINT:
+                case DXGI_FORMAT_D16_UNORM:
+                case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+                case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+                    continue;
+                }
+            }
+
+            if (lParam2 == D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
+            {
+                if (g_dwViewState != IDM_VIEWALL && fmt == DXGI_FORMAT_B5G6R5_UNORM)
+                    continue;
+
+                UINT quality = GetFormatQuality(pDevice, fmt, (UINT)lParam3);
+
+                BOOL msaa = (quality > 0);
+
+                if (!pPrintInfo)
+                {
+                    if (g_dwViewState == IDM_VIEWALL || msaa)
+                    {
+                        LVAddText(g_hwndLV, 0, FormatName(fmt));
+                        LVAddText(g_hwndLV, 1, msaa ? c_szYes : c_szNo); \
+
+                            TCHAR strBuffer[16];
+                        sprintf_s(strBuffer, 16, "%u", msaa ? quality : 0);
                         LVAddText(g_hwndLV, 2, strBuffer);
                     }
                 }
@@ -2776,171 +2963,60 @@ namespace
                     PrintStringValueLine(FormatName(fmt), strBuffer, pPrintInfo);
                 }
             }
-            else
+            else if (lParam2 != LPARAM(-1))
             {
-                UINT fmtSupport = 0;
-                HRESULT hr = pDevice->CheckFormatSupport(fmt, &fmtSupport);
-                if (FAILED(hr))
-                    fmtSupport = 0;
+                UINT fmtSupport = GetFormatSupport(pDevice, fmt);
 
                 if (!pPrintInfo)
                 {
-                    LVYESNO(FormatName(fmt), fmtSupport& (UINT)lParam2);
+                    LVYESNO(FormatName(fmt), fmtSupport & (UINT)lParam2);
                 }
                 else
                 {
                     PRINTYESNO(FormatName(fmt), fmtSupport & (UINT)lParam2);
                 }
             }
-        }
-
-        return S_OK;
-    }
-
-
-    HRESULT D3D10InfoMSAA(LPARAM lParam1, LPARAM lParam2, PRINTCBINFO* pPrintInfo)
-    {
-        auto pDevice = reinterpret_cast<ID3D10Device*>(lParam1);
-        if (!pDevice)
-            return S_OK;
-
-        auto sampCount = reinterpret_cast<BOOL*>(lParam2);
-
-        if (!pPrintInfo)
-        {
-            LVAddColumn(g_hwndLV, 0, "Name", 30);
-
-            UINT column = 1;
-            for (UINT samples = 2; samples <= D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT; ++samples)
-            {
-                if (!sampCount[samples - 1] && !IsMSAAPowerOf2(samples))
-                    continue;
-
-                TCHAR strBuffer[8];
-                sprintf_s(strBuffer, 8, "%ux", samples);
-                LVAddColumn(g_hwndLV, column, strBuffer, 8);
-                ++column;
-            }
-        }
-
-        const UINT count = sizeof(g_cfsMSAA_10) / sizeof(DXGI_FORMAT);
-
-        for (UINT i = 0; i < count; ++i)
-        {
-            DXGI_FORMAT fmt = g_cfsMSAA_10[i];
-
-            UINT sampQ[D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT];
-            memset(sampQ, 0, sizeof(sampQ));
-
-            BOOL any = FALSE;
-            for (UINT samples = 2; samples <= D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT; ++samples)
-            {
-                UINT quality;
-                HRESULT hr = pDevice->CheckMultisampleQualityLevels(fmt, samples, &quality);
-
-                if (SUCCEEDED(hr) && quality > 0)
-                {
-                    sampQ[samples - 1] = quality;
-                    any = TRUE;
-                }
-            }
-
-            if (!pPrintInfo)
+            else
             {
-                if (g_dwViewState != IDM_VIEWALL && !any)
-                    continue;
-
-                LVAddText(g_hwndLV, 0, FormatName(fmt));
+                UINT fmtSupport2 = GetFormatSupport2(pDevice, fmt);
 
-                UINT column = 1;
-                for (UINT samples = 2; samples <= D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT; ++samples)
+                if (!pPrintInfo)
                 {
-                    if (!sampCount[samples - 1] && !IsMSAAPowerOf2(samples))
-                        continue;
-
-                    if (sampQ[samples - 1] > 0)
-                    {
-                        TCHAR strBuffer[32];
-                        sprintf_s(strBuffer, 32, "Yes (%u)", sampQ[samples - 1]);
-                        LVAddText(g_hwndLV, column, strBuffer);
-                    }
-                    else
-                        LVAddText(g_hwndLV, column, c_szNo);
-
-                    ++column;
+                    LVYESNO(FormatName(fmt), fmtSupport2 & (UINT)lParam3);
                 }
-            }
-            else
-            {
-                TCHAR buff[1024];
-                *buff = 0;
-
-                for (UINT samples = 2; samples <= D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT; ++samples)
+                else
                 {
-                    if (!sampCount[samples - 1] && !IsMSAAPowerOf2(samples))
-                        continue;
-
-                    TCHAR strBuffer[32];
-                    if (sampQ[samples - 1] > 0)
-                        sprintf_s(strBuffer, 32, "%ux: Yes (%u)   ", samples, sampQ[samples - 1]);
-                    else
-                        sprintf_s(strBuffer, 32, "%ux: No   ", samples);
-
-                    strcat_s(buff, 1024, strBuffer);
+                    PRINTYESNO(FormatName(fmt), fmtSupport2 & (UINT)lParam3);
                 }
-
-                PrintStringValueLine(FormatName(fmt), buff, pPrintInfo);
             }
         }
 
         return S_OK;
     }
 
-
-    //-----------------------------------------------------------------------------
-    HRESULT D3D11Info(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
+    HRESULT D3D11Info2(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
     {
-        auto pDevice = reinterpret_cast<ID3D11Device*>(lParam1);
+        auto pDevice = reinterpret_cast<ID3D11Device2*>(lParam1);
         if (!pDevice)
             return S_OK;
 
         if (!pPrintInfo)
         {
             LVAddColumn(g_hwndLV, 0, "Name", 30);
-
-            if (lParam2 == D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
-            {
-                LVAddColumn(g_hwndLV, 1, "Value", 25);
-                LVAddColumn(g_hwndLV, 2, "Quality Level", 25);
-            }
-            else
-            {
-                LVAddColumn(g_hwndLV, 1, "Value", 60);
-            }
+            LVAddColumn(g_hwndLV, 1, "Value", 60);
         }
 
+        // General Direct3D 11.2 device information
+        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
+
         if (!lParam2)
         {
-            // General Direct3D 11 device information
-            D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
-            if (fl > D3D_FEATURE_LEVEL_11_0)
-                fl = D3D_FEATURE_LEVEL_11_0;
-
-            // CheckFeatureSupport
-            D3D11_FEATURE_DATA_THREADING threading = {};
-            HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading));
-            if (FAILED(hr))
-                memset(&threading, 0, sizeof(threading));
-
-            D3D11_FEATURE_DATA_DOUBLES doubles = {};
-            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_DOUBLES, &doubles, sizeof(doubles));
-            if (FAILED(hr))
-                memset(&doubles, 0, sizeof(doubles));
+            D3D11FeatureSupportInfo1(pDevice, true, pPrintInfo);
 
-            D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS d3d10xhw = {};
-            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &d3d10xhw, sizeof(d3d10xhw));
+            D3D11_FEATURE_DATA_MARKER_SUPPORT marker = {};
+            HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_MARKER_SUPPORT, &marker, sizeof(marker));
             if (FAILED(hr))
-                memset(&d3d10xhw, 0, sizeof(d3d10xhw));
+                memset(&marker, 0, sizeof(marker));
 
             // Setup note
             const char* szNote = nullptr;
@@ -2958,66 +3034,79 @@ namespace
                 szNote = SEE_D3D10_1;
                 break;
 
+            case D3D_FEATURE_LEVEL_11_0:
+                szNote = SEE_D3D11;
+                break;
+
+            case D3D_FEATURE_LEVEL_11_1:
+                szNote = SEE_D3D11_1;
+                break;
+
             default:
-                szNote = D3D11_NOTE;
+                szNote = D3D11_NOTE2;
                 break;
             }
 
             if (!pPrintInfo)
             {
-                LVLINE("Feature Level", FLName(fl));
-
-                LVYESNO("Driver Concurrent Creates", threading.DriverConcurrentCreates);
-                LVYESNO("Driver Command Lists", threading.DriverCommandLists);
-                LVYESNO("Double-precision Shaders", doubles.DoublePrecisionFloatShaderOps);
-                LVYESNO("DirectCompute CS 4.x", d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x);
+                LVYESNO("Profile Marker Support", marker.Profile);
 
-                    LVLINE("Note", szNote);
+                LVLINE("Note", szNote);
             }
             else
             {
-                PRINTLINE("Feature Level", FLName(fl));
-
-                PRINTYESNO("Driver Concurrent Creates", threading.DriverConcurrentCreates);
-                PRINTYESNO("Driver Command Lists", threading.DriverCommandLists);
-                PRINTYESNO("Double-precision Shaders", doubles.DoublePrecisionFloatShaderOps);
-                PRINTYESNO("DirectCompute CS 4.x", d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x);
+                PRINTYESNO("Profile Marker Support", marker.Profile);
 
-                    PRINTLINE("Note", szNote);
+                PRINTLINE("Note", szNote);
             }
 
             return S_OK;
         }
 
-        // Use CheckFormatSupport for format usage defined as optional for Direct3D 11 devices
-        static const DXGI_FORMAT cfsShaderSample[] =
-        {
-            DXGI_FORMAT_R32G32B32_FLOAT
-        };
-
-        static const DXGI_FORMAT cfsShaderGather[] =
-        {
-            DXGI_FORMAT_R32G32B32_FLOAT
-        };
-
-        static const DXGI_FORMAT cfsMipAutoGen[] =
-        {
-            DXGI_FORMAT_R32G32B32_FLOAT
-        };
-
-        static const DXGI_FORMAT cfsRenderTarget[] =
-        {
-            DXGI_FORMAT_R32G32B32_FLOAT,
-            DXGI_FORMAT_R32G32B32_UINT,
-            DXGI_FORMAT_R32G32B32_SINT
-        };
+        // Use CheckFormatSupport for format usage defined as optional for Direct3D 11.2 devices
 
-        // Most RT formats are required to support 8x MSAA for 11 devices
-        static const DXGI_FORMAT cfsMSAA8x[] =
+        static const DXGI_FORMAT cfsShareable[] =
         {
             DXGI_FORMAT_R32G32B32A32_FLOAT,
             DXGI_FORMAT_R32G32B32A32_UINT,
-            DXGI_FORMAT_R32G32B32A32_SINT
+            DXGI_FORMAT_R32G32B32A32_SINT,
+            DXGI_FORMAT_R16G16B16A16_FLOAT,
+            DXGI_FORMAT_R16G16B16A16_UNORM,
+            DXGI_FORMAT_R16G16B16A16_UINT,
+            DXGI_FORMAT_R16G16B16A16_SNORM,
+            DXGI_FORMAT_R16G16B16A16_SINT,
+            DXGI_FORMAT_R10G10B10A2_UNORM,
+            DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM,
+            DXGI_FORMAT_R10G10B10A2_UINT,
+            DXGI_FORMAT_R8G8B8A8_UNORM,
+            DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
+            DXGI_FORMAT_R8G8B8A8_UINT,
+            DXGI_FORMAT_R8G8B8A8_SNORM,
+            DXGI_FORMAT_R8G8B8A8_SINT,
+            DXGI_FORMAT_R32_FLOAT,
+            DXGI_FORMAT_R32_UINT,
+            DXGI_FORMAT_R32_SINT,
+            DXGI_FORMAT_R8G8_UNORM,
+            DXGI_FORMAT_R16_FLOAT,
+            DXGI_FORMAT_R16_UNORM,
+            DXGI_FORMAT_R16_UINT,
+            DXGI_FORMAT_R16_SNORM,
+            DXGI_FORMAT_R16_SINT,
+            DXGI_FORMAT_R8_UNORM,
+            DXGI_FORMAT_R8_UINT,
+            DXGI_FORMAT_R8_SNORM,
+            DXGI_FORMAT_R8_SINT,
+            DXGI_FORMAT_A8_UNORM,
+            DXGI_FORMAT_BC1_UNORM,
+            DXGI_FORMAT_BC1_UNORM_SRGB,
+            DXGI_FORMAT_BC2_UNORM,
+            DXGI_FORMAT_BC2_UNORM_SRGB,
+            DXGI_FORMAT_BC3_UNORM,
+            DXGI_FORMAT_BC3_UNORM_SRGB,
+            DXGI_FORMAT_B8G8R8A8_UNORM,
+            DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,
+            DXGI_FORMAT_B8G8R8X8_UNORM,
+            DXGI_FORMAT_B8G8R8X8_UNORM_SRGB,
         };
 
         UINT count = 0;
@@ -3025,40 +3114,16 @@ namespace
 
         switch (lParam2)
         {
-        case D3D11_FORMAT_SUPPORT_SHADER_SAMPLE:
-            count = sizeof(cfsShaderSample) / sizeof(DXGI_FORMAT);
-            array = cfsShaderSample;
-            break;
-
-        case D3D11_FORMAT_SUPPORT_SHADER_GATHER:
-            count = sizeof(cfsShaderGather) / sizeof(DXGI_FORMAT);
-            array = cfsShaderGather;
-            break;
-
-        case D3D11_FORMAT_SUPPORT_MIP_AUTOGEN:
-            count = sizeof(cfsMipAutoGen) / sizeof(DXGI_FORMAT);
-            array = cfsMipAutoGen;
-            break;
-
-        case D3D11_FORMAT_SUPPORT_RENDER_TARGET:
-            count = sizeof(cfsRenderTarget) / sizeof(DXGI_FORMAT);
-            array = cfsRenderTarget;
-            break;
-
-        case D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET:
-            if (g_dwViewState != IDM_VIEWALL && lParam3 == 8)
-            {
-                count = sizeof(cfsMSAA8x) / sizeof(DXGI_FORMAT);
-                array = cfsMSAA8x;
-            }
-            else if (g_dwViewState != IDM_VIEWALL && lParam3 == 4)
-            {
-                count = 0;
-            }
-            else
+        case LPARAM(-1): // D3D11_FORMAT_SUPPORT2
+            switch (lParam3)
             {
-                count = static_cast<UINT>(std::size(g_cfsMSAA_11));
-                array = g_cfsMSAA_11;
+            case D3D11_FORMAT_SUPPORT2_SHAREABLE:
+                count = static_cast<UINT>(std::size(cfsShareable));
+                array = cfsShareable;
+                break;
+
+            default:
+                return E_FAIL;
             }
             break;
 
@@ -3070,54 +3135,30 @@ namespace
         {
             DXGI_FORMAT fmt = array[i];
 
-            if (lParam2 == D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
+            if (lParam2 != LPARAM(-1))
             {
-                // Skip 16 bits-per-pixel formats for DX 11.0
-                if (fmt == DXGI_FORMAT_B5G6R5_UNORM || fmt == DXGI_FORMAT_B5G5R5A1_UNORM || fmt == DXGI_FORMAT_B4G4R4A4_UNORM)
-                    continue;
-
-                UINT quality;
-                HRESULT hr = pDevice->CheckMultisampleQualityLevels(fmt, (UINT)lParam3, &quality);
-
-                BOOL msaa = (SUCCEEDED(hr) && quality > 0) != 0;
+                UINT fmtSupport = GetFormatSupport(pDevice, fmt);
 
                 if (!pPrintInfo)
                 {
-                    if (g_dwViewState == IDM_VIEWALL || msaa)
-                    {
-                        LVAddText(g_hwndLV, 0, FormatName(fmt));
-                        LVAddText(g_hwndLV, 1, msaa ? c_szYes : c_szNo); \
-
-                            TCHAR strBuffer[16];
-                        sprintf_s(strBuffer, 16, "%u", msaa ? quality : 0);
-                        LVAddText(g_hwndLV, 2, strBuffer);
-                    }
+                    LVYESNO(FormatName(fmt), fmtSupport & (UINT)lParam2);
                 }
                 else
                 {
-                    TCHAR strBuffer[32];
-                    if (msaa)
-                        sprintf_s(strBuffer, 32, "Yes (%u)", quality);
-                    else
-                        strcpy_s(strBuffer, 32, c_szNo);
-
-                    PrintStringValueLine(FormatName(fmt), strBuffer, pPrintInfo);
+                    PRINTYESNO(FormatName(fmt), fmtSupport & (UINT)lParam2);
                 }
             }
             else
             {
-                UINT fmtSupport = 0;
-                HRESULT hr = pDevice->CheckFormatSupport(fmt, &fmtSupport);
-                if (FAILED(hr))
-                    fmtSupport = 0;
+                UINT fmtSupport2 = GetFormatSupport2(pDevice, fmt);
 
                 if (!pPrintInfo)
                 {
-                    LVYESNO(FormatName(fmt), fmtSupport & (UINT)lParam2);
+                    LVYESNO(FormatName(fmt), fmtSupport2 & (UINT)lParam3);
                 }
                 else
                 {
-                    PRINTYESNO(FormatName(fmt), fmtSupport & (UINT)lParam2);
+                    PRINTYESNO(FormatName(fmt), fmtSupport2 & (UINT)lParam3);
                 }
             }
         }
@@ -3125,861 +3166,117 @@ namespace
         return S_OK;
     }
 
-    void D3D11FeatureSupportInfo1(ID3D11Device1* pDevice, bool bDev2, PRINTCBINFO* pPrintInfo)
+    HRESULT D3D11Info3(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
     {
+        ID3D11Device3* pDevice = reinterpret_cast<ID3D11Device3*>(lParam1);
+
         if (!pDevice)
-            return;
+            return S_OK;
 
-        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
+        if (!pPrintInfo)
+        {
+            LVAddColumn(g_hwndLV, 0, "Name", 30);
+            LVAddColumn(g_hwndLV, 1, "Value", 60);
+        }
 
-        // CheckFeatureSupport
-        D3D11_FEATURE_DATA_THREADING threading = {};
-        HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading));
-        if (FAILED(hr))
-            memset(&threading, 0, sizeof(threading));
+        // General Direct3D 11.3/11.4 device information
+        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
 
-        D3D11_FEATURE_DATA_DOUBLES doubles = {};
-        hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_DOUBLES, &doubles, sizeof(doubles));
-        if (FAILED(hr))
-            memset(&doubles, 0, sizeof(doubles));
+        if (!lParam2)
+        {
+            D3D11FeatureSupportInfo1(pDevice, true, pPrintInfo);
 
-        D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS d3d10xhw = {};
-        hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &d3d10xhw, sizeof(d3d10xhw));
-        if (FAILED(hr))
-            memset(&d3d10xhw, 0, sizeof(d3d10xhw));
+            D3D11_FEATURE_DATA_MARKER_SUPPORT marker = {};
+            HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_MARKER_SUPPORT, &marker, sizeof(marker));
+            if (FAILED(hr))
+                memset(&marker, 0, sizeof(marker));
 
-        D3D11_FEATURE_DATA_D3D11_OPTIONS d3d11opts = {};
-        hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &d3d11opts, sizeof(d3d11opts));
-        if (FAILED(hr))
-            memset(&d3d11opts, 0, sizeof(d3d11opts));
+            D3D11_FEATURE_DATA_D3D11_OPTIONS2 d3d11opts2 = {};
+            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS2, &d3d11opts2, sizeof(d3d11opts2));
+            if (FAILED(hr))
+                memset(&d3d11opts2, 0, sizeof(d3d11opts2));
 
-        D3D11_FEATURE_DATA_D3D9_OPTIONS d3d9opts = {};
-        hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D9_OPTIONS, &d3d9opts, sizeof(d3d9opts));
-        if (FAILED(hr))
-            memset(&d3d9opts, 0, sizeof(d3d9opts));
+            D3D11_FEATURE_DATA_D3D11_OPTIONS3 d3d11opts3 = {};
+            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS3, &d3d11opts3, sizeof(d3d11opts3));
+            if (FAILED(hr))
+                memset(&d3d11opts3, 0, sizeof(d3d11opts3));
 
-        D3D11_FEATURE_DATA_ARCHITECTURE_INFO d3d11arch = {};
-        hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_ARCHITECTURE_INFO, &d3d11arch, sizeof(d3d11arch));
-        if (FAILED(hr))
-            memset(&d3d11arch, 0, sizeof(d3d11arch));
+            D3D11_FEATURE_DATA_D3D11_OPTIONS4 d3d11opts4 = {};
+            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS4, &d3d11opts4, sizeof(d3d11opts4));
+            if (FAILED(hr))
+                memset(&d3d11opts4, 0, sizeof(d3d11opts4));
 
-        D3D11_FEATURE_DATA_SHADER_MIN_PRECISION_SUPPORT minprecis = {};
-        hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_SHADER_MIN_PRECISION_SUPPORT, &minprecis, sizeof(minprecis));
-        if (FAILED(hr))
-            memset(&minprecis, 0, sizeof(minprecis));
+            D3D11_FEATURE_DATA_D3D11_OPTIONS5 d3d11opts5 = {};
+            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS5, &d3d11opts5, sizeof(d3d11opts5));
+            if (FAILED(hr))
+                memset(&d3d11opts5, 0, sizeof(d3d11opts5));
 
-        D3D11_FEATURE_DATA_D3D11_OPTIONS1 d3d11opts1 = {};
-        memset(&d3d11opts1, 0, sizeof(d3d11opts1));
-        if (bDev2)
-        {
-            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS1, &d3d11opts1, sizeof(d3d11opts1));
+            D3D11_FEATURE_DATA_GPU_VIRTUAL_ADDRESS_SUPPORT d3d11vm = {};
+            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_GPU_VIRTUAL_ADDRESS_SUPPORT, &d3d11vm, sizeof(d3d11vm));
             if (FAILED(hr))
-                memset(&d3d11opts1, 0, sizeof(d3d11opts1));
-        }
+                memset(&d3d11vm, 0, sizeof(d3d11vm));
 
-        const char* clearview = nullptr;
-        if (d3d11opts.ClearView)
-        {
-            clearview = d3d11opts1.ClearViewAlsoSupportsDepthOnlyFormats ? "RTV, UAV, and Depth (Driver sees)" : "RTV and UAV (Driver sees)";
-        }
-        else
-        {
-            clearview = d3d11opts1.ClearViewAlsoSupportsDepthOnlyFormats ? "RTV, UAV, and Depth (Driver doesn't see)" : "RTV and UAV (Driver doesn't see)";
-        }
+            D3D11_FEATURE_DATA_SHADER_CACHE d3d11sc = {};
+            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_SHADER_CACHE, &d3d11sc, sizeof(d3d11sc));
+            if (FAILED(hr))
+                memset(&d3d11sc, 0, sizeof(d3d11sc));
 
-        const char* double_shaders = nullptr;
-        if (d3d11opts.ExtendedDoublesShaderInstructions)
-        {
-            double_shaders = "Extended";
-        }
-        else if (doubles.DoublePrecisionFloatShaderOps)
-        {
-            double_shaders = c_szYes;
-        }
-        else
-        {
-            double_shaders = c_szNo;
-        }
+            // Setup note
+            const char* szNote = nullptr;
 
-        const char* ps_precis = nullptr;
-        switch (minprecis.PixelShaderMinPrecision & (D3D11_SHADER_MIN_PRECISION_16_BIT | D3D11_SHADER_MIN_PRECISION_10_BIT))
-        {
-        case 0:                                 ps_precis = "Full";         break;
-        case D3D11_SHADER_MIN_PRECISION_16_BIT: ps_precis = "16/32-bit";    break;
-        case D3D11_SHADER_MIN_PRECISION_10_BIT: ps_precis = "10/32-bit";    break;
-        default:                                ps_precis = "10/16/32-bit"; break;
-        }
+            switch (fl)
+            {
+            case D3D_FEATURE_LEVEL_10_0:
+                szNote = SEE_D3D10;
+                break;
 
-        const char* other_precis = nullptr;
-        switch (minprecis.AllOtherShaderStagesMinPrecision & (D3D11_SHADER_MIN_PRECISION_16_BIT | D3D11_SHADER_MIN_PRECISION_10_BIT))
-        {
-        case 0:                                 other_precis = "Full";      break;
-        case D3D11_SHADER_MIN_PRECISION_16_BIT: other_precis = "16/32-bit"; break;
-        case D3D11_SHADER_MIN_PRECISION_10_BIT: other_precis = "10/32-bit"; break;
-        default:                                other_precis = "10/16/32-bit"; break;
-        }
+            case D3D_FEATURE_LEVEL_10_1:
+            case D3D_FEATURE_LEVEL_9_3:
+            case D3D_FEATURE_LEVEL_9_2:
+            case D3D_FEATURE_LEVEL_9_1:
+                szNote = SEE_D3D10_1;
+                break;
 
-        const char* nonpow2 = (d3d9opts.FullNonPow2TextureSupport) ? "Full" : "Conditional";
+            case D3D_FEATURE_LEVEL_11_0:
+                szNote = SEE_D3D11;
+                break;
 
-        if (!pPrintInfo)
-        {
-            LVLINE("Feature Level", FLName(fl));
+            case D3D_FEATURE_LEVEL_11_1:
+                szNote = SEE_D3D11_1;
+                break;
 
-            LVYESNO("Driver Concurrent Creates", threading.DriverConcurrentCreates);
-            LVYESNO("Driver Command Lists", threading.DriverCommandLists);
-            LVLINE("Double-precision Shaders", double_shaders);
-            LVYESNO("DirectCompute CS 4.x", d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x);
+            default:
+                szNote = (lParam3 != 0) ? D3D11_NOTE4 : D3D11_NOTE3;
+                break;
+            }
 
-            LVYESNO("Driver sees DiscardResource/View", d3d11opts.DiscardAPIsSeenByDriver);
-            LVYESNO("Driver sees COPY_FLAGS", d3d11opts.FlagsForUpdateAndCopySeenByDriver);
-            LVLINE("ClearView", clearview);
-            LVYESNO("Copy w/ Overlapping Rect", d3d11opts.CopyWithOverlap);
-            LVYESNO("CB Partial Update", d3d11opts.ConstantBufferPartialUpdate);
-            LVYESNO("CB Offsetting", d3d11opts.ConstantBufferOffsetting);
-            LVYESNO("Map NO_OVERWRITE on Dynamic CB", d3d11opts.MapNoOverwriteOnDynamicConstantBuffer);
+            char tiled_rsc[16];
+            if (d3d11opts2.TiledResourcesTier == D3D11_TILED_RESOURCES_NOT_SUPPORTED)
+                strcpy_s(tiled_rsc, "Not supported");
+            else
+                sprintf_s(tiled_rsc, "Tier %d", d3d11opts2.TiledResourcesTier);
 
-            if (fl >= D3D_FEATURE_LEVEL_10_0)
-            {
-                LVYESNO("Map NO_OVERWRITE on Dynamic SRV", d3d11opts.MapNoOverwriteOnDynamicBufferSRV);
-                LVYESNO("MSAA with ForcedSampleCount=1", d3d11opts.MultisampleRTVWithForcedSampleCountOne);
-                    LVYESNO("Extended resource sharing", d3d11opts.ExtendedResourceSharing);
-            }
+            char consrv_rast[16];
+            if (d3d11opts2.ConservativeRasterizationTier == D3D11_CONSERVATIVE_RASTERIZATION_NOT_SUPPORTED)
+                strcpy_s(consrv_rast, "Not supported");
+            else
+                sprintf_s(consrv_rast, "Tier %d", d3d11opts2.ConservativeRasterizationTier);
 
-            if (fl >= D3D_FEATURE_LEVEL_11_0)
+            const char* sharedResTier = nullptr;
+            switch (d3d11opts5.SharedResourceTier)
             {
-                LVYESNO("Saturating Add Instruction", d3d11opts.SAD4ShaderInstructions);
+            case D3D11_SHARED_RESOURCE_TIER_0: sharedResTier = "Yes - Tier 0"; break;
+            case D3D11_SHARED_RESOURCE_TIER_1: sharedResTier = "Yes - Tier 1"; break;
+            case D3D11_SHARED_RESOURCE_TIER_2: sharedResTier = "Yes - Tier 2"; break;
+            case D3D11_SHARED_RESOURCE_TIER_3: sharedResTier = "Yes - Tier 3"; break;
+            default: sharedResTier = c_szYes; break;
             }
 
-            LVYESNO("Tile-based Deferred Renderer", d3d11arch.TileBasedDeferredRenderer);
+            char vmRes[16];
+            sprintf_s(vmRes, 16, "%u", d3d11vm.MaxGPUVirtualAddressBitsPerResource);
 
-                LVLINE("Non-Power-of-2 Textures", nonpow2);
-
-            LVLINE("Pixel Shader Precision", ps_precis);
-            LVLINE("Other Stage Precision", other_precis);
-        }
-        else
-        {
-            PRINTLINE("Feature Level", FLName(fl));
-
-            PRINTYESNO("Driver Concurrent Creates", threading.DriverConcurrentCreates);
-            PRINTYESNO("Driver Command Lists", threading.DriverCommandLists);
-            PRINTLINE("Double-precision Shaders", double_shaders);
-            PRINTYESNO("DirectCompute CS 4.x", d3d10xhw.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x);
-
-            PRINTYESNO("Driver sees DiscardResource/View", d3d11opts.DiscardAPIsSeenByDriver);
-            PRINTYESNO("Driver sees COPY_FLAGS", d3d11opts.FlagsForUpdateAndCopySeenByDriver);
-            PRINTLINE("ClearView", clearview);
-            PRINTYESNO("Copy w/ Overlapping Rect", d3d11opts.CopyWithOverlap);
-            PRINTYESNO("CB Partial Update", d3d11opts.ConstantBufferPartialUpdate);
-            PRINTYESNO("CB Offsetting", d3d11opts.ConstantBufferOffsetting);
-            PRINTYESNO("Map NO_OVERWRITE on Dynamic CB", d3d11opts.MapNoOverwriteOnDynamicConstantBuffer);
-
-            if (fl >= D3D_FEATURE_LEVEL_10_0)
-            {
-                PRINTYESNO("Map NO_OVERWRITE on Dynamic SRV", d3d11opts.MapNoOverwriteOnDynamicBufferSRV);
-                PRINTYESNO("MSAA with ForcedSampleCount=1", d3d11opts.MultisampleRTVWithForcedSampleCountOne);
-                PRINTYESNO("Extended resource sharing", d3d11opts.ExtendedResourceSharing);
-            }
-
-            if (fl >= D3D_FEATURE_LEVEL_11_0)
-            {
-                PRINTYESNO("Saturating Add Instruction", d3d11opts.SAD4ShaderInstructions);
-            }
-
-            PRINTYESNO("Tile-based Deferred Renderer", d3d11arch.TileBasedDeferredRenderer);
-
-            PRINTLINE("Non-Power-of-2 Textures", nonpow2);
-
-            PRINTLINE("Pixel Shader Precision", ps_precis);
-            PRINTLINE("Other Stage Precision", other_precis);
-        }
-    }
-
-    HRESULT D3D11Info1(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
-    {
-        auto pDevice = reinterpret_cast<ID3D11Device1*>(lParam1);
-        if (!pDevice)
-            return S_OK;
-
-        if (!pPrintInfo)
-        {
-            LVAddColumn(g_hwndLV, 0, "Name", 30);
-
-            if (lParam2 == D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
-            {
-                LVAddColumn(g_hwndLV, 1, "Value", 25);
-                LVAddColumn(g_hwndLV, 2, "Quality Level", 25);
-            }
-            else
-            {
-                LVAddColumn(g_hwndLV, 1, "Value", 60);
-            }
-        }
-
-        // General Direct3D 11.1 device information
-        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
-
-        if (!lParam2)
-        {
-            D3D11FeatureSupportInfo1(pDevice, false, pPrintInfo);
-
-            // Setup note
-            const char* szNote = nullptr;
-
-            switch (fl)
-            {
-            case D3D_FEATURE_LEVEL_10_0:
-                szNote = SEE_D3D10;
-                break;
-
-            case D3D_FEATURE_LEVEL_10_1:
-            case D3D_FEATURE_LEVEL_9_3:
-            case D3D_FEATURE_LEVEL_9_2:
-            case D3D_FEATURE_LEVEL_9_1:
-                szNote = SEE_D3D10_1;
-                break;
-
-            case D3D_FEATURE_LEVEL_11_0:
-                szNote = SEE_D3D11;
-                break;
-
-            default:
-                szNote = D3D11_NOTE1;
-                break;
-            }
-
-            if (!pPrintInfo)
-            {
-                LVLINE("Note", szNote);
-            }
-            else
-            {
-                PRINTLINE("Note", szNote);
-            }
-
-            return S_OK;
-        }
-
-        // Use CheckFormatSupport for format usage defined as optional for Direct3D 11.1 devices
-
-        static const DXGI_FORMAT cfs16bpp[] =
-        {
-            DXGI_FORMAT_B5G6R5_UNORM,
-            DXGI_FORMAT_B5G5R5A1_UNORM,
-            DXGI_FORMAT_B4G4R4A4_UNORM,
-        };
-
-        static const DXGI_FORMAT cfs16bpp2[] =
-        {
-            DXGI_FORMAT_B5G5R5A1_UNORM,
-            DXGI_FORMAT_B4G4R4A4_UNORM,
-        };
-
-        static const DXGI_FORMAT cfsShaderSample[] =
-        {
-            DXGI_FORMAT_R32G32B32A32_FLOAT,
-            DXGI_FORMAT_R32G32B32_FLOAT,
-            DXGI_FORMAT_R32G32_FLOAT,
-            DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS,
-            DXGI_FORMAT_R32_FLOAT,
-            DXGI_FORMAT_R24_UNORM_X8_TYPELESS
-        };
-
-        static const DXGI_FORMAT cfsShaderSample10_1[] =
-        {
-            DXGI_FORMAT_R32G32B32_FLOAT
-        };
-
-        static const DXGI_FORMAT cfsShaderGather[] =
-        {
-            DXGI_FORMAT_R32G32B32_FLOAT
-        };
-
-        static const DXGI_FORMAT cfsMipAutoGen[] =
-        {
-            DXGI_FORMAT_R32G32B32_FLOAT,
-            DXGI_FORMAT_B5G6R5_UNORM,
-            DXGI_FORMAT_B5G5R5A1_UNORM,
-            DXGI_FORMAT_B4G4R4A4_UNORM,
-        };
-
-        static const DXGI_FORMAT cfsMipAutoGen11_1[] =
-        {
-            DXGI_FORMAT_R32G32B32_FLOAT,
-            DXGI_FORMAT_B5G5R5A1_UNORM,
-            DXGI_FORMAT_B4G4R4A4_UNORM,
-        };
-
-        static const DXGI_FORMAT cfsRenderTarget[] =
-        {
-            DXGI_FORMAT_R32G32B32_FLOAT,
-            DXGI_FORMAT_R32G32B32_UINT,
-            DXGI_FORMAT_R32G32B32_SINT,
-            DXGI_FORMAT_B5G6R5_UNORM,
-            DXGI_FORMAT_B5G5R5A1_UNORM,
-            DXGI_FORMAT_B4G4R4A4_UNORM,
-        };
-
-        static const DXGI_FORMAT cfsRenderTarget11_1[] =
-        {
-            DXGI_FORMAT_R32G32B32_FLOAT,
-            DXGI_FORMAT_R32G32B32_UINT,
-            DXGI_FORMAT_R32G32B32_SINT,
-            DXGI_FORMAT_B5G5R5A1_UNORM,
-            DXGI_FORMAT_B4G4R4A4_UNORM,
-        };
-
-        static const DXGI_FORMAT cfsBlendableRT[] =
-        {
-            DXGI_FORMAT_R32G32B32_FLOAT,
-            DXGI_FORMAT_R16G16B16A16_UNORM,
-            DXGI_FORMAT_R16G16_UNORM,
-            DXGI_FORMAT_R16_UNORM,
-            DXGI_FORMAT_B5G6R5_UNORM,
-            DXGI_FORMAT_B5G5R5A1_UNORM,
-            DXGI_FORMAT_B4G4R4A4_UNORM,
-        };
-
-        static const DXGI_FORMAT cfsLogicOps[] =
-        {
-            DXGI_FORMAT_R32G32B32A32_UINT,
-            DXGI_FORMAT_R32G32B32_UINT,
-            DXGI_FORMAT_R16G16B16A16_UINT,
-            DXGI_FORMAT_R32G32_UINT,
-            DXGI_FORMAT_R10G10B10A2_UINT,
-            DXGI_FORMAT_R8G8B8A8_UINT,
-            DXGI_FORMAT_R16G16_UINT,
-            DXGI_FORMAT_R32_UINT,
-            DXGI_FORMAT_R8G8_UINT,
-            DXGI_FORMAT_R16_UINT,
-            DXGI_FORMAT_R8_UINT,
-        };
-
-        // Most RT formats are required to support 8x MSAA for 11.x devices
-        static const DXGI_FORMAT cfsMSAA8x[] =
-        {
-            DXGI_FORMAT_R32G32B32A32_FLOAT,
-            DXGI_FORMAT_R32G32B32A32_UINT,
-            DXGI_FORMAT_R32G32B32A32_SINT,
-            DXGI_FORMAT_B5G6R5_UNORM,
-            DXGI_FORMAT_B5G5R5A1_UNORM,
-            DXGI_FORMAT_B4G4R4A4_UNORM,
-        };
-
-        UINT count = 0;
-        const DXGI_FORMAT* array = nullptr;
-        BOOL skips = FALSE;
-
-        switch (lParam2)
-        {
-        case D3D11_FORMAT_SUPPORT_IA_VERTEX_BUFFER:
-            count = sizeof(cfs16bpp) / sizeof(DXGI_FORMAT);
-            array = cfs16bpp;
-            break;
-
-        case D3D11_FORMAT_SUPPORT_SHADER_SAMPLE:
-            if (fl >= D3D_FEATURE_LEVEL_10_1)
-            {
-                count = sizeof(cfsShaderSample10_1) / sizeof(DXGI_FORMAT);
-                array = cfsShaderSample10_1;
-            }
-            else
-            {
-                count = sizeof(cfsShaderSample) / sizeof(DXGI_FORMAT);
-                array = cfsShaderSample;
-            }
-            break;
-
-        case D3D11_FORMAT_SUPPORT_SHADER_GATHER:
-            count = sizeof(cfsShaderGather) / sizeof(DXGI_FORMAT);
-            array = cfsShaderGather;
-            break;
-
-        case D3D11_FORMAT_SUPPORT_MIP_AUTOGEN:
-            if (fl >= D3D_FEATURE_LEVEL_11_1)
-            {
-                count = sizeof(cfsMipAutoGen11_1) / sizeof(DXGI_FORMAT);
-                array = cfsMipAutoGen11_1;
-            }
-            else
-            {
-                count = sizeof(cfsMipAutoGen) / sizeof(DXGI_FORMAT);
-                array = cfsMipAutoGen;
-            }
-            break;
-
-        case D3D11_FORMAT_SUPPORT_RENDER_TARGET:
-            if (fl >= D3D_FEATURE_LEVEL_11_1)
-            {
-                count = sizeof(cfsRenderTarget11_1) / sizeof(DXGI_FORMAT);
-                array = cfsRenderTarget11_1;
-            }
-            else
-            {
-                count = sizeof(cfsRenderTarget) / sizeof(DXGI_FORMAT);
-                array = cfsRenderTarget;
-            }
-            break;
-
-        case D3D11_FORMAT_SUPPORT_BLENDABLE:
-            if (fl >= D3D_FEATURE_LEVEL_10_0)
-            {
-                count = sizeof(cfs16bpp2) / sizeof(DXGI_FORMAT);
-                array = cfs16bpp2;
-            }
-            else
-            {
-                count = sizeof(cfsBlendableRT) / sizeof(DXGI_FORMAT);
-                array = cfsBlendableRT;
-            }
-            break;
-
-        case D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET:
-            if (g_dwViewState != IDM_VIEWALL && lParam3 == 8)
-            {
-                count = sizeof(cfsMSAA8x) / sizeof(DXGI_FORMAT);
-                array = cfsMSAA8x;
-            }
-            else if (g_dwViewState != IDM_VIEWALL && (lParam3 == 2 || lParam3 == 4))
-            {
-                count = sizeof(cfs16bpp) / sizeof(DXGI_FORMAT);
-                array = cfs16bpp;
-            }
-            else
-            {
-                count = sizeof(g_cfsMSAA_11) / sizeof(DXGI_FORMAT);
-                array = g_cfsMSAA_11;
-            }
-            break;
-
-        case D3D11_FORMAT_SUPPORT_MULTISAMPLE_LOAD:
-            if (fl >= D3D_FEATURE_LEVEL_10_1)
-            {
-                count = sizeof(cfs16bpp2) / sizeof(DXGI_FORMAT);
-                array = cfs16bpp2;
-            }
-            else if (fl >= D3D_FEATURE_LEVEL_10_0)
-            {
-                count = sizeof(cfs16bpp) / sizeof(DXGI_FORMAT);
-                array = cfs16bpp;
-            }
-            else
-            {
-                count = sizeof(g_cfsMSAA_11) / sizeof(DXGI_FORMAT);
-                array = g_cfsMSAA_11;
-            }
-            skips = TRUE;
-            break;
-
-        case D3D11_FORMAT_SUPPORT_TYPED_UNORDERED_ACCESS_VIEW:
-            count = sizeof(cfs16bpp) / sizeof(DXGI_FORMAT);
-            array = cfs16bpp;
-            break;
-
-        case LPARAM(-1): // D3D11_FORMAT_SUPPORT2
-            switch (lParam3)
-            {
-            case D3D11_FORMAT_SUPPORT2_OUTPUT_MERGER_LOGIC_OP:
-                count = sizeof(cfsLogicOps) / sizeof(DXGI_FORMAT);
-                array = cfsLogicOps;
-                break;
-
-            case D3D11_FORMAT_SUPPORT2_UAV_TYPED_STORE:
-                count = sizeof(cfs16bpp) / sizeof(DXGI_FORMAT);
-                array = cfs16bpp;
-                break;
-
-            default:
-                return E_FAIL;
-            }
-            break;
-
-        default:
-            return E_FAIL;
-        }
-
-        for (UINT i = 0; i < count; ++i)
-        {
-            DXGI_FORMAT fmt = array[i];
-
-            if (skips)
-            {
-                // Special logic to let us reuse the MSAA array twice with a few special cases that are skipped
-                switch (fmt)
-                {
-                case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
-                case DXGI_FORMAT_D32_FLOAT:
-                case DXGI_FORMAT_D24_UNORM_S8_UINT:
-                case DXGI_FORMAT_D16_UNORM:
-                case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
-                case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
-                    continue;
-                }
-            }
-
-            if (lParam2 == D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET)
-            {
-                if (g_dwViewState != IDM_VIEWALL && fmt == DXGI_FORMAT_B5G6R5_UNORM)
-                    continue;
-
-                UINT quality;
-                HRESULT hr = pDevice->CheckMultisampleQualityLevels(fmt, (UINT)lParam3, &quality);
-
-                BOOL msaa = (SUCCEEDED(hr) && quality > 0) != 0;
-
-                if (!pPrintInfo)
-                {
-                    if (g_dwViewState == IDM_VIEWALL || msaa)
-                    {
-                        LVAddText(g_hwndLV, 0, FormatName(fmt));
-                        LVAddText(g_hwndLV, 1, msaa ? c_szYes : c_szNo); \
-
-                            TCHAR strBuffer[16];
-                        sprintf_s(strBuffer, 16, "%u", msaa ? quality : 0);
-                        LVAddText(g_hwndLV, 2, strBuffer);
-                    }
-                }
-                else
-                {
-                    TCHAR strBuffer[32];
-                    if (msaa)
-                        sprintf_s(strBuffer, 32, "Yes (%u)", quality);
-                    else
-                        strcpy_s(strBuffer, 32, c_szNo);
-
-                    PrintStringValueLine(FormatName(fmt), strBuffer, pPrintInfo);
-                }
-            }
-            else if (lParam2 != LPARAM(-1))
-            {
-                UINT fmtSupport = 0;
-                HRESULT hr = pDevice->CheckFormatSupport(fmt, &fmtSupport);
-                if (FAILED(hr))
-                    fmtSupport = 0;
-
-                if (!pPrintInfo)
-                {
-                    LVYESNO(FormatName(fmt), fmtSupport & (UINT)lParam2);
-                }
-                else
-                {
-                    PRINTYESNO(FormatName(fmt), fmtSupport & (UINT)lParam2);
-                }
-            }
-            else
-            {
-                D3D11_FEATURE_DATA_FORMAT_SUPPORT2 cfs2;
-                cfs2.InFormat = fmt;
-                cfs2.OutFormatSupport2 = 0;
-                HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_FORMAT_SUPPORT2, &cfs2, sizeof(cfs2));
-                if (FAILED(hr))
-                    cfs2.OutFormatSupport2 = 0;
-
-                if (!pPrintInfo)
-                {
-                    LVYESNO(FormatName(fmt), cfs2.OutFormatSupport2 & (UINT)lParam3);
-                }
-                else
-                {
-                    PRINTYESNO(FormatName(fmt), cfs2.OutFormatSupport2 & (UINT)lParam3);
-                }
-            }
-        }
-
-        return S_OK;
-    }
-
-    HRESULT D3D11Info2(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
-    {
-        auto pDevice = reinterpret_cast<ID3D11Device2*>(lParam1);
-        if (!pDevice)
-            return S_OK;
-
-        if (!pPrintInfo)
-        {
-            LVAddColumn(g_hwndLV, 0, "Name", 30);
-            LVAddColumn(g_hwndLV, 1, "Value", 60);
-        }
-
-        // General Direct3D 11.2 device information
-        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
-
-        if (!lParam2)
-        {
-            D3D11FeatureSupportInfo1(pDevice, true, pPrintInfo);
-
-            D3D11_FEATURE_DATA_MARKER_SUPPORT marker = {};
-            HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_MARKER_SUPPORT, &marker, sizeof(marker));
-            if (FAILED(hr))
-                memset(&marker, 0, sizeof(marker));
-
-            // Setup note
-            const char* szNote = nullptr;
-
-            switch (fl)
-            {
-            case D3D_FEATURE_LEVEL_10_0:
-                szNote = SEE_D3D10;
-                break;
-
-            case D3D_FEATURE_LEVEL_10_1:
-            case D3D_FEATURE_LEVEL_9_3:
-            case D3D_FEATURE_LEVEL_9_2:
-            case D3D_FEATURE_LEVEL_9_1:
-                szNote = SEE_D3D10_1;
-                break;
-
-            case D3D_FEATURE_LEVEL_11_0:
-                szNote = SEE_D3D11;
-                break;
-
-            case D3D_FEATURE_LEVEL_11_1:
-                szNote = SEE_D3D11_1;
-                break;
-
-            default:
-                szNote = D3D11_NOTE2;
-                break;
-            }
-
-            if (!pPrintInfo)
-            {
-                LVYESNO("Profile Marker Support", marker.Profile);
-
-                LVLINE("Note", szNote);
-            }
-            else
-            {
-                PRINTYESNO("Profile Marker Support", marker.Profile);
-
-                PRINTLINE("Note", szNote);
-            }
-
-            return S_OK;
-        }
-
-        // Use CheckFormatSupport for format usage defined as optional for Direct3D 11.2 devices
-
-        static const DXGI_FORMAT cfsShareable[] =
-        {
-            DXGI_FORMAT_R32G32B32A32_FLOAT,
-            DXGI_FORMAT_R32G32B32A32_UINT,
-            DXGI_FORMAT_R32G32B32A32_SINT,
-            DXGI_FORMAT_R16G16B16A16_FLOAT,
-            DXGI_FORMAT_R16G16B16A16_UNORM,
-            DXGI_FORMAT_R16G16B16A16_UINT,
-            DXGI_FORMAT_R16G16B16A16_SNORM,
-            DXGI_FORMAT_R16G16B16A16_SINT,
-            DXGI_FORMAT_R10G10B10A2_UNORM,
-            DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM,
-            DXGI_FORMAT_R10G10B10A2_UINT,
-            DXGI_FORMAT_R8G8B8A8_UNORM,
-            DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
-            DXGI_FORMAT_R8G8B8A8_UINT,
-            DXGI_FORMAT_R8G8B8A8_SNORM,
-            DXGI_FORMAT_R8G8B8A8_SINT,
-            DXGI_FORMAT_R32_FLOAT,
-            DXGI_FORMAT_R32_UINT,
-            DXGI_FORMAT_R32_SINT,
-            DXGI_FORMAT_R8G8_UNORM,
-            DXGI_FORMAT_R16_FLOAT,
-            DXGI_FORMAT_R16_UNORM,
-            DXGI_FORMAT_R16_UINT,
-            DXGI_FORMAT_R16_SNORM,
-            DXGI_FORMAT_R16_SINT,
-            DXGI_FORMAT_R8_UNORM,
-            DXGI_FORMAT_R8_UINT,
-            DXGI_FORMAT_R8_SNORM,
-            DXGI_FORMAT_R8_SINT,
-            DXGI_FORMAT_A8_UNORM,
-            DXGI_FORMAT_BC1_UNORM,
-            DXGI_FORMAT_BC1_UNORM_SRGB,
-            DXGI_FORMAT_BC2_UNORM,
-            DXGI_FORMAT_BC2_UNORM_SRGB,
-            DXGI_FORMAT_BC3_UNORM,
-            DXGI_FORMAT_BC3_UNORM_SRGB,
-            DXGI_FORMAT_B8G8R8A8_UNORM,
-            DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,
-            DXGI_FORMAT_B8G8R8X8_UNORM,
-            DXGI_FORMAT_B8G8R8X8_UNORM_SRGB,
-        };
-
-        UINT count = 0;
-        const DXGI_FORMAT* array = nullptr;
-
-        switch (lParam2)
-        {
-        case LPARAM(-1): // D3D11_FORMAT_SUPPORT2
-            switch (lParam3)
-            {
-            case D3D11_FORMAT_SUPPORT2_SHAREABLE:
-                count = static_cast<UINT>(std::size(cfsShareable));
-                array = cfsShareable;
-                break;
-
-            default:
-                return E_FAIL;
-            }
-            break;
-
-        default:
-            return E_FAIL;
-        }
-
-        for (UINT i = 0; i < count; ++i)
-        {
-            DXGI_FORMAT fmt = array[i];
-
-            if (lParam2 != LPARAM(-1))
-            {
-                UINT fmtSupport = 0;
-                HRESULT hr = pDevice->CheckFormatSupport(fmt, &fmtSupport);
-                if (FAILED(hr))
-                    fmtSupport = 0;
-
-                if (!pPrintInfo)
-                {
-                    LVYESNO(FormatName(fmt), fmtSupport & (UINT)lParam2);
-                }
-                else
-                {
-                    PRINTYESNO(FormatName(fmt), fmtSupport & (UINT)lParam2);
-                }
-            }
-            else
-            {
-                D3D11_FEATURE_DATA_FORMAT_SUPPORT2 cfs2;
-                cfs2.InFormat = fmt;
-                cfs2.OutFormatSupport2 = 0;
-                HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_FORMAT_SUPPORT2, &cfs2, sizeof(cfs2));
-                if (FAILED(hr))
-                    cfs2.OutFormatSupport2 = 0;
-
-                if (!pPrintInfo)
-                {
-                    LVYESNO(FormatName(fmt), cfs2.OutFormatSupport2 & (UINT)lParam3);
-                }
-                else
-                {
-                    PRINTYESNO(FormatName(fmt), cfs2.OutFormatSupport2 & (UINT)lParam3);
-                }
-            }
-        }
-
-        return S_OK;
-    }
-
-    HRESULT D3D11Info3(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
-    {
-        ID3D11Device3* pDevice = reinterpret_cast<ID3D11Device3*>(lParam1);
-
-        if (!pDevice)
-            return S_OK;
-
-        if (!pPrintInfo)
-        {
-            LVAddColumn(g_hwndLV, 0, "Name", 30);
-            LVAddColumn(g_hwndLV, 1, "Value", 60);
-        }
-
-        // General Direct3D 11.3/11.4 device information
-        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
-
-        if (!lParam2)
-        {
-            D3D11FeatureSupportInfo1(pDevice, true, pPrintInfo);
-
-            D3D11_FEATURE_DATA_MARKER_SUPPORT marker = {};
-            HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_MARKER_SUPPORT, &marker, sizeof(marker));
-            if (FAILED(hr))
-                memset(&marker, 0, sizeof(marker));
-
-            D3D11_FEATURE_DATA_D3D11_OPTIONS2 d3d11opts2 = {};
-            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS2, &d3d11opts2, sizeof(d3d11opts2));
-            if (FAILED(hr))
-                memset(&d3d11opts2, 0, sizeof(d3d11opts2));
-
-            D3D11_FEATURE_DATA_D3D11_OPTIONS3 d3d11opts3 = {};
-            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS3, &d3d11opts3, sizeof(d3d11opts3));
-            if (FAILED(hr))
-                memset(&d3d11opts3, 0, sizeof(d3d11opts3));
-
-            D3D11_FEATURE_DATA_D3D11_OPTIONS4 d3d11opts4 = {};
-            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS4, &d3d11opts4, sizeof(d3d11opts4));
-            if (FAILED(hr))
-                memset(&d3d11opts4, 0, sizeof(d3d11opts4));
-
-            D3D11_FEATURE_DATA_D3D11_OPTIONS5 d3d11opts5 = {};
-            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS5, &d3d11opts5, sizeof(d3d11opts5));
-            if (FAILED(hr))
-                memset(&d3d11opts5, 0, sizeof(d3d11opts5));
-
-            D3D11_FEATURE_DATA_GPU_VIRTUAL_ADDRESS_SUPPORT d3d11vm = {};
-            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_GPU_VIRTUAL_ADDRESS_SUPPORT, &d3d11vm, sizeof(d3d11vm));
-            if (FAILED(hr))
-                memset(&d3d11vm, 0, sizeof(d3d11vm));
-
-            D3D11_FEATURE_DATA_SHADER_CACHE d3d11sc = {};
-            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_SHADER_CACHE, &d3d11sc, sizeof(d3d11sc));
-            if (FAILED(hr))
-                memset(&d3d11sc, 0, sizeof(d3d11sc));
-
-            // Setup note
-            const char* szNote = nullptr;
-
-            switch (fl)
-            {
-            case D3D_FEATURE_LEVEL_10_0:
-                szNote = SEE_D3D10;
-                break;
-
-            case D3D_FEATURE_LEVEL_10_1:
-            case D3D_FEATURE_LEVEL_9_3:
-            case D3D_FEATURE_LEVEL_9_2:
-            case D3D_FEATURE_LEVEL_9_1:
-                szNote = SEE_D3D10_1;
-                break;
-
-            case D3D_FEATURE_LEVEL_11_0:
-                szNote = SEE_D3D11;
-                break;
-
-            case D3D_FEATURE_LEVEL_11_1:
-                szNote = SEE_D3D11_1;
-                break;
-
-            default:
-                szNote = (lParam3 != 0) ? D3D11_NOTE4 : D3D11_NOTE3;
-                break;
-            }
-
-            char tiled_rsc[16];
-            if (d3d11opts2.TiledResourcesTier == D3D11_TILED_RESOURCES_NOT_SUPPORTED)
-                strcpy_s(tiled_rsc, "Not supported");
-            else
-                sprintf_s(tiled_rsc, "Tier %d", d3d11opts2.TiledResourcesTier);
-
-            char consrv_rast[16];
-            if (d3d11opts2.ConservativeRasterizationTier == D3D11_CONSERVATIVE_RASTERIZATION_NOT_SUPPORTED)
-                strcpy_s(consrv_rast, "Not supported");
-            else
-                sprintf_s(consrv_rast, "Tier %d", d3d11opts2.ConservativeRasterizationTier);
-
-            const char* sharedResTier = nullptr;
-            switch (d3d11opts5.SharedResourceTier)
-            {
-            case D3D11_SHARED_RESOURCE_TIER_0: sharedResTier = "Yes - Tier 0"; break;
-            case D3D11_SHARED_RESOURCE_TIER_1: sharedResTier = "Yes - Tier 1"; break;
-            case D3D11_SHARED_RESOURCE_TIER_2: sharedResTier = "Yes - Tier 2"; break;
-            case D3D11_SHARED_RESOURCE_TIER_3: sharedResTier = "Yes - Tier 3"; break;
-            default: sharedResTier = c_szYes; break;
-            }
-
-            char vmRes[16];
-            sprintf_s(vmRes, 16, "%u", d3d11vm.MaxGPUVirtualAddressBitsPerResource);
-
-            char vmProcess[16];
-            sprintf_s(vmProcess, 16, "%u", d3d11vm.MaxGPUVirtualAddressBitsPerProcess);
+            char vmProcess[16];
+            sprintf_s(vmProcess, 16, "%u", d3d11vm.MaxGPUVirtualAddressBitsPerProcess);
 
             char shaderCache[32] = {};
             if (d3d11sc.SupportFlags)
@@ -4134,10 +3431,7 @@ namespace
 
             if (lParam2 != LPARAM(-1))
             {
-                UINT fmtSupport = 0;
-                HRESULT hr = pDevice->CheckFormatSupport(fmt, &fmtSupport);
-                if (FAILED(hr))
-                    fmtSupport = 0;
+                UINT fmtSupport = GetFormatSupport(pDevice, fmt);
 
                 if (!pPrintInfo)
                 {
@@ -4150,20 +3444,15 @@ namespace
             }
             else
             {
-                D3D11_FEATURE_DATA_FORMAT_SUPPORT2 cfs2;
-                cfs2.InFormat = fmt;
-                cfs2.OutFormatSupport2 = 0;
-                HRESULT hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_FORMAT_SUPPORT2, &cfs2, sizeof(cfs2));
-                if (FAILED(hr))
-                    cfs2.OutFormatSupport2 = 0;
+                UINT fmtSupport2 = GetFormatSupport2(pDevice, fmt);
 
                 if (!pPrintInfo)
                 {
-                    LVYESNO(FormatName(fmt), cfs2.OutFormatSupport2 & (UINT)lParam3);
+                    LVYESNO(FormatName(fmt), fmtSupport2 & (UINT)lParam3);
                 }
                 else
                 {
-                    PRINTYESNO(FormatName(fmt), cfs2.OutFormatSupport2 & (UINT)lParam3);
+                    PRINTYESNO(FormatName(fmt), fmtSupport2 & (UINT)lParam3);
                 }
             }
         }
@@ -4171,13 +3460,14 @@ namespace
         return S_OK;
     }
 
-    HRESULT D3D11InfoMSAA(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
+    HRESULT D3D11InfoMSAA(LPARAM lParam1, LPARAM /*lParam2*/, LPARAM lParam3, PRINTCBINFO* pPrintInfo)
     {
         auto pDevice = reinterpret_cast<ID3D11Device*>(lParam1);
         if (!pDevice)
             return S_OK;
 
-        auto sampCount = reinterpret_cast<BOOL*>(lParam2);
+        BOOL sampCount[D3D11_MAX_MULTISAMPLE_SAMPLE_COUNT];
+        GetMSAASampleCounts(pDevice, g_cfsMSAA_11.formats, g_cfsMSAA_11.count, sampCount);
 
         if (!pPrintInfo)
         {
@@ -4196,11 +3486,11 @@ namespace
             }
         }
 
-        const UINT count = sizeof(g_cfsMSAA_11) / sizeof(DXGI_FORMAT);
+        const UINT count = g_cfsMSAA_11.count;
 
         for (UINT i = 0; i < count; ++i)
         {
-            DXGI_FORMAT fmt = g_cfsMSAA_11[i];
+            DXGI_FORMAT fmt = g_cfsMSAA_11.formats[i];
 
             // Skip 16 bits-per-pixel formats for DX 11.0
             if (lParam3 == 0
@@ -4213,10 +3503,9 @@ namespace
             BOOL any = FALSE;
             for (UINT samples = 2; samples <= D3D11_MAX_MULTISAMPLE_SAMPLE_COUNT; ++samples)
             {
-                UINT quality;
-                HRESULT hr = pDevice->CheckMultisampleQualityLevels(fmt, samples, &quality);
+                UINT quality = GetFormatQuality(pDevice, fmt, samples);
 
-                if (SUCCEEDED(hr) && quality > 0)
+                if (quality > 0)
                 {
                     sampQ[samples - 1] = quality;
                     any = TRUE;
@@ -4243,93 +3532,35 @@ namespace
                         LVAddText(g_hwndLV, column, strBuffer);
                     }
                     else
-                        LVAddText(g_hwndLV, column, c_szNo);
-
-                    ++column;
-                }
-            }
-            else
-            {
-                TCHAR buff[1024];
-                *buff = 0;
-
-                for (UINT samples = 2; samples <= D3D11_MAX_MULTISAMPLE_SAMPLE_COUNT; ++samples)
-                {
-                    if (!sampCount[samples - 1] && !IsMSAAPowerOf2(samples))
-                        continue;
-
-                    TCHAR strBuffer[32];
-                    if (sampQ[samples - 1] > 0)
-                        sprintf_s(strBuffer, 32, "%ux: Yes (%u)   ", samples, sampQ[samples - 1]);
-                    else
-                        sprintf_s(strBuffer, 32, "%ux: No   ", samples);
-
-                    strcat_s(buff, 1024, strBuffer);
-                }
-
-                PrintStringValueLine(FormatName(fmt), buff, pPrintInfo);
-            }
-        }
-
-        return S_OK;
-    }
-
-    void FillMSAASampleTable(ID3D10Device* pDevice, BOOL sampCount[], BOOL _10level9)
-    {
-        memset(sampCount, 0, sizeof(BOOL) * D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT);
-        sampCount[0] = TRUE;    // sample count of 1 is always required
-
-        UINT count = 0;
-        const DXGI_FORMAT* array = nullptr;
-
-        if (_10level9)
-        {
-            count = sizeof(g_cfsMSAA_10level9) / sizeof(DXGI_FORMAT);
-            array = g_cfsMSAA_10level9;
-        }
-        else
-        {
-            count = sizeof(g_cfsMSAA_10) / sizeof(DXGI_FORMAT);
-            array = g_cfsMSAA_10;
-        }
-
-        for (UINT samples = 2; samples <= D3D10_MAX_MULTISAMPLE_SAMPLE_COUNT; ++samples)
-        {
-            for (UINT i = 0; i < count; ++i)
-            {
-                UINT quality;
-                HRESULT hr = pDevice->CheckMultisampleQualityLevels(array[i], samples, &quality);
+                        LVAddText(g_hwndLV, column, c_szNo);
 
-                if (SUCCEEDED(hr) && quality > 0)
-                {
-                    sampCount[samples - 1] = TRUE;
-                    break;
+                    ++column;
                 }
             }
-        }
-    }
-
-    void FillMSAASampleTable(ID3D11Device* pDevice, BOOL sampCount[])
-    {
-        memset(sampCount, 0, sizeof(BOOL) * D3D11_MAX_MULTISAMPLE_SAMPLE_COUNT);
-        sampCount[0] = TRUE;    // sample count of 1 is always required
-
-        for (UINT samples = 2; samples <= D3D11_MAX_MULTISAMPLE_SAMPLE_COUNT; ++samples)
-        {
-            const UINT count = sizeof(g_cfsMSAA_11) / sizeof(DXGI_FORMAT);
-
-            for (UINT i = 0; i < count; ++i)
+            else
             {
-                UINT quality;
-                HRESULT hr = pDevice->CheckMultisampleQualityLevels(g_cfsMSAA_11[i], samples, &quality);
+                TCHAR buff[1024];
+                *buff = 0;
 
-                if (SUCCEEDED(hr) && quality > 0)
+                for (UINT samples = 2; samples <= D3D11_MAX_MULTISAMPLE_SAMPLE_COUNT; ++samples)
                 {
-                    sampCount[samples - 1] = TRUE;
-                    break;
+                    if (!sampCount[samples - 1] && !IsMSAAPowerOf2(samples))
+                        continue;
+
+                    TCHAR strBuffer[32];
+                    if (sampQ[samples - 1] > 0)
+                        sprintf_s(strBuffer, 32, "%ux: Yes (%u)   ", samples, sampQ[samples - 1]);
+                    else
+                        sprintf_s(strBuffer, 32, "%ux: No   ", samples);
+
+                    strcat_s(buff, 1024, strBuffer);
                 }
+
+                PrintStringValueLine(FormatName(fmt), buff, pPrintInfo);
             }
         }
+
+        return S_OK;
     }
 
     //-----------------------------------------------------------------------------
@@ -4348,33 +3579,11 @@ namespace
             LVAddColumn(g_hwndLV, 4, "Encoder", 15);
         }
 
-        static const DXGI_FORMAT cfsVideo[] =
-        {
-            DXGI_FORMAT_NV12,
-            DXGI_FORMAT_420_OPAQUE,
-            DXGI_FORMAT_YUY2,
-            DXGI_FORMAT_AYUV,
-            DXGI_FORMAT_Y410,
-            DXGI_FORMAT_Y416,
-            DXGI_FORMAT_P010,
-            DXGI_FORMAT_P016,
-            DXGI_FORMAT_Y210,
-            DXGI_FORMAT_Y216,
-            DXGI_FORMAT_NV11,
-            DXGI_FORMAT_AI44,
-            DXGI_FORMAT_IA44,
-            DXGI_FORMAT_P8,
-            DXGI_FORMAT_A8P8,
-        };
-
-        for (UINT i = 0; i < std::size(cfsVideo); ++i)
+        for (UINT i = 0; i < g_cfsVideo.count; ++i)
         {
-            DXGI_FORMAT fmt = cfsVideo[i];
+            DXGI_FORMAT fmt = g_cfsVideo.formats[i];
 
-            UINT fmtSupport = 0;
-            HRESULT hr = pDevice->CheckFormatSupport(fmt, &fmtSupport);
-            if (FAILED(hr))
-                fmtSupport = 0;
+            UINT fmtSupport = GetFormatSupport(pDevice, fmt);
 
             bool any = (fmtSupport & (D3D11_FORMAT_SUPPORT_TEXTURE2D
                 | D3D11_FORMAT_SUPPORT_VIDEO_PROCESSOR_INPUT
@@ -4963,222 +4172,493 @@ namespace
         TVAddNodeEx(hTreeD3D, "Shader sample (any filter)", FALSE, IDI_CAPS, D3D10Info,
             (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_SHADER_SAMPLE, 0);
 
-        TVAddNodeEx(hTreeD3D, "Mipmap Auto-Generation", FALSE, IDI_CAPS, D3D10Info,
-            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MIP_AUTOGEN, 0);
+        TVAddNodeEx(hTreeD3D, "Mipmap Auto-Generation", FALSE, IDI_CAPS, D3D10Info,
+            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MIP_AUTOGEN, 0);
+
+        TVAddNodeEx(hTreeD3D, "Render Target", FALSE, IDI_CAPS, D3D10Info,
+            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_RENDER_TARGET, 0);
+
+        TVAddNodeEx(hTreeD3D, "Blendable Render Target", FALSE, IDI_CAPS, D3D10Info,
+            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_BLENDABLE, 0);
+
+        // MSAA
+        BeginFormatMatrix(pDevice);
+
+        TVAddNodeEx(hTreeD3D, "2x MSAA", FALSE, IDI_CAPS, D3D10Info,
+            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 2);
+
+        TVAddNodeEx(hTreeD3D, "4x MSAA", FALSE, IDI_CAPS, D3D10Info,
+            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 4);
+
+        TVAddNodeEx(hTreeD3D, "8x MSAA", FALSE, IDI_CAPS, D3D10Info,
+            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 8);
+
+        TVAddNode(hTreeD3D, "Other MSAA", FALSE, IDI_CAPS, D3D10InfoMSAA, (LPARAM)pDevice, 0);
+
+        TVAddNodeEx(hTreeD3D, "MSAA Load", FALSE, IDI_CAPS, D3D10Info,
+            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_LOAD, 0);
+    }
+
+    void D3D10_FillTree1(HTREEITEM hTree, ID3D10Device1* pDevice, DWORD flMask, D3D_DRIVER_TYPE devType)
+    {
+        D3D10_FEATURE_LEVEL1 fl = pDevice->GetFeatureLevel();
+
+        HTREEITEM hTreeD3D = TVAddNodeEx(hTree, "Direct3D 10.1", TRUE,
+            IDI_CAPS, D3D10Info1, (LPARAM)pDevice, 0, 0);
+
+        TVAddNodeEx(hTreeD3D, FLName(fl), FALSE, IDI_CAPS, D3D_FeatureLevel, (LPARAM)fl, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D10_1(devType));
+
+        if ((g_DXGIFactory1 != nullptr && fl != D3D10_FEATURE_LEVEL_9_1)
+            || (g_DXGIFactory1 == nullptr && fl != D3D10_FEATURE_LEVEL_10_0))
+        {
+            HTREEITEM hTreeF = TVAddNode(hTreeD3D, "Additional Feature Levels", TRUE, IDI_CAPS, nullptr, 0, 0);
+
+            switch (fl)
+            {
+            case D3D10_FEATURE_LEVEL_10_1:
+                if (flMask & FLMASK_10_0)
+                {
+                    TVAddNodeEx(hTreeF, "D3D10_FEATURE_LEVEL_10_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_10_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D10_1(devType));
+                }
+                // Fall thru
+
+            case D3D10_FEATURE_LEVEL_10_0:
+                if (flMask & FLMASK_9_3)
+                {
+                    TVAddNodeEx(hTreeF, "D3D10_FEATURE_LEVEL_9_3", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_9_3, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D10_1(devType));
+                }
+                // Fall thru
+
+            case D3D10_FEATURE_LEVEL_9_3:
+                if (flMask & FLMASK_9_2)
+                {
+                    TVAddNodeEx(hTreeF, "D3D10_FEATURE_LEVEL_9_2", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_9_2, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D10_1(devType));
+                }
+                // Fall thru
+
+            case D3D10_FEATURE_LEVEL_9_2:
+                if (flMask & FLMASK_9_1)
+                {
+                    TVAddNodeEx(hTreeF, "D3D10_FEATURE_LEVEL_9_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_9_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D10_1(devType));
+                }
+                break;
+            }
+        }
+
+        // Only display for 10.1 devices. 10 and 11 devices are handled in their "native" node
+        // Nothing optional about 10level9 feature levels
+        if (fl == D3D10_FEATURE_LEVEL_10_1)
+        {
+            TVAddNodeEx(hTreeD3D, "Shader sample (any filter)", FALSE, IDI_CAPS, D3D10Info1,
+                (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_SHADER_SAMPLE, 0);
+
+            TVAddNodeEx(hTreeD3D, "Mipmap Auto-Generation", FALSE, IDI_CAPS, D3D10Info1,
+                (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MIP_AUTOGEN, 0);
+
+            TVAddNodeEx(hTreeD3D, "Render Target", FALSE, IDI_CAPS, D3D10Info1,
+                (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_RENDER_TARGET, 0);
+        }
+
+        // MSAA (for all but 10 devices, which are handled in their "native" node)
+        if (fl != D3D10_FEATURE_LEVEL_10_0)
+        {
+            BeginFormatMatrix(pDevice);
+
+            if (fl == D3D10_FEATURE_LEVEL_10_1)
+            {
+                TVAddNodeEx(hTreeD3D, "2x MSAA", FALSE, IDI_CAPS, D3D10Info1,
+                    (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 2);
+
+                TVAddNodeEx(hTreeD3D, "4x MSAA (most required)", FALSE, IDI_CAPS, D3D10Info1,
+                    (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 4);
+
+                TVAddNodeEx(hTreeD3D, "8x MSAA", FALSE, IDI_CAPS, D3D10Info1,
+                    (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 8);
+
+                TVAddNode(hTreeD3D, "Other MSAA", FALSE, IDI_CAPS, D3D10InfoMSAA, (LPARAM)pDevice, 0);
+            }
+            else // 10level9
+            {
+                TVAddNodeEx(hTreeD3D, "2x MSAA", FALSE, IDI_CAPS, D3D10Info1,
+                    (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 2);
+
+                if (fl >= D3D10_FEATURE_LEVEL_9_3)
+                {
+                    TVAddNodeEx(hTreeD3D, "4x MSAA", FALSE, IDI_CAPS, D3D10Info1,
+                        (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 4);
+                }
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    HRESULT D3D12InfoVideo(LPARAM lParam1, LPARAM /*lParam2*/, LPARAM /*lParam3*/, PRINTCBINFO* pPrintInfo)
+    {
+        auto pDevice = reinterpret_cast<ID3D12Device*>(lParam1);
+        if (!pDevice)
+            return S_OK;
+
+        if (!pPrintInfo)
+        {
+            LVAddColumn(g_hwndLV, 0, "Name", 30);
+            LVAddColumn(g_hwndLV, 1, "Texture2D", 15);
+            LVAddColumn(g_hwndLV, 2, "Input", 15);
+            LVAddColumn(g_hwndLV, 3, "Output", 15);
+            LVAddColumn(g_hwndLV, 4, "Encoder", 15);
+        }
+
+        for (UINT i = 0; i < g_cfsVideo.count; ++i)
+        {
+            D3D12_FEATURE_DATA_FORMAT_SUPPORT fmtSupport = {
+                g_cfsVideo.formats[i], D3D12_FORMAT_SUPPORT1_NONE, D3D12_FORMAT_SUPPORT2_NONE,
+            };
+            GetFormatSupport(pDevice, fmtSupport);
+
+            bool any = (fmtSupport.Support1 & (D3D12_FORMAT_SUPPORT1_TEXTURE2D
+                | D3D12_FORMAT_SUPPORT1_VIDEO_PROCESSOR_INPUT
+                | D3D12_FORMAT_SUPPORT1_VIDEO_PROCESSOR_OUTPUT
+                | D3D12_FORMAT_SUPPORT1_VIDEO_ENCODER)) ? true : false;
+
+            if (!pPrintInfo)
+            {
+                if (g_dwViewState != IDM_VIEWALL && !any)
+                    continue;
+
+                LVAddText(g_hwndLV, 0, FormatName(fmtSupport.Format));
+
+                LVAddText(g_hwndLV, 1, (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_TEXTURE2D) ? c_szYes : c_szNo);
+                LVAddText(g_hwndLV, 2, (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_VIDEO_PROCESSOR_INPUT) ? c_szYes : c_szNo);
+                LVAddText(g_hwndLV, 3, (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_VIDEO_PROCESSOR_OUTPUT) ? c_szYes : c_szNo);
+                LVAddText(g_hwndLV, 4, (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_VIDEO_ENCODER) ? c_szYes : c_szNo);
+            }
+            else
+            {
+                TCHAR buff[1024];
+
+                sprintf_s(buff, "Texture2D: %-3s   Input: %-3s   Output: %-3s   Encoder: %-3s",
+                    (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_TEXTURE2D) ? c_szYes : c_szNo,
+                    (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_VIDEO_PROCESSOR_INPUT) ? c_szYes : c_szNo,
+                    (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_VIDEO_PROCESSOR_OUTPUT) ? c_szYes : c_szNo,
+                    (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_VIDEO_ENCODER) ? c_szYes : c_szNo);
+
+                PrintStringValueLine(FormatName(fmtSupport.Format), buff, pPrintInfo);
+            }
+        }
+
+        return S_OK;
+    }
+
+    //-----------------------------------------------------------------------------
+    void D3D11_FillTree(HTREEITEM hTree, ID3D11Device* pDevice, DWORD flMask, D3D_DRIVER_TYPE devType)
+    {
+        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
+        if (fl > D3D_FEATURE_LEVEL_11_0)
+            fl = D3D_FEATURE_LEVEL_11_0;
+
+        HTREEITEM hTreeD3D = TVAddNodeEx(hTree, "Direct3D 11.0", TRUE,
+            IDI_CAPS, D3D11Info, (LPARAM)pDevice, 0, 0);
+
+        TVAddNodeEx(hTreeD3D, FLName(fl), FALSE, IDI_CAPS, D3D_FeatureLevel,
+            (LPARAM)fl, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11(devType));
+
+        if (fl != D3D_FEATURE_LEVEL_9_1)
+        {
+            HTREEITEM hTreeF = TVAddNode(hTreeD3D, "Additional Feature Levels", TRUE, IDI_CAPS, nullptr, 0, 0);
+
+            switch (fl)
+            {
+            case D3D_FEATURE_LEVEL_11_0:
+                if (flMask & FLMASK_10_1)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_10_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11(devType));
+                }
+                // Fall thru
+
+            case D3D_FEATURE_LEVEL_10_1:
+                if (flMask & FLMASK_10_0)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_10_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11(devType));
+                }
+                // Fall thru
+
+            case D3D_FEATURE_LEVEL_10_0:
+                if (flMask & FLMASK_9_3)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_3", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_9_3, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11(devType));
+                }
+                // Fall thru
+
+            case D3D_FEATURE_LEVEL_9_3:
+                if (flMask & FLMASK_9_2)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_2", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_9_2, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11(devType));
+                }
+                // Fall thru
+
+            case D3D_FEATURE_LEVEL_9_2:
+                if (flMask & FLMASK_9_1)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_9_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11(devType));
+                }
+                break;
+            }
+        }
 
-        TVAddNodeEx(hTreeD3D, "Render Target", FALSE, IDI_CAPS, D3D10Info,
-            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_RENDER_TARGET, 0);
+        if (fl >= D3D_FEATURE_LEVEL_11_0)
+        {
+            TVAddNodeEx(hTreeD3D, "Shader sample (any filter)", FALSE, IDI_CAPS, D3D11Info,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_SHADER_SAMPLE, 0);
 
-        TVAddNodeEx(hTreeD3D, "Blendable Render Target", FALSE, IDI_CAPS, D3D10Info,
-            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_BLENDABLE, 0);
+            TVAddNodeEx(hTreeD3D, "Shader gather4", FALSE, IDI_CAPS, D3D11Info,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_SHADER_GATHER, 0);
 
-        // MSAA
-        FillMSAASampleTable(pDevice, g_sampCount10, FALSE);
+            TVAddNodeEx(hTreeD3D, "Mipmap Auto-Generation", FALSE, IDI_CAPS, D3D11Info,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MIP_AUTOGEN, 0);
 
-        TVAddNodeEx(hTreeD3D, "2x MSAA", FALSE, IDI_CAPS, D3D10Info,
-            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 2);
+            TVAddNodeEx(hTreeD3D, "Render Target", FALSE, IDI_CAPS, D3D11Info,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_RENDER_TARGET, 0);
 
-        TVAddNodeEx(hTreeD3D, "4x MSAA", FALSE, IDI_CAPS, D3D10Info,
-            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 4);
+            // MSAA (MSAA data for 10level9 is shown under the 10.1 node)
+            BeginFormatMatrix(pDevice);
 
-        TVAddNodeEx(hTreeD3D, "8x MSAA", FALSE, IDI_CAPS, D3D10Info,
-            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 8);
+            TVAddNodeEx(hTreeD3D, "2x MSAA", FALSE, IDI_CAPS, D3D11Info,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 2);
 
-        TVAddNode(hTreeD3D, "Other MSAA", FALSE, IDI_CAPS, D3D10InfoMSAA, (LPARAM)pDevice, (LPARAM)g_sampCount10);
+            TVAddNodeEx(hTreeD3D, "4x MSAA (all required)", FALSE, IDI_CAPS, D3D11Info,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 4);
 
-        TVAddNodeEx(hTreeD3D, "MSAA Load", FALSE, IDI_CAPS, D3D10Info,
-            (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_LOAD, 0);
+            TVAddNodeEx(hTreeD3D, "8x MSAA (most required)", FALSE, IDI_CAPS, D3D11Info,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 8);
+
+            TVAddNodeEx(hTreeD3D, "Other MSAA", FALSE, IDI_CAPS, D3D11InfoMSAA,
+                (LPARAM)pDevice, 0, 0);
+        }
     }
 
-    void D3D10_FillTree1(HTREEITEM hTree, ID3D10Device1* pDevice, DWORD flMask, D3D_DRIVER_TYPE devType)
+    void D3D11_FillTree1(HTREEITEM hTree, ID3D11Device1* pDevice, DWORD flMask, D3D_DRIVER_TYPE devType)
     {
-        D3D10_FEATURE_LEVEL1 fl = pDevice->GetFeatureLevel();
+        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
+        if (fl > D3D_FEATURE_LEVEL_11_1)
+            fl = D3D_FEATURE_LEVEL_11_1;
 
-        HTREEITEM hTreeD3D = TVAddNodeEx(hTree, "Direct3D 10.1", TRUE,
-            IDI_CAPS, D3D10Info1, (LPARAM)pDevice, 0, 0);
+        HTREEITEM hTreeD3D = TVAddNodeEx(hTree, "Direct3D 11.1", TRUE,
+            IDI_CAPS, D3D11Info1, (LPARAM)pDevice, 0, 0);
 
-        TVAddNodeEx(hTreeD3D, FLName(fl), FALSE, IDI_CAPS, D3D_FeatureLevel, (LPARAM)fl, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D10_1(devType));
+        TVAddNodeEx(hTreeD3D, FLName(fl), FALSE, IDI_CAPS, D3D_FeatureLevel,
+            (LPARAM)fl, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
 
-        if ((g_DXGIFactory1 != nullptr && fl != D3D10_FEATURE_LEVEL_9_1)
-            || (g_DXGIFactory1 == nullptr && fl != D3D10_FEATURE_LEVEL_10_0))
+        if (fl != D3D_FEATURE_LEVEL_9_1)
         {
             HTREEITEM hTreeF = TVAddNode(hTreeD3D, "Additional Feature Levels", TRUE, IDI_CAPS, nullptr, 0, 0);
 
             switch (fl)
             {
-            case D3D10_FEATURE_LEVEL_10_1:
+            case D3D_FEATURE_LEVEL_11_1:
+                if (flMask & FLMASK_11_0)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_11_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_11_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
+                }
+                // Fall thru
+
+            case D3D_FEATURE_LEVEL_11_0:
+                if (flMask & FLMASK_10_1)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_10_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
+                }
+                // Fall thru
+
+            case D3D_FEATURE_LEVEL_10_1:
                 if (flMask & FLMASK_10_0)
                 {
-                    TVAddNodeEx(hTreeF, "D3D10_FEATURE_LEVEL_10_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_10_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D10_1(devType));
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_10_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
                 }
                 // Fall thru
 
-            case D3D10_FEATURE_LEVEL_10_0:
+            case D3D_FEATURE_LEVEL_10_0:
                 if (flMask & FLMASK_9_3)
                 {
-                    TVAddNodeEx(hTreeF, "D3D10_FEATURE_LEVEL_9_3", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_3, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D10_1(devType));
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_3", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_9_3, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
                 }
                 // Fall thru
 
-            case D3D10_FEATURE_LEVEL_9_3:
+            case D3D_FEATURE_LEVEL_9_3:
                 if (flMask & FLMASK_9_2)
                 {
-                    TVAddNodeEx(hTreeF, "D3D10_FEATURE_LEVEL_9_2", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_2, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D10_1(devType));
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_2", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_9_2, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
                 }
                 // Fall thru
 
-            case D3D10_FEATURE_LEVEL_9_2:
+            case D3D_FEATURE_LEVEL_9_2:
                 if (flMask & FLMASK_9_1)
                 {
-                    TVAddNodeEx(hTreeF, "D3D10_FEATURE_LEVEL_9_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D10_1(devType));
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_9_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
                 }
                 break;
             }
         }
 
-        // Only display for 10.1 devices. 10 and 11 devices are handled in their "native" node
-        // Nothing optional about 10level9 feature levels
-        if (fl == D3D10_FEATURE_LEVEL_10_1)
+        if (fl >= D3D_FEATURE_LEVEL_10_0)
         {
-            TVAddNodeEx(hTreeD3D, "Shader sample (any filter)", FALSE, IDI_CAPS, D3D10Info1,
-                (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_SHADER_SAMPLE, 0);
-
-            TVAddNodeEx(hTreeD3D, "Mipmap Auto-Generation", FALSE, IDI_CAPS, D3D10Info1,
-                (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MIP_AUTOGEN, 0);
-
-            TVAddNodeEx(hTreeD3D, "Render Target", FALSE, IDI_CAPS, D3D10Info1,
-                (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_RENDER_TARGET, 0);
-        }
+            TVAddNodeEx(hTreeD3D, "IA Vertex Buffer", FALSE, IDI_CAPS, D3D11Info1,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_IA_VERTEX_BUFFER, 0);
 
-        // MSAA (for all but 10 devices, which are handled in their "native" node)
-        if (fl != D3D10_FEATURE_LEVEL_10_0)
-        {
-            FillMSAASampleTable(pDevice, g_sampCount10_1, (fl != D3D10_FEATURE_LEVEL_10_1));
+            TVAddNodeEx(hTreeD3D, "Shader sample (any filter)", FALSE, IDI_CAPS, D3D11Info1,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_SHADER_SAMPLE, 0);
 
-            if (fl == D3D10_FEATURE_LEVEL_10_1)
+            if (fl >= D3D_FEATURE_LEVEL_11_0)
             {
-                TVAddNodeEx(hTreeD3D, "2x MSAA", FALSE, IDI_CAPS, D3D10Info1,
-                    (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 2);
+                TVAddNodeEx(hTreeD3D, "Shader gather4", FALSE, IDI_CAPS, D3D11Info1,
+                    (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_SHADER_GATHER, 0);
+            }
 
-                TVAddNodeEx(hTreeD3D, "4x MSAA (most required)", FALSE, IDI_CAPS, D3D10Info1,
-                    (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 4);
+            TVAddNodeEx(hTreeD3D, "Mipmap Auto-Generation", FALSE, IDI_CAPS, D3D11Info1,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MIP_AUTOGEN, 0);
 
-                TVAddNodeEx(hTreeD3D, "8x MSAA", FALSE, IDI_CAPS, D3D10Info1,
-                    (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 8);
+            TVAddNodeEx(hTreeD3D, "Render Target", FALSE, IDI_CAPS, D3D11Info1,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_RENDER_TARGET, 0);
+
+            TVAddNodeEx(hTreeD3D, "Blendable Render Target", FALSE, IDI_CAPS, D3D11Info1,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_BLENDABLE, 0);
 
-                TVAddNode(hTreeD3D, "Other MSAA", FALSE, IDI_CAPS, D3D10InfoMSAA, (LPARAM)pDevice, (LPARAM)g_sampCount10_1);
+            if (fl < D3D_FEATURE_LEVEL_11_1)
+            {
+                // This is required for 11.1, but is optional for 10.x and 11.0
+                TVAddNodeEx(hTreeD3D, "OM Logic Ops", FALSE, IDI_CAPS, D3D11Info1,
+                    (LPARAM)pDevice, (LPARAM)-1, (LPARAM)D3D11_FORMAT_SUPPORT2_OUTPUT_MERGER_LOGIC_OP);
             }
-            else // 10level9
+
+            if (fl >= D3D_FEATURE_LEVEL_11_0)
             {
-                TVAddNodeEx(hTreeD3D, "2x MSAA", FALSE, IDI_CAPS, D3D10Info1,
-                    (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 2);
+                TVAddNodeEx(hTreeD3D, "Typed UAV (most required)", FALSE, IDI_CAPS, D3D11Info1,
+                    (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_TYPED_UNORDERED_ACCESS_VIEW, 0);
 
-                if (fl >= D3D10_FEATURE_LEVEL_9_3)
-                {
-                    TVAddNodeEx(hTreeD3D, "4x MSAA", FALSE, IDI_CAPS, D3D10Info1,
-                        (LPARAM)pDevice, (LPARAM)D3D10_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 4);
-                }
+                TVAddNodeEx(hTreeD3D, "UAV Typed Store (most required)", FALSE, IDI_CAPS, D3D11Info1,
+                    (LPARAM)pDevice, (LPARAM)-1, (LPARAM)D3D11_FORMAT_SUPPORT2_UAV_TYPED_STORE);
             }
+
+            // MSAA (MSAA data for 10level9 is shown under the 10.1 node)
+            BeginFormatMatrix(pDevice);
+
+            TVAddNodeEx(hTreeD3D, "2x MSAA", FALSE, IDI_CAPS, D3D11Info1,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 2);
+
+            TVAddNodeEx(hTreeD3D, "4x MSAA (all required)", FALSE, IDI_CAPS, D3D11Info1,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 4);
+
+            TVAddNodeEx(hTreeD3D, "8x MSAA (most required)", FALSE, IDI_CAPS, D3D11Info1,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 8);
+
+            TVAddNodeEx(hTreeD3D, "Other MSAA", FALSE, IDI_CAPS, D3D11InfoMSAA,
+                (LPARAM)pDevice, 0, 1);
+
+            TVAddNodeEx(hTreeD3D, "MSAA Load", FALSE, IDI_CAPS, D3D11Info1,
+                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_LOAD, 0);
+        }
+
+        if (devType != D3D_DRIVER_TYPE_REFERENCE)
+        {
+            TVAddNodeEx(hTreeD3D, "Video", FALSE, IDI_CAPS, D3D11InfoVideo, (LPARAM)pDevice, 0, 0);
         }
     }
 
-    //-----------------------------------------------------------------------------
-    HRESULT D3D12InfoVideo(LPARAM lParam1, LPARAM /*lParam2*/, LPARAM /*lParam3*/, PRINTCBINFO* pPrintInfo)
+    void D3D11_FillTree2(HTREEITEM hTree, ID3D11Device2* pDevice, DWORD flMask, D3D_DRIVER_TYPE devType)
     {
-        auto pDevice = reinterpret_cast<ID3D12Device*>(lParam1);
-        if (!pDevice)
-            return S_OK;
+        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
+        if (fl > D3D_FEATURE_LEVEL_11_1)
+            fl = D3D_FEATURE_LEVEL_11_1;
 
-        if (!pPrintInfo)
-        {
-            LVAddColumn(g_hwndLV, 0, "Name", 30);
-            LVAddColumn(g_hwndLV, 1, "Texture2D", 15);
-            LVAddColumn(g_hwndLV, 2, "Input", 15);
-            LVAddColumn(g_hwndLV, 3, "Output", 15);
-            LVAddColumn(g_hwndLV, 4, "Encoder", 15);
-        }
+        HTREEITEM hTreeD3D = TVAddNodeEx(hTree, "Direct3D 11.2", TRUE,
+            IDI_CAPS, D3D11Info2, (LPARAM)pDevice, 0, 0);
 
-        static const DXGI_FORMAT cfsVideo[] =
-        {
-            DXGI_FORMAT_NV12,
-            DXGI_FORMAT_420_OPAQUE,
-            DXGI_FORMAT_YUY2,
-            DXGI_FORMAT_AYUV,
-            DXGI_FORMAT_Y410,
-            DXGI_FORMAT_Y416,
-            DXGI_FORMAT_P010,
-            DXGI_FORMAT_P016,
-            DXGI_FORMAT_Y210,
-            DXGI_FORMAT_Y216,
-            DXGI_FORMAT_NV11,
-            DXGI_FORMAT_AI44,
-            DXGI_FORMAT_IA44,
-            DXGI_FORMAT_P8,
-            DXGI_FORMAT_A8P8,
-        };
+        TVAddNodeEx(hTreeD3D, FLName(fl), FALSE, IDI_CAPS, D3D_FeatureLevel,
+            (LPARAM)fl, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
 
-        for (UINT i = 0; i < std::size(cfsVideo); ++i)
+        if (fl != D3D_FEATURE_LEVEL_9_1)
         {
-            D3D12_FEATURE_DATA_FORMAT_SUPPORT fmtSupport = {
-                cfsVideo[i], D3D12_FORMAT_SUPPORT1_NONE, D3D12_FORMAT_SUPPORT2_NONE,
-            };
-            if (FAILED(pDevice->CheckFeatureSupport(D3D12_FEATURE_FORMAT_SUPPORT,
-                &fmtSupport, sizeof(D3D12_FEATURE_DATA_FORMAT_SUPPORT))))
-            {
-                fmtSupport.Support1 = D3D12_FORMAT_SUPPORT1_NONE;
-                fmtSupport.Support2 = D3D12_FORMAT_SUPPORT2_NONE;
-            }
-
-            bool any = (fmtSupport.Support1 & (D3D12_FORMAT_SUPPORT1_TEXTURE2D
-                | D3D12_FORMAT_SUPPORT1_VIDEO_PROCESSOR_INPUT
-                | D3D12_FORMAT_SUPPORT1_VIDEO_PROCESSOR_OUTPUT
-                | D3D12_FORMAT_SUPPORT1_VIDEO_ENCODER)) ? true : false;
+            HTREEITEM hTreeF = TVAddNode(hTreeD3D, "Additional Feature Levels", TRUE, IDI_CAPS, nullptr, 0, 0);
 
-            if (!pPrintInfo)
+            switch (fl)
             {
-                if (g_dwViewState != IDM_VIEWALL && !any)
-                    continue;
+            case D3D_FEATURE_LEVEL_11_1:
+                if (flMask & FLMASK_11_0)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_11_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_11_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
+                }
+                // Fall thru
 
-                LVAddText(g_hwndLV, 0, FormatName(fmtSupport.Format));
+            case D3D_FEATURE_LEVEL_11_0:
+                if (flMask & FLMASK_10_1)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_10_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
+                }
+                // Fall thru
 
-                LVAddText(g_hwndLV, 1, (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_TEXTURE2D) ? c_szYes : c_szNo);
-                LVAddText(g_hwndLV, 2, (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_VIDEO_PROCESSOR_INPUT) ? c_szYes : c_szNo);
-                LVAddText(g_hwndLV, 3, (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_VIDEO_PROCESSOR_OUTPUT) ? c_szYes : c_szNo);
-                LVAddText(g_hwndLV, 4, (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_VIDEO_ENCODER) ? c_szYes : c_szNo);
-            }
-            else
-            {
-                TCHAR buff[1024];
+            case D3D_FEATURE_LEVEL_10_1:
+                if (flMask & FLMASK_10_0)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_10_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
+                }
+                // Fall thru
 
-                sprintf_s(buff, "Texture2D: %-3s   Input: %-3s   Output: %-3s   Encoder: %-3s",
-                    (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_TEXTURE2D) ? c_szYes : c_szNo,
-                    (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_VIDEO_PROCESSOR_INPUT) ? c_szYes : c_szNo,
-                    (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_VIDEO_PROCESSOR_OUTPUT) ? c_szYes : c_szNo,
-                    (fmtSupport.Support1 & D3D12_FORMAT_SUPPORT1_VIDEO_ENCODER) ? c_szYes : c_szNo);
+            case D3D_FEATURE_LEVEL_10_0:
+                if (flMask & FLMASK_9_3)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_3", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_9_3, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
+                }
+                // Fall thru
 
-                PrintStringValueLine(FormatName(fmtSupport.Format), buff, pPrintInfo);
+            case D3D_FEATURE_LEVEL_9_3:
+                if (flMask & FLMASK_9_2)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_2", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_9_2, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
+                }
+                // Fall thru
+
+            case D3D_FEATURE_LEVEL_9_2:
+                if (flMask & FLMASK_9_1)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_9_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
+                }
+                break;
             }
         }
 
-        return S_OK;
+        // The majority of this data is already shown under the DirectX 11.1 node, so we only show the 'new' info
+
+        TVAddNodeEx(hTreeD3D, "Shareable", FALSE, IDI_CAPS, D3D11Info2,
+            (LPARAM)pDevice, (LPARAM)-1, (LPARAM)D3D11_FORMAT_SUPPORT2_SHAREABLE);
     }
 
-    //-----------------------------------------------------------------------------
-    void D3D11_FillTree(HTREEITEM hTree, ID3D11Device* pDevice, DWORD flMask, D3D_DRIVER_TYPE devType)
+    void D3D11_FillTree3(HTREEITEM hTree, ID3D11Device3* pDevice, ID3D11Device4* pDevice4, DWORD flMask, D3D_DRIVER_TYPE devType)
     {
         D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
-        if (fl > D3D_FEATURE_LEVEL_11_0)
-            fl = D3D_FEATURE_LEVEL_11_0;
 
-        HTREEITEM hTreeD3D = TVAddNodeEx(hTree, "Direct3D 11.0", TRUE,
-            IDI_CAPS, D3D11Info, (LPARAM)pDevice, 0, 0);
+        HTREEITEM hTreeD3D = TVAddNodeEx(hTree, (pDevice4) ? "Direct3D 11.3/11.4" : "Direct3D 11.3", TRUE,
+            IDI_CAPS, D3D11Info3, (LPARAM)pDevice, 0, (LPARAM)pDevice4);
 
         TVAddNodeEx(hTreeD3D, FLName(fl), FALSE, IDI_CAPS, D3D_FeatureLevel,
-            (LPARAM)fl, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11(devType));
+            (LPARAM)fl, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
 
         if (fl != D3D_FEATURE_LEVEL_9_1)
         {
@@ -5186,11 +4666,43 @@ namespace
 
             switch (fl)
             {
+            case D3D_FEATURE_LEVEL_12_2:
+                if (flMask & FLMASK_12_1)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_12_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_12_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
+                }
+                // Fall thru
+
+            case D3D_FEATURE_LEVEL_12_1:
+                if (flMask & FLMASK_12_0)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_12_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_12_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
+                }
+                // Fall thru
+
+            case D3D_FEATURE_LEVEL_12_0:
+                if (flMask & FLMASK_11_1)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_11_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_11_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
+                }
+                // Fall thru
+
+            case D3D_FEATURE_LEVEL_11_1:
+                if (flMask & FLMASK_11_0)
+                {
+                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_11_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                        (LPARAM)D3D_FEATURE_LEVEL_11_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
+                }
+                // Fall thru
+
             case D3D_FEATURE_LEVEL_11_0:
                 if (flMask & FLMASK_10_1)
                 {
                     TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_10_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11(devType));
+                        (LPARAM)D3D_FEATURE_LEVEL_10_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
                 }
                 // Fall thru
 
@@ -5198,7 +4710,7 @@ namespace
                 if (flMask & FLMASK_10_0)
                 {
                     TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_10_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11(devType));
+                        (LPARAM)D3D_FEATURE_LEVEL_10_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
                 }
                 // Fall thru
 
@@ -5206,7 +4718,7 @@ namespace
                 if (flMask & FLMASK_9_3)
                 {
                     TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_3", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_3, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11(devType));
+                        (LPARAM)D3D_FEATURE_LEVEL_9_3, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
                 }
                 // Fall thru
 
@@ -5214,7 +4726,7 @@ namespace
                 if (flMask & FLMASK_9_2)
                 {
                     TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_2", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_2, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11(devType));
+                        (LPARAM)D3D_FEATURE_LEVEL_9_2, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
                 }
                 // Fall thru
 
@@ -5222,406 +4734,1000 @@ namespace
                 if (flMask & FLMASK_9_1)
                 {
                     TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11(devType));
+                        (LPARAM)D3D_FEATURE_LEVEL_9_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
                 }
                 break;
             }
         }
 
-        if (fl >= D3D_FEATURE_LEVEL_11_0)
+        // The majority of this data is already shown under the DirectX 11.1 or 11.2 node, so we only show the 'new' info
+
+        TVAddNodeEx(hTreeD3D, "UAV Typed Load", FALSE, IDI_CAPS, D3D11Info3,
+            (LPARAM)pDevice, (LPARAM)-1, (LPARAM)D3D11_FORMAT_SUPPORT2_UAV_TYPED_LOAD);
+    }
+
+    //-----------------------------------------------------------------------------
+    void D3D12_FillTree(HTREEITEM hTree, ID3D12Device* pDevice, D3D_DRIVER_TYPE devType)
+    {
+        D3D_FEATURE_LEVEL fl = GetD3D12FeatureLevel(pDevice);
+
+        HTREEITEM hTreeD3D = TVAddNodeEx(hTree, "Direct3D 12", TRUE, IDI_CAPS, D3D12Info, (LPARAM)pDevice, (LPARAM)fl, 0);
+
+        TVAddNodeEx(hTreeD3D, FLName(fl), FALSE, IDI_CAPS, D3D_FeatureLevel, (LPARAM)fl, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D12(devType));
+
+        if (fl != D3D_FEATURE_LEVEL_11_0)
         {
-            TVAddNodeEx(hTreeD3D, "Shader sample (any filter)", FALSE, IDI_CAPS, D3D11Info,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_SHADER_SAMPLE, 0);
+            HTREEITEM hTreeF = TVAddNode(hTreeD3D, "Additional Feature Levels", TRUE, IDI_CAPS, nullptr, 0, 0);
 
-            TVAddNodeEx(hTreeD3D, "Shader gather4", FALSE, IDI_CAPS, D3D11Info,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_SHADER_GATHER, 0);
+            switch (fl)
+            {
+            case D3D_FEATURE_LEVEL_12_2:
+                TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_12_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                    (LPARAM)D3D_FEATURE_LEVEL_12_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D12(devType));
+                // Fall thru
 
-            TVAddNodeEx(hTreeD3D, "Mipmap Auto-Generation", FALSE, IDI_CAPS, D3D11Info,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MIP_AUTOGEN, 0);
+            case D3D_FEATURE_LEVEL_12_1:
+                TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_12_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                    (LPARAM)D3D_FEATURE_LEVEL_12_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D12(devType));
+                // Fall thru
 
-            TVAddNodeEx(hTreeD3D, "Render Target", FALSE, IDI_CAPS, D3D11Info,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_RENDER_TARGET, 0);
+            case D3D_FEATURE_LEVEL_12_0:
+                TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_11_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                    (LPARAM)D3D_FEATURE_LEVEL_11_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D12(devType));
+                // Fall thru
 
-            // MSAA (MSAA data for 10level9 is shown under the 10.1 node)
-            FillMSAASampleTable(pDevice, g_sampCount11);
+            case D3D_FEATURE_LEVEL_11_1:
+                TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_11_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
+                    (LPARAM)D3D_FEATURE_LEVEL_11_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D12(devType));
+                break;
+            }
+        }
 
-            TVAddNodeEx(hTreeD3D, "2x MSAA", FALSE, IDI_CAPS, D3D11Info,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 2);
+        TVAddNodeEx(hTreeD3D, "Architecture", FALSE, IDI_CAPS, D3D12Architecture, (LPARAM)pDevice, 0, 0);
 
-            TVAddNodeEx(hTreeD3D, "4x MSAA (all required)", FALSE, IDI_CAPS, D3D11Info,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 4);
+        TVAddNodeEx(hTreeD3D, "Extended Shader Features", FALSE, IDI_CAPS, D3D12ExShaderInfo, (LPARAM)pDevice, 0, 0);
 
-            TVAddNodeEx(hTreeD3D, "8x MSAA (most required)", FALSE, IDI_CAPS, D3D11Info,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 8);
+        TVAddNodeEx(hTreeD3D, "Multi-GPU", FALSE, IDI_CAPS, D3D12MultiGPU, (LPARAM)pDevice, 0, 0);
 
-            TVAddNodeEx(hTreeD3D, "Other MSAA", FALSE, IDI_CAPS, D3D11InfoMSAA,
-                (LPARAM)pDevice, (LPARAM)g_sampCount11, 0);
+        TVAddNodeEx(hTreeD3D, "Video", FALSE, IDI_CAPS, D3D12InfoVideo, (LPARAM)pDevice, 0, 1);
+    }
+
+    //-----------------------------------------------------------------------------
+    // Device probing
+    //
+    // Device creation is by far the slowest part of startup, so each adapter
+    // (plus WARP and REF) is probed on the system thread pool with one work item
+    // per adapter. DXGI_FillTree then builds the tree on the UI thread from the
+    // results, so startup scales with the slowest adapter rather than the sum.
+    // A work item creates its adapter's devices one API after another, as a
+    // driver serializes device creation on an adapter anyway.
+    //
+    // Each API is probed under the watchdog against a private copy of its
+    // adapter's probe, which is only merged back once it has finished in time,
+    // so one that hangs in the driver can be abandoned without the tree ever
+    // seeing what it goes on to write.
+    //-----------------------------------------------------------------------------
+    struct DXGIDeviceProbe
+    {
+        IDXGIAdapter*       pAdapter;
+        IDXGIAdapter1*      pAdapter1;
+        IDXGIAdapter2*      pAdapter2;
+        IDXGIAdapter3*      pAdapter3;
+        DXGI_ADAPTER_DESC   aDesc;
+        UINT                iAdapter;
+        CHAR                strName[128];   // Description, for probe timing
+
+        ID3D12Device*       pDevice12;
+
+        ID3D11Device*       pDevice11;
+        ID3D11Device1*      pDevice11_1;
+        ID3D11Device2*      pDevice11_2;
+        ID3D11Device3*      pDevice11_3;
+        ID3D11Device4*      pDevice11_4;
+        DWORD               flMaskDX11;
+
+        ID3D11Device*       pKeptDevices11[std::size(g_featureLevels)];  // See ProbeAdapterD3D11
+        UINT                numKeptDevices11;
+
+        ID3D10Device*       pDevice10;
+        ID3D10Device1*      pDevice10_1;
+        DWORD               flMaskDX10;
+
+        uint64_t            deadline;       // For all of the adapter's probes, see WatchdogAdapterDeadline
+        const char*         strTimedOut[3]; // APIs whose probes were abandoned
+        UINT                numTimedOut;
+    };
+
+    using PROBECALLBACK = void(*)(DXGIDeviceProbe& probe);
+
+    struct PROBEAPI
+    {
+        PROBECALLBACK       fnProbe;
+        const char*         strApi;
+    };
+
+    const UINT MAX_PROBE_APIS = 3;
+
+    struct DXGIProbeTask
+    {
+        DXGIDeviceProbe*    pProbe;                     // Null once the results are in
+        const PROBEAPI*     pApis;                      // In the order they're probed
+        UINT                numApis;
+        std::atomic<UINT>   numDone;                    // APIs whose results are in
+        DXGIDeviceProbe     results[MAX_PROBE_APIS];    // What each API's probe fills in, in place of pProbe
+        WATCHDOGTASK        watch;
+    };
+
+    // Hardware adapters first, followed by one entry each for WARP and REF
+    DXGIDeviceProbe* g_deviceProbes = nullptr;
+    UINT g_numAdapterProbes = 0;
+
+    DXGIProbeTask* g_probeTasks = nullptr;
+    UINT g_numProbeTasks = 0;
+    BOOL g_bProbeTasksAbandoned = FALSE;    // A work item may still be using g_probeTasks
+
+    UINT g_dxgiShard = DXGISHARD_ALL;       // What DXGI_BeginProbe probes, see DXGI_SetShard
+
+#ifdef EXTRA_DEBUG
+    // A work item's debug output, printed in one piece once it's done so it
+    // doesn't interleave with that of the adapters probed alongside it
+    thread_local std::string t_probeLog;
+
+    //-----------------------------------------------------------------------------
+    void ProbeLog(const char* str)
+    {
+        t_probeLog += str;
+    }
+#endif
+
+    //-----------------------------------------------------------------------------
+    void ProbeAdapterD3D12(DXGIDeviceProbe& probe)
+    {
+#ifdef EXTRA_DEBUG
+        ProbeLog("Direct3D 12\n");
+#endif
+        if (!probe.pAdapter3 || !g_D3D12CreateDevice)
+            return;
+
+        HRESULT hr = PROBE_CALL("D3D12CreateDevice", probe.strName,
+            g_D3D12CreateDevice(probe.pAdapter3, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&probe.pDevice12)));
+        if (SUCCEEDED(hr))
+        {
+#ifdef EXTRA_DEBUG
+            D3D_FEATURE_LEVEL fl = GetD3D12FeatureLevel(probe.pDevice12);
+            ProbeLog(FLName(fl));
+#endif
+        }
+        else
+        {
+#ifdef EXTRA_DEBUG
+            char buff[64] = {};
+            sprintf_s(buff, ": Failed (%08X)\n", hr);
+            ProbeLog(buff);
+#endif
+            probe.pDevice12 = nullptr;
         }
     }
 
-    void D3D11_FillTree1(HTREEITEM hTree, ID3D11Device1* pDevice, DWORD flMask, D3D_DRIVER_TYPE devType)
+    //-----------------------------------------------------------------------------
+    void ProbeAdapterD3D11(DXGIDeviceProbe& probe)
     {
-        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
-        if (fl > D3D_FEATURE_LEVEL_11_1)
-            fl = D3D_FEATURE_LEVEL_11_1;
+#ifdef EXTRA_DEBUG
+        ProbeLog("Direct3D 11.x\n");
+#endif
+        if (!probe.pAdapter1 || !g_D3D11CreateDevice)
+            return;
 
-        HTREEITEM hTreeD3D = TVAddNodeEx(hTree, "Direct3D 11.1", TRUE,
-            IDI_CAPS, D3D11Info1, (LPARAM)pDevice, 0, 0);
+        HRESULT hr;
+        ID3D11Device* pDevice11 = nullptr;
+        D3D_FEATURE_LEVEL flHigh = (D3D_FEATURE_LEVEL)0;
 
-        TVAddNodeEx(hTreeD3D, FLName(fl), FALSE, IDI_CAPS, D3D_FeatureLevel,
-            (LPARAM)fl, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
+        for (UINT i = 1 /* Skip 12.2 for DX11 */; i < std::size(g_featureLevels); ++i)
+        {
+#ifdef EXTRA_DEBUG
+            ProbeLog(FLName(g_featureLevels[i]));
+#endif
+            hr = PROBE_CALL("D3D11CreateDevice", probe.strName,
+                g_D3D11CreateDevice(probe.pAdapter1, D3D_DRIVER_TYPE_UNKNOWN, nullptr, 0,
+                    &g_featureLevels[i], 1,
+                    D3D11_SDK_VERSION, &pDevice11, nullptr, nullptr));
+            if (SUCCEEDED(hr))
+            {
+#ifdef EXTRA_DEBUG
+                ProbeLog(": Success\n");
+#endif
+                switch (g_featureLevels[i])
+                {
+                case D3D_FEATURE_LEVEL_9_1:  probe.flMaskDX11 |= FLMASK_9_1; break;
+                case D3D_FEATURE_LEVEL_9_2:  probe.flMaskDX11 |= FLMASK_9_2; break;
+                case D3D_FEATURE_LEVEL_9_3:  probe.flMaskDX11 |= FLMASK_9_3; break;
+                case D3D_FEATURE_LEVEL_10_0: probe.flMaskDX11 |= FLMASK_10_0; break;
+                case D3D_FEATURE_LEVEL_10_1: probe.flMaskDX11 |= FLMASK_10_1; break;
+                case D3D_FEATURE_LEVEL_11_0: probe.flMaskDX11 |= FLMASK_11_0; break;
+                case D3D_FEATURE_LEVEL_11_1: probe.flMaskDX11 |= FLMASK_11_1; break;
+                case D3D_FEATURE_LEVEL_12_0: probe.flMaskDX11 |= FLMASK_12_0; break;
+                case D3D_FEATURE_LEVEL_12_1: probe.flMaskDX11 |= FLMASK_12_1; break;
+                default: break;
+                }
 
-        if (fl != D3D_FEATURE_LEVEL_9_1)
+                if (g_featureLevels[i] > flHigh)
+                    flHigh = g_featureLevels[i];
+            }
+            else
+            {
+#ifdef EXTRA_DEBUG
+                char buff[64] = {};
+                sprintf_s(buff, ": Failed (%08X)\n", hr);
+                ProbeLog(buff);
+#endif
+                pDevice11 = nullptr;
+            }
+
+            if (pDevice11)
+            {
+                // Some Intel Integrated Graphics WDDM 1.0 drivers will crash if you try to release here,
+                // so those are kept until the adapter's other devices are released
+                if (probe.aDesc.VendorId != 0x8086)
+                    pDevice11->Release();
+                else
+                    probe.pKeptDevices11[probe.numKeptDevices11++] = pDevice11;
+
+                pDevice11 = nullptr;
+            }
+        }
+
+        if (flHigh > 0)
         {
-            HTREEITEM hTreeF = TVAddNode(hTreeD3D, "Additional Feature Levels", TRUE, IDI_CAPS, nullptr, 0, 0);
+            hr = PROBE_CALL("D3D11CreateDevice", probe.strName,
+                g_D3D11CreateDevice(probe.pAdapter1, D3D_DRIVER_TYPE_UNKNOWN, nullptr, 0, &flHigh, 1,
+                    D3D11_SDK_VERSION, &probe.pDevice11, nullptr, nullptr));
 
-            switch (fl)
+            if (SUCCEEDED(hr))
             {
-            case D3D_FEATURE_LEVEL_11_1:
-                if (flMask & FLMASK_11_0)
+                hr = probe.pDevice11->QueryInterface(IID_PPV_ARGS(&probe.pDevice11_1));
+                if (FAILED(hr))
+                    probe.pDevice11_1 = nullptr;
+
+                hr = probe.pDevice11->QueryInterface(IID_PPV_ARGS(&probe.pDevice11_2));
+                if (FAILED(hr))
+                    probe.pDevice11_2 = nullptr;
+
+                hr = probe.pDevice11->QueryInterface(IID_PPV_ARGS(&probe.pDevice11_3));
+                if (FAILED(hr))
+                    probe.pDevice11_3 = nullptr;
+
+                hr = probe.pDevice11->QueryInterface(IID_PPV_ARGS(&probe.pDevice11_4));
+                if (FAILED(hr))
+                    probe.pDevice11_4 = nullptr;
+            }
+            else
+                probe.pDevice11 = nullptr;
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    void ProbeAdapterD3D10(DXGIDeviceProbe& probe)
+    {
+#ifdef EXTRA_DEBUG
+        ProbeLog("Direct3D 10.x\n");
+#endif
+        HRESULT hr;
+        if (g_D3D10CreateDevice1)
+        {
+            // Since 10 & 10.1 are so close, try to create just one device object for both...
+            static const D3D10_FEATURE_LEVEL1 lvl[] =
+            {
+                D3D10_FEATURE_LEVEL_10_1, D3D10_FEATURE_LEVEL_10_0,
+                D3D10_FEATURE_LEVEL_9_3, D3D10_FEATURE_LEVEL_9_2, D3D10_FEATURE_LEVEL_9_1
+            };
+
+            // Test every feature-level since some devices might be missing some
+            ID3D10Device1* pDevice10_1 = nullptr;
+            D3D10_FEATURE_LEVEL1 flHigh = (D3D10_FEATURE_LEVEL1)0;
+            for (UINT i = 0; i < std::size(lvl); ++i)
+            {
+                if (g_DXGIFactory1 == 0)
                 {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_11_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_11_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
+                    // Skip 10level9 if using DXGI 1.0
+                    if (lvl[i] == D3D10_FEATURE_LEVEL_9_1
+                        || lvl[i] == D3D10_FEATURE_LEVEL_9_2
+                        || lvl[i] == D3D10_FEATURE_LEVEL_9_3)
+                        continue;
                 }
-                // Fall thru
 
-            case D3D_FEATURE_LEVEL_11_0:
-                if (flMask & FLMASK_10_1)
+#ifdef EXTRA_DEBUG
+                ProbeLog(FLName(lvl[i]));
+#endif
+
+                hr = PROBE_CALL("D3D10CreateDevice1", probe.strName,
+                    g_D3D10CreateDevice1(probe.pAdapter, D3D10_DRIVER_TYPE_HARDWARE, nullptr, 0, lvl[i], D3D10_1_SDK_VERSION, &pDevice10_1));
+                if (SUCCEEDED(hr))
                 {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_10_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
-                }
-                // Fall thru
+#ifdef EXTRA_DEBUG
+                    ProbeLog(": Success\n");
+#endif
 
-            case D3D_FEATURE_LEVEL_10_1:
-                if (flMask & FLMASK_10_0)
+                    switch (lvl[i])
+                    {
+                    case D3D10_FEATURE_LEVEL_9_1:  probe.flMaskDX10 |= FLMASK_9_1; break;
+                    case D3D10_FEATURE_LEVEL_9_2:  probe.flMaskDX10 |= FLMASK_9_2; break;
+                    case D3D10_FEATURE_LEVEL_9_3:  probe.flMaskDX10 |= FLMASK_9_3; break;
+                    case D3D10_FEATURE_LEVEL_10_0: probe.flMaskDX10 |= FLMASK_10_0; break;
+                    case D3D10_FEATURE_LEVEL_10_1: probe.flMaskDX10 |= FLMASK_10_1; break;
+                    }
+
+                    if (lvl[i] > flHigh)
+                        flHigh = lvl[i];
+                }
+                else
                 {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_10_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
+#ifdef EXTRA_DEBUG
+                    char buff[64] = {};
+                    sprintf_s(buff, ": Failed (%08X)\n", hr);
+                    ProbeLog(buff);
+#endif
+                    pDevice10_1 = nullptr;
                 }
-                // Fall thru
 
-            case D3D_FEATURE_LEVEL_10_0:
-                if (flMask & FLMASK_9_3)
+                if (pDevice10_1)
                 {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_3", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_3, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
+                    pDevice10_1->Release();
+                    pDevice10_1 = nullptr;
                 }
-                // Fall thru
+            }
 
-            case D3D_FEATURE_LEVEL_9_3:
-                if (flMask & FLMASK_9_2)
+            if (flHigh > 0)
+            {
+                hr = PROBE_CALL("D3D10CreateDevice1", probe.strName,
+                    g_D3D10CreateDevice1(probe.pAdapter, D3D10_DRIVER_TYPE_HARDWARE, nullptr, 0, flHigh, D3D10_1_SDK_VERSION, &probe.pDevice10_1));
+                if (SUCCEEDED(hr))
                 {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_2", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_2, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
+                    if (flHigh >= D3D10_FEATURE_LEVEL_10_0)
+                    {
+                        hr = probe.pDevice10_1->QueryInterface(IID_PPV_ARGS(&probe.pDevice10));
+                        if (FAILED(hr))
+                            probe.pDevice10 = nullptr;
+                    }
                 }
-                // Fall thru
-
-            case D3D_FEATURE_LEVEL_9_2:
-                if (flMask & FLMASK_9_1)
+                else
                 {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_1(devType));
+                    probe.pDevice10_1 = nullptr;
                 }
-                break;
             }
         }
-
-        if (fl >= D3D_FEATURE_LEVEL_10_0)
+        else if (g_D3D10CreateDevice)
         {
-            TVAddNodeEx(hTreeD3D, "IA Vertex Buffer", FALSE, IDI_CAPS, D3D11Info1,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_IA_VERTEX_BUFFER, 0);
+            hr = PROBE_CALL("D3D10CreateDevice", probe.strName,
+                g_D3D10CreateDevice(probe.pAdapter, D3D10_DRIVER_TYPE_HARDWARE, nullptr, 0, D3D10_SDK_VERSION, &probe.pDevice10));
+            if (FAILED(hr))
+                probe.pDevice10 = nullptr;
+        }
+    }
 
-            TVAddNodeEx(hTreeD3D, "Shader sample (any filter)", FALSE, IDI_CAPS, D3D11Info1,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_SHADER_SAMPLE, 0);
+    //-----------------------------------------------------------------------------
+    void ProbeWARP10(DXGIDeviceProbe& probe)
+    {
+        // WARP supported both 10 and 10.1 when first released
+        probe.flMaskDX10 = FLMASK_9_1 | FLMASK_9_2 | FLMASK_9_3 | FLMASK_10_0 | FLMASK_10_1;
 
-            if (fl >= D3D_FEATURE_LEVEL_11_0)
-            {
-                TVAddNodeEx(hTreeD3D, "Shader gather4", FALSE, IDI_CAPS, D3D11Info1,
-                    (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_SHADER_GATHER, 0);
-            }
+        if (!g_D3D10CreateDevice1)
+            return;
 
-            TVAddNodeEx(hTreeD3D, "Mipmap Auto-Generation", FALSE, IDI_CAPS, D3D11Info1,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MIP_AUTOGEN, 0);
+#ifdef EXTRA_DEBUG
+        ProbeLog("WARP10\n");
+#endif
 
-            TVAddNodeEx(hTreeD3D, "Render Target", FALSE, IDI_CAPS, D3D11Info1,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_RENDER_TARGET, 0);
+        HRESULT hr = PROBE_CALL("D3D10CreateDevice1", probe.strName,
+            g_D3D10CreateDevice1(nullptr, D3D10_DRIVER_TYPE_WARP, nullptr, 0, D3D10_FEATURE_LEVEL_10_1,
+                D3D10_1_SDK_VERSION, &probe.pDevice10_1));
+        if (FAILED(hr))
+            probe.pDevice10_1 = nullptr;
+    }
 
-            TVAddNodeEx(hTreeD3D, "Blendable Render Target", FALSE, IDI_CAPS, D3D11Info1,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_BLENDABLE, 0);
+    //-----------------------------------------------------------------------------
+    void ProbeWARP11(DXGIDeviceProbe& probe)
+    {
+        probe.flMaskDX11 = FLMASK_9_1 | FLMASK_9_2 | FLMASK_9_3 | FLMASK_10_0 | FLMASK_10_1;
 
-            if (fl < D3D_FEATURE_LEVEL_11_1)
+        if (!g_D3D11CreateDevice)
+            return;
+
+#ifdef EXTRA_DEBUG
+        ProbeLog("WARP11\n");
+#endif
+        D3D_FEATURE_LEVEL fl;
+        // Skip 12.2
+        HRESULT hr = PROBE_CALL("D3D11CreateDevice", probe.strName,
+            g_D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0,
+                &g_featureLevels[1], static_cast<UINT>(std::size(g_featureLevels) - 1),
+                D3D11_SDK_VERSION, &probe.pDevice11, &fl, nullptr));
+        if (FAILED(hr))
+        {
+            // Try without 12.x
+            hr = PROBE_CALL("D3D11CreateDevice", probe.strName,
+                g_D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0,
+                    &g_featureLevels[3], static_cast<UINT>(std::size(g_featureLevels) - 3),
+                    D3D11_SDK_VERSION, &probe.pDevice11, &fl, nullptr));
+
+            if (FAILED(hr))
             {
-                // This is required for 11.1, but is optional for 10.x and 11.0
-                TVAddNodeEx(hTreeD3D, "OM Logic Ops", FALSE, IDI_CAPS, D3D11Info1,
-                    (LPARAM)pDevice, (LPARAM)-1, (LPARAM)D3D11_FORMAT_SUPPORT2_OUTPUT_MERGER_LOGIC_OP);
+                hr = PROBE_CALL("D3D11CreateDevice", probe.strName,
+                    g_D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0, nullptr, 0,
+                        D3D11_SDK_VERSION, &probe.pDevice11, &fl, nullptr));
             }
+        }
+        if (FAILED(hr))
+            probe.pDevice11 = nullptr;
+        else
+        {
+#ifdef EXTRA_DEBUG
+            ProbeLog(FLName(fl));
+#endif
+            if (fl >= D3D_FEATURE_LEVEL_12_1)
+                probe.flMaskDX11 |= FLMASK_12_1;
+
+            if (fl >= D3D_FEATURE_LEVEL_12_0)
+                probe.flMaskDX11 |= FLMASK_12_0;
+
+            if (fl >= D3D_FEATURE_LEVEL_11_1)
+                probe.flMaskDX11 |= FLMASK_11_1;
 
             if (fl >= D3D_FEATURE_LEVEL_11_0)
-            {
-                TVAddNodeEx(hTreeD3D, "Typed UAV (most required)", FALSE, IDI_CAPS, D3D11Info1,
-                    (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_TYPED_UNORDERED_ACCESS_VIEW, 0);
+                probe.flMaskDX11 |= FLMASK_11_0;
 
-                TVAddNodeEx(hTreeD3D, "UAV Typed Store (most required)", FALSE, IDI_CAPS, D3D11Info1,
-                    (LPARAM)pDevice, (LPARAM)-1, (LPARAM)D3D11_FORMAT_SUPPORT2_UAV_TYPED_STORE);
-            }
+            hr = probe.pDevice11->QueryInterface(IID_PPV_ARGS(&probe.pDevice11_1));
+            if (FAILED(hr))
+                probe.pDevice11_1 = nullptr;
 
-            // MSAA (MSAA data for 10level9 is shown under the 10.1 node)
-            FillMSAASampleTable(pDevice, g_sampCount11_1);
+            hr = probe.pDevice11->QueryInterface(IID_PPV_ARGS(&probe.pDevice11_2));
+            if (FAILED(hr))
+                probe.pDevice11_2 = nullptr;
 
-            TVAddNodeEx(hTreeD3D, "2x MSAA", FALSE, IDI_CAPS, D3D11Info1,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 2);
+            hr = probe.pDevice11->QueryInterface(IID_PPV_ARGS(&probe.pDevice11_3));
+            if (FAILED(hr))
+                probe.pDevice11_3 = nullptr;
 
-            TVAddNodeEx(hTreeD3D, "4x MSAA (all required)", FALSE, IDI_CAPS, D3D11Info1,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 4);
+            hr = probe.pDevice11->QueryInterface(IID_PPV_ARGS(&probe.pDevice11_4));
+            if (FAILED(hr))
+                probe.pDevice11_4 = nullptr;
+        }
+    }
 
-            TVAddNodeEx(hTreeD3D, "8x MSAA (most required)", FALSE, IDI_CAPS, D3D11Info1,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_RENDERTARGET, 8);
+    //-----------------------------------------------------------------------------
+    void ProbeWARP12(DXGIDeviceProbe& probe)
+    {
+        if (!g_D3D12CreateDevice || !g_DXGIFactory4)
+            return;
 
-            TVAddNodeEx(hTreeD3D, "Other MSAA", FALSE, IDI_CAPS, D3D11InfoMSAA,
-                (LPARAM)pDevice, (LPARAM)g_sampCount11_1, 1);
+#ifdef EXTRA_DEBUG
+        ProbeLog("WARP12\n");
+#endif
+        IDXGIAdapter* warpAdapter = nullptr;
+        HRESULT hr = PROBE_CALL("IDXGIFactory4::EnumWarpAdapter", probe.strName,
+            g_DXGIFactory4->EnumWarpAdapter(IID_PPV_ARGS(&warpAdapter)));
+        if (SUCCEEDED(hr))
+        {
+            hr = PROBE_CALL("D3D12CreateDevice", probe.strName,
+                g_D3D12CreateDevice(warpAdapter, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&probe.pDevice12)));
+            if (SUCCEEDED(hr))
+            {
+#ifdef EXTRA_DEBUG
+                D3D_FEATURE_LEVEL fl = GetD3D12FeatureLevel(probe.pDevice12);
+                ProbeLog(FLName(fl));
+#endif
+            }
+            else
+            {
+#ifdef EXTRA_DEBUG
+                char buff[64] = {};
+                sprintf_s(buff, ": Failed (%08X)\n", hr);
+                ProbeLog(buff);
+#endif
+                probe.pDevice12 = nullptr;
+            }
 
-            TVAddNodeEx(hTreeD3D, "MSAA Load", FALSE, IDI_CAPS, D3D11Info1,
-                (LPARAM)pDevice, (LPARAM)D3D11_FORMAT_SUPPORT_MULTISAMPLE_LOAD, 0);
+            warpAdapter->Release();
+        }
+#ifdef EXTRA_DEBUG
+        else
+        {
+            ProbeLog("WARP12 adapter not found!\n");
         }
+#endif
+    }
 
-        if (devType != D3D_DRIVER_TYPE_REFERENCE)
+    //-----------------------------------------------------------------------------
+    void ProbeREF10(DXGIDeviceProbe& probe)
+    {
+        probe.flMaskDX10 = FLMASK_10_0 | FLMASK_10_1;
+
+        HRESULT hr;
+        if (g_D3D10CreateDevice1)
         {
-            TVAddNodeEx(hTreeD3D, "Video", FALSE, IDI_CAPS, D3D11InfoVideo, (LPARAM)pDevice, 0, 0);
+            hr = PROBE_CALL("D3D10CreateDevice1", probe.strName,
+                g_D3D10CreateDevice1(nullptr, D3D10_DRIVER_TYPE_REFERENCE, nullptr, 0, D3D10_FEATURE_LEVEL_10_1,
+                    D3D10_1_SDK_VERSION, &probe.pDevice10_1));
+            if (SUCCEEDED(hr))
+            {
+                hr = probe.pDevice10_1->QueryInterface(IID_PPV_ARGS(&probe.pDevice10));
+                if (FAILED(hr))
+                    probe.pDevice10 = nullptr;
+            }
+            else
+                probe.pDevice10_1 = nullptr;
+        }
+        else if (g_D3D10CreateDevice != nullptr)
+        {
+            hr = PROBE_CALL("D3D10CreateDevice", probe.strName,
+                g_D3D10CreateDevice(nullptr, D3D10_DRIVER_TYPE_REFERENCE, nullptr, 0, D3D10_SDK_VERSION, &probe.pDevice10));
+            if (FAILED(hr))
+                probe.pDevice10 = nullptr;
         }
     }
 
-    void D3D11_FillTree2(HTREEITEM hTree, ID3D11Device2* pDevice, DWORD flMask, D3D_DRIVER_TYPE devType)
+    //-----------------------------------------------------------------------------
+    void ProbeREF11(DXGIDeviceProbe& probe)
     {
-        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
-        if (fl > D3D_FEATURE_LEVEL_11_1)
-            fl = D3D_FEATURE_LEVEL_11_1;
+        probe.flMaskDX11 = FLMASK_9_1 | FLMASK_9_2 | FLMASK_9_3 | FLMASK_10_0 | FLMASK_10_1 | FLMASK_11_0;
 
-        HTREEITEM hTreeD3D = TVAddNodeEx(hTree, "Direct3D 11.2", TRUE,
-            IDI_CAPS, D3D11Info2, (LPARAM)pDevice, 0, 0);
+        if (!g_D3D11CreateDevice)
+            return;
 
-        TVAddNodeEx(hTreeD3D, FLName(fl), FALSE, IDI_CAPS, D3D_FeatureLevel,
-            (LPARAM)fl, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
+        D3D_FEATURE_LEVEL lvl = D3D_FEATURE_LEVEL_11_1;
+        HRESULT hr = PROBE_CALL("D3D11CreateDevice", probe.strName,
+            g_D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_REFERENCE, nullptr, 0, &lvl, 1,
+                D3D11_SDK_VERSION, &probe.pDevice11, nullptr, nullptr));
 
-        if (fl != D3D_FEATURE_LEVEL_9_1)
+        if (SUCCEEDED(hr))
         {
-            HTREEITEM hTreeF = TVAddNode(hTreeD3D, "Additional Feature Levels", TRUE, IDI_CAPS, nullptr, 0, 0);
+            probe.flMaskDX11 |= FLMASK_11_1;
+            hr = probe.pDevice11->QueryInterface(IID_PPV_ARGS(&probe.pDevice11_1));
+            if (FAILED(hr))
+                probe.pDevice11_1 = nullptr;
 
-            switch (fl)
+            hr = probe.pDevice11->QueryInterface(IID_PPV_ARGS(&probe.pDevice11_2));
+            if (FAILED(hr))
+                probe.pDevice11_2 = nullptr;
+
+            hr = probe.pDevice11->QueryInterface(IID_PPV_ARGS(&probe.pDevice11_3));
+            if (FAILED(hr))
+                probe.pDevice11_3 = nullptr;
+
+            hr = probe.pDevice11->QueryInterface(IID_PPV_ARGS(&probe.pDevice11_4));
+            if (FAILED(hr))
+                probe.pDevice11_4 = nullptr;
+        }
+        else
+        {
+            hr = PROBE_CALL("D3D11CreateDevice", probe.strName,
+                g_D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_REFERENCE, nullptr, 0, nullptr, 0,
+                    D3D11_SDK_VERSION, &probe.pDevice11, nullptr, nullptr));
+            if (SUCCEEDED(hr))
             {
-            case D3D_FEATURE_LEVEL_11_1:
-                if (flMask & FLMASK_11_0)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_11_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_11_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
-                }
-                // Fall thru
+                hr = probe.pDevice11->QueryInterface(IID_PPV_ARGS(&probe.pDevice11_1));
+                if (FAILED(hr))
+                    probe.pDevice11_1 = nullptr;
+            }
+            else
+                probe.pDevice11 = nullptr;
+        }
+    }
 
-            case D3D_FEATURE_LEVEL_11_0:
-                if (flMask & FLMASK_10_1)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_10_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
-                }
-                // Fall thru
+    // The APIs of each adapter, in the order its devices are created
+    const PROBEAPI c_adapterApis[] =
+    {
+        { ProbeAdapterD3D12, "Direct3D 12" },
+        { ProbeAdapterD3D11, "Direct3D 11" },
+        { ProbeAdapterD3D10, "Direct3D 10" },
+    };
+
+    const PROBEAPI c_warpApis[] =
+    {
+        { ProbeWARP12, "Direct3D 12" },
+        { ProbeWARP11, "Direct3D 11" },
+        { ProbeWARP10, "Direct3D 10" },
+    };
+
+    // No REF for Direct3D 12
+    const PROBEAPI c_refApis[] =
+    {
+        { ProbeREF11, "Direct3D 11" },
+        { ProbeREF10, "Direct3D 10" },
+    };
+
+    //-----------------------------------------------------------------------------
+    void DXGIProbeProc(VOID* pContext)
+    {
+        auto pTask = static_cast<DXGIProbeTask*>(pContext);
+
+#ifdef EXTRA_DEBUG
+        t_probeLog = pTask->results[0].strName;
+        t_probeLog += ":\n";
+#endif
+
+        for (UINT iApi = 0; iApi < pTask->numApis; ++iApi)
+        {
+            pTask->pApis[iApi].fnProbe(pTask->results[iApi]);
+            pTask->numDone.store(iApi + 1, std::memory_order_release);
+        }
+
+#ifdef EXTRA_DEBUG
+        OutputDebugStringA(t_probeLog.c_str());
+        t_probeLog.clear();
+#endif
+
+        // Taken by AddProbeTask, so an abandoned probe keeps its adapter
+        DXGIDeviceProbe& result = pTask->results[0];
+        SAFE_RELEASE(result.pAdapter);
+        SAFE_RELEASE(result.pAdapter1);
+        SAFE_RELEASE(result.pAdapter2);
+        SAFE_RELEASE(result.pAdapter3);
+    }
+
+    //-----------------------------------------------------------------------------
+    template <size_t N>
+    void AddProbeTask(DXGIDeviceProbe& probe, const PROBEAPI (&apis)[N])
+    {
+        static_assert(N <= MAX_PROBE_APIS, "Too many APIs for a probe task");
+
+        if (!probe.deadline)
+            probe.deadline = WatchdogAdapterDeadline();
+
+        DXGIProbeTask& task = g_probeTasks[g_numProbeTasks++];
+        task.pProbe = &probe;
+        task.pApis = apis;
+        task.numApis = static_cast<UINT>(N);
+        for (UINT iApi = 0; iApi < task.numApis; ++iApi)
+            task.results[iApi] = probe;
+
+        // pAdapter is pAdapter1 when there is one, so each pointer gets its own
+        // reference. The results share them.
+        DXGIDeviceProbe& result = task.results[0];
+        if (result.pAdapter)
+            result.pAdapter->AddRef();
+        if (result.pAdapter1)
+            result.pAdapter1->AddRef();
+        if (result.pAdapter2)
+            result.pAdapter2->AddRef();
+        if (result.pAdapter3)
+            result.pAdapter3->AddRef();
+
+        task.watch.Start(DXGIProbeProc, &task);
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: MergeProbeResult()
+    // Desc: Moves the devices a work item created into its adapter's probe.
+    //       Each API's probe fills in fields of its own, so none collide.
+    //-----------------------------------------------------------------------------
+    void MergeProbeResult(DXGIDeviceProbe& probe, const DXGIDeviceProbe& result)
+    {
+        if (result.pDevice12)
+            probe.pDevice12 = result.pDevice12;
+
+        if (result.pDevice11)
+            probe.pDevice11 = result.pDevice11;
+        if (result.pDevice11_1)
+            probe.pDevice11_1 = result.pDevice11_1;
+        if (result.pDevice11_2)
+            probe.pDevice11_2 = result.pDevice11_2;
+        if (result.pDevice11_3)
+            probe.pDevice11_3 = result.pDevice11_3;
+        if (result.pDevice11_4)
+            probe.pDevice11_4 = result.pDevice11_4;
+        probe.flMaskDX11 |= result.flMaskDX11;
+
+        for (UINT i = 0; i < result.numKeptDevices11; ++i)
+            probe.pKeptDevices11[probe.numKeptDevices11++] = result.pKeptDevices11[i];
+
+        if (result.pDevice10)
+            probe.pDevice10 = result.pDevice10;
+        if (result.pDevice10_1)
+            probe.pDevice10_1 = result.pDevice10_1;
+        probe.flMaskDX10 |= result.flMaskDX10;
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: WaitForDeviceProbes()
+    // Desc: Collects each work item's devices. If the watchdog gave up on one,
+    //       the APIs it had finished are kept and the rest noted as timed out.
+    //-----------------------------------------------------------------------------
+    void WaitForDeviceProbes()
+    {
+        for (UINT i = 0; i < g_numProbeTasks; ++i)
+        {
+            DXGIProbeTask& task = g_probeTasks[i];
+            if (!task.pProbe)
+                continue;
 
-            case D3D_FEATURE_LEVEL_10_1:
-                if (flMask & FLMASK_10_0)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_10_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
-                }
-                // Fall thru
+            DXGIDeviceProbe& probe = *task.pProbe;
+            task.pProbe = nullptr;
 
-            case D3D_FEATURE_LEVEL_10_0:
-                if (flMask & FLMASK_9_3)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_3", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_3, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
-                }
-                // Fall thru
+            BOOL bFinished = task.watch.Wait(probe.deadline);
 
-            case D3D_FEATURE_LEVEL_9_3:
-                if (flMask & FLMASK_9_2)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_2", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_2, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
-                }
-                // Fall thru
+            // Those past numDone are still being written by the work item
+            UINT numDone = bFinished ? task.numApis : task.numDone.load(std::memory_order_acquire);
+            for (UINT iApi = 0; iApi < numDone; ++iApi)
+                MergeProbeResult(probe, task.results[iApi]);
 
-            case D3D_FEATURE_LEVEL_9_2:
-                if (flMask & FLMASK_9_1)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_2(devType));
-                }
-                break;
+            if (!bFinished)
+            {
+                for (UINT iApi = numDone; iApi < task.numApis; ++iApi)
+                    probe.strTimedOut[probe.numTimedOut++] = task.pApis[iApi].strApi;
+                g_bProbeTasksAbandoned = TRUE;
             }
         }
+    }
 
-        // The majority of this data is already shown under the DirectX 11.1 node, so we only show the 'new' info
-
-        TVAddNodeEx(hTreeD3D, "Shareable", FALSE, IDI_CAPS, D3D11Info2,
-            (LPARAM)pDevice, (LPARAM)-1, (LPARAM)D3D11_FORMAT_SUPPORT2_SHAREABLE);
+    //-----------------------------------------------------------------------------
+    void FreeDeviceProbes()
+    {
+        WaitForDeviceProbes();
+
+        // The adapters and devices themselves are owned by the object registry.
+        // An abandoned work item still points into the tasks, so they're leaked.
+        if (!g_bProbeTasksAbandoned)
+            delete[] g_probeTasks;
+        g_probeTasks = nullptr;
+        g_numProbeTasks = 0;
+        g_bProbeTasksAbandoned = FALSE;
+
+        delete[] g_deviceProbes;
+        g_deviceProbes = nullptr;
+        g_numAdapterProbes = 0;
     }
 
-    void D3D11_FillTree3(HTREEITEM hTree, ID3D11Device3* pDevice, ID3D11Device4* pDevice4, DWORD flMask, D3D_DRIVER_TYPE devType)
+    //-----------------------------------------------------------------------------
+    // Name: InitAdapterProbe()
+    // Desc: Gets the interfaces of an adapter ready to probe. Returns FALSE for
+    //       an adapter that isn't shown.
+    //-----------------------------------------------------------------------------
+    BOOL InitAdapterProbe(UINT iAdapter, DXGIDeviceProbe& probe)
     {
-        D3D_FEATURE_LEVEL fl = pDevice->GetFeatureLevel();
+        probe.iAdapter = iAdapter;
 
-        HTREEITEM hTreeD3D = TVAddNodeEx(hTree, (pDevice4) ? "Direct3D 11.3/11.4" : "Direct3D 11.3", TRUE,
-            IDI_CAPS, D3D11Info3, (LPARAM)pDevice, 0, (LPARAM)pDevice4);
+        HRESULT hr;
 
-        TVAddNodeEx(hTreeD3D, FLName(fl), FALSE, IDI_CAPS, D3D_FeatureLevel,
-            (LPARAM)fl, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
+        if (g_DXGIFactory1)
+        {
+            hr = PROBE_CALL("IDXGIFactory1::EnumAdapters1", nullptr,
+                g_DXGIFactory1->EnumAdapters1(iAdapter, &probe.pAdapter1));
+            probe.pAdapter = probe.pAdapter1;
 
-        if (fl != D3D_FEATURE_LEVEL_9_1)
+            if (SUCCEEDED(hr))
+            {
+                HRESULT hr2 = probe.pAdapter1->QueryInterface(IID_PPV_ARGS(&probe.pAdapter2));
+                if (FAILED(hr2))
+                    probe.pAdapter2 = nullptr;
+
+                hr2 = probe.pAdapter1->QueryInterface(IID_PPV_ARGS(&probe.pAdapter3));
+                if (FAILED(hr2))
+                    probe.pAdapter3 = nullptr;
+            }
+        }
+        else
         {
-            HTREEITEM hTreeF = TVAddNode(hTreeD3D, "Additional Feature Levels", TRUE, IDI_CAPS, nullptr, 0, 0);
+            hr = PROBE_CALL("IDXGIFactory::EnumAdapters", nullptr,
+                g_DXGIFactory->EnumAdapters(iAdapter, &probe.pAdapter));
+        }
 
-            switch (fl)
+        if (FAILED(hr))
+        {
+            probe = {};
+            return FALSE;
+        }
+
+        if (probe.pAdapter2)
+        {
+            DXGI_ADAPTER_DESC2 aDesc2;
+            probe.pAdapter2->GetDesc2(&aDesc2);
+
+            if (aDesc2.Flags & DXGI_ADAPTER_FLAG_SOFTWARE)
             {
-            case D3D_FEATURE_LEVEL_12_2:
-                if (flMask & FLMASK_12_1)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_12_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_12_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
-                }
-                // Fall thru
+                // Skip "always there" Microsoft Basics Display Driver
+                SAFE_RELEASE(probe.pAdapter3);
+                SAFE_RELEASE(probe.pAdapter2);
+                SAFE_RELEASE(probe.pAdapter1);
+                probe = {};
+                return FALSE;
+            }
+        }
 
-            case D3D_FEATURE_LEVEL_12_1:
-                if (flMask & FLMASK_12_0)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_12_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_12_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
-                }
-                // Fall thru
+        hr = probe.pAdapter->GetDesc(&probe.aDesc);
+        if (FAILED(hr))
+        {
+            probe = {};
+            return FALSE;
+        }
 
-            case D3D_FEATURE_LEVEL_12_0:
-                if (flMask & FLMASK_11_1)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_11_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_11_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
-                }
-                // Fall thru
+        wcstombs_s(nullptr, probe.strName, probe.aDesc.Description, 128);
 
-            case D3D_FEATURE_LEVEL_11_1:
-                if (flMask & FLMASK_11_0)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_11_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_11_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
-                }
-                // Fall thru
+        return TRUE;
+    }
 
-            case D3D_FEATURE_LEVEL_11_0:
-                if (flMask & FLMASK_10_1)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_10_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
-                }
-                // Fall thru
+    //-----------------------------------------------------------------------------
+    // Object registry
+    //
+    // Owns every adapter, output and device the probes create, and records the
+    // subtree whose nodes use each of them. Once the viewer is idle the subtrees
+    // are captured one at a time and their objects released, so a viewer left
+    // open doesn't hold on to several devices per adapter. Anything left is
+    // released at exit, and any object that outlived the registry's last
+    // reference to it is reported.
+    //-----------------------------------------------------------------------------
+    struct COMREF
+    {
+        COMREF*     pNext;
+        IUnknown*   pObject;    // The registry's reference, nullptr once released
+        IUnknown*   pIdentity;  // Not AddRef'd, only compared
+        const char* strName;    // Interface, for the leak report
+        HTREEITEM   hOwner;     // The nodes below here use the object
+        CHAR        strAdapter[128];    // What the object was created on, for probe timing
+        BOOL        bKeep;      // The nodes couldn't be captured, so release at exit
+        ULONG       cRefsLeft;  // References others still held after the last release
+    };
 
-            case D3D_FEATURE_LEVEL_10_1:
-                if (flMask & FLMASK_10_0)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_10_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_10_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
-                }
-                // Fall thru
+    COMREF* g_pComRefs = nullptr;
 
-            case D3D_FEATURE_LEVEL_10_0:
-                if (flMask & FLMASK_9_3)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_3", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_3, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
-                }
-                // Fall thru
+    //-----------------------------------------------------------------------------
+    // Name: RegisterObject()
+    // Desc: Hands the caller's reference to the registry
+    //-----------------------------------------------------------------------------
+    void RegisterObject(IUnknown* pObject, const char* strName, const char* strAdapter, HTREEITEM hOwner)
+    {
+        if (!pObject)
+            return;
 
-            case D3D_FEATURE_LEVEL_9_3:
-                if (flMask & FLMASK_9_2)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_2", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_2, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
-                }
-                // Fall thru
+        auto pRef = new (std::nothrow) COMREF();
+        if (!pRef)
+            return;
 
-            case D3D_FEATURE_LEVEL_9_2:
-                if (flMask & FLMASK_9_1)
-                {
-                    TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_9_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                        (LPARAM)D3D_FEATURE_LEVEL_9_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D11_3(devType));
-                }
-                break;
-            }
+        // Interfaces of the same object share a reference count
+        IUnknown* pIdentity = nullptr;
+        if (SUCCEEDED(pObject->QueryInterface(IID_PPV_ARGS(&pIdentity))))
+            pIdentity->Release();
+        else
+            pIdentity = pObject;
+
+        pRef->pObject = pObject;
+        pRef->pIdentity = pIdentity;
+        pRef->strName = strName;
+        pRef->hOwner = hOwner;
+        strcpy_s(pRef->strAdapter, strAdapter);
+
+        // Newest first, so devices are released before the adapters they were created on
+        pRef->pNext = g_pComRefs;
+        g_pComRefs = pRef;
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: GetObjectAdapterName()
+    // Desc: The adapter a registered object was created on, or "" if it isn't
+    //       registered. UI thread only.
+    //-----------------------------------------------------------------------------
+    const char* GetObjectAdapterName(IUnknown* pObject)
+    {
+        for (const COMREF* pRef = g_pComRefs; pRef; pRef = pRef->pNext)
+        {
+            if (pRef->pObject == pObject)
+                return pRef->strAdapter;
         }
 
-        // The majority of this data is already shown under the DirectX 11.1 or 11.2 node, so we only show the 'new' info
+        return "";
+    }
 
-        TVAddNodeEx(hTreeD3D, "UAV Typed Load", FALSE, IDI_CAPS, D3D11Info3,
-            (LPARAM)pDevice, (LPARAM)-1, (LPARAM)D3D11_FORMAT_SUPPORT2_UAV_TYPED_LOAD);
+    //-----------------------------------------------------------------------------
+    void RegisterDevices(DXGIDeviceProbe& probe, HTREEITEM hOwner)
+    {
+        for (UINT i = 0; i < probe.numKeptDevices11; ++i)
+            RegisterObject(probe.pKeptDevices11[i], "ID3D11Device", probe.strName, hOwner);
+        probe.numKeptDevices11 = 0;
+
+        RegisterObject(probe.pDevice12, "ID3D12Device", probe.strName, hOwner);
+        RegisterObject(probe.pDevice11, "ID3D11Device", probe.strName, hOwner);
+        RegisterObject(probe.pDevice11_1, "ID3D11Device1", probe.strName, hOwner);
+        RegisterObject(probe.pDevice11_2, "ID3D11Device2", probe.strName, hOwner);
+        RegisterObject(probe.pDevice11_3, "ID3D11Device3", probe.strName, hOwner);
+        RegisterObject(probe.pDevice11_4, "ID3D11Device4", probe.strName, hOwner);
+        RegisterObject(probe.pDevice10, "ID3D10Device", probe.strName, hOwner);
+        RegisterObject(probe.pDevice10_1, "ID3D10Device1", probe.strName, hOwner);
     }
 
     //-----------------------------------------------------------------------------
-    void D3D12_FillTree(HTREEITEM hTree, ID3D12Device* pDevice, D3D_DRIVER_TYPE devType)
+    void ReleaseObject(COMREF& ref)
     {
-        D3D_FEATURE_LEVEL fl = GetD3D12FeatureLevel(pDevice);
+        if (!ref.pObject)
+            return;
 
-        HTREEITEM hTreeD3D = TVAddNodeEx(hTree, "Direct3D 12", TRUE, IDI_CAPS, D3D12Info, (LPARAM)pDevice, (LPARAM)fl, 0);
+        // The format matrix may still be filling in on the thread pool
+        FreeFormatMatrix(ref.pObject);
+        FreeFeatureOptions(ref.pObject);
 
-        TVAddNodeEx(hTreeD3D, FLName(fl), FALSE, IDI_CAPS, D3D_FeatureLevel, (LPARAM)fl, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D12(devType));
+        IUnknown* pObject = ref.pObject;
+        ref.pObject = nullptr;
+        ULONG cRefs = pObject->Release();
 
-        if (fl != D3D_FEATURE_LEVEL_11_0)
+        // Only the last of the registry's references to an object should free it
+        for (const COMREF* pOther = g_pComRefs; pOther; pOther = pOther->pNext)
         {
-            HTREEITEM hTreeF = TVAddNode(hTreeD3D, "Additional Feature Levels", TRUE, IDI_CAPS, nullptr, 0, 0);
+            if (pOther->pObject && pOther->pIdentity == ref.pIdentity)
+                return;
+        }
 
-            switch (fl)
-            {
-            case D3D_FEATURE_LEVEL_12_2:
-                TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_12_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                    (LPARAM)D3D_FEATURE_LEVEL_12_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D12(devType));
-                // Fall thru
+        ref.cRefsLeft = cRefs;
+    }
 
-            case D3D_FEATURE_LEVEL_12_1:
-                TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_12_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                    (LPARAM)D3D_FEATURE_LEVEL_12_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D12(devType));
-                // Fall thru
+    //-----------------------------------------------------------------------------
+    // Name: ReleaseCapturedObjects()
+    // Desc: Has DXGI_CaptureNextSubtree run on every IDT_CAPTURE tick until the
+    //       registered objects are all released. Capturing runs every callback
+    //       under each view option, so it waits until the viewer is idle rather
+    //       than holding up the tree. A headless capture shows each node once
+    //       and exits, so there the objects are simply released at exit.
+    //-----------------------------------------------------------------------------
+    void ReleaseCapturedObjects(HWND hwndTV)
+    {
+        // The main window may still be in WM_CREATE, so g_hwndMain isn't set yet
+        if (hwndTV)
+            SetTimer(GetParent(hwndTV), IDT_CAPTURE, CAPTURE_PERIOD, nullptr);
+    }
 
-            case D3D_FEATURE_LEVEL_12_0:
-                TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_11_1", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                    (LPARAM)D3D_FEATURE_LEVEL_11_1, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D12(devType));
-                // Fall thru
+    //-----------------------------------------------------------------------------
+    // Name: FreeObjectRegistry()
+    // Desc: Releases whatever is left and reports any object that outlived the
+    //       registry's references to it
+    //-----------------------------------------------------------------------------
+    void FreeObjectRegistry()
+    {
+        for (COMREF* pRef = g_pComRefs; pRef; pRef = pRef->pNext)
+            ReleaseObject(*pRef);
 
-            case D3D_FEATURE_LEVEL_11_1:
-                TVAddNodeEx(hTreeF, "D3D_FEATURE_LEVEL_11_0", FALSE, IDI_CAPS, D3D_FeatureLevel,
-                    (LPARAM)D3D_FEATURE_LEVEL_11_0, (LPARAM)pDevice, D3D_FL_LPARAM3_D3D12(devType));
-                break;
+        while (g_pComRefs)
+        {
+            COMREF* pNext = g_pComRefs->pNext;
+            if (g_pComRefs->cRefsLeft > 0)
+            {
+                char buff[128] = {};
+                sprintf_s(buff, "DXView: %s leaked with %lu references left\n",
+                    g_pComRefs->strName, g_pComRefs->cRefsLeft);
+                OutputDebugStringA(buff);
             }
-        }
 
-        TVAddNodeEx(hTreeD3D, "Architecture", FALSE, IDI_CAPS, D3D12Architecture, (LPARAM)pDevice, 0, 0);
+            delete g_pComRefs;
+            g_pComRefs = pNext;
+        }
+    }
 
-        TVAddNodeEx(hTreeD3D, "Extended Shader Features", FALSE, IDI_CAPS, D3D12ExShaderInfo, (LPARAM)pDevice, 0, 0);
+    //-----------------------------------------------------------------------------
+    // Name: ReleaseOwnedObjects()
+    // Desc: Releases the objects a subtree uses before the subtree is deleted
+    //-----------------------------------------------------------------------------
+    void ReleaseOwnedObjects(HTREEITEM hOwner)
+    {
+        for (COMREF* pRef = g_pComRefs; pRef; pRef = pRef->pNext)
+        {
+            if (pRef->hOwner != hOwner)
+                continue;
 
-        TVAddNodeEx(hTreeD3D, "Multi-GPU", FALSE, IDI_CAPS, D3D12MultiGPU, (LPARAM)pDevice, 0, 0);
+            ReleaseObject(*pRef);
 
-        TVAddNodeEx(hTreeD3D, "Video", FALSE, IDI_CAPS, D3D12InfoVideo, (LPARAM)pDevice, 0, 1);
+            // The item may be handed out again to a node added later
+            pRef->hOwner = nullptr;
+            pRef->bKeep = FALSE;
+        }
     }
-}
 
-//-----------------------------------------------------------------------------
-// Name: DXGI_Init()
-//-----------------------------------------------------------------------------
-VOID DXGI_Init()
-{
-    // DXGI
-    g_dxgi = LoadLibraryEx("dxgi.dll", 0, LOAD_LIBRARY_SEARCH_SYSTEM32);
-    if (g_dxgi)
+    //-----------------------------------------------------------------------------
+    // Name: CreateFactory()
+    // Desc: Creates the newest DXGI factory available
+    //-----------------------------------------------------------------------------
+    void CreateFactory()
     {
         auto fpCreateDXGIFactory = reinterpret_cast<LPCREATEDXGIFACTORY>(GetProcAddress(g_dxgi, "CreateDXGIFactory1"));
         if (fpCreateDXGIFactory)
         {
             // DXGI 1.5
-            HRESULT hr = fpCreateDXGIFactory(IID_PPV_ARGS(&g_DXGIFactory5));
+            HRESULT hr = PROBE_CALL("CreateDXGIFactory1", nullptr, fpCreateDXGIFactory(IID_PPV_ARGS(&g_DXGIFactory5)));
             if (SUCCEEDED(hr))
             {
                 g_DXGIFactory4 = g_DXGIFactory5;
@@ -5635,7 +5741,7 @@ VOID DXGI_Init()
                 g_DXGIFactory5 = nullptr;
 
                 // DXGI 1.4
-                hr = fpCreateDXGIFactory(IID_PPV_ARGS(&g_DXGIFactory4));
+                hr = PROBE_CALL("CreateDXGIFactory1", nullptr, fpCreateDXGIFactory(IID_PPV_ARGS(&g_DXGIFactory4)));
                 if (SUCCEEDED(hr))
                 {
                     g_DXGIFactory3 = g_DXGIFactory4;
@@ -5648,7 +5754,7 @@ VOID DXGI_Init()
                     g_DXGIFactory4 = nullptr;
 
                     // DXGI 1.3
-                    hr = fpCreateDXGIFactory(IID_PPV_ARGS(&g_DXGIFactory3));
+                    hr = PROBE_CALL("CreateDXGIFactory1", nullptr, fpCreateDXGIFactory(IID_PPV_ARGS(&g_DXGIFactory3)));
                     if (SUCCEEDED(hr))
                     {
                         g_DXGIFactory2 = g_DXGIFactory3;
@@ -5660,7 +5766,8 @@ VOID DXGI_Init()
                         g_DXGIFactory3 = nullptr;
 
                         // DXGI 1.2
-                        hr = fpCreateDXGIFactory(IID_PPV_ARGS(&g_DXGIFactory2));
+                        hr = PROBE_CALL("CreateDXGIFactory1", nullptr,
+                            fpCreateDXGIFactory(IID_PPV_ARGS(&g_DXGIFactory2)));
                         if (SUCCEEDED(hr))
                         {
                             g_DXGIFactory1 = g_DXGIFactory2;
@@ -5671,7 +5778,8 @@ VOID DXGI_Init()
                             g_DXGIFactory2 = nullptr;
 
                             // DXGI 1.1
-                            hr = fpCreateDXGIFactory(IID_PPV_ARGS(&g_DXGIFactory1));
+                            hr = PROBE_CALL("CreateDXGIFactory1", nullptr,
+                                fpCreateDXGIFactory(IID_PPV_ARGS(&g_DXGIFactory1)));
                             if (SUCCEEDED(hr))
                                 g_DXGIFactory = g_DXGIFactory1;
                             else
@@ -5688,13 +5796,103 @@ VOID DXGI_Init()
 
             if (fpCreateDXGIFactory != 0)
             {
-                HRESULT hr = fpCreateDXGIFactory(IID_PPV_ARGS(&g_DXGIFactory));
+                HRESULT hr = PROBE_CALL("CreateDXGIFactory", nullptr,
+                    fpCreateDXGIFactory(IID_PPV_ARGS(&g_DXGIFactory)));
                 if (FAILED(hr))
                     g_DXGIFactory = nullptr;
             }
         }
     }
 
+    //-----------------------------------------------------------------------------
+    ADAPTERLUID ToAdapterLuid(const LUID& luid)
+    {
+        return { luid.LowPart, luid.HighPart };
+    }
+
+    //-----------------------------------------------------------------------------
+    void GetAdapterKey(IDXGIAdapter* pAdapter, ADAPTERKEY& key)
+    {
+        key = {};
+
+        DXGI_ADAPTER_DESC desc;
+        if (SUCCEEDED(pAdapter->GetDesc(&desc)))
+        {
+            key.AdapterLuid = ToAdapterLuid(desc.AdapterLuid);
+            key.VendorId = desc.VendorId;
+            key.DeviceId = desc.DeviceId;
+            key.SubSysId = desc.SubSysId;
+            key.Revision = desc.Revision;
+        }
+
+        // Reports the user-mode driver version
+        LARGE_INTEGER umdVersion;
+        if (SUCCEEDED(pAdapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &umdVersion)))
+            key.DriverVersion = static_cast<uint64_t>(umdVersion.QuadPart);
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: GetOutputsHash()
+    // Desc: FNV-1a over each output's name and where it sits on the desktop, so
+    //       plugging in a monitor or changing the display mode changes it
+    //-----------------------------------------------------------------------------
+    DWORD GetOutputsHash(IDXGIAdapter* pAdapter)
+    {
+        DWORD hash = 2166136261u;
+        auto hashBytes = [&hash](const void* pData, size_t cbData)
+        {
+            auto pBytes = static_cast<const BYTE*>(pData);
+            for (size_t i = 0; i < cbData; ++i)
+            {
+                hash ^= pBytes[i];
+                hash *= 16777619u;
+            }
+        };
+
+        IDXGIOutput* pOutput = nullptr;
+        for (UINT iOutput = 0; SUCCEEDED(pAdapter->EnumOutputs(iOutput, &pOutput)); ++iOutput)
+        {
+            DXGI_OUTPUT_DESC oDesc;
+            if (SUCCEEDED(pOutput->GetDesc(&oDesc)))
+            {
+                hashBytes(oDesc.DeviceName, wcslen(oDesc.DeviceName) * sizeof(WCHAR));
+                hashBytes(&oDesc.DesktopCoordinates, sizeof(oDesc.DesktopCoordinates));
+                hashBytes(&oDesc.AttachedToDesktop, sizeof(oDesc.AttachedToDesktop));
+                hashBytes(&oDesc.Rotation, sizeof(oDesc.Rotation));
+            }
+
+            pOutput->Release();
+        }
+
+        return hash;
+    }
+
+    //-----------------------------------------------------------------------------
+    void ReleaseFactory()
+    {
+        if (g_DXGIFactory)
+        {
+            SAFE_RELEASE(g_DXGIFactory);
+            g_DXGIFactory = nullptr;
+            g_DXGIFactory1 = nullptr;
+            g_DXGIFactory2 = nullptr;
+            g_DXGIFactory3 = nullptr;
+            g_DXGIFactory4 = nullptr;
+            g_DXGIFactory5 = nullptr;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name: DXGI_Init()
+//-----------------------------------------------------------------------------
+VOID DXGI_Init()
+{
+    // DXGI
+    g_dxgi = LoadLibraryEx("dxgi.dll", 0, LOAD_LIBRARY_SEARCH_SYSTEM32);
+    if (g_dxgi)
+        CreateFactory();
+
     // Direct3D 10.x
     g_d3d10_1 = LoadLibraryEx("d3d10_1.dll", 0, LOAD_LIBRARY_SEARCH_SYSTEM32);
     if (g_d3d10_1)
@@ -5727,631 +5925,748 @@ VOID DXGI_Init()
 
 
 //-----------------------------------------------------------------------------
-// Name: DXGI_FillTree()
+// Name: DXGI_BeginProbe()
+// Desc: Enumerates adapters and starts creating devices for each of them on
+//       the thread pool. DXGI_FillTree waits for the results.
 //-----------------------------------------------------------------------------
-VOID DXGI_FillTree(HWND hwndTV)
+VOID DXGI_BeginProbe()
 {
-    if (!g_DXGIFactory)
+    if (!g_DXGIFactory || g_deviceProbes)
         return;
 
-    HTREEITEM hTree = TVAddNode(TVI_ROOT, "DXGI Devices", TRUE, IDI_DIRECTX, nullptr, 0, 0);
-
-    // Hardware driver types
-    IDXGIAdapter* pAdapter = nullptr;
-    IDXGIAdapter1* pAdapter1 = nullptr;
-    IDXGIAdapter2* pAdapter2 = nullptr;
-    IDXGIAdapter3* pAdapter3 = nullptr;
-    HRESULT hr;
-    for (UINT iAdapter = 0; ; ++iAdapter)
+    UINT numAdapters = 0;
+    for (;;)
     {
-        if (g_DXGIFactory1)
-        {
-            hr = g_DXGIFactory1->EnumAdapters1(iAdapter, &pAdapter1);
-            pAdapter = pAdapter1;
-
-            if (SUCCEEDED(hr))
-            {
-                HRESULT hr2 = pAdapter1->QueryInterface(IID_PPV_ARGS(&pAdapter2));
-                if (FAILED(hr2))
-                    pAdapter2 = nullptr;
+        IDXGIAdapter* pAdapter = nullptr;
+        if (FAILED(PROBE_CALL("IDXGIFactory::EnumAdapters", nullptr,
+            g_DXGIFactory->EnumAdapters(numAdapters, &pAdapter))))
+            break;
 
-                hr2 = pAdapter1->QueryInterface(IID_PPV_ARGS(&pAdapter3));
-                if (FAILED(hr2))
-                    pAdapter3 = nullptr;
-            }
-        }
-        else
-        {
-            hr = g_DXGIFactory->EnumAdapters(iAdapter, &pAdapter);
-        }
+        pAdapter->Release();
+        ++numAdapters;
+    }
 
-        if (FAILED(hr))
-            break;
+    // One probe per adapter, plus WARP and REF
+    g_deviceProbes = new (std::nothrow) DXGIDeviceProbe[numAdapters + 2]();
+    if (!g_deviceProbes)
+        return;
 
-        if (pAdapter2)
-        {
-            DXGI_ADAPTER_DESC2 aDesc2;
-            pAdapter2->GetDesc2(&aDesc2);
+    // One per adapter, plus WARP and REF
+    g_probeTasks = new (std::nothrow) DXGIProbeTask[numAdapters + 2]();
+    if (!g_probeTasks)
+    {
+        delete[] g_deviceProbes;
+        g_deviceProbes = nullptr;
+        return;
+    }
 
-            if (aDesc2.Flags & DXGI_ADAPTER_FLAG_SOFTWARE)
-            {
-                // Skip "always there" Microsoft Basics Display Driver
-                pAdapter2->Release();
-                pAdapter1->Release();
-                continue;
-            }
-        }
+    g_numAdapterProbes = numAdapters;
 
-        DXGI_ADAPTER_DESC aDesc;
-        hr = pAdapter->GetDesc(&aDesc);
-        if (FAILED(hr))
+    for (UINT iAdapter = 0; iAdapter < numAdapters; ++iAdapter)
+    {
+        if (g_dxgiShard != DXGISHARD_ALL && g_dxgiShard != iAdapter)
             continue;
 
-        char szDesc[128];
-        wcstombs_s(nullptr, szDesc, aDesc.Description, 128);
+        DXGIDeviceProbe& probe = g_deviceProbes[iAdapter];
+        if (!InitAdapterProbe(iAdapter, probe))
+            continue;
 
-        HTREEITEM hTreeA;
+        AddProbeTask(probe, c_adapterApis);
+    }
 
-        // No need for DXGIAdapterInfo3 as there's no extra desc information to display
+    // WARP
+    DXGIDeviceProbe& warp = g_deviceProbes[numAdapters];
+    strcpy_s(warp.strName, "WARP");
+    if (g_dxgiShard == DXGISHARD_ALL || g_dxgiShard == DXGISHARD_WARP)
+        AddProbeTask(warp, c_warpApis);
 
-        if (pAdapter2)
-        {
-            hTreeA = TVAddNode(hTree, szDesc, TRUE, IDI_CAPS, DXGIAdapterInfo2, iAdapter, (LPARAM)(pAdapter2));
-        }
-        else if (pAdapter1)
-        {
-            hTreeA = TVAddNode(hTree, szDesc, TRUE, IDI_CAPS, DXGIAdapterInfo1, iAdapter, (LPARAM)(pAdapter1));
-        }
-        else
-        {
-            hTreeA = TVAddNode(hTree, szDesc, TRUE, IDI_CAPS, DXGIAdapterInfo, iAdapter, (LPARAM)(pAdapter));
-        }
+    // REFERENCE
+    DXGIDeviceProbe& ref = g_deviceProbes[numAdapters + 1];
+    strcpy_s(ref.strName, "Reference");
+    if (g_dxgiShard == DXGISHARD_ALL || g_dxgiShard == DXGISHARD_REF)
+        AddProbeTask(ref, c_refApis);
+}
 
-        // Outputs
-        HTREEITEM hTreeO = nullptr;
 
-        IDXGIOutput* pOutput = nullptr;
-        for (UINT iOutput = 0; ; ++iOutput)
-        {
-            hr = pAdapter->EnumOutputs(iOutput, &pOutput);
+//-----------------------------------------------------------------------------
+// Name: DXGI_SetShard()
+// Desc: Limits probing to one adapter by index, or to DXGISHARD_WARP or
+//       DXGISHARD_REF, for a probe worker. Call before DXGI_BeginProbe.
+//-----------------------------------------------------------------------------
+VOID DXGI_SetShard(UINT shard)
+{
+    g_dxgiShard = shard;
+}
 
-            if (FAILED(hr))
-                break;
 
-            if (iOutput == 0)
-            {
-                hTreeO = TVAddNode(hTreeA, "Outputs", TRUE, IDI_CAPS, DXGIFeatures, 0, 0);
-            }
+//-----------------------------------------------------------------------------
+// Name: DXGI_GetAdapterKeys()
+// Desc: Identifies the adapters and their drivers without creating any devices.
+//       Returns the number of adapters, filling in up to maxKeys of them.
+//-----------------------------------------------------------------------------
+UINT DXGI_GetAdapterKeys(ADAPTERKEY* pKeys, UINT maxKeys)
+{
+    if (!g_DXGIFactory)
+        return 0;
 
-            DXGI_OUTPUT_DESC oDesc;
-            pOutput->GetDesc(&oDesc);
+    UINT iAdapter = 0;
+    for (;; ++iAdapter)
+    {
+        IDXGIAdapter* pAdapter = nullptr;
+        if (FAILED(PROBE_CALL("IDXGIFactory::EnumAdapters", nullptr, g_DXGIFactory->EnumAdapters(iAdapter, &pAdapter))))
+            break;
 
-            char szDeviceName[32];
-            wcstombs_s(nullptr, szDeviceName, oDesc.DeviceName, 32);
+        if (pKeys && iAdapter < maxKeys)
+            GetAdapterKey(pAdapter, pKeys[iAdapter]);
 
-            HTREEITEM hTreeD = TVAddNode(hTreeO, szDeviceName, TRUE, IDI_CAPS, DXGIOutputInfo, iOutput, (LPARAM)pOutput);
+        pAdapter->Release();
+    }
 
-            TVAddNode(hTreeD, "Display Modes", FALSE, IDI_CAPS, DXGIOutputModes, iOutput, (LPARAM)pOutput);
-        }
+    return iAdapter;
+}
 
-        // Direct3D 12
-#ifdef EXTRA_DEBUG
-        OutputDebugStringA("Direct3D 12\n");
-#endif
-        ID3D12Device* pDevice12 = nullptr;
 
-        if (pAdapter3 != 0 && g_D3D12CreateDevice != 0)
-        {
-            hr = g_D3D12CreateDevice(pAdapter3, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&pDevice12));
-            if (SUCCEEDED(hr))
-            {
-#ifdef EXTRA_DEBUG
-                D3D_FEATURE_LEVEL fl = GetD3D12FeatureLevel(pDevice12);
-                OutputDebugString(FLName(fl));
-#endif
-                D3D12_FillTree(hTreeA, pDevice12, D3D_DRIVER_TYPE_HARDWARE);
-            }
-            else
-            {
-#ifdef EXTRA_DEBUG
-                char buff[64] = {};
-                sprintf_s(buff, ": Failed (%08X)\n", hr);
-                OutputDebugStringA(buff);
-#endif
-                pDevice12 = nullptr;
-            }
-        }
+//-----------------------------------------------------------------------------
+// Name: DXGI_GetAdapterStates()
+// Desc: As DXGI_GetAdapterKeys, along with the outputs of each adapter. This
+//       is the ADAPTERSOURCE the device change watch reads.
+//-----------------------------------------------------------------------------
+UINT DXGI_GetAdapterStates(ADAPTERSTATE* pStates, UINT maxStates)
+{
+    if (!g_DXGIFactory)
+        return 0;
 
-        // Direct3D 11.x
-#ifdef EXTRA_DEBUG
-        OutputDebugStringA("Direct3D 11.x\n");
-#endif
+    UINT iAdapter = 0;
+    for (;; ++iAdapter)
+    {
+        IDXGIAdapter* pAdapter = nullptr;
+        if (FAILED(g_DXGIFactory->EnumAdapters(iAdapter, &pAdapter)))
+            break;
 
-        ID3D11Device* pDevice11 = nullptr;
-        ID3D11Device1* pDevice11_1 = nullptr;
-        ID3D11Device2* pDevice11_2 = nullptr;
-        ID3D11Device3* pDevice11_3 = nullptr;
-        ID3D11Device4* pDevice11_4 = nullptr;
-        DWORD flMaskDX11 = 0;
-        if (pAdapter1 != nullptr && g_D3D11CreateDevice != nullptr)
+        if (pStates && iAdapter < maxStates)
         {
-            D3D_FEATURE_LEVEL flHigh = (D3D_FEATURE_LEVEL)0;
-
-            for (UINT i = 1 /* Skip 12.2 for DX11 */; i < std::size(g_featureLevels); ++i)
-            {
-#ifdef EXTRA_DEBUG
-                OutputDebugString(FLName(g_featureLevels[i]));
-#endif
-                hr = g_D3D11CreateDevice(pAdapter1, D3D_DRIVER_TYPE_UNKNOWN, nullptr, 0,
-                    &g_featureLevels[i], 1,
-                    D3D11_SDK_VERSION, &pDevice11, nullptr, nullptr);
-                if (SUCCEEDED(hr))
-                {
-#ifdef EXTRA_DEBUG
-                    OutputDebugString(": Success\n");
-#endif
-                    switch (g_featureLevels[i])
-                    {
-                    case D3D_FEATURE_LEVEL_9_1:  flMaskDX11 |= FLMASK_9_1; break;
-                    case D3D_FEATURE_LEVEL_9_2:  flMaskDX11 |= FLMASK_9_2; break;
-                    case D3D_FEATURE_LEVEL_9_3:  flMaskDX11 |= FLMASK_9_3; break;
-                    case D3D_FEATURE_LEVEL_10_0: flMaskDX11 |= FLMASK_10_0; break;
-                    case D3D_FEATURE_LEVEL_10_1: flMaskDX11 |= FLMASK_10_1; break;
-                    case D3D_FEATURE_LEVEL_11_0: flMaskDX11 |= FLMASK_11_0; break;
-                    case D3D_FEATURE_LEVEL_11_1: flMaskDX11 |= FLMASK_11_1; break;
-                    case D3D_FEATURE_LEVEL_12_0: flMaskDX11 |= FLMASK_12_0; break;
-                    case D3D_FEATURE_LEVEL_12_1: flMaskDX11 |= FLMASK_12_1; break;
-                    default: break;
-                    }
+            GetAdapterKey(pAdapter, pStates[iAdapter].Key);
+            pStates[iAdapter].OutputsHash = GetOutputsHash(pAdapter);
+        }
 
-                    if (g_featureLevels[i] > flHigh)
-                        flHigh = g_featureLevels[i];
-                }
-                else
-                {
-#ifdef EXTRA_DEBUG
-                    char buff[64] = {};
-                    sprintf_s(buff, ": Failed (%08X)\n", hr);
-                    OutputDebugStringA(buff);
-#endif
-                    pDevice11 = nullptr;
-                }
+        pAdapter->Release();
+    }
 
-                if (pDevice11)
-                {
-                    // Some Intel Integrated Graphics WDDM 1.0 drivers will crash if you try to release here
-                    // For this application, leaking a few device instances is not a big deal
-                    if (aDesc.VendorId != 0x8086)
-                        pDevice11->Release();
+    return iAdapter;
+}
 
-                    pDevice11 = nullptr;
-                }
-            }
 
-            if (flHigh > 0)
-            {
-                hr = g_D3D11CreateDevice(pAdapter1, D3D_DRIVER_TYPE_UNKNOWN, nullptr, 0, &flHigh, 1,
-                    D3D11_SDK_VERSION, &pDevice11, nullptr, nullptr);
+//-----------------------------------------------------------------------------
+// Name: DXGI_GetMonitorAdapter()
+// Desc: Finds the adapter a monitor is attached to, so the older APIs can tell
+//       which of their devices a device change touched
+//-----------------------------------------------------------------------------
+BOOL DXGI_GetMonitorAdapter(HMONITOR hMonitor, ADAPTERLUID& luid)
+{
+    if (!g_DXGIFactory || !hMonitor)
+        return FALSE;
 
-                if (SUCCEEDED(hr))
-                {
-                    hr = pDevice11->QueryInterface(IID_PPV_ARGS(&pDevice11_1));
-                    if (FAILED(hr))
-                        pDevice11_1 = nullptr;
+    for (UINT iAdapter = 0;; ++iAdapter)
+    {
+        IDXGIAdapter* pAdapter = nullptr;
+        if (FAILED(g_DXGIFactory->EnumAdapters(iAdapter, &pAdapter)))
+            return FALSE;
 
-                    hr = pDevice11->QueryInterface(IID_PPV_ARGS(&pDevice11_2));
-                    if (FAILED(hr))
-                        pDevice11_2 = nullptr;
+        BOOL bFound = FALSE;
+        IDXGIOutput* pOutput = nullptr;
+        for (UINT iOutput = 0; !bFound && SUCCEEDED(pAdapter->EnumOutputs(iOutput, &pOutput)); ++iOutput)
+        {
+            DXGI_OUTPUT_DESC oDesc;
+            bFound = SUCCEEDED(pOutput->GetDesc(&oDesc)) && (oDesc.Monitor == hMonitor);
+            pOutput->Release();
+        }
 
-                    hr = pDevice11->QueryInterface(IID_PPV_ARGS(&pDevice11_3));
-                    if (FAILED(hr))
-                        pDevice11_3 = nullptr;
+        DXGI_ADAPTER_DESC desc;
+        if (bFound && SUCCEEDED(pAdapter->GetDesc(&desc)))
+            luid = ToAdapterLuid(desc.AdapterLuid);
+        else
+            bFound = FALSE;
 
-                    hr = pDevice11->QueryInterface(IID_PPV_ARGS(&pDevice11_4));
-                    if (FAILED(hr))
-                        pDevice11_4 = nullptr;
-                }
-                else if (FAILED(hr))
-                    pDevice11 = nullptr;
-            }
-        }
+        pAdapter->Release();
 
-        if (pDevice11 || pDevice11_1 || pDevice11_2 || pDevice11_3)
-        {
-            HTREEITEM hTree11 = (pDevice11_1 || pDevice11_2 || pDevice11_3)
-                ? TVAddNode(hTreeA, "Direct3D 11", TRUE, IDI_CAPS, nullptr, 0, 0)
-                : hTreeA;
+        if (bFound)
+            return TRUE;
+    }
+}
 
-            if (pDevice11)
-                D3D11_FillTree(hTree11, pDevice11, flMaskDX11, D3D_DRIVER_TYPE_HARDWARE);
 
-            if (pDevice11_1)
-                D3D11_FillTree1(hTree11, pDevice11_1, flMaskDX11, D3D_DRIVER_TYPE_HARDWARE);
+namespace
+{
+    // Hardware adapter nodes, so a device change can find the ones to replace
+    struct ADAPTERNODE
+    {
+        ADAPTERLUID AdapterLuid;
+        HTREEITEM   hItem;
+    };
 
-            if (pDevice11_2)
-                D3D11_FillTree2(hTree11, pDevice11_2, flMaskDX11, D3D_DRIVER_TYPE_HARDWARE);
+    HTREEITEM g_hTreeDXGI = nullptr;
+    std::vector<ADAPTERNODE> g_adapterNodes;
+    ADAPTERWATCH g_adapterWatch(DXGI_GetAdapterStates);
 
-            if (pDevice11_3)
-                D3D11_FillTree3(hTree11, pDevice11_3, pDevice11_4, flMaskDX11, D3D_DRIVER_TYPE_HARDWARE);
-        }
+    // The re-probe of a device change, waited out on the thread pool
+    PTP_WORK g_pUpdateWork = nullptr;
+    UINT g_updateGeneration = 0;
+    BOOL g_bCheckPending = FALSE;   // A device change came in while re-probing
 
-        // Direct3D 10.x
-#ifdef EXTRA_DEBUG
-        OutputDebugStringA("Direct3D 10.x\n");
-#endif
-        ID3D10Device* pDevice10 = nullptr;
-        ID3D10Device1* pDevice10_1 = nullptr;
-        DWORD flMaskDX10 = 0;
-        if (g_D3D10CreateDevice1)
-        {
-            // Since 10 & 10.1 are so close, try to create just one device object for both...
-            static const D3D10_FEATURE_LEVEL1 lvl[] =
-            {
-                D3D10_FEATURE_LEVEL_10_1, D3D10_FEATURE_LEVEL_10_0,
-                D3D10_FEATURE_LEVEL_9_3, D3D10_FEATURE_LEVEL_9_2, D3D10_FEATURE_LEVEL_9_1
-            };
+    //-----------------------------------------------------------------------------
+    // Name: AddAdapterTree()
+    // Desc: Adds the node of a probed hardware adapter and everything below it
+    //-----------------------------------------------------------------------------
+    void AddAdapterTree(HTREEITEM hTree, DXGIDeviceProbe& probe)
+    {
+        HRESULT hr;
 
-            // Test every feature-level since some devices might be missing some
-            D3D10_FEATURE_LEVEL1 flHigh = (D3D10_FEATURE_LEVEL1)0;
-            for (UINT i = 0; i < std::size(lvl); ++i)
-            {
-                if (g_DXGIFactory1 == 0)
-                {
-                    // Skip 10level9 if using DXGI 1.0
-                    if (lvl[i] == D3D10_FEATURE_LEVEL_9_1
-                        || lvl[i] == D3D10_FEATURE_LEVEL_9_2
-                        || lvl[i] == D3D10_FEATURE_LEVEL_9_3)
-                        continue;
-                }
+        char szDesc[128];
+        wcstombs_s(nullptr, szDesc, probe.aDesc.Description, 128);
 
-#ifdef EXTRA_DEBUG
-                OutputDebugString(FLName(lvl[i]));
-#endif
+        HTREEITEM hTreeA;
 
-                hr = g_D3D10CreateDevice1(pAdapter, D3D10_DRIVER_TYPE_HARDWARE, nullptr, 0, lvl[i], D3D10_1_SDK_VERSION, &pDevice10_1);
-                if (SUCCEEDED(hr))
-                {
-#ifdef EXTRA_DEBUG
-                    OutputDebugString(": Success\n");
-#endif
+        // No need for DXGIAdapterInfo3 as there's no extra desc information to display
 
-                    switch (lvl[i])
-                    {
-                    case D3D10_FEATURE_LEVEL_9_1:  flMaskDX10 |= FLMASK_9_1; break;
-                    case D3D10_FEATURE_LEVEL_9_2:  flMaskDX10 |= FLMASK_9_2; break;
-                    case D3D10_FEATURE_LEVEL_9_3:  flMaskDX10 |= FLMASK_9_3; break;
-                    case D3D10_FEATURE_LEVEL_10_0: flMaskDX10 |= FLMASK_10_0; break;
-                    case D3D10_FEATURE_LEVEL_10_1: flMaskDX10 |= FLMASK_10_1; break;
-                    }
+        if (probe.pAdapter2)
+        {
+            hTreeA = TVAddNode(hTree, szDesc, TRUE, IDI_CAPS, DXGIAdapterInfo2, probe.iAdapter, (LPARAM)(probe.pAdapter2));
+        }
+        else if (probe.pAdapter1)
+        {
+            hTreeA = TVAddNode(hTree, szDesc, TRUE, IDI_CAPS, DXGIAdapterInfo1, probe.iAdapter, (LPARAM)(probe.pAdapter1));
+        }
+        else
+        {
+            hTreeA = TVAddNode(hTree, szDesc, TRUE, IDI_CAPS, DXGIAdapterInfo, probe.iAdapter, (LPARAM)(probe.pAdapter));
+        }
 
-                    if (lvl[i] > flHigh)
-                        flHigh = lvl[i];
-                }
-                else
-                {
-#ifdef EXTRA_DEBUG
-                    char buff[64] = {};
-                    sprintf_s(buff, ": Failed (%08X)\n", hr);
-                    OutputDebugStringA(buff);
-#endif
-                    pDevice10_1 = nullptr;
-                }
+        // pAdapter is pAdapter1 when there is one
+        RegisterObject(probe.pAdapter, "IDXGIAdapter", probe.strName, hTreeA);
+        RegisterObject(probe.pAdapter2, "IDXGIAdapter2", probe.strName, hTreeA);
+        RegisterObject(probe.pAdapter3, "IDXGIAdapter3", probe.strName, hTreeA);
 
-                if (pDevice10_1)
-                {
-                    pDevice10_1->Release();
-                    pDevice10_1 = nullptr;
-                }
-            }
+        // Outputs
+        HTREEITEM hTreeO = nullptr;
 
-            if (flHigh > 0)
-            {
-                hr = g_D3D10CreateDevice1(pAdapter, D3D10_DRIVER_TYPE_HARDWARE, nullptr, 0, flHigh, D3D10_1_SDK_VERSION, &pDevice10_1);
-                if (SUCCEEDED(hr))
-                {
-                    if (flHigh >= D3D10_FEATURE_LEVEL_10_0)
-                    {
-                        hr = pDevice10_1->QueryInterface(IID_PPV_ARGS(&pDevice10));
-                        if (FAILED(hr))
-                            pDevice10 = nullptr;
-                    }
-                }
-                else
-                {
-                    pDevice10_1 = nullptr;
-                }
+        IDXGIOutput* pOutput = nullptr;
+        for (UINT iOutput = 0; ; ++iOutput)
+        {
+            hr = PROBE_CALL("IDXGIAdapter::EnumOutputs", probe.strName, probe.pAdapter->EnumOutputs(iOutput, &pOutput));
+
+            if (FAILED(hr))
+                break;
+
+            if (iOutput == 0)
+            {
+                hTreeO = TVAddNode(hTreeA, "Outputs", TRUE, IDI_CAPS, DXGIFeatures, 0, 0);
             }
+
+            DXGI_OUTPUT_DESC oDesc;
+            pOutput->GetDesc(&oDesc);
+
+            char szDeviceName[32];
+            wcstombs_s(nullptr, szDeviceName, oDesc.DeviceName, 32);
+
+            HTREEITEM hTreeD = TVAddNode(hTreeO, szDeviceName, TRUE, IDI_CAPS, DXGIOutputInfo, iOutput, (LPARAM)pOutput);
+
+            TVAddNode(hTreeD, "Display Modes", FALSE, IDI_CAPS, DXGIOutputModes, iOutput, (LPARAM)pOutput);
+
+            RegisterObject(pOutput, "IDXGIOutput", probe.strName, hTreeA);
         }
-        else if (g_D3D10CreateDevice)
+
+        // Ahead of the subtrees, so the format matrices they start know the adapter
+        RegisterDevices(probe, hTreeA);
+
+        // Direct3D 12
+        if (probe.pDevice12)
+            D3D12_FillTree(hTreeA, probe.pDevice12, D3D_DRIVER_TYPE_HARDWARE);
+
+        // Direct3D 11.x
+        if (probe.pDevice11 || probe.pDevice11_1 || probe.pDevice11_2 || probe.pDevice11_3)
         {
-            hr = g_D3D10CreateDevice(pAdapter, D3D10_DRIVER_TYPE_HARDWARE, nullptr, 0, D3D10_SDK_VERSION, &pDevice10);
-            if (FAILED(hr))
-                pDevice10 = nullptr;
+            HTREEITEM hTree11 = (probe.pDevice11_1 || probe.pDevice11_2 || probe.pDevice11_3)
+                ? TVAddNode(hTreeA, "Direct3D 11", TRUE, IDI_CAPS, nullptr, 0, 0)
+                : hTreeA;
+
+            if (probe.pDevice11)
+                D3D11_FillTree(hTree11, probe.pDevice11, probe.flMaskDX11, D3D_DRIVER_TYPE_HARDWARE);
+
+            if (probe.pDevice11_1)
+                D3D11_FillTree1(hTree11, probe.pDevice11_1, probe.flMaskDX11, D3D_DRIVER_TYPE_HARDWARE);
+
+            if (probe.pDevice11_2)
+                D3D11_FillTree2(hTree11, probe.pDevice11_2, probe.flMaskDX11, D3D_DRIVER_TYPE_HARDWARE);
+
+            if (probe.pDevice11_3)
+                D3D11_FillTree3(hTree11, probe.pDevice11_3, probe.pDevice11_4, probe.flMaskDX11, D3D_DRIVER_TYPE_HARDWARE);
         }
 
         // Direct3D 10
-        if (pDevice10 || pDevice10_1)
+        if (probe.pDevice10 || probe.pDevice10_1)
         {
-            HTREEITEM hTree10 = (pDevice10_1)
+            HTREEITEM hTree10 = (probe.pDevice10_1)
                 ? TVAddNode(hTreeA, "Direct3D 10", TRUE, IDI_CAPS, nullptr, 0, 0)
                 : hTreeA;
 
-            if (pDevice10)
-                D3D10_FillTree(hTree10, pDevice10, D3D_DRIVER_TYPE_HARDWARE);
+            if (probe.pDevice10)
+                D3D10_FillTree(hTree10, probe.pDevice10, D3D_DRIVER_TYPE_HARDWARE);
 
             // Direct3D 10.1 (includes 10level9 feature levels)
-            if (pDevice10_1)
-                D3D10_FillTree1(hTree10, pDevice10_1, flMaskDX10, D3D_DRIVER_TYPE_HARDWARE);
+            if (probe.pDevice10_1)
+                D3D10_FillTree1(hTree10, probe.pDevice10_1, probe.flMaskDX10, D3D_DRIVER_TYPE_HARDWARE);
         }
-    }
 
-    // WARP
-    DWORD flMaskWARP = FLMASK_9_1 | FLMASK_9_2 | FLMASK_9_3 | FLMASK_10_0 | FLMASK_10_1;
-    ID3D10Device1* pDeviceWARP10 = nullptr;
-    if (g_D3D10CreateDevice1)
-    {
-#ifdef EXTRA_DEBUG
-        OutputDebugString("WARP10\n");
-#endif
+        for (UINT i = 0; i < probe.numTimedOut; ++i)
+            WatchdogAddTimedOutNode(hTreeA, probe.strTimedOut[i]);
 
-        hr = g_D3D10CreateDevice1(nullptr, D3D10_DRIVER_TYPE_WARP, nullptr, 0, D3D10_FEATURE_LEVEL_10_1,
-            D3D10_1_SDK_VERSION, &pDeviceWARP10);
-        if (FAILED(hr))
-            pDeviceWARP10 = nullptr;
+        ADAPTERNODE node = { ToAdapterLuid(probe.aDesc.AdapterLuid), hTreeA };
+        g_adapterNodes.push_back(node);
     }
 
-    ID3D11Device* pDeviceWARP11 = nullptr;
-    ID3D11Device1* pDeviceWARP11_1 = nullptr;
-    ID3D11Device2* pDeviceWARP11_2 = nullptr;
-    ID3D11Device3* pDeviceWARP11_3 = nullptr;
-    ID3D11Device4* pDeviceWARP11_4 = nullptr;
-    if (g_D3D11CreateDevice)
+    //-----------------------------------------------------------------------------
+    // Name: RemoveAdapterTree()
+    // Desc: Deletes the subtree of an adapter that's gone or about to be
+    //       re-probed, releasing whatever objects it still held
+    //-----------------------------------------------------------------------------
+    void RemoveAdapterTree(HWND hwndTV, const ADAPTERLUID& luid)
     {
-#ifdef EXTRA_DEBUG
-        OutputDebugString("WARP11\n");
-#endif
-        D3D_FEATURE_LEVEL fl;
-        // Skip 12.2
-        hr = g_D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0,
-            &g_featureLevels[1], static_cast<UINT>(std::size(g_featureLevels) - 1),
-            D3D11_SDK_VERSION, &pDeviceWARP11, &fl, nullptr);
-        if (FAILED(hr))
+        for (auto it = g_adapterNodes.begin(); it != g_adapterNodes.end(); ++it)
         {
-            // Try without 12.x
-            hr = g_D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0,
-                &g_featureLevels[3], static_cast<UINT>(std::size(g_featureLevels) - 3),
-                D3D11_SDK_VERSION, &pDeviceWARP11, &fl, nullptr);
-
-            if (FAILED(hr))
+            if (IsSameLuid(it->AdapterLuid, luid))
             {
-                hr = g_D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0, nullptr, 0,
-                    D3D11_SDK_VERSION, &pDeviceWARP11, &fl, nullptr);
+                ReleaseOwnedObjects(it->hItem);
+                TVDeleteNode(hwndTV, it->hItem);
+                g_adapterNodes.erase(it);
+                return;
             }
         }
-        if (FAILED(hr))
-            pDeviceWARP11 = nullptr;
-        else
-        {
-#ifdef EXTRA_DEBUG
-            OutputDebugString(FLName(fl));
-#endif
-            if (fl >= D3D_FEATURE_LEVEL_12_1)
-                flMaskWARP |= FLMASK_12_1;
-
-            if (fl >= D3D_FEATURE_LEVEL_12_0)
-                flMaskWARP |= FLMASK_12_0;
+    }
 
-            if (fl >= D3D_FEATURE_LEVEL_11_1)
-                flMaskWARP |= FLMASK_11_1;
+    //-----------------------------------------------------------------------------
+    BOOL FindAdapterIndex(const ADAPTERLUID& luid, UINT& iAdapter)
+    {
+        for (iAdapter = 0;; ++iAdapter)
+        {
+            IDXGIAdapter* pAdapter = nullptr;
+            if (FAILED(g_DXGIFactory->EnumAdapters(iAdapter, &pAdapter)))
+                return FALSE;
 
-            if (fl >= D3D_FEATURE_LEVEL_11_0)
-                flMaskWARP |= FLMASK_11_0;
+            DXGI_ADAPTER_DESC desc;
+            HRESULT hr = pAdapter->GetDesc(&desc);
+            pAdapter->Release();
 
-            hr = pDeviceWARP11->QueryInterface(IID_PPV_ARGS(&pDeviceWARP11_1));
-            if (FAILED(hr))
-                pDeviceWARP11_1 = nullptr;
+            if (SUCCEEDED(hr) && IsSameLuid(ToAdapterLuid(desc.AdapterLuid), luid))
+                return TRUE;
+        }
+    }
 
-            hr = pDeviceWARP11->QueryInterface(IID_PPV_ARGS(&pDeviceWARP11_2));
-            if (FAILED(hr))
-                pDeviceWARP11_2 = nullptr;
+    //-----------------------------------------------------------------------------
+    // Name: SortAdapterNodes()
+    // Desc: Re-probed adapters are added at the end, so put the hardware
+    //       adapters back in the order DXGI enumerates them, ahead of WARP and
+    //       REF
+    //-----------------------------------------------------------------------------
+    struct ADAPTERRANK
+    {
+        LPARAM      lParam;     // The node's NODEINFO
+        UINT        rank;
+    };
 
-            hr = pDeviceWARP11->QueryInterface(IID_PPV_ARGS(&pDeviceWARP11_3));
-            if (FAILED(hr))
-                pDeviceWARP11_3 = nullptr;
+    int CALLBACK CompareAdapterNodes(LPARAM lParam1, LPARAM lParam2, LPARAM lParamSort)
+    {
+        auto pRanks = reinterpret_cast<const std::vector<ADAPTERRANK>*>(lParamSort);
 
-            hr = pDeviceWARP11->QueryInterface(IID_PPV_ARGS(&pDeviceWARP11_4));
-            if (FAILED(hr))
-                pDeviceWARP11_4 = nullptr;
+        UINT rank1 = 0;
+        UINT rank2 = 0;
+        for (const auto& rank : *pRanks)
+        {
+            if (rank.lParam == lParam1)
+                rank1 = rank.rank;
+            if (rank.lParam == lParam2)
+                rank2 = rank.rank;
         }
-    }
 
-    ID3D12Device* pDeviceWARP12 = nullptr;
+        return (rank1 < rank2) ? -1 : ((rank1 > rank2) ? 1 : 0);
+    }
 
-    if (g_D3D12CreateDevice != 0 && g_DXGIFactory4 != 0)
+    void SortAdapterNodes(HWND hwndTV)
     {
-#ifdef EXTRA_DEBUG
-        OutputDebugString("WARP12\n");
-#endif
-        IDXGIAdapter* warpAdapter = nullptr;
-        hr = g_DXGIFactory4->EnumWarpAdapter(IID_PPV_ARGS(&warpAdapter));
-        if (SUCCEEDED(hr))
+        std::vector<ADAPTERRANK> ranks;
+
+        UINT position = 0;
+        for (HTREEITEM hChild = TreeView_GetChild(hwndTV, g_hTreeDXGI); hChild;
+            hChild = TreeView_GetNextSibling(hwndTV, hChild), ++position)
         {
-            hr = g_D3D12CreateDevice(warpAdapter, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&pDeviceWARP12));
-            if (SUCCEEDED(hr))
-            {
-#ifdef EXTRA_DEBUG
-                D3D_FEATURE_LEVEL fl = GetD3D12FeatureLevel(pDeviceWARP12);
-                OutputDebugString(FLName(fl));
-#endif
-            }
-            else
+            TV_ITEM tvi = {};
+            tvi.mask = TVIF_PARAM;
+            tvi.hItem = hChild;
+            if (!TreeView_GetItem(hwndTV, &tvi))
+                continue;
+
+            // Anything else keeps its place after the adapters
+            ADAPTERRANK rank = { tvi.lParam, 0x10000 + position };
+            for (const auto& node : g_adapterNodes)
             {
-#ifdef EXTRA_DEBUG
-                char buff[64] = {};
-                sprintf_s(buff, ": Failed (%08X)\n", hr);
-                OutputDebugStringA(buff);
-#endif
-                pDeviceWARP12 = nullptr;
+                if (node.hItem != hChild)
+                    continue;
+
+                const auto& states = g_adapterWatch.states;
+                for (UINT i = 0; i < states.size(); ++i)
+                {
+                    if (IsSameLuid(states[i].Key.AdapterLuid, node.AdapterLuid))
+                        rank.rank = i;
+                }
             }
 
-            warpAdapter->Release();
-        }
-#ifdef EXTRA_DEBUG
-        else
-        {
-            OutputDebugString("WARP12 adapter not found!\n");
+            ranks.push_back(rank);
         }
-#endif
+
+        TVSORTCB sort = {};
+        sort.hParent = g_hTreeDXGI;
+        sort.lpfnCompare = CompareAdapterNodes;
+        sort.lParam = reinterpret_cast<LPARAM>(&ranks);
+        TreeView_SortChildrenCB(hwndTV, &sort, FALSE);
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: AddProbedAdapterTrees()
+    // Desc: Adds the subtrees of the adapters a device change re-probed
+    //-----------------------------------------------------------------------------
+    void AddProbedAdapterTrees(HWND hwndTV)
+    {
+        for (UINT iProbe = 0; iProbe < g_numAdapterProbes; ++iProbe)
+            AddAdapterTree(g_hTreeDXGI, g_deviceProbes[iProbe]);
+
+        FreeDeviceProbes();
+
+        ReleaseCapturedObjects(hwndTV);
+
+        SortAdapterNodes(hwndTV);
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: WaitForUpdateProbes()
+    // Desc: Waits out a device change's probes off the UI thread, then hands
+    //       the results back to it with WM_ADAPTERSPROBED
+    //-----------------------------------------------------------------------------
+    VOID CALLBACK WaitForUpdateProbes(PTP_CALLBACK_INSTANCE /*instance*/, PVOID pContext, PTP_WORK /*work*/)
+    {
+        WaitForDeviceProbes();
+
+        PostMessage(g_hwndMain, WM_ADAPTERSPROBED, reinterpret_cast<WPARAM>(pContext), 0);
+    }
+
+    //-----------------------------------------------------------------------------
+    void CloseUpdateWork()
+    {
+        if (!g_pUpdateWork)
+            return;
+
+        // Bounded by the watchdog, which gives up on any probe that hangs
+        WaitForThreadpoolWorkCallbacks(g_pUpdateWork, FALSE);
+        CloseThreadpoolWork(g_pUpdateWork);
+        g_pUpdateWork = nullptr;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXGI_FindFormat()
+// Desc: Looks up a DXGI format by name, with or without the DXGI_FORMAT_ prefix
+//-----------------------------------------------------------------------------
+const FORMATDESC* DXGI_FindFormat(const char* strName)
+{
+    return FindFormatByName(c_dxgiFormatTable, c_dxgiFormatHash, strName);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXGI_FillTree()
+//-----------------------------------------------------------------------------
+VOID DXGI_FillTree(HWND hwndTV)
+{
+    PROBESCOPE probeScope(PROBE_PHASE, "DXGI_FillTree", nullptr);
+
+    if (!g_DXGIFactory)
+        return;
+
+    // Normally already started from WinMain so device creation overlaps window creation
+    DXGI_BeginProbe();
+    {
+        PROBESCOPE waitScope(PROBE_PHASE, "WaitForDeviceProbes", nullptr);
+        WaitForDeviceProbes();
     }
 
-    if (pDeviceWARP10 || pDeviceWARP11 || pDeviceWARP11_1 || pDeviceWARP11_2 || pDeviceWARP11_3 || pDeviceWARP11_4 || pDeviceWARP12)
+    if (!g_deviceProbes)
+        return;
+
+    HTREEITEM hTree = TVAddNode(TVI_ROOT, "DXGI Devices", TRUE, IDI_DIRECTX, nullptr, 0, 0);
+
+    // Hardware driver types
+    g_hTreeDXGI = hTree;
+    g_adapterNodes.clear();
+    for (UINT iProbe = 0; iProbe < g_numAdapterProbes; ++iProbe)
+    {
+        DXGIDeviceProbe& probe = g_deviceProbes[iProbe];
+        if (probe.pAdapter)
+            AddAdapterTree(hTree, probe);
+    }
+
+    // WARP
+    DXGIDeviceProbe& warp = g_deviceProbes[g_numAdapterProbes];
+    if (warp.pDevice10_1 || warp.pDevice11 || warp.pDevice11_1 || warp.pDevice11_2 || warp.pDevice11_3 || warp.pDevice11_4 || warp.pDevice12
+        || warp.numTimedOut)
     {
         HTREEITEM hTreeW = TVAddNode(hTree, "Windows Advanced Rasterization Platform (WARP)", TRUE, IDI_CAPS, nullptr, 0, 0);
+        RegisterDevices(warp, hTreeW);
 
         // DirectX 12 (WARP)
-        if (pDeviceWARP12)
-            D3D12_FillTree(hTreeW, pDeviceWARP12, D3D_DRIVER_TYPE_WARP);
+        if (warp.pDevice12)
+            D3D12_FillTree(hTreeW, warp.pDevice12, D3D_DRIVER_TYPE_WARP);
 
         // DirectX 11.x (WARP)
-        if (pDeviceWARP11 || pDeviceWARP11_1 || pDeviceWARP11_2 || pDeviceWARP11_3)
+        if (warp.pDevice11 || warp.pDevice11_1 || warp.pDevice11_2 || warp.pDevice11_3)
         {
-            HTREEITEM hTree11 = (pDeviceWARP11_1 || pDeviceWARP11_2 || pDeviceWARP11_3)
+            HTREEITEM hTree11 = (warp.pDevice11_1 || warp.pDevice11_2 || warp.pDevice11_3)
                 ? TVAddNode(hTreeW, "Direct3D 11", TRUE, IDI_CAPS, nullptr, 0, 0)
                 : hTreeW;
 
-            if (pDeviceWARP11)
-                D3D11_FillTree(hTree11, pDeviceWARP11, flMaskWARP, D3D_DRIVER_TYPE_WARP);
+            if (warp.pDevice11)
+                D3D11_FillTree(hTree11, warp.pDevice11, warp.flMaskDX11, D3D_DRIVER_TYPE_WARP);
 
-            if (pDeviceWARP11_1)
-                D3D11_FillTree1(hTree11, pDeviceWARP11_1, flMaskWARP, D3D_DRIVER_TYPE_WARP);
+            if (warp.pDevice11_1)
+                D3D11_FillTree1(hTree11, warp.pDevice11_1, warp.flMaskDX11, D3D_DRIVER_TYPE_WARP);
 
-            if (pDeviceWARP11_2)
-                D3D11_FillTree2(hTree11, pDeviceWARP11_2, flMaskWARP, D3D_DRIVER_TYPE_WARP);
+            if (warp.pDevice11_2)
+                D3D11_FillTree2(hTree11, warp.pDevice11_2, warp.flMaskDX11, D3D_DRIVER_TYPE_WARP);
 
-            if (pDeviceWARP11_3)
-                D3D11_FillTree3(hTree11, pDeviceWARP11_3, pDeviceWARP11_4, flMaskWARP, D3D_DRIVER_TYPE_WARP);
+            if (warp.pDevice11_3)
+                D3D11_FillTree3(hTree11, warp.pDevice11_3, warp.pDevice11_4, warp.flMaskDX11, D3D_DRIVER_TYPE_WARP);
         }
 
         // DirectX 10.x (WARP)
-        if (pDeviceWARP10)
+        if (warp.pDevice10_1)
         {
             // WARP supported both 10 and 10.1 when first released
             HTREEITEM hTree10 = TVAddNode(hTreeW, "Direct3D 10", TRUE, IDI_CAPS, nullptr, 0, 0);
 
-            D3D10_FillTree(hTree10, pDeviceWARP10, D3D_DRIVER_TYPE_WARP);
-            D3D10_FillTree1(hTree10, pDeviceWARP10, flMaskWARP, D3D_DRIVER_TYPE_WARP);
+            D3D10_FillTree(hTree10, warp.pDevice10_1, D3D_DRIVER_TYPE_WARP);
+            D3D10_FillTree1(hTree10, warp.pDevice10_1, warp.flMaskDX10, D3D_DRIVER_TYPE_WARP);
         }
+
+        for (UINT i = 0; i < warp.numTimedOut; ++i)
+            WatchdogAddTimedOutNode(hTreeW, warp.strTimedOut[i]);
     }
 
     // REFERENCE
-    ID3D10Device1* pDeviceREF10_1 = nullptr;
-    ID3D10Device* pDeviceREF10 = nullptr;
-    if (g_D3D10CreateDevice1)
+    DXGIDeviceProbe& ref = g_deviceProbes[g_numAdapterProbes + 1];
+    if (ref.pDevice10 || ref.pDevice10_1 || ref.pDevice11 || ref.pDevice11_1 || ref.pDevice11_2 || ref.pDevice11_3
+        || ref.numTimedOut)
     {
-        hr = g_D3D10CreateDevice1(nullptr, D3D10_DRIVER_TYPE_REFERENCE, nullptr, 0, D3D10_FEATURE_LEVEL_10_1,
-            D3D10_1_SDK_VERSION, &pDeviceREF10_1);
-        if (SUCCEEDED(hr))
+        HTREEITEM hTreeR = TVAddNode(hTree, "Reference", TRUE, IDI_CAPS, nullptr, 0, 0);
+        RegisterDevices(ref, hTreeR);
+
+        // No REF for Direct3D 12
+
+        // Direct3D 11.x (REF)
+        if (ref.pDevice11 || ref.pDevice11_1 || ref.pDevice11_2 || ref.pDevice11_3)
         {
-            hr = pDeviceREF10_1->QueryInterface(IID_PPV_ARGS(&pDeviceREF10));
-            if (FAILED(hr))
-                pDeviceREF10 = nullptr;
+            HTREEITEM hTree11 = (ref.pDevice11_1 || ref.pDevice11_2 || ref.pDevice11_3)
+                ? TVAddNode(hTreeR, "Direct3D 11", TRUE, IDI_CAPS, nullptr, 0, 0)
+                : hTreeR;
+
+            if (ref.pDevice11)
+                D3D11_FillTree(hTree11, ref.pDevice11, ref.flMaskDX11, D3D_DRIVER_TYPE_REFERENCE);
+
+            if (ref.pDevice11_1)
+                D3D11_FillTree1(hTree11, ref.pDevice11_1, ref.flMaskDX11, D3D_DRIVER_TYPE_REFERENCE);
+
+            if (ref.pDevice11_2)
+                D3D11_FillTree2(hTree11, ref.pDevice11_2, ref.flMaskDX11, D3D_DRIVER_TYPE_REFERENCE);
+
+            if (ref.pDevice11_3)
+                D3D11_FillTree3(hTree11, ref.pDevice11_3, ref.pDevice11_4, ref.flMaskDX11, D3D_DRIVER_TYPE_REFERENCE);
         }
-        else
-            pDeviceREF10_1 = nullptr;
+
+        // Direct3D 10.x (REF)
+        if (ref.pDevice10 || ref.pDevice10_1)
+        {
+            HTREEITEM hTree10 = (ref.pDevice10_1)
+                ? TVAddNode(hTreeR, "Direct3D 10", TRUE, IDI_CAPS, nullptr, 0, 0)
+                : hTreeR;
+
+            if (ref.pDevice10)
+                D3D10_FillTree(hTree10, ref.pDevice10, D3D_DRIVER_TYPE_REFERENCE);
+
+            if (ref.pDevice10_1)
+                D3D10_FillTree1(hTree10, ref.pDevice10_1, ref.flMaskDX10, D3D_DRIVER_TYPE_REFERENCE);
+        }
+
+        for (UINT i = 0; i < ref.numTimedOut; ++i)
+            WatchdogAddTimedOutNode(hTreeR, ref.strTimedOut[i]);
     }
-    else if (g_D3D10CreateDevice != nullptr)
+
+    FreeDeviceProbes();
+
+    // Everything the nodes show will be kept with them, so the devices can go
+    ReleaseCapturedObjects(hwndTV);
+
+    TreeView_Expand(hwndTV, hTree, TVE_EXPAND);
+
+    // What a device change is compared against
+    if (hwndTV)
+        g_adapterWatch.Reset();
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXGI_UpdateAdapters()
+// Desc: Called every TIMER_PERIOD, with bCheck set after a device change
+//       notification. Removes the subtrees of the adapters that were removed
+//       or changed and starts re-probing those that were added or changed, so
+//       a hot-plug or driver update costs one adapter rather than the whole
+//       machine. The probes are waited out on the thread pool, and their
+//       subtrees added by DXGI_AddProbedAdapters once WM_ADAPTERSPROBED comes
+//       in. Returns TRUE with what changed if the tree did.
+//-----------------------------------------------------------------------------
+BOOL DXGI_UpdateAdapters(HWND hwndTV, BOOL bCheck, std::vector<ADAPTERCHANGE>& changes)
+{
+    changes.clear();
+
+    if (!hwndTV || !g_hTreeDXGI || !g_DXGIFactory)
+        return FALSE;
+
+    // Still probing, so look again once that's done
+    if (g_deviceProbes)
     {
-        hr = g_D3D10CreateDevice(nullptr, D3D10_DRIVER_TYPE_REFERENCE, nullptr, 0, D3D10_SDK_VERSION, &pDeviceREF10);
-        if (FAILED(hr))
-            pDeviceREF10 = nullptr;
+        g_bCheckPending |= bCheck;
+        return FALSE;
+    }
+
+    bCheck |= g_bCheckPending;
+    g_bCheckPending = FALSE;
+
+    // A factory goes on enumerating the adapters there were when it was created
+    if (g_DXGIFactory1 && !g_DXGIFactory1->IsCurrent())
+    {
+        ReleaseFactory();
+        CreateFactory();
+        if (!g_DXGIFactory)
+            return FALSE;
+
+        bCheck = TRUE;
     }
 
-    ID3D11Device* pDeviceREF11 = nullptr;
-    ID3D11Device1* pDeviceREF11_1 = nullptr;
-    ID3D11Device2* pDeviceREF11_2 = nullptr;
-    ID3D11Device3* pDeviceREF11_3 = nullptr;
-    ID3D11Device4* pDeviceREF11_4 = nullptr;
-    DWORD flMaskREF = FLMASK_9_1 | FLMASK_9_2 | FLMASK_9_3 | FLMASK_10_0 | FLMASK_10_1 | FLMASK_11_0;
-    if (g_D3D11CreateDevice)
+    if (!bCheck || !g_adapterWatch.Check(changes))
+        return FALSE;
+
+    UINT numProbes = 0;
+    for (const auto& change : changes)
     {
-        D3D_FEATURE_LEVEL lvl = D3D_FEATURE_LEVEL_11_1;
-        hr = g_D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_REFERENCE, nullptr, 0, &lvl, 1,
-            D3D11_SDK_VERSION, &pDeviceREF11, nullptr, nullptr);
+        if (change.kind != ADAPTER_ADDED)
+            RemoveAdapterTree(hwndTV, change.AdapterLuid);
 
-        if (SUCCEEDED(hr))
+        if (change.kind != ADAPTER_REMOVED)
+            ++numProbes;
+    }
+
+    // Probe the adapters together on the thread pool, as DXGI_BeginProbe does
+    if (numProbes > 0)
+    {
+        g_deviceProbes = new (std::nothrow) DXGIDeviceProbe[numProbes]();
+        g_probeTasks = new (std::nothrow) DXGIProbeTask[numProbes]();
+        if (g_deviceProbes && g_probeTasks)
         {
-            flMaskREF |= FLMASK_11_1;
-            hr = pDeviceREF11->QueryInterface(IID_PPV_ARGS(&pDeviceREF11_1));
-            if (FAILED(hr))
-                pDeviceREF11_1 = nullptr;
+            for (const auto& change : changes)
+            {
+                UINT iAdapter;
+                if (change.kind == ADAPTER_REMOVED || !FindAdapterIndex(change.AdapterLuid, iAdapter))
+                    continue;
 
-            hr = pDeviceREF11->QueryInterface(IID_PPV_ARGS(&pDeviceREF11_2));
-            if (FAILED(hr))
-                pDeviceREF11_2 = nullptr;
+                DXGIDeviceProbe& probe = g_deviceProbes[g_numAdapterProbes];
+                if (!InitAdapterProbe(iAdapter, probe))
+                    continue;
 
-            hr = pDeviceREF11->QueryInterface(IID_PPV_ARGS(&pDeviceREF11_3));
-            if (FAILED(hr))
-                pDeviceREF11_3 = nullptr;
+                ++g_numAdapterProbes;
+                AddProbeTask(probe, c_adapterApis);
+            }
 
-            hr = pDeviceREF11->QueryInterface(IID_PPV_ARGS(&pDeviceREF11_4));
-            if (FAILED(hr))
-                pDeviceREF11_4 = nullptr;
-        }
-        else
-        {
-            hr = g_D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_REFERENCE, nullptr, 0, nullptr, 0,
-                D3D11_SDK_VERSION, &pDeviceREF11, nullptr, nullptr);
-            if (SUCCEEDED(hr))
+            ++g_updateGeneration;
+            g_pUpdateWork = CreateThreadpoolWork(WaitForUpdateProbes,
+                reinterpret_cast<PVOID>(static_cast<UINT_PTR>(g_updateGeneration)), nullptr);
+            if (g_pUpdateWork)
             {
-                hr = pDeviceREF11->QueryInterface(IID_PPV_ARGS(&pDeviceREF11_1));
-                if (FAILED(hr))
-                    pDeviceREF11_1 = nullptr;
+                SubmitThreadpoolWork(g_pUpdateWork);
+                return TRUE;
             }
+
+            // No work item to wait on, so wait here
+            WaitForDeviceProbes();
         }
-    }
 
-    if (pDeviceREF10 || pDeviceREF10_1 || pDeviceREF11 || pDeviceREF11_1 || pDeviceREF11_2 || pDeviceREF11_3)
+        AddProbedAdapterTrees(hwndTV);
+    }
+    else
     {
-        HTREEITEM hTreeR = TVAddNode(hTree, "Reference", TRUE, IDI_CAPS, nullptr, 0, 0);
+        SortAdapterNodes(hwndTV);
+    }
 
-        // No REF for Direct3D 12
+    return TRUE;
+}
 
-        // Direct3D 11.x (REF)
-        if (pDeviceREF11 || pDeviceREF11_1 || pDeviceREF11_2 || pDeviceREF11_3)
-        {
-            HTREEITEM hTree11 = (pDeviceREF11_1 || pDeviceREF11_2 || pDeviceREF11_3)
-                ? TVAddNode(hTreeR, "Direct3D 11", TRUE, IDI_CAPS, nullptr, 0, 0)
-                : hTreeR;
 
-            if (pDeviceREF11)
-                D3D11_FillTree(hTree11, pDeviceREF11, flMaskREF, D3D_DRIVER_TYPE_REFERENCE);
+//-----------------------------------------------------------------------------
+// Name: DXGI_AddProbedAdapters()
+// Desc: Handles WM_ADAPTERSPROBED, adding the subtrees of the adapters the
+//       device change of that generation re-probed. Returns TRUE if the tree
+//       changed.
+//-----------------------------------------------------------------------------
+BOOL DXGI_AddProbedAdapters(HWND hwndTV, UINT generation)
+{
+    // Posted before a refresh threw the probes away
+    if (!g_pUpdateWork || generation != g_updateGeneration)
+        return FALSE;
 
-            if (pDeviceREF11_1)
-                D3D11_FillTree1(hTree11, pDeviceREF11_1, flMaskREF, D3D_DRIVER_TYPE_REFERENCE);
+    // The callback posted the message on its way out, so this is quick
+    CloseUpdateWork();
 
-            if (pDeviceREF11_2)
-                D3D11_FillTree2(hTree11, pDeviceREF11_2, flMaskREF, D3D_DRIVER_TYPE_REFERENCE);
+    AddProbedAdapterTrees(hwndTV);
+    return TRUE;
+}
 
-            if (pDeviceREF11_3)
-                D3D11_FillTree3(hTree11, pDeviceREF11_3, pDeviceREF11_4, flMaskREF, D3D_DRIVER_TYPE_REFERENCE);
-        }
 
-        // Direct3D 10.x (REF)
-        if (pDeviceREF10 || pDeviceREF10_1)
-        {
-            HTREEITEM hTree10 = (pDeviceREF10_1)
-                ? TVAddNode(hTreeR, "Direct3D 10", TRUE, IDI_CAPS, nullptr, 0, 0)
-                : hTreeR;
+//-----------------------------------------------------------------------------
+// Name: DXGI_CaptureNextSubtree()
+// Desc: Handles IDT_CAPTURE, capturing the next subtree that uses registered
+//       objects and releasing them. A subtree that can't be captured keeps its
+//       objects until exit. Returns FALSE once none are left, to stop the timer.
+//-----------------------------------------------------------------------------
+BOOL DXGI_CaptureNextSubtree(HWND hwndTV)
+{
+    for (COMREF* pRef = g_pComRefs; pRef; pRef = pRef->pNext)
+    {
+        if (!pRef->pObject || pRef->bKeep)
+            continue;
+
+        BOOL bCaptured = TVCaptureNodes(hwndTV, pRef->hOwner);
 
-            if (pDeviceREF10)
-                D3D10_FillTree(hTree10, pDeviceREF10, D3D_DRIVER_TYPE_REFERENCE);
+        HTREEITEM hOwner = pRef->hOwner;
+        for (COMREF* pOther = pRef; pOther; pOther = pOther->pNext)
+        {
+            if (pOther->hOwner != hOwner)
+                continue;
 
-            if (pDeviceREF10_1)
-                D3D10_FillTree1(hTree10, pDeviceREF10_1, FLMASK_10_0 | FLMASK_10_1, D3D_DRIVER_TYPE_REFERENCE);
+            if (bCaptured)
+                ReleaseObject(*pOther);
+            else
+                pOther->bKeep = TRUE;
         }
+
+        return TRUE;
     }
 
-    TreeView_Expand(hwndTV, hTree, TVE_EXPAND);
+    return FALSE;
 }
 
 
@@ -6360,16 +6675,24 @@ VOID DXGI_FillTree(HWND hwndTV)
 //-----------------------------------------------------------------------------
 VOID DXGI_CleanUp()
 {
-    if (g_DXGIFactory)
-    {
-        SAFE_RELEASE(g_DXGIFactory);
-        g_DXGIFactory = nullptr;
-        g_DXGIFactory1 = nullptr;
-        g_DXGIFactory2 = nullptr;
-        g_DXGIFactory3 = nullptr;
-        g_DXGIFactory4 = nullptr;
-        g_DXGIFactory5 = nullptr;
-    }
+    FreeFormatMatrices();
+    FreeFeatureOptions();
+
+    CloseUpdateWork();
+    g_bCheckPending = FALSE;
+
+    FreeDeviceProbes();
+
+    FreeObjectRegistry();
+
+    g_adapterNodes.clear();
+    g_hTreeDXGI = nullptr;
+
+    ReleaseFactory();
+
+    // A probe that hung may yet return into these
+    if (g_bProbesTimedOut)
+        return;
 
     if (g_dxgi)
     {
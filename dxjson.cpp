@@ -0,0 +1,370 @@
+//-----------------------------------------------------------------------------
+// Name: dxjson.cpp
+//
+// Desc: DirectX Capabilities Viewer JSON and NDJSON export
+//
+//       The tree is streamed out node by node as it is walked, so only one
+//       buffer's worth of the document is ever held in memory.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxview.h"
+#include "dxtrace.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+#define JSON_BUFFER_SIZE (64 * 1024)
+
+    const char* c_szKindNames[] =
+    {
+        "text",
+        "heading",
+        "string",
+        "value",
+        "hex",
+        "bool",
+        "version",
+        "float",
+    };
+
+    static_assert(std::size(c_szKindNames) == CAPKIND_FLOAT + 1, "Missing kind name");
+
+    //-----------------------------------------------------------------------------
+    // Name: JsonSink
+    // Desc: Writes the tree as a single JSON document, or as one NDJSON record
+    //       per capability row
+    //-----------------------------------------------------------------------------
+    struct JsonSink : public CAPSINK
+    {
+        HANDLE                      hFile;
+        BOOL                        bNDJSON;
+        BOOL                        fFailed;
+        BOOL                        bFirst;         // No sibling written yet at this level
+        DWORD                       dwOpenDepth;    // Nodes whose children are still open
+        std::vector<std::string>    path;           // Node names down to the current one
+        DWORD                       cbBuffer;
+        CHAR                        buffer[JSON_BUFFER_SIZE];
+
+        //-----------------------------------------------------------------------------
+        void Flush()
+        {
+            if (!cbBuffer)
+                return;
+
+            DWORD cbWritten = 0;
+            if (!WriteFile(hFile, buffer, cbBuffer, &cbWritten, nullptr) || (cbWritten != cbBuffer))
+                fFailed = TRUE;
+            cbBuffer = 0;
+        }
+
+        //-----------------------------------------------------------------------------
+        void Write(const char* pData, size_t cbData)
+        {
+            while (cbData > 0)
+            {
+                if (cbBuffer == JSON_BUFFER_SIZE)
+                    Flush();
+
+                DWORD cbCopy = static_cast<DWORD>(__min(cbData, static_cast<size_t>(JSON_BUFFER_SIZE - cbBuffer)));
+                memcpy(buffer + cbBuffer, pData, cbCopy);
+                cbBuffer += cbCopy;
+                pData += cbCopy;
+                cbData -= cbCopy;
+            }
+        }
+
+        void Write(const char* str) { Write(str, strlen(str)); }
+
+        //-----------------------------------------------------------------------------
+        void WriteNumber(const char* format, ...)
+        {
+            char szNumber[64];
+
+            va_list vl;
+            va_start(vl, format);
+            int cch = vsprintf_s(szNumber, sizeof(szNumber), format, vl);
+            va_end(vl);
+
+            if (cch > 0)
+                Write(szNumber, static_cast<size_t>(cch));
+        }
+
+        //-----------------------------------------------------------------------------
+        // Name: WriteString()
+        // Desc: Writes a quoted JSON string. The tool's text is in the ANSI code
+        //       page, so it's converted to UTF-8 on the way out.
+        //-----------------------------------------------------------------------------
+        void WriteString(const char* str)
+        {
+            Write("\"", 1);
+
+            // Sized by a first pass, as descriptions and driver strings run long
+            int cchWide = MultiByteToWideChar(CP_ACP, 0, str, -1, nullptr, 0);
+            std::vector<WCHAR> wszText((cchWide > 0) ? static_cast<size_t>(cchWide) : 1, L'\0');
+            if (cchWide <= 0
+                || MultiByteToWideChar(CP_ACP, 0, str, -1, wszText.data(), cchWide) != cchWide)
+            {
+                wszText[0] = L'\0';
+                cchWide = 1;
+            }
+
+            for (int i = 0; i < cchWide - 1; ++i)
+            {
+                WCHAR ch = wszText[i];
+                if (ch == L'"' || ch == L'\\')
+                {
+                    char esc[2] = { '\\', static_cast<char>(ch) };
+                    Write(esc, 2);
+                }
+                else if (ch < 0x20)
+                {
+                    WriteNumber("\\u%04X", ch);
+                }
+                else if (ch < 0x80)
+                {
+                    char c = static_cast<char>(ch);
+                    Write(&c, 1);
+                }
+                else
+                {
+                    // Keep surrogate pairs together
+                    int cchUnit = (IS_HIGH_SURROGATE(ch) && (i + 1 < cchWide - 1)) ? 2 : 1;
+
+                    char utf8[8];
+                    int cb = WideCharToMultiByte(CP_UTF8, 0, &wszText[i], cchUnit, utf8, sizeof(utf8), nullptr, nullptr);
+                    if (cb > 0)
+                        Write(utf8, static_cast<size_t>(cb));
+
+                    i += cchUnit - 1;
+                }
+            }
+
+            Write("\"", 1);
+        }
+
+        //-----------------------------------------------------------------------------
+        // Name: WriteTier()
+        // Desc: Picks the tier out of values such as "Optional (Yes - Tier 1.1)"
+        //-----------------------------------------------------------------------------
+        void WriteTier(const char* strValue)
+        {
+            const char* pTier = strstr(strValue, "Tier ");
+            if (!pTier)
+                return;
+
+            pTier += 5;
+            size_t cchTier = 0;
+            while (pTier[cchTier] && pTier[cchTier] != ')' && pTier[cchTier] != ' ')
+                ++cchTier;
+
+            if (!cchTier)
+                return;
+
+            Write(",\"tier\":");
+            WriteString(std::string(pTier, cchTier).c_str());
+        }
+
+        //-----------------------------------------------------------------------------
+        // Name: WriteRow()
+        // Desc: Writes the fields of a capability row, less the enclosing braces
+        //-----------------------------------------------------------------------------
+        void WriteRow(const CAPROW& row)
+        {
+            Write("\"kind\":\"");
+            Write(c_szKindNames[row.kind]);
+            Write("\"");
+
+            if (row.kind == CAPKIND_TEXT)
+            {
+                Write(",\"cells\":[");
+                for (size_t i = 0; i < row.cells.size(); ++i)
+                {
+                    if (i > 0)
+                        Write(",", 1);
+                    WriteString(row.cells[i].text.c_str());
+                }
+                Write("]");
+                return;
+            }
+
+            Write(",\"name\":");
+            WriteString(row.Name());
+
+            switch (row.kind)
+            {
+            case CAPKIND_STRING:
+                Write(",\"value\":");
+                WriteString(row.Value());
+                WriteTier(row.Value());
+                break;
+
+            case CAPKIND_VALUE:
+                WriteNumber(",\"value\":%u", row.value);
+                break;
+
+            case CAPKIND_HEX:
+                WriteNumber(",\"value\":%u,\"hex\":", row.value);
+                WriteString(row.Value());
+                break;
+
+            case CAPKIND_BOOL:
+                Write(row.value ? ",\"value\":true" : ",\"value\":false");
+                break;
+
+            case CAPKIND_VERSION:
+                Write(",\"value\":");
+                WriteString(row.Value());
+                WriteNumber(",\"major\":%u,\"minor\":%u", (row.value >> 8) & 0xFF, row.value & 0xFF);
+                break;
+
+            case CAPKIND_FLOAT:
+            {
+                float fValue;
+                memcpy(&fValue, &row.value, sizeof(fValue));
+                if (std::isfinite(fValue))
+                    WriteNumber(",\"value\":%.9g", static_cast<double>(fValue));
+                else
+                    Write(",\"value\":null");
+                break;
+            }
+
+            default:
+                break;
+            }
+        }
+
+        //-----------------------------------------------------------------------------
+        HRESULT OnNode(LPCSTR strText, DWORD dwDepth, const CAPMODEL* pModel) override
+        {
+            if (bNDJSON)
+            {
+                path.resize(dwDepth);
+                path.push_back(strText);
+
+                if (pModel)
+                {
+                    for (const auto& row : pModel->rows)
+                    {
+                        // Blank spacer lines carry nothing
+                        if (row.cells.empty())
+                            continue;
+
+                        Write("{\"path\":[");
+                        for (size_t i = 0; i < path.size(); ++i)
+                        {
+                            if (i > 0)
+                                Write(",", 1);
+                            WriteString(path[i].c_str());
+                        }
+                        Write("],");
+                        WriteRow(row);
+                        Write("}\n");
+                    }
+                }
+            }
+            else
+            {
+                // Close the children of any nodes we've climbed back out of
+                for (; dwOpenDepth > dwDepth; --dwOpenDepth)
+                {
+                    Write("]}");
+                    bFirst = FALSE;
+                }
+
+                if (!bFirst)
+                    Write(",\n");
+
+                Write("{\"name\":");
+                WriteString(strText);
+
+                if (pModel)
+                {
+                    Write(",\"caps\":[");
+                    BOOL bFirstRow = TRUE;
+                    for (const auto& row : pModel->rows)
+                    {
+                        if (row.cells.empty())
+                            continue;
+
+                        Write(bFirstRow ? "{" : ",{");
+                        WriteRow(row);
+                        Write("}");
+                        bFirstRow = FALSE;
+                    }
+                    Write("]");
+                }
+
+                Write(",\"children\":[");
+                dwOpenDepth = dwDepth + 1;
+                bFirst = TRUE;
+            }
+
+            return fFailed ? E_FAIL : S_OK;
+        }
+
+        //-----------------------------------------------------------------------------
+        void Finish()
+        {
+            if (!bNDJSON)
+            {
+                for (; dwOpenDepth > 0; --dwOpenDepth)
+                    Write("]}");
+                Write("]}\n");
+            }
+
+            Flush();
+        }
+    };
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_SaveJson()
+// Desc: Saves the whole tree, probing anything not yet expanded, as JSON or
+//       NDJSON. Uses the in-memory tree when hwndTV is nullptr.
+//-----------------------------------------------------------------------------
+BOOL DXView_SaveJson(HWND hwndTV, LPCTSTR strFile, BOOL bNDJSON)
+{
+    PROBESCOPE probeScope(PROBE_PHASE, "DXView_SaveJson", nullptr);
+
+    if (!strFile || !*strFile)
+        return FALSE;
+
+    auto pSink = new (std::nothrow) JsonSink;
+    if (!pSink)
+        return FALSE;
+
+    pSink->hFile = CreateFile(strFile, GENERIC_WRITE, 0, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (pSink->hFile == INVALID_HANDLE_VALUE)
+    {
+        delete pSink;
+        return FALSE;
+    }
+
+    pSink->bNDJSON = bNDJSON;
+    pSink->fFailed = FALSE;
+    pSink->bFirst = TRUE;
+    pSink->dwOpenDepth = 0;
+    pSink->cbBuffer = 0;
+
+    if (!bNDJSON)
+        pSink->Write("{\"nodes\":[\n");
+
+    HRESULT hr = TVWalkModels(hwndTV, pSink);
+    pSink->Finish();
+
+    BOOL fResult = SUCCEEDED(hr) && !pSink->fFailed;
+
+    CloseHandle(pSink->hFile);
+    delete pSink;
+
+    return fResult;
+}
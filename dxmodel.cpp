@@ -0,0 +1,459 @@
+//-----------------------------------------------------------------------------
+// Name: dxmodel.cpp
+//
+// Desc: DirectX Capabilities Viewer capability data model
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxmodel.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <new>
+#include <utility>
+
+
+//-----------------------------------------------------------------------------
+// Name: Append()
+// Desc: Adds the caps of another table after these
+//-----------------------------------------------------------------------------
+void CAPVECTOR::Append(const CAPVECTOR& other)
+{
+    for (uint32_t i = 0; i < other.numFlags; ++i, ++numFlags)
+    {
+        if (!(numFlags & 63))
+            bits.push_back(0);
+        if (other.Test(i))
+            bits.back() |= uint64_t(1) << (numFlags & 63);
+    }
+
+    scalars.insert(scalars.end(), other.scalars.begin(), other.scalars.end());
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CountSet()
+// Desc: Number of flags set
+//-----------------------------------------------------------------------------
+uint32_t CAPVECTOR::CountSet() const
+{
+    size_t count = 0;
+    for (uint64_t word : bits)
+        count += std::bitset<64>(word).count();
+    return static_cast<uint32_t>(count);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: operator==()
+// Desc: Unused bits of the last word are always clear, so the words can be
+//       compared directly
+//-----------------------------------------------------------------------------
+bool CAPVECTOR::operator==(const CAPVECTOR& other) const
+{
+    return numFlags == other.numFlags
+        && scalars.size() == other.scalars.size()
+        && (bits.empty() || !memcmp(bits.data(), other.bits.data(), bits.size() * sizeof(uint64_t)))
+        && (scalars.empty() || !memcmp(scalars.data(), other.scalars.data(), scalars.size() * sizeof(uint32_t)));
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: SetRowKind()
+// Desc: Tags the row being captured. The first tag wins, so PrintValueLine
+//       can tag a row before handing off to PrintStringValueLine.
+//-----------------------------------------------------------------------------
+void CAPMODEL::SetRowKind(CAPKIND kind, uint32_t value)
+{
+    if (rowOpen && current.kind != CAPKIND_TEXT)
+        return;
+
+    current.kind = kind;
+    current.value = value;
+    rowOpen = true;
+}
+
+
+//-----------------------------------------------------------------------------
+void CAPMODEL::AddCell(uint32_t x, const char* text, size_t cchText)
+{
+    CAPCELL cell;
+    cell.x = x;
+    if (text)
+        cell.text.assign(text, strnlen(text, cchText));
+
+    current.cells.push_back(std::move(cell));
+    rowOpen = true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: EndRow()
+// Desc: Completes the row being captured. Blank lines are kept as empty rows.
+//-----------------------------------------------------------------------------
+void CAPMODEL::EndRow()
+{
+    rows.push_back(std::move(current));
+    current = {};
+    rowOpen = false;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: Flush()
+// Desc: Completes a trailing row that was never ended with a new line
+//-----------------------------------------------------------------------------
+void CAPMODEL::Flush()
+{
+    if (rowOpen)
+        EndRow();
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: Serialize()
+// Desc: Appends the rows, caps and list. View options are stored so a cached
+//       model is only reused under the same ones.
+//-----------------------------------------------------------------------------
+void CAPMODEL::Serialize(std::vector<uint8_t>& out) const
+{
+    CapWriteU32(out, viewState);
+    CapWriteU32(out, view9Ex);
+    CapWriteU32(out, static_cast<uint32_t>(rows.size()));
+    for (const auto& row : rows)
+    {
+        CapWriteU32(out, row.kind);
+        CapWriteU32(out, row.value);
+        CapWriteU32(out, static_cast<uint32_t>(row.cells.size()));
+        for (const auto& cell : row.cells)
+        {
+            CapWriteU32(out, cell.x);
+            CapWriteString(out, cell.text.c_str(), cell.text.length());
+        }
+    }
+
+    CapWriteU32(out, caps.numFlags);
+    for (uint64_t word : caps.bits)
+    {
+        CapWriteU32(out, static_cast<uint32_t>(word));
+        CapWriteU32(out, static_cast<uint32_t>(word >> 32));
+    }
+    CapWriteU32(out, static_cast<uint32_t>(caps.scalars.size()));
+    for (uint32_t value : caps.scalars)
+        CapWriteU32(out, value);
+    CapWriteU32(out, capRows);
+
+    CapWriteU32(out, static_cast<uint32_t>(list.columns.size()));
+    for (const auto& column : list.columns)
+    {
+        CapWriteString(out, column.name.c_str(), column.name.length());
+        CapWriteU32(out, column.width);
+    }
+    CapWriteU32(out, static_cast<uint32_t>(list.rows.size()));
+    for (const auto& row : list.rows)
+    {
+        CapWriteU32(out, static_cast<uint32_t>(row.size()));
+        for (const auto& cell : row)
+        {
+            CapWriteU32(out, cell.col);
+            CapWriteString(out, cell.text.c_str(), cell.text.length());
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: Deserialize()
+// Desc: Reads back what Serialize wrote, advancing pData. Returns false on
+//       truncated or malformed data.
+//-----------------------------------------------------------------------------
+bool CAPMODEL::Deserialize(const uint8_t*& pData, const uint8_t* pEnd)
+{
+    uint32_t rowCount = 0;
+    if (!CapReadU32(pData, pEnd, viewState)
+        || !CapReadU32(pData, pEnd, view9Ex)
+        || !CapReadU32(pData, pEnd, rowCount))
+        return false;
+
+    // Each row takes at least 12 bytes, which bounds what a bad count can reserve
+    rows.clear();
+    rows.reserve(std::min(static_cast<size_t>(rowCount), static_cast<size_t>(pEnd - pData) / 12));
+    for (uint32_t i = 0; i < rowCount; ++i)
+    {
+        CAPROW row = {};
+        uint32_t kind = 0;
+        uint32_t cellCount = 0;
+        if (!CapReadU32(pData, pEnd, kind)
+            || !CapReadU32(pData, pEnd, row.value)
+            || !CapReadU32(pData, pEnd, cellCount))
+            return false;
+
+        if (kind > CAPKIND_FLOAT)
+            return false;
+        row.kind = static_cast<CAPKIND>(kind);
+        row.cells.reserve(std::min(static_cast<size_t>(cellCount), static_cast<size_t>(pEnd - pData) / 8));
+
+        for (uint32_t j = 0; j < cellCount; ++j)
+        {
+            CAPCELL cell;
+            if (!CapReadU32(pData, pEnd, cell.x)
+                || !CapReadString(pData, pEnd, cell.text))
+                return false;
+
+            row.cells.push_back(std::move(cell));
+        }
+
+        rows.push_back(std::move(row));
+    }
+
+    uint32_t numScalars = 0;
+    if (!CapReadU32(pData, pEnd, caps.numFlags))
+        return false;
+
+    size_t numWords = (static_cast<size_t>(caps.numFlags) + 63) / 64;
+    if (static_cast<size_t>(pEnd - pData) / 8 < numWords)
+        return false;
+
+    caps.bits.resize(numWords);
+    for (auto& word : caps.bits)
+    {
+        uint32_t lo = 0;
+        uint32_t hi = 0;
+        if (!CapReadU32(pData, pEnd, lo) || !CapReadU32(pData, pEnd, hi))
+            return false;
+        word = (static_cast<uint64_t>(hi) << 32) | lo;
+    }
+
+    if (!CapReadU32(pData, pEnd, numScalars)
+        || static_cast<size_t>(pEnd - pData) / 4 < numScalars)
+        return false;
+
+    caps.scalars.resize(numScalars);
+    for (auto& value : caps.scalars)
+    {
+        if (!CapReadU32(pData, pEnd, value))
+            return false;
+    }
+
+    if (!CapReadU32(pData, pEnd, capRows) || capRows > rows.size())
+        return false;
+
+    // Each column and cell takes at least 8 bytes, and each row 4
+    uint32_t numColumns = 0;
+    if (!CapReadU32(pData, pEnd, numColumns)
+        || static_cast<size_t>(pEnd - pData) / 8 < numColumns)
+        return false;
+
+    list.columns.resize(numColumns);
+    for (auto& column : list.columns)
+    {
+        if (!CapReadString(pData, pEnd, column.name)
+            || !CapReadU32(pData, pEnd, column.width))
+            return false;
+    }
+
+    uint32_t numListRows = 0;
+    if (!CapReadU32(pData, pEnd, numListRows)
+        || static_cast<size_t>(pEnd - pData) / 4 < numListRows)
+        return false;
+
+    list.rows.resize(numListRows);
+    for (auto& row : list.rows)
+    {
+        uint32_t numCells = 0;
+        if (!CapReadU32(pData, pEnd, numCells)
+            || static_cast<size_t>(pEnd - pData) / 8 < numCells)
+            return false;
+
+        row.resize(numCells);
+        for (auto& cell : row)
+        {
+            if (!CapReadU32(pData, pEnd, cell.col)
+                || !CapReadString(pData, pEnd, cell.text))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapReadSnapshotHeader()
+// Desc: Reads a snapshot's magic and key, advancing pData to its first node.
+//       version is the key's first value, so a snapshot from another build
+//       can be rejected before its nodes are read.
+//-----------------------------------------------------------------------------
+bool CapReadSnapshotHeader(const uint8_t*& pData, const uint8_t* pEnd, std::string& key, uint32_t& version)
+{
+    uint32_t magic = 0;
+    if (!CapReadU32(pData, pEnd, magic) || magic != CAPSNAPSHOT_MAGIC
+        || !CapReadString(pData, pEnd, key))
+        return false;
+
+    auto pKey = reinterpret_cast<const uint8_t*>(key.data());
+    return CapReadU32(pKey, pKey + key.size(), version);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapReadSnapshotNodes()
+// Desc: Reads every node up to pEnd. On failure nothing is returned and any
+//       models read so far are freed.
+//-----------------------------------------------------------------------------
+bool CapReadSnapshotNodes(const uint8_t*& pData, const uint8_t* pEnd, std::vector<CAPSNAPSHOTNODE>& nodes)
+{
+    std::vector<CAPSNAPSHOTNODE> read;
+    bool fResult = true;
+    while (pData < pEnd)
+    {
+        CAPSNAPSHOTNODE node = {};
+        uint32_t hasModel = 0;
+        if (!CapReadU32(pData, pEnd, node.depth)
+            || !CapReadString(pData, pEnd, node.text)
+            || !CapReadU32(pData, pEnd, hasModel)
+            || node.depth > (read.empty() ? 0 : read.back().depth + 1))
+        {
+            fResult = false;
+            break;
+        }
+
+        if (hasModel)
+        {
+            node.pModel = new (std::nothrow) CAPMODEL;
+            if (!node.pModel || !node.pModel->Deserialize(pData, pEnd))
+            {
+                delete node.pModel;
+                fResult = false;
+                break;
+            }
+        }
+
+        read.push_back(std::move(node));
+    }
+
+    if (!fResult || read.empty())
+    {
+        for (auto& node : read)
+            delete node.pModel;
+        return false;
+    }
+
+    nodes = std::move(read);
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapWriteSnapshotNode()
+// Desc: Appends a node, and its caps if it has any, as CapReadSnapshotNodes
+//       reads them
+//-----------------------------------------------------------------------------
+void CapWriteSnapshotNode(std::vector<uint8_t>& out, uint32_t depth, const char* text, size_t cchText, const CAPMODEL* pModel)
+{
+    CapWriteU32(out, depth);
+    CapWriteString(out, text, cchText);
+    CapWriteU32(out, pModel ? 1 : 0);
+    if (pModel)
+        pModel->Serialize(out);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapReadSnapshotAdapters()
+// Desc: Reads the adapters from a snapshot's key, in DXGI enumeration order.
+//       The layout is the one BuildCacheKey writes.
+//-----------------------------------------------------------------------------
+bool CapReadSnapshotAdapters(const std::string& key, std::vector<CAPSNAPSHOTADAPTER>& adapters)
+{
+    auto pData = reinterpret_cast<const uint8_t*>(key.data());
+    auto pEnd = pData + key.size();
+
+    // Version, OS version and build, executable timestamp and view options
+    uint32_t value = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        if (!CapReadU32(pData, pEnd, value))
+            return false;
+    }
+
+    uint32_t numAdapters = 0;
+    if (!CapReadU32(pData, pEnd, numAdapters)
+        || static_cast<size_t>(pEnd - pData) / 32 < numAdapters)
+        return false;
+
+    adapters.resize(numAdapters);
+    for (auto& adapter : adapters)
+    {
+        uint32_t luidLow = 0;
+        uint32_t luidHigh = 0;
+        uint32_t driverLow = 0;
+        uint32_t driverHigh = 0;
+        if (!CapReadU32(pData, pEnd, luidLow)
+            || !CapReadU32(pData, pEnd, luidHigh)
+            || !CapReadU32(pData, pEnd, adapter.vendorId)
+            || !CapReadU32(pData, pEnd, adapter.deviceId)
+            || !CapReadU32(pData, pEnd, adapter.subSysId)
+            || !CapReadU32(pData, pEnd, adapter.revision)
+            || !CapReadU32(pData, pEnd, driverLow)
+            || !CapReadU32(pData, pEnd, driverHigh))
+            return false;
+
+        adapter.driverVersion = (static_cast<uint64_t>(driverHigh) << 32) | driverLow;
+    }
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+void CapWriteU32(std::vector<uint8_t>& out, uint32_t value)
+{
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 24));
+}
+
+
+//-----------------------------------------------------------------------------
+void CapWriteString(std::vector<uint8_t>& out, const char* text, size_t cchText)
+{
+    CapWriteU32(out, static_cast<uint32_t>(cchText));
+    out.insert(out.end(), text, text + cchText);
+}
+
+
+//-----------------------------------------------------------------------------
+bool CapReadU32(const uint8_t*& pData, const uint8_t* pEnd, uint32_t& value)
+{
+    if (pEnd - pData < 4)
+        return false;
+
+    value = static_cast<uint32_t>(pData[0])
+        | (static_cast<uint32_t>(pData[1]) << 8)
+        | (static_cast<uint32_t>(pData[2]) << 16)
+        | (static_cast<uint32_t>(pData[3]) << 24);
+    pData += 4;
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+bool CapReadString(const uint8_t*& pData, const uint8_t* pEnd, std::string& text)
+{
+    uint32_t cchText = 0;
+    if (!CapReadU32(pData, pEnd, cchText))
+        return false;
+
+    if (static_cast<size_t>(pEnd - pData) < cchText)
+        return false;
+
+    text.assign(reinterpret_cast<const char*>(pData), cchText);
+    pData += cchText;
+    return true;
+}
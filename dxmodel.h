@@ -0,0 +1,149 @@
+//-----------------------------------------------------------------------------
+// Name: dxmodel.h
+//
+// Desc: DirectX Capabilities Viewer capability data model
+//
+//       Holds the rows a node's display callback produces so they can be
+//       probed once and then written to any number of outputs. Kept free of
+//       Windows dependencies.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum CAPKIND : uint32_t
+{
+    CAPKIND_TEXT = 0,       // Free-form line, possibly with several columns
+    CAPKIND_HEADING,        // Name with no value
+    CAPKIND_STRING,         // Name/value pair
+    CAPKIND_VALUE,          // Name/decimal value pair
+    CAPKIND_HEX,            // Name/hexadecimal value pair
+    CAPKIND_BOOL,           // Name/Yes or No, value is 0 or 1
+    CAPKIND_VERSION,        // Name/shader version, value is the D3DPS_VERSION encoding
+    CAPKIND_FLOAT,          // Name/float value, value holds the bits
+};
+
+struct CAPCELL
+{
+    uint32_t        x;          // Column in characters, relative to the node indent
+    std::string     text;
+};
+
+struct CAPROW
+{
+    CAPKIND                 kind;
+    uint32_t                value;  // Raw value for the typed kinds
+    std::vector<CAPCELL>    cells;
+
+    const char* Name() const { return cells.empty() ? "" : cells[0].text.c_str(); }
+    const char* Value() const { return (cells.size() < 2) ? "" : cells[1].text.c_str(); }
+};
+
+// The caps of one or more CAPDEF tables in canonical form: a bit per flag row
+// and the raw value of every other row, each in table order. Identical caps
+// give identical vectors regardless of view options.
+struct CAPVECTOR
+{
+    std::vector<uint64_t>   bits;
+    std::vector<uint32_t>   scalars;
+    uint32_t                numFlags;
+
+    CAPVECTOR() noexcept : numFlags(0) {}
+
+    bool Test(uint32_t iFlag) const { return ((bits[iFlag >> 6] >> (iFlag & 63)) & 1) != 0; }
+    void Append(const CAPVECTOR& other);
+    uint32_t CountSet() const;
+    bool operator==(const CAPVECTOR& other) const;
+    bool operator!=(const CAPVECTOR& other) const { return !(*this == other); }
+};
+
+// What a node shows in the viewer's list view: its columns, and rows of cells
+// each set for a column, in the order the display callback set them
+struct CAPLISTCOLUMN
+{
+    std::string     name;
+    uint32_t        width;      // In characters
+};
+
+struct CAPLISTCELL
+{
+    uint32_t        col;
+    std::string     text;
+};
+
+struct CAPLIST
+{
+    std::vector<CAPLISTCOLUMN>              columns;    // Empty if the list wasn't captured
+    std::vector<std::vector<CAPLISTCELL>>   rows;
+};
+
+struct CAPMODEL
+{
+    uint32_t                viewState;  // View options the rows were produced under
+    uint32_t                view9Ex;
+    std::vector<CAPROW>     rows;
+    CAPVECTOR               caps;       // Unfiltered caps behind the rows, if they came from CAPDEF tables
+    uint32_t                capRows;    // How many of the rows were printed from caps
+    CAPLIST                 list;       // The list view under the same options, kept for snapshots
+
+    CAPMODEL() noexcept : viewState(0), view9Ex(0), capRows(0), current{}, rowOpen(false) {}
+
+    // Every row was printed from caps, so equal caps give equal rows
+    bool IsAllCaps() const { return (caps.numFlags || !caps.scalars.empty()) && capRows == rows.size(); }
+
+    // Capture interface used by the Print* helpers
+    void SetRowKind(CAPKIND kind, uint32_t value);
+    void AddCell(uint32_t x, const char* text, size_t cchText);
+    void EndRow();
+    void Flush();
+
+    // Compact binary form used by the snapshot cache
+    void Serialize(std::vector<uint8_t>& out) const;
+    bool Deserialize(const uint8_t*& pData, const uint8_t* pEnd);
+
+private:
+    CAPROW  current;
+    bool    rowOpen;
+};
+
+// A node of a snapshot, in tree order (see CapReadSnapshotNodes)
+struct CAPSNAPSHOTNODE
+{
+    uint32_t        depth;
+    std::string     text;
+    CAPMODEL*       pModel;     // Caller owns this, null if the node has no caps
+};
+
+// An adapter as recorded in a snapshot's key
+struct CAPSNAPSHOTADAPTER
+{
+    uint32_t        vendorId;
+    uint32_t        deviceId;
+    uint32_t        subSysId;
+    uint32_t        revision;
+    uint64_t        driverVersion;  // UMD version, four 16-bit parts from most significant
+};
+
+// Snapshot files start with CAPSNAPSHOT_MAGIC and a key whose first value is
+// CAPSNAPSHOT_VERSION, followed by every node
+const uint32_t CAPSNAPSHOT_MAGIC = 0x43565844; // 'DXVC'
+const uint32_t CAPSNAPSHOT_VERSION = 5;
+
+bool CapReadSnapshotHeader(const uint8_t*& pData, const uint8_t* pEnd, std::string& key, uint32_t& version);
+bool CapReadSnapshotNodes(const uint8_t*& pData, const uint8_t* pEnd, std::vector<CAPSNAPSHOTNODE>& nodes);
+void CapWriteSnapshotNode(std::vector<uint8_t>& out, uint32_t depth, const char* text, size_t cchText, const CAPMODEL* pModel);
+bool CapReadSnapshotAdapters(const std::string& key, std::vector<CAPSNAPSHOTADAPTER>& adapters);
+
+// Little-endian primitives for the binary form
+void CapWriteU32(std::vector<uint8_t>& out, uint32_t value);
+void CapWriteString(std::vector<uint8_t>& out, const char* text, size_t cchText);
+bool CapReadU32(const uint8_t*& pData, const uint8_t* pEnd, uint32_t& value);
+bool CapReadString(const uint8_t*& pData, const uint8_t* pEnd, std::string& text);
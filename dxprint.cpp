@@ -9,6 +9,7 @@
 // https://go.microsoft.com/fwlink/?linkid=2136896
 //-----------------------------------------------------------------------------
 #include "dxview.h"
+#include "dxtrace.h"
 
 #include <Windowsx.h>
 #include <commdlg.h>
@@ -25,6 +26,12 @@ namespace
 
     DWORD iLastXPos = 0;
 
+    // Output to g_FileHandle is collected here and written in large blocks,
+    // since a whole tree is hundreds of thousands of very short writes
+    constexpr DWORD FILE_BUFFER_SIZE = 64 * 1024;
+    CHAR  g_FileBuffer[FILE_BUFFER_SIZE];
+    DWORD g_cbFileBuffer = 0;
+
     //-----------------------------------------------------------------------------
     // Local Prototypes
     //-----------------------------------------------------------------------------
@@ -83,6 +90,57 @@ namespace
     }
 
 
+    //-----------------------------------------------------------------------------
+    // Name: FlushFileBuffer()
+    // Desc: Write any buffered output out to the log file
+    //-----------------------------------------------------------------------------
+    BOOL FlushFileBuffer()
+    {
+        if (!g_cbFileBuffer)
+            return TRUE;
+
+        DWORD cbWritten = 0;
+        BOOL fResult = WriteFile(g_FileHandle, g_FileBuffer, g_cbFileBuffer, &cbWritten, nullptr)
+            && (cbWritten == g_cbFileBuffer);
+        g_cbFileBuffer = 0;
+        return fResult;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: WriteFileBuffered()
+    // Desc: Append text to the log file buffer, or cbData spaces when pData
+    //       is nullptr
+    //-----------------------------------------------------------------------------
+    BOOL WriteFileBuffered(_In_reads_opt_(cbData) const CHAR* pData, DWORD cbData)
+    {
+        while (cbData > 0)
+        {
+            if (g_cbFileBuffer == FILE_BUFFER_SIZE)
+            {
+                if (!FlushFileBuffer())
+                    return FALSE;
+            }
+
+            DWORD cbCopy = __min(cbData, FILE_BUFFER_SIZE - g_cbFileBuffer);
+            if (pData)
+            {
+                memcpy(g_FileBuffer + g_cbFileBuffer, pData, cbCopy);
+                pData += cbCopy;
+            }
+            else
+            {
+                memset(g_FileBuffer + g_cbFileBuffer, ' ', cbCopy);
+            }
+
+            g_cbFileBuffer += cbCopy;
+            cbData -= cbCopy;
+        }
+
+        return TRUE;
+    }
+
+
     //-----------------------------------------------------------------------------
     // Name: PrintStartPage
     // Desc: Check if we need to start a new page
@@ -160,6 +218,67 @@ namespace
     }
 
 
+    //-----------------------------------------------------------------------------
+    // Name: PrintNodeInfo()
+    // Desc: Print the caps associated with a tree node
+    //-----------------------------------------------------------------------------
+    HRESULT PrintNodeInfo(_In_opt_ NODEINFO* pni, _In_ PRINTCBINFO* pci)
+    {
+        if (!pni || !pni->fnDisplayCallback)
+            return S_OK;
+
+        const CAPMODEL* pModel = TVGetNodeModel(pni);
+        if (!pModel)
+            return E_FAIL;
+
+        // Force indent to offset node info from tree info
+        pci->dwCurrIndent += 2;
+
+        HRESULT hr = PrintCapModel(*pModel, pci);
+
+        // Recover indent
+        pci->dwCurrIndent -= 2;
+
+        return hr;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: TextFileSink
+    // Desc: Writes the tree in the same layout as PrintTreeStats does to a file
+    //-----------------------------------------------------------------------------
+    struct TextFileSink : public CAPSINK
+    {
+        PRINTCBINFO pci;
+
+        HRESULT OnNode(LPCSTR strText, DWORD dwDepth, const CAPMODEL* pModel) override
+        {
+            // Same truncation as the TreeView text buffer
+            DWORD cchLen = static_cast<DWORD>(_tcslen(strText));
+            cchLen = __min(cchLen, pci.dwCharsPerLine - 1);
+            if (!cchLen)
+                return S_OK;
+
+            pci.dwCurrIndent = dwDepth;
+
+            int xOffset = (int)(pci.dwCurrIndent * DEF_TAB_SIZE * pci.dwCharWidth);
+            int yOffset = (int)(pci.dwLineHeight * pci.dwCurrLine);
+
+            if (FAILED(PrintLine(xOffset, yOffset, strText, cchLen, &pci)))
+                return E_FAIL;
+
+            if (FAILED(PrintNextLine(&pci)))
+                return E_FAIL;
+
+            if (!pModel)
+                return S_OK;
+
+            pci.dwCurrIndent += 2;
+            return PrintCapModel(*pModel, &pci);
+        }
+    };
+
+
     //-----------------------------------------------------------------------------
     // Name: PrintStats()
     // Desc: Print user defined stuff
@@ -167,6 +286,9 @@ namespace
     BOOL CALLBACK PrintTreeStats(HINSTANCE hInstance, HWND hWnd, HWND hTreeWnd,
         HTREEITEM hRoot)
     {
+        // Includes the time spent in the print dialog
+        PROBESCOPE probeScope(PROBE_PHASE, "PrintTreeStats", nullptr);
+
         static DOCINFO  di;
         static PRINTDLG pd = {};
 
@@ -337,6 +459,7 @@ namespace
             }
             g_FileHandle = CreateFile(pstrFile, GENERIC_WRITE, 0, nullptr,
                 CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            g_cbFileBuffer = 0;
         }
         else
             if (StartDoc(pd.hDC, &di) < 0)
@@ -402,35 +525,10 @@ namespace
 
                         // Check if there is any additional node info 
                         // that needs to be printed
-                        if (tvi.lParam != 0)
+                        if (FAILED(PrintNodeInfo(reinterpret_cast<NODEINFO*>(tvi.lParam), &pci)))
                         {
-                            NODEINFO* pni = (NODEINFO*)tvi.lParam;
-
-                            if (pni && pni->fnDisplayCallback)
-                            {
-                                // Force indent to offset node info from tree info
-                                pci.dwCurrIndent += 2;
-
-                                if (pni->bUseLParam3)
-                                {
-                                    if (FAILED(((DISPLAYCALLBACKEX)(pni->fnDisplayCallback))(pni->lParam1, pni->lParam2, pni->lParam3, &pci)))
-                                    {
-                                        // Error, callback failed
-                                        goto lblCLEANUP;
-                                    }
-                                }
-                                else
-                                {
-                                    if (FAILED(pni->fnDisplayCallback(pni->lParam1, pni->lParam2, &pci)))
-                                    {
-                                        // Error, callback failed
-                                        goto lblCLEANUP;
-                                    }
-                                }
-
-                                // Recover indent
-                                pci.dwCurrIndent -= 2;
-                            }
+                            // Error, callback failed
+                            goto lblCLEANUP;
                         }
                     }
                 } // End if TreeView_GetItem()
@@ -444,6 +542,9 @@ namespace
                 // Get first child, if any
                 if (tvi.cChildren)
                 {
+                    // Probe any subtree that hasn't been expanded yet
+                    (void)TVExpandLazyNode(hTreeWnd, pci.hCurrTree);
+
                     // Get First child
                     HTREEITEM hTempTree = TreeView_GetChild(hTreeWnd, pci.hCurrTree);
                     if (hTempTree)
@@ -517,6 +618,8 @@ namespace
         {
             if (g_PrintToFile)
             {
+                if (!FlushFileBuffer())
+                    fResult = FALSE;
                 CloseHandle(g_FileHandle);
             }
             else
@@ -638,6 +741,50 @@ BOOL DXView_OnFile(HWND hWnd, HWND hTreeWnd, BOOL bPrintAll)
 }
 
 
+//-----------------------------------------------------------------------------
+// Name: DXView_OnHeadlessFile()
+// Desc: Save the in-memory tree built by a headless capture
+//-----------------------------------------------------------------------------
+BOOL DXView_OnHeadlessFile(LPCTSTR strFile)
+{
+    PROBESCOPE probeScope(PROBE_PHASE, "DXView_OnHeadlessFile", nullptr);
+
+    if (!strFile || !*strFile)
+        return FALSE;
+
+    g_PrintToFile = TRUE;
+
+    g_FileHandle = CreateFile(strFile, GENERIC_WRITE, 0, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (g_FileHandle == INVALID_HANDLE_VALUE)
+    {
+        g_FileHandle = nullptr;
+        return FALSE;
+    }
+
+    g_cbFileBuffer = 0;
+
+    TextFileSink sink;
+    sink.pci = {};
+    sink.pci.dwLineHeight = 1;
+    sink.pci.dwCharWidth = 1;
+    sink.pci.dwCharsPerLine = 80;
+    sink.pci.dwLinesPerPage = 66;
+    sink.pci.fStartPage = TRUE;
+    iLastXPos = 0;
+
+    HRESULT hr = TVWalkModels(nullptr, &sink);
+
+    if (!FlushFileBuffer())
+        hr = E_FAIL;
+
+    CloseHandle(g_FileHandle);
+    g_FileHandle = nullptr;
+
+    return SUCCEEDED(hr);
+}
+
+
 //-----------------------------------------------------------------------------
 // Name: PrintLine()
 // Desc: Prints text to page at specified location
@@ -649,6 +796,13 @@ HRESULT PrintLine(int xOffset, int yOffset, LPCTSTR pszBuff, size_t cchBuff,
     if (!pci)
         return E_FAIL;
 
+    if (pci->pModel)
+    {
+        if (pszBuff && cchBuff)
+            pci->pModel->AddCell(static_cast<uint32_t>(xOffset) / pci->dwCharWidth, pszBuff, cchBuff);
+        return S_OK;
+    }
+
     // Check if we need to start a new page
     if (FAILED(PrintStartPage(pci)))
         return E_FAIL;
@@ -660,20 +814,18 @@ HRESULT PrintLine(int xOffset, int yOffset, LPCTSTR pszBuff, size_t cchBuff,
     // Print text out to buffer current line
     if (g_PrintToFile)
     {
-        DWORD dwDummy;
-        TCHAR Temp[80];
-
         int offset = (xOffset - iLastXPos) / pci->dwCharWidth;
 
         if (offset < 0 || offset >= 80)
             return S_OK;
 
-        memset(Temp, ' ', sizeof(TCHAR) * 79);
-        Temp[offset] = 0;
-        WriteFile(g_FileHandle, Temp, (xOffset - iLastXPos) / pci->dwCharWidth, &dwDummy, nullptr);
+        // Pad out to the column
+        if (!WriteFileBuffered(nullptr, static_cast<DWORD>(offset)))
+            return E_FAIL;
         iLastXPos = (xOffset - iLastXPos) + (pci->dwCharWidth * static_cast<DWORD>(cchBuff));
 
-        WriteFile(g_FileHandle, pszBuff, static_cast<DWORD>(cchBuff), &dwDummy, nullptr);
+        if (!WriteFileBuffered(pszBuff, static_cast<DWORD>(cchBuff)))
+            return E_FAIL;
     }
     else
     {
@@ -691,13 +843,16 @@ HRESULT PrintLine(int xOffset, int yOffset, LPCTSTR pszBuff, size_t cchBuff,
 _Use_decl_annotations_
 HRESULT PrintNextLine(PRINTCBINFO* pci)
 {
-    if (g_PrintToFile)
+    if (pci && pci->pModel)
     {
-        DWORD dwDummy;
+        pci->pModel->EndRow();
+        return S_OK;
+    }
 
-        WriteFile(g_FileHandle, "\r\n", 2, &dwDummy, nullptr);
+    if (g_PrintToFile)
+    {
         iLastXPos = 0;
-        return S_OK;
+        return WriteFileBuffered("\r\n", 2) ? S_OK : E_FAIL;
     }
 
     if (!pci)
@@ -711,3 +866,33 @@ HRESULT PrintNextLine(PRINTCBINFO* pci)
 
     return S_OK;
 }
+
+
+//-----------------------------------------------------------------------------
+// Name: PrintCapModel()
+// Desc: Prints the rows of a node's caps at the current indent
+//-----------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT PrintCapModel(const CAPMODEL& model, PRINTCBINFO* pci)
+{
+    if (!pci)
+        return E_FAIL;
+
+    const DWORD xIndent = pci->dwCurrIndent * DEF_TAB_SIZE;
+    for (const auto& row : model.rows)
+    {
+        int yLine = (int)(pci->dwCurrLine * pci->dwLineHeight);
+        for (const auto& cell : row.cells)
+        {
+            int xCell = (int)((xIndent + cell.x) * pci->dwCharWidth);
+            if (FAILED(PrintLine(xCell, yLine, cell.text.c_str(), cell.text.length(), pci)))
+                return E_FAIL;
+        }
+
+        // Advance to next line on page
+        if (FAILED(PrintNextLine(pci)))
+            return E_FAIL;
+    }
+
+    return S_OK;
+}
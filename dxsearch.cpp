@@ -0,0 +1,365 @@
+//-----------------------------------------------------------------------------
+// Name: dxsearch.cpp
+//
+// Desc: DirectX Capabilities Viewer full-text search
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxsearch.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+    // Only ASCII letters and digits make up words, whatever the locale
+    bool IsLower(char ch) { return ch >= 'a' && ch <= 'z'; }
+    bool IsUpper(char ch) { return ch >= 'A' && ch <= 'Z'; }
+    bool IsWordChar(char ch) { return IsLower(ch) || IsUpper(ch) || (ch >= '0' && ch <= '9'); }
+
+    //-----------------------------------------------------------------------------
+    // Name: IsWordBreak()
+    // Desc: A new word starts at a capital after a lower-case letter, as in
+    //       MaxTexture, or at the last capital of a run followed by lower-case,
+    //       as in UAVLoad
+    //-----------------------------------------------------------------------------
+    bool IsWordBreak(const char* pText, size_t i, size_t cchText)
+    {
+        if (!IsUpper(pText[i]))
+            return false;
+
+        if (IsLower(pText[i - 1]))
+            return true;
+
+        return IsUpper(pText[i - 1]) && (i + 1 < cchText) && IsLower(pText[i + 1]);
+    }
+
+    //-----------------------------------------------------------------------------
+    void AddWord(const char* pWord, size_t cchWord, std::vector<std::string>& words)
+    {
+        words.emplace_back(pWord, cchWord);
+        for (auto& ch : words.back())
+        {
+            if (IsUpper(ch))
+                ch = static_cast<char>(ch - 'A' + 'a');
+        }
+    }
+
+    // One-character queries are answered from CAPSEARCHINDEX::charMatches
+    const size_t NUM_SEARCH_CHARS = 36;
+
+    size_t CharSlot(char ch)
+    {
+        return (ch >= '0' && ch <= '9') ? static_cast<size_t>(ch - '0') : static_cast<size_t>(ch - 'a' + 10);
+    }
+
+    //-----------------------------------------------------------------------------
+    void SetRange(std::vector<uint64_t>& bits, uint32_t first, uint32_t last)
+    {
+        while (first < last && (first & 63))
+        {
+            bits[first >> 6] |= 1ull << (first & 63);
+            ++first;
+        }
+
+        for (; first + 64 <= last; first += 64)
+            bits[first >> 6] = ~0ull;
+
+        for (; first < last; ++first)
+            bits[first >> 6] |= 1ull << (first & 63);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapSearchWords()
+// Desc: Splits text at anything other than a letter or digit, and again where
+//       the case changes. A run that was split by case is also added whole, so
+//       "typeduav" finds TypedUAV too.
+//-----------------------------------------------------------------------------
+void CapSearchWords(const char* pText, size_t cchText, std::vector<std::string>& words)
+{
+    words.clear();
+
+    size_t i = 0;
+    while (i < cchText)
+    {
+        if (!IsWordChar(pText[i]))
+        {
+            ++i;
+            continue;
+        }
+
+        size_t runStart = i;
+        size_t wordStart = i;
+        for (++i; i < cchText && IsWordChar(pText[i]); ++i)
+        {
+            if (IsWordBreak(pText, i, cchText))
+            {
+                AddWord(pText + wordStart, i - wordStart, words);
+                wordStart = i;
+            }
+        }
+
+        AddWord(pText + wordStart, i - wordStart, words);
+        if (wordStart != runStart)
+            AddWord(pText + runStart, i - runStart, words);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CAPSEARCHINDEX::Build()
+// Desc: Lists every node and row as an entry, then the entries each word
+//       appears in
+//-----------------------------------------------------------------------------
+void CAPSEARCHINDEX::Build(const std::vector<CAPSNAPSHOTNODE>& nodes)
+{
+    Clear();
+
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;   // Word id and entry
+    std::vector<std::string> found;
+    auto addText = [&](const std::string& text, uint32_t entry)
+    {
+        CapSearchWords(text.data(), text.size(), found);
+        for (auto& word : found)
+        {
+            auto it = ids.emplace(std::move(word), static_cast<uint32_t>(ids.size())).first;
+            pairs.emplace_back(it->second, entry);
+        }
+    };
+
+    // Nodes whose subtree hasn't ended yet, by depth
+    std::vector<uint32_t> open;
+    for (uint32_t iNode = 0; iNode < nodes.size(); ++iNode)
+    {
+        const CAPSNAPSHOTNODE& node = nodes[iNode];
+        auto entry = static_cast<uint32_t>(entries.size());
+
+        while (open.size() > node.depth)
+        {
+            subtreeEnd[open.back()] = entry;
+            open.pop_back();
+        }
+        open.push_back(entry);
+
+        entries.push_back({ iNode, CAPSEARCH_NODE });
+        subtreeEnd.push_back(entry + 1);
+        addText(node.text, entry);
+
+        if (!node.pModel)
+            continue;
+
+        const auto& rows = node.pModel->rows;
+        for (uint32_t iRow = 0; iRow < rows.size(); ++iRow)
+        {
+            entry = static_cast<uint32_t>(entries.size());
+            entries.push_back({ iNode, iRow });
+            subtreeEnd.push_back(entry + 1);
+            for (const auto& cell : rows[iRow].cells)
+                addText(cell.text, entry);
+        }
+    }
+
+    for (uint32_t entry : open)
+        subtreeEnd[entry] = static_cast<uint32_t>(entries.size());
+
+    // Number the words in sorted order so a prefix is a contiguous range of them
+    std::vector<const std::string*> sorted(ids.size());
+    for (const auto& id : ids)
+        sorted[id.second] = &id.first;
+
+    std::vector<uint32_t> order(ids.size());
+    for (uint32_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&sorted](uint32_t a, uint32_t b) { return *sorted[a] < *sorted[b]; });
+
+    std::vector<uint32_t> rank(ids.size());
+    words.reserve(order.size());
+    for (uint32_t i = 0; i < order.size(); ++i)
+    {
+        rank[order[i]] = i;
+        words.push_back(*sorted[order[i]]);
+    }
+
+    for (auto& pair : pairs)
+        pair.first = rank[pair.first];
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    firstPosting.assign(words.size() + 1, 0);
+    postings.reserve(pairs.size());
+    for (const auto& pair : pairs)
+    {
+        ++firstPosting[pair.first + 1];
+        postings.push_back(pair.second);
+    }
+
+    for (size_t i = 1; i < firstPosting.size(); ++i)
+        firstPosting[i] += firstPosting[i - 1];
+
+    // Typing a query always starts with one character, which is also the
+    // slowest to match, so those are matched up front
+    size_t numBits = (entries.size() + 63) / 64;
+    charMatches.assign(NUM_SEARCH_CHARS * numBits, 0);
+
+    std::vector<uint64_t> matches;
+    auto lo = words.begin();
+    for (char ch : std::string("0123456789abcdefghijklmnopqrstuvwxyz"))
+    {
+        lo = std::lower_bound(lo, words.end(), std::string(1, ch));
+        auto hi = std::lower_bound(lo, words.end(), std::string(1, static_cast<char>(ch + 1)));
+        MatchWords(static_cast<size_t>(lo - words.begin()), static_cast<size_t>(hi - words.begin()), matches);
+        std::copy(matches.begin(), matches.end(), charMatches.begin() + static_cast<ptrdiff_t>(CharSlot(ch) * numBits));
+        lo = hi;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+void CAPSEARCHINDEX::Clear()
+{
+    entries.clear();
+    words.clear();
+    firstPosting.clear();
+    postings.clear();
+    subtreeEnd.clear();
+    charMatches.clear();
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CAPSEARCHINDEX::MatchWords()
+// Desc: The entries containing any of words [iFirst, iLast), along with
+//       everything below any node among them
+//-----------------------------------------------------------------------------
+void CAPSEARCHINDEX::MatchWords(size_t iFirst, size_t iLast, std::vector<uint64_t>& matches) const
+{
+    matches.assign((entries.size() + 63) / 64, 0);
+
+    for (uint32_t i = firstPosting[iFirst]; i < firstPosting[iLast]; ++i)
+    {
+        uint32_t entry = postings[i];
+        if (entries[entry].row == CAPSEARCH_NODE)
+            SetRange(matches, entry, subtreeEnd[entry]);
+        else
+            matches[entry >> 6] |= 1ull << (entry & 63);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CAPSEARCHINDEX::Find()
+// Desc: The entries matching every word of the query. Each word matches the
+//       words it starts, which are a contiguous range as they're sorted.
+//-----------------------------------------------------------------------------
+void CAPSEARCHINDEX::Find(const char* strQuery, std::vector<uint64_t>& matches) const
+{
+    size_t numBits = (entries.size() + 63) / 64;
+    matches.assign(numBits, 0);
+
+    std::vector<std::string> query;
+    CapSearchWords(strQuery, strlen(strQuery), query);
+    if (query.empty() || words.empty())
+        return;
+
+    std::sort(query.begin(), query.end());
+    query.erase(std::unique(query.begin(), query.end()), query.end());
+
+    std::vector<uint64_t> wordMatches;
+    for (size_t i = 0; i < query.size(); ++i)
+    {
+        const std::string& word = query[i];
+        if (word.size() == 1)
+        {
+            auto pChar = charMatches.begin() + static_cast<ptrdiff_t>(CharSlot(word[0]) * numBits);
+            wordMatches.assign(pChar, pChar + static_cast<ptrdiff_t>(numBits));
+        }
+        else
+        {
+            // Words are only letters and digits, which all sort ahead of '{'
+            auto lo = std::lower_bound(words.begin(), words.end(), word);
+            auto hi = std::lower_bound(lo, words.end(), word + '{');
+            MatchWords(static_cast<size_t>(lo - words.begin()), static_cast<size_t>(hi - words.begin()), wordMatches);
+        }
+
+        if (!i)
+        {
+            matches.swap(wordMatches);
+            continue;
+        }
+
+        uint64_t any = 0;
+        for (size_t j = 0; j < numBits; ++j)
+        {
+            matches[j] &= wordMatches[j];
+            any |= matches[j];
+        }
+
+        if (!any)
+            break;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapSearchNext()
+//-----------------------------------------------------------------------------
+bool CapSearchNext(const std::vector<uint64_t>& matches, uint32_t start, bool bBackward, uint32_t& entry)
+{
+    size_t numBits = matches.size();
+    if (!numBits)
+        return false;
+
+    // Past the end wraps around
+    uint64_t end = numBits * 64;
+    if (start >= end)
+        start = bBackward ? static_cast<uint32_t>(end - 1) : 0;
+
+    size_t iStart = start >> 6;
+    for (size_t n = 0; n <= numBits; ++n)
+    {
+        size_t i = bBackward ? (iStart + numBits - n) % numBits : (iStart + n) % numBits;
+        uint64_t bits = matches[i];
+
+        // Only the bits on the right side of start count the first time around
+        if (n == 0)
+        {
+            uint32_t bit = start & 63;
+            bits &= bBackward ? (~0ull >> (63 - bit)) : (~0ull << bit);
+        }
+        else if (n == numBits)
+        {
+            uint32_t bit = start & 63;
+            bits &= bBackward ? ~(~0ull >> (63 - bit)) : ~(~0ull << bit);
+        }
+
+        if (!bits)
+            continue;
+
+        uint32_t bit = bBackward ? 63 : 0;
+        while (!((bits >> bit) & 1))
+            bBackward ? --bit : ++bit;
+
+        entry = static_cast<uint32_t>(i * 64 + bit);
+        return true;
+    }
+
+    return false;
+}
+
+
+//-----------------------------------------------------------------------------
+uint32_t CapSearchCount(const std::vector<uint64_t>& matches)
+{
+    size_t count = 0;
+    for (uint64_t bits : matches)
+        count += std::bitset<64>(bits).count();
+    return static_cast<uint32_t>(count);
+}
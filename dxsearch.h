@@ -0,0 +1,59 @@
+//-----------------------------------------------------------------------------
+// Name: dxsearch.h
+//
+// Desc: DirectX Capabilities Viewer full-text search
+//
+//       An inverted index over the node names, row names and values of a
+//       snapshot. Text is split into lower-case words, also where the case
+//       changes inside a word, so "typed uav load" finds
+//       TypedUAVLoadAdditionalFormats and "bc7" finds DXGI_FORMAT_BC7_UNORM.
+//       Each word of a query matches any word it starts, and a word found in
+//       a node's name matches everything below the node as well, so
+//       "direct3d 12 typed uav" only finds rows under Direct3D 12 nodes.
+//       Kept free of Windows dependencies.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include "dxmodel.h"
+
+const uint32_t CAPSEARCH_NODE = 0xFFFFFFFF;
+
+struct CAPSEARCHENTRY
+{
+    uint32_t        node;       // Into the nodes the index was built from
+    uint32_t        row;        // Into the node's model, or CAPSEARCH_NODE for the node's name
+};
+
+struct CAPSEARCHINDEX
+{
+    std::vector<CAPSEARCHENTRY>     entries;    // Each node followed by its rows, in tree order
+
+    // The nodes must stay as they are for as long as the entries are used
+    void Build(const std::vector<CAPSNAPSHOTNODE>& nodes);
+    void Clear();
+
+    // Sets a bit per matching entry
+    void Find(const char* strQuery, std::vector<uint64_t>& matches) const;
+
+private:
+    void MatchWords(size_t iFirst, size_t iLast, std::vector<uint64_t>& matches) const;
+
+    std::vector<std::string>    words;          // Sorted
+    std::vector<uint32_t>       firstPosting;   // Into postings for each word, and one past the last
+    std::vector<uint32_t>       postings;       // Entries that contain each word, ascending
+    std::vector<uint32_t>       subtreeEnd;     // Entry after everything below each entry
+    std::vector<uint64_t>       charMatches;    // Matches for each one-character query, see Find
+};
+
+// Lower-case words of text, as the index splits them
+void CapSearchWords(const char* pText, size_t cchText, std::vector<std::string>& words);
+
+// First matching entry at or after start, or at or before it when bBackward,
+// wrapping around. Returns false when nothing matches.
+bool CapSearchNext(const std::vector<uint64_t>& matches, uint32_t start, bool bBackward, uint32_t& entry);
+uint32_t CapSearchCount(const std::vector<uint64_t>& matches);
@@ -0,0 +1,201 @@
+//-----------------------------------------------------------------------------
+// Name: dxshard.cpp
+//
+// Desc: DirectX Capabilities Viewer probe worker shards
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxshard.h"
+
+#include <cstring>
+#include <new>
+
+namespace
+{
+    //-----------------------------------------------------------------------------
+    uint64_t ShardChecksum(const uint8_t* pData, size_t cbData)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < cbData; ++i)
+        {
+            hash ^= pData[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // A top-level node of the merged snapshot, and what each shard put under it
+    struct MERGEDPIECE
+    {
+        const CAPSNAPSHOTNODE*  pFirst;     // Null for a failed shard
+        const CAPSNAPSHOTNODE*  pEnd;
+        std::string             failed;     // Stands in for the failed shard's nodes
+    };
+
+    struct MERGEDROOT
+    {
+        std::string                 text;
+        const CAPMODEL*             pModel; // From the first shard that had the node
+        std::vector<MERGEDPIECE>    pieces;
+    };
+
+    //-----------------------------------------------------------------------------
+    MERGEDROOT& FindRoot(std::vector<MERGEDROOT>& roots, const std::string& text)
+    {
+        for (auto& root : roots)
+        {
+            if (root.text == text)
+                return root;
+        }
+
+        roots.push_back({ text, nullptr, {} });
+        return roots.back();
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapShardInit()
+// Desc: Readies a region for a worker, before the worker is started
+//-----------------------------------------------------------------------------
+void CapShardInit(void* pRegion, size_t cbRegion)
+{
+    if (cbRegion < CAPSHARD_MIN_REGION)
+        return;
+
+    auto pHeader = new (pRegion) CAPSHARDHEADER;
+    pHeader->magic = CAPSHARD_MAGIC;
+    pHeader->state.store(CAPSHARD_EMPTY);
+    pHeader->cbData = 0;
+    pHeader->checksum = 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapShardWrite()
+// Desc: Called by the worker with its snapshot. Returns false if the region
+//       wasn't readied or is too small, which leaves the shard failed.
+//-----------------------------------------------------------------------------
+bool CapShardWrite(void* pRegion, size_t cbRegion, const std::vector<uint8_t>& data)
+{
+    if (cbRegion < CAPSHARD_MIN_REGION || data.size() > cbRegion - CAPSHARD_MIN_REGION)
+        return false;
+
+    auto pHeader = static_cast<CAPSHARDHEADER*>(pRegion);
+    if (pHeader->magic != CAPSHARD_MAGIC)
+        return false;
+
+    pHeader->state.store(CAPSHARD_WRITING);
+
+    // The payload is bytes past the header; a CAPSHARDHEADER* destination
+    // would have memcpy write "into" a type with an atomic (-Wclass-memaccess)
+    if (!data.empty())
+        memcpy(reinterpret_cast<uint8_t*>(pHeader) + sizeof(CAPSHARDHEADER), data.data(), data.size());
+    pHeader->cbData = data.size();
+    pHeader->checksum = ShardChecksum(data.data(), data.size());
+
+    // Publishes everything above
+    pHeader->state.store(CAPSHARD_DONE, std::memory_order_release);
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapShardLoad()
+// Desc: Called by the parent once the worker has exited
+//-----------------------------------------------------------------------------
+CAPSHARDRESULT CapShardLoad(const void* pRegion, size_t cbRegion, CAPSNAPSHOT& snapshot)
+{
+    snapshot.Clear();
+
+    if (cbRegion < CAPSHARD_MIN_REGION)
+        return CAPSHARD_FAILED;
+
+    auto pHeader = static_cast<const CAPSHARDHEADER*>(pRegion);
+    if (pHeader->magic != CAPSHARD_MAGIC
+        || pHeader->state.load(std::memory_order_acquire) != CAPSHARD_DONE
+        || pHeader->cbData > cbRegion - CAPSHARD_MIN_REGION)
+        return CAPSHARD_FAILED;
+
+    auto pData = reinterpret_cast<const uint8_t*>(pHeader) + sizeof(CAPSHARDHEADER);
+    auto cbData = static_cast<size_t>(pHeader->cbData);
+    if (ShardChecksum(pData, cbData) != pHeader->checksum)
+        return CAPSHARD_FAILED;
+
+    if (snapshot.Load(pData, cbData))
+        return CAPSHARD_OK;
+
+    // Snapshots with no nodes don't load, but are what a worker with nothing
+    // to probe writes
+    const uint8_t* pEnd = pData + cbData;
+    uint32_t version = 0;
+    if (CapReadSnapshotHeader(pData, pEnd, snapshot.key, version)
+        && version == CAPSNAPSHOT_VERSION && pData == pEnd)
+        return CAPSHARD_OK;
+
+    snapshot.Clear();
+    return CAPSHARD_FAILED;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: CapMergeShards()
+// Desc: The shards are ordered as the tree is filled in process, so the
+//       merged tree reads the same as one probed without workers. A failed
+//       shard gets a node under its root saying why.
+//-----------------------------------------------------------------------------
+void CapMergeShards(const CAPSHARD* pShards, size_t numShards, const std::string& key, std::vector<uint8_t>& data)
+{
+    std::vector<MERGEDROOT> roots;
+    for (size_t iShard = 0; iShard < numShards; ++iShard)
+    {
+        const CAPSHARD& shard = pShards[iShard];
+        if (shard.result != CAPSHARD_OK)
+        {
+            std::string failed = shard.name;
+            failed += (shard.result == CAPSHARD_TIMEDOUT) ? " (timed out)" : " (worker failed)";
+            FindRoot(roots, shard.root).pieces.push_back({ nullptr, nullptr, std::move(failed) });
+            continue;
+        }
+
+        const auto& nodes = shard.snapshot.nodes;
+        for (size_t i = 0; i < nodes.size(); )
+        {
+            MERGEDROOT& root = FindRoot(roots, nodes[i].text);
+            if (!root.pModel)
+                root.pModel = nodes[i].pModel;
+
+            size_t iEnd = i + 1;
+            while (iEnd < nodes.size() && nodes[iEnd].depth > 0)
+                ++iEnd;
+
+            if (iEnd > i + 1)
+                root.pieces.push_back({ nodes.data() + i + 1, nodes.data() + iEnd, {} });
+            i = iEnd;
+        }
+    }
+
+    data.clear();
+    CapWriteU32(data, CAPSNAPSHOT_MAGIC);
+    CapWriteString(data, key.data(), key.size());
+
+    for (const auto& root : roots)
+    {
+        CapWriteSnapshotNode(data, 0, root.text.data(), root.text.size(), root.pModel);
+
+        for (const auto& piece : root.pieces)
+        {
+            if (!piece.pFirst)
+            {
+                CapWriteSnapshotNode(data, 1, piece.failed.data(), piece.failed.size(), nullptr);
+                continue;
+            }
+
+            for (auto pNode = piece.pFirst; pNode != piece.pEnd; ++pNode)
+                CapWriteSnapshotNode(data, pNode->depth, pNode->text.data(), pNode->text.size(), pNode->pModel);
+        }
+    }
+}
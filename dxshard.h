@@ -0,0 +1,74 @@
+//-----------------------------------------------------------------------------
+// Name: dxshard.h
+//
+// Desc: DirectX Capabilities Viewer probe worker shards
+//
+//       With -workers the probing is split into shards, one per DXGI adapter
+//       and one per older API, each probed by a child process of its own so a
+//       driver that crashes or hangs only costs its own shard. A worker writes
+//       its part of the tree in snapshot form into a region of memory shared
+//       with the parent, and the parent merges the shards back into a single
+//       snapshot. Kept free of Windows dependencies so the protocol can be
+//       exercised with fake workers anywhere (see dxcapsshard).
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include "dxdiff.h"
+
+#include <atomic>
+
+enum CAPSHARDSTATE : uint32_t
+{
+    CAPSHARD_EMPTY = 0,     // The worker hasn't written anything
+    CAPSHARD_WRITING,       // Left this way by a worker that died mid-write
+    CAPSHARD_DONE,
+};
+
+// The start of a shard's region, followed by the snapshot. The parent clears
+// it before starting the worker and only reads it once the worker has exited.
+struct CAPSHARDHEADER
+{
+    uint32_t                magic;
+    std::atomic<uint32_t>   state;      // CAPSHARDSTATE
+    uint64_t                cbData;
+    uint64_t                checksum;   // FNV-1a of the snapshot, so a stray write is caught
+};
+
+const uint32_t CAPSHARD_MAGIC = 0x53565844; // 'DXVS'
+
+enum CAPSHARDRESULT : uint32_t
+{
+    CAPSHARD_OK = 0,
+    CAPSHARD_FAILED,        // The worker died, or left something unreadable
+    CAPSHARD_TIMEDOUT,      // The worker was killed for running too long
+};
+
+// What the parent knows of a shard, and what its worker wrote
+struct CAPSHARD
+{
+    std::string     root;       // Top-level node the shard's nodes belong under, as "DXGI Devices"
+    std::string     name;       // Stands in for the shard's nodes if its worker failed
+    CAPSHARDRESULT  result;
+    CAPSNAPSHOT     snapshot;   // Empty unless result is CAPSHARD_OK
+
+    CAPSHARD() noexcept : result(CAPSHARD_FAILED) {}
+};
+
+// Regions hold the header and then the snapshot, so need more than this
+const size_t CAPSHARD_MIN_REGION = sizeof(CAPSHARDHEADER);
+
+void CapShardInit(void* pRegion, size_t cbRegion);
+bool CapShardWrite(void* pRegion, size_t cbRegion, const std::vector<uint8_t>& data);
+
+// CAPSHARD_OK, with the snapshot loaded, only if the worker finished writing
+// it. A worker that probed nothing leaves an OK shard with no nodes.
+CAPSHARDRESULT CapShardLoad(const void* pRegion, size_t cbRegion, CAPSNAPSHOT& snapshot);
+
+// Every shard's nodes in shard order, with top-level nodes of the same name
+// merged into one, written as a snapshot under key
+void CapMergeShards(const CAPSHARD* pShards, size_t numShards, const std::string& key, std::vector<uint8_t>& data);
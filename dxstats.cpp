@@ -0,0 +1,107 @@
+//-----------------------------------------------------------------------------
+// Name: dxstats.cpp
+//
+// Desc: DirectX Capabilities Viewer probe statistics and -trace
+//
+//       With -stats the tree gets a Probe Statistics node listing every timed
+//       driver call, display callback and export phase (see dxtrace.h), and
+//       with -trace:file every call is also written out as a trace at exit.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxview.h"
+#include "dxtrace.h"
+
+extern HWND g_hwndLV;
+
+namespace
+{
+    //-----------------------------------------------------------------------------
+    // Name: DisplayProbeStats()
+    // Desc: One row per API and adapter, or per node, slowest total first. The
+    //       figures are as of when the node is shown.
+    //-----------------------------------------------------------------------------
+    HRESULT DisplayProbeStats(LPARAM /*lParam1*/, LPARAM /*lParam2*/, _In_opt_ PRINTCBINFO* pPrintInfo)
+    {
+        std::vector<PROBESTAT> stats;
+        ProbeTimingGetStats(stats);
+
+        if (!pPrintInfo)
+        {
+            LVAddColumn(g_hwndLV, 0, "API", 36);
+            LVAddColumn(g_hwndLV, 1, "Adapter or node", 36);
+            LVAddColumn(g_hwndLV, 2, "Calls", 8);
+            LVAddColumn(g_hwndLV, 3, "Total ms", 10);
+            LVAddColumn(g_hwndLV, 4, "Avg ms", 10);
+            LVAddColumn(g_hwndLV, 5, "Max ms", 10);
+        }
+
+        for (const auto& stat : stats)
+        {
+            double totalMs = stat.totalNs / 1000000.0;
+            double avgMs = totalMs / stat.calls;
+            double maxMs = stat.maxNs / 1000000.0;
+
+            if (!pPrintInfo)
+            {
+                LVAddText(g_hwndLV, 0, "%s", stat.name.c_str());
+                LVAddText(g_hwndLV, 1, "%s", stat.subject.c_str());
+                LVAddText(g_hwndLV, 2, "%u", stat.calls);
+                LVAddText(g_hwndLV, 3, "%.3f", totalMs);
+                LVAddText(g_hwndLV, 4, "%.3f", avgMs);
+                LVAddText(g_hwndLV, 5, "%.3f", maxMs);
+            }
+            else
+            {
+                char strBuff[512];
+                sprintf_s(strBuff, sizeof(strBuff), "%-36s %-36s %8u %10.3f %10.3f %10.3f",
+                    stat.name.c_str(), stat.subject.c_str(), stat.calls, totalMs, avgMs, maxMs);
+                HRESULT hr = PrintStringLine(strBuff, pPrintInfo);
+                if (FAILED(hr))
+                    return hr;
+            }
+        }
+
+        return S_OK;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_AddProbeStats()
+// Desc: Adds the Probe Statistics node at the end of the tree
+//-----------------------------------------------------------------------------
+VOID DXView_AddProbeStats()
+{
+    TVAddNode(TVI_ROOT, "Probe Statistics", FALSE, IDI_CAPS, DisplayProbeStats, 0, 0);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_SaveTrace()
+// Desc: Writes every timed call so far as a trace-event JSON file
+//-----------------------------------------------------------------------------
+BOOL DXView_SaveTrace(LPCTSTR strFile)
+{
+    if (!strFile || !*strFile)
+        return FALSE;
+
+    std::string json;
+    ProbeTimingWriteTrace(json);
+
+    HANDLE hFile = CreateFile(strFile, GENERIC_WRITE, 0, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    DWORD cbWritten = 0;
+    BOOL fResult = WriteFile(hFile, json.data(), static_cast<DWORD>(json.size()), &cbWritten, nullptr)
+        && (cbWritten == json.size());
+
+    CloseHandle(hFile);
+
+    return fResult;
+}
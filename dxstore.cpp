@@ -0,0 +1,664 @@
+//-----------------------------------------------------------------------------
+// Name: dxstore.cpp
+//
+// Desc: DirectX Capabilities Viewer columnar snapshot store
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxstore.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+    //-----------------------------------------------------------------------------
+    size_t BitmapWords(uint32_t numRows)
+    {
+        return (static_cast<size_t>(numRows) + 63) / 64;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    bool IsTypedKind(CAPKIND kind)
+    {
+        switch (kind)
+        {
+        case CAPKIND_VALUE:
+        case CAPKIND_HEX:
+        case CAPKIND_BOOL:
+        case CAPKIND_VERSION:
+        case CAPKIND_FLOAT:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: AppendBlock()
+    // Desc: Appends a block at the next 8-byte boundary, returning its offset
+    //-----------------------------------------------------------------------------
+    uint64_t AppendBlock(std::vector<uint8_t>& out, const void* pBlock, size_t cbBlock)
+    {
+        out.resize((out.size() + 7) & ~size_t(7), 0);
+        uint64_t offset = out.size();
+        if (cbBlock)
+        {
+            auto pBytes = static_cast<const uint8_t*>(pBlock);
+            out.insert(out.end(), pBytes, pBytes + cbBlock);
+        }
+        return offset;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    CAPSTORESTRING AppendString(std::vector<char>& strings, const std::string& text)
+    {
+        CAPSTORESTRING str;
+        str.offset = static_cast<uint32_t>(strings.size());
+        str.length = static_cast<uint32_t>(text.length());
+        strings.insert(strings.end(), text.begin(), text.end());
+        strings.push_back('\0');
+        return str;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: GlobMatch()
+    // Desc: '*' matches any run of characters other than the '/' between nodes
+    //-----------------------------------------------------------------------------
+    bool GlobMatch(const char* strPattern, const char* strName)
+    {
+        while (*strPattern)
+        {
+            if (*strPattern == '*')
+            {
+                ++strPattern;
+                for (;; ++strName)
+                {
+                    if (GlobMatch(strPattern, strName))
+                        return true;
+                    if (!*strName || *strName == '/')
+                        return false;
+                }
+            }
+
+            if (*strPattern != *strName)
+                return false;
+
+            ++strPattern;
+            ++strName;
+        }
+
+        return !*strName;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    bool ParseBool(const std::string& text, bool& value)
+    {
+        if (text == "Yes" || text == "yes" || text == "1" || text == "true")
+            value = true;
+        else if (text == "No" || text == "no" || text == "0" || text == "false")
+            value = false;
+        else
+            return false;
+
+        return true;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: MatchCodes()
+    // Desc: Sets the bit of each present row whose code is target
+    //-----------------------------------------------------------------------------
+    template <typename TCode>
+    void MatchCodes(const TCode* pCodes, const uint64_t* pPresent, uint32_t numRows, uint32_t target, uint64_t* pMatches)
+    {
+        for (uint32_t row = 0; row < numRows; ++row)
+        {
+            uint64_t bit = static_cast<uint64_t>(pCodes[row] == target) << (row & 63);
+            pMatches[row >> 6] |= bit & pPresent[row >> 6];
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: BeginRow()
+// Desc: The name and the vendor, device and driver of the first adapter go
+//       in columns of their own, so they can be queried like any cap
+//-----------------------------------------------------------------------------
+void CAPSTOREBUILDER::BeginRow(const char* strName, const std::string& key)
+{
+    ++numRows;
+
+    AddCell("@name", CAPKIND_STRING, 0, strName ? strName : "");
+
+    std::vector<CAPSNAPSHOTADAPTER> adapters;
+    if (CapReadSnapshotAdapters(key, adapters) && !adapters.empty())
+    {
+        const CAPSNAPSHOTADAPTER& adapter = adapters[0];
+
+        char szText[32];
+        snprintf(szText, sizeof(szText), "0x%08X", adapter.vendorId);
+        AddCell("@vendor", CAPKIND_HEX, adapter.vendorId, szText);
+        snprintf(szText, sizeof(szText), "0x%08X", adapter.deviceId);
+        AddCell("@device", CAPKIND_HEX, adapter.deviceId, szText);
+        snprintf(szText, sizeof(szText), "%u.%u.%u.%u",
+            static_cast<unsigned>((adapter.driverVersion >> 48) & 0xFFFF),
+            static_cast<unsigned>((adapter.driverVersion >> 32) & 0xFFFF),
+            static_cast<unsigned>((adapter.driverVersion >> 16) & 0xFFFF),
+            static_cast<unsigned>(adapter.driverVersion & 0xFFFF));
+        AddCell("@driver", CAPKIND_STRING, 0, szText);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: AddModel()
+// Desc: Each named row is a column, keyed the same way as dxcapsdiff lines
+//       them up. Headings and blank lines are skipped.
+//-----------------------------------------------------------------------------
+void CAPSTOREBUILDER::AddModel(const std::string& path, const CAPMODEL& model)
+{
+    if (!numRows)
+        return;
+
+    std::vector<std::string> keys;
+    CapBuildRowKeys(model, keys);
+
+    std::string name;
+    std::string text;
+    for (size_t i = 0; i < model.rows.size(); ++i)
+    {
+        const CAPROW& row = model.rows[i];
+        if (keys[i].empty() || row.kind == CAPKIND_HEADING)
+            continue;
+
+        name = path;
+        name += '/';
+        name += keys[i];
+        CapDiffRowValue(row, text);
+        AddCell(name, row.kind, row.value, text);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+void CAPSTOREBUILDER::AddSnapshot(const char* strName, const CAPSNAPSHOT& snapshot)
+{
+    BeginRow(strName, snapshot.key);
+
+    std::vector<std::string> paths;
+    CapBuildNodePaths(snapshot.nodes, paths);
+    for (size_t i = 0; i < snapshot.nodes.size(); ++i)
+    {
+        if (snapshot.nodes[i].pModel)
+            AddModel(paths[i], *snapshot.nodes[i].pModel);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+void CAPSTOREBUILDER::AddCell(const std::string& name, CAPKIND kind, uint32_t value, const std::string& text)
+{
+    auto it = index.find(name);
+    if (it == index.end())
+    {
+        COLUMN column;
+        column.name = name;
+        column.kind = kind;
+        column.mixed = false;
+        it = index.emplace(name, columns.size()).first;
+        columns.push_back(std::move(column));
+    }
+
+    COLUMN& column = columns[it->second];
+    if (column.kind != kind)
+        column.mixed = true;
+
+    auto itCode = column.codes.find(text);
+    if (itCode == column.codes.end())
+    {
+        itCode = column.codes.emplace(text, static_cast<uint32_t>(column.dict.size())).first;
+        column.dict.push_back(text);
+    }
+
+    column.cells.push_back({ numRows - 1, value, itCode->second });
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: Write()
+// Desc: Lays out the header, the column directory sorted by name, each
+//       column's blocks and finally the strings
+//-----------------------------------------------------------------------------
+void CAPSTOREBUILDER::Write(std::vector<uint8_t>& out) const
+{
+    std::vector<size_t> order(columns.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return columns[a].name < columns[b].name; });
+
+    CAPSTOREHEADER header = {};
+    header.magic = CAPSTORE_MAGIC;
+    header.version = CAPSTORE_VERSION;
+    header.numRows = numRows;
+    header.numColumns = static_cast<uint32_t>(columns.size());
+
+    out.clear();
+    AppendBlock(out, &header, sizeof(header));
+
+    std::vector<CAPSTORECOLUMN> directory(columns.size());
+    header.columnsOffset = AppendBlock(out, directory.data(), directory.size() * sizeof(CAPSTORECOLUMN));
+
+    const size_t numWords = BitmapWords(numRows);
+    std::vector<char> strings;
+    std::vector<uint64_t> present;
+    std::vector<uint64_t> bits;
+    std::vector<uint32_t> values;
+    std::vector<uint8_t> codes;
+    std::vector<CAPSTORESTRING> dict;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const COLUMN& column = columns[order[i]];
+        CAPSTORECOLUMN& entry = directory[i];
+        entry.name = AppendString(strings, column.name);
+        entry.kind = column.kind;
+
+        if (column.mixed || !IsTypedKind(column.kind))
+            entry.type = CAPSTORE_DICT;
+        else if (column.kind == CAPKIND_BOOL)
+            entry.type = CAPSTORE_BOOL;
+        else
+            entry.type = CAPSTORE_U32;
+
+        present.assign(numWords, 0);
+        for (const auto& cell : column.cells)
+            present[cell.row >> 6] |= uint64_t(1) << (cell.row & 63);
+        entry.presentOffset = AppendBlock(out, present.data(), numWords * sizeof(uint64_t));
+
+        switch (entry.type)
+        {
+        case CAPSTORE_BOOL:
+            bits.assign(numWords, 0);
+            for (const auto& cell : column.cells)
+            {
+                if (cell.value)
+                    bits[cell.row >> 6] |= uint64_t(1) << (cell.row & 63);
+            }
+            entry.dataOffset = AppendBlock(out, bits.data(), numWords * sizeof(uint64_t));
+            break;
+
+        case CAPSTORE_U32:
+            values.assign(numRows, 0);
+            for (const auto& cell : column.cells)
+                values[cell.row] = cell.value;
+            entry.dataOffset = AppendBlock(out, values.data(), values.size() * sizeof(uint32_t));
+            break;
+
+        default:
+            entry.codeSize = (column.dict.size() <= 0x100) ? 1 : (column.dict.size() <= 0x10000) ? 2 : 4;
+            codes.assign(static_cast<size_t>(numRows) * entry.codeSize, 0);
+            for (const auto& cell : column.cells)
+                memcpy(&codes[static_cast<size_t>(cell.row) * entry.codeSize], &cell.code, entry.codeSize);
+            entry.dataOffset = AppendBlock(out, codes.data(), codes.size());
+
+            dict.clear();
+            for (const auto& text : column.dict)
+                dict.push_back(AppendString(strings, text));
+            entry.dictCount = static_cast<uint32_t>(dict.size());
+            entry.dictOffset = AppendBlock(out, dict.data(), dict.size() * sizeof(CAPSTORESTRING));
+            break;
+        }
+    }
+
+    header.stringsOffset = AppendBlock(out, strings.data(), strings.size());
+    header.stringsSize = strings.size();
+    AppendBlock(out, nullptr, 0);
+
+    memcpy(out.data(), &header, sizeof(header));
+    if (!directory.empty())
+        memcpy(out.data() + header.columnsOffset, directory.data(), directory.size() * sizeof(CAPSTORECOLUMN));
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: Open()
+// Desc: Checks the header and every column's blocks are within the store.
+//       Nothing is copied; pStore must stay mapped while the store is used.
+//-----------------------------------------------------------------------------
+bool CAPSTORE::Open(const uint8_t* pStore, size_t cbStore)
+{
+    pData = pStore;
+    cbData = cbStore;
+    pHeader = nullptr;
+    pColumns = nullptr;
+
+    if (!pStore || cbStore < sizeof(CAPSTOREHEADER) || (reinterpret_cast<uintptr_t>(pStore) & 7))
+        return false;
+
+    auto pHead = reinterpret_cast<const CAPSTOREHEADER*>(pStore);
+    if (pHead->magic != CAPSTORE_MAGIC || pHead->version != CAPSTORE_VERSION
+        || !CheckBlock(pHead->columnsOffset, static_cast<uint64_t>(pHead->numColumns) * sizeof(CAPSTORECOLUMN))
+        || !CheckBlock(pHead->stringsOffset, pHead->stringsSize))
+        return false;
+
+    pHeader = pHead;
+    pColumns = reinterpret_cast<const CAPSTORECOLUMN*>(pStore + pHead->columnsOffset);
+
+    const uint64_t cbBitmap = BitmapWords(pHead->numRows) * sizeof(uint64_t);
+    for (uint32_t i = 0; i < pHead->numColumns; ++i)
+    {
+        const CAPSTORECOLUMN& column = pColumns[i];
+        bool fValid = CheckString(column.name) && CheckBlock(column.presentOffset, cbBitmap);
+        switch (column.type)
+        {
+        case CAPSTORE_BOOL:
+            fValid = fValid && CheckBlock(column.dataOffset, cbBitmap);
+            break;
+
+        case CAPSTORE_U32:
+            fValid = fValid && CheckBlock(column.dataOffset, uint64_t(pHead->numRows) * sizeof(uint32_t));
+            break;
+
+        case CAPSTORE_DICT:
+            fValid = fValid && (column.codeSize == 1 || column.codeSize == 2 || column.codeSize == 4)
+                && CheckBlock(column.dataOffset, uint64_t(pHead->numRows) * column.codeSize)
+                && CheckBlock(column.dictOffset, uint64_t(column.dictCount) * sizeof(CAPSTORESTRING));
+            break;
+
+        default:
+            fValid = false;
+            break;
+        }
+
+        if (!fValid)
+        {
+            pHeader = nullptr;
+            pColumns = nullptr;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: FindColumn()
+//-----------------------------------------------------------------------------
+const CAPSTORECOLUMN* CAPSTORE::FindColumn(const char* strName) const
+{
+    if (!pHeader || !strName)
+        return nullptr;
+
+    const CAPSTORECOLUMN* pEnd = pColumns + pHeader->numColumns;
+    auto it = std::lower_bound(pColumns, pEnd, strName, [this](const CAPSTORECOLUMN& column, const char* str)
+        {
+            return strcmp(String(column.name), str) < 0;
+        });
+
+    return (it != pEnd && !strcmp(String(it->name), strName)) ? it : nullptr;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: FindColumns()
+// Desc: Columns matching a pattern. The part before the first '*' narrows
+//       the search to a range of the sorted directory.
+//-----------------------------------------------------------------------------
+void CAPSTORE::FindColumns(const char* strPattern, std::vector<const CAPSTORECOLUMN*>& columns) const
+{
+    columns.clear();
+    if (!pHeader || !strPattern)
+        return;
+
+    const char* pWildcard = strchr(strPattern, '*');
+    if (!pWildcard)
+    {
+        const CAPSTORECOLUMN* pColumn = FindColumn(strPattern);
+        if (pColumn)
+            columns.push_back(pColumn);
+        return;
+    }
+
+    const std::string prefix(strPattern, pWildcard);
+    const CAPSTORECOLUMN* pEnd = pColumns + pHeader->numColumns;
+    auto it = std::lower_bound(pColumns, pEnd, prefix, [this](const CAPSTORECOLUMN& column, const std::string& str)
+        {
+            return strcmp(String(column.name), str.c_str()) < 0;
+        });
+
+    for (; it != pEnd; ++it)
+    {
+        const char* strName = String(it->name);
+        if (strncmp(strName, prefix.c_str(), prefix.length()) != 0)
+            break;
+
+        if (GlobMatch(pWildcard, strName + prefix.length()))
+            columns.push_back(it);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: GetText()
+// Desc: A row's value as the viewer shows it. Returns false if the row
+//       doesn't have the cap.
+//-----------------------------------------------------------------------------
+bool CAPSTORE::GetText(const CAPSTORECOLUMN& column, uint32_t row, std::string& text) const
+{
+    text.clear();
+    if (!pHeader || row >= pHeader->numRows)
+        return false;
+
+    auto pPresent = reinterpret_cast<const uint64_t*>(pData + column.presentOffset);
+    if (!((pPresent[row >> 6] >> (row & 63)) & 1))
+        return false;
+
+    switch (column.type)
+    {
+    case CAPSTORE_BOOL:
+    {
+        auto pBits = reinterpret_cast<const uint64_t*>(pData + column.dataOffset);
+        text = ((pBits[row >> 6] >> (row & 63)) & 1) ? "Yes" : "No";
+        break;
+    }
+
+    case CAPSTORE_U32:
+    {
+        uint32_t value = reinterpret_cast<const uint32_t*>(pData + column.dataOffset)[row];
+
+        char szText[32];
+        switch (column.kind)
+        {
+        case CAPKIND_HEX:
+            snprintf(szText, sizeof(szText), "0x%08X", value);
+            break;
+
+        case CAPKIND_VERSION:
+            snprintf(szText, sizeof(szText), "%u.%u", (value >> 8) & 0xFF, value & 0xFF);
+            break;
+
+        case CAPKIND_FLOAT:
+        {
+            float fValue;
+            memcpy(&fValue, &value, sizeof(fValue));
+            snprintf(szText, sizeof(szText), "%G", static_cast<double>(fValue));
+            break;
+        }
+
+        default:
+            snprintf(szText, sizeof(szText), "%u", value);
+            break;
+        }
+
+        text = szText;
+        break;
+    }
+
+    default:
+    {
+        uint32_t code = 0;
+        memcpy(&code, pData + column.dataOffset + static_cast<size_t>(row) * column.codeSize, column.codeSize);
+
+        auto pDict = reinterpret_cast<const CAPSTORESTRING*>(pData + column.dictOffset);
+        if (code >= column.dictCount || !CheckString(pDict[code]))
+            return false;
+
+        text.assign(String(pDict[code]), pDict[code].length);
+        break;
+    }
+    }
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+void CAPSTORE::SelectAll(std::vector<uint64_t>& rows) const
+{
+    rows.assign(BitmapWords(NumRows()), ~uint64_t(0));
+    if (NumRows() & 63)
+        rows.back() = (uint64_t(1) << (NumRows() & 63)) - 1;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: Select()
+// Desc: Only the columns the predicate names are read. A row matches HAS or
+//       EQUAL if any of them does, and LACKS or NOTEQUAL if none do.
+//-----------------------------------------------------------------------------
+void CAPSTORE::Select(const CAPSTOREPREDICATE& predicate, std::vector<uint64_t>& rows) const
+{
+    const size_t numWords = BitmapWords(NumRows());
+    rows.resize(numWords, 0);
+
+    std::vector<uint64_t> matches(numWords, 0);
+    std::vector<const CAPSTORECOLUMN*> columns;
+    FindColumns(predicate.path.c_str(), columns);
+    for (auto pColumn : columns)
+        MatchColumn(*pColumn, predicate, matches);
+
+    if (predicate.op == CAPSTORE_LACKS || predicate.op == CAPSTORE_NOTEQUAL)
+    {
+        for (auto& word : matches)
+            word = ~word;
+
+        if (NumRows() & 63)
+            matches.back() &= (uint64_t(1) << (NumRows() & 63)) - 1;
+    }
+
+    for (size_t i = 0; i < numWords; ++i)
+        rows[i] &= matches[i];
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: MatchColumn()
+// Desc: Sets the bits of the rows where a column has the cap, or has it with
+//       the predicate's value. Text is looked up in the dictionary once, so
+//       rows are matched by code.
+//-----------------------------------------------------------------------------
+void CAPSTORE::MatchColumn(const CAPSTORECOLUMN& column, const CAPSTOREPREDICATE& predicate, std::vector<uint64_t>& matches) const
+{
+    const uint32_t numRows = NumRows();
+    const size_t numWords = BitmapWords(numRows);
+    auto pPresent = reinterpret_cast<const uint64_t*>(pData + column.presentOffset);
+
+    if (predicate.op == CAPSTORE_HAS || predicate.op == CAPSTORE_LACKS)
+    {
+        for (size_t i = 0; i < numWords; ++i)
+            matches[i] |= pPresent[i];
+        return;
+    }
+
+    switch (column.type)
+    {
+    case CAPSTORE_BOOL:
+    {
+        bool value;
+        if (!ParseBool(predicate.value, value))
+            return;
+
+        auto pBits = reinterpret_cast<const uint64_t*>(pData + column.dataOffset);
+        for (size_t i = 0; i < numWords; ++i)
+            matches[i] |= pPresent[i] & (value ? pBits[i] : ~pBits[i]);
+        break;
+    }
+
+    case CAPSTORE_U32:
+    {
+        char* pEnd = nullptr;
+        unsigned long value = strtoul(predicate.value.c_str(), &pEnd, 0);
+        if (predicate.value.empty() || *pEnd || value > UINT32_MAX)
+            return;
+
+        auto pValues = reinterpret_cast<const uint32_t*>(pData + column.dataOffset);
+        for (uint32_t row = 0; row < numRows; ++row)
+        {
+            uint64_t bit = static_cast<uint64_t>(pValues[row] == value) << (row & 63);
+            matches[row >> 6] |= bit & pPresent[row >> 6];
+        }
+        break;
+    }
+
+    default:
+    {
+        auto pDict = reinterpret_cast<const CAPSTORESTRING*>(pData + column.dictOffset);
+        uint32_t code = 0;
+        for (; code < column.dictCount; ++code)
+        {
+            if (CheckString(pDict[code]) && pDict[code].length == predicate.value.length()
+                && !memcmp(String(pDict[code]), predicate.value.data(), predicate.value.length()))
+                break;
+        }
+
+        if (code == column.dictCount)
+            return;
+
+        const uint8_t* pCodes = pData + column.dataOffset;
+        switch (column.codeSize)
+        {
+        case 1: MatchCodes(pCodes, pPresent, numRows, code, matches.data()); break;
+        case 2: MatchCodes(reinterpret_cast<const uint16_t*>(pCodes), pPresent, numRows, code, matches.data()); break;
+        default: MatchCodes(reinterpret_cast<const uint32_t*>(pCodes), pPresent, numRows, code, matches.data()); break;
+        }
+        break;
+    }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+const char* CAPSTORE::String(const CAPSTORESTRING& str) const
+{
+    return reinterpret_cast<const char*>(pData + pHeader->stringsOffset + str.offset);
+}
+
+
+//-----------------------------------------------------------------------------
+bool CAPSTORE::CheckString(const CAPSTORESTRING& str) const
+{
+    return pHeader
+        && static_cast<uint64_t>(str.offset) + str.length < pHeader->stringsSize
+        && !String(str)[str.length];
+}
+
+
+//-----------------------------------------------------------------------------
+bool CAPSTORE::CheckBlock(uint64_t offset, uint64_t size) const
+{
+    return !(offset & 7) && offset <= cbData && size <= cbData - offset;
+}
@@ -0,0 +1,153 @@
+//-----------------------------------------------------------------------------
+// Name: dxstore.h
+//
+// Desc: DirectX Capabilities Viewer columnar snapshot store
+//
+//       Holds the caps of many snapshots, a row per snapshot and a column
+//       per cap path. Flags are bit-packed, typed values stored raw and text
+//       dictionary-encoded. The file is laid out to be used straight from a
+//       memory mapping: CAPSTORE only checks the header and the column
+//       directory, and a query reads just the columns it names. Kept free of
+//       Windows dependencies.
+//
+//       Values are little-endian and every block is 8-byte aligned, so the
+//       structs below can point into the mapping on any little-endian CPU.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include "dxdiff.h"
+
+#include <unordered_map>
+
+const uint32_t CAPSTORE_MAGIC = 0x53435844; // 'DXCS'
+const uint32_t CAPSTORE_VERSION = 1;
+
+enum CAPSTORETYPE : uint32_t
+{
+    CAPSTORE_BOOL = 0,      // Bitmap of values
+    CAPSTORE_U32,           // Raw value per row
+    CAPSTORE_DICT,          // Code per row into a dictionary of text
+};
+
+struct CAPSTOREHEADER
+{
+    uint32_t        magic;
+    uint32_t        version;
+    uint32_t        numRows;
+    uint32_t        numColumns;
+    uint64_t        columnsOffset;  // CAPSTORECOLUMN array, sorted by name
+    uint64_t        stringsOffset;  // Names and dictionary text
+    uint64_t        stringsSize;
+};
+
+struct CAPSTORESTRING
+{
+    uint32_t        offset;         // Into the strings block
+    uint32_t        length;
+};
+
+struct CAPSTORECOLUMN
+{
+    CAPSTORESTRING  name;
+    CAPSTORETYPE    type;
+    CAPKIND         kind;           // How values are shown, for CAPSTORE_U32
+    uint64_t        presentOffset;  // Bitmap of the rows that have this cap
+    uint64_t        dataOffset;     // Bitmap, uint32_t per row or code per row, by type
+    uint64_t        dictOffset;     // CAPSTORESTRING per entry, for CAPSTORE_DICT
+    uint32_t        dictCount;
+    uint32_t        codeSize;       // Bytes per code: 1, 2 or 4
+};
+
+static_assert(sizeof(CAPSTOREHEADER) == 40, "CAPSTOREHEADER layout changed");
+static_assert(sizeof(CAPSTORECOLUMN) == 48, "CAPSTORECOLUMN layout changed");
+
+//-----------------------------------------------------------------------------
+// Builds a store in memory a snapshot at a time
+//-----------------------------------------------------------------------------
+struct CAPSTOREBUILDER
+{
+    CAPSTOREBUILDER() noexcept : numRows(0) {}
+
+    // Starts the row for a snapshot, adding its name and first adapter
+    void BeginRow(const char* strName, const std::string& key);
+
+    // Adds the caps a node's display callback produced to the current row
+    void AddModel(const std::string& path, const CAPMODEL& model);
+
+    void AddSnapshot(const char* strName, const CAPSNAPSHOT& snapshot);
+    void Write(std::vector<uint8_t>& out) const;
+
+private:
+    struct CELL
+    {
+        uint32_t    row;
+        uint32_t    value;      // Raw value of typed caps
+        uint32_t    code;       // Into the column's dictionary
+    };
+
+    struct COLUMN
+    {
+        std::string                                 name;
+        CAPKIND                                     kind;
+        bool                                        mixed;  // Kinds differ between rows, so only the text is kept
+        std::vector<CELL>                           cells;
+        std::vector<std::string>                    dict;
+        std::unordered_map<std::string, uint32_t>   codes;
+    };
+
+    void AddCell(const std::string& name, CAPKIND kind, uint32_t value, const std::string& text);
+
+    uint32_t                                    numRows;
+    std::vector<COLUMN>                         columns;
+    std::unordered_map<std::string, size_t>     index;
+};
+
+//-----------------------------------------------------------------------------
+// Queries a store in place
+//-----------------------------------------------------------------------------
+enum CAPSTOREOP : uint32_t
+{
+    CAPSTORE_HAS = 0,       // Row has the cap
+    CAPSTORE_LACKS,
+    CAPSTORE_EQUAL,         // Row has the cap with this value
+    CAPSTORE_NOTEQUAL,      // Row lacks the cap or has another value
+};
+
+struct CAPSTOREPREDICATE
+{
+    std::string     path;   // Column name, where '*' matches any part of one node name
+    CAPSTOREOP      op;
+    std::string     value;
+};
+
+struct CAPSTORE
+{
+    CAPSTORE() noexcept : pData(nullptr), cbData(0), pHeader(nullptr), pColumns(nullptr) {}
+
+    bool Open(const uint8_t* pStore, size_t cbStore);
+
+    uint32_t NumRows() const { return pHeader ? pHeader->numRows : 0; }
+    const CAPSTORECOLUMN* FindColumn(const char* strName) const;
+    void FindColumns(const char* strPattern, std::vector<const CAPSTORECOLUMN*>& columns) const;
+    bool GetText(const CAPSTORECOLUMN& column, uint32_t row, std::string& text) const;
+
+    // Narrows rows, a bitmap of NumRows bits from SelectAll, to those matching
+    void SelectAll(std::vector<uint64_t>& rows) const;
+    void Select(const CAPSTOREPREDICATE& predicate, std::vector<uint64_t>& rows) const;
+
+private:
+    const char* String(const CAPSTORESTRING& str) const;
+    bool CheckString(const CAPSTORESTRING& str) const;
+    bool CheckBlock(uint64_t offset, uint64_t size) const;
+    void MatchColumn(const CAPSTORECOLUMN& column, const CAPSTOREPREDICATE& predicate, std::vector<uint64_t>& matches) const;
+
+    const uint8_t*          pData;
+    size_t                  cbData;
+    const CAPSTOREHEADER*   pHeader;
+    const CAPSTORECOLUMN*   pColumns;
+};
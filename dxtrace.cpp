@@ -0,0 +1,344 @@
+//-----------------------------------------------------------------------------
+// Name: dxtrace.cpp
+//
+// Desc: DirectX Capabilities Viewer probe timing
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxtrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+bool g_bProbeTiming = false;
+thread_local std::atomic<uint64_t>* t_pProbeHeartbeat = nullptr;
+uint32_t g_probeStubDelayMs = 0;
+
+namespace
+{
+    // A D3D9 format storm is hundreds of thousands of calls, so past this many
+    // only the totals are kept
+    const size_t PROBE_MAX_EVENTS = 1024 * 1024;
+
+    struct PROBEEVENT
+    {
+        uint32_t        stat;       // Into the thread's stats
+        uint64_t        start;
+        uint64_t        duration;
+    };
+
+    // A call site and the subject it was last timed on. The name is a literal
+    // that outlives the process, so its address stands for the site.
+    struct PROBESITE
+    {
+        PROBEKIND       kind;
+        const char*     pName;
+        const char*     pSubject;
+
+        bool operator==(const PROBESITE& other) const
+        {
+            return kind == other.kind && pName == other.pName && pSubject == other.pSubject;
+        }
+    };
+
+    struct PROBESITEHASH
+    {
+        size_t operator()(const PROBESITE& site) const
+        {
+            return std::hash<const void*>()(site.pName) * 31 + std::hash<const void*>()(site.pSubject) + site.kind;
+        }
+    };
+
+    // What one thread has timed. Only that thread records into it, so its lock
+    // is uncontended but for the odd ProbeTimingGetStats or ProbeTimingWriteTrace.
+    struct PROBETHREAD
+    {
+        std::mutex                                              lock;
+        std::vector<PROBESTAT>                                  stats;
+        std::unordered_map<PROBESITE, uint32_t, PROBESITEHASH>  sites;      // By address, into stats
+        std::unordered_map<std::string, uint32_t>               statIndex;  // Kind, name and subject to stats
+        std::vector<PROBEEVENT>                                 events;
+    };
+
+    std::mutex                                  g_lock;         // Guards g_threads and g_origin
+    std::atomic<bool>                           g_bEvents(false);
+    std::vector<std::unique_ptr<PROBETHREAD>>   g_threads;      // Numbered in the order they were seen
+    std::atomic<size_t>                         g_numEvents(0);
+    std::atomic<size_t>                         g_droppedEvents(0);
+    uint64_t                                    g_origin = 0;   // Trace timestamps count from here
+
+    thread_local PROBETHREAD*                   t_pProbeThread = nullptr;
+
+    //-----------------------------------------------------------------------------
+    PROBETHREAD* GetProbeThread()
+    {
+        if (t_pProbeThread)
+            return t_pProbeThread;
+
+        std::unique_ptr<PROBETHREAD> pThread(new PROBETHREAD);
+
+        std::lock_guard<std::mutex> guard(g_lock);
+        g_threads.push_back(std::move(pThread));
+        t_pProbeThread = g_threads.back().get();
+        return t_pProbeThread;
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: FindStat()
+    // Desc: The call site and subject address find the stat without building a
+    //       key; a subject buffer reused for other text falls back to the text.
+    //-----------------------------------------------------------------------------
+    uint32_t FindStat(PROBETHREAD& thread, PROBEKIND kind, const char* strName, const char* strSubject)
+    {
+        PROBESITE site = { kind, strName, strSubject };
+        auto itSite = thread.sites.find(site);
+        if (itSite != thread.sites.end() && thread.stats[itSite->second].subject == strSubject)
+            return itSite->second;
+
+        std::string key(1, static_cast<char>('0' + kind));
+        key += strName;
+        key += '\0';
+        key += strSubject;
+
+        auto it = thread.statIndex.find(key);
+        if (it == thread.statIndex.end())
+        {
+            it = thread.statIndex.emplace(std::move(key), static_cast<uint32_t>(thread.stats.size())).first;
+            thread.stats.push_back({ kind, strName, strSubject, 0, 0, 0 });
+        }
+
+        thread.sites[site] = it->second;
+        return it->second;
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: MergeStats()
+    // Desc: Totals every thread's stats per kind, name and subject, and gives
+    //       each thread's stat its index in the result. Called under g_lock.
+    //-----------------------------------------------------------------------------
+    void MergeStats(std::vector<PROBESTAT>& stats, std::vector<std::vector<uint32_t>>* pMaps)
+    {
+        std::unordered_map<std::string, uint32_t> index;
+
+        stats.clear();
+        if (pMaps)
+            pMaps->assign(g_threads.size(), std::vector<uint32_t>());
+
+        for (size_t iThread = 0; iThread < g_threads.size(); ++iThread)
+        {
+            PROBETHREAD& thread = *g_threads[iThread];
+            std::lock_guard<std::mutex> guard(thread.lock);
+
+            for (const auto& entry : thread.statIndex)
+            {
+                const PROBESTAT& from = thread.stats[entry.second];
+
+                auto it = index.find(entry.first);
+                if (it == index.end())
+                {
+                    it = index.emplace(entry.first, static_cast<uint32_t>(stats.size())).first;
+                    stats.push_back({ from.kind, from.name, from.subject, 0, 0, 0 });
+                }
+
+                PROBESTAT& stat = stats[it->second];
+                stat.calls += from.calls;
+                stat.totalNs += from.totalNs;
+                stat.maxNs = std::max(stat.maxNs, from.maxNs);
+
+                if (pMaps)
+                {
+                    auto& map = (*pMaps)[iThread];
+                    if (map.size() < thread.stats.size())
+                        map.resize(thread.stats.size());
+                    map[entry.second] = it->second;
+                }
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    void AppendJsonString(std::string& json, const std::string& text)
+    {
+        json += '"';
+        for (char ch : text)
+        {
+            auto uch = static_cast<unsigned char>(ch);
+            if (ch == '"' || ch == '\\')
+            {
+                json += '\\';
+                json += ch;
+            }
+            else if (uch < 0x20)
+            {
+                char szEscape[8];
+                snprintf(szEscape, sizeof(szEscape), "\\u%04X", uch);
+                json += szEscape;
+            }
+            else
+            {
+                json += ch;
+            }
+        }
+        json += '"';
+    }
+
+    const char* c_szKindNames[] = { "driver", "display", "phase" };
+
+    std::string g_strStubDelayFilter;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: ProbeTimingEnable()
+// Desc: Starts timing, keeping every call as a trace event when bEvents is set
+//-----------------------------------------------------------------------------
+void ProbeTimingEnable(bool bEvents)
+{
+    std::lock_guard<std::mutex> guard(g_lock);
+    if (bEvents)
+        g_bEvents = true;
+    if (!g_bProbeTiming)
+        g_origin = ProbeTimingNow();
+    g_bProbeTiming = true;
+}
+
+
+//-----------------------------------------------------------------------------
+uint64_t ProbeTimingNow()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: ProbeTimingRecord()
+// Desc: Adds to the calling thread's own totals, so parallel probe threads
+//       never wait on each other
+//-----------------------------------------------------------------------------
+void ProbeTimingRecord(PROBEKIND kind, const char* strName, const char* strSubject, uint64_t start, uint64_t end)
+{
+    uint64_t duration = (end > start) ? end - start : 0;
+
+    PROBETHREAD* pThread = GetProbeThread();
+    std::lock_guard<std::mutex> guard(pThread->lock);
+
+    uint32_t iStat = FindStat(*pThread, kind, strName, strSubject);
+    PROBESTAT& stat = pThread->stats[iStat];
+    ++stat.calls;
+    stat.totalNs += duration;
+    stat.maxNs = std::max(stat.maxNs, duration);
+
+    if (!g_bEvents.load(std::memory_order_relaxed))
+        return;
+
+    if (g_numEvents.fetch_add(1, std::memory_order_relaxed) < PROBE_MAX_EVENTS)
+        pThread->events.push_back({ iStat, start, duration });
+    else
+        g_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+//-----------------------------------------------------------------------------
+void ProbeTimingGetStats(std::vector<PROBESTAT>& stats)
+{
+    {
+        std::lock_guard<std::mutex> guard(g_lock);
+        MergeStats(stats, nullptr);
+    }
+
+    std::stable_sort(stats.begin(), stats.end(),
+        [](const PROBESTAT& a, const PROBESTAT& b) { return a.totalNs > b.totalNs; });
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: ProbeTimingWriteTrace()
+// Desc: A complete ("X") event per call, on a track per thread, with times
+//       in microseconds from when timing started
+//-----------------------------------------------------------------------------
+void ProbeTimingWriteTrace(std::string& json)
+{
+    std::lock_guard<std::mutex> guard(g_lock);
+
+    std::vector<PROBESTAT> stats;
+    std::vector<std::vector<uint32_t>> maps;
+    MergeStats(stats, &maps);
+
+    json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    char szNumbers[96];
+    for (size_t i = 0; i < g_threads.size(); ++i)
+    {
+        snprintf(szNumbers, sizeof(szNumbers),
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Thread %u\"}},\n",
+            static_cast<unsigned>(i), static_cast<unsigned>(i));
+        json += szNumbers;
+    }
+
+    for (size_t iThread = 0; iThread < g_threads.size(); ++iThread)
+    {
+        PROBETHREAD& thread = *g_threads[iThread];
+        std::lock_guard<std::mutex> threadGuard(thread.lock);
+
+        for (const auto& event : thread.events)
+        {
+            // A stat added since the merge has no map entry; its events wait for the next trace
+            if (event.stat >= maps[iThread].size())
+                continue;
+
+            const PROBESTAT& stat = stats[maps[iThread][event.stat]];
+            uint64_t start = (event.start > g_origin) ? event.start - g_origin : 0;
+
+            json += "{\"name\":";
+            AppendJsonString(json, stat.name);
+            json += ",\"cat\":\"";
+            json += c_szKindNames[stat.kind];
+            snprintf(szNumbers, sizeof(szNumbers), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                static_cast<unsigned>(iThread), start / 1000.0, event.duration / 1000.0);
+            json += szNumbers;
+            if (!stat.subject.empty())
+            {
+                json += ",\"args\":{\"subject\":";
+                AppendJsonString(json, stat.subject);
+                json += '}';
+            }
+            json += "},\n";
+        }
+    }
+
+    snprintf(szNumbers, sizeof(szNumbers),
+        "{\"name\":\"dropped_events\",\"ph\":\"M\",\"pid\":1,\"args\":{\"count\":%zu}}\n]}\n", g_droppedEvents.load());
+    json += szNumbers;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: ProbeStubDelaySet()
+// Desc: Makes driver calls slow, or with a long enough delay hung, so the
+//       watchdog can be tried without a bad driver. Call before any probing.
+//-----------------------------------------------------------------------------
+void ProbeStubDelaySet(uint32_t delayMs, const char* strFilter)
+{
+    g_strStubDelayFilter = strFilter ? strFilter : "";
+    g_probeStubDelayMs = delayMs;
+}
+
+
+//-----------------------------------------------------------------------------
+void ProbeStubDelay(const char* strName)
+{
+    if (!g_strStubDelayFilter.empty() && !strstr(strName, g_strStubDelayFilter.c_str()))
+        return;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(g_probeStubDelayMs));
+}
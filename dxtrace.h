@@ -0,0 +1,135 @@
+//-----------------------------------------------------------------------------
+// Name: dxtrace.h
+//
+// Desc: DirectX Capabilities Viewer probe timing
+//
+//       Scoped timers around the driver calls, display callbacks and export
+//       phases, totalled per name and per subject (the adapter of a driver
+//       call, the node of a display callback). Every call can also be kept as
+//       a trace event for a trace viewer, as with -trace. When timing is off
+//       a timer costs a test of one flag. Driver calls also stamp a heartbeat
+//       for the probe watchdog, and can be made to sleep to exercise it. Kept
+//       free of Windows dependencies.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum PROBEKIND : uint32_t
+{
+    PROBE_DRIVER = 0,       // A call into the runtime or driver
+    PROBE_DISPLAY,          // A node's display callback
+    PROBE_PHASE,            // Filling the tree, or writing it out
+};
+
+struct PROBESTAT
+{
+    PROBEKIND       kind;
+    std::string     name;
+    std::string     subject;
+    uint32_t        calls;
+    uint64_t        totalNs;
+    uint64_t        maxNs;
+};
+
+// Set once at startup, before any timer runs
+extern bool g_bProbeTiming;
+
+void ProbeTimingEnable(bool bEvents);
+uint64_t ProbeTimingNow();
+
+// Thread-safe, and each thread adds to totals of its own. strName must
+// outlive the process, as its address stands for the call site; strSubject
+// is copied.
+void ProbeTimingRecord(PROBEKIND kind, const char* strName, const char* strSubject, uint64_t start, uint64_t end);
+
+// Slowest total first
+void ProbeTimingGetStats(std::vector<PROBESTAT>& stats);
+
+// Chrome trace event format, as loaded by about:tracing or Perfetto
+void ProbeTimingWriteTrace(std::string& json);
+
+// A thread probing under the watchdog points this at its heartbeat, which
+// every driver call stamps as it starts and returns. Null on other threads.
+extern thread_local std::atomic<uint64_t>* t_pProbeHeartbeat;
+
+// Set once at startup by -stubdelay: driver calls whose name contains the
+// filter, or all of them without one, sleep this long before they're made
+extern uint32_t g_probeStubDelayMs;
+
+void ProbeStubDelaySet(uint32_t delayMs, const char* strFilter);
+void ProbeStubDelay(const char* strName);
+
+//-----------------------------------------------------------------------------
+// Name: PROBESCOPE
+// Desc: Times its own lifetime, if timing is on
+//-----------------------------------------------------------------------------
+struct PROBESCOPE
+{
+    PROBEKIND       kind;
+    const char*     pName;      // Null when timing is off
+    const char*     pSubject;
+    uint64_t        start;
+
+    PROBESCOPE(PROBEKIND probeKind, const char* strName, const char* strSubject) noexcept
+        : kind(probeKind), pName(nullptr), pSubject(strSubject), start(0)
+    {
+        if (g_bProbeTiming)
+        {
+            pName = strName;
+            start = ProbeTimingNow();
+        }
+    }
+
+    PROBESCOPE(const PROBESCOPE&) = delete;
+    PROBESCOPE& operator=(const PROBESCOPE&) = delete;
+
+    ~PROBESCOPE()
+    {
+        if (pName)
+            ProbeTimingRecord(kind, pName, pSubject ? pSubject : "", start, ProbeTimingNow());
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Name: PROBEHEARTBEAT
+// Desc: Stamps the watchdog heartbeat, if any, either side of a driver call
+//-----------------------------------------------------------------------------
+struct PROBEHEARTBEAT
+{
+    std::atomic<uint64_t>*  pHeartbeat;
+
+    explicit PROBEHEARTBEAT(const char* strName) noexcept
+        : pHeartbeat(t_pProbeHeartbeat)
+    {
+        if (pHeartbeat)
+            pHeartbeat->store(ProbeTimingNow());
+        if (g_probeStubDelayMs)
+            ProbeStubDelay(strName);
+    }
+
+    PROBEHEARTBEAT(const PROBEHEARTBEAT&) = delete;
+    PROBEHEARTBEAT& operator=(const PROBEHEARTBEAT&) = delete;
+
+    ~PROBEHEARTBEAT()
+    {
+        if (pHeartbeat)
+            pHeartbeat->store(ProbeTimingNow());
+    }
+};
+
+// Times one driver call, evaluating to what it returns, as in
+//     PROBE_CALL("IDirect3D9::CheckDeviceFormat", strAdapter, g_pD3D->CheckDeviceFormat(...))
+#define PROBE_CALL(name, subject, call) \
+    [&]() { \
+        PROBESCOPE probeScope(PROBE_DRIVER, name, subject); \
+        PROBEHEARTBEAT probeHeartbeat(name); \
+        return call; }()
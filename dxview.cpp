@@ -9,8 +9,10 @@
 // https://go.microsoft.com/fwlink/?linkid=2136896
 //-----------------------------------------------------------------------------
 #include "dxview.h"
+#include "dxtrace.h"
 
 #include <objbase.h>
+#include <algorithm>
 #include <stdio.h>
 #include <strsafe.h>
 #include <shlwapi.h>
@@ -19,6 +21,12 @@
 #define D3DSHADER_VERSION_MAJOR(_Version) (((_Version)>>8)&0xFF)
 #define D3DSHADER_VERSION_MINOR(_Version) (((_Version)>>0)&0xFF)
 
+// Headless capture output formats (see -json, -ndjson and -grep)
+#define SAVEFORMAT_TEXT     0
+#define SAVEFORMAT_JSON     1
+#define SAVEFORMAT_NDJSON   2
+#define SAVEFORMAT_GREP     3
+
 HINSTANCE   g_hInstance;
 CHAR        g_strAppName[]  = "DXView";
 CHAR        g_strClassName[] = "DXView";
@@ -32,6 +40,8 @@ extern const char c_szNA[] = "n/a";
 
 HWND        g_hwndLV;        // List view
 HWND        g_hwndTV;        // Tree view
+HWND        g_hwndSearch;    // Search box above the tree view
+int         g_cySearch;      // Height of the search box
 HIMAGELIST  g_hImageList;
 HFONT       g_hFont;
 int         g_xPaneSplit;
@@ -43,7 +53,19 @@ DWORD       g_tmAveCharWidth;
 extern BOOL g_PrintToFile;
 extern TCHAR  g_PrintToFilePath[MAX_PATH];
 CHAR        g_szClip[200];   // Text to possibly copy to clipboard
+BOOL        g_bForceReprobe; // Ignore the snapshot cache
+DWORD       g_dwSaveFormat;  // SAVEFORMAT_ value for the headless capture
+TCHAR       g_RecordPath[MAX_PATH] = {};  // Save a recording of the tree here
+TCHAR       g_ReplayPath[MAX_PATH] = {};  // Replay this recording instead of probing
+CHAR        g_GrepQuery[256] = {};        // Save only what matches this, see -grep
+TCHAR       g_TracePath[MAX_PATH] = {};   // Write the timed probe calls here at exit, see -trace
+BOOL        g_bProbeStats;   // Show the Probe Statistics node, see -stats
+BOOL        g_bProbeWorkers; // Probe in child processes, see -workers
+TCHAR       g_WorkerArgs[MAX_PATH] = {};  // Set in a child started by -workers, see DXView_RunWorker
+TCHAR       g_StubDelay[MAX_PATH] = {};   // Passed on to the workers, see -stubdelay
 TCHAR       g_helpPath[MAX_PATH] = {};
+BOOL        g_bWatchAdapters;   // The tree shows live devices rather than a recording
+BOOL        g_bAdaptersChanged; // A device change notification came in since the last check
 
 //-----------------------------------------------------------------------------
 // Local function prototypes
@@ -55,10 +77,30 @@ VOID    DXView_OnCommand( HWND hwnd, WPARAM wParam );
 VOID    DXView_OnSize( HWND hwnd );
 VOID    DXView_OnTreeSelect( HWND hwndTV, NM_TREEVIEW* ptv );
 VOID    DXView_OnListViewDblClick( HWND hwndLV, NM_LISTVIEW* plv );
+VOID    DXView_OnListViewDispInfo( NMLVDISPINFO* pdi );
+VOID    DXView_OnListViewColumnClick( HWND hwndLV, NM_LISTVIEW* plv );
 VOID    DXView_Cleanup();
 BOOL    DXView_InitImageList();
 BOOL    DXView_OnPrint( HWND hWindow, HWND hTreeView, BOOL bPrintAll );
 BOOL    DXView_OnFile( HWND hWindow, HWND hTreeWnd,BOOL bPrintAll );
+BOOL    DXView_OnHeadlessFile( LPCTSTR strFile );
+BOOL    DXView_SaveJson( HWND hwndTV, LPCTSTR strFile, BOOL bNDJSON );
+int     DXView_RunHeadless( BOOL bCached );
+BOOL    DXView_LoadRecording( LPCTSTR strFile );
+BOOL    DXView_SaveRecording( HWND hwndTV, LPCTSTR strFile );
+VOID    DXView_FreeSnapshot();
+HWND    DXView_CreateSearchBox( HWND hwnd );
+VOID    DXView_BeginSearchIndex();
+VOID    DXView_OnSearchReady( UINT generation );
+VOID    DXView_OnSearchChange();
+VOID    DXView_FindNext( BOOL bBackward );
+VOID    DXView_ResetSearch();
+VOID    DXView_FreeSearch();
+BOOL    DXView_SaveGrep( HWND hwndTV, LPCTSTR strFile, LPCSTR strQuery );
+VOID    DXView_AddProbeStats();
+BOOL    DXView_SaveTrace( LPCTSTR strFile );
+BOOL    DXView_ProbeWithWorkers();
+int     DXView_RunWorker( LPCTSTR strArgs );
 VOID    CreateCopyMenu( VOID );
 
 
@@ -75,6 +117,16 @@ VOID DXGI_Init();
 VOID DXG_Init();
 VOID DD_Init();
 
+VOID DXGI_BeginProbe();
+BOOL DXGI_UpdateAdapters( HWND hwndTV, BOOL bCheck, std::vector<ADAPTERCHANGE>& changes );
+BOOL DXGI_AddProbedAdapters( HWND hwndTV, UINT generation );
+VOID DXG_UpdateAdapters( HWND hwndTV, const std::vector<ADAPTERCHANGE>& changes );
+VOID DD_UpdateAdapters( HWND hwndTV, const std::vector<ADAPTERCHANGE>& changes );
+BOOL DXGI_CaptureNextSubtree( HWND hwndTV );
+
+BOOL DXView_LoadCache();
+VOID DXView_SaveCache();
+
 VOID DXGI_CleanUp();
 VOID DXG_CleanUp();
 VOID DD_CleanUp();
@@ -83,6 +135,226 @@ BOOL DXG_Is9Ex();
 
 
 
+//-----------------------------------------------------------------------------
+// The list view is LVS_OWNERDATA, so what it shows is kept here and handed out
+// a cell at a time as rows become visible (see DXView_OnListViewDispInfo)
+//-----------------------------------------------------------------------------
+struct LVCELL
+{
+    int         col;
+    uint32_t    offset;     // Into LVSTORE::text
+};
+
+struct LVROW
+{
+    uint32_t    firstCell;  // Into LVSTORE::cells, a row's cells are contiguous
+    uint32_t    numCells;
+};
+
+struct LVCOLUMNDEF
+{
+    std::string name;
+    int         width;      // In characters
+};
+
+struct LVSTORE
+{
+    std::vector<LVCOLUMNDEF>    columns;
+    std::vector<char>           text;
+    std::vector<LVCELL>         cells;
+    std::vector<LVROW>          rows;
+};
+
+// What a node displays under each view option, kept once the objects its
+// callback used are gone (see TVCaptureNodes)
+struct CAPTUREDNODE
+{
+    LVSTORE     list[2];    // Indexed by CaptureViewIndex
+    CAPMODEL    model[2];
+};
+
+
+namespace
+{
+    HEADLESSNODE* g_pHeadlessRoot = nullptr;   // Top-level nodes when there is no TreeView
+    HEADLESSNODE* g_pHeadlessLast = nullptr;
+
+    LVSTORE g_lvStore;                  // Rows of the node being shown
+    int     g_lvSortCol = -1;
+    BOOL    g_lvSortAscending = TRUE;
+
+    // View options a node is captured under
+    const DWORD c_dwCaptureViews[] = { IDM_VIEWAVAIL, IDM_VIEWALL };
+
+    //-----------------------------------------------------------------------------
+    int CaptureViewIndex()
+    {
+        return (g_dwViewState == IDM_VIEWALL) ? 1 : 0;
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: AllocNodeInfo()
+    // Desc: A zeroed NODEINFO carrying a copy of the node's text
+    //-----------------------------------------------------------------------------
+    NODEINFO* AllocNodeInfo(LPCSTR strText)
+    {
+        size_t cchText = strlen(strText);
+        auto pni = reinterpret_cast<NODEINFO*>(LocalAlloc(LPTR, sizeof(NODEINFO) + cchText));
+        if (pni)
+            memcpy(pni->strText, strText, cchText);
+        return pni;
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: CallDisplayCallback()
+    // Desc: Runs the node's display callback, timed under the node's text
+    //-----------------------------------------------------------------------------
+    HRESULT CallDisplayCallback(const NODEINFO* pni, _In_opt_ PRINTCBINFO* pPrintInfo)
+    {
+        PROBESCOPE probeScope(PROBE_DISPLAY, "Display callback", pni->strText);
+
+        if (pni->bUseLParam3)
+            return ((DISPLAYCALLBACKEX)(pni->fnDisplayCallback))(pni->lParam1, pni->lParam2, pni->lParam3, pPrintInfo);
+
+        return pni->fnDisplayCallback(pni->lParam1, pni->lParam2, pPrintInfo);
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: TVInsertNode()
+    // Desc: Adds a node to the treeview, or to the in-memory tree when running
+    //       headless. Takes ownership of pni.
+    //-----------------------------------------------------------------------------
+    HTREEITEM TVInsertNode(HTREEITEM hParent, LPCSTR strText, BOOL fKids, int iImage, NODEINFO* pni)
+    {
+        if (!g_hwndTV)
+        {
+            size_t cchText = strlen(strText);
+            auto pNode = reinterpret_cast<HEADLESSNODE*>(LocalAlloc(LPTR, sizeof(HEADLESSNODE) + cchText));
+            if (!pNode)
+            {
+                LocalFree(pni);
+                return nullptr;
+            }
+
+            pNode->pni = pni;
+            pNode->bKids = fKids;
+            memcpy(pNode->strText, strText, cchText);
+
+            if (!hParent || hParent == TVI_ROOT)
+            {
+                if (g_pHeadlessLast)
+                    g_pHeadlessLast->pNext = pNode;
+                else
+                    g_pHeadlessRoot = pNode;
+                g_pHeadlessLast = pNode;
+            }
+            else
+            {
+                auto pParent = reinterpret_cast<HEADLESSNODE*>(hParent);
+                if (pParent->pLastChild)
+                    pParent->pLastChild->pNext = pNode;
+                else
+                    pParent->pFirstChild = pNode;
+                pParent->pLastChild = pNode;
+            }
+
+            return reinterpret_cast<HTREEITEM>(pNode);
+        }
+
+        // Add Node to treeview
+        TV_INSERTSTRUCT tvi = {};
+        tvi.hParent = hParent;
+        tvi.hInsertAfter = TVI_LAST;
+        tvi.item.mask = TVIF_TEXT | TVIF_IMAGE | TVIF_SELECTEDIMAGE |
+            TVIF_PARAM | TVIF_CHILDREN;
+        tvi.item.iImage = iImage - IDI_FIRSTIMAGE;
+        tvi.item.iSelectedImage = iImage - IDI_FIRSTIMAGE;
+        tvi.item.lParam = (LPARAM)pni;
+        tvi.item.cChildren = fKids;
+        tvi.item.pszText = (LPSTR)strText;
+
+        return TreeView_InsertItem(g_hwndTV, &tvi);
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: IsSwitch()
+    // Desc: Does the command line switch between pszSwitch and pszEnd match?
+    //-----------------------------------------------------------------------------
+    BOOL IsSwitch(const TCHAR* pszSwitch, const TCHAR* pszEnd, const TCHAR* pszName)
+    {
+        size_t cchName = _tcslen(pszName);
+        return (static_cast<size_t>(pszEnd - pszSwitch) == cchName)
+            && (_tcsnicmp(pszSwitch, pszName, cchName) == 0);
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: GetSwitchValue()
+    // Desc: Copies out the value of a "name:value" switch, dropping any quotes
+    //-----------------------------------------------------------------------------
+    BOOL GetSwitchValue(const TCHAR* pszSwitch, const TCHAR* pszEnd, const TCHAR* pszName,
+        _Out_writes_(cchValue) TCHAR* pszValue, size_t cchValue)
+    {
+        size_t cchName = _tcslen(pszName);
+        if ((static_cast<size_t>(pszEnd - pszSwitch) <= cchName + 1)
+            || (_tcsnicmp(pszSwitch, pszName, cchName) != 0)
+            || (pszSwitch[cchName] != TEXT(':')))
+            return FALSE;
+
+        size_t cch = 0;
+        for (const TCHAR* pch = pszSwitch + cchName + 1; (pch < pszEnd) && (cch + 1 < cchValue); ++pch)
+        {
+            if (*pch != TEXT('"'))
+                pszValue[cch++] = *pch;
+        }
+        pszValue[cch] = TEXT('\0');
+
+        return (cch > 0);
+    }
+
+    //-----------------------------------------------------------------------------
+    VOID FreeHeadlessNodes(HEADLESSNODE* pNode)
+    {
+        while (pNode)
+        {
+            HEADLESSNODE* pNext = pNode->pNext;
+            FreeHeadlessNodes(pNode->pFirstChild);
+            if (pNode->pni)
+            {
+                delete pNode->pni->pModel;
+                delete pNode->pni->pCaptured;
+            }
+            LocalFree(pNode->pni);
+            LocalFree(pNode);
+            pNode = pNext;
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    VOID FreeTreeViewNodes(HWND hwndTV, HTREEITEM hItem)
+    {
+        for (HTREEITEM hChild = TreeView_GetChild(hwndTV, hItem); hChild;
+            hChild = TreeView_GetNextSibling(hwndTV, hChild))
+        {
+            FreeTreeViewNodes(hwndTV, hChild);
+        }
+
+        TV_ITEM tvi = {};
+        tvi.mask = TVIF_PARAM;
+        tvi.hItem = hItem;
+        if (!TreeView_GetItem(hwndTV, &tvi) || !tvi.lParam)
+            return;
+
+        auto pni = reinterpret_cast<NODEINFO*>(tvi.lParam);
+        delete pni->pModel;
+        delete pni->pCaptured;
+        LocalFree(pni);
+
+        tvi.lParam = 0;
+        TreeView_SetItem(hwndTV, &tvi);
+    }
+}
+
+
 //-----------------------------------------------------------------------------
 // Name: Int2Str()
 // Desc: Get number as a string
@@ -121,6 +393,14 @@ HRESULT Int2Str( _Out_z_cap_(nDestLen) LPTSTR strDest, UINT nDestLen, DWORD i )
 _Use_decl_annotations_
 HRESULT PrintStringValueLine(const char * szText, const char * szText2, PRINTCBINFO *lpInfo)
 {
+    if (lpInfo->pModel)
+    {
+        if (!strcmp(szText2, c_szYes) || !strcmp(szText2, c_szNo))
+            lpInfo->pModel->SetRowKind(CAPKIND_BOOL, (strcmp(szText2, c_szYes) == 0) ? 1 : 0);
+        else
+            lpInfo->pModel->SetRowKind(CAPKIND_STRING, 0);
+    }
+
     // Calculate Name and Value column x offsets
     int xName   = (lpInfo->dwCurrIndent * DEF_TAB_SIZE * lpInfo->dwCharWidth);
     int xVal    = xName + (32 * lpInfo->dwCharWidth);
@@ -153,6 +433,9 @@ HRESULT PrintStringValueLine(const char * szText, const char * szText2, PRINTCBI
 _Use_decl_annotations_
 HRESULT PrintValueLine(const char * szText, DWORD dwValue, PRINTCBINFO *lpInfo)
 {
+    if (lpInfo->pModel)
+        lpInfo->pModel->SetRowKind(CAPKIND_VALUE, dwValue);
+
     char  szBuff[80];
     Int2Str(szBuff, 80, dwValue);
     return PrintStringValueLine( szText, szBuff, lpInfo );
@@ -163,6 +446,9 @@ HRESULT PrintValueLine(const char * szText, DWORD dwValue, PRINTCBINFO *lpInfo)
 _Use_decl_annotations_
 HRESULT PrintHexValueLine(const char * szText, DWORD dwValue, PRINTCBINFO *lpInfo)
 {
+    if (lpInfo->pModel)
+        lpInfo->pModel->SetRowKind(CAPKIND_HEX, dwValue);
+
     char  szBuff[80];
     sprintf_s( szBuff, sizeof(szBuff), "0x%08x", dwValue );
     return PrintStringValueLine( szText, szBuff, lpInfo );
@@ -173,6 +459,9 @@ HRESULT PrintHexValueLine(const char * szText, DWORD dwValue, PRINTCBINFO *lpInf
 _Use_decl_annotations_
 HRESULT PrintStringLine(const char * szText, PRINTCBINFO *lpInfo)
 {
+    if (lpInfo->pModel)
+        lpInfo->pModel->SetRowKind(CAPKIND_HEADING, 0);
+
     // Calculate Name and Value column x offsets
     int xName   = (lpInfo->dwCurrIndent * DEF_TAB_SIZE * lpInfo->dwCharWidth);
     int yLine   = (lpInfo->dwCurrLine * lpInfo->dwLineHeight);
@@ -207,37 +496,6 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE /*hPrevInstance*
     if (FAILED(hr))
         return 1;
 
-    // Init various DX components
-    DXGI_Init();
-    DXG_Init();
-    DD_Init();
-
-    // Register window class
-    WNDCLASS  wc;
-    wc.style = CS_HREDRAW | CS_VREDRAW; // Class style(s).
-    wc.lpfnWndProc = (WNDPROC)WndProc;        // Window Procedure
-    wc.cbClsExtra = 0;                       // No per-class extra data.
-    wc.cbWndExtra = 0;                       // No per-window extra data.
-    wc.hInstance = hInstance;               // Owner of this class
-    wc.hIcon = LoadIcon(hInstance, MAKEINTRESOURCE(IDI_DIRECTX)); // Icon name from .RC
-    wc.hCursor = LoadCursor(hInstance, MAKEINTRESOURCE(IDC_SPLIT));// Cursor
-    wc.hbrBackground = (HBRUSH)(COLOR_3DFACE + 1); // Default color
-    wc.lpszMenuName = "Menu";                   // Menu name from .RC
-    wc.lpszClassName = g_strClassName;            // Name to register as
-    RegisterClass(&wc);
-
-    // Create a main window for this application instance.
-    g_hwndMain = CreateWindowEx(0, g_strClassName, g_strTitle, WS_OVERLAPPEDWINDOW,
-        CW_USEDEFAULT, CW_USEDEFAULT, DXView_WIDTH, DXView_HEIGHT,
-        nullptr, nullptr, hInstance, nullptr);
-
-    // If window could not be created, return "failure"
-    if (!g_hwndMain)
-    {
-        CoUninitialize();
-        return -1;
-    }
-
     TCHAR* pszCmdLine = GetCommandLine();
     // Skip past program name (first token in command line).
     if (*pszCmdLine == TEXT('"'))  // Check for and handle quoted program name
@@ -261,6 +519,56 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE /*hPrevInstance*
     while (*pszCmdLine && (*pszCmdLine <= TEXT(' ')))
         pszCmdLine++;
 
+    // Handle any switches ahead of the filename
+    while (*pszCmdLine == TEXT('-') || *pszCmdLine == TEXT('/'))
+    {
+        // Values may be quoted to include spaces, as in -replay:"my machine.dxv"
+        TCHAR* pszSwitch = ++pszCmdLine;
+        BOOL bQuoted = FALSE;
+        while (*pszCmdLine && (bQuoted || (*pszCmdLine > TEXT(' '))))
+        {
+            if (*pszCmdLine == TEXT('"'))
+                bQuoted = !bQuoted;
+            pszCmdLine++;
+        }
+
+        // Take --name as well as -name
+        if (*pszSwitch == TEXT('-'))
+            pszSwitch++;
+
+        TCHAR szValue[MAX_PATH];
+        if (IsSwitch(pszSwitch, pszCmdLine, TEXT("reprobe")))
+            g_bForceReprobe = TRUE;
+        else if (IsSwitch(pszSwitch, pszCmdLine, TEXT("json")))
+            g_dwSaveFormat = SAVEFORMAT_JSON;
+        else if (IsSwitch(pszSwitch, pszCmdLine, TEXT("ndjson")))
+            g_dwSaveFormat = SAVEFORMAT_NDJSON;
+        else if (GetSwitchValue(pszSwitch, pszCmdLine, TEXT("grep"), g_GrepQuery, std::size(g_GrepQuery)))
+            g_dwSaveFormat = SAVEFORMAT_GREP;
+        else if (IsSwitch(pszSwitch, pszCmdLine, TEXT("stats")))
+            g_bProbeStats = TRUE;
+        else if (IsSwitch(pszSwitch, pszCmdLine, TEXT("workers")))
+            g_bProbeWorkers = TRUE;
+        else if (GetSwitchValue(pszSwitch, pszCmdLine, TEXT("timeout"), szValue, std::size(szValue)))
+            g_dwCallTimeout = _tcstoul(szValue, nullptr, 10);
+        else if (GetSwitchValue(pszSwitch, pszCmdLine, TEXT("adaptertimeout"), szValue, std::size(szValue)))
+            g_dwAdapterTimeout = _tcstoul(szValue, nullptr, 10);
+        else if (GetSwitchValue(pszSwitch, pszCmdLine, TEXT("stubdelay"), g_StubDelay, std::size(g_StubDelay)))
+        {
+            // -stubdelay:ms, or -stubdelay:ms:name for just the calls with name in theirs
+            TCHAR* pszFilter = nullptr;
+            ULONG delayMs = _tcstoul(g_StubDelay, &pszFilter, 10);
+            ProbeStubDelaySet(delayMs, (*pszFilter == TEXT(':')) ? pszFilter + 1 : nullptr);
+        }
+        else if (!GetSwitchValue(pszSwitch, pszCmdLine, TEXT("trace"), g_TracePath, std::size(g_TracePath))
+            && !GetSwitchValue(pszSwitch, pszCmdLine, TEXT("record"), g_RecordPath, std::size(g_RecordPath))
+            && !GetSwitchValue(pszSwitch, pszCmdLine, TEXT("worker"), g_WorkerArgs, std::size(g_WorkerArgs)))
+            (void)GetSwitchValue(pszSwitch, pszCmdLine, TEXT("replay"), g_ReplayPath, std::size(g_ReplayPath));
+
+        while (*pszCmdLine && (*pszCmdLine <= TEXT(' ')))
+            pszCmdLine++;
+    }
+
     // Treat the rest of the command line as a filename to save the whole tree to
     TCHAR* pstrSave = g_PrintToFilePath;
     if (*pszCmdLine == TEXT('"'))  // Check for and handle quoted program name
@@ -281,17 +589,91 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE /*hPrevInstance*
     }
     *pstrSave = TEXT('\0');
 
-    if (strlen(g_PrintToFilePath) > 0)
+    BOOL bHeadless = (strlen(g_PrintToFilePath) > 0);
+
+    // Timing is off unless asked for, so the probes only pay for a flag test
+    if (g_bProbeStats || g_TracePath[0])
+        ProbeTimingEnable(g_TracePath[0] != TEXT('\0'));
+
+    // Init various DX components
+    DXGI_Init();
+
+    // A headless capture on an unchanged configuration needs no devices at all,
+    // and neither does one replayed from a recording
+    BOOL bCached = FALSE;
+    BOOL bReplay = (g_ReplayPath[0] != TEXT('\0'));
+    BOOL bWorker = (g_WorkerArgs[0] != TEXT('\0'));
+    if (bHeadless && bReplay)
+    {
+        g_dwViewState = IDM_VIEWALL;
+        if (!DXView_LoadRecording(g_ReplayPath))
+        {
+            CoUninitialize();
+            return 1;
+        }
+        bCached = TRUE;
+    }
+    else if (bHeadless && !g_bForceReprobe)
     {
-        PostMessage(g_hwndMain, WM_COMMAND, IDM_PRINTWHOLETREETOFILE, 0);
-        PostMessage(g_hwndMain, WM_CLOSE, 0, 0);
+        g_dwViewState = IDM_VIEWALL;
+        bCached = DXView_LoadCache();
     }
-    else
+
+    if (!bCached && !bReplay && !bWorker && !g_bProbeWorkers)
+    {
+        // Start creating DXGI devices on the thread pool while everything else
+        // initializes. DXGI_FillTree waits for the results.
+        DXGI_BeginProbe();
+    }
+
+    DXG_Init();
+    DD_Init();
+
+    if (bWorker)
+    {
+        // Started by -workers to probe one shard into the parent's section
+        int result = DXView_RunWorker(g_WorkerArgs);
+        CoUninitialize();
+        return result;
+    }
+
+    if (bHeadless)
+    {
+        // Capture straight to the file without creating any windows
+        int result = DXView_RunHeadless(bCached);
+        CoUninitialize();
+        return result;
+    }
+
+    // Register window class
+    WNDCLASS  wc;
+    wc.style = CS_HREDRAW | CS_VREDRAW; // Class style(s).
+    wc.lpfnWndProc = (WNDPROC)WndProc;        // Window Procedure
+    wc.cbClsExtra = 0;                       // No per-class extra data.
+    wc.cbWndExtra = 0;                       // No per-window extra data.
+    wc.hInstance = hInstance;               // Owner of this class
+    wc.hIcon = LoadIcon(hInstance, MAKEINTRESOURCE(IDI_DIRECTX)); // Icon name from .RC
+    wc.hCursor = LoadCursor(hInstance, MAKEINTRESOURCE(IDC_SPLIT));// Cursor
+    wc.hbrBackground = (HBRUSH)(COLOR_3DFACE + 1); // Default color
+    wc.lpszMenuName = "Menu";                   // Menu name from .RC
+    wc.lpszClassName = g_strClassName;            // Name to register as
+    RegisterClass(&wc);
+
+    // Create a main window for this application instance.
+    g_hwndMain = CreateWindowEx(0, g_strClassName, g_strTitle, WS_OVERLAPPEDWINDOW,
+        CW_USEDEFAULT, CW_USEDEFAULT, DXView_WIDTH, DXView_HEIGHT,
+        nullptr, nullptr, hInstance, nullptr);
+
+    // If window could not be created, return "failure"
+    if (!g_hwndMain)
     {
-        // Make the window visible; update its client area; and return "success"
-        ShowWindow(g_hwndMain, SW_MAXIMIZE /*nCmdShow*/);
+        CoUninitialize();
+        return -1;
     }
 
+    // Make the window visible; update its client area; and return "success"
+    ShowWindow(g_hwndMain, SW_MAXIMIZE /*nCmdShow*/);
+
     // Message pump
     MSG msg;
     while (GetMessage(&msg, nullptr, 0, 0))
@@ -306,6 +688,63 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE /*hPrevInstance*
 }
 
 
+//-----------------------------------------------------------------------------
+// Name: DXView_RunHeadless()
+// Desc: Builds the device tree in memory, unless it was loaded from the
+//       cache, and saves it to g_PrintToFilePath as text, JSON or NDJSON, or
+//       just the lines matching g_GrepQuery
+//-----------------------------------------------------------------------------
+int DXView_RunHeadless(BOOL bCached)
+{
+    // Same defaults as a freshly created window
+    g_dwViewState = IDM_VIEWALL;
+    g_dwView9Ex = DXG_Is9Ex() ? 1 : 0;
+
+    if (!bCached && !(g_bProbeWorkers && DXView_ProbeWithWorkers()))
+    {
+        // No TreeView is created, so these fill the in-memory tree instead
+        DXGI_FillTree(nullptr);
+        DXG_FillTree(nullptr);
+        DD_FillTree(nullptr);
+    }
+
+    BOOL fResult;
+    switch (g_dwSaveFormat)
+    {
+    case SAVEFORMAT_JSON:
+        fResult = DXView_SaveJson(nullptr, g_PrintToFilePath, FALSE);
+        break;
+
+    case SAVEFORMAT_NDJSON:
+        fResult = DXView_SaveJson(nullptr, g_PrintToFilePath, TRUE);
+        break;
+
+    case SAVEFORMAT_GREP:
+        fResult = DXView_SaveGrep(nullptr, g_PrintToFilePath, g_GrepQuery);
+        break;
+
+    default:
+        fResult = DXView_OnHeadlessFile(g_PrintToFilePath);
+        break;
+    }
+
+    // Writing the file has probed every node, so the whole tree can be cached,
+    // unless some of it timed out or its worker died
+    if (fResult && !bCached && !g_bProbesTimedOut && !g_bWorkersFailed)
+        DXView_SaveCache();
+
+    if (fResult && g_RecordPath[0])
+        fResult = DXView_SaveRecording(nullptr, g_RecordPath);
+
+    if (g_TracePath[0] && !DXView_SaveTrace(g_TracePath))
+        fResult = FALSE;
+
+    DXView_Cleanup();
+
+    return fResult ? 0 : 1;
+}
+
+
 //-----------------------------------------------------------------------------
 LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
@@ -354,6 +793,16 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
         {
             if (((NMHDR*)lParam)->code == TVN_SELCHANGED)
                 DXView_OnTreeSelect(g_hwndTV, (NM_TREEVIEW*)lParam);
+            else if (((NMHDR*)lParam)->code == TVN_ITEMEXPANDING)
+            {
+                NM_TREEVIEW* ptv = (NM_TREEVIEW*)lParam;
+                if (ptv->action & TVE_EXPAND)
+                {
+                    HCURSOR hOldCursor = SetCursor(LoadCursor(nullptr, IDC_WAIT));
+                    TVExpandLazyNode(g_hwndTV, ptv->itemNew.hItem);
+                    SetCursor(hOldCursor);
+                }
+            }
             else if (((NMHDR*)lParam)->code == NM_RCLICK)
             {
                 NMHDR* pnmhdr = (NMHDR*)lParam;
@@ -376,13 +825,19 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
             {
                 NMTVKEYDOWN* ptvkd = (LPNMTVKEYDOWN)lParam;
                 if (ptvkd->wVKey == VK_TAB)
-                    SetFocus(g_hwndLV);
+                    SetFocus((GetKeyState(VK_SHIFT) < 0) ? g_hwndSearch : g_hwndLV);
+                else if (ptvkd->wVKey == VK_F3)
+                    DXView_FindNext(GetKeyState(VK_SHIFT) < 0);
             }
         }
 
         if (((NMHDR*)lParam)->hwndFrom == g_hwndLV)
         {
-            if (((NMHDR*)lParam)->code == NM_RDBLCLK)
+            if (((NMHDR*)lParam)->code == LVN_GETDISPINFO)
+                DXView_OnListViewDispInfo((NMLVDISPINFO*)lParam);
+            else if (((NMHDR*)lParam)->code == LVN_COLUMNCLICK)
+                DXView_OnListViewColumnClick(g_hwndLV, (NM_LISTVIEW*)lParam);
+            else if (((NMHDR*)lParam)->code == NM_RDBLCLK)
                 DXView_OnListViewDblClick(g_hwndLV, (NM_LISTVIEW*)lParam);
             else if (((NMHDR*)lParam)->code == NM_RCLICK)
             {
@@ -401,10 +856,55 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
             {
                 NMLVKEYDOWN* plvkd = (LPNMLVKEYDOWN)lParam;
                 if (plvkd->wVKey == VK_TAB)
-                    SetFocus(g_hwndTV);
+                    SetFocus((GetKeyState(VK_SHIFT) < 0) ? g_hwndTV : g_hwndSearch);
+                else if (plvkd->wVKey == VK_F3)
+                    DXView_FindNext(GetKeyState(VK_SHIFT) < 0);
+            }
+        }
+
+        break;
+
+    case WM_TIMER:
+        if (wParam == IDT_ADAPTERS)
+        {
+            std::vector<ADAPTERCHANGE> changes;
+            if (DXGI_UpdateAdapters(g_hwndTV, g_bAdaptersChanged, changes))
+            {
+                // The Direct3D 9 and DirectDraw devices of those adapters change too
+                DXG_UpdateAdapters(g_hwndTV, changes);
+                DD_UpdateAdapters(g_hwndTV, changes);
+
+                // The search index points at the nodes of adapters that were replaced
+                DXView_ResetSearch();
             }
+            g_bAdaptersChanged = FALSE;
+        }
+        else if (wParam == IDT_CAPTURE)
+        {
+            // Timer messages only come when the queue is empty, so this runs
+            // while the viewer is idle
+            if (!DXGI_CaptureNextSubtree(g_hwndTV))
+                KillTimer(hWnd, IDT_CAPTURE);
+        }
+        break;
+
+    case WM_ADAPTERSPROBED:
+        if (DXGI_AddProbedAdapters(g_hwndTV, static_cast<UINT>(wParam)))
+            DXView_ResetSearch();
+        break;
+
+    case WM_DISPLAYCHANGE:
+    case WM_DEVICECHANGE:
+        // These come in bursts, so restart the timer and check once they settle
+        if (g_bWatchAdapters)
+        {
+            g_bAdaptersChanged = TRUE;
+            SetTimer(hWnd, IDT_ADAPTERS, TIMER_PERIOD, nullptr);
         }
+        break;
 
+    case WM_SEARCHREADY:
+        DXView_OnSearchReady(static_cast<UINT>(wParam));
         break;
 
     case WM_SETFOCUS:
@@ -412,6 +912,15 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
         break;
 
     case WM_COMMAND:  // message: command from application menu
+        if (LOWORD(wParam) == IDC_SEARCH)
+        {
+            // Get the index going before the first key is typed
+            if (HIWORD(wParam) == EN_SETFOCUS)
+                DXView_BeginSearchIndex();
+            else if (HIWORD(wParam) == EN_CHANGE)
+                DXView_OnSearchChange();
+            break;
+        }
         DXView_OnCommand(hWnd, wParam);
         break;
 
@@ -420,6 +929,10 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
         return 0;
 
     case WM_DESTROY:  // message: window being destroyed
+        KillTimer(hWnd, IDT_ADAPTERS);
+        KillTimer(hWnd, IDT_CAPTURE);
+        if (g_TracePath[0])
+            DXView_SaveTrace(g_TracePath);
         DXView_Cleanup();  // Free per item struct for all items
         PostQuitMessage(0);
         break;
@@ -477,6 +990,7 @@ BOOL DXView_OnCreate(HWND hWnd)
     TEXTMETRIC tm = {};
     GetTextMetrics(hDC, &tm);
     g_tmAveCharWidth = tm.tmAveCharWidth;
+    g_cySearch = tm.tmHeight + tm.tmExternalLeading + 4 * GetSystemMetrics(SM_CYEDGE);
     ReleaseDC(hWnd, hDC);
 
     // Initialize global data
@@ -494,7 +1008,7 @@ BOOL DXView_OnCreate(HWND hWnd)
 
     // Create the list view window.
     g_hwndLV = CreateWindowEx(WS_EX_CLIENTEDGE, WC_LISTVIEW, "",
-        WS_VISIBLE | WS_CHILD | LVS_REPORT | LVS_SHOWSELALWAYS | LVS_SINGLESEL,
+        WS_VISIBLE | WS_CHILD | LVS_REPORT | LVS_SHOWSELALWAYS | LVS_SINGLESEL | LVS_OWNERDATA,
         0, 0, 0, 0, hWnd, (HMENU)IDC_LV, g_hInstance, nullptr);
     ListView_SetExtendedListViewStyleEx(g_hwndLV, LVS_EX_FULLROWSELECT, LVS_EX_FULLROWSELECT);
 
@@ -504,14 +1018,37 @@ BOOL DXView_OnCreate(HWND hWnd)
         TVS_HASBUTTONS | TVS_LINESATROOT | TVS_SHOWSELALWAYS,
         0, 0, 0, 0, hWnd, (HMENU)IDC_TV, g_hInstance, nullptr);
 
+    // Searches every node and value, see dxfind.cpp
+    g_hwndSearch = DXView_CreateSearchBox(hWnd);
+
     // create our image list.
     DXView_InitImageList();
 
     // Add DXStuff stuff to the tree
-    // view.
-    DXGI_FillTree(g_hwndTV);
-    DXG_FillTree(g_hwndTV);
-    DD_FillTree(g_hwndTV);
+    // view, or replay it from a recording without touching the devices.
+    BOOL bLoaded = g_ReplayPath[0] && DXView_LoadRecording(g_ReplayPath);
+    if (!bLoaded && g_bProbeWorkers && DXView_ProbeWithWorkers())
+    {
+        // What the workers probed loads as a recording does, so there are no
+        // live devices to keep up to date
+        if (g_bProbeStats)
+            DXView_AddProbeStats();
+        bLoaded = TRUE;
+    }
+
+    if (!bLoaded)
+    {
+        DXGI_FillTree(g_hwndTV);
+        DXG_FillTree(g_hwndTV);
+        DD_FillTree(g_hwndTV);
+
+        if (g_bProbeStats)
+            DXView_AddProbeStats();
+
+        // Keep the adapters up to date through hot-plugs, docking and driver updates
+        g_bWatchAdapters = TRUE;
+        SetTimer(hWnd, IDT_ADAPTERS, TIMER_PERIOD, nullptr);
+    }
 
     TreeView_SelectItem(g_hwndTV, TreeView_GetRoot(g_hwndTV));
 
@@ -566,91 +1103,313 @@ void AddCapsToTV(HTREEITEM hRoot, CAPDEFS* pcds, LPARAM lParam1)
 }
 
 
-//-----------------------------------------------------------------------------
-// AddMoreCapsToLV is like AddCapsToLV, except it doesn't add the
-// column headers like AddCapsToLV does.
-void AddMoreCapsToLV(CAPDEF* pcd, LPVOID pv)
+namespace
 {
-    TCHAR szBuff[64];
+    //-----------------------------------------------------------------------------
+    // Name: FormatCap()
+    // Desc: Formats a cap's raw value from a CAPVECTOR, one specialization per
+    //       kind. Flags arrive as 0 or 1.
+    //-----------------------------------------------------------------------------
+    template <CAPDEFKIND kind>
+    VOID FormatCap(const CAPDEF& cd, uint32_t value, CAPVALUE& val);
+
+    template <>
+    VOID FormatCap<CAPDEF_FLAG>(const CAPDEF& /*cd*/, uint32_t value, CAPVALUE& val)
+    {
+        val.kind = CAPKIND_BOOL;
+        val.value = value;
+        strcpy_s(val.szValue, sizeof(val.szValue), value ? c_szYes : c_szNo);
+    }
 
-    while (pcd->strName && *pcd->strName)
+    template <>
+    VOID FormatCap<CAPDEF_VALUE>(const CAPDEF& /*cd*/, uint32_t value, CAPVALUE& val)
     {
-        if (!g_dwView9Ex && (pcd->dwCapsFlags & DXV_9EXCAP))
-        {
-            pcd++;  // Get next Cap bit definition
-            continue;
-        }
+        val.kind = CAPKIND_VALUE;
+        val.value = value;
+        Int2Str(val.szValue, sizeof(val.szValue), value);
+    }
 
-        auto dwValue = *reinterpret_cast<DWORD*>(static_cast<BYTE*>(pv) + pcd->dwOffset);
+    template <>
+    VOID FormatCap<CAPDEF_HEX>(const CAPDEF& /*cd*/, uint32_t value, CAPVALUE& val)
+    {
+        val.kind = CAPKIND_HEX;
+        val.value = value;
+        sprintf_s(val.szValue, sizeof(val.szValue), "0x%08X", value);
+    }
 
-        switch (pcd->dwFlag)
-        {
-        case 0:
-            LVAddText(g_hwndLV, 0, "%s", pcd->strName);
-            Int2Str(szBuff, 64, dwValue);
-            LVAddText(g_hwndLV, 1, "%s", szBuff);
-            break;
-        case 0xFFFFFFFF:	// Hex
-            LVAddText(g_hwndLV, 0, "%s", pcd->strName);
-            LVAddText(g_hwndLV, 1, "0x%08X", dwValue);
-            break;
-        case 0xEFFFFFFF:	// Shader Version
-            LVAddText(g_hwndLV, 0, "%s", pcd->strName);
-            LVAddText(g_hwndLV, 1, "%d.%0d", D3DSHADER_VERSION_MAJOR(dwValue), D3DSHADER_VERSION_MINOR(dwValue));
-            break;
-        case 0xBFFFFFFF:	// FLOAT Support for new DX6 "D3DVALUE" values in D3DDeviceDesc
-        {
-            LVAddText(g_hwndLV, 0, "%s", pcd->strName);
-            auto fValue = *reinterpret_cast<float*>(static_cast<BYTE*>(pv) + pcd->dwOffset);
-            LVAddText(g_hwndLV, 1, "%G", fValue);
-            break;
-        }
-        case 0x7FFFFFFF:	// HEX Support for new DX6 "WORD" values in D3DDeviceDesc
-            LVAddText(g_hwndLV, 0, "%s", pcd->strName);
-            dwValue = *reinterpret_cast<WORD*>(static_cast<BYTE*>(pv) + pcd->dwOffset);
-            LVAddText(g_hwndLV, 1, "0x%04X", dwValue);
-            break;
-        case 0x3FFFFFFF:	// VAL Support for new DX6 "WORD" values in D3DDeviceDesc
-            LVAddText(g_hwndLV, 0, "%s", pcd->strName);
-            dwValue = *reinterpret_cast<WORD*>(static_cast<BYTE*>(pv) + pcd->dwOffset);
-            Int2Str(szBuff, 64, dwValue);
-            LVAddText(g_hwndLV, 1, "%s", szBuff);
-            break;
-        case 0x1FFFFFFF:	// "-1 == unlimited"
-            LVAddText(g_hwndLV, 0, "%s", pcd->strName);
-            if (dwValue == 0xFFFFFFFF)
-            {
-                LVAddText(g_hwndLV, 1, "Unlimited");
-            }
-            else
-            {
-                Int2Str(szBuff, 64, dwValue);
-                LVAddText(g_hwndLV, 1, "%s", szBuff);
-            }
-            break;
-        case 0x0fffffff:    // Mask with 0xffff
+    template <>
+    VOID FormatCap<CAPDEF_VERSION>(const CAPDEF& /*cd*/, uint32_t value, CAPVALUE& val)
+    {
+        val.kind = CAPKIND_VERSION;
+        val.value = value;
+        sprintf_s(val.szValue, sizeof(val.szValue), "%u.%u", D3DSHADER_VERSION_MAJOR(value), D3DSHADER_VERSION_MINOR(value));
+    }
+
+    template <>
+    VOID FormatCap<CAPDEF_FLOAT>(const CAPDEF& /*cd*/, uint32_t value, CAPVALUE& val)
+    {
+        float fValue;
+        memcpy(&fValue, &value, sizeof(fValue));
+        val.kind = CAPKIND_FLOAT;
+        val.value = value;
+        sprintf_s(val.szValue, sizeof(val.szValue), "%G", static_cast<double>(fValue));
+    }
+
+    template <>
+    VOID FormatCap<CAPDEF_HEX16>(const CAPDEF& /*cd*/, uint32_t value, CAPVALUE& val)
+    {
+        val.kind = CAPKIND_HEX;
+        val.value = value;
+        sprintf_s(val.szValue, sizeof(val.szValue), "0x%04X", value);
+    }
+
+    template <>
+    VOID FormatCap<CAPDEF_VALUE16>(const CAPDEF& /*cd*/, uint32_t value, CAPVALUE& val)
+    {
+        val.kind = CAPKIND_VALUE;
+        val.value = value;
+        Int2Str(val.szValue, sizeof(val.szValue), value);
+    }
+
+    template <>
+    VOID FormatCap<CAPDEF_UNLIMITED>(const CAPDEF& /*cd*/, uint32_t value, CAPVALUE& val)
+    {
+        val.value = value;
+        if (value == 0xFFFFFFFF)
         {
-            LVAddText(g_hwndLV, 0, pcd->strName);
-            dwValue = (*reinterpret_cast<DWORD*>(static_cast<BYTE*>(pv) + pcd->dwOffset)) & 0xffff;
-            Int2Str(szBuff, 64, dwValue);
-            LVAddText(g_hwndLV, 1, "%s", szBuff);
+            val.kind = CAPKIND_STRING;
+            strcpy_s(val.szValue, sizeof(val.szValue), "Unlimited");
         }
-        break;
-        default:
-            if (pcd->dwFlag & dwValue)
+        else
+        {
+            val.kind = CAPKIND_VALUE;
+            Int2Str(val.szValue, sizeof(val.szValue), value);
+        }
+    }
+
+    template <>
+    VOID FormatCap<CAPDEF_MASK16>(const CAPDEF& /*cd*/, uint32_t value, CAPVALUE& val)
+    {
+        val.kind = CAPKIND_VALUE;
+        val.value = value & 0xFFFF;
+        Int2Str(val.szValue, sizeof(val.szValue), val.value);
+    }
+
+    using FORMATCAPFN = VOID(*)(const CAPDEF& cd, uint32_t value, CAPVALUE& val);
+
+    struct CAPKINDINFO
+    {
+        FORMATCAPFN     fnFormat;
+        BYTE            cbField;        // Bytes read from the caps struct
+    };
+
+#define CAPKINDINFO_ENTRY(kind) { FormatCap<kind>, sizeof(CAPDEFFIELD<kind>::Type) }
+
+    // Indexed by CAPDEFKIND
+    const CAPKINDINFO c_capKinds[] =
+    {
+        CAPKINDINFO_ENTRY(CAPDEF_FLAG),
+        CAPKINDINFO_ENTRY(CAPDEF_VALUE),
+        CAPKINDINFO_ENTRY(CAPDEF_HEX),
+        CAPKINDINFO_ENTRY(CAPDEF_VERSION),
+        CAPKINDINFO_ENTRY(CAPDEF_FLOAT),
+        CAPKINDINFO_ENTRY(CAPDEF_HEX16),
+        CAPKINDINFO_ENTRY(CAPDEF_VALUE16),
+        CAPKINDINFO_ENTRY(CAPDEF_UNLIMITED),
+        CAPKINDINFO_ENTRY(CAPDEF_MASK16),
+    };
+
+    static_assert(std::size(c_capKinds) == CAPDEF_MASK16 + 1, "Missing cap kind");
+
+    //-----------------------------------------------------------------------------
+    // Name: CAPLAYOUT
+    // Desc: A CAPDEF table split into flag and scalar rows, compiled the first
+    //       time the table is used
+    //-----------------------------------------------------------------------------
+    struct CAPLAYOUT
+    {
+        CAPLAYOUT*              pNext;
+        const CAPDEF*           pcd;            // Table this was compiled from
+        std::vector<uint32_t>   flagOffsets;
+        std::vector<uint32_t>   flagMasks;
+        std::vector<uint32_t>   scalarOffsets;
+        std::vector<BYTE>       scalarSizes;
+    };
+
+    CAPLAYOUT* g_pCapLayouts = nullptr;
+
+    //-----------------------------------------------------------------------------
+    const CAPLAYOUT* GetCapLayout(const CAPDEF* pcd)
+    {
+        for (CAPLAYOUT* pLayout = g_pCapLayouts; pLayout; pLayout = pLayout->pNext)
+        {
+            if (pLayout->pcd == pcd)
+                return pLayout;
+        }
+
+        auto pLayout = new (std::nothrow) CAPLAYOUT;
+        if (!pLayout)
+            return nullptr;
+
+        pLayout->pcd = pcd;
+        for (; pcd->strName && *pcd->strName; ++pcd)
+        {
+            if (pcd->kind == CAPDEF_FLAG)
             {
-                LVAddText(g_hwndLV, 0, pcd->strName);
-                LVAddText(g_hwndLV, 1, c_szYes);
+                pLayout->flagOffsets.push_back(static_cast<uint32_t>(pcd->dwOffset));
+                pLayout->flagMasks.push_back(pcd->dwFlag);
             }
-            else if (g_dwViewState == IDM_VIEWALL)
+            else
             {
-                LVAddText(g_hwndLV, 0, pcd->strName);
-                LVAddText(g_hwndLV, 1, c_szNo);
+                pLayout->scalarOffsets.push_back(static_cast<uint32_t>(pcd->dwOffset));
+                pLayout->scalarSizes.push_back(c_capKinds[pcd->kind].cbField);
             }
-            break;
         }
-        pcd++;  // Get next Cap bit definition
+
+        pLayout->pNext = g_pCapLayouts;
+        g_pCapLayouts = pLayout;
+        return pLayout;
+    }
+
+    //-----------------------------------------------------------------------------
+    VOID FreeCapLayouts()
+    {
+        while (g_pCapLayouts)
+        {
+            CAPLAYOUT* pNext = g_pCapLayouts->pNext;
+            delete g_pCapLayouts;
+            g_pCapLayouts = pNext;
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    HRESULT AddCapValueToLV(const CAPDEF& cd, const CAPVALUE& val, VOID* /*pContext*/)
+    {
+        LVAddText(g_hwndLV, 0, "%s", cd.strName);
+        LVAddText(g_hwndLV, 1, "%s", val.szValue);
+        return S_OK;
+    }
+
+    //-----------------------------------------------------------------------------
+    struct PRINTCAPSINFO
+    {
+        PRINTCBINFO*    pInfo;
+        int             xName;      // Name and value column x offsets
+        int             xVal;
+    };
+
+    HRESULT PrintCapValue(const CAPDEF& cd, const CAPVALUE& val, VOID* pContext)
+    {
+        auto pPrint = static_cast<PRINTCAPSINFO*>(pContext);
+        PRINTCBINFO* lpInfo = pPrint->pInfo;
+        int yLine = static_cast<int>(lpInfo->dwCurrLine * lpInfo->dwLineHeight);
+
+        if (lpInfo->pModel)
+            lpInfo->pModel->SetRowKind(val.kind, val.value);
+
+        // Print name
+        if (FAILED(PrintLine(pPrint->xName, yLine, cd.strName, strlen(cd.strName), lpInfo)))
+            return E_FAIL;
+
+        // Print value
+        if (FAILED(PrintLine(pPrint->xVal, yLine, val.szValue, strlen(val.szValue), lpInfo)))
+            return E_FAIL;
+
+        // Advance to next line on page
+        return PrintNextLine(lpInfo);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: BuildCapVector()
+// Desc: Packs every cap of a CAPDEF table, whatever the view options, into
+//       vec. Flag rows are tested without branching, straight from the
+//       table's compiled layout.
+//-----------------------------------------------------------------------------
+BOOL BuildCapVector(const CAPDEF* pcd, const VOID* pv, CAPVECTOR& vec)
+{
+    const CAPLAYOUT* pLayout = (pcd && pv) ? GetCapLayout(pcd) : nullptr;
+    if (!pLayout)
+        return FALSE;
+
+    auto pBase = static_cast<const BYTE*>(pv);
+
+    const size_t numFlags = pLayout->flagOffsets.size();
+    vec.numFlags = static_cast<uint32_t>(numFlags);
+    vec.bits.assign((numFlags + 63) / 64, 0);
+    for (size_t i = 0; i < numFlags; ++i)
+    {
+        DWORD dwValue;
+        memcpy(&dwValue, pBase + pLayout->flagOffsets[i], sizeof(dwValue));
+        vec.bits[i >> 6] |= static_cast<uint64_t>((dwValue & pLayout->flagMasks[i]) != 0) << (i & 63);
+    }
+
+    const size_t numScalars = pLayout->scalarOffsets.size();
+    vec.scalars.assign(numScalars, 0);
+    for (size_t i = 0; i < numScalars; ++i)
+        memcpy(&vec.scalars[i], pBase + pLayout->scalarOffsets[i], pLayout->scalarSizes[i]);
+
+    return TRUE;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: EvalCaps()
+// Desc: Walks a CAPDEF table alongside the vector built from it, passing each
+//       cap the current view shows to fnValue. Touches no windows, so any
+//       sink can use it.
+//-----------------------------------------------------------------------------
+HRESULT EvalCaps(const CAPDEF* pcd, const CAPVECTOR& vec, CAPVALUECALLBACK fnValue, VOID* pContext)
+{
+    if (!pcd || !fnValue)
+        return E_INVALIDARG;
+
+    uint32_t iFlag = 0;
+    size_t iScalar = 0;
+    for (; pcd->strName && *pcd->strName; ++pcd)
+    {
+        uint32_t value;
+        if (pcd->kind == CAPDEF_FLAG)
+        {
+            if (iFlag >= vec.numFlags)
+                return E_INVALIDARG;
+            value = vec.Test(iFlag++) ? 1u : 0u;
+        }
+        else
+        {
+            if (iScalar >= vec.scalars.size())
+                return E_INVALIDARG;
+            value = vec.scalars[iScalar++];
+        }
+
+        if (!g_dwView9Ex && (pcd->dwCapsFlags & DXV_9EXCAP))
+            continue;
+
+        // Flags that aren't set are only listed when viewing all
+        if (pcd->kind == CAPDEF_FLAG && !value && g_dwViewState != IDM_VIEWALL)
+            continue;
+
+        CAPVALUE val;
+        c_capKinds[pcd->kind].fnFormat(*pcd, value, val);
+
+        HRESULT hr = fnValue(*pcd, val, pContext);
+        if (FAILED(hr))
+            return hr;
     }
+
+    return S_OK;
+}
+
+
+//-----------------------------------------------------------------------------
+// AddMoreCapsToLV is like AddCapsToLV, except it doesn't add the
+// column headers like AddCapsToLV does.
+void AddMoreCapsToLV(CAPDEF* pcd, LPVOID pv)
+{
+    CAPVECTOR vec;
+    if (BuildCapVector(pcd, pv, vec))
+        (void)EvalCaps(pcd, vec, AddCapValueToLV, nullptr);
 }
 
 
@@ -675,187 +1434,31 @@ VOID AddCapsToLV(CAPDEF *pcd, LPVOID pv)
 _Use_decl_annotations_
 HRESULT PrintCapsToDC(CAPDEF* pcd, LPVOID pv, PRINTCBINFO* lpInfo)
 {
-    DWORD cchLen;
-    TCHAR szValue[100];
-
     // Check Parameters
     if ((!pcd) || (!lpInfo))
         return E_FAIL;
 
-    // Calculate Name and Value column x offsets
-    int xName = (lpInfo->dwCurrIndent * DEF_TAB_SIZE * lpInfo->dwCharWidth);
-    int xVal = xName + (50 * lpInfo->dwCharWidth);
-
-    while (pcd->strName && *pcd->strName)
-    {
-        if (!g_dwView9Ex && (pcd->dwCapsFlags & DXV_9EXCAP))
-        {
-            pcd++;  // Get next Cap bit definition
-            continue;
-        }
-
-        auto dwValue = *reinterpret_cast<DWORD*>(static_cast<BYTE*>(pv) + pcd->dwOffset);
-        int yLine = lpInfo->dwCurrLine * lpInfo->dwLineHeight;
-
-        if (pcd->dwFlag)
-        {
-            switch (pcd->dwFlag)
-            {
-            case 0xFFFFFFFF:	// Hex
-                // Print name
-                cchLen = static_cast<DWORD>(_tcslen(pcd->strName));
-                if (FAILED(PrintLine(xName, yLine, pcd->strName, cchLen, lpInfo)))
-                    return E_FAIL;
-                // Print value in hex
-                sprintf_s(szValue, sizeof(szValue), "0x%08X", dwValue);
-                if (FAILED(PrintLine(xVal, yLine, szValue, strlen(szValue), lpInfo)))
-                    return E_FAIL;
-                // Advance to next line on page
-                if (FAILED(PrintNextLine(lpInfo)))
-                    return E_FAIL;
-                break;
-
-            case 0xEFFFFFFF:	// Shader Version
-                // Print name
-                cchLen = static_cast<DWORD>(_tcslen(pcd->strName));
-                if (FAILED(PrintLine(xName, yLine, pcd->strName, cchLen, lpInfo)))
-                    return E_FAIL;
-                // Print version
-                sprintf_s(szValue, sizeof(szValue), "%u.%0u", D3DSHADER_VERSION_MAJOR(dwValue), D3DSHADER_VERSION_MINOR(dwValue));
-                if (FAILED(PrintLine(xVal, yLine, szValue, strlen(szValue), lpInfo)))
-                    return E_FAIL;
-                // Advance to next line on page
-                if (FAILED(PrintNextLine(lpInfo)))
-                    return E_FAIL;
-                break;
-
-            case 0xBFFFFFFF:	// FLOAT Support for new DX6 "D3DVALUE" values in D3DDeviceDesc
-            {
-                // Print name
-                cchLen = static_cast<DWORD>(_tcslen(pcd->strName));
-                if (FAILED(PrintLine(xName, yLine, pcd->strName, cchLen, lpInfo)))
-                    return E_FAIL;
-                // Print value
-                auto fValue = *reinterpret_cast<float*>(static_cast<BYTE*>(pv) + pcd->dwOffset);
-                sprintf_s(szValue, sizeof(szValue), "%G", fValue);
-                if (FAILED(PrintLine(xVal, yLine, szValue, strlen(szValue), lpInfo)))
-                    return E_FAIL;
-                // Advance to next line on page
-                if (FAILED(PrintNextLine(lpInfo)))
-                    return E_FAIL;
-                break;
-            }
+    CAPVECTOR vec;
+    if (!BuildCapVector(pcd, pv, vec))
+        return E_FAIL;
 
-            case 0x7FFFFFFF:	// HEX Support for new DX6 "WORD" values in D3DDeviceDesc
-                // Print name
-                cchLen = static_cast<DWORD>(_tcslen(pcd->strName));
-                if (FAILED(PrintLine(xName, yLine, pcd->strName, cchLen, lpInfo)))
-                    return E_FAIL;
-                // Print value
-                dwValue = *reinterpret_cast<WORD*>(static_cast<BYTE*>(pv) + pcd->dwOffset);
-                sprintf_s(szValue, sizeof(szValue), "0x%04X", dwValue);
-                if (FAILED(PrintLine(xVal, yLine, szValue, strlen(szValue), lpInfo)))
-                    return E_FAIL;
-                // Advance to next line on page
-                if (FAILED(PrintNextLine(lpInfo)))
-                    return E_FAIL;
-                break;
-
-            case 0x3FFFFFFF:	// VAL Support for new DX6 "WORD" values in D3DDeviceDesc
-                // Print name
-                cchLen = static_cast<DWORD>(_tcslen(pcd->strName));
-                if (FAILED(PrintLine(xName, yLine, pcd->strName, cchLen, lpInfo)))
-                    return E_FAIL;
-                // Print value
-                dwValue = *reinterpret_cast<WORD*>(static_cast<BYTE*>(pv) + pcd->dwOffset);
-                *szValue = 0;
-                Int2Str(szValue, 100, dwValue);
-                if (FAILED(PrintLine(xVal, yLine, szValue, strlen(szValue), lpInfo)))
-                    return E_FAIL;
-                // Advance to next line on page
-                if (FAILED(PrintNextLine(lpInfo)))
-                    return E_FAIL;
-                break;
-
-            case 0x1FFFFFFF:	// "-1 == unlimited"
-                // Print name
-                cchLen = static_cast<DWORD>(_tcslen(pcd->strName));
-                if (FAILED(PrintLine(xName, yLine, pcd->strName, cchLen, lpInfo)))
-                    return E_FAIL;
-                // Print value
-                *szValue = 0;
-                if (dwValue == 0xFFFFFFFF)
-                    strcpy_s(szValue, sizeof(szValue), "Unlimited");
-                else
-                    Int2Str(szValue, 100, dwValue);
-                if (FAILED(PrintLine(xVal, yLine, szValue, strlen(szValue), lpInfo)))
-                    return E_FAIL;
-                // Advance to next line on page
-                if (FAILED(PrintNextLine(lpInfo)))
-                    return E_FAIL;
-                break;
-
-            default:
-                if (pcd->dwFlag & dwValue)
-                {
-                    // Print Name
-                    cchLen = static_cast<DWORD>(_tcslen(pcd->strName));
-                    if (FAILED(PrintLine(xName, yLine, pcd->strName, cchLen, lpInfo)))
-                        return E_FAIL;
-
-                    // Print Yes in value column
-                    cchLen = static_cast<DWORD>(_tcslen(c_szYes));
-                    if (FAILED(PrintLine(xVal, yLine, c_szYes, cchLen, lpInfo)))
-                        return E_FAIL;
-
-                    // Advance to next line on page
-                    if (FAILED(PrintNextLine(lpInfo)))
-                        return E_FAIL;
-                }
-                else if (g_dwViewState == IDM_VIEWALL)
-                {
-                    // Print name
-                    cchLen = static_cast<DWORD>(_tcslen(pcd->strName));
-                    if (FAILED(PrintLine(xName, yLine, pcd->strName, cchLen, lpInfo)))
-                        return E_FAIL;
-
-                    // Print No in value column
-                    cchLen = static_cast<DWORD>(_tcslen(c_szNo));
-                    if (FAILED(PrintLine(xVal, yLine, c_szNo, cchLen, lpInfo)))
-                        return E_FAIL;
-
-                    // Advance to next line on page
-                    if (FAILED(PrintNextLine(lpInfo)))
-                        return E_FAIL;
-                }
-                break;
-            }
-        }
-        else
-        {
-            char    szBuff[80];
+    // Captured models keep the whole vector, whatever the view shows
+    if (lpInfo->pModel)
+        lpInfo->pModel->caps.Append(vec);
 
-            // Print name
-            sprintf_s(szBuff, sizeof(szBuff), pcd->strName, "test");
-            cchLen = static_cast<DWORD>(_tcslen(pcd->strName));
-            if (FAILED(PrintLine(xName, yLine, szBuff, cchLen, lpInfo)))
-                return E_FAIL;
+    // Calculate Name and Value column x offsets
+    PRINTCAPSINFO print;
+    print.pInfo = lpInfo;
+    print.xName = (lpInfo->dwCurrIndent * DEF_TAB_SIZE * lpInfo->dwCharWidth);
+    print.xVal = print.xName + (50 * lpInfo->dwCharWidth);
 
-            // Print value
-            Int2Str(szBuff, 80, dwValue);
-            cchLen = static_cast<DWORD>(_tcslen(szBuff));
-            if (FAILED(PrintLine(xVal, yLine, szBuff, cchLen, lpInfo)))
-                return E_FAIL;
+    size_t numRows = lpInfo->pModel ? lpInfo->pModel->rows.size() : 0;
+    HRESULT hr = EvalCaps(pcd, vec, PrintCapValue, &print);
 
-            // Advance to next line on page
-            if (FAILED(PrintNextLine(lpInfo)))
-                return E_FAIL;
-        }
-
-        pcd++;  // Get next Cap bit definition
-    }
+    if (lpInfo->pModel)
+        lpInfo->pModel->capRows += static_cast<uint32_t>(lpInfo->pModel->rows.size() - numRows);
 
-    return S_OK;
+    return hr;
 }
 
 
@@ -881,14 +1484,17 @@ void DXView_OnTreeSelect(HWND /*hwndTV*/, NM_TREEVIEW* ptv)
         pni = (NODEINFO*)ptv->itemNew.lParam;
     }
 
-    if (pni && pni->fnDisplayCallback)
+    if (pni && pni->pCaptured)
     {
-        if (pni->bUseLParam3)
-            ((DISPLAYCALLBACKEX)(pni->fnDisplayCallback))(pni->lParam1, pni->lParam2, pni->lParam3, nullptr);
-        else
-            pni->fnDisplayCallback(pni->lParam1, pni->lParam2, nullptr);
+        g_lvStore = pni->pCaptured->list[CaptureViewIndex()];
+    }
+    else if (pni && pni->fnDisplayCallback)
+    {
+        CallDisplayCallback(pni, nullptr);
     }
 
+    LVShowItems(g_hwndLV);
+
     ListView_SetItemState(g_hwndLV, 0, LVIS_SELECTED | LVIS_FOCUSED, LVIS_SELECTED | LVIS_FOCUSED);
 
     SendMessage(g_hwndLV, WM_SETREDRAW, TRUE, 0);
@@ -919,6 +1525,7 @@ void DXView_OnCommand(HWND hWnd, WPARAM wParam)
         CheckMenuItem(hMenu, g_dwViewState, MF_BYCOMMAND | MF_UNCHECKED);
         g_dwViewState = LOWORD(wParam);
         CheckMenuItem(hMenu, g_dwViewState, MF_BYCOMMAND | MF_CHECKED);
+        DXView_ResetSearch();
         DXView_OnTreeSelect(g_hwndTV, nullptr);
         break;
 
@@ -926,6 +1533,7 @@ void DXView_OnCommand(HWND hWnd, WPARAM wParam)
         hMenu = GetMenu(hWnd);
         g_dwView9Ex = !g_dwView9Ex;
         CheckMenuItem(hMenu, IDM_VIEW9EX, MF_BYCOMMAND | (g_dwView9Ex ? MF_CHECKED : MF_UNCHECKED));
+        DXView_ResetSearch();
         DXView_OnTreeSelect(g_hwndTV, nullptr);
         break;
 
@@ -984,12 +1592,20 @@ void DXView_OnCommand(HWND hWnd, WPARAM wParam)
 //-----------------------------------------------------------------------------
 void DXView_Cleanup()
 {
+    DXView_FreeSearch();
+
     DXGI_CleanUp();
 
     DXG_CleanUp();
 
     DD_CleanUp();
 
+    TVFreeHeadlessTree();
+
+    DXView_FreeSnapshot();
+
+    FreeCapLayouts();
+
     if (g_hImageList)
         ImageList_Destroy(g_hImageList);
 }
@@ -1107,7 +1723,7 @@ VOID DXView_OnSize(HWND hWnd)
         return;
 
     HDWP hDWP;
-    if ((hDWP = BeginDeferWindowPos(2)) != nullptr)
+    if ((hDWP = BeginDeferWindowPos(3)) != nullptr)
     {
         //  Data structure used when calling GetEffectiveClientRect (which takes into
         //  account space taken up by the toolbars/status bars).  First half of the
@@ -1122,10 +1738,16 @@ VOID DXView_OnSize(HWND hWnd)
         GetEffectiveClientRect(hWnd, &ClientRect, s_EffectiveClientRectData);
         int Height = ClientRect.bottom - ClientRect.top;
 
+        // The search box sits above the tree
+        int cySearch = g_hwndSearch ? __min(g_cySearch, Height) : 0;
+        if (g_hwndSearch)
+            DeferWindowPos(hDWP, g_hwndSearch, nullptr, 0, ClientRect.top, g_xPaneSplit,
+                cySearch, SWP_NOZORDER | SWP_NOACTIVATE);
+
         HWND hKeyTreeWnd = g_hwndTV;
 
-        DeferWindowPos(hDWP, hKeyTreeWnd, nullptr, 0, ClientRect.top, g_xPaneSplit,
-            Height, SWP_NOZORDER | SWP_NOACTIVATE);
+        DeferWindowPos(hDWP, hKeyTreeWnd, nullptr, 0, ClientRect.top + cySearch, g_xPaneSplit,
+            Height - cySearch, SWP_NOZORDER | SWP_NOACTIVATE);
 
         int x = g_xPaneSplit + GetSystemMetrics(SM_CXSIZEFRAME);
         int dx = ClientRect.right - ClientRect.left - x;
@@ -1141,58 +1763,596 @@ VOID DXView_OnSize(HWND hWnd)
 
 
 //-----------------------------------------------------------------------------
-void LVAddColumn(HWND hwndLV, int i, const char* name, int width)
+// Name: LVAddColumn()
+// Desc: Sets column i, dropping all the columns when i is 0. Like the rows,
+//       nothing is sent to the list view until LVShowItems.
+//-----------------------------------------------------------------------------
+void LVAddColumn(HWND /*hwndLV*/, int i, const char* name, int width)
 {
+    if (i < 0)
+        return;
+
     if (i == 0)
+        g_lvStore.columns.clear();
+
+    if (static_cast<size_t>(i) >= g_lvStore.columns.size())
+        g_lvStore.columns.resize(static_cast<size_t>(i) + 1);
+
+    g_lvStore.columns[i].name = name ? name : "";
+    g_lvStore.columns[i].width = width;
+}
+
+
+namespace
+{
+    //-----------------------------------------------------------------------------
+    const char* LVGetCellText(const LVROW& row, int col)
     {
-        while (ListView_DeleteColumn(hwndLV, 0))
-            ;
+        // Search backwards so the last text set for a column wins
+        for (uint32_t i = row.numCells; i > 0; --i)
+        {
+            const LVCELL& cell = g_lvStore.cells[row.firstCell + i - 1];
+            if (cell.col == col)
+                return &g_lvStore.text[cell.offset];
+        }
+
+        return "";
     }
 
-    LV_COLUMN col = {};
-    col.mask = LVCF_FMT | LVCF_WIDTH | LVCF_TEXT;
-    col.fmt = LVCFMT_LEFT;
-    col.pszText = (char*)name;
-    col.cx = width * g_tmAveCharWidth;
-    ListView_InsertColumn(hwndLV, i, &col);
+    //-----------------------------------------------------------------------------
+    // Name: LVCompareText()
+    // Desc: Sort order for a column. Cells that are both numbers compare by
+    //       value, so "16" sorts after "8".
+    //-----------------------------------------------------------------------------
+    int LVCompareText(const char* str1, const char* str2)
+    {
+        char* pEnd1 = nullptr;
+        char* pEnd2 = nullptr;
+        double val1 = strtod(str1, &pEnd1);
+        double val2 = strtod(str2, &pEnd2);
+        if (pEnd1 != str1 && !*pEnd1 && pEnd2 != str2 && !*pEnd2)
+            return (val1 < val2) ? -1 : ((val1 > val2) ? 1 : 0);
+
+        return _stricmp(str1, str2);
+    }
 }
 
 
 //-----------------------------------------------------------------------------
-int LVAddText(HWND hwndLV, int col, const char* sz, ...)
+// Name: LVAddText()
+// Desc: Adds a row when col is 0, otherwise sets a column of the last row.
+//       Nothing is sent to the list view until LVShowItems.
+//-----------------------------------------------------------------------------
+int LVAddText(HWND /*hwndLV*/, int col, const char* sz, ...)
 {
     va_list vl;
     va_start(vl, sz);
+    int cch = _vscprintf(sz, vl);
+    va_end(vl);
 
-    char    ach[80];
-    vsprintf_s(ach, sizeof(ach), sz, vl);
-    ach[79] = '\0';
-
-    LV_ITEM lvi = {};
-    lvi.mask = LVIF_TEXT;
-    lvi.pszText = ach;
+    if (cch < 0)
+        return -1;
 
     if (col == 0)
     {
-        lvi.iItem = 0x7FFF;
-        lvi.iSubItem = 0;
-        va_end(vl);
-        return ListView_InsertItem(hwndLV, &lvi);
+        LVROW row = { static_cast<uint32_t>(g_lvStore.cells.size()), 0 };
+        g_lvStore.rows.push_back(row);
     }
-    else
+    else if (g_lvStore.rows.empty())
     {
-        lvi.iItem = ListView_GetItemCount(hwndLV) - 1;
-        lvi.iSubItem = col;
-        va_end(vl);
-        return ListView_SetItem(hwndLV, &lvi);
+        return -1;
     }
+
+    LVCELL cell = { col, static_cast<uint32_t>(g_lvStore.text.size()) };
+    g_lvStore.text.resize(g_lvStore.text.size() + cch + 1);
+
+    va_start(vl, sz);
+    vsprintf_s(&g_lvStore.text[cell.offset], static_cast<size_t>(cch) + 1, sz, vl);
+    va_end(vl);
+
+    g_lvStore.cells.push_back(cell);
+    g_lvStore.rows.back().numCells++;
+
+    return static_cast<int>(g_lvStore.rows.size()) - 1;
 }
 
 
 //-----------------------------------------------------------------------------
 void LVDeleteAllItems(HWND hwndLV)
 {
-    ListView_DeleteAllItems(hwndLV);
+    g_lvStore = {};
+    g_lvSortCol = -1;
+    g_lvSortAscending = TRUE;
+
+    ListView_SetItemCountEx(hwndLV, 0, 0);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: LVShowItems()
+// Desc: Hands the columns and rows added since LVDeleteAllItems to the list view
+//-----------------------------------------------------------------------------
+VOID LVShowItems(HWND hwndLV)
+{
+    while (ListView_DeleteColumn(hwndLV, 0))
+        ;
+
+    for (size_t i = 0; i < g_lvStore.columns.size(); ++i)
+    {
+        LV_COLUMN col = {};
+        col.mask = LVCF_FMT | LVCF_WIDTH | LVCF_TEXT;
+        col.fmt = LVCFMT_LEFT;
+        col.pszText = const_cast<char*>(g_lvStore.columns[i].name.c_str());
+        col.cx = g_lvStore.columns[i].width * g_tmAveCharWidth;
+        ListView_InsertColumn(hwndLV, static_cast<int>(i), &col);
+    }
+
+    ListView_SetItemCountEx(hwndLV, static_cast<int>(g_lvStore.rows.size()), LVSICF_NOSCROLL);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_OnListViewDispInfo()
+// Desc: Fills in the text of a cell that is about to be drawn
+//-----------------------------------------------------------------------------
+VOID DXView_OnListViewDispInfo(NMLVDISPINFO* pdi)
+{
+    LVITEM& item = pdi->item;
+    if (!(item.mask & LVIF_TEXT) || !item.pszText || item.cchTextMax <= 0)
+        return;
+
+    if (item.iItem < 0 || static_cast<size_t>(item.iItem) >= g_lvStore.rows.size())
+    {
+        *item.pszText = '\0';
+        return;
+    }
+
+    strncpy_s(item.pszText, static_cast<size_t>(item.cchTextMax),
+        LVGetCellText(g_lvStore.rows[item.iItem], item.iSubItem), _TRUNCATE);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_OnListViewColumnClick()
+// Desc: Sorts the rows by the clicked column, reversing the order on a second
+//       click of the same one
+//-----------------------------------------------------------------------------
+VOID DXView_OnListViewColumnClick(HWND hwndLV, NM_LISTVIEW* plv)
+{
+    int col = plv->iSubItem;
+    if (col == g_lvSortCol)
+        g_lvSortAscending = !g_lvSortAscending;
+    else
+        g_lvSortAscending = TRUE;
+    g_lvSortCol = col;
+
+    BOOL bAscending = g_lvSortAscending;
+    std::stable_sort(g_lvStore.rows.begin(), g_lvStore.rows.end(),
+        [col, bAscending](const LVROW& row1, const LVROW& row2)
+        {
+            int result = LVCompareText(LVGetCellText(row1, col), LVGetCellText(row2, col));
+            return bAscending ? (result < 0) : (result > 0);
+        });
+
+    InvalidateRect(hwndLV, nullptr, FALSE);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: LVSelectRow()
+// Desc: Selects the nth row named strName, counting from 0 in the order the
+//       rows were added, and scrolls it into view. Returns the row or -1.
+//-----------------------------------------------------------------------------
+int LVSelectRow(HWND hwndLV, const CHAR* strName, UINT nth)
+{
+    // Sorting moves rows, but cells are only ever appended, so the order
+    // the rows were added in is that of their first cell
+    std::vector<std::pair<uint32_t, int>> found;
+    for (size_t i = 0; i < g_lvStore.rows.size(); ++i)
+    {
+        const LVROW& row = g_lvStore.rows[i];
+        if (!strcmp(LVGetCellText(row, 0), strName))
+            found.emplace_back(row.firstCell, static_cast<int>(i));
+    }
+
+    if (found.empty())
+        return -1;
+
+    nth = __min(nth, static_cast<UINT>(found.size() - 1));
+    std::nth_element(found.begin(), found.begin() + nth, found.end());
+    int iFound = found[nth].second;
+
+    ListView_SetItemState(hwndLV, -1, 0, LVIS_SELECTED | LVIS_FOCUSED);
+    ListView_SetItemState(hwndLV, iFound, LVIS_SELECTED | LVIS_FOCUSED, LVIS_SELECTED | LVIS_FOCUSED);
+    ListView_EnsureVisible(hwndLV, iFound, FALSE);
+
+    return iFound;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: TVFreeHeadlessTree()
+// Desc: Frees every node added while headless
+//-----------------------------------------------------------------------------
+VOID TVFreeHeadlessTree()
+{
+    FreeHeadlessNodes(g_pHeadlessRoot);
+    g_pHeadlessRoot = g_pHeadlessLast = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: TVDeleteNode()
+// Desc: Removes a node and everything below it from the treeview, freeing
+//       what each node kept
+//-----------------------------------------------------------------------------
+VOID TVDeleteNode(HWND hwndTV, HTREEITEM hItem)
+{
+    // Select the parent first, so the list view never shows a freed node
+    for (HTREEITEM hSel = TreeView_GetSelection(hwndTV); hSel; hSel = TreeView_GetParent(hwndTV, hSel))
+    {
+        if (hSel == hItem)
+        {
+            TreeView_SelectItem(hwndTV, TreeView_GetParent(hwndTV, hItem));
+            break;
+        }
+    }
+
+    FreeTreeViewNodes(hwndTV, hItem);
+    TreeView_DeleteItem(hwndTV, hItem);
+}
+
+
+namespace
+{
+    //-----------------------------------------------------------------------------
+    // Name: RunNodeCallback()
+    // Desc: Captures what the node's display callback prints under the current
+    //       view options
+    //-----------------------------------------------------------------------------
+    HRESULT RunNodeCallback(const NODEINFO* pni, CAPMODEL& model)
+    {
+        model.viewState = g_dwViewState;
+        model.view9Ex = g_dwView9Ex;
+
+        // Capture in character units with no indent, PrintCapModel adds those back
+        PRINTCBINFO pci = {};
+        pci.dwCharWidth = 1;
+        pci.dwLineHeight = 1;
+        pci.dwCharsPerLine = 80;
+        pci.dwLinesPerPage = 66;
+        pci.pModel = &model;
+
+        HRESULT hr = CallDisplayCallback(pni, &pci);
+
+        if (SUCCEEDED(hr))
+            model.Flush();
+
+        return hr;
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: CaptureNode()
+    // Desc: Keeps everything the node displays under each view option. The list
+    //       view's rows are only needed when there is a list view.
+    //-----------------------------------------------------------------------------
+    BOOL CaptureNode(NODEINFO* pni, BOOL bList)
+    {
+        if (!pni || !pni->fnDisplayCallback || pni->pCaptured)
+            return TRUE;
+
+        auto pCaptured = new (std::nothrow) CAPTUREDNODE;
+        if (!pCaptured)
+            return FALSE;
+
+        DWORD dwViewState = g_dwViewState;
+
+        HRESULT hr = S_OK;
+        for (UINT i = 0; i < std::size(c_dwCaptureViews) && SUCCEEDED(hr); ++i)
+        {
+            g_dwViewState = c_dwCaptureViews[i];
+
+            // The search or a save may have built this one already
+            const CAPMODEL* pModel = pni->pModel;
+            if (pModel && pModel->viewState == g_dwViewState && pModel->view9Ex == g_dwView9Ex)
+                pCaptured->model[i] = *pModel;
+            else
+                hr = RunNodeCallback(pni, pCaptured->model[i]);
+
+            if (SUCCEEDED(hr) && bList)
+            {
+                // Collect the rows aside, leaving those of the node being shown alone
+                LVSTORE shown;
+                std::swap(shown, g_lvStore);
+
+                // As DXView_OnTreeSelect starts out
+                LVAddColumn(g_hwndLV, 0, "", 0);
+
+                CallDisplayCallback(pni, nullptr);
+
+                pCaptured->list[i] = std::move(g_lvStore);
+                g_lvStore = std::move(shown);
+            }
+        }
+
+        g_dwViewState = dwViewState;
+
+        if (FAILED(hr))
+        {
+            delete pCaptured;
+            return FALSE;
+        }
+
+        delete pni->pModel;
+        pni->pModel = nullptr;
+        pni->pCaptured = pCaptured;
+        return TRUE;
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: ForgetNodeParams()
+    // Desc: Nothing reads the lParams of a node once it's captured and its
+    //       children are added, so they're cleared rather than left pointing
+    //       at objects about to be released
+    //-----------------------------------------------------------------------------
+    VOID ForgetNodeParams(NODEINFO* pni)
+    {
+        if (pni && !pni->fnExpandCallback && (pni->pCaptured || !pni->fnDisplayCallback))
+        {
+            pni->lParam1 = 0;
+            pni->lParam2 = 0;
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    BOOL CaptureTreeView(HWND hwndTV, HTREEITEM hItem)
+    {
+        TV_ITEM tvi = {};
+        tvi.mask = TVIF_CHILDREN | TVIF_PARAM;
+        tvi.hItem = hItem;
+        if (!TreeView_GetItem(hwndTV, &tvi))
+            return FALSE;
+
+        auto pni = reinterpret_cast<NODEINFO*>(tvi.lParam);
+        if (!CaptureNode(pni, TRUE))
+            return FALSE;
+
+        if (tvi.cChildren)
+        {
+            (void)TVExpandLazyNode(hwndTV, hItem);
+
+            for (HTREEITEM hChild = TreeView_GetChild(hwndTV, hItem); hChild;
+                hChild = TreeView_GetNextSibling(hwndTV, hChild))
+            {
+                if (!CaptureTreeView(hwndTV, hChild))
+                    return FALSE;
+            }
+        }
+
+        ForgetNodeParams(pni);
+        return TRUE;
+    }
+
+    //-----------------------------------------------------------------------------
+    BOOL CaptureHeadless(HEADLESSNODE* pNode)
+    {
+        if (!CaptureNode(pNode->pni, FALSE))
+            return FALSE;
+
+        if (pNode->bKids)
+        {
+            (void)TVExpandLazyNode(nullptr, reinterpret_cast<HTREEITEM>(pNode));
+
+            for (HEADLESSNODE* pChild = pNode->pFirstChild; pChild; pChild = pChild->pNext)
+            {
+                if (!CaptureHeadless(pChild))
+                    return FALSE;
+            }
+        }
+
+        ForgetNodeParams(pNode->pni);
+        return TRUE;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: TVGetNodeModel()
+// Desc: Returns the caps for a node, running its display callback only the
+//       first time (or when the view options have changed since)
+//-----------------------------------------------------------------------------
+const CAPMODEL* TVGetNodeModel(NODEINFO* pni)
+{
+    if (!pni || !pni->fnDisplayCallback)
+        return nullptr;
+
+    // Captured nodes don't depend on the 9Ex view (see TVCaptureNodes)
+    if (pni->pCaptured)
+        return &pni->pCaptured->model[CaptureViewIndex()];
+
+    if (pni->pModel)
+    {
+        if (pni->pModel->viewState == g_dwViewState && pni->pModel->view9Ex == g_dwView9Ex)
+            return pni->pModel;
+
+        delete pni->pModel;
+        pni->pModel = nullptr;
+    }
+
+    auto pModel = new (std::nothrow) CAPMODEL;
+    if (!pModel)
+        return nullptr;
+
+    if (FAILED(RunNodeCallback(pni, *pModel)))
+    {
+        delete pModel;
+        return nullptr;
+    }
+
+    pni->pModel = pModel;
+    return pModel;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: TVCaptureNodes()
+// Desc: Runs the display callbacks of hItem and everything below it under each
+//       view option and keeps the results, after which the nodes no longer use
+//       whatever their lParams point at and they're cleared. Only for nodes that
+//       don't depend on the 9Ex view. Returns FALSE if any callback failed, in
+//       which case the nodes that weren't captured still need their lParams.
+//-----------------------------------------------------------------------------
+BOOL TVCaptureNodes(HWND hwndTV, HTREEITEM hItem)
+{
+    if (!hItem || hItem == TVI_ROOT)
+        return FALSE;
+
+    if (!hwndTV)
+        return CaptureHeadless(reinterpret_cast<HEADLESSNODE*>(hItem));
+
+    return CaptureTreeView(hwndTV, hItem);
+}
+
+
+namespace
+{
+    //-----------------------------------------------------------------------------
+    VOID StoreToList(const LVSTORE& store, CAPLIST& list)
+    {
+        list.columns.clear();
+        for (const auto& column : store.columns)
+            list.columns.push_back({ column.name, static_cast<uint32_t>(column.width) });
+
+        list.rows.clear();
+        list.rows.reserve(store.rows.size());
+        for (const auto& row : store.rows)
+        {
+            std::vector<CAPLISTCELL> cells;
+            cells.reserve(row.numCells);
+            for (uint32_t i = 0; i < row.numCells; ++i)
+            {
+                const LVCELL& cell = store.cells[row.firstCell + i];
+                cells.push_back({ static_cast<uint32_t>(cell.col), &store.text[cell.offset] });
+            }
+            list.rows.push_back(std::move(cells));
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    // Name: GetNodeModel()
+    // Desc: TVGetNodeModel, along with what the node shows in the list view
+    //       when bList is set
+    //-----------------------------------------------------------------------------
+    const CAPMODEL* GetNodeModel(NODEINFO* pni, BOOL bList)
+    {
+        const CAPMODEL* pModel = TVGetNodeModel(pni);
+        if (!pModel || !bList || !pModel->list.columns.empty())
+            return pModel;
+
+        // The lParams of a captured node are gone by now, so its list is the
+        // one kept when it was captured, which is empty if it was headless
+        if (pni->pCaptured)
+        {
+            CAPMODEL& model = pni->pCaptured->model[CaptureViewIndex()];
+            StoreToList(pni->pCaptured->list[CaptureViewIndex()], model.list);
+            return &model;
+        }
+
+        // Collect the rows aside, leaving those of the node being shown alone
+        LVSTORE shown;
+        std::swap(shown, g_lvStore);
+
+        // As DXView_OnTreeSelect starts out
+        LVAddColumn(g_hwndLV, 0, "", 0);
+
+        CallDisplayCallback(pni, nullptr);
+
+        StoreToList(g_lvStore, pni->pModel->list);
+        g_lvStore = std::move(shown);
+        return pni->pModel;
+    }
+
+    //-----------------------------------------------------------------------------
+    HRESULT WalkTreeView(HWND hwndTV, HTREEITEM hItem, DWORD dwDepth, CAPSINK* pSink)
+    {
+        for (; hItem; hItem = TreeView_GetNextSibling(hwndTV, hItem))
+        {
+            CHAR strText[80] = {};
+
+            TV_ITEM tvi = {};
+            tvi.mask = TVIF_CHILDREN | TVIF_TEXT | TVIF_PARAM;
+            tvi.hItem = hItem;
+            tvi.pszText = strText;
+            tvi.cchTextMax = static_cast<int>(std::size(strText));
+            if (!TreeView_GetItem(hwndTV, &tvi))
+                continue;
+
+            auto pni = reinterpret_cast<NODEINFO*>(tvi.lParam);
+            const CAPMODEL* pModel = GetNodeModel(pni, pSink->WantsLists());
+            if (pni && pni->fnDisplayCallback && !pModel)
+                return E_FAIL;
+
+            HRESULT hr = pSink->OnNode(strText, dwDepth, pModel);
+            if (FAILED(hr))
+                return hr;
+
+            if (tvi.cChildren)
+            {
+                // Probe any subtree that hasn't been expanded yet
+                (void)TVExpandLazyNode(hwndTV, hItem);
+
+                hr = WalkTreeView(hwndTV, TreeView_GetChild(hwndTV, hItem), dwDepth + 1, pSink);
+                if (FAILED(hr))
+                    return hr;
+            }
+        }
+
+        return S_OK;
+    }
+
+    //-----------------------------------------------------------------------------
+    HRESULT WalkHeadless(HEADLESSNODE* pNode, DWORD dwDepth, CAPSINK* pSink)
+    {
+        for (; pNode; pNode = pNode->pNext)
+        {
+            const CAPMODEL* pModel = GetNodeModel(pNode->pni, pSink->WantsLists());
+            if (pNode->pni && pNode->pni->fnDisplayCallback && !pModel)
+                return E_FAIL;
+
+            HRESULT hr = pSink->OnNode(pNode->strText, dwDepth, pModel);
+            if (FAILED(hr))
+                return hr;
+
+            if (pNode->bKids)
+            {
+                // Probe any subtree that hasn't been expanded yet
+                (void)TVExpandLazyNode(nullptr, reinterpret_cast<HTREEITEM>(pNode));
+
+                hr = WalkHeadless(pNode->pFirstChild, dwDepth + 1, pSink);
+                if (FAILED(hr))
+                    return hr;
+            }
+        }
+
+        return S_OK;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: TVWalkModels()
+// Desc: Pre-order traversal of the whole tree, handing every node and its caps
+//       to pSink. Uses the in-memory tree when hwndTV is nullptr.
+//-----------------------------------------------------------------------------
+HRESULT TVWalkModels(HWND hwndTV, CAPSINK* pSink)
+{
+    if (!pSink)
+        return E_INVALIDARG;
+
+    if (!hwndTV)
+        return WalkHeadless(g_pHeadlessRoot, 0, pSink);
+
+    return WalkTreeView(hwndTV, TreeView_GetRoot(hwndTV), 0, pSink);
 }
 
 
@@ -1201,7 +2361,7 @@ HTREEITEM TVAddNode(HTREEITEM hParent, LPCSTR strText, BOOL fKids,
     int iImage, DISPLAYCALLBACK fnDisplayCallback, LPARAM lParam1,
     LPARAM lParam2)
 {
-    auto pni = reinterpret_cast<NODEINFO*>(LocalAlloc(LPTR, sizeof(NODEINFO)));
+    NODEINFO* pni = AllocNodeInfo(strText);
     if (!pni)
         return nullptr;
 
@@ -1211,19 +2371,188 @@ HTREEITEM TVAddNode(HTREEITEM hParent, LPCSTR strText, BOOL fKids,
     pni->lParam3 = 0;
     pni->fnDisplayCallback = fnDisplayCallback;
 
-    // Add Node to treeview
-    TV_INSERTSTRUCT tvi = {};
-    tvi.hParent = hParent;
-    tvi.hInsertAfter = TVI_LAST;
-    tvi.item.mask = TVIF_TEXT | TVIF_IMAGE | TVIF_SELECTEDIMAGE |
-        TVIF_PARAM | TVIF_CHILDREN;
-    tvi.item.iImage = iImage - IDI_FIRSTIMAGE;
-    tvi.item.iSelectedImage = iImage - IDI_FIRSTIMAGE;
-    tvi.item.lParam = (LPARAM)pni;
-    tvi.item.cChildren = fKids;
-    tvi.item.pszText = (LPSTR)strText;
-
-    return TreeView_InsertItem(g_hwndTV, &tvi);
+    return TVInsertNode(hParent, strText, fKids, iImage, pni);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: TVAddLazyNode()
+// Desc: Adds a node whose children are only probed and added the first time
+//       it is expanded (see TVExpandLazyNode)
+//-----------------------------------------------------------------------------
+HTREEITEM TVAddLazyNode(HTREEITEM hParent, LPCSTR strText, int iImage,
+    EXPANDCALLBACK fnExpandCallback, LPARAM lParam1, LPARAM lParam2, LPARAM lParam3)
+{
+    NODEINFO* pni = AllocNodeInfo(strText);
+    if (!pni)
+        return nullptr;
+
+    pni->bUseLParam3 = TRUE;
+    pni->lParam1 = lParam1;
+    pni->lParam2 = lParam2;
+    pni->lParam3 = lParam3;
+    pni->fnDisplayCallback = nullptr;
+    pni->fnExpandCallback = fnExpandCallback;
+
+    // Always add an expand button until it's been probed
+    return TVInsertNode(hParent, strText, TRUE, iImage, pni);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: TVExpandLazyNode()
+// Desc: Runs the expand callback of a lazy node once. Returns TRUE if the
+//       node was populated by this call.
+//-----------------------------------------------------------------------------
+BOOL TVExpandLazyNode(HWND hwndTV, HTREEITEM hItem)
+{
+    if (!hwndTV)
+    {
+        // Headless, so hItem is one of our in-memory nodes
+        auto pNode = reinterpret_cast<HEADLESSNODE*>(hItem);
+        if (!pNode || !pNode->pni || !pNode->pni->fnExpandCallback)
+            return FALSE;
+
+        NODEINFO* pni = pNode->pni;
+        EXPANDCALLBACK fnExpandCallback = pni->fnExpandCallback;
+        pni->fnExpandCallback = nullptr;
+
+        fnExpandCallback(nullptr, hItem, pni->lParam1, pni->lParam2, pni->lParam3);
+
+        if (!pNode->pFirstChild)
+            pNode->bKids = FALSE;
+
+        return TRUE;
+    }
+
+    TV_ITEM tvi = {};
+    tvi.hItem = hItem;
+    tvi.mask = TVIF_PARAM;
+    if (!TreeView_GetItem(hwndTV, &tvi))
+        return FALSE;
+
+    auto pni = reinterpret_cast<NODEINFO*>(tvi.lParam);
+    if (!pni || !pni->fnExpandCallback)
+        return FALSE;
+
+    // Clear the callback first so the probe results (the child nodes) are
+    // kept for the lifetime of the tree and never probed again
+    EXPANDCALLBACK fnExpandCallback = pni->fnExpandCallback;
+    pni->fnExpandCallback = nullptr;
+
+    fnExpandCallback(hwndTV, hItem, pni->lParam1, pni->lParam2, pni->lParam3);
+
+    if (!TreeView_GetChild(hwndTV, hItem))
+    {
+        // Nothing supported, so drop the expand button
+        tvi.mask = TVIF_CHILDREN;
+        tvi.cChildren = 0;
+        TreeView_SetItem(hwndTV, &tvi);
+    }
+
+    return TRUE;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: TVExpandAll()
+// Desc: Fills in hItem and every lazy node below it, without running any
+//       display callbacks
+//-----------------------------------------------------------------------------
+VOID TVExpandAll(HWND hwndTV, HTREEITEM hItem)
+{
+    (void)TVExpandLazyNode(hwndTV, hItem);
+
+    if (!hwndTV)
+    {
+        auto pNode = reinterpret_cast<HEADLESSNODE*>(hItem);
+        for (HEADLESSNODE* pChild = pNode ? pNode->pFirstChild : nullptr; pChild; pChild = pChild->pNext)
+            TVExpandAll(nullptr, reinterpret_cast<HTREEITEM>(pChild));
+        return;
+    }
+
+    for (HTREEITEM hChild = TreeView_GetChild(hwndTV, hItem); hChild; hChild = TreeView_GetNextSibling(hwndTV, hChild))
+        TVExpandAll(hwndTV, hChild);
+}
+
+
+namespace
+{
+    //-----------------------------------------------------------------------------
+    UINT CountHeadlessNodes(const HEADLESSNODE* pNode)
+    {
+        UINT count = 0;
+        for (; pNode; pNode = pNode->pNext)
+            count += 1 + CountHeadlessNodes(pNode->pFirstChild);
+        return count;
+    }
+
+    //-----------------------------------------------------------------------------
+    VOID FreeNodeModel(NODEINFO* pni)
+    {
+        if (!pni)
+            return;
+
+        delete pni->pModel;
+        pni->pModel = nullptr;
+    }
+
+    //-----------------------------------------------------------------------------
+    VOID FreeHeadlessModels(HEADLESSNODE* pNode)
+    {
+        for (; pNode; pNode = pNode->pNext)
+        {
+            FreeNodeModel(pNode->pni);
+            FreeHeadlessModels(pNode->pFirstChild);
+        }
+    }
+
+    //-----------------------------------------------------------------------------
+    VOID FreeTreeViewModels(HWND hwndTV, HTREEITEM hItem)
+    {
+        for (; hItem; hItem = TreeView_GetNextSibling(hwndTV, hItem))
+        {
+            TV_ITEM tvi = {};
+            tvi.mask = TVIF_PARAM;
+            tvi.hItem = hItem;
+            if (TreeView_GetItem(hwndTV, &tvi))
+                FreeNodeModel(reinterpret_cast<NODEINFO*>(tvi.lParam));
+
+            FreeTreeViewModels(hwndTV, TreeView_GetChild(hwndTV, hItem));
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: TVCountNodes()
+// Desc: How many nodes the tree has so far, not counting those lazy nodes
+//       have yet to add
+//-----------------------------------------------------------------------------
+UINT TVCountNodes(HWND hwndTV)
+{
+    if (!hwndTV)
+        return CountHeadlessNodes(g_pHeadlessRoot);
+
+    return TreeView_GetCount(hwndTV);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: TVFreeNodeModels()
+// Desc: Drops every node's caps built by TVGetNodeModel, so the display
+//       callbacks run again the next time they're asked for. Captured nodes
+//       keep theirs.
+//-----------------------------------------------------------------------------
+VOID TVFreeNodeModels(HWND hwndTV)
+{
+    if (!hwndTV)
+    {
+        FreeHeadlessModels(g_pHeadlessRoot);
+        return;
+    }
+
+    FreeTreeViewModels(hwndTV, TreeView_GetRoot(hwndTV));
 }
 
 
@@ -1232,7 +2561,7 @@ HTREEITEM TVAddNodeEx(HTREEITEM hParent, LPCSTR strText, BOOL fKids,
     int iImage, DISPLAYCALLBACKEX fnDisplayCallback, LPARAM lParam1,
     LPARAM lParam2, LPARAM lParam3)
 {
-    auto pni = reinterpret_cast<NODEINFO*>(LocalAlloc(LPTR, sizeof(NODEINFO)));
+    NODEINFO* pni = AllocNodeInfo(strText);
     if (!pni)
         return nullptr;
 
@@ -1242,17 +2571,5 @@ HTREEITEM TVAddNodeEx(HTREEITEM hParent, LPCSTR strText, BOOL fKids,
     pni->lParam3 = lParam3;
     pni->fnDisplayCallback = reinterpret_cast<DISPLAYCALLBACK>(fnDisplayCallback);
 
-    // Add Node to treeview
-    TV_INSERTSTRUCT tvi = {};
-    tvi.hParent = hParent;
-    tvi.hInsertAfter = TVI_LAST;
-    tvi.item.mask = TVIF_TEXT | TVIF_IMAGE | TVIF_SELECTEDIMAGE |
-        TVIF_PARAM | TVIF_CHILDREN;
-    tvi.item.iImage = iImage - IDI_FIRSTIMAGE;
-    tvi.item.iSelectedImage = iImage - IDI_FIRSTIMAGE;
-    tvi.item.lParam = (LPARAM)pni;
-    tvi.item.cChildren = fKids;
-    tvi.item.pszText = (LPSTR)strText;
-
-    return TreeView_InsertItem(g_hwndTV, &tvi);
+    return TVInsertNode(hParent, strText, fKids, iImage, pni);
 }
@@ -14,12 +14,17 @@
 #include <commctrl.h>
 #include <tchar.h>
 
+#include <atomic>
 #include <ctime>
 #include <cstdio>
 #include <iterator>
 #include <new>
+#include <type_traits>
+#include <utility>
 
 #include "resource.h"
+#include "dxmodel.h"
+#include "dxwatch.h"
 
 //-----------------------------------------------------------------------------
 // Defines
@@ -30,11 +35,25 @@
 
 #define IDC_LV          0x2000       // Child controls
 #define IDC_TV          0x2003
+#define IDC_SEARCH      0x2004
 
 #define IDI_FIRSTIMAGE  IDI_DIRECTX  // Imagelist first and last icons
 #define IDI_LASTIMAGE   IDI_CAPSOPEN
 
 #define TIMER_PERIOD	500
+#define IDT_ADAPTERS    1            // Checks for device changes every TIMER_PERIOD
+#define CAPTURE_PERIOD  50
+#define IDT_CAPTURE     2            // Captures a subtree and releases its devices every CAPTURE_PERIOD
+
+#define WM_SEARCHREADY  (WM_APP + 1) // The search index finished building, wParam is its generation
+#define WM_ADAPTERSPROBED (WM_APP + 2) // The adapters a device change touched have been re-probed
+
+#define WATCHDOG_CALL_TIMEOUT       30000   // Default -timeout, in ms
+#define WATCHDOG_ADAPTER_TIMEOUT    120000  // Default -adaptertimeout, in ms
+
+#define DXGISHARD_ALL   0xFFFFFFFF   // What a probe worker probes of DXGI (see DXGI_SetShard),
+#define DXGISHARD_WARP  0xFFFFFFFE   // when not a single adapter by index
+#define DXGISHARD_REF   0xFFFFFFFD
 
 #define SAFE_RELEASE(p)      { if (p) { (p)->Release(); (p)=nullptr; } }
 
@@ -54,10 +73,14 @@ struct PRINTCBINFO
     DWORD       dwLinesPerPage; // In:      maximum lines per page
     DWORD       dwCurrIndent;   // In:      Current tab setting
     BOOL        fStartPage;     // In/Out:  need to a start new page ?!?
+    CAPMODEL*   pModel;         // In:      capture into this model instead of printing
 };
 
 using DISPLAYCALLBACK = HRESULT(*)(LPARAM lParam1, LPARAM lParam2, _In_opt_ PRINTCBINFO* pPrintInfo);
 using DISPLAYCALLBACKEX = HRESULT(*)(LPARAM lParam1, LPARAM lParam2, LPARAM lParam3, _In_opt_ PRINTCBINFO* pPrintInfo);
+using EXPANDCALLBACK = VOID(*)(HWND hwndTV, HTREEITEM hParent, LPARAM lParam1, LPARAM lParam2, LPARAM lParam3);
+
+struct CAPTUREDNODE;
 
 struct NODEINFO
 {
@@ -66,18 +89,112 @@ struct NODEINFO
     LPARAM          lParam1;
     LPARAM          lParam2;
     LPARAM          lParam3;
+    EXPANDCALLBACK  fnExpandCallback;   // Fills in children on first expand, cleared once populated
+    CAPMODEL*       pModel;             // Output of fnDisplayCallback, built on first use
+    CAPTUREDNODE*   pCaptured;          // Everything the node displays, once the lParams are released
+    CHAR            strText[1];         // The node's text, for probe timing
+};
+
+// Headless capture keeps the nodes in memory instead of in a TreeView control
+struct HEADLESSNODE
+{
+    HEADLESSNODE*   pNext;          // Next sibling
+    HEADLESSNODE*   pFirstChild;
+    HEADLESSNODE*   pLastChild;
+    NODEINFO*       pni;
+    BOOL            bKids;
+    CHAR            strText[1];
+};
+
+// Receives each node of the tree along with its caps (see TVWalkModels)
+struct CAPSINK
+{
+    virtual HRESULT OnNode(LPCSTR strText, DWORD dwDepth, _In_opt_ const CAPMODEL* pModel) = 0;
+
+    // Whether the models handed to OnNode need their list views too
+    virtual BOOL WantsLists() const { return FALSE; }
+};
+
+using WATCHDOGPROC = VOID(*)(VOID* pContext);
+
+// A probe run on the thread pool that is given up on if a driver call hangs
+// (see dxwatchdog.cpp)
+struct WATCHDOGTASK
+{
+    WATCHDOGPROC            fnProc;
+    VOID*                   pContext;
+    PTP_WORK                pWork;          // Null once finished or abandoned
+    HANDLE                  hDone;
+    std::atomic<uint64_t>   heartbeat;      // Last driver call start or return, see t_pProbeHeartbeat
+
+    WATCHDOGTASK() noexcept : fnProc(nullptr), pContext(nullptr), pWork(nullptr), hDone(nullptr), heartbeat(0) {}
+
+    VOID Start(WATCHDOGPROC fnProbe, VOID* pProbeContext);
+    BOOL Wait(uint64_t deadline);
 };
 
 #define DXV_9EXCAP (1<<0)
 
+// How a CAPDEF reads and shows its field
+enum CAPDEFKIND : BYTE
+{
+    CAPDEF_FLAG = 0,        // Yes/No for dwFlag within a DWORD
+    CAPDEF_VALUE,           // 32-bit decimal
+    CAPDEF_HEX,             // 32-bit hexadecimal
+    CAPDEF_VERSION,         // Shader version
+    CAPDEF_FLOAT,
+    CAPDEF_HEX16,           // 16-bit hexadecimal
+    CAPDEF_VALUE16,         // 16-bit decimal
+    CAPDEF_UNLIMITED,       // 32-bit decimal, where -1 means unlimited
+    CAPDEF_MASK16,          // Low 16 bits of a DWORD, in decimal
+};
+
 struct CAPDEF
 {
     const CHAR*  strName;        // Name of cap
     LONG         dwOffset;       // Offset to cap
-    DWORD        dwFlag;         // Bit flag for cal
+    DWORD        dwFlag;         // Bit flag for CAPDEF_FLAG
     DWORD        dwCapsFlags;	   // used for optional caps and such (see DXV_ values above)
+    CAPDEFKIND   kind;
+};
+
+// The field type each kind reads
+template <CAPDEFKIND kind> struct CAPDEFFIELD { using Type = DWORD; };
+template <> struct CAPDEFFIELD<CAPDEF_FLOAT> { using Type = float; };
+template <> struct CAPDEFFIELD<CAPDEF_HEX16> { using Type = WORD; };
+template <> struct CAPDEFFIELD<CAPDEF_VALUE16> { using Type = WORD; };
+
+//-----------------------------------------------------------------------------
+// Name: CapDefKind()
+// Desc: Used by the CAPDEF table macros so a field that doesn't match its kind
+//       fails to compile, rather than being misread at dwOffset
+//-----------------------------------------------------------------------------
+template <typename TField, CAPDEFKIND kind>
+constexpr CAPDEFKIND CapDefKind()
+{
+    using TExpected = typename CAPDEFFIELD<kind>::Type;
+    static_assert(sizeof(TField) == sizeof(TExpected), "Cap field is the wrong width for its kind");
+    static_assert(std::is_floating_point<TField>::value == std::is_floating_point<TExpected>::value,
+        "Cap field is the wrong type for its kind");
+    return kind;
+}
+
+#define CAPDEFFIELDTYPE(caps, field) std::decay<decltype(std::declval<caps&>().field)>::type
+
+// Defines a CAPDEF row for caps::field
+#define CAPDEFROW(name, caps, field, flag, capsFlags, kind) \
+    { name, FIELD_OFFSET(caps, field), flag, capsFlags, CapDefKind<CAPDEFFIELDTYPE(caps, field), kind>() }
+
+// A cap as it's shown, see EvalCaps
+struct CAPVALUE
+{
+    CAPKIND     kind;
+    uint32_t    value;          // Raw value, as for CAPROW
+    CHAR        szValue[32];
 };
 
+using CAPVALUECALLBACK = HRESULT(*)(const CAPDEF& cd, const CAPVALUE& val, VOID* pContext);
+
 struct CAPDEFS
 {
     const CHAR*           strName;        // Name of cap
@@ -109,16 +226,37 @@ struct LOCALAPP
 VOID    LVAddColumn( HWND hwndLV, int i, const CHAR* strName, int width );
 int     LVAddText( HWND hwndLV, int col, const CHAR* str, ... );
 VOID    LVDeleteAllItems( HWND hwndLV );
+VOID    LVShowItems( HWND hwndLV );
+int     LVSelectRow( HWND hwndLV, const CHAR* strName, UINT nth );
 HTREEITEM TVAddNode( HTREEITEM hParent, LPCSTR strText, BOOL bKids, int iImage, 
                      DISPLAYCALLBACK Callback, LPARAM lParam1, LPARAM lParam2 );
 HTREEITEM TVAddNodeEx( HTREEITEM hParent, LPCSTR strText, BOOL bKids, int iImage, 
                      DISPLAYCALLBACKEX Callback, LPARAM lParam1, LPARAM lParam2, 
                      LPARAM lParam3 );
+HTREEITEM TVAddLazyNode( HTREEITEM hParent, LPCSTR strText, int iImage,
+                     EXPANDCALLBACK Callback, LPARAM lParam1, LPARAM lParam2,
+                     LPARAM lParam3 );
+BOOL    TVExpandLazyNode( HWND hwndTV, HTREEITEM hItem );
+VOID    TVExpandAll( HWND hwndTV, HTREEITEM hItem );
+UINT    TVCountNodes( HWND hwndTV );
+VOID    TVFreeNodeModels( HWND hwndTV );
+VOID    TVFreeHeadlessTree();
+const CAPMODEL* TVGetNodeModel( NODEINFO* pni );
+HRESULT TVWalkModels( HWND hwndTV, CAPSINK* pSink );
+BOOL    TVCaptureNodes( HWND hwndTV, HTREEITEM hItem );
+VOID    TVDeleteNode( HWND hwndTV, HTREEITEM hItem );
 VOID    AddCapsToTV( HTREEITEM hParent, CAPDEFS *pcds, LPARAM lParam1 );
 VOID    AddColsToLV();
 VOID    AddCapsToLV( CAPDEF* pcd, VOID* pv );
 VOID    AddMoreCapsToLV( CAPDEF* pcd, VOID* pv );
 HRESULT PrintCapsToDC( CAPDEF* pcd, VOID* pv, _In_ PRINTCBINFO* pInfo );
+BOOL    BuildCapVector( const CAPDEF* pcd, const VOID* pv, CAPVECTOR& vec );
+HRESULT EvalCaps( const CAPDEF* pcd, const CAPVECTOR& vec, CAPVALUECALLBACK fnValue, VOID* pContext );
+
+// Probe watchdog helper functions
+uint64_t WatchdogAdapterDeadline();
+BOOL    WatchdogRun( WATCHDOGPROC fnProc, VOID* pContext );
+VOID    WatchdogAddTimedOutNode( HTREEITEM hParent, LPCSTR strName );
 
 // Printer Helper functions
 HRESULT PrintLine(int x, int y, _In_count_(cchBuff) LPCTSTR lpszBuff, size_t cchBuff, _In_ PRINTCBINFO* pci);
@@ -127,6 +265,7 @@ HRESULT PrintValueLine(_In_z_ const char* szText, DWORD dwValue, _In_ PRINTCBINF
 HRESULT PrintHexValueLine(_In_z_ const CHAR* szText, DWORD dwValue, _In_ PRINTCBINFO* lpInfo);
 HRESULT PrintStringValueLine(_In_z_ const CHAR* szText, const CHAR* szText2, _In_ PRINTCBINFO* lpInfo);
 HRESULT PrintStringLine(_In_z_ const CHAR* szText, _In_ PRINTCBINFO* lpInfo);
+HRESULT PrintCapModel(const CAPMODEL& model, _In_ PRINTCBINFO* pci);
 
 
 //-----------------------------------------------------------------------------
@@ -135,3 +274,7 @@ HRESULT PrintStringLine(_In_z_ const CHAR* szText, _In_ PRINTCBINFO* lpInfo);
 extern HINSTANCE g_hInstance;
 extern HWND      g_hwndMain;
 extern HWND      g_hwndLV;        // List view
+extern DWORD     g_dwCallTimeout;     // Longest a probe may go between driver calls, in ms, 0 for no limit
+extern DWORD     g_dwAdapterTimeout;  // Longest an adapter's probes may take, in ms, 0 for no limit
+extern BOOL      g_bProbesTimedOut;   // Some probe was abandoned, so the tree is incomplete
+extern BOOL      g_bWorkersFailed;    // Some probe worker died, so the tree is incomplete
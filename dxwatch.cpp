@@ -0,0 +1,127 @@
+//-----------------------------------------------------------------------------
+// Name: dxwatch.cpp
+//
+// Desc: DirectX Capabilities Viewer device change detection
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxwatch.h"
+
+#include <algorithm>
+
+namespace
+{
+    //-----------------------------------------------------------------------------
+    const ADAPTERSTATE* FindAdapter(const std::vector<ADAPTERSTATE>& states, const ADAPTERLUID& luid)
+    {
+        for (const auto& state : states)
+        {
+            if (IsSameLuid(state.Key.AdapterLuid, luid))
+                return &state;
+        }
+
+        return nullptr;
+    }
+
+    //-----------------------------------------------------------------------------
+    bool IsSameAdapter(const ADAPTERSTATE& state1, const ADAPTERSTATE& state2)
+    {
+        return (state1.Key.VendorId == state2.Key.VendorId)
+            && (state1.Key.DeviceId == state2.Key.DeviceId)
+            && (state1.Key.SubSysId == state2.Key.SubSysId)
+            && (state1.Key.Revision == state2.Key.Revision)
+            && (state1.Key.DriverVersion == state2.Key.DriverVersion)
+            && (state1.OutputsHash == state2.OutputsHash);
+    }
+
+    //-----------------------------------------------------------------------------
+    void ReadAdapterStates(ADAPTERSOURCE fnGetStates, std::vector<ADAPTERSTATE>& states)
+    {
+        states.clear();
+        if (!fnGetStates)
+            return;
+
+        uint32_t numStates = fnGetStates(nullptr, 0);
+        if (numStates > 0)
+        {
+            states.resize(numStates);
+            numStates = std::min(numStates, fnGetStates(states.data(), numStates));
+            states.resize(numStates);
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DiffAdapterStates()
+// Desc: Lists the adapters that are gone, those that are new and those whose
+//       driver or outputs changed. An adapter keeps its LUID until it's
+//       removed, so that's what they're matched by. Changes come out in the
+//       order of before, then the new adapters in the order of after.
+//-----------------------------------------------------------------------------
+void DiffAdapterStates(const std::vector<ADAPTERSTATE>& before, const std::vector<ADAPTERSTATE>& after,
+    std::vector<ADAPTERCHANGE>& changes)
+{
+    changes.clear();
+
+    for (const auto& state : before)
+    {
+        const ADAPTERSTATE* pNow = FindAdapter(after, state.Key.AdapterLuid);
+        if (!pNow)
+            changes.push_back({ ADAPTER_REMOVED, state.Key.AdapterLuid });
+        else if (!IsSameAdapter(state, *pNow))
+            changes.push_back({ ADAPTER_UPDATED, state.Key.AdapterLuid });
+    }
+
+    for (const auto& state : after)
+    {
+        if (!FindAdapter(before, state.Key.AdapterLuid))
+            changes.push_back({ ADAPTER_ADDED, state.Key.AdapterLuid });
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: IsAdapterChanged()
+//-----------------------------------------------------------------------------
+bool IsAdapterChanged(const std::vector<ADAPTERCHANGE>& changes, const ADAPTERLUID& luid)
+{
+    for (const auto& change : changes)
+    {
+        if (change.kind != ADAPTER_ADDED && IsSameLuid(change.AdapterLuid, luid))
+            return true;
+    }
+
+    return false;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: ADAPTERWATCH::Reset()
+// Desc: Takes the adapters present now as those the tree shows
+//-----------------------------------------------------------------------------
+void ADAPTERWATCH::Reset()
+{
+    ReadAdapterStates(fnGetStates, states);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: ADAPTERWATCH::Check()
+// Desc: Lists what changed since the last Reset or Check, then takes the
+//       adapters present now as those the tree shows. Returns true if anything
+//       changed.
+//-----------------------------------------------------------------------------
+bool ADAPTERWATCH::Check(std::vector<ADAPTERCHANGE>& changes)
+{
+    std::vector<ADAPTERSTATE> now;
+    ReadAdapterStates(fnGetStates, now);
+
+    DiffAdapterStates(states, now, changes);
+    states = std::move(now);
+
+    return !changes.empty();
+}
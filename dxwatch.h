@@ -0,0 +1,84 @@
+//-----------------------------------------------------------------------------
+// Name: dxwatch.h
+//
+// Desc: DirectX Capabilities Viewer device change detection
+//
+//       Compares the adapters present now with those the tree was built from,
+//       so a device change only re-probes the adapters it touched. Adapters
+//       come from an ADAPTERSOURCE, so the same logic runs against a scripted
+//       list of adapters as against DXGI. Kept free of Windows dependencies so
+//       it can be checked anywhere (see dxwatchtest).
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// An adapter's LUID, laid out as the Windows LUID
+struct ADAPTERLUID
+{
+    uint32_t        LowPart;
+    int32_t         HighPart;
+};
+
+// Everything about an adapter that can change its caps (see DXGI_GetAdapterKeys)
+struct ADAPTERKEY
+{
+    ADAPTERLUID     AdapterLuid;
+    uint32_t        VendorId;
+    uint32_t        DeviceId;
+    uint32_t        SubSysId;
+    uint32_t        Revision;
+    uint64_t        DriverVersion;  // The UMD version, as CheckInterfaceSupport reports it
+};
+
+// An adapter as the device-change watch sees it (see DXGI_GetAdapterStates)
+struct ADAPTERSTATE
+{
+    ADAPTERKEY      Key;
+    uint32_t        OutputsHash;    // Of the outputs attached and where they sit on the desktop
+};
+
+enum ADAPTERCHANGEKIND : uint8_t
+{
+    ADAPTER_ADDED = 0,
+    ADAPTER_REMOVED,
+    ADAPTER_UPDATED,        // Same LUID with another driver or other outputs
+};
+
+struct ADAPTERCHANGE
+{
+    ADAPTERCHANGEKIND   kind;
+    ADAPTERLUID         AdapterLuid;
+};
+
+// Fills in up to maxStates adapters, returning how many there are
+using ADAPTERSOURCE = uint32_t(*)(ADAPTERSTATE* pStates, uint32_t maxStates);
+
+// The adapters the tree was last built from
+struct ADAPTERWATCH
+{
+    ADAPTERSOURCE               fnGetStates;    // DXGI_GetAdapterStates, or a scripted list
+    std::vector<ADAPTERSTATE>   states;         // As of the last Reset or Check
+
+    explicit ADAPTERWATCH(ADAPTERSOURCE fnSource) noexcept : fnGetStates(fnSource) {}
+
+    void Reset();
+    bool Check(std::vector<ADAPTERCHANGE>& changes);
+};
+
+inline bool IsSameLuid(const ADAPTERLUID& luid1, const ADAPTERLUID& luid2)
+{
+    return (luid1.LowPart == luid2.LowPart) && (luid1.HighPart == luid2.HighPart);
+}
+
+void DiffAdapterStates(const std::vector<ADAPTERSTATE>& before, const std::vector<ADAPTERSTATE>& after,
+    std::vector<ADAPTERCHANGE>& changes);
+
+// Whether a list of changes removed or updated the adapter with the LUID
+bool IsAdapterChanged(const std::vector<ADAPTERCHANGE>& changes, const ADAPTERLUID& luid);
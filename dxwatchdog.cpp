@@ -0,0 +1,170 @@
+//-----------------------------------------------------------------------------
+// Name: dxwatchdog.cpp
+//
+// Desc: DirectX Capabilities Viewer probe watchdog
+//
+//       A probe runs on the thread pool while the caller waits for it. Every
+//       driver call the probe makes stamps a heartbeat (see PROBE_CALL), so
+//       the wait can tell a probe that is merely slow from one stuck in a
+//       single call. A probe that goes g_dwCallTimeout without a heartbeat,
+//       or runs past its adapter's deadline, is abandoned: the caller stops
+//       waiting and reports it as timed out, and whatever the probe still
+//       holds is leaked along with the thread it's stuck on. Nothing abandoned
+//       may be touched again, so callers keep the results of a probe apart
+//       until it has finished in time.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxview.h"
+#include "dxtrace.h"
+
+DWORD g_dwCallTimeout = WATCHDOG_CALL_TIMEOUT;
+DWORD g_dwAdapterTimeout = WATCHDOG_ADAPTER_TIMEOUT;
+BOOL  g_bProbesTimedOut;
+
+namespace
+{
+    // How often a wait checks the heartbeat
+    const DWORD WATCHDOG_POLL_MS = 100;
+
+    //-----------------------------------------------------------------------------
+    VOID CALLBACK WatchdogWorkCallback(PTP_CALLBACK_INSTANCE instance, PVOID pContext, PTP_WORK /*work*/)
+    {
+        auto pTask = static_cast<WATCHDOGTASK*>(pContext);
+
+        // The event is only set once the callback has fully returned, so the
+        // waiter can't close the work item out from under it
+        SetEventWhenCallbackReturns(instance, pTask->hDone);
+
+        pTask->heartbeat.store(ProbeTimingNow());
+        t_pProbeHeartbeat = &pTask->heartbeat;
+        pTask->fnProc(pTask->pContext);
+        t_pProbeHeartbeat = nullptr;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: WATCHDOGTASK::Start()
+// Desc: Submits the probe to the thread pool, or runs it inline if it can't
+//-----------------------------------------------------------------------------
+VOID WATCHDOGTASK::Start(WATCHDOGPROC fnProbe, VOID* pProbeContext)
+{
+    fnProc = fnProbe;
+    pContext = pProbeContext;
+    heartbeat.store(ProbeTimingNow());
+
+    hDone = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    pWork = hDone ? CreateThreadpoolWork(WatchdogWorkCallback, this, nullptr) : nullptr;
+    if (pWork)
+    {
+        SubmitThreadpoolWork(pWork);
+        return;
+    }
+
+    if (hDone)
+    {
+        CloseHandle(hDone);
+        hDone = nullptr;
+    }
+
+    // No thread pool work item available, so just probe inline
+    fnProc(pContext);
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: WATCHDOGTASK::Wait()
+// Desc: Waits for the probe to finish, or until it's overdue. deadline is a
+//       ProbeTimingNow time, or 0 for none. Returns FALSE if the probe was
+//       abandoned, in which case this task and its context must be leaked.
+//       Messages sent to this thread are dispatched meanwhile, so a probe that
+//       calls into one of its windows doesn't deadlock against the wait.
+//-----------------------------------------------------------------------------
+BOOL WATCHDOGTASK::Wait(uint64_t deadline)
+{
+    if (!pWork)
+        return TRUE;
+
+    const uint64_t callTimeout = g_dwCallTimeout * 1000000ull;
+    for (;;)
+    {
+        DWORD dwWait = MsgWaitForMultipleObjects(1, &hDone, FALSE, WATCHDOG_POLL_MS, QS_SENDMESSAGE);
+        if (dwWait == WAIT_OBJECT_0)
+            break;
+
+        if (dwWait == WAIT_OBJECT_0 + 1)
+        {
+            // Peeking is what dispatches sent messages
+            MSG msg;
+            (void)PeekMessage(&msg, nullptr, 0, 0, PM_NOREMOVE | PM_QS_SENDMESSAGE);
+            continue;
+        }
+
+        uint64_t now = ProbeTimingNow();
+        uint64_t last = heartbeat.load();
+        if ((callTimeout && now > last && now - last > callTimeout)
+            || (deadline && now > deadline))
+        {
+            // The work item goes once the callback returns, if it ever does
+            CloseThreadpoolWork(pWork);
+            pWork = nullptr;
+            g_bProbesTimedOut = TRUE;
+            return FALSE;
+        }
+    }
+
+    CloseThreadpoolWork(pWork);
+    pWork = nullptr;
+    CloseHandle(hDone);
+    hDone = nullptr;
+    return TRUE;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: WatchdogAdapterDeadline()
+// Desc: When an adapter whose probes start now is given up on, or 0 for never
+//-----------------------------------------------------------------------------
+uint64_t WatchdogAdapterDeadline()
+{
+    return g_dwAdapterTimeout ? ProbeTimingNow() + g_dwAdapterTimeout * 1000000ull : 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: WatchdogRun()
+// Desc: Runs a probe on its own under the call timeout. Returns FALSE if it
+//       was abandoned, in which case pContext must be leaked.
+//-----------------------------------------------------------------------------
+BOOL WatchdogRun(WATCHDOGPROC fnProc, VOID* pContext)
+{
+    auto pTask = new (std::nothrow) WATCHDOGTASK;
+    if (!pTask)
+    {
+        fnProc(pContext);
+        return TRUE;
+    }
+
+    pTask->Start(fnProc, pContext);
+    if (!pTask->Wait(0))
+        return FALSE;
+
+    delete pTask;
+    return TRUE;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: WatchdogAddTimedOutNode()
+// Desc: Stands in for the subtree of a probe that was abandoned
+//-----------------------------------------------------------------------------
+VOID WatchdogAddTimedOutNode(HTREEITEM hParent, LPCSTR strName)
+{
+    CHAR szText[128];
+    sprintf_s(szText, sizeof(szText), "%s (timed out)", strName);
+    TVAddNode(hParent, szText, FALSE, IDI_CAPS, nullptr, 0, 0);
+}
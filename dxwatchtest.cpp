@@ -0,0 +1,151 @@
+//-----------------------------------------------------------------------------
+// Name: dxwatchtest.cpp
+//
+// Desc: Checks what the device change watch makes of scripted adapter lists:
+//       adapters added, removed, given a new driver or new outputs, and
+//       several of these at once. Exits with 0 when every check passes and
+//       1 otherwise.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxwatch.h"
+
+#include <cstdio>
+
+namespace
+{
+    // What the scripted ADAPTERSOURCE reports
+    std::vector<ADAPTERSTATE> g_script;
+
+    //-----------------------------------------------------------------------------
+    uint32_t GetScriptedStates(ADAPTERSTATE* pStates, uint32_t maxStates)
+    {
+        for (uint32_t i = 0; pStates && i < maxStates && i < g_script.size(); ++i)
+            pStates[i] = g_script[i];
+
+        return static_cast<uint32_t>(g_script.size());
+    }
+
+    //-----------------------------------------------------------------------------
+    ADAPTERSTATE Adapter(uint32_t luid, uint32_t deviceId, uint64_t driverVersion, uint32_t outputsHash)
+    {
+        ADAPTERSTATE state = {};
+        state.Key.AdapterLuid = { luid, 0 };
+        state.Key.VendorId = 0x10de;
+        state.Key.DeviceId = deviceId;
+        state.Key.DriverVersion = driverVersion;
+        state.OutputsHash = outputsHash;
+        return state;
+    }
+
+    //-----------------------------------------------------------------------------
+    const char* KindName(ADAPTERCHANGEKIND kind)
+    {
+        switch (kind)
+        {
+        case ADAPTER_ADDED:     return "added";
+        case ADAPTER_REMOVED:   return "removed";
+        case ADAPTER_UPDATED:   return "updated";
+        default:                return "?";
+        }
+    }
+
+    unsigned g_numChecks = 0;
+    unsigned g_numFailed = 0;
+
+    //-----------------------------------------------------------------------------
+    // Name: CheckWatch()
+    // Desc: Moves the script on to after and checks the watch reports changes
+    //-----------------------------------------------------------------------------
+    void CheckWatch(const char* strName, ADAPTERWATCH& watch, const std::vector<ADAPTERSTATE>& after,
+        const std::vector<ADAPTERCHANGE>& expected)
+    {
+        g_script = after;
+
+        std::vector<ADAPTERCHANGE> changes;
+        bool bChanged = watch.Check(changes);
+
+        bool bPassed = (bChanged == !expected.empty()) && (changes.size() == expected.size());
+        for (size_t i = 0; bPassed && i < changes.size(); ++i)
+        {
+            bPassed = (changes[i].kind == expected[i].kind)
+                && IsSameLuid(changes[i].AdapterLuid, expected[i].AdapterLuid);
+        }
+
+        ++g_numChecks;
+        if (bPassed)
+            return;
+
+        ++g_numFailed;
+        printf("%s:\n  expected:", strName);
+        for (const auto& change : expected)
+            printf(" %s %u", KindName(change.kind), change.AdapterLuid.LowPart);
+        printf("\n  actual:  ");
+        for (const auto& change : changes)
+            printf(" %s %u", KindName(change.kind), change.AdapterLuid.LowPart);
+        printf("\n");
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: main()
+//-----------------------------------------------------------------------------
+int main()
+{
+    const ADAPTERSTATE a1 = Adapter(1, 0x2204, 0x001f00000000a1b2ull, 0x1111);
+    const ADAPTERSTATE a2 = Adapter(2, 0x9bc5, 0x001e00000000c3d4ull, 0x2222);
+    const ADAPTERSTATE a3 = Adapter(3, 0x73bf, 0x001f00000000e5f6ull, 0);
+
+    ADAPTERSTATE a1Driver = a1;
+    a1Driver.Key.DriverVersion = 0x001f00000000a1b3ull;
+
+    ADAPTERSTATE a2Outputs = a2;
+    a2Outputs.OutputsHash = 0x2223;
+
+    // A new adapter that got a LUID that was used before
+    ADAPTERSTATE a2Swapped = a3;
+    a2Swapped.Key.AdapterLuid = a2.Key.AdapterLuid;
+
+    g_script = { a1, a2 };
+    ADAPTERWATCH watch(GetScriptedStates);
+    watch.Reset();
+
+    CheckWatch("unchanged", watch, { a1, a2 }, {});
+    CheckWatch("reordered", watch, { a2, a1 }, {});
+    CheckWatch("added", watch, { a2, a1, a3 }, { { ADAPTER_ADDED, a3.Key.AdapterLuid } });
+    CheckWatch("removed", watch, { a2, a1 }, { { ADAPTER_REMOVED, a3.Key.AdapterLuid } });
+    CheckWatch("driver updated", watch, { a2, a1Driver }, { { ADAPTER_UPDATED, a1.Key.AdapterLuid } });
+    CheckWatch("outputs changed", watch, { a2Outputs, a1Driver }, { { ADAPTER_UPDATED, a2.Key.AdapterLuid } });
+    CheckWatch("LUID reused", watch, { a2Swapped, a1Driver }, { { ADAPTER_UPDATED, a2.Key.AdapterLuid } });
+
+    // Changes come out in the order of before, then what's new in the order of after
+    CheckWatch("all at once", watch, { a3, a1 },
+        {
+            { ADAPTER_REMOVED, a2.Key.AdapterLuid },
+            { ADAPTER_UPDATED, a1.Key.AdapterLuid },
+            { ADAPTER_ADDED, a3.Key.AdapterLuid },
+        });
+
+    CheckWatch("all removed", watch, {},
+        {
+            { ADAPTER_REMOVED, a3.Key.AdapterLuid },
+            { ADAPTER_REMOVED, a1.Key.AdapterLuid },
+        });
+
+    // What the older APIs ask of a list of changes
+    std::vector<ADAPTERCHANGE> changes = { { ADAPTER_ADDED, a1.Key.AdapterLuid }, { ADAPTER_UPDATED, a2.Key.AdapterLuid } };
+    ++g_numChecks;
+    if (IsAdapterChanged(changes, a1.Key.AdapterLuid) || !IsAdapterChanged(changes, a2.Key.AdapterLuid)
+        || IsAdapterChanged(changes, a3.Key.AdapterLuid))
+    {
+        ++g_numFailed;
+        printf("IsAdapterChanged: only the updated adapter counts as changed\n");
+    }
+
+    printf("%u checks, %u failed\n", g_numChecks, g_numFailed);
+    return g_numFailed ? 1 : 0;
+}
@@ -0,0 +1,366 @@
+//-----------------------------------------------------------------------------
+// Name: dxworker.cpp
+//
+// Desc: DirectX Capabilities Viewer probe workers
+//
+//       With -workers nothing is probed in this process. A child process is
+//       started per shard (see dxshard.h): one for each DXGI adapter, WARP,
+//       REF, Direct3D 9 and DirectDraw. Each is this executable run with
+//       -worker, which probes just its shard, headless and under the
+//       watchdog as usual, and writes it into a section it alone shares with
+//       the parent. The parent waits for them all, and then loads the merged
+//       shards as it would a recording. A worker that crashes, or that is
+//       still running well past the adapter timeout and gets killed, only
+//       leaves a node saying so in place of its own shard.
+//
+// Copyright (c) Microsoft Corporation. All Rights Reserved.
+// Licensed under the MIT License.
+//
+// https://go.microsoft.com/fwlink/?linkid=2136896
+//-----------------------------------------------------------------------------
+#include "dxview.h"
+#include "dxshard.h"
+#include "dxtrace.h"
+
+extern DWORD g_dwViewState;
+extern DWORD g_dwView9Ex;
+extern TCHAR g_StubDelay[MAX_PATH];
+
+VOID DXGI_FillTree(HWND hwndTV);
+VOID DXG_FillTree(HWND hwndTV);
+VOID DD_FillTree(HWND hwndTV);
+VOID DXGI_SetShard(UINT shard);
+UINT DXGI_GetAdapterKeys(ADAPTERKEY* pKeys, UINT maxKeys);
+BOOL DXG_Is9Ex();
+BOOL DXView_BuildSnapshot(HWND hwndTV, std::vector<uint8_t>& data);
+BOOL DXView_LoadShards(const CAPSHARD* pShards, size_t numShards);
+VOID DXView_Cleanup();
+
+BOOL g_bWorkersFailed;
+
+namespace
+{
+    // Reserved for each worker's snapshot, and only committed as it's written
+    const SIZE_T WORKER_REGION_SIZE = 64 * 1024 * 1024;
+
+    // Exit code of a worker that finished, but with some probe timed out
+    const DWORD WORKER_EXIT_TIMEDOUT = 3;
+
+    struct WORKER
+    {
+        CHAR        strShard[16];   // What -worker probes, as "dxgi:0" or "d3d9"
+        HANDLE      hSection;
+        VOID*       pRegion;
+        HANDLE      hProcess;       // Null if it couldn't be started
+        BOOL        bKilled;
+    };
+
+    //-----------------------------------------------------------------------------
+    // Name: FillShard()
+    // Desc: The worker's side, adding just its shard to the headless tree
+    //-----------------------------------------------------------------------------
+    BOOL FillShard(LPCTSTR strShard)
+    {
+        if (!_tcsicmp(strShard, TEXT("ddraw")))
+        {
+            DD_FillTree(nullptr);
+            return TRUE;
+        }
+
+        if (!_tcsicmp(strShard, TEXT("d3d9")))
+        {
+            DXG_FillTree(nullptr);
+            return TRUE;
+        }
+
+        if (!_tcsicmp(strShard, TEXT("warp")))
+            DXGI_SetShard(DXGISHARD_WARP);
+        else if (!_tcsicmp(strShard, TEXT("ref")))
+            DXGI_SetShard(DXGISHARD_REF);
+        else if (!_tcsnicmp(strShard, TEXT("dxgi:"), 5))
+            DXGI_SetShard(_tcstoul(strShard + 5, nullptr, 10));
+        else
+            return FALSE;
+
+        DXGI_FillTree(nullptr);
+        return TRUE;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: StartWorker()
+    // Desc: Readies the worker's section and starts it on its shard
+    //-----------------------------------------------------------------------------
+    BOOL StartWorker(LPCTSTR strModule, WORKER& worker)
+    {
+        // Inheritable, but only handed to this worker (see the handle list below)
+        SECURITY_ATTRIBUTES sa = { sizeof(sa), nullptr, TRUE };
+        worker.hSection = CreateFileMapping(INVALID_HANDLE_VALUE, &sa, PAGE_READWRITE | SEC_RESERVE,
+            0, static_cast<DWORD>(WORKER_REGION_SIZE), nullptr);
+        if (!worker.hSection)
+            return FALSE;
+
+        worker.pRegion = MapViewOfFile(worker.hSection, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, WORKER_REGION_SIZE);
+        if (!worker.pRegion || !VirtualAlloc(worker.pRegion, CAPSHARD_MIN_REGION, MEM_COMMIT, PAGE_READWRITE))
+            return FALSE;
+
+        CapShardInit(worker.pRegion, WORKER_REGION_SIZE);
+
+        SIZE_T cbAttributes = 0;
+        (void)InitializeProcThreadAttributeList(nullptr, 1, 0, &cbAttributes);
+        std::vector<BYTE> attributes(cbAttributes);
+        auto pAttributes = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attributes.data());
+        if (!InitializeProcThreadAttributeList(pAttributes, 1, 0, &cbAttributes))
+            return FALSE;
+
+        // The worker gets the same timeouts, and -stubdelay so the workers
+        // can be tried without a bad driver too
+        TCHAR strCmdLine[MAX_PATH * 3];
+        sprintf_s(strCmdLine, std::size(strCmdLine), "\"%s\" -timeout:%lu -adaptertimeout:%lu%s%s%s -worker:%Ix:%s",
+            strModule, g_dwCallTimeout, g_dwAdapterTimeout,
+            g_StubDelay[0] ? " -stubdelay:\"" : "", g_StubDelay, g_StubDelay[0] ? "\"" : "",
+            reinterpret_cast<ULONG_PTR>(worker.hSection), worker.strShard);
+
+        STARTUPINFOEX si = {};
+        si.StartupInfo.cb = sizeof(si);
+        si.lpAttributeList = pAttributes;
+
+        PROCESS_INFORMATION pi = {};
+        BOOL fResult = UpdateProcThreadAttribute(pAttributes, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST,
+                &worker.hSection, sizeof(HANDLE), nullptr, nullptr)
+            && CreateProcess(strModule, strCmdLine, nullptr, nullptr, TRUE,
+                CREATE_NO_WINDOW | EXTENDED_STARTUPINFO_PRESENT, nullptr, nullptr, &si.StartupInfo, &pi);
+
+        DeleteProcThreadAttributeList(pAttributes);
+
+        if (!fResult)
+            return FALSE;
+
+        CloseHandle(pi.hThread);
+        worker.hProcess = pi.hProcess;
+        return TRUE;
+    }
+
+
+    //-----------------------------------------------------------------------------
+    // Name: WaitForWorkers()
+    // Desc: The workers run their probes under the watchdog themselves, so this
+    //       only kills one stuck where the watchdog can't see, such as in the
+    //       runtime's own teardown. Messages sent to this thread are dispatched
+    //       meanwhile, as WATCHDOGTASK::Wait does, since the workers share the
+    //       desktop with our window.
+    //-----------------------------------------------------------------------------
+    VOID WaitForWorkers(WORKER* pWorkers, UINT numWorkers)
+    {
+        const ULONGLONG deadline = g_dwAdapterTimeout ? GetTickCount64() + 2ull * g_dwAdapterTimeout : 0;
+
+        for (UINT i = 0; i < numWorkers; ++i)
+        {
+            WORKER& worker = pWorkers[i];
+            if (!worker.hProcess)
+                continue;
+
+            DWORD dwWait;
+            for (;;)
+            {
+                DWORD dwTimeout = INFINITE;
+                if (deadline)
+                {
+                    ULONGLONG now = GetTickCount64();
+                    dwTimeout = (now < deadline) ? static_cast<DWORD>(deadline - now) : 0;
+                }
+
+                dwWait = MsgWaitForMultipleObjects(1, &worker.hProcess, FALSE, dwTimeout, QS_SENDMESSAGE);
+                if (dwWait != WAIT_OBJECT_0 + 1)
+                    break;
+
+                MSG msg;
+                (void)PeekMessage(&msg, nullptr, 0, 0, PM_NOREMOVE | PM_QS_SENDMESSAGE);
+            }
+
+            if (dwWait != WAIT_OBJECT_0)
+            {
+                // Whatever it already wrote is still good
+                (void)TerminateProcess(worker.hProcess, 1);
+                worker.bKilled = TRUE;
+            }
+        }
+    }
+
+
+    //-----------------------------------------------------------------------------
+    VOID FreeWorker(WORKER& worker)
+    {
+        if (worker.hProcess)
+            CloseHandle(worker.hProcess);
+        if (worker.pRegion)
+            UnmapViewOfFile(worker.pRegion);
+        if (worker.hSection)
+            CloseHandle(worker.hSection);
+        worker = {};
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_RunWorker()
+// Desc: The child's side of -workers. strArgs is the section handle the
+//       parent passed down, in hex, then a colon and the shard to probe.
+//       Returns the process exit code.
+//-----------------------------------------------------------------------------
+int DXView_RunWorker(LPCTSTR strArgs)
+{
+    TCHAR* pszShard = nullptr;
+    auto hSection = reinterpret_cast<HANDLE>(static_cast<ULONG_PTR>(_tcstoui64(strArgs, &pszShard, 16)));
+    if (!hSection || *pszShard != TEXT(':'))
+        return 1;
+
+    // Same defaults as a headless capture
+    g_dwViewState = IDM_VIEWALL;
+    g_dwView9Ex = DXG_Is9Ex() ? 1 : 0;
+
+    std::vector<uint8_t> data;
+    BOOL fResult = FillShard(pszShard + 1)
+        && DXView_BuildSnapshot(nullptr, data)
+        && (data.size() <= WORKER_REGION_SIZE - CAPSHARD_MIN_REGION);
+
+    if (fResult)
+    {
+        // The parent only committed the header
+        VOID* pRegion = MapViewOfFile(hSection, FILE_MAP_WRITE, 0, 0, WORKER_REGION_SIZE);
+        fResult = pRegion
+            && VirtualAlloc(pRegion, CAPSHARD_MIN_REGION + data.size(), MEM_COMMIT, PAGE_READWRITE)
+            && CapShardWrite(pRegion, WORKER_REGION_SIZE, data);
+
+        if (pRegion)
+            UnmapViewOfFile(pRegion);
+    }
+
+    CloseHandle(hSection);
+
+    BOOL bTimedOut = g_bProbesTimedOut;
+    DXView_Cleanup();
+
+    if (!fResult)
+        return 1;
+
+    return bTimedOut ? WORKER_EXIT_TIMEDOUT : 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// Name: DXView_ProbeWithWorkers()
+// Desc: The parent's side of -workers, filling the tree with what they
+//       probed. Returns FALSE, leaving the tree empty, only if no worker
+//       could be started at all.
+//-----------------------------------------------------------------------------
+BOOL DXView_ProbeWithWorkers()
+{
+    PROBESCOPE probeScope(PROBE_PHASE, "DXView_ProbeWithWorkers", nullptr);
+
+    TCHAR strModule[MAX_PATH];
+    DWORD cchModule = GetModuleFileName(nullptr, strModule, MAX_PATH);
+    if (!cchModule || cchModule >= MAX_PATH)
+        return FALSE;
+
+    // In the order the tree is filled in process, so it reads the same
+    UINT numAdapters = DXGI_GetAdapterKeys(nullptr, 0);
+    UINT numWorkers = numAdapters + 4;
+
+    auto pWorkers = new (std::nothrow) WORKER[numWorkers]();
+    auto pShards = new (std::nothrow) CAPSHARD[numWorkers];
+    if (!pWorkers || !pShards)
+    {
+        delete[] pWorkers;
+        delete[] pShards;
+        return FALSE;
+    }
+
+    for (UINT i = 0; i < numWorkers; ++i)
+    {
+        WORKER& worker = pWorkers[i];
+        CAPSHARD& shard = pShards[i];
+        CHAR szName[64];
+        if (i < numAdapters)
+        {
+            sprintf_s(worker.strShard, "dxgi:%u", i);
+            sprintf_s(szName, "Adapter %u", i);
+            shard.root = "DXGI Devices";
+            shard.name = szName;
+        }
+        else if (i == numAdapters)
+        {
+            strcpy_s(worker.strShard, "warp");
+            shard.root = "DXGI Devices";
+            shard.name = "Windows Advanced Rasterization Platform (WARP)";
+        }
+        else if (i == numAdapters + 1)
+        {
+            strcpy_s(worker.strShard, "ref");
+            shard.root = "DXGI Devices";
+            shard.name = "Reference";
+        }
+        else if (i == numAdapters + 2)
+        {
+            strcpy_s(worker.strShard, "d3d9");
+            shard.root = "Direct3D9 Devices";
+            shard.name = "Direct3D 9";
+        }
+        else
+        {
+            strcpy_s(worker.strShard, "ddraw");
+            shard.root = "DirectDraw Devices";
+            shard.name = "DirectDraw";
+        }
+    }
+
+    // They all probe at once
+    UINT numStarted = 0;
+    for (UINT i = 0; i < numWorkers; ++i)
+    {
+        if (StartWorker(strModule, pWorkers[i]))
+            ++numStarted;
+        else
+            FreeWorker(pWorkers[i]);
+    }
+
+    BOOL fResult = FALSE;
+    if (numStarted > 0)
+    {
+        WaitForWorkers(pWorkers, numWorkers);
+
+        for (UINT i = 0; i < numWorkers; ++i)
+        {
+            WORKER& worker = pWorkers[i];
+            CAPSHARD& shard = pShards[i];
+
+            shard.result = CAPSHARD_FAILED;
+            if (worker.hProcess)
+                shard.result = CapShardLoad(worker.pRegion, WORKER_REGION_SIZE, shard.snapshot);
+
+            DWORD dwExitCode = 0;
+            if (shard.result != CAPSHARD_OK && worker.bKilled)
+                shard.result = CAPSHARD_TIMEDOUT;
+            else if (shard.result == CAPSHARD_OK && GetExitCodeProcess(worker.hProcess, &dwExitCode)
+                && dwExitCode == WORKER_EXIT_TIMEDOUT)
+                g_bProbesTimedOut = TRUE;
+
+            if (shard.result == CAPSHARD_TIMEDOUT)
+                g_bProbesTimedOut = TRUE;
+            else if (shard.result != CAPSHARD_OK)
+                g_bWorkersFailed = TRUE;
+
+            FreeWorker(worker);
+        }
+
+        fResult = DXView_LoadShards(pShards, numWorkers);
+    }
+
+    for (UINT i = 0; i < numWorkers; ++i)
+        FreeWorker(pWorkers[i]);
+
+    delete[] pWorkers;
+    delete[] pShards;
+
+    return fResult;
+}